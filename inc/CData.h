@@ -15,6 +15,9 @@
 #include <TFile.h>
 
 #include "VGlobalRunParameter.h"
+#ifdef RUNWITHRNTUPLE
+#include "VRNTupleReader.h"
+#endif
 
 #include <cstdlib>
 #include <iostream>
@@ -23,6 +26,8 @@
 
 using namespace std;
 
+class VRNTupleReader;
+
 ////////////////////////////////////////////////////////////////////////////////
 // reconstruction types
 // note: reconstruction types determine which values are written from the mscw root
@@ -46,6 +51,7 @@ class CData
         bool            fShort;
         TTree*          fChain;                   //!pointer to the analyzed TTree or TChain
         Int_t           fCurrent;                 //!current Tree number in a TChain
+        VRNTupleReader* fRNTuple;                 //!columnar event data (RNTuple; instead of fChain)
         
         // Declaration of leave types
         Int_t           runNumber;
@@ -273,11 +279,19 @@ class CData
         TBranch*        b_dl_isGamma;             //!
         
         CData( TTree* tree = 0, bool bMC = false, bool bShort = false );
+#ifdef RUNWITHRNTUPLE
+        CData( VRNTupleReader* iRNTuple, bool bMC = false, bool bShort = false );
+#endif
         virtual ~CData();
         virtual Int_t    Cut( Long64_t entry );
         virtual Int_t    GetEntry( Long64_t entry );
         virtual Long64_t LoadTree( Long64_t entry );
         virtual void     Init( TTree* tree );
+#ifdef RUNWITHRNTUPLE
+        void             InitRNTuple( VRNTupleReader* iRNTuple );
+#endif
+        template< class T > void setBranchAddresses( T* iTree );
+        Long64_t         getEntries();
         virtual void     Loop();
         virtual Bool_t   Notify();
         virtual void     Show( Long64_t entry = -1 );
@@ -477,12 +491,33 @@ CData::CData( TTree* tree, bool bMC, bool bShort )
     fShort = bShort;
     fDeepLearner = false;
     fReconstructionType = GEO;
+    fChain = 0;
+    fRNTuple = 0;
     Init( tree );
 }
 
+#ifdef RUNWITHRNTUPLE
+CData::CData( VRNTupleReader* iRNTuple, bool bMC, bool bShort )
+{
+    fMC = bMC;
+    fShort = bShort;
+    fDeepLearner = false;
+    fReconstructionType = GEO;
+    fChain = 0;
+    fRNTuple = 0;
+    InitRNTuple( iRNTuple );
+}
+#endif
+
 
 CData::~CData()
 {
+#ifdef RUNWITHRNTUPLE
+    if( fRNTuple )
+    {
+        delete fRNTuple;
+    }
+#endif
     if( !fChain )
     {
         return;
@@ -491,9 +526,31 @@ CData::~CData()
 }
 
 
+Long64_t CData::getEntries()
+{
+#ifdef RUNWITHRNTUPLE
+    if( fRNTuple )
+    {
+        return fRNTuple->GetEntries();
+    }
+#endif
+    if( !fChain )
+    {
+        return 0;
+    }
+    return fChain->GetEntries();
+}
+
+
 Int_t CData::GetEntry( Long64_t entry )
 {
     // Read contents of entry.
+#ifdef RUNWITHRNTUPLE
+    if( fRNTuple )
+    {
+        return fRNTuple->GetEntry( entry );
+    }
+#endif
     if( !fChain )
     {
         return 0;
@@ -540,36 +597,64 @@ void CData::Init( TTree* tree )
         return;
     }
     
+    fChain = tree;
+    fCurrent = -1;
+    
+    setBranchAddresses( fChain );
+    
+    Notify();
+}
+
+#ifdef RUNWITHRNTUPLE
+/*
+ * read event data from RNTuple (same variables as from the data tree)
+ */
+void CData::InitRNTuple( VRNTupleReader* iRNTuple )
+{
+    if( iRNTuple == 0 )
+    {
+        return;
+    }
+    fRNTuple = iRNTuple;
+    fCurrent = -1;
+    
+    setBranchAddresses( fRNTuple );
+}
+#endif
+
+/*
+ * set addresses of all variables
+ * (T is a TTree or a VRNTupleReader)
+ */
+template< class T > void CData::setBranchAddresses( T* iTree )
+{
     // test if this is a MC file
-    if( tree->GetBranchStatus( "MCe0" ) )
+    if( iTree->GetBranchStatus( "MCe0" ) )
     {
         fMC = true;
     }
     // test if deep learner variables exists
-    if( tree->GetBranchStatus( "dl_gammaness" ) )
+    if( iTree->GetBranchStatus( "dl_gammaness" ) )
     {
         fDeepLearner = true;
     }
     
-    fChain = tree;
-    fCurrent = -1;
-    
-    fChain->SetBranchAddress( "runNumber", &runNumber );
-    fChain->SetBranchAddress( "eventNumber", &eventNumber );
+    iTree->SetBranchAddress( "runNumber", &runNumber );
+    iTree->SetBranchAddress( "eventNumber", &eventNumber );
     if( !fShort )
     {
-        fChain->SetBranchAddress( "MJD", &MJD );
-        fChain->SetBranchAddress( "Time", &Time );
+        iTree->SetBranchAddress( "MJD", &MJD );
+        iTree->SetBranchAddress( "Time", &Time );
     }
     else
     {
         MJD = 0;
         Time = 0;
     }
-    if( fChain->GetBranchStatus( "TelElevation" ) && fChain->GetBranchStatus( "TelAzimuth" ) )
+    if( iTree->GetBranchStatus( "TelElevation" ) && iTree->GetBranchStatus( "TelAzimuth" ) )
     {
-        fChain->SetBranchAddress( "TelElevation", TelElevation );
-        fChain->SetBranchAddress( "TelAzimuth", TelAzimuth );
+        iTree->SetBranchAddress( "TelElevation", TelElevation );
+        iTree->SetBranchAddress( "TelAzimuth", TelAzimuth );
     }
     else
     {
@@ -580,26 +665,26 @@ void CData::Init( TTree* tree )
         }
     }
     
-    if( fChain->GetBranchStatus( "ArrayPointing_Azimuth" ) )
+    if( iTree->GetBranchStatus( "ArrayPointing_Azimuth" ) )
     {
-        fChain->SetBranchAddress( "ArrayPointing_Azimuth", &ArrayPointing_Azimuth );
+        iTree->SetBranchAddress( "ArrayPointing_Azimuth", &ArrayPointing_Azimuth );
     }
     else
     {
         ArrayPointing_Azimuth = 0.;
     }
-    if( fChain->GetBranchStatus( "ArrayPointing_Elevation" ) )
+    if( iTree->GetBranchStatus( "ArrayPointing_Elevation" ) )
     {
-        fChain->SetBranchAddress( "ArrayPointing_Elevation", &ArrayPointing_Elevation );
+        iTree->SetBranchAddress( "ArrayPointing_Elevation", &ArrayPointing_Elevation );
     }
     else
     {
         ArrayPointing_Elevation = 0.;
     }
-    if( fChain->GetBranchStatus( "TelDec" ) )
+    if( iTree->GetBranchStatus( "TelDec" ) )
     {
-        fChain->SetBranchAddress( "TelDec", TelDec );
-        fChain->SetBranchAddress( "TelRA", TelRA );
+        iTree->SetBranchAddress( "TelDec", TelDec );
+        iTree->SetBranchAddress( "TelRA", TelRA );
     }
     else
     {
@@ -613,38 +698,38 @@ void CData::Init( TTree* tree )
     // MC tree
     if( fMC )
     {
-        if( fChain->GetBranch( "MCprimary" ) )
+        if( iTree->GetBranch( "MCprimary" ) )
         {
-            fChain->SetBranchAddress( "MCprimary", &MCprimary );
+            iTree->SetBranchAddress( "MCprimary", &MCprimary );
         }
         else
         {
             MCprimary = 0;
         }
-        fChain->SetBranchAddress( "MCe0", &MCe0 );
-        fChain->SetBranchAddress( "MCxcore", &MCxcore );
-        fChain->SetBranchAddress( "MCycore", &MCycore );
+        iTree->SetBranchAddress( "MCe0", &MCe0 );
+        iTree->SetBranchAddress( "MCxcore", &MCxcore );
+        iTree->SetBranchAddress( "MCycore", &MCycore );
         if( !fShort )
         {
-            fChain->SetBranchAddress( "MCxcore_SC", &MCxcore_SC );
-            fChain->SetBranchAddress( "MCycore_SC", &MCycore_SC );
-            fChain->SetBranchAddress( "MCxcos", &MCxcos );
-            fChain->SetBranchAddress( "MCycos", &MCycos );
+            iTree->SetBranchAddress( "MCxcore_SC", &MCxcore_SC );
+            iTree->SetBranchAddress( "MCycore_SC", &MCycore_SC );
+            iTree->SetBranchAddress( "MCxcos", &MCxcos );
+            iTree->SetBranchAddress( "MCycos", &MCycos );
         }
         else
         {
             MCxcore_SC = MCycore_SC = MCxcos = MCycos = 0.;
         }
-        fChain->SetBranchAddress( "MCaz", &MCaz );
-        fChain->SetBranchAddress( "MCze", &MCze );
-        fChain->SetBranchAddress( "MCxoff", &MCxoff );
-        fChain->SetBranchAddress( "MCyoff", &MCyoff );
-        if( fChain->GetBranch( "MCCorsikaRunID" ) )
+        iTree->SetBranchAddress( "MCaz", &MCaz );
+        iTree->SetBranchAddress( "MCze", &MCze );
+        iTree->SetBranchAddress( "MCxoff", &MCxoff );
+        iTree->SetBranchAddress( "MCyoff", &MCyoff );
+        if( iTree->GetBranch( "MCCorsikaRunID" ) )
         {
-            fChain->SetBranchAddress( "MCCorsikaRunID", &MCCorsikaRunID );
-            fChain->SetBranchAddress( "MCCorsikaShowerID", &MCCorsikaShowerID );
-            fChain->SetBranchAddress( "MCFirstInteractionHeight", &MCFirstInteractionHeight );
-            fChain->SetBranchAddress( "MCFirstInteractionDepth", &MCFirstInteractionDepth );
+            iTree->SetBranchAddress( "MCCorsikaRunID", &MCCorsikaRunID );
+            iTree->SetBranchAddress( "MCCorsikaShowerID", &MCCorsikaShowerID );
+            iTree->SetBranchAddress( "MCFirstInteractionHeight", &MCFirstInteractionHeight );
+            iTree->SetBranchAddress( "MCFirstInteractionDepth", &MCFirstInteractionDepth );
         }
         else
         {
@@ -676,30 +761,30 @@ void CData::Init( TTree* tree )
     }
     
     
-    if( fChain->GetBranchStatus( "LTrig" ) )
+    if( iTree->GetBranchStatus( "LTrig" ) )
     {
-        fChain->SetBranchAddress( "LTrig", &LTrig );
-        fChain->SetBranchAddress( "NTrig", &NTrig );
+        iTree->SetBranchAddress( "LTrig", &LTrig );
+        iTree->SetBranchAddress( "NTrig", &NTrig );
     }
     else
     {
         LTrig = 0;
         NTrig = 0;
     }
-    fChain->SetBranchAddress( "NImages", &NImages );
-    fChain->SetBranchAddress( "ImgSel", &ImgSel );
-    if( fChain->GetBranchStatus( "img2_ang" ) )
+    iTree->SetBranchAddress( "NImages", &NImages );
+    iTree->SetBranchAddress( "ImgSel", &ImgSel );
+    if( iTree->GetBranchStatus( "img2_ang" ) )
     {
-        fChain->SetBranchAddress( "img2_ang", &img2_ang );
+        iTree->SetBranchAddress( "img2_ang", &img2_ang );
     }
     else
     {
         img2_ang = 0.;
     }
-    if( fChain->GetBranchStatus( "Ze" ) &&  fChain->GetBranchStatus( "Az" ) )
+    if( iTree->GetBranchStatus( "Ze" ) &&  iTree->GetBranchStatus( "Az" ) )
     {
-        fChain->SetBranchAddress( "Ze", &Ze );
-        fChain->SetBranchAddress( "Az", &Az );
+        iTree->SetBranchAddress( "Ze", &Ze );
+        iTree->SetBranchAddress( "Az", &Az );
     }
     else
     {
@@ -708,43 +793,43 @@ void CData::Init( TTree* tree )
     }
     if( !fShort )
     {
-        fChain->SetBranchAddress( "ra", &ra );
-        fChain->SetBranchAddress( "dec", &dec );
+        iTree->SetBranchAddress( "ra", &ra );
+        iTree->SetBranchAddress( "dec", &dec );
     }
     else
     {
         ra = dec = 0.;
     }
-    fChain->SetBranchAddress( "Xoff", &Xoff );
-    fChain->SetBranchAddress( "Yoff", &Yoff );
-    if( fChain->GetBranchStatus( "Xoff_derot" ) )
+    iTree->SetBranchAddress( "Xoff", &Xoff );
+    iTree->SetBranchAddress( "Yoff", &Yoff );
+    if( iTree->GetBranchStatus( "Xoff_derot" ) )
     {
-        fChain->SetBranchAddress( "Xoff_derot", &Xoff_derot );
+        iTree->SetBranchAddress( "Xoff_derot", &Xoff_derot );
     }
-    if( fChain->GetBranchStatus( "Yoff_derot" ) )
+    if( iTree->GetBranchStatus( "Yoff_derot" ) )
     {
-        fChain->SetBranchAddress( "Yoff_derot", &Yoff_derot );
+        iTree->SetBranchAddress( "Yoff_derot", &Yoff_derot );
     }
-    if( fChain->GetBranchStatus( "Xoff_intersect" ) )
+    if( iTree->GetBranchStatus( "Xoff_intersect" ) )
     {
-        fChain->SetBranchAddress( "Xoff_intersect", &Xoff_intersect );
+        iTree->SetBranchAddress( "Xoff_intersect", &Xoff_intersect );
     }
     else
     {
         Xoff_intersect = 0.;
     }
-    if( fChain->GetBranchStatus( "Yoff_intersect" ) )
+    if( iTree->GetBranchStatus( "Yoff_intersect" ) )
     {
-        fChain->SetBranchAddress( "Yoff_intersect", &Yoff_intersect );
+        iTree->SetBranchAddress( "Yoff_intersect", &Yoff_intersect );
     }
     else
     {
         Yoff_intersect = 0.;
     }
     
-    if( fChain->GetBranchStatus( "stdS" ) )
+    if( iTree->GetBranchStatus( "stdS" ) )
     {
-        fChain->SetBranchAddress( "stdS", &stdS );
+        iTree->SetBranchAddress( "stdS", &stdS );
     }
     else
     {
@@ -752,36 +837,36 @@ void CData::Init( TTree* tree )
     }
     if( !fShort )
     {
-        fChain->SetBranchAddress( "theta2", &theta2 );
+        iTree->SetBranchAddress( "theta2", &theta2 );
     }
     else
     {
         theta2 = 0.;
     }
-    fChain->SetBranchAddress( "Xcore", &Xcore );
-    fChain->SetBranchAddress( "Ycore", &Ycore );
+    iTree->SetBranchAddress( "Xcore", &Xcore );
+    iTree->SetBranchAddress( "Ycore", &Ycore );
     if( !fShort )
     {
-        fChain->SetBranchAddress( "Xcore_SC", &Xcore_SC );
-        fChain->SetBranchAddress( "Ycore_SC", &Ycore_SC );
+        iTree->SetBranchAddress( "Xcore_SC", &Xcore_SC );
+        iTree->SetBranchAddress( "Ycore_SC", &Ycore_SC );
     }
     else
     {
         Xcore_SC = Ycore_SC = 0.;
     }
-    if( fChain->GetBranchStatus( "stdP" ) )
+    if( iTree->GetBranchStatus( "stdP" ) )
     {
-        fChain->SetBranchAddress( "stdP", &stdP );
+        iTree->SetBranchAddress( "stdP", &stdP );
     }
     else
     {
         stdP = 0.;
     }
     
-    fChain->SetBranchAddress( "Chi2", &Chi2 );
-    if( fChain->GetBranchStatus( "meanPedvar_Image" ) )
+    iTree->SetBranchAddress( "Chi2", &Chi2 );
+    if( iTree->GetBranchStatus( "meanPedvar_Image" ) )
     {
-        fChain->SetBranchAddress( "meanPedvar_Image", &meanPedvar_Image );
+        iTree->SetBranchAddress( "meanPedvar_Image", &meanPedvar_Image );
     }
     else
     {
@@ -789,7 +874,7 @@ void CData::Init( TTree* tree )
     }
     if( !fShort )
     {
-        fChain->SetBranchAddress( "meanPedvar_ImageT", meanPedvar_ImageT );
+        iTree->SetBranchAddress( "meanPedvar_ImageT", meanPedvar_ImageT );
     }
     else
     {
@@ -799,11 +884,11 @@ void CData::Init( TTree* tree )
         }
     }
     
-    fChain->SetBranchAddress( "SizeSecondMax", &SizeSecondMax );
+    iTree->SetBranchAddress( "SizeSecondMax", &SizeSecondMax );
     
-    if( fChain->GetBranchStatus( "theta2_All" ) )
+    if( iTree->GetBranchStatus( "theta2_All" ) )
     {
-        fChain->SetBranchAddress( "theta2_All", &theta2_All );
+        iTree->SetBranchAddress( "theta2_All", &theta2_All );
     }
     else
     {
@@ -813,11 +898,11 @@ void CData::Init( TTree* tree )
         }
     }
     
-    if( fChain->GetBranchStatus( "NTtype" ) )
+    if( iTree->GetBranchStatus( "NTtype" ) )
     {
-        fChain->SetBranchAddress( "ImgSel_list", ImgSel_list );
-        fChain->SetBranchAddress( "NTtype", &NTtype );
-        fChain->SetBranchAddress( "NImages_Ttype", NImages_Ttype );
+        iTree->SetBranchAddress( "ImgSel_list", ImgSel_list );
+        iTree->SetBranchAddress( "NTtype", &NTtype );
+        iTree->SetBranchAddress( "NImages_Ttype", NImages_Ttype );
     }
     else
     {
@@ -827,9 +912,9 @@ void CData::Init( TTree* tree )
             NImages_Ttype[tt] = 0;
         }
     }
-    if( fChain->GetBranchStatus( "TtypeID" ) )
+    if( iTree->GetBranchStatus( "TtypeID" ) )
     {
-        fChain->SetBranchAddress( "TtypeID", TtypeID );
+        iTree->SetBranchAddress( "TtypeID", TtypeID );
     }
     else
     {
@@ -838,14 +923,14 @@ void CData::Init( TTree* tree )
             TtypeID[tt] = 0;
         }
     }
-    fChain->SetBranchAddress( "dist", dist );
-    fChain->SetBranchAddress( "size", size );
-    fChain->SetBranchAddress( "loss", loss );
-    fChain->SetBranchAddress( "asym", asym );
-    fChain->SetBranchAddress( "tgrad_x", tgrad_x );
-    if( fChain->GetBranchStatus( "fui" ) )
+    iTree->SetBranchAddress( "dist", dist );
+    iTree->SetBranchAddress( "size", size );
+    iTree->SetBranchAddress( "loss", loss );
+    iTree->SetBranchAddress( "asym", asym );
+    iTree->SetBranchAddress( "tgrad_x", tgrad_x );
+    if( iTree->GetBranchStatus( "fui" ) )
     {
-        fChain->SetBranchAddress( "fui", fui );
+        iTree->SetBranchAddress( "fui", fui );
     }
     else
     {
@@ -854,9 +939,9 @@ void CData::Init( TTree* tree )
             fui[i] = 0.;
         }
     }
-    if( fChain->GetBranchStatus( "cross" ) )
+    if( iTree->GetBranchStatus( "cross" ) )
     {
-        fChain->SetBranchAddress( "cross", cross );
+        iTree->SetBranchAddress( "cross", cross );
     }
     else
     {
@@ -869,9 +954,9 @@ void CData::Init( TTree* tree )
     
     if( !fShort )
     {
-        if( fChain->GetBranchStatus( "size2" ) )
+        if( iTree->GetBranchStatus( "size2" ) )
         {
-            fChain->SetBranchAddress( "size2", size2 );
+            iTree->SetBranchAddress( "size2", size2 );
         }
         else
         {
@@ -880,9 +965,9 @@ void CData::Init( TTree* tree )
                 size2[i] = 0.;
             }
         }
-        if( fChain->GetBranchStatus( "fracLow" ) )
+        if( iTree->GetBranchStatus( "fracLow" ) )
         {
-            fChain->SetBranchAddress( "fracLow", fraclow );
+            iTree->SetBranchAddress( "fracLow", fraclow );
         }
         else
         {
@@ -891,19 +976,19 @@ void CData::Init( TTree* tree )
                 fraclow[i] = 0.;
             }
         }
-        fChain->SetBranchAddress( "max1", max1 );
-        fChain->SetBranchAddress( "max2", max2 );
-        fChain->SetBranchAddress( "max3", max3 );
-        fChain->SetBranchAddress( "maxindex1", maxindex1 );
-        fChain->SetBranchAddress( "maxindex2", maxindex2 );
-        fChain->SetBranchAddress( "maxindex3", maxindex3 );
-        fChain->SetBranchAddress( "width", width );
-        fChain->SetBranchAddress( "length", length );
-        fChain->SetBranchAddress( "ntubes", ntubes );
-        fChain->SetBranchAddress( "nsat", nsat );
-        if( fChain->GetBranchStatus( "nlowgain" ) )
+        iTree->SetBranchAddress( "max1", max1 );
+        iTree->SetBranchAddress( "max2", max2 );
+        iTree->SetBranchAddress( "max3", max3 );
+        iTree->SetBranchAddress( "maxindex1", maxindex1 );
+        iTree->SetBranchAddress( "maxindex2", maxindex2 );
+        iTree->SetBranchAddress( "maxindex3", maxindex3 );
+        iTree->SetBranchAddress( "width", width );
+        iTree->SetBranchAddress( "length", length );
+        iTree->SetBranchAddress( "ntubes", ntubes );
+        iTree->SetBranchAddress( "nsat", nsat );
+        if( iTree->GetBranchStatus( "nlowgain" ) )
         {
-            fChain->SetBranchAddress( "nlowgain", nlowgain );
+            iTree->SetBranchAddress( "nlowgain", nlowgain );
         }
         else
         {
@@ -912,9 +997,9 @@ void CData::Init( TTree* tree )
                 nlowgain[i] = 0;
             }
         }
-        if( fChain->GetBranchStatus( "ntubesBNI" ) )
+        if( iTree->GetBranchStatus( "ntubesBNI" ) )
         {
-            fChain->SetBranchAddress( "ntubesBNI", ntubesBNI );
+            iTree->SetBranchAddress( "ntubesBNI", ntubesBNI );
         }
         else
         {
@@ -923,14 +1008,14 @@ void CData::Init( TTree* tree )
                 ntubesBNI[i] = 0;
             }
         }
-        fChain->SetBranchAddress( "alpha", alpha );
-        fChain->SetBranchAddress( "los", los );
-        fChain->SetBranchAddress( "cen_x", cen_x );
-        fChain->SetBranchAddress( "cen_y", cen_y );
-        fChain->SetBranchAddress( "cosphi", cosphi );
-        fChain->SetBranchAddress( "sinphi", sinphi );
-        fChain->SetBranchAddress( "Fitstat", Fitstat );
-        fChain->SetBranchAddress( "tchisq_x", tchisq_x );
+        iTree->SetBranchAddress( "alpha", alpha );
+        iTree->SetBranchAddress( "los", los );
+        iTree->SetBranchAddress( "cen_x", cen_x );
+        iTree->SetBranchAddress( "cen_y", cen_y );
+        iTree->SetBranchAddress( "cosphi", cosphi );
+        iTree->SetBranchAddress( "sinphi", sinphi );
+        iTree->SetBranchAddress( "Fitstat", Fitstat );
+        iTree->SetBranchAddress( "tchisq_x", tchisq_x );
     }
     else
     {
@@ -960,11 +1045,11 @@ void CData::Init( TTree* tree )
             tchisq_x[i] = 0.;
         }
     }
-    fChain->SetBranchAddress( "R", R );
+    iTree->SetBranchAddress( "R", R );
     if( !fShort )
     {
-        fChain->SetBranchAddress( "MSCWT", MSCWT );
-        fChain->SetBranchAddress( "MSCLT", MSCLT );
+        iTree->SetBranchAddress( "MSCWT", MSCWT );
+        iTree->SetBranchAddress( "MSCLT", MSCLT );
     }
     else
     {
@@ -974,27 +1059,27 @@ void CData::Init( TTree* tree )
             MSCLT[i] = 0.;
         }
     }
-    fChain->SetBranchAddress( "ES", ES );
+    iTree->SetBranchAddress( "ES", ES );
     if( !fShort )
     {
-        fChain->SetBranchAddress( "NMSCW", &NMSCW );
+        iTree->SetBranchAddress( "NMSCW", &NMSCW );
     }
     else
     {
         NMSCW = 0;
     }
-    fChain->SetBranchAddress( "MSCW", &MSCW );
-    fChain->SetBranchAddress( "MSCL", &MSCL );
-    fChain->SetBranchAddress( "MWR", &MWR );
-    fChain->SetBranchAddress( "MLR", &MLR );
-    fChain->SetBranchAddress( "ErecS", &ErecS );
-    fChain->SetBranchAddress( "EChi2S", &EChi2S );
-    fChain->SetBranchAddress( "dES", &dES );
-    if( fChain->GetBranchStatus( "Erec" ) )
+    iTree->SetBranchAddress( "MSCW", &MSCW );
+    iTree->SetBranchAddress( "MSCL", &MSCL );
+    iTree->SetBranchAddress( "MWR", &MWR );
+    iTree->SetBranchAddress( "MLR", &MLR );
+    iTree->SetBranchAddress( "ErecS", &ErecS );
+    iTree->SetBranchAddress( "EChi2S", &EChi2S );
+    iTree->SetBranchAddress( "dES", &dES );
+    if( iTree->GetBranchStatus( "Erec" ) )
     {
-        fChain->SetBranchAddress( "Erec", &Erec );
-        fChain->SetBranchAddress( "EChi2", &EChi2 );
-        fChain->SetBranchAddress( "dES", &dES );
+        iTree->SetBranchAddress( "Erec", &Erec );
+        iTree->SetBranchAddress( "EChi2", &EChi2 );
+        iTree->SetBranchAddress( "dES", &dES );
     }
     else
     {
@@ -1003,11 +1088,11 @@ void CData::Init( TTree* tree )
         dES = -99.;
     }
     EmissionHeight = -99.;
-    fChain->SetBranchAddress( "EmissionHeight", &EmissionHeight );
-    fChain->SetBranchAddress( "EmissionHeightChi2", &EmissionHeightChi2 );
-    if( fChain->GetBranchStatus( "NTelPairs" ) )
+    iTree->SetBranchAddress( "EmissionHeight", &EmissionHeight );
+    iTree->SetBranchAddress( "EmissionHeightChi2", &EmissionHeightChi2 );
+    if( iTree->GetBranchStatus( "NTelPairs" ) )
     {
-        fChain->SetBranchAddress( "NTelPairs", &NTelPairs );
+        iTree->SetBranchAddress( "NTelPairs", &NTelPairs );
     }
     else
     {
@@ -1015,7 +1100,7 @@ void CData::Init( TTree* tree )
     }
     if( !fShort )
     {
-        fChain->SetBranchAddress( "EmissionHeightT", EmissionHeightT );
+        iTree->SetBranchAddress( "EmissionHeightT", EmissionHeightT );
     }
     else
     {
@@ -1024,25 +1109,25 @@ void CData::Init( TTree* tree )
             EmissionHeightT[i] = 0.;
         }
     }
-    if( fChain->GetBranchStatus( "DispDiff" ) )
+    if( iTree->GetBranchStatus( "DispDiff" ) )
     {
-        fChain->SetBranchAddress( "DispDiff", &DispDiff );
+        iTree->SetBranchAddress( "DispDiff", &DispDiff );
     }
     else
     {
         DispDiff = 0.;
     }
-    if( fChain->GetBranchStatus( "DispAbsSumWeigth" ) )
+    if( iTree->GetBranchStatus( "DispAbsSumWeigth" ) )
     {
-        fChain->SetBranchAddress( "DispAbsSumWeigth", &DispAbsSumWeigth );
+        iTree->SetBranchAddress( "DispAbsSumWeigth", &DispAbsSumWeigth );
     }
     else
     {
         DispAbsSumWeigth = 0.;
     }
-    if( fChain->GetBranchStatus( "DispNImages" ) )
+    if( iTree->GetBranchStatus( "DispNImages" ) )
     {
-        fChain->SetBranchAddress( "DispNImages", &DispNImages );
+        iTree->SetBranchAddress( "DispNImages", &DispNImages );
     }
     else
     {
@@ -1050,16 +1135,14 @@ void CData::Init( TTree* tree )
     }
     if( fDeepLearner )
     {
-        fChain->SetBranchAddress( "dl_gammaness", &dl_gammaness );
-        fChain->SetBranchAddress( "dl_isGamma", &dl_isGamma );
+        iTree->SetBranchAddress( "dl_gammaness", &dl_gammaness );
+        iTree->SetBranchAddress( "dl_isGamma", &dl_isGamma );
     }
     else
     {
         dl_gammaness = 0.;
         dl_isGamma = 0;
     }
-    
-    Notify();
 }
 
 
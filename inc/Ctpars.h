@@ -13,10 +13,106 @@
 #include <TChain.h>
 #include <TFile.h>
 
+#include <vector>
+
 #include "VGlobalRunParameter.h"
 
 using namespace std;
 
+/*
+    reader for image parameters of all telescopes in one tree
+    (sparse layout written by evndisp -sparseimagetree; tree tparsSparse)
+    
+    one entry per event, parameters of telescopes with images only
+*/
+class CtparsSparse
+{
+    public :
+        unsigned int    bShort;
+        bool            bParameterErrors;
+        bool            bPixelList;
+        TTree*          fChain;                   //!pointer to the analyzed TTree or TChain
+        Long64_t        fCurrentEntry;            //!entry currently in memory
+        
+        // index of telescope in image arrays (-1: no image)
+        int             fImageIndex[VDST_MAXTELESCOPES];
+        // index of first pixel of each image in pixel lists
+        UInt_t          fPixelIndex[VDST_MAXTELESCOPES];
+        
+        // Declaration of leave types
+        UInt_t          NImages;
+        UInt_t          TelID[VDST_MAXTELESCOPES];   //[NImages]
+        Float_t         meanPed_Image[VDST_MAXTELESCOPES];
+        Float_t         meanPedvar_Image[VDST_MAXTELESCOPES];
+        Float_t         cen_x[VDST_MAXTELESCOPES];
+        Float_t         cen_y[VDST_MAXTELESCOPES];
+        Float_t         f_s[VDST_MAXTELESCOPES];
+        Float_t         f_d[VDST_MAXTELESCOPES];
+        Float_t         f_sdevxy[VDST_MAXTELESCOPES];
+        Float_t         length[VDST_MAXTELESCOPES];
+        Float_t         width[VDST_MAXTELESCOPES];
+        Float_t         size[VDST_MAXTELESCOPES];
+        Float_t         size2[VDST_MAXTELESCOPES];
+        Float_t         loss[VDST_MAXTELESCOPES];
+        Float_t         fracLow[VDST_MAXTELESCOPES];
+        Float_t         fui[VDST_MAXTELESCOPES];
+        Float_t         dist[VDST_MAXTELESCOPES];
+        Float_t         alpha[VDST_MAXTELESCOPES];
+        Float_t         los[VDST_MAXTELESCOPES];
+        Float_t         phi[VDST_MAXTELESCOPES];
+        Float_t         cosphi[VDST_MAXTELESCOPES];
+        Float_t         sinphi[VDST_MAXTELESCOPES];
+        UShort_t        ntubes[VDST_MAXTELESCOPES];
+        UShort_t        ntubesBNI[VDST_MAXTELESCOPES];
+        UShort_t        nsat[VDST_MAXTELESCOPES];
+        UShort_t        nlowgain[VDST_MAXTELESCOPES];
+        Float_t         max[VDST_MAXTELESCOPES][3];
+        UShort_t        index_of_max[VDST_MAXTELESCOPES][3];
+        Float_t         asymmetry[VDST_MAXTELESCOPES];
+        Float_t         tgrad_x[VDST_MAXTELESCOPES];
+        Float_t         tchisq_x[VDST_MAXTELESCOPES];
+        Int_t           Fitstat[VDST_MAXTELESCOPES];
+        Float_t         dcen_x[VDST_MAXTELESCOPES];
+        Float_t         dcen_y[VDST_MAXTELESCOPES];
+        Float_t         dlength[VDST_MAXTELESCOPES];
+        Float_t         dwidth[VDST_MAXTELESCOPES];
+        Float_t         dphi[VDST_MAXTELESCOPES];
+        UInt_t          PixelListN[VDST_MAXTELESCOPES];   //[NImages]
+        UInt_t          PixelListNPixelNN;
+        vector< UInt_t >  PixelID;                //[PixelListNPixelNN]
+        vector< UInt_t >  PixelType;              //[PixelListNPixelNN]
+        vector< Float_t > PixelIntensity;         //[PixelListNPixelNN]
+        vector< Float_t > PixelTimingT0;          //[PixelListNPixelNN]
+        vector< Float_t > PixelPE;                //[PixelListNPixelNN]
+        
+        CtparsSparse( TTree* tree = 0, unsigned int iShort = false );
+        virtual ~CtparsSparse();
+        virtual Int_t    GetEntry( Long64_t entry );
+        virtual void     Init( TTree* tree );
+        int              getImageIndex( unsigned int iTelID )
+        {
+            if( iTelID < VDST_MAXTELESCOPES )
+            {
+                return fImageIndex[iTelID];
+            }
+            return -1;
+        }
+        bool             hasParameterErrors()
+        {
+            return bParameterErrors;
+        }
+        bool             hasPixelList()
+        {
+            return bPixelList;
+        }
+    
+    private:
+    
+        Int_t            fLastEntryBytes;
+        
+        bool             setBranchAddress( const char* iName, void* iAddress );
+};
+
 class Ctpars
 {
     public :
@@ -26,6 +122,8 @@ class Ctpars
         bool            bPixelList;
         TTree*          fChain;                   //!pointer to the analyzed TTree or TChain
         Int_t           fCurrent;                 //!current Tree number in a TChain
+        CtparsSparse*   fSparse;                  //!image parameters of all telescopes (sparse layout; not owned)
+        unsigned int    fSparseTelID;             //!telescope in sparse layout (counting from 0)
         
         // Declaration of leave types
         Int_t           telID;
@@ -198,6 +296,7 @@ class Ctpars
         TBranch*        b_PixelPE;   //!
         
         Ctpars( TTree* tree = 0, bool iMC = false, unsigned int iShort = false );
+        Ctpars( CtparsSparse* iSparse, unsigned int iTelID, bool iMC = false, unsigned int iShort = false );
         virtual ~Ctpars();
         virtual Int_t    GetEntry( Long64_t entry );
         virtual Long64_t LoadTree( Long64_t entry );
@@ -221,6 +320,10 @@ class Ctpars
         {
             return bPixelList;
         }
+    
+    private:
+    
+        void             resetSparse();
 };
 #endif
 
@@ -237,6 +340,9 @@ class Ctpars
 */
 Ctpars::Ctpars( TTree* tree, bool iMC, unsigned int iShort )
 {
+    fChain = 0;
+    fSparse = 0;
+    fSparseTelID = 0;
     if( !tree )
     {
         return;
@@ -254,6 +360,41 @@ Ctpars::Ctpars( TTree* tree, bool iMC, unsigned int iShort )
 }
 
 
+/*
+    image parameters of telescope iTelID (counting from 0) from the
+    sparse layout (one tree for all telescopes)
+    
+    values for telescopes without image in an event are those of
+    an empty image
+*/
+Ctpars::Ctpars( CtparsSparse* iSparse, unsigned int iTelID, bool iMC, unsigned int iShort )
+{
+    fChain = 0;
+    fCurrent = -1;
+    fSparse = iSparse;
+    fSparseTelID = iTelID;
+    bMC = iMC;
+    bShort = iShort;
+    bParameterErrors = false;
+    bPixelList = false;
+    if( fSparse )
+    {
+        bParameterErrors = fSparse->hasParameterErrors();
+        bPixelList = fSparse->hasPixelList();
+    }
+    eventNumber = 0;
+    muonX0 = 0.;
+    muonY0 = 0.;
+    muonRadius = 0.;
+    muonRSigma = 0.;
+    muonSize = 0.;
+    muonIPCorrectedSize = 0.;
+    muonValid = 0;
+    houghMuonValid = 0;
+    resetSparse();
+}
+
+
 Ctpars::~Ctpars()
 {
     if( !fChain )
@@ -266,6 +407,71 @@ Ctpars::~Ctpars()
 
 Int_t Ctpars::GetEntry( Long64_t entry )
 {
+    // sparse layout: read event (once for all telescopes) and
+    // copy parameters of this telescope
+    if( fSparse )
+    {
+        Int_t nbytes = fSparse->GetEntry( entry );
+        int i = fSparse->getImageIndex( fSparseTelID );
+        if( i < 0 )
+        {
+            resetSparse();
+            return nbytes;
+        }
+        meanPed_Image = fSparse->meanPed_Image[i];
+        meanPedvar_Image = fSparse->meanPedvar_Image[i];
+        cen_x = fSparse->cen_x[i];
+        cen_y = fSparse->cen_y[i];
+        f_s = fSparse->f_s[i];
+        f_d = fSparse->f_d[i];
+        f_sdevxy = fSparse->f_sdevxy[i];
+        length = fSparse->length[i];
+        width = fSparse->width[i];
+        size = fSparse->size[i];
+        size2 = fSparse->size2[i];
+        loss = fSparse->loss[i];
+        fracLow = fSparse->fracLow[i];
+        fui = fSparse->fui[i];
+        dist = fSparse->dist[i];
+        alpha = fSparse->alpha[i];
+        los = fSparse->los[i];
+        phi = fSparse->phi[i];
+        cosphi = fSparse->cosphi[i];
+        sinphi = fSparse->sinphi[i];
+        ntubes = fSparse->ntubes[i];
+        ntubesBNI = fSparse->ntubesBNI[i];
+        nsat = fSparse->nsat[i];
+        nlowgain = fSparse->nlowgain[i];
+        for( unsigned int j = 0; j < 3; j++ )
+        {
+            max[j] = fSparse->max[i][j];
+            index_of_max[j] = fSparse->index_of_max[i][j];
+        }
+        asymmetry = fSparse->asymmetry[i];
+        tgrad_x = fSparse->tgrad_x[i];
+        tchisq_x = fSparse->tchisq_x[i];
+        Fitstat = fSparse->Fitstat[i];
+        dcen_x = fSparse->dcen_x[i];
+        dcen_y = fSparse->dcen_y[i];
+        dlength = fSparse->dlength[i];
+        dwidth = fSparse->dwidth[i];
+        dphi = fSparse->dphi[i];
+        PixelListN = 0;
+        if( bPixelList )
+        {
+            PixelListN = fSparse->PixelListN[i];
+            unsigned int p0 = fSparse->fPixelIndex[i];
+            for( unsigned int p = 0; p < PixelListN && p < VDST_MAXCHANNELS; p++ )
+            {
+                PixelID[p] = fSparse->PixelID[p0 + p];
+                PixelType[p] = fSparse->PixelType[p0 + p];
+                PixelIntensity[p] = fSparse->PixelIntensity[p0 + p];
+                PixelTimingT0[p] = fSparse->PixelTimingT0[p0 + p];
+                PixelPE[p] = fSparse->PixelPE[p0 + p];
+            }
+        }
+        return nbytes;
+    }
     // Read contents of entry.
     if( !fChain )
     {
@@ -275,6 +481,53 @@ Int_t Ctpars::GetEntry( Long64_t entry )
 }
 
 
+/*
+    parameters of an empty image (sparse layout, telescope without image)
+*/
+void Ctpars::resetSparse()
+{
+    meanPed_Image = 0.;
+    meanPedvar_Image = 0.;
+    cen_x = 0.;
+    cen_y = 0.;
+    f_s = 0.;
+    f_d = 0.;
+    f_sdevxy = 0.;
+    length = 0.;
+    width = 0.;
+    size = 0.;
+    size2 = 0.;
+    loss = 0.;
+    fracLow = 0.;
+    fui = 0.;
+    dist = 0.;
+    alpha = 0.;
+    los = 0.;
+    phi = 0.;
+    cosphi = 0.;
+    sinphi = 0.;
+    ntubes = 0;
+    ntubesBNI = 0;
+    nsat = 0;
+    nlowgain = 0;
+    for( unsigned int j = 0; j < 3; j++ )
+    {
+        max[j] = 0.;
+        index_of_max[j] = 0;
+    }
+    asymmetry = 0.;
+    tgrad_x = 0.;
+    tchisq_x = 0.;
+    Fitstat = -1;
+    dcen_x = 0.;
+    dcen_y = 0.;
+    dlength = 0.;
+    dwidth = 0.;
+    dphi = 0.;
+    PixelListN = 0;
+}
+
+
 Long64_t Ctpars::LoadTree( Long64_t entry )
 {
     // Set the environment to read one entry
@@ -826,4 +1079,233 @@ void Ctpars::Show( Long64_t entry )
 }
 
 
+/*
+
+    reader for sparse layout (one tree for all telescopes)
+    
+    bShort as for Ctpars (branches not needed are not read)
+
+*/
+CtparsSparse::CtparsSparse( TTree* tree, unsigned int iShort )
+{
+    fChain = 0;
+    fCurrentEntry = -1;
+    fLastEntryBytes = 0;
+    bShort = iShort;
+    bParameterErrors = false;
+    bPixelList = false;
+    NImages = 0;
+    PixelListNPixelNN = 0;
+    for( unsigned int i = 0; i < VDST_MAXTELESCOPES; i++ )
+    {
+        fImageIndex[i] = -1;
+        fPixelIndex[i] = 0;
+        TelID[i] = 0;
+        meanPed_Image[i] = 0.;
+        meanPedvar_Image[i] = 0.;
+        cen_x[i] = 0.;
+        cen_y[i] = 0.;
+        f_s[i] = 0.;
+        f_d[i] = 0.;
+        f_sdevxy[i] = 0.;
+        length[i] = 0.;
+        width[i] = 0.;
+        size[i] = 0.;
+        size2[i] = 0.;
+        loss[i] = 0.;
+        fracLow[i] = 0.;
+        fui[i] = 0.;
+        dist[i] = 0.;
+        alpha[i] = 0.;
+        los[i] = 0.;
+        phi[i] = 0.;
+        cosphi[i] = 0.;
+        sinphi[i] = 0.;
+        ntubes[i] = 0;
+        ntubesBNI[i] = 0;
+        nsat[i] = 0;
+        nlowgain[i] = 0;
+        for( unsigned int j = 0; j < 3; j++ )
+        {
+            max[i][j] = 0.;
+            index_of_max[i][j] = 0;
+        }
+        asymmetry[i] = 0.;
+        tgrad_x[i] = 0.;
+        tchisq_x[i] = 0.;
+        Fitstat[i] = -1;
+        dcen_x[i] = 0.;
+        dcen_y[i] = 0.;
+        dlength[i] = 0.;
+        dwidth[i] = 0.;
+        dphi[i] = 0.;
+        PixelListN[i] = 0;
+    }
+    
+    Init( tree );
+}
+
+
+CtparsSparse::~CtparsSparse()
+{
+    if( !fChain )
+    {
+        return;
+    }
+    delete fChain->GetCurrentFile();
+}
+
+
+bool CtparsSparse::setBranchAddress( const char* iName, void* iAddress )
+{
+    if( !fChain->GetBranch( iName ) )
+    {
+        return false;
+    }
+    fChain->SetBranchStatus( iName, 1 );
+    fChain->SetBranchAddress( iName, iAddress );
+    return true;
+}
+
+
+void CtparsSparse::Init( TTree* tree )
+{
+    if( tree == 0 )
+    {
+        return;
+    }
+    fChain = tree;
+    fCurrentEntry = -1;
+    // read only branches with addresses
+    fChain->SetBranchStatus( "*", 0 );
+    
+    setBranchAddress( "NImages", &NImages );
+    setBranchAddress( "TelID", TelID );
+    if( bShort <= 2 )
+    {
+        setBranchAddress( "meanPedvar_Image", meanPedvar_Image );
+        setBranchAddress( "length", length );
+        setBranchAddress( "width", width );
+        setBranchAddress( "size", size );
+        setBranchAddress( "size2", size2 );
+        setBranchAddress( "loss", loss );
+    }
+    if( bShort <= 1 )
+    {
+        setBranchAddress( "meanPed_Image", meanPed_Image );
+        setBranchAddress( "cen_x", cen_x );
+        setBranchAddress( "cen_y", cen_y );
+        setBranchAddress( "f_d", f_d );
+        setBranchAddress( "f_s", f_s );
+        setBranchAddress( "f_sdevxy", f_sdevxy );
+        setBranchAddress( "fracLow", fracLow );
+        setBranchAddress( "fui", fui );
+        setBranchAddress( "dist", dist );
+        setBranchAddress( "ntubes", ntubes );
+        setBranchAddress( "cosphi", cosphi );
+        setBranchAddress( "sinphi", sinphi );
+        setBranchAddress( "ntubesBNI", ntubesBNI );
+        setBranchAddress( "nsat", nsat );
+        setBranchAddress( "nlowgain", nlowgain );
+        setBranchAddress( "asymmetry", asymmetry );
+        setBranchAddress( "tgrad_x", tgrad_x );
+        setBranchAddress( "Fitstat", Fitstat );
+        bParameterErrors = setBranchAddress( "dcen_x", dcen_x );
+        if( bParameterErrors )
+        {
+            setBranchAddress( "dcen_y", dcen_y );
+            setBranchAddress( "dlength", dlength );
+            setBranchAddress( "dwidth", dwidth );
+            setBranchAddress( "dphi", dphi );
+        }
+        // pixel lists (addresses are set in GetEntry())
+        bPixelList = setBranchAddress( "PixelListN", PixelListN );
+        if( bPixelList )
+        {
+            setBranchAddress( "PixelListNPixelNN", &PixelListNPixelNN );
+            fChain->SetBranchStatus( "PixelID", 1 );
+            fChain->SetBranchStatus( "PixelType", 1 );
+            fChain->SetBranchStatus( "PixelIntensity", 1 );
+            fChain->SetBranchStatus( "PixelTimingT0", 1 );
+            fChain->SetBranchStatus( "PixelPE", 1 );
+        }
+    }
+    if( bShort == 0 )
+    {
+        setBranchAddress( "alpha", alpha );
+        setBranchAddress( "los", los );
+        setBranchAddress( "phi", phi );
+        setBranchAddress( "max", max );
+        setBranchAddress( "index_of_max", index_of_max );
+        setBranchAddress( "tchisq_x", tchisq_x );
+    }
+}
+
+
+/*
+    read event (only once per entry for all telescopes)
+*/
+Int_t CtparsSparse::GetEntry( Long64_t entry )
+{
+    if( !fChain )
+    {
+        return 0;
+    }
+    if( entry == fCurrentEntry )
+    {
+        return fLastEntryBytes;
+    }
+    // reset index of previous event
+    for( unsigned int i = 0; i < NImages && i < VDST_MAXTELESCOPES; i++ )
+    {
+        if( TelID[i] < VDST_MAXTELESCOPES )
+        {
+            fImageIndex[TelID[i]] = -1;
+        }
+    }
+    // size of pixel lists
+    if( bPixelList )
+    {
+        Long64_t centry = fChain->LoadTree( entry );
+        TBranch* iB = fChain->GetBranch( "PixelListNPixelNN" );
+        if( centry >= 0 && iB )
+        {
+            iB->GetEntry( centry );
+        }
+        if( PixelListNPixelNN + 1 > PixelID.size() )
+        {
+            PixelID.resize( PixelListNPixelNN + 1, 0 );
+            PixelType.resize( PixelListNPixelNN + 1, 0 );
+            PixelIntensity.resize( PixelListNPixelNN + 1, 0. );
+            PixelTimingT0.resize( PixelListNPixelNN + 1, 0. );
+            PixelPE.resize( PixelListNPixelNN + 1, 0. );
+        }
+        fChain->SetBranchAddress( "PixelID", &PixelID[0] );
+        fChain->SetBranchAddress( "PixelType", &PixelType[0] );
+        fChain->SetBranchAddress( "PixelIntensity", &PixelIntensity[0] );
+        fChain->SetBranchAddress( "PixelTimingT0", &PixelTimingT0[0] );
+        fChain->SetBranchAddress( "PixelPE", &PixelPE[0] );
+    }
+    fLastEntryBytes = fChain->GetEntry( entry );
+    fCurrentEntry = entry;
+    if( NImages > VDST_MAXTELESCOPES )
+    {
+        NImages = VDST_MAXTELESCOPES;
+    }
+    UInt_t iPixelIndex = 0;
+    for( unsigned int i = 0; i < NImages; i++ )
+    {
+        if( TelID[i] < VDST_MAXTELESCOPES )
+        {
+            fImageIndex[TelID[i]] = ( int )i;
+        }
+        fPixelIndex[i] = iPixelIndex;
+        if( bPixelList )
+        {
+            iPixelIndex += PixelListN[i];
+        }
+    }
+    return fLastEntryBytes;
+}
+
 #endif                                            // #ifdef Ctpars_cxx
@@ -24,6 +24,8 @@
 #include "TLeaf.h"
 #include "TStyle.h"
 #include "TSystem.h"
+#include "TMD5.h"
+#include "TNamed.h"
 #include "TTree.h"
 
 #include <bitset>
@@ -47,8 +49,11 @@ class VAnaSum
         
         void doStereoAnalysis();
         void initialize( string i_longlistfilename, unsigned int iRunType,
-                         string i_outfile, int iRandomSeed, string fRunParameterfile );
+                         string i_outfile, int iRandomSeed, string fRunParameterfile,
+                         int iSelectedRunOn = -1 );
         void terminate();
+        bool updateRunCache( string i_longlistfilename, string iCacheDirectory,
+                             int iRandomSeed, string fRunParameterfile );
         
     private:
     
@@ -59,9 +64,15 @@ class VAnaSum
                              double i_sig, double i_rate, double i_rateOFF, VOnOff* fstereo_onoff );
         double getAzRange( int i_run, string i_treename, double& azmin, double& azmax );
         double getNoiseLevel( int i_run );
+        string getFileSignature( string iFile, string iDirectory = "" );
+        string getRunCacheKey( VAnaSumRunParameter* iRunPara, unsigned int iRunCounter,
+                               string iRunParameterfile, int iRandomSeed );
+        bool   isValidRunCache( string iCacheFile, string iCacheKey );
         
         set< int > fOldRunList;
         
+        string fCacheKey;                         //!< key identifying run-wise results in incremental mode
+        
         unsigned int fAnalysisRunMode;            // 0: loop over all files (sequentiell)
         // 1: combine several anasum result file and merge analysis results
         
@@ -180,6 +180,10 @@ class VAnaSumRunParameter : public TNamed, public VGlobalRunParameter
         
         unsigned int fWriteEventTree;   // 0=don't fill the event tree; 1=write all events; 2=write events after direction cuts (default)
         
+        // DL3 event lists
+        unsigned int fWriteDL3EventList; // 0=DL3 tree only (default); 1=DL3 tree and FITS event list; 2=FITS event list only
+        string fDL3FITSDirectory;        // output directory for FITS event lists
+        
         // Likelihood Spectral Analysis
         bool fLikelihoodAnalysis;
         
@@ -256,6 +260,7 @@ class VAnaSumRunParameter : public TNamed, public VGlobalRunParameter
         void printStereoParameter( unsigned int icounter );
         void printStereoParameter( int irun );
         int  readRunParameter( string i_filename, bool fIgnoreZeroExclusionRegion = false );
+        bool selectRun( int iRunOn );
         bool setRunTimes( unsigned int irun, double iMJDStart, double iMJDStopp );
         bool setSkyMapCentreJ2000( unsigned int i, double ra, double dec );
         bool setTargetRADecJ2000( unsigned int i, double ra, double dec, string iTargetName );
@@ -264,6 +269,6 @@ class VAnaSumRunParameter : public TNamed, public VGlobalRunParameter
         bool writeListOfExcludedSkyRegions( int inonRun );
         bool getListOfExcludedSkyRegions( TFile* f, int inonRun );
         
-        ClassDef( VAnaSumRunParameter, 17 );
+        ClassDef( VAnaSumRunParameter, 18 );
 };
 #endif
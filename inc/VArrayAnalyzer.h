@@ -16,6 +16,8 @@
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <sstream>
 #include <string>
 
 class VArrayAnalyzer : public VEvndispData, public VGrIsuAnalyzer
@@ -26,6 +28,7 @@ class VArrayAnalyzer : public VEvndispData, public VGrIsuAnalyzer
         bool fInitialized;                        //!< true after initialization
         
         vector< VDispAnalyzer* > fDispAnalyzer;
+        static map< string, VDispAnalyzer* > fDispAnalyzerCache;   //!< disp analyzers (key: method, weight file, telescope types)
         
         vector< double > fMeanPointingMismatch;   //!< mean pointing mismatch between eventdisplay and vbf (per telescope)
         vector< double > fNMeanPointingMismatch;
@@ -66,6 +69,7 @@ class VArrayAnalyzer : public VEvndispData, public VGrIsuAnalyzer
         
         void calcShowerDirection_and_Core();      //!< calculate shower core and direction
         void checkPointing();                     //!< check for mismatching between different pointing values
+        VDispAnalyzer* getDispAnalyzer( string iFile, string iDispMethod );
         void initializeDispAnalyzer( unsigned int iStereoMethodID );
         void prepareforCoreReconstruction( unsigned int iMeth, float xs, float ys );
         void prepareforDirectionReconstruction( unsigned int iMethIndex, unsigned int iReconstructionMethod );
@@ -98,6 +102,7 @@ class VArrayAnalyzer : public VEvndispData, public VGrIsuAnalyzer
         void updatePointingToArbitraryTime( int iMJD, double iTime ) ;
         void initAnalysis();
         void initOutput();
+        void resetRun();
         void terminate( bool iDebug_IO = false );
         void initTree();
 };
@@ -6,6 +6,7 @@
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #ifdef ASTROSLALIB
 #include "VASlalib.h"
@@ -22,6 +23,9 @@ class VAstronometry
 {
     private:
     
+#ifdef ASTROSOFA
+        static void vlaPrecesMatrix( double MJD_ep0, double MJD_ep1, double rot_prec[3][3] );
+#endif
         static void test_vlaDjcl();
         static void test_vlaCldj();
         static void test_vlaPreces();
@@ -62,6 +66,7 @@ class VAstronometry
         static void vlaDe2h( double ha, double dec, double phi, double* az, double* el );
         static void vlaDh2e( double az, double el, double phi, double* ha, double* dec );
         static void vlaPreces( double MJD_ep0, double MJD_ep1, double* ra, double* dc );
+        static void vlaPreces( double MJD_ep0, double MJD_ep1, vector< double >& ra, vector< double >& dc );
         
         static string getAstronometryLibrary();
         static void test();
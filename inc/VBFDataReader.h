@@ -4,17 +4,35 @@
 #define VBFDATAREADER_H
 
 #include "VBaseRawDataReader.h"
+#include "VEventPrefetchRing.h"
 
 #include <VBankFileReader.h>
 #include <VPacket.h>
 
 #include <bitset>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 using namespace std;
 
+/*
+ * packet read by the prefetch thread
+ */
+class VBFPrefetchPacket
+{
+    public:
+    
+        VPacket* fPacket;
+        string   fError;                  // exception message for read errors
+        
+        VBFPrefetchPacket()
+        {
+            fPacket = 0;
+        }
+};
+
 class VBFDataReader : public VBaseRawDataReader
 {
     protected:
@@ -30,6 +48,15 @@ class VBFDataReader : public VBaseRawDataReader
         
         vector< bool > ib_temp;
         
+        // asynchronous reading
+        unsigned int fPrefetchWindow;
+        unsigned int fPrefetchIndex;            // next packet to be read by the prefetch thread
+        bool         fPrefetchError;
+        VEventPrefetchRing< VBFPrefetchPacket > fPrefetchRing;
+        
+        bool         readNextPacket( VPacket*& iPacket );
+        void         stopPrefetch();
+    
     public:
         VBFDataReader( string,
                        int isourcetype,
@@ -67,12 +94,18 @@ class VBFDataReader : public VBaseRawDataReader
         {
             return at;
         }
+        int64_t           getEventPosition()
+        {
+            return ( int64_t )index - 1;
+        }
         vector< bool >&   getLocalTrigger();
         bool              getNextEvent();
         unsigned int      getNTelLocalTrigger();
         uint16_t          getNumSamples();
         bool              hasArrayTrigger();
         bool              hasLocalTrigger( unsigned int iTel );
+        bool              setEventPosition( int64_t iPosition );
+        void              setPrefetchWindow( unsigned int iWindow = 0 );
         void              setPerformFADCAnalysis( unsigned int iTel, bool iB )
         {
             iB = false;
@@ -58,6 +58,14 @@ class VBaseRawDataReader : public VVirtualDataReader, public VSimulationDataRead
 
         VMonteCarloRunHeader* fMonteCarloHeader;
 
+        // decoded samples of the current event (per telescope; [hit channel * nsamples + sample])
+        vector< vector< uint8_t > > fSampleBuffer;
+        vector< VEvent* >  fSampleBufferEvent;
+        vector< uint32_t > fSampleBufferEventNumber;
+        vector< uint16_t > fSampleBufferNSamples;
+        
+        bool              fillSampleBuffer();
+        
         // QADC values
         std::valarray<double> fSums;
         std::valarray<double> fTraceMax;
@@ -239,6 +247,7 @@ class VBaseRawDataReader : public VVirtualDataReader, public VSimulationDataRead
         }
         uint8_t                     getSample( unsigned channel, unsigned sample, bool iNewNoiseTrace = true );
         std::vector< uint8_t >      getSamplesVec();
+        VDataSpan< uint8_t >        getSamplesSpan( uint32_t iHitID );
         uint32_t                    getHitID( uint32_t i );
         bool                        getHiLo( uint32_t i );
         unsigned int                getTelescopeID()
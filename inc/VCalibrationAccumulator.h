@@ -0,0 +1,191 @@
+//! VCalibrationAccumulator per-channel statistics for gain and time offset calibration (flasher/laser runs)
+
+#ifndef VCalibrationAccumulator_H
+#define VCalibrationAccumulator_H
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <valarray>
+#include <vector>
+
+#include "TH1F.h"
+#include "TProfile.h"
+
+using namespace std;
+
+/*
+ * binned distribution for all channels of a telescope
+ * (bin layout as in ROOT: underflow, nBins, overflow)
+ */
+class VCalibrationDistribution
+{
+    private:
+    
+        unsigned int fNChannels;
+        unsigned int fNBins;
+        double fXmin;
+        double fXmax;
+        double fScale;                             // nBins / ( xmax - xmin )
+        
+        vector< float > fBinContent;               // [channel * (nBins+2) + bin]
+        vector< double > fEntries;
+        vector< double > fSumW;                    // statistics of fills inside the histogram range
+        vector< double > fSumWX;
+        vector< double > fSumWX2;
+    
+    public:
+    
+        vector< float > fMean;
+        vector< float > fRMS;
+        vector< float > fMedian;
+        
+        VCalibrationDistribution();
+        ~VCalibrationDistribution() {}
+        
+        void   calculate( unsigned int iChannel );
+        void   fill( unsigned int iChannel, double x )
+        {
+            fEntries[iChannel]++;
+            unsigned int iOffset = iChannel * ( fNBins + 2 );
+            if( x < fXmin )
+            {
+                fBinContent[iOffset]++;
+                return;
+            }
+            if( !( x < fXmax ) )
+            {
+                fBinContent[iOffset + fNBins + 1]++;
+                return;
+            }
+            unsigned int iBin = ( unsigned int )( ( x - fXmin ) * fScale );
+            if( iBin >= fNBins )
+            {
+                iBin = fNBins - 1;
+            }
+            fBinContent[iOffset + iBin + 1]++;
+            fSumW[iChannel]++;
+            fSumWX[iChannel]  += x;
+            fSumWX2[iChannel] += x * x;
+        }
+        double getEntries( unsigned int iChannel )
+        {
+            return fEntries[iChannel];
+        }
+        TH1F*  getHistogram( unsigned int iChannel, string iName, string iTitle );
+        void   init( unsigned int iNChannels, unsigned int iNBins, double iXmin, double iXmax );
+};
+
+/*
+ * profile (mean y per x bin) for all channels of a telescope
+ */
+class VCalibrationProfile
+{
+    private:
+    
+        unsigned int fNChannels;
+        unsigned int fNBins;
+        double fXmin;
+        double fXmax;
+        double fScale;
+        double fYmin;                              // fills outside [fYmin,fYmax] are ignored (if fYmin < fYmax)
+        double fYmax;
+        
+        vector< double > fBinEntries;              // [channel * (nBins+2) + bin]
+        vector< double > fSumY;
+        vector< double > fSumY2;
+        vector< double > fEntries;
+    
+    public:
+    
+        VCalibrationProfile();
+        ~VCalibrationProfile() {}
+        
+        void   fill( unsigned int iChannel, double x, double y )
+        {
+            if( fYmin < fYmax && ( y < fYmin || y > fYmax ) )
+            {
+                return;
+            }
+            unsigned int iBin = 0;
+            if( !( x < fXmin ) )
+            {
+                if( x < fXmax )
+                {
+                    iBin = ( unsigned int )( ( x - fXmin ) * fScale ) + 1;
+                    if( iBin > fNBins )
+                    {
+                        iBin = fNBins;
+                    }
+                }
+                else
+                {
+                    iBin = fNBins + 1;
+                }
+            }
+            unsigned int i = iChannel * ( fNBins + 2 ) + iBin;
+            fEntries[iChannel]++;
+            fBinEntries[i]++;
+            fSumY[i]  += y;
+            fSumY2[i] += y * y;
+        }
+        TProfile* getProfile( unsigned int iChannel, string iName, string iTitle, string iErrorOption = "" );
+        void   init( unsigned int iNChannels, unsigned int iNBins, double iXmin, double iXmax, double iYmin = 0., double iYmax = 0. );
+        void   setEntries( unsigned int iChannel, double iEntries )
+        {
+            fEntries[iChannel] = iEntries;
+        }
+};
+
+/*
+ * accumulator for gain and time offset calibration
+ */
+class VCalibrationAccumulator
+{
+    private:
+    
+        unsigned int fNChannels;
+        unsigned int fNSamples;
+        bool fPulseShape;
+        
+        vector< double > fNPulseEvents;            // number of events contributing to the mean pulses
+    
+    public:
+    
+        VCalibrationDistribution fGain;
+        VCalibrationDistribution fTOff;
+        VCalibrationProfile      fTOff_vs_Sum;
+        VCalibrationProfile      fPulse;
+        VCalibrationProfile      fTCPulse;
+        
+        VCalibrationAccumulator();
+        ~VCalibrationAccumulator() {}
+        
+        void   fill( const valarray< double >& iSums, const valarray< double >& iTZeros, const vector< unsigned char >& iUse,
+                     double iMeanSum, double iMeanTZero );
+        void   fillPulse( unsigned int iChannel, double iSample, double iContent, double iTCorr )
+        {
+            fPulse.fill( iChannel, iSample, iContent );
+            fTCPulse.fill( iChannel, iSample - iTCorr, iContent );
+        }
+        void   countPulseEvent( unsigned int iChannel )
+        {
+            fNPulseEvents[iChannel]++;
+        }
+        unsigned int getNChannels()
+        {
+            return fNChannels;
+        }
+        bool   hasPulseShape()
+        {
+            return fPulseShape;
+        }
+        void   init( unsigned int iNChannels, unsigned int iNSamples, bool iPulseShape );
+        bool   isInitialized()
+        {
+            return ( fNChannels > 0 );
+        }
+        void   terminate( unsigned int iNThreads = 0 );
+};
+
+#endif
@@ -3,6 +3,7 @@
 #ifndef VCALIBRATOR_H
 #define VCALIBRATOR_H
 
+#include "VCalibrationAccumulator.h"
 #include "VImageBaseAnalyzer.h"
 #include "VPedestalCalculator.h"
 #include "VDB_CalibrationInfo.h"
@@ -40,11 +41,8 @@ class VCalibrator : public VImageBaseAnalyzer
         map< ULong64_t, TClonesArray* > fPedestalsHistoClonesArray;
         TFile* opfgain;
         TFile* opftoff;
-        vector<TH1F* > hgain;
-        vector<TProfile* > hpulse;
-        vector<TProfile* > htcpulse;
-        vector<TH1F* > htoff;
-        vector<TProfile* > htoff_vs_sum;
+        VCalibrationAccumulator fGainTOffAccumulator;           // gain/toffset statistics for all channels
+        vector< unsigned char > fGainTOffUse;                   // channels used for gain/toffset calculation (current event)
         int fPedPerTelescopeTypeMinCnt;                         // statistical limit for IPR calculation
 
         //Extra calib output.
@@ -84,11 +82,16 @@ class VCalibrator : public VImageBaseAnalyzer
         vector< string > fLowGainMultiplierNameC;
         vector< string > fLowGainTZeroFileNameC;
 
+        map< string, vector< VCalibrationData* > > fCalDataCache;   //!< calibration data (key: calibration input, see getCalibrationDataKey())
+
         TTree* fillCalibrationSummaryTree( unsigned int itel, string iName, vector<TH1F* > h );
+        TTree* fillCalibrationSummaryTree( unsigned int itel, string iName,
+                                           vector< float >& iMean, vector< float >& iMedian, vector< float >& iRMS );
         bool   fillPedestalTree( unsigned int tel, VPedestalCalculator* iP );
         bool   initializePedestalHistograms( ULong64_t iTelType, bool iLowGain,
                                              vector< double > minSumPerSumWindow,
                                              vector< double > maxSumPerSumWindow );
+        string getCalibrationDataKey();
         void getCalibrationRunNumbers();
         int  getCalibrationRunNumbers_fromCalibFile();
         unsigned int getNumberOfEventsUsedInCalibration( vector< int > iE, int iTelID );
@@ -0,0 +1,163 @@
+//! VCompiledLookupTableFile binary, memory-mapped representation of a lookup table file
+
+#ifndef VCompiledLookupTableFile_H
+#define VCompiledLookupTableFile_H
+
+#include "TClass.h"
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TH2.h"
+#include "TKey.h"
+#include "TROOT.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+ * file header of a compiled lookup table file
+ *
+ * (all values in native byte order)
+ */
+struct sCompiledLookupTableHeader
+{
+    char     fMagic[8];
+    uint32_t fVersion;
+    uint32_t fByteOrder;
+    uint64_t fNTables;
+    uint64_t fIndexOffset;
+    uint64_t fDataOffset;
+    uint64_t fFileSize;
+};
+
+/*
+ * one entry in the directory index
+ *
+ * fName is the full path of the histogram in the
+ * original table file, e.g. tel_1/NOISE_00250/ze_200/woff_0500/az_0/mscw/width_median_tb
+ */
+struct sCompiledLookupTableIndex
+{
+    char     fName[256];
+    int32_t  fNbinsX;
+    int32_t  fNbinsY;
+    double   fXmin;
+    double   fXmax;
+    double   fYmin;
+    double   fYmax;
+    uint64_t fOffset;       // offset of bin contents (followed by bin errors) from start of file
+    uint64_t fNBins;        // number of bins including under- and overflow bins
+};
+
+/*
+ * read-only view of a single table
+ *
+ * bin numbering follows the ROOT convention
+ * (bin 0: underflow, bin nbins+1: overflow)
+ */
+class VCompiledLookupTable
+{
+    public:
+    
+        string        fName;
+        int           fNbinsX;
+        int           fNbinsY;
+        double        fXmin;
+        double        fXmax;
+        double        fYmin;
+        double        fYmax;
+        const double* fContent;
+        const double* fError;
+        
+        VCompiledLookupTable();
+        ~VCompiledLookupTable() {}
+        
+        int    findBinX( double x ) const;
+        int    findBinY( double y ) const;
+        int    getBin( int ix, int iy ) const;
+        double getBinCenterX( int i ) const
+        {
+            return fXmin + ( i - 0.5 ) * ( ( fXmax - fXmin ) / fNbinsX );
+        }
+        double getBinCenterY( int i ) const
+        {
+            return fYmin + ( i - 0.5 ) * ( ( fYmax - fYmin ) / fNbinsY );
+        }
+        double getBinContent( int ix, int iy ) const
+        {
+            return fContent[getBin( ix, iy )];
+        }
+        double getBinError( int ix, int iy ) const
+        {
+            return fError[getBin( ix, iy )];
+        }
+        int    getNbinsX() const
+        {
+            return fNbinsX;
+        }
+        int    getNbinsY() const
+        {
+            return fNbinsY;
+        }
+};
+
+class VCompiledLookupTableFile
+{
+    private:
+    
+        bool   fDebug;
+        string fFileName;
+        int    fFileDescriptor;
+        void*  fMappedData;
+        size_t fMappedSize;
+        
+        map< string, VCompiledLookupTable > fTables;
+        set< string > fDirectories;
+        
+        static bool compileDirectory( TDirectory* iDir, string iPath, ofstream& iOutFile,
+                                      vector< sCompiledLookupTableIndex >& iIndex );
+        static void writePadding( ofstream& iOutFile );
+    
+    public:
+    
+        VCompiledLookupTableFile();
+        ~VCompiledLookupTableFile();
+        
+        void   close();
+        static bool compile( string iInputFile, string iOutputFile );
+        vector< string > getListOfDirectories( string iPath );
+        string getFileName()
+        {
+            return fFileName;
+        }
+        unsigned int getNTables()
+        {
+            return fTables.size();
+        }
+        const VCompiledLookupTable* getTable( string iName );
+        bool   hasDirectory( string iPath )
+        {
+            return ( fDirectories.find( iPath ) != fDirectories.end() );
+        }
+        static bool isCompiledLookupTableFile( string iFile );
+        bool   open( string iFile );
+        void   setDebug( bool iB = false )
+        {
+            fDebug = iB;
+        }
+};
+
+#endif
@@ -19,6 +19,8 @@ using namespace std;
 
 #define VDST_MAXTELESCOPES  180
 
+class VRNTupleWriter;
+
 class VTMVA_eval_dist
 {
     public:
@@ -72,6 +74,9 @@ class VDL2Writer
         
         // event data
         TTree* fDL2DataTree;
+        // RNTuple output in addition to the DL2 tree (0 = no, 1 = yes)
+        int    fWriteRNTuple;
+        VRNTupleWriter* fDL2RNTupleWriter;
         
         Int_t runNumber;
         Int_t eventNumber;
@@ -121,6 +126,7 @@ class VDL2Writer
     
         VDL2Writer( string iConfigFile );
         ~VDL2Writer();
+        void  closeRNTuple();
         bool  fill( CData* d );
         string getDataFile()
         {
@@ -130,5 +136,6 @@ class VDL2Writer
         {
             return fDL2DataTree;
         }
+        bool  initializeRNTuple( TDirectory* iDir );
 };
 #endif
@@ -0,0 +1,93 @@
+//! VDL3FITSWriter buffered writer for DL3 event lists in FITS format (GADF)
+
+#ifndef VDL3FITSWriter_H
+#define VDL3FITSWriter_H
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fitsio.h>
+
+#include "VGlobalRunParameter.h"
+#include "VTimeMask.h"
+
+using namespace std;
+
+class VDL3FITSWriter
+{
+    private:
+    
+        fitsfile* fptr;
+        string    fFileName;
+        int       fRunNumber;
+        
+        unsigned int fChunkSize;                  // number of rows buffered before writing to disk
+        LONGLONG     fNRowsWritten;
+        
+        // column buffers (EVENTS table)
+        vector< LONGLONG > fEVENT_ID;
+        vector< double >   fTIME;
+        vector< float >    fRA;
+        vector< float >    fDEC;
+        vector< float >    fENERGY;
+        vector< float >    fALT;
+        vector< float >    fAZ;
+        vector< short >    fMULTIP;
+        vector< float >    fDETX;
+        vector< float >    fDETY;
+        vector< float >    fCOREX;
+        vector< float >    fCOREY;
+        vector< float >    fHIL_MSW;
+        vector< float >    fHIL_MSL;
+        vector< float >    fEMISSION_HEIGHT;
+        vector< float >    fACCEPTANCE;
+        
+        // header information
+        string fObject;
+        string fObservatory;
+        double fRA_OBJ;
+        double fDEC_OBJ;
+        double fRA_PNT;
+        double fDEC_PNT;
+        double fGeoLon;
+        double fGeoLat;
+        double fAltitude;
+        
+        bool   printerror( int status );
+        void   clearBuffers();
+        bool   writeTimeKeywords();
+        bool   writeGTI( const VTimeMask* iTimeMask, double& iOnTime );
+    
+    public:
+    
+        // time reference (MJD, UTC)
+        static const int    fMJDREFI = 51910;
+        static double       getTime( int iMJD, double iTime_s )
+        {
+            return ( double )( iMJD - fMJDREFI ) * 86400. + iTime_s;
+        }
+        
+        VDL3FITSWriter( unsigned int iChunkSize = 100000 );
+        ~VDL3FITSWriter();
+        
+        bool close( double iMJDStart, double iMJDStopp, const VTimeMask* iTimeMask, double iDeadTimeFraction );
+        void fill( int iEventNumber, int iMJD, double iTime_s, double iRA_deg, double iDec_deg, double iEnergy_TeV,
+                   double iAlt_deg, double iAz_deg, int iNImages, double iXoff_deg, double iYoff_deg,
+                   double iXcore_m, double iYcore_m, double iMSCW, double iMSCL, double iEmissionHeight, double iAcceptance );
+        bool flush();
+        string getFileName()
+        {
+            return fFileName;
+        }
+        bool isOpen()
+        {
+            return ( fptr != 0 );
+        }
+        bool open( string iFileName, int iRunNumber );
+        void setObservatory( string iObservatory, double iLongitude_deg, double iLatitude_deg, double iAltitude_m );
+        void setTarget( string iObject, double iRA_OBJ, double iDEC_OBJ, double iRA_PNT, double iDEC_PNT );
+};
+
+#endif
@@ -5,6 +5,7 @@
 
 #include "VGlobalRunParameter.h"
 #include "VDSTTree.h"
+#include "VEventPrefetchRing.h"
 #include "VVirtualDataReader.h"
 
 #include "TFile.h"
@@ -19,6 +20,58 @@
 // MAXIMUM NUMBERS OF TELESCOPES AND CHANNELS ARE DEFINED IN EVNDISP_definition.h
 ///////////////////////////////////////////////////////////////////////////////////
 
+/*
+ * data of one event read from the DST tree
+ *
+ * (vectors are indexed by telescope and channel)
+ */
+class VDSTReaderEvent
+{
+    public:
+    
+        unsigned int fStatus;                     // 1 = successfull, 0 = read error, 999 = no next event
+        uint32_t     fRunNumber;
+        uint32_t     fEventNumber;
+        uint8_t      fEventType;
+        uint32_t     fGPS[5];
+        uint16_t     fGPSYear;
+        uint16_t     fATGPSYear;
+        unsigned int fNLocalTrigger;
+        
+        unsigned short int fMCPrimary;
+        float        fMCEnergy;
+        float        fMCxcore;
+        float        fMCycore;
+        float        fMCxcos;
+        float        fMCycos;
+        float        fMCze;
+        float        fMCaz;
+        float        fMCxoff;
+        float        fMCyoff;
+        
+        vector< valarray< double > > fPedestal;
+        vector< valarray< double > > fSums;
+        vector< valarray< double > > fPe;
+        vector< vector< valarray< double > > > fTracePulseTiming;
+        vector< vector < unsigned int > > fDead;
+        vector< valarray< double > > fTraceMax;
+        vector< valarray< double > > fRawTraceMax;
+        vector< vector< unsigned short int > > fZeroSuppressed;
+        vector< float > fLTtime;
+        vector< float > fLDTtime;
+        vector< double > fTelAzimuth;
+        vector< double > fTelElevation;
+        vector< vector< bool > > fFullTrigVec;
+        vector< vector < bool > > fHiLo;
+        vector< int > fNumberofFullTrigger;
+        vector< bool > fDSTvltrig;
+        vector< bool > fHasLocalTrigger;
+        vector< unsigned short int > fDSTl2trig_type;
+        vector< vector< vector< uint16_t > > > fFADCTrace;
+        
+        VDSTReaderEvent();
+};
+
 class VDSTReader : public VVirtualDataReader
 {
     private:
@@ -36,35 +89,25 @@ class VDSTReader : public VVirtualDataReader
         vector< uint16_t >     fNumSamples;
         unsigned int fSelectedHitChannel;
         vector< unsigned int > fNChannel;
-        vector< valarray< double > > fPedestal;
-        vector< valarray< double > > fSums;
-        vector< valarray< double > > fPe;
-        vector< vector< valarray< double > > > fTracePulseTiming;
-        vector< vector < unsigned int > > fDead;
-        vector< valarray< double > > fTraceMax;
-        vector< valarray< double > > fRawTraceMax;
-        vector< float > fLTtime;
-        vector< float > fLDTtime;
-        vector< double > fTelAzimuth;
-        vector< double > fTelElevation;
 
+        VDSTReaderEvent fEvent;                   //!< current event
         vector< vector< bool > > fFullHitVec;
-        vector< vector< bool > > fFullTrigVec;
-        vector< vector < bool > > fHiLo;
-        vector< int > fNumberofFullTrigger;
 
         vector< uint8_t > fDummySample;
         vector< uint16_t > fDummySample16Bit;
-        vector< vector< vector< uint16_t > > > fFADCTrace;
 
-        vector< bool > fDSTvltrig;
-        vector< unsigned short int > fDSTl2trig_type;
+        // asynchronous reading
+        unsigned int fPrefetchWindow;             //!< number of events read ahead (0 = no prefetching)
+        unsigned int fPrefetchTreeEvent;          //!< next tree event to be read by the prefetch thread
+        VEventPrefetchRing< VDSTReaderEvent > fPrefetchRing;
+        VMonteCarloRunHeader* fMonteCarloHeader;
 
+        bool fillEvent( VDSTReaderEvent& iEvent, unsigned int iTreeEvent );
         bool init();                              //!< open source file and init tree
 
     public:
         VDSTReader( string isourcefile, bool iMC, int iNTel, bool iDebug );
-        ~VDSTReader() {}
+        ~VDSTReader();
         bool isZeroSuppressed( unsigned int iChannel );
         unsigned short int getZeroSuppressionFlag( unsigned int iChannel );
         std::pair< bool, uint32_t > getChannelHitIndex( uint32_t i_channel );
@@ -78,19 +121,19 @@ class VDSTReader : public VVirtualDataReader
         }
         vector<unsigned int>&       getDead()
         {
-            return fDead[fTelID];
+            return fEvent.fDead[fTelID];
         }
         uint32_t                    getEventNumber()
         {
-            return fDSTTree->getDSTEventNumber();
+            return fEvent.fEventNumber;
         }
         uint8_t                     getEventType()
         {
-            return fDSTTree->getDSTEventType();
+            return fEvent.fEventType;
         }
         uint8_t                     getATEventType()
         {
-            return fDSTTree->getDSTEventType();
+            return fEvent.fEventType;
         }
         unsigned int   getDSTTreeEvent()
         {
@@ -100,48 +143,56 @@ class VDSTReader : public VVirtualDataReader
         {
             return fFullHitVec[fTelID];
         }
+        const vector< bool >&       getFullHitVecRef()
+        {
+            return fFullHitVec[fTelID];
+        }
         vector< bool >              getFullTrigVec()
         {
-            return fFullTrigVec[fTelID];
+            return fEvent.fFullTrigVec[fTelID];
+        }
+        const vector< bool >&       getFullTrigVecRef()
+        {
+            return fEvent.fFullTrigVec[fTelID];
         }
         int                         getNumberofFullTrigger()
         {
-            return fNumberofFullTrigger[fTelID];
+            return fEvent.fNumberofFullTrigger[fTelID];
         }
         uint32_t                    getGPS0()
         {
-            return fDSTTree->getDSTGPS0();
+            return fEvent.fGPS[0];
         }
         uint32_t                    getGPS1()
         {
-            return fDSTTree->getDSTGPS1();
+            return fEvent.fGPS[1];
         }
         uint32_t                    getGPS2()
         {
-            return fDSTTree->getDSTGPS2();
+            return fEvent.fGPS[2];
         }
         uint32_t                    getGPS3()
         {
-            return fDSTTree->getDSTGPS3();
+            return fEvent.fGPS[3];
         }
         uint32_t                    getGPS4()
         {
-            return fDSTTree->getDSTGPS4();
+            return fEvent.fGPS[4];
         }
         uint16_t                    getGPSYear()
         {
-            return fDSTTree->getDSTGPSYear();
+            return fEvent.fGPSYear;
         }
         uint16_t                    getATGPSYear()
         {
-            return fDSTTree->getDSTATGPSYear();
+            return fEvent.fATGPSYear;
         }
         uint32_t                    getHitID( uint32_t );
         bool                        getHiLo( uint32_t i )
         {
-            if( i < fHiLo[fTelID].size() )
+            if( i < fEvent.fHiLo[fTelID].size() )
             {
-                return fHiLo[fTelID][i];
+                return fEvent.fHiLo[fTelID][i];
             }
             else
             {
@@ -150,13 +201,13 @@ class VDSTReader : public VVirtualDataReader
         }
         vector< bool >&             getLocalTrigger()
         {
-            return fDSTvltrig;
+            return fEvent.fDSTvltrig;
         }
         unsigned short int          getLocalTriggerType( unsigned int iTelID )
         {
-            if( iTelID < fDSTl2trig_type.size() )
+            if( iTelID < fEvent.fDSTl2trig_type.size() )
             {
-                return fDSTl2trig_type[iTelID];
+                return fEvent.fDSTl2trig_type[iTelID];
             }
             else
             {
@@ -165,9 +216,9 @@ class VDSTReader : public VVirtualDataReader
         }
         float                       getLocalTriggerTime( unsigned int iTel )
         {
-            if( iTel < fLTtime.size() )
+            if( iTel < fEvent.fLTtime.size() )
             {
-                return fLTtime[iTel];
+                return fEvent.fLTtime[iTel];
             }
             else
             {
@@ -176,9 +227,9 @@ class VDSTReader : public VVirtualDataReader
         }
         float                       getLocalDelayedTriggerTime( unsigned int iTel )
         {
-            if( iTel < fLDTtime.size() )
+            if( iTel < fEvent.fLDTtime.size() )
             {
-                return fLDTtime[iTel];
+                return fEvent.fLDTtime[iTel];
             }
             else
             {
@@ -207,43 +258,47 @@ class VDSTReader : public VVirtualDataReader
         TTree*                      getMCTree();
         int                         getMC_primary()
         {
-            return fDSTTree->getDSTMCPrimary();    //!< MC primary type
+            return fEvent.fMCPrimary;    //!< MC primary type
         }
         float                       getMC_energy()                  //!< MC primary energy
         {
-            return fDSTTree->getDSTMCEnergy();
+            return fEvent.fMCEnergy;
         }
         float     getMC_X()                       //!< MC x-coordinate of impact point on ground plane
         {
-            return fDSTTree->getDSTMCxcore();
+            return fEvent.fMCxcore;
         }
         float     getMC_Y()                       //!< MC y-coordinate of impact point on ground plane
         {
-            return fDSTTree->getDSTMCycore();
+            return fEvent.fMCycore;
         }
         float     getMC_Xcos()                    //!< MC x direction cosine of primary in ground coordinate system
         {
-            return fDSTTree->getDSTMCxcos();
+            return fEvent.fMCxcos;
         }
         float     getMC_Ycos()                    //!< MC y direction cosine of primary in ground coordinate system
         {
-            return fDSTTree->getDSTMCycos();
+            return fEvent.fMCycos;
         }
         float     getMC_Ze()                      //!< MC zenith angle of primary
         {
-            return fDSTTree->getDSTMCze();
+            return fEvent.fMCze;
         }
         float     getMC_Az()                      //!< MC azimuth angle of primary
         {
-            return fDSTTree->getDSTMCaz();
+            return fEvent.fMCaz;
         }
         float     getMC_Xoffset()                 //!< MC x coordinate of source location in degrees
         {
-            return fDSTTree->getDSTMCxoff();
+            return fEvent.fMCxoff;
         }
         float     getMC_Yoffset()                 //!< MC x coordinate of source location in degrees
         {
-            return fDSTTree->getDSTMCyoff();
+            return fEvent.fMCyoff;
+        }
+        int64_t      getEventPosition()
+        {
+            return ( int64_t )fDSTtreeEvent - 1;
         }
         bool         getNextEvent();
         VMonteCarloRunHeader*         getMonteCarloHeader();
@@ -253,7 +308,7 @@ class VDSTReader : public VVirtualDataReader
         }
         unsigned int                  getNTelLocalTrigger()
         {
-            return fDSTTree->getDSTNLocalTrigger();
+            return fEvent.fNLocalTrigger;
         }
         unsigned int                  getNTel()
         {
@@ -261,23 +316,24 @@ class VDSTReader : public VVirtualDataReader
         }
         uint32_t                      getRunNumber()
         {
-            return fDSTTree->getDSTRunNumber();
+            return fEvent.fRunNumber;
         }
         valarray< double >&           getPedestal()
         {
-            return fPedestal[fTelID];
+            return fEvent.fPedestal[fTelID];
         }
         vector< uint8_t >             getSamplesVec();
         uint8_t                       getSample( unsigned channel, unsigned sample, bool iNewNoiseTrace = true );
         vector< uint16_t >            getSamplesVec16Bit();
+        VDataSpan< uint16_t >         getSamplesSpan16Bit( uint32_t iHitID );
         uint16_t                      getSample16Bit( unsigned channel, unsigned sample, bool iNewNoiseTrace = true );
         valarray< double >&           getSums( unsigned int iNChannel = 99999 )
         {
-            return fSums[fTelID];
+            return fEvent.fSums[fTelID];
         }
         valarray< double >&           getPE( unsigned int iNChannel = 99999 )
         {
-            return fPe[fTelID];
+            return fEvent.fPe[fTelID];
         }
         string                        getSourceFileName()
         {
@@ -285,11 +341,11 @@ class VDSTReader : public VVirtualDataReader
         }
         vector< double >              getTelAzimuth()
         {
-            return fTelAzimuth;
+            return fEvent.fTelAzimuth;
         }
         vector< double >              getTelElevation()
         {
-            return fTelElevation;
+            return fEvent.fTelElevation;
         }
         unsigned int                  getTelescopeID()
         {
@@ -297,15 +353,15 @@ class VDSTReader : public VVirtualDataReader
         }
         valarray< double >&           getTraceMax( unsigned int iNChannel = 99999 )
         {
-            return fTraceMax[fTelID];
+            return fEvent.fTraceMax[fTelID];
         }
         valarray< double >&           getTraceRawMax( unsigned int iNChannel = 99999 )
         {
-            return fRawTraceMax[fTelID];
+            return fEvent.fRawTraceMax[fTelID];
         }
         vector< valarray< double > >& getTracePulseTiming( unsigned int iNChannel = 99999 )
         {
-            return fTracePulseTiming[fTelID];
+            return fEvent.fTracePulseTiming[fTelID];
         }
         bool      has16Bit()
         {
@@ -324,13 +380,13 @@ class VDSTReader : public VVirtualDataReader
         }
         bool      hasLocalTrigger( unsigned int iTel )
         {
-            if( fDSTTree->hasLocalTrigger( iTel ) < 0 )
+            if( iTel < fEvent.fHasLocalTrigger.size() )
             {
-                return false;
+                return fEvent.fHasLocalTrigger[iTel];
             }
             else
             {
-                return true;
+                return false;
             }
         }
         bool      isMC()
@@ -355,6 +411,8 @@ class VDSTReader : public VVirtualDataReader
                 fPerformFADCAnalysis[iTelID] = iB;
             }
         }
+        bool      setEventPosition( int64_t iPosition );
+        void      setPrefetchWindow( unsigned int iWindow = 0 );
         bool      setTelescopeID( unsigned int );
         void      setTrigger( vector<bool> iImage, vector<bool> iBorder );          //!< set trigger values
         bool      wasLossyCompressed()
@@ -111,6 +111,10 @@ class VDataMCComparision
         // angle for shower max correction
         double fShowerMaxZe_deg;
         
+        // accumulators (parallel filling): reduced printout
+        bool fQuiet;
+        
+        void selectBranches( TTree* iTree, bool iAzimuthWeighting = false );
         void setEntries( TH1D* );
         void setEntries( TH2D* );
         
@@ -120,7 +124,9 @@ class VDataMCComparision
     public:
     
         VDataMCComparision( string, int, bool );
+        VDataMCComparision( VDataMCComparision* iParent );
         ~VDataMCComparision() {}
+        bool addHistograms( VDataMCComparision* iAccumulator );
         void defineHistograms();
         bool fillHistograms( string ifile, int iSingleTelescopeCuts );
         TH1D* getAzimuthWeightingHistogram( string ifile );
@@ -0,0 +1,61 @@
+//! VDataSpan non-owning view of data held by a data reader
+
+#ifndef VDATASPAN_H
+#define VDATASPAN_H
+
+/*
+ * read-only view (pointer + length + stride) into a buffer
+ * owned by a data reader (e.g. FADC samples of one channel)
+ *
+ * the view is valid until the reader reads the next event
+ *
+ * an empty view means that the reader can not provide direct
+ * access to the data (e.g. samples are modified on access by
+ * noise injection); use the copying interface in this case
+ */
+template< class T > class VDataSpan
+{
+    private:
+    
+        const T*     fData;
+        unsigned int fSize;
+        unsigned int fStride;
+    
+    public:
+    
+        VDataSpan()
+        {
+            fData = 0;
+            fSize = 0;
+            fStride = 1;
+        }
+        VDataSpan( const T* iData, unsigned int iSize, unsigned int iStride = 1 )
+        {
+            fData = iData;
+            fSize = ( iData ? iSize : 0 );
+            fStride = iStride;
+        }
+        
+        const T& operator[]( unsigned int i ) const
+        {
+            return fData[i * fStride];
+        }
+        const T* data() const
+        {
+            return fData;
+        }
+        bool empty() const
+        {
+            return ( fSize == 0 );
+        }
+        unsigned int size() const
+        {
+            return fSize;
+        }
+        unsigned int stride() const
+        {
+            return fStride;
+        }
+};
+
+#endif
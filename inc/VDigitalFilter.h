@@ -0,0 +1,41 @@
+//! VDigitalFilter pole-zero correction, upsampling and smoothing of FADC traces (blocks of channels)
+
+#ifndef VDigitalFilter_H
+#define VDigitalFilter_H
+
+#include <vector>
+
+using namespace std;
+
+class VDigitalFilter
+{
+    private:
+    
+        // filter coefficients (recalculated for new parameters only)
+        unsigned int fUpSample;
+        float        fPoleZero;
+        float        fMult;                        // 1 / upsample^2 (normalisation of the two running sums)
+        
+        // interleaved block buffers ([sample * fBlockSize + lane])
+        vector< float > fBlockIn;
+        vector< float > fBlockOut;
+        
+        void filterBlock( unsigned int n, const float* iBaseline, float* iMax, int* iAt );
+    
+    public:
+    
+        static const unsigned int fBlockSize = 8;  // number of channels filtered together
+        
+        VDigitalFilter();
+        ~VDigitalFilter() {}
+        
+        void filter( unsigned int iNTraces, unsigned int iNSamples, const float* iIn, const float* iBaseline,
+                     float* iOut, float* iMax, int* iAt );
+        unsigned int getUpSample()
+        {
+            return fUpSample;
+        }
+        void setParameters( unsigned int iUpSample, float iPoleZero );
+};
+
+#endif
@@ -0,0 +1,84 @@
+//! VEventIndex event number to file position index for random access to events
+
+#ifndef VEventIndex_H
+#define VEventIndex_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace std;
+
+/*
+ * file header of an event index file
+ *
+ * (all values in native byte order; followed by fNEvents
+ *  pairs of event number (uint32_t) and position (int64_t))
+ */
+struct sEventIndexHeader
+{
+    char     fMagic[8];
+    uint32_t fVersion;
+    uint32_t fComplete;
+    int64_t  fSourceFileSize;
+    int64_t  fSourceFileModTime;
+    uint64_t fNEvents;
+};
+
+class VEventIndex
+{
+    private:
+    
+        bool    fDebug;
+        string  fSourceFile;
+        int64_t fSourceFileSize;
+        int64_t fSourceFileModTime;
+        
+        map< uint32_t, int64_t > fIndex;     // event number -> position of event in source file
+        bool    fComplete;                   // all events of the source file are in the index
+        bool    fChanged;                    // index changed since reading or writing
+        
+        bool    getSourceFileStatus( string iSourceFile, int64_t& iSize, int64_t& iModTime );
+    
+    public:
+    
+        VEventIndex();
+        ~VEventIndex() {}
+        
+        void    addEvent( uint32_t iEventNumber, int64_t iPosition );
+        static string getIndexFileName( string iDirectory, string iSourceFile );
+        bool    getPosition( uint32_t iEventNumber, int64_t& iPosition );
+        bool    getPreviousEvent( uint32_t iEventNumber, uint32_t& iPreviousEventNumber );
+        string  getSourceFile()
+        {
+            return fSourceFile;
+        }
+        unsigned int getNEvents()
+        {
+            return fIndex.size();
+        }
+        bool    isChanged()
+        {
+            return fChanged;
+        }
+        bool    isComplete()
+        {
+            return fComplete;
+        }
+        bool    readIndexFile( string iIndexFile );
+        void    reset( string iSourceFile = "" );
+        void    setComplete( bool iB = true );
+        void    setDebug( bool iB = false )
+        {
+            fDebug = iB;
+        }
+        bool    writeIndexFile( string iIndexFile );
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include <TApplication.h>
 #include <TGClient.h>
 #include <TQObject.h>
+#include <TROOT.h>
 #include <TSystem.h>
 #include <TTree.h>
 
@@ -23,7 +24,9 @@
 #include "VPedestalCalculator.h"
 #include "VPEReader.h"
 #include "VEvndispRunParameter.h"
+#include "VEventIndex.h"
 
+#include <fstream>
 #include <iostream>
 #include <map>
 #include <string>
@@ -69,11 +72,17 @@ class VEventLoop : public VEvndispData
 
         int  fTimeCut_RunStartSeconds;                 //!< run start in seconds of the day
 
+        VEventIndex fEventIndex;                  //!< event number -> position in data file
+        bool fEventIndexSequential;               //!< file read sequentially from first event (index complete at end of file)
+        bool fResetAnaData;                       //!< reset analysis data storage classes at next initialization (new run)
+        
         int      analyzeEvent();                  //!< analyze current event
         int      checkArrayCuts();                //!< check cuts (see tab cut option) for current event
         int      checkCuts();                     //!< check cuts (see tab cut option) for current event
         int      checkTimeCuts();                 //!< check time cuts
         void     fillTriggerVectors();
+        bool     loopEventList( int iEvents );    //!< analyse events from event list
+        vector< unsigned int > readEventList( string iFile );
         void     setEventTimeFromReader();        //! calculate event time in appropriate format
         void     printRunInfos();                 //!< print some information about current run
         void     terminate( int );
@@ -118,14 +127,15 @@ class VEventLoop : public VEvndispData
         {
             return fReader;
         }
-        void        gotoEvent( int iNumber );     //!< goto event iNumber
+        bool        gotoEvent( int iNumber );     //!< goto event iNumber
         bool        initEventLoop();              //!< init values for file names and analyzer
         //!< init values for file names
         bool        initEventLoop( string iDataFile );
         void        initializeAnalyzers();        //!< initialize analyzers (call at first event)
         bool        loop( int );                  //!< analyse certain number of events
         bool        nextEvent();                  //!< goto next event and analyze it
-        void        previousEvent();              //!< goto previous event (doesn't work yet)
+        void        previousEvent();              //!< goto previous event (requires event index)
+        bool        resetRun( VEvndispRunParameter* );  //!< reset run dependent data (analysis of several runs)
         void        resetRunOptions();            //!< reset options to standard values
         void        setCutString( string );       //!< set cut string (from display)
         void        setCutNArrayTrigger( int );   //!< set minimal number of triggered telescopes
@@ -0,0 +1,162 @@
+//! VEventPrefetchRing ring of event buffers filled by a reader thread
+
+#ifndef VEVENTPREFETCHRING_H
+#define VEVENTPREFETCHRING_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/*
+ * ring of event buffers for asynchronous event reading
+ *
+ * a reader thread fills up to iWindow buffers ahead of the
+ * analysis thread using the function given in start();
+ * the fill function returns false at the end of the data.
+ *
+ * next() hands the oldest filled buffer to the caller by
+ * swapping it with the caller's buffer (no copy of event data)
+ *
+ */
+template< class T > class VEventPrefetchRing
+{
+    private:
+    
+        vector< T >    fSlot;
+        unsigned int   fHead;                        // next slot to be served
+        unsigned int   fTail;                        // next slot to be filled
+        unsigned int   fNFilled;
+        bool           fEndOfData;
+        bool           fStop;
+        bool           fRunning;
+        
+        function< bool( T& ) > fFill;
+        mutex              fMutex;
+        condition_variable fFilled;
+        condition_variable fFree;
+        thread             fThread;
+        
+        void run()
+        {
+            for( ;; )
+            {
+                unsigned int i_slot = 0;
+                {
+                    unique_lock< mutex > i_lock( fMutex );
+                    fFree.wait( i_lock, [this] { return fStop || fNFilled < fSlot.size(); } );
+                    if( fStop )
+                    {
+                        break;
+                    }
+                    i_slot = fTail;
+                }
+                // slot fTail is not visible to the consumer: fill without lock
+                bool i_filled = fFill( fSlot[i_slot] );
+                
+                unique_lock< mutex > i_lock( fMutex );
+                if( !i_filled )
+                {
+                    fEndOfData = true;
+                    fFilled.notify_all();
+                    break;
+                }
+                fTail = ( fTail + 1 ) % fSlot.size();
+                fNFilled++;
+                fFilled.notify_all();
+            }
+        }
+    
+    public:
+    
+        VEventPrefetchRing()
+        {
+            fHead = 0;
+            fTail = 0;
+            fNFilled = 0;
+            fEndOfData = false;
+            fStop = false;
+            fRunning = false;
+        }
+        ~VEventPrefetchRing()
+        {
+            stop();
+        }
+        
+        bool isRunning()
+        {
+            return fRunning;
+        }
+        
+        /*
+         * hand next filled event buffer to the caller
+         *
+         * (blocks until the reader thread has filled a buffer;
+         *  returns false at the end of the data)
+         */
+        bool next( T& iEvent )
+        {
+            unique_lock< mutex > i_lock( fMutex );
+            fFilled.wait( i_lock, [this] { return fNFilled > 0 || fEndOfData || fStop; } );
+            if( fNFilled == 0 )
+            {
+                return false;
+            }
+            swap( iEvent, fSlot[fHead] );
+            fHead = ( fHead + 1 ) % fSlot.size();
+            fNFilled--;
+            fFree.notify_all();
+            return true;
+        }
+        
+        /*
+         * start reader thread
+         *
+         * iWindow:  number of events read ahead
+         * iEvent:   template used to allocate the event buffers
+         */
+        bool start( unsigned int iWindow, const T& iEvent, function< bool( T& ) > iFill )
+        {
+            stop();
+            if( iWindow == 0 )
+            {
+                return false;
+            }
+            fSlot.assign( iWindow, iEvent );
+            fHead = 0;
+            fTail = 0;
+            fNFilled = 0;
+            fEndOfData = false;
+            fStop = false;
+            fFill = iFill;
+            fRunning = true;
+            fThread = thread( &VEventPrefetchRing::run, this );
+            return true;
+        }
+        
+        /*
+         * stop reader thread
+         *
+         * (buffers already filled can still be retrieved with next())
+         */
+        void stop()
+        {
+            {
+                unique_lock< mutex > i_lock( fMutex );
+                fStop = true;
+            }
+            fFree.notify_all();
+            fFilled.notify_all();
+            if( fThread.joinable() )
+            {
+                fThread.join();
+            }
+            fRunning = false;
+        }
+};
+
+#endif
@@ -20,10 +20,12 @@
 #include "VDB_PixelDataReader.h"
 #include "VEvndispRunParameter.h"
 #include "VStarCatalogue.h"
+#include "VImageParameterSparseTree.h"
 #include "VShowerParameters.h"
 #include "VPointing.h"
 #include "VArrayPointing.h"
 #include "VTraceHandler.h"
+#include "VUtilities.h"
 
 #include "TDirectory.h"
 #include "TFile.h"
@@ -32,6 +34,7 @@
 
 #include <bitset>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -62,6 +65,7 @@ class VEvndispData
         static bool fNoTelescopePointing;
         // cameras
         static VDetectorGeometry* fDetectorGeo;
+        static string fDetectorGeoKey;            //!< configuration used to read fDetectorGeo (empty: do not reuse)
         static VDetectorTree* fDetectorTree;
         
         // reader
@@ -122,6 +126,7 @@ class VEvndispData
         static vector< VImageAnalyzerData* > fAnaData; //!< data class with analysis results for each telescope
         //!< data class with analysis results from all telescopes
         static VShowerParameters* fShowerParameters;
+        static VImageParameterSparseTree* fImageParameterSparseTree;
         static VMCParameters* fMCParameters;      //!< data class with MC parameters
         
         // timing results
@@ -792,6 +797,10 @@ class VEvndispData
         {
             return fShowerParameters;
         }
+        VImageParameterSparseTree* getImageParameterSparseTree()
+        {
+            return fImageParameterSparseTree;
+        }
         int                 getSumFirst()
         {
             return fRunPar->fsumfirst[fTelID];
@@ -1058,6 +1067,10 @@ class VEvndispData
         {
             return fAnaData[fTelID]->getTraceWidth( true );
         }
+        VTraceCache*        getTraceCache()
+        {
+            return fAnaData[fTelID]->getTraceCache();
+        }
         VTraceHandler*      getTraceHandler()
         {
             return fTraceHandler;
@@ -1677,7 +1690,7 @@ class VEvndispData
         {
             fCalData[fTelID]->setAverageTZero( iTZero, iLowGain );
         }
-        void                setTrace( unsigned int iChannel, vector< double > fT, bool iHiLo, double iPeds )
+        void                setTrace( unsigned int iChannel, const vector< double >& fT, bool iHiLo, double iPeds )
         {
             fAnaData[fTelID]->setTrace( iChannel, fT, iHiLo, iPeds );
         }
@@ -73,6 +73,9 @@ class VEvndispRunParameter : public TNamed, public VGlobalRunParameter
         int    fFirstEvent;                       // skip up till this event
         int    fTimeCutsMin_min;                  // start to analyse run at this min
         int    fTimeCutsMin_max;                  // stop to analyse this run at this min
+        unsigned int fPrefetchNEvents;            // number of events read ahead by a reader thread (0 = synchronous reading)
+        string fEventListFile;                    // analyse only events listed in this file
+        string fEventIndexDirectory;              // directory for event index files (random access to events)
         
         bool fprintdeadpixelinfo ;       // DEADCHAN if true, will print list of dead pixels
         // at end of run to evndisp.log
@@ -141,7 +144,10 @@ class VEvndispRunParameter : public TNamed, public VGlobalRunParameter
         bool fNoCalibNoPb;                        // if true, when no information for gain and toff can be found, the analysis is done filling thenm with 1 and 0 respectively (in VCalibrator)
         bool fNextDayGainHack;            //if true, and > 100 channels in one telescope have gain=0, all gains in that tel will be set to 1; gains won't be tested in the dead channel finder.
         bool fWriteExtraCalibTree;        // write additional tree into .gain.root file with channel charges/monitor charge/nHiLo for each event
+        bool fWriteCalibrationHistograms; // write per-channel gain/toffset histograms into .gain.root/.toff.root files
+        unsigned int fCalibrationNThreads; // number of threads used for gain/toffset calculation (0 = all cores)
         bool fWriteImagePixelList;        // write image pixel list to tpars tree
+        bool fWriteSparseImageTree;       // write image parameters of all telescopes into one tree (tparsSparse) instead of tpars trees
         string fLowGainCalibrationFile;           // file with file name for low-gain calibration
         int fNCalibrationEvents;                  // events to be used for calibration
         float faverageTZeroFiducialRadius;        // fiducial radius for average tzero calculation (DST), in fraction of FOV
@@ -327,6 +333,6 @@ class VEvndispRunParameter : public TNamed, public VGlobalRunParameter
             return fuseDB;
         }
         
-        ClassDef( VEvndispRunParameter, 1002 ); //(increase this number)
+        ClassDef( VEvndispRunParameter, 1006 ); //(increase this number)
 };
 #endif
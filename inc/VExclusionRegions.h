@@ -11,6 +11,7 @@
 
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -186,11 +186,19 @@ class VGrIsuReader : public VVirtualDataReader
         {
             return fFullHitVec[fTelescopeID];
         }
+        const std::vector< bool >&  getFullHitVecRef()
+        {
+            return fFullHitVec[fTelescopeID];
+        }
         //!< get triggered channels
         std::vector< bool >         getFullTrigVec()
         {
             return fFullTrigVec[fTelescopeID];
         }
+        const std::vector< bool >&  getFullTrigVecRef()
+        {
+            return fFullTrigVec[fTelescopeID];
+        }
         int                         getNumberofFullTrigger()
         {
             return fNumberofFullTrigger[fTelescopeID];
@@ -200,6 +208,10 @@ class VGrIsuReader : public VVirtualDataReader
         {
             return fFullAnaVec[fTelescopeID];
         }
+        const std::vector< int >&   getFullAnaVecRef()
+        {
+            return fFullAnaVec[fTelescopeID];
+        }
         uint8_t                     getEventType()
         {
             return fEventType;
@@ -291,6 +303,7 @@ class VGrIsuReader : public VVirtualDataReader
         uint8_t                     getSample( unsigned channel, unsigned sample, bool iNewNoiseTrace = true );
         //!< return FADC samples vector for current hit channel
         std::vector< uint8_t >      getSamplesVec();
+        VDataSpan< uint8_t >        getSamplesSpan( uint32_t iHitID );
         std::vector< double >       getTelElevation()
         {
             return fTelElevation;
@@ -381,12 +394,22 @@ class VGrIsuReader : public VVirtualDataReader
         }
 
         // rawfile
+        //!< position of current shower event in the data file
+        int64_t                     getEventPosition()
+        {
+            if( fPedestalMode )
+            {
+                return -1;
+            }
+            return ( int64_t )sp;
+        }
         //!< read in next event
         bool                        getNextEvent();
         //!< create next pedestal event
         bool                        getNextPedestalEvent();
         //!< read next shower event from file
         bool                        getNextShowerEvent();
+        bool                        setEventPosition( int64_t iPosition );
 
         // MC
         bool                       isMC()         //!< GrIsu type data is always MC
@@ -11,6 +11,7 @@
 #include "VImageAnalyzerHistograms.h"
 #include "VSpecialChannel.h"
 #include "VImageParameter.h"
+#include "VTraceCache.h"
 
 #include <valarray>
 #include <vector>
@@ -104,6 +105,9 @@ class VImageAnalyzerData
         vector< double > fFADCstopTZero;
         vector< double > fFADCstopSum;
 
+        // decoded traces of the current event
+        VTraceCache fTraceCache;
+
         // mean pulse histograms
         TList* hMeanPulses;
         vector< TProfile2D* > hMeanPulseHigh;     //!< high gain mean pulse
@@ -142,6 +146,10 @@ class VImageAnalyzerData
         valarray<double>&        getTTrigger();
         valarray<double>&        getTZeros( bool iCorrected );
         valarray<double>&        getTraceWidth( bool iCorrected );
+        VTraceCache*             getTraceCache()
+        {
+            return &fTraceCache;
+        }
         VSpecialChannel*         getSpecialChannel()
         {
             return fSpecialChannel;
@@ -154,10 +162,11 @@ class VImageAnalyzerData
         bool                     readSpecialChannels( int iRunNumber, string iEpoch,
                 string ispecialchannelfile,
                 string ithroughputfile, string iDirectory );
+        void                     resetRun();
         void                     setTraceIntegrationMethod( unsigned iN = 1 )
         {
             fTraceIntegrationMethod = iN;
         }
-        void                     setTrace( unsigned int iChannel, vector< double > fT, bool iHiLo, double fPeds );
+        void                     setTrace( unsigned int iChannel, const vector< double >& fT, bool iHiLo, double fPeds );
 };
 #endif
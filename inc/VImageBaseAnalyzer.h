@@ -20,12 +20,19 @@ class VImageBaseAnalyzer : public VEvndispData
         vector<bool> fCalibrated;                 //!  true = calibration is done
         bool fRaw;
 
+        // channel lists for filling of the trace cache (reused for each event)
+        vector< unsigned int > fTraceCacheHitID;
+        vector< unsigned int > fTraceCacheChanID;
+        vector< double > fTraceCachePed;
+        vector< double > fTraceCacheHiLo;
+
         void calcSecondTZerosSums();
         void calcTZeros( int , int );
         void calcTZerosSums( int, int, unsigned int );
         unsigned int getDynamicSummationWindow( unsigned int chanID );
         int  getFADCTraceIntegrationPosition( int iPos );
         void FADCStopCorrect();
+        void fillTraceCache();
         bool setSpecialChannels();
         void timingCorrect();
         TTree* makeDeadChannelTree();
@@ -98,6 +98,7 @@ class VImageCleaning
 
         VImageCleaning( VEvndispData* iData = 0 );
         ~VImageCleaning() {}
+        void resetRun();                            //!< reset run dependent NN cleaning data (IPR graphs, probability curves)
 
         // tailcut cleaning
         void cleanImageFixed( VImageCleaningRunParameter* iImageCleaningParameters );
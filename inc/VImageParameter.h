@@ -188,6 +188,10 @@ class VImageParameter
         }
         void printParameters();
         void reset( unsigned int resetLevel = 0 );
+        void resetTree()                          //!< forget tree (owned by the closed output file of the previous run)
+        {
+            tpars = 0;
+        }
         void setImageBorderPixelPosition( vector< float > iImageBorderPixelPosition_x, vector< float > iImageBorderPixelPosition_y );
         void setMC()
         {
@@ -3,6 +3,7 @@
 #ifndef VImageParameterCalculation_H
 #define VImageParameterCalculation_H
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <valarray>
@@ -13,6 +14,7 @@
 #include "VHoughTransform.h"
 #include "VImageParameter.h"
 #include "VImageParameterFitter.h"
+#include "VLinearRegression.h"
 
 #include "TError.h"
 #include "TMath.h"
@@ -45,6 +47,28 @@ class VImageParameterCalculation
 
         VEvndispData* fData;
 
+        // time gradient fit (buffers are reused for each image)
+        VLinearRegression fTimeGradientFit;
+        vector< double > fTimeFitX;
+        vector< double > fTimeFitT;
+        vector< double > fTimeFitE;
+        vector< bool >   fTimeFitUse;
+        vector< double > fTimeFitXDistribution;
+        void   getTimeFitQuartiles( double i_xmin, double i_xmax, double& q1, double& q3 );
+
+        // compacted list of image/border pixels and gathered pixel data
+        // (buffers are reused for each image; padded with zero signals to a multiple of fMomentLanes)
+        static const unsigned int fMomentLanes = 4;
+        vector< unsigned int > fImagePixelList;
+        vector< double > fImagePixelX;
+        vector< double > fImagePixelY;
+        vector< double > fImagePixelSignal;
+        vector< double > fImagePixelSignal2;
+        vector< double > fImagePixelOuterRing;    // 1 for pixels in outer ring
+        vector< double > fImagePixelDeadRing;     // 1 for pixels next to dead pixels
+        vector< double > fImagePixelLowGain;      // 1 for low-gain pixels
+        void   fillImagePixelList();
+
         double getFractionOfImageBorderPixelUnderImage( double, double, double, double, double, double );
         void   setImageBorderPixelPosition( VImageParameter* iPar );
 
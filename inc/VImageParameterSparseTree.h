@@ -0,0 +1,91 @@
+//! VImageParameterSparseTree image parameters of all telescopes with images in one tree (one entry per event)
+
+#ifndef VImageParameterSparseTree_H
+#define VImageParameterSparseTree_H
+
+#include "TTree.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "VGlobalRunParameter.h"
+#include "VImageParameter.h"
+
+using namespace std;
+
+class VImageParameterSparseTree
+{
+    private:
+    
+        TTree* fTree;
+        unsigned int fShortTree;
+        bool fWritePixelList;
+        bool fEventAnalyzed;                      // at least one telescope was analyzed in this event
+        
+        // image parameters (telescopes with images only)
+        unsigned int NImages;
+        unsigned int TelID[VDST_MAXTELESCOPES];   // telescope counting starts at 0
+        unsigned int eventStatus[VDST_MAXTELESCOPES];
+        float meanPed_Image[VDST_MAXTELESCOPES];
+        float meanPedvar_Image[VDST_MAXTELESCOPES];
+        float cen_x[VDST_MAXTELESCOPES];
+        float cen_y[VDST_MAXTELESCOPES];
+        float f_d[VDST_MAXTELESCOPES];
+        float f_s[VDST_MAXTELESCOPES];
+        float f_sdevxy[VDST_MAXTELESCOPES];
+        float length[VDST_MAXTELESCOPES];
+        float width[VDST_MAXTELESCOPES];
+        float size[VDST_MAXTELESCOPES];
+        float size2[VDST_MAXTELESCOPES];
+        float loss[VDST_MAXTELESCOPES];
+        float fui[VDST_MAXTELESCOPES];
+        float fracLow[VDST_MAXTELESCOPES];
+        float dist[VDST_MAXTELESCOPES];
+        float alpha[VDST_MAXTELESCOPES];
+        float los[VDST_MAXTELESCOPES];
+        float phi[VDST_MAXTELESCOPES];
+        float cosphi[VDST_MAXTELESCOPES];
+        float sinphi[VDST_MAXTELESCOPES];
+        unsigned short int ntubes[VDST_MAXTELESCOPES];
+        unsigned short int ntubesBNI[VDST_MAXTELESCOPES];
+        unsigned short int nsat[VDST_MAXTELESCOPES];
+        unsigned short int nlowgain[VDST_MAXTELESCOPES];
+        unsigned short int bad[VDST_MAXTELESCOPES];
+        unsigned short int badLow[VDST_MAXTELESCOPES];
+        float max[VDST_MAXTELESCOPES][3];
+        unsigned short int index_of_max[VDST_MAXTELESCOPES][3];
+        float asymmetry[VDST_MAXTELESCOPES];
+        float tgrad_x[VDST_MAXTELESCOPES];
+        float tchisq_x[VDST_MAXTELESCOPES];
+        int Fitstat[VDST_MAXTELESCOPES];
+        float dcen_x[VDST_MAXTELESCOPES];
+        float dcen_y[VDST_MAXTELESCOPES];
+        float dlength[VDST_MAXTELESCOPES];
+        float dwidth[VDST_MAXTELESCOPES];
+        float dphi[VDST_MAXTELESCOPES];
+        
+        // image pixel lists (all images of an event in one list)
+        unsigned int PixelListN[VDST_MAXTELESCOPES];
+        unsigned int PixelListNPixelNN;
+        vector< unsigned int > PixelID;
+        vector< unsigned int > PixelType;
+        vector< float > PixelIntensity;
+        vector< float > PixelTimingT0;
+        vector< float > PixelPE;
+    
+    public:
+    
+        VImageParameterSparseTree( unsigned int iShortTree = 0, bool iWritePixelList = false );
+        ~VImageParameterSparseTree() {}
+        
+        void   addTelescope( unsigned int iTelID, VImageParameter* iPar );
+        void   fill();
+        TTree* getTree()
+        {
+            return fTree;
+        }
+        void   initTree( string iName, string iTitle );
+        void   newEvent();
+};
+#endif
@@ -81,6 +81,7 @@ class VInstrumentResponseFunction
             }
             return false;
         }
+        void   clearSamples();
         bool   fill();
         bool   fillResolutionGraphs( vector< vector< VInstrumentResponseFunctionData* > > iIRFData );
         double getContainmentProbability()
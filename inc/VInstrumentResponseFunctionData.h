@@ -13,6 +13,7 @@
 
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "CData.h"
@@ -43,8 +44,20 @@ class VInstrumentResponseFunctionData : public TObject, public VHistogramUtiliti
         double  fArrayCentre_X;
         double  fArrayCentre_Y;
         
+        // per-bin samples (value, weight) for exact containment values
+        // [histogram ID][x bin][sample]
+        // (8 bytes per event and histogram type, e.g. 0.8 GB for 10^7 events
+        //  and 10 types; released with clearSamples())
+        vector< vector< vector< pair< float, float > > > > fSample;     //!
+        // containment values calculated from samples [histogram ID][point]
+        vector< vector< double > > fResolution_x;                      //!
+        vector< vector< double > > fResolution_y;                      //!
+        vector< vector< double > > fResolution_yE;                     //!
+        vector< double > fResolution_Probability;                      //!
+        
         TList*   calculateResolution( TH2D* iHistogram, TGraphErrors* iResult, string iHistoName,
                                       double iContainmentProbability );
+        void     fillSample( unsigned int iHistoID, double x, double y, double iWeight );
         double   getResolutionErrorfromToyMC( double i68, double iN );
         int      testResponseFunctionType( string iType );
         
@@ -86,6 +99,8 @@ class VInstrumentResponseFunctionData : public TObject, public VHistogramUtiliti
         
         VInstrumentResponseFunctionData();
         ~VInstrumentResponseFunctionData();
+        bool   calculateResolutionFromSamples( unsigned int iHistoID, double iContainmentProbability );
+        void   clearSamples();
         void   fill( double iWeight );
         TList* getListofHistograms()
         {
@@ -120,6 +135,7 @@ class VInstrumentResponseFunctionData : public TObject, public VHistogramUtiliti
             fHistogrambinningAngular_Min_Log = iMin;
             fHistogrambinningAngular_Max_Log = iMax;
         }
+        static double getWeightedQuantile( vector< pair< float, float > >& iSample, double iTotalWeight, double iProbability );
         bool   terminate( double iContainmentProbability, double iContainmentProbabilityError );
         
         ClassDef( VInstrumentResponseFunctionData, 9 );
@@ -35,6 +35,7 @@ class VInstrumentResponseFunctionRunParameter : public TNamed
         string fObservatory;
         unsigned int    fFillingMode;              // filling mode
         bool            fEffArea_short_writing;    // short/long tree writing
+        unsigned int    fNThreads;                 // number of threads for resolution calculation (0 = all cores)
         
         vector< string > fCutFileName;
         vector< float >  fCutCharacteristicMCAZ;
@@ -125,7 +126,7 @@ class VInstrumentResponseFunctionRunParameter : public TNamed
         bool                  readRunParameterFromTextFile( string iFile );
         bool                  testRunparameters();
         
-        ClassDef( VInstrumentResponseFunctionRunParameter, 22 );
+        ClassDef( VInstrumentResponseFunctionRunParameter, 23 );
 };
 
 #endif
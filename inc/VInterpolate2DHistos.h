@@ -12,6 +12,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -20,6 +21,9 @@ class VInterpolate2DHistos : public TNamed
     private:
         TRandom3* fRandom;
         
+        static void convolveGaussian( const TH2F* h, const TH2F* hNevents, double nWidth, TH2F* hs );
+        static vector< double > getGaussianKernel( const TAxis* iAxis, double iSigma );
+    
     public:
     
         VInterpolate2DHistos( int iseed = 0 );
@@ -27,6 +31,8 @@ class VInterpolate2DHistos : public TNamed
         
         TH2F* doSimpleInterpolation( TH2F*, string, int, int, bool, TH2F* hNevents = 0, int iMinEvents = 0 );
         TH2F* doGaussianInterpolation( TH2F* h, string iname, TH2F* hNevents = 0, int nGausN = 1, double nWidth = 1. );
+        vector< TH2F* > doGaussianInterpolation( vector< TH2F* > h, string iname, vector< TH2F* > hNevents,
+                double nWidth = 1., unsigned int iNThreads = 1 );
         TH2F* doLogLinearExtrapolation( TH2F* h, string iname, TH2F* hNevents = 0, int iMinEvents = 20 );
         
         ClassDef( VInterpolate2DHistos, 1 );
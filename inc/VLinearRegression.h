@@ -0,0 +1,84 @@
+//! VLinearRegression weighted straight-line fit (closed form) with optional least trimmed squares
+
+#ifndef VLinearRegression_H
+#define VLinearRegression_H
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+class VLinearRegression
+{
+    private:
+    
+        // data points (buffers are reused for each fit)
+        vector< double > fX;
+        vector< double > fY;
+        vector< double > fW;                       // weights 1/ey^2
+        
+        // robust fitting
+        vector< double > fResidual;
+        vector< unsigned int > fIndex;
+        vector< unsigned int > fSubset;
+        mt19937 fRandom;
+        
+        // fit results
+        double fIntercept;
+        double fSlope;
+        double fInterceptError;
+        double fSlopeError;
+        double fChi2;
+        
+        double cStep( double& a, double& b, unsigned int h );
+        double getChi2( double a, double b );
+        bool   fitSubset( const vector< unsigned int >& iSubset, unsigned int n, double& a, double& b, double* da = 0, double* db = 0 );
+    
+    public:
+    
+        VLinearRegression();
+        ~VLinearRegression() {}
+        
+        void   addPoint( double x, double y, double ey )
+        {
+            fX.push_back( x );
+            fY.push_back( y );
+            fW.push_back( ey > 0. ? 1. / ( ey * ey ) : 1. );
+        }
+        void   clear()
+        {
+            fX.clear();
+            fY.clear();
+            fW.clear();
+        }
+        bool   fit();
+        bool   fitRobust( double iFraction = 0. );
+        double getChi2()
+        {
+            return fChi2;
+        }
+        double getIntercept()
+        {
+            return fIntercept;
+        }
+        double getInterceptError()
+        {
+            return fInterceptError;
+        }
+        unsigned int getN()
+        {
+            return fX.size();
+        }
+        double getSlope()
+        {
+            return fSlope;
+        }
+        double getSlopeError()
+        {
+            return fSlopeError;
+        }
+};
+
+#endif
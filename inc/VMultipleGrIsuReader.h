@@ -49,6 +49,7 @@ class VMultipleGrIsuReader : public VVirtualDataReader
         ///////////////////////////////////////////////////////////////////////////
         // needed for good return values only
         std::vector< bool > vv_bool;
+        std::vector< int > vv_int;
         std::valarray< double > vvv_valarray;
         std::vector< valarray<double> > vvv_v_vvv_valarray;
         ///////////////////////////////////////////////////////////////////////////
@@ -80,9 +81,12 @@ class VMultipleGrIsuReader : public VVirtualDataReader
         uint32_t                    getEventNumber();
         // don't know the difference between hit and trig
         std::vector< bool >         getFullHitVec();
+        const std::vector< bool >&  getFullHitVecRef();
         std::vector< bool >         getFullTrigVec();
+        const std::vector< bool >&  getFullTrigVecRef();
         int                         getNumberofFullTrigger();
         std::vector< int >          getFullAnaVec();
+        const std::vector< int >&   getFullAnaVecRef();
         uint8_t                     getEventType();
         uint8_t                     getATEventType();
         uint32_t                    getGPS0()     //!< no MC time -> returns 0
@@ -105,10 +105,18 @@ class VPEReader : public VVirtualDataReader
         {
             return fFullHitVec[fTelID];
         }
+        const vector< bool >& getFullHitVecRef()
+        {
+            return fFullHitVec[fTelID];
+        }
         vector< bool >    getFullTrigVec()
         {
             return fFullTrigVec[fTelID];
         }
+        const vector< bool >& getFullTrigVecRef()
+        {
+            return fFullTrigVec[fTelID];
+        }
         int                    getNumberofFullTrigger()
         {
             return fNumberofFullTrigger[fTelID];
@@ -231,6 +239,10 @@ class VPEReader : public VVirtualDataReader
         {
             return  fPE_Tel_yoff;
         }
+        int64_t   getEventPosition()
+        {
+            return ( int64_t )fPE_treeEvent - 1;
+        }
         bool      getNextEvent();
         unsigned int getNumTelescopes()
         {
@@ -297,6 +309,7 @@ class VPEReader : public VVirtualDataReader
         {
             fSelectedHitChannel = hit;
         }
+        bool      setEventPosition( int64_t iPosition );
         bool      setTelescopeID( unsigned int );
         //!< set trigger values
         void      setTrigger( vector<bool> iImage, vector<bool> iBorder );
@@ -21,6 +21,7 @@ class VPointingCorrectionsTreeReader
         
     public:
         VPointingCorrectionsTreeReader( TChain* t = 0 );
+        ~VPointingCorrectionsTreeReader();
         bool is_initialized()
         {
             return fPointingCorrectionTreeSetting;
@@ -0,0 +1,272 @@
+//! VRNTupleReader columnar reader for mscw/DL2 event data stored as RNTuple (TTree-like interface for CData)
+
+#ifndef VRNTupleReader_H
+#define VRNTupleReader_H
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TDirectory.h"
+
+#include <ROOT/RNTuple.hxx>
+#include <ROOT/RNTupleReader.hxx>
+#include <ROOT/RNTupleView.hxx>
+
+using namespace std;
+
+/*
+ * copy one field of the current entry to the user address
+ */
+class VRNTupleColumnReader
+{
+    public:
+    
+        string fName;
+        
+        VRNTupleColumnReader( string iName )
+        {
+            fName = iName;
+        }
+        virtual ~VRNTupleColumnReader() {}
+        virtual void read( ROOT::NTupleSize_t i ) = 0;
+};
+
+template< class S, class D > class VRNTupleScalarReader : public VRNTupleColumnReader
+{
+    private:
+    
+        ROOT::RNTupleView< S > fView;
+        D* fAddress;
+    
+    public:
+    
+        VRNTupleScalarReader( string iName, ROOT::RNTupleView< S > iView, D* iAddress )
+            : VRNTupleColumnReader( iName ), fView( std::move( iView ) )
+        {
+            fAddress = iAddress;
+        }
+        void read( ROOT::NTupleSize_t i )
+        {
+            *fAddress = ( D )fView( i );
+        }
+};
+
+/*
+ * per-telescope arrays are stored as collections;
+ * user arrays are filled as for the TTree (no bound checking)
+ */
+template< class S, class D > class VRNTupleCollectionReader : public VRNTupleColumnReader
+{
+    private:
+    
+        ROOT::RNTupleView< vector< S > > fView;
+        D* fAddress;
+    
+    public:
+    
+        VRNTupleCollectionReader( string iName, ROOT::RNTupleView< vector< S > > iView, D* iAddress )
+            : VRNTupleColumnReader( iName ), fView( std::move( iView ) )
+        {
+            fAddress = iAddress;
+        }
+        void read( ROOT::NTupleSize_t i )
+        {
+            const vector< S >& v = fView( i );
+            for( unsigned int k = 0; k < v.size(); k++ )
+            {
+                fAddress[k] = ( D )v[k];
+            }
+        }
+};
+
+/*
+ * reader for event data written by VRNTupleWriter
+ *
+ * provides the subset of the TTree interface used by CData
+ * (SetBranchAddress, GetBranchStatus, GetEntry, GetEntries);
+ * only fields with addresses set are read (columnar access)
+ */
+class VRNTupleReader
+{
+    private:
+    
+        unique_ptr< ROOT::RNTupleReader > fReader;
+        vector< VRNTupleColumnReader* > fColumns;
+        
+        template< class S, class D > void addColumn( string iName, D* iAddress, bool iCollection )
+        {
+            VRNTupleColumnReader* c = 0;
+            if( iCollection )
+            {
+                c = new VRNTupleCollectionReader< S, D >( iName, fReader->GetView< vector< S > >( iName ), iAddress );
+            }
+            else
+            {
+                c = new VRNTupleScalarReader< S, D >( iName, fReader->GetView< S >( iName ), iAddress );
+            }
+            // replace existing address
+            for( unsigned int i = 0; i < fColumns.size(); i++ )
+            {
+                if( fColumns[i] && fColumns[i]->fName == iName )
+                {
+                    delete fColumns[i];
+                    fColumns[i] = c;
+                    return;
+                }
+            }
+            fColumns.push_back( c );
+        }
+        
+        string getFieldType( string iName )
+        {
+            if( !fReader )
+            {
+                return "";
+            }
+            ROOT::DescriptorId_t i_id = fReader->GetDescriptor().FindFieldId( iName );
+            if( i_id == ROOT::kInvalidDescriptorId )
+            {
+                return "";
+            }
+            return fReader->GetDescriptor().GetFieldDescriptor( i_id ).GetTypeName();
+        }
+    
+    public:
+    
+        VRNTupleReader( unique_ptr< ROOT::RNTupleReader > iReader )
+        {
+            fReader = std::move( iReader );
+        }
+        ~VRNTupleReader()
+        {
+            for( unsigned int i = 0; i < fColumns.size(); i++ )
+            {
+                delete fColumns[i];
+            }
+        }
+        
+        /*
+         * open RNTuple from file or directory (return 0 if not found)
+         */
+        static VRNTupleReader* open( TDirectory* iDir, string iName = "data_rntuple" )
+        {
+            if( !iDir )
+            {
+                return 0;
+            }
+            ROOT::RNTuple* i_anchor = iDir->Get< ROOT::RNTuple >( iName.c_str() );
+            if( !i_anchor )
+            {
+                return 0;
+            }
+            return new VRNTupleReader( ROOT::RNTupleReader::Open( *i_anchor ) );
+        }
+        
+        bool GetBranch( const char* iName )
+        {
+            return GetBranchStatus( iName );
+        }
+        bool GetBranchStatus( const char* iName )
+        {
+            return ( getFieldType( iName ).size() > 0 );
+        }
+        Long64_t GetEntries()
+        {
+            if( !fReader )
+            {
+                return 0;
+            }
+            return ( Long64_t )fReader->GetNEntries();
+        }
+        Int_t GetEntry( Long64_t entry )
+        {
+            if( entry < 0 || entry >= GetEntries() )
+            {
+                return 0;
+            }
+            for( unsigned int i = 0; i < fColumns.size(); i++ )
+            {
+                fColumns[i]->read( ( ROOT::NTupleSize_t )entry );
+            }
+            return 1;
+        }
+        
+        /*
+         * set user address for a field
+         * (values are converted to the type of the user variable)
+         */
+        template< class D > void SetBranchAddress( const char* iName, D* iAddress )
+        {
+            string iType = getFieldType( iName );
+            if( iType.size() == 0 )
+            {
+                cout << "VRNTupleReader::SetBranchAddress error: field not found: " << iName << endl;
+                return;
+            }
+            bool iCollection = false;
+            if( iType.find( "std::vector<" ) == 0 )
+            {
+                iCollection = true;
+                iType = iType.substr( 12, iType.size() - 13 );
+            }
+            if( iType == "float" )
+            {
+                addColumn< float, D >( iName, iAddress, iCollection );
+            }
+            else if( iType == "double" )
+            {
+                addColumn< double, D >( iName, iAddress, iCollection );
+            }
+            else if( iType == "std::int32_t" )
+            {
+                addColumn< std::int32_t, D >( iName, iAddress, iCollection );
+            }
+            else if( iType == "std::uint32_t" )
+            {
+                addColumn< std::uint32_t, D >( iName, iAddress, iCollection );
+            }
+            else if( iType == "std::int64_t" )
+            {
+                addColumn< std::int64_t, D >( iName, iAddress, iCollection );
+            }
+            else if( iType == "std::uint64_t" )
+            {
+                addColumn< std::uint64_t, D >( iName, iAddress, iCollection );
+            }
+            else if( iType == "std::int16_t" )
+            {
+                addColumn< std::int16_t, D >( iName, iAddress, iCollection );
+            }
+            else if( iType == "std::uint16_t" )
+            {
+                addColumn< std::uint16_t, D >( iName, iAddress, iCollection );
+            }
+            else if( iType == "std::int8_t" )
+            {
+                addColumn< std::int8_t, D >( iName, iAddress, iCollection );
+            }
+            else if( iType == "std::uint8_t" )
+            {
+                addColumn< std::uint8_t, D >( iName, iAddress, iCollection );
+            }
+            else if( iType == "bool" )
+            {
+                addColumn< bool, D >( iName, iAddress, iCollection );
+            }
+            else
+            {
+                cout << "VRNTupleReader::SetBranchAddress error: unsupported field type " << iType;
+                cout << " (" << iName << ")" << endl;
+            }
+        }
+        // fixed-size arrays given as pointer to array (e.g. &theta2_All)
+        template< class D, size_t N > void SetBranchAddress( const char* iName, D( *iAddress )[N] )
+        {
+            SetBranchAddress( iName, &( *iAddress )[0] );
+        }
+};
+
+#endif
@@ -0,0 +1,117 @@
+//! VRNTupleWriter columnar copy of mscw/DL2 event data trees as RNTuple
+
+#ifndef VRNTupleWriter_H
+#define VRNTupleWriter_H
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TBranch.h"
+#include "TDirectory.h"
+#include "TLeaf.h"
+#include "TObjArray.h"
+#include "TTree.h"
+
+#include <ROOT/RNTupleModel.hxx>
+#include <ROOT/RNTupleWriteOptions.hxx>
+#include <ROOT/RNTupleWriter.hxx>
+
+using namespace std;
+
+/*
+ * copy one leaf (at its branch address) into the RNTuple entry
+ */
+class VRNTupleColumnWriter
+{
+    public:
+    
+        virtual ~VRNTupleColumnWriter() {}
+        virtual void fill() = 0;
+};
+
+template< class S, class T > class VRNTupleScalarWriter : public VRNTupleColumnWriter
+{
+    private:
+    
+        TLeaf* fLeaf;
+        shared_ptr< T > fValue;
+    
+    public:
+    
+        VRNTupleScalarWriter( TLeaf* iLeaf, shared_ptr< T > iValue )
+        {
+            fLeaf = iLeaf;
+            fValue = iValue;
+        }
+        void fill()
+        {
+            *fValue = ( T )( *( S* )fLeaf->GetValuePointer() );
+        }
+};
+
+/*
+ * arrays (fixed size or with counter leaf, e.g. [NImages]) are written as collections
+ */
+template< class S, class T > class VRNTupleCollectionWriter : public VRNTupleColumnWriter
+{
+    private:
+    
+        TLeaf* fLeaf;
+        shared_ptr< vector< T > > fValue;
+    
+    public:
+    
+        VRNTupleCollectionWriter( TLeaf* iLeaf, shared_ptr< vector< T > > iValue )
+        {
+            fLeaf = iLeaf;
+            fValue = iValue;
+        }
+        void fill()
+        {
+            int n = fLeaf->GetLenStatic();
+            if( fLeaf->GetLeafCount() )
+            {
+                n = ( int )fLeaf->GetLeafCount()->GetValue( 0 );
+            }
+            const S* p = ( const S* )fLeaf->GetValuePointer();
+            fValue->resize( n > 0 ? n : 0 );
+            for( int i = 0; i < n; i++ )
+            {
+                ( *fValue )[i] = ( T )p[i];
+            }
+        }
+};
+
+class VRNTupleWriter
+{
+    private:
+    
+        string fName;
+        unique_ptr< ROOT::RNTupleWriter > fWriter;
+        vector< VRNTupleColumnWriter* > fColumns;
+        Long64_t fNEntries;
+        
+        template< class S, class T > void addColumn( ROOT::RNTupleModel* iModel, string iName, TLeaf* iLeaf, bool iCollection );
+    
+    public:
+    
+        VRNTupleWriter();
+        ~VRNTupleWriter();
+        
+        void     close();
+        void     fill();
+        Long64_t getEntries()
+        {
+            return fNEntries;
+        }
+        bool     initialize( TTree* iTree, TDirectory* iDir, string iName = "data_rntuple", int iCompression = 505 );
+        bool     isActive()
+        {
+            return ( fWriter != nullptr );
+        }
+};
+
+#endif
@@ -132,6 +132,29 @@ class VRadialAcceptance
         // get acceptance curves from a file
         TFile* fAccFile;
         
+        // accumulator for parallel filling: list of histograms owned by this object
+        TList* hListAccumulator;
+        
+        // exclusion mask on the camera-coordinate grid of hAreaExcluded2D
+        // (0 = not excluded, 1 = excluded, 2 = close to a region boundary: exact test required)
+        bool             fExclusionMaskFilled;
+        int              fExclusionMask_nbins;
+        double           fExclusionMask_max;
+        vector< char >   fExclusionMask;
+        
+        // acceptance map: 1D acceptance function evaluated on a grid of nodes
+        // in derotated camera coordinates (bilinear interpolation between nodes)
+        bool             fAcceptanceMapFilled;
+        int              fAcceptanceMap_nbins;
+        double           fAcceptanceMap_max;
+        vector< float >  fAcceptanceMap;
+        
+        void fillAcceptanceMap();
+        double interpolateAcceptanceMap( double x, double y );
+        void fillExclusionMask();
+        bool testExcludedfromBackground( double, double );
+        TH1* cloneAccumulatorHistogram( TH1* h );
+        
         // reset all variables
         void reset();
         
@@ -143,13 +166,19 @@ class VRadialAcceptance
         VRadialAcceptance( VGammaHadronCuts* iCuts, VAnaSumRunParameter* irun, double iMaxDistanceAllowed = -99. );
         // use acceptance curve from this file
         VRadialAcceptance( string ifile, int irun = -1 );
+        // accumulator for parallel filling (merged with addAccumulator())
+        VRadialAcceptance( VRadialAcceptance* iParent, VGammaHadronCuts* iCuts );
         ~VRadialAcceptance();
         
+        bool   addAccumulator( VRadialAcceptance* iAccumulator );
         int    calculateAverageRadialAcceptanceCurveFromRuns( TDirectory* iDirectory );
         // correct run-wise radial acceptances for exclusion regions
-        bool   correctRadialAcceptancesForExclusionRegions( TDirectory* iDirectory, unsigned int iRunNumber );
+        bool   correctRadialAcceptancesForExclusionRegions( TDirectory* iDirectory, unsigned int iRunNumber, ostream& iLog = cout );
         int    fillAcceptanceFromData( CData* c, int entry, double x_rotJ2000, double y_rotJ2000 );
         double getAcceptance( double x, double y );   //!< return radial acceptance
+        void   getAcceptance( unsigned int n, const double* x, const double* y, double* acc );
+        void   getAcceptanceMap( vector< double >& iAcc, int nx, double xmin, double xmax,
+                                 int ny, double ymin, double ymax, bool iBackground, int nsub = 4 );
         double getNumberofRawFiles()
         {
             return fNumberOfRawFiles;
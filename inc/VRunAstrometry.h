@@ -0,0 +1,66 @@
+//! VRunAstrometry run-wise astrometry (precession matrices and tabulated sidereal time)
+
+#ifndef VRunAstrometry_H
+#define VRunAstrometry_H
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "TMath.h"
+
+#include "VAstronometry.h"
+#include "VGlobalRunParameter.h"
+#include "VSkyCoordinatesUtilities.h"
+
+using namespace std;
+
+class VRunAstrometry
+{
+    private:
+    
+        bool   fDebug;
+        
+        double fObsLongitude_rad;
+        double fObsLatitude_rad;
+        
+        // time grid for local sidereal time
+        int    fMJD0;                           // MJD of time grid origin
+        double fTime0_s;                        // first grid point (seconds since fMJD0)
+        double fTimeStep_s;
+        vector< double > fLST;                  // local sidereal time at grid points [rad] (unwrapped)
+        double fMaxLSTError_rad;                // maximum interpolation error (measured at init)
+        
+        // precession matrices (key: start and end epoch [MJD])
+        map< pair< double, double >, vector< double > > fPrecessionMatrix;
+        
+        double getLST( int iMJD, double iTime_s );
+        double getLST_exact( int iMJD, double iTime_s );
+        const vector< double >& getPrecessionMatrix( double iMJD_start, double iMJD_end );
+        bool   fillLSTTable( double iTimeStep_s );
+        void   precess( double iMJD_start, double iMJD_end, double& ra_rad, double& dec_rad );
+    
+    public:
+    
+        VRunAstrometry();
+        ~VRunAstrometry() {}
+        
+        void   convert_derotatedCoordinates_to_J2000( int iMJD, double iTime, double iTelAz, double iTelEl, double& x, double& y );
+        void   getEquatorialCoordinates( int iMJD, double iTime, double az_deg, double ze_deg, double& dec_deg, double& ra_deg );
+        void   getHorizontalCoordinates( int iMJD, double iTime, double dec_deg, double ra_deg, double& az_deg, double& ze_deg );
+        void   getHorizontalCoordinates_J2000( const vector< int >& iMJD, const vector< double >& iTime,
+                const vector< double >& iRA_J2000_deg, const vector< double >& iDec_J2000_deg,
+                vector< double >& iAz_deg, vector< double >& iEl_deg );
+        double getMaxInterpolationError_arcsec()
+        {
+            return fMaxLSTError_rad * TMath::RadToDeg() * 3600.;
+        }
+        bool   init( double iMJDStart, double iMJDStopp, double iTimeStep_s = 10., double iMaxError_arcsec = 0.01 );
+        bool   isInitialized()
+        {
+            return ( fLST.size() > 1 );
+        }
+};
+
+#endif
@@ -19,6 +19,11 @@
 #include "VUtilities.h"
 #include "VDB_Connection.h"
 
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -29,6 +34,24 @@
 
 using namespace std;
 
+/*
+ * file header of a binary star catalogue cache
+ *
+ * (native byte order; followed by the list of stars and
+ *  the declination band index)
+ */
+struct sStarCatalogueCacheHeader
+{
+    char     fMagic[8];
+    uint32_t fVersion;
+    uint32_t fCatalogueVersion;
+    int64_t  fSourceFileSize;
+    int64_t  fSourceFileModTime;
+    uint64_t fNStars;
+    uint32_t fNDecBands;
+    uint32_t fReserved;
+};
+
 class VStarCatalogue : public TObject, public VGlobalRunParameter
 {
     private:
@@ -40,6 +63,11 @@ class VStarCatalogue : public TObject, public VGlobalRunParameter
         vector< VStar* > fStars;
         vector< VStar* > fStarsinFOV;
         
+        // index of stars in declination bands (J2000)
+        double fDecBandWidth_deg;                          //!
+        vector< vector< unsigned int > > fDecBandIndex;    //!
+        string fCatalogueCacheDirectory;                   //!
+        
         // telescope pointing
         unsigned int fTel_telescopeID;
         double       fTel_deRotationAngle_deg;
@@ -48,6 +76,11 @@ class VStarCatalogue : public TObject, public VGlobalRunParameter
         double       fTel_camerascale;
         
         bool readCatalogue();
+        bool readCatalogueCache( string iCacheFile, int64_t iSourceFileSize, int64_t iSourceFileModTime );
+        bool writeCatalogueCache( string iCacheFile, int64_t iSourceFileSize, int64_t iSourceFileModTime );
+        string getCatalogueCacheFileName();
+        void fillDecBandIndex();
+        vector< unsigned int > getStarsInDecRange( double iDecMin_deg, double iDecMax_deg );
         VStar* readCommaSeparatedLine_Fermi( string, int, VStar* );
         VStar* readCommaSeparatedLine_Fermi_Catalogue( string, int, VStar* );
         VStar* readCommaSeparatedLine_Fermi2nd_Catalogue( string, int, VStar* );
@@ -97,6 +130,8 @@ class VStarCatalogue : public TObject, public VGlobalRunParameter
         {
             return fStarsinFOV;
         }
+        vector< VStar* > getStarsInCone( double ra_deg, double dec_deg, double iRadius_deg, bool bJ2000 = true,
+                                         double iBrightness = 9999., string iBand = "B" );
         void          printCatalogue( unsigned int i_nRows = 0, double iMinBrightness = 999999., string iBand = "B" );
         void          printStarsInFOV();
         void          printStarsInFOV( double iMinBrightness, string iBand = "B" );
@@ -104,12 +139,16 @@ class VStarCatalogue : public TObject, public VGlobalRunParameter
         bool          readVERITASsourcesfromDB( string );
         unsigned int  setFOV( double ra_deg, double dec_deg, double FOV_x, double FOV_y, bool bJ2000 = true, double iBrightness = 9999., string iBand = "B" );
         unsigned int  setFOV( string ra_hour, string dec, double FOV_x, double FOV_y, bool bJ2000 = true );
+        void          setCatalogueCacheDirectory( string iDir )
+        {
+            fCatalogueCacheDirectory = iDir;
+        }
         void          setTelescopePointing( unsigned int iTelID = 0, double iDerotationAngle = 0.,
                                             double ra_deg = -99., double dec_deg = -99., double iCameraScale = 1. );
         bool          writeCatalogueToRootFile( string iRootFile );
         
         bool          checkTextBlocks( string iL, unsigned int iV );
         
-        ClassDef( VStarCatalogue, 8 );
+        ClassDef( VStarCatalogue, 9 );
 };
 #endif
@@ -14,6 +14,7 @@
 #include "VExclusionRegions.h"
 #include "VStereoHistograms.h"
 #include "VStereoMaps.h"
+#include "VRunAstrometry.h"
 #include "VSkyCoordinates.h"
 #include "VSkyCoordinatesUtilities.h"
 
@@ -39,6 +40,38 @@
 
 using namespace std;
 
+class VDL3FITSWriter;
+
+/*
+ * buffered event for the DL3 tree
+ * (azimuth and elevation are calculated in batches)
+ */
+struct sDL3Event
+{
+    int       runNumber;
+    int       eventNumber;
+    double    Time;
+    int       MJD;
+    double    Xoff;
+    double    Yoff;
+    double    Xderot;
+    double    Yderot;
+    bool      bDirection;
+    double    RA;
+    double    DEC;
+    double    Erec;
+    double    Erec_Err;
+    double    dE;
+    double    Xcore;
+    double    Ycore;
+    int       NImages;
+    ULong64_t ImgSel;
+    double    MSCW;
+    double    MSCL;
+    double    EmissionHeight;
+    double    Acceptance;
+};
+
 class VStereoAnalysis
 {
     public:
@@ -216,10 +249,12 @@ class VStereoAnalysis
         double  fDL3EventTree_EmissionHeight ;
         double  fDL3EventTree_Acceptance ;
         VRadialAcceptance* fDL3_Acceptance;
+        vector< sDL3Event > fDL3EventBuffer;
+        VDL3FITSWriter* fDL3FITSWriter;          // DL3 event list in FITS format (requires cfitsio)
         
         double  fDeadTimeStorage ;
         //double fullMJD ;
-        VSkyCoordinates* fVsky ;  // for RADec to AzimElev conversion
+        VRunAstrometry* fRunAstrometry;  // run-wise astrometry (derotation, RADec to AzimElev conversion)
         
         double fTreeSelected_MVA;
         
@@ -268,8 +303,12 @@ class VStereoAnalysis
         void fill_DL3Tree( CData* c ,
                            double i_xderot, double i_yderot,
                            unsigned int icounter, double i_UTC );
+        void flush_DL3Tree();
         bool init_DL3Tree( int irun, int icounter );
+        void init_DL3Acceptance( int icounter );
+        bool init_DL3FITSEventList( int irun, int icounter );
         void write_DL3Tree();
+        void close_DL3FITSEventList( double iMJDStart, double iMJDStopp );
         
         // derotation and J2000
         void getDerotatedCoordinates( unsigned int, CData* iData, double& x_derot, double& y_derot );
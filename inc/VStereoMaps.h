@@ -15,6 +15,10 @@
 #include "TTree.h"
 
 #include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
 
 using namespace std;
 
@@ -26,6 +30,24 @@ struct sRE_REGIONS
     vector< double > roff;                        //!< radius of off source region
 };
 
+//! reflected region solution for all bins of a sky map (one per wobble/exclusion region configuration)
+struct sRE_SOLUTION
+{
+    vector< vector< sRE_REGIONS > > fOff;         //!< off region parameters
+    vector< vector< int > > fNRegions;            //!< number of off regions for debug histogram (-1: not filled)
+};
+
+//! off region in the event matching index
+struct sRE_INDEXREGION
+{
+    double x_bin;                                 //!< bin centre
+    double y_bin;
+    double xoff;                                  //!< centre of off region
+    double yoff;
+    double roff2;                                 //!< radius^2 of off region
+    int noff;                                     //!< number of off regions of this bin
+};
+
 class VStereoMaps
 {
     private:
@@ -79,12 +101,23 @@ class VStereoMaps
         // REFLECTED REGION MODEL:
         vector< vector< sRE_REGIONS > > fRE_off;  //!< off region parameters
         double fRE_roffTemp;                      //!< radius of off source region
+        map< string, sRE_SOLUTION > fRE_cache;    //!< off regions of previous runs before random removal (key: see getReflectedRegionCacheKey())
+        
+        // index of off regions in radial and polar angle buckets (for event matching)
+        vector< sRE_INDEXREGION > fRE_indexRegions;
+        vector< vector< unsigned int > > fRE_index;
+        unsigned int fRE_index_nr;
+        unsigned int fRE_index_nphi;
+        double fRE_index_dr;
         
         bool fill_ReflectedRegionModel( double, double, int, bool );
         bool fill_ReflectedRegionModel( double, double, int, bool, double& i_theta2 );
+        string getReflectedRegionCacheKey( int iBinX_min, int iBinX_max, int iBinY_min, int iBinY_max );
         void RE_getAlpha( bool iIsOn );
         bool initialize_ReflectedRegionModel();
         void initialize_ReflectedRegionHistograms();
+        void initialize_ReflectedRegionIndex();
+        void solve_ReflectedRegions( double x, double y, sRE_REGIONS& iRegions, int& iNRegions );
         
         // histograms related to reflected region model
         TH2D* hRE_NRegions;
@@ -12,11 +12,13 @@
 #include "VTMVARunData.h"
 #include "VUtilities.h"
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "TCanvas.h"
@@ -95,6 +97,91 @@ class VTMVAEvaluatorResults : public TNamed
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// data for sensitivity optimization
+// (per bin; efficiencies are indexed by ROOT bin numbers)
+class VTMVAOptimizationBin
+{
+    public:
+    
+        unsigned int     fDataBin;
+        double           fNon;
+        double           fNof;
+        double           fNdif;
+        double           fEnergy_Log10TeV;
+        TH2D*            fHAngContainment;
+        
+        // signal and background efficiencies vs MVA cut value
+        int              fNbins;
+        double           fXmin;
+        double           fXmax;
+        vector< double > fBinLowEdges;                // variable bin sizes only
+        vector< double > fMVACut;
+        vector< double > fEffS;
+        vector< double > fEffB;
+        
+        // results
+        bool             fOptimumCutValueFound;
+        double           fSourceStrength;
+        double           fTMVACutValue_AtMaximum;
+        double           fSourceStrength_atMaximum;
+        double           fSignalEfficiency_AtMaximum;
+        double           fBackgroundEfficiency_AtMaximum;
+        double           fSignal_to_sqrtNoise_atMaximum;
+        
+        // optimization curves (last source strength step)
+        vector< double > fSignal_to_sqrtNoise_x;
+        vector< double > fSignal_to_sqrtNoise_y;
+        vector< double > fAngularContainmentRadius_y;
+        vector< double > fAngularContainmentFraction_y;
+        vector< double > fSmooth_x;
+        vector< double > fSmooth_y;
+        vector< double > fSignalEvents_x;
+        vector< double > fSignalEvents_y;
+        vector< double > fBackgroundEvents_y;
+        
+        ostringstream    fLog;
+        
+        VTMVAOptimizationBin()
+        {
+            fDataBin = 0;
+            fNon = 0.;
+            fNof = 0.;
+            fNdif = 0.;
+            fEnergy_Log10TeV = 0.;
+            fHAngContainment = 0;
+            fNbins = 0;
+            fXmin = 0.;
+            fXmax = 0.;
+            fOptimumCutValueFound = false;
+            fSourceStrength = 0.;
+            fTMVACutValue_AtMaximum = -99.;
+            fSourceStrength_atMaximum = 0.;
+            fSignalEfficiency_AtMaximum = -99.;
+            fBackgroundEfficiency_AtMaximum = -99.;
+            fSignal_to_sqrtNoise_atMaximum = 0.;
+        }
+        
+        /* same as TAxis::FindBin */
+        int findBin( double x )
+        {
+            if( x < fXmin )
+            {
+                return 0;
+            }
+            if( !( x < fXmax ) )
+            {
+                return fNbins + 1;
+            }
+            if( fBinLowEdges.size() > 0 )
+            {
+                return 1 + TMath::BinarySearch( ( int )fBinLowEdges.size(), &fBinLowEdges[0], x );
+            }
+            return 1 + ( int )( fNbins * ( x - fXmin ) / ( fXmax - fXmin ) );
+        }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 class VTMVAEvaluator : public TNamed, public VPlotUtilities
 {
     private:
@@ -136,6 +223,8 @@ class VTMVAEvaluator : public TNamed, public VPlotUtilities
         
         bool     fSmoothAndInterpolateMVAValues;
         
+        unsigned int fOptimizationNThreads;      // number of threads used in sensitivity optimization (0: all available cores)
+        
         string   fTMVAMethodName;
         int      fTMVAMethodCounter;
         double   fTMVAngularContainmentRadiusMax;     // maximum angular containment radius (optimization scales relative to this value)
@@ -179,7 +268,7 @@ class VTMVAEvaluator : public TNamed, public VPlotUtilities
         double           evaluateInterPolateMVA( double iErec_log10TeV, double iZe, unsigned int evaluateInterPolateMVA );
         TH1D*            getEfficiencyHistogram( string iName, TFile* iF, string iMethodTag_2 );
         double           getMeanEnergyAfterCut( TFile* f, double iCut, unsigned int iDataBin );
-        bool             optimizeSensitivity( unsigned int iDataBin, string iOptimizationType, string iEpoch = "noepoch" );
+        bool             optimizeSensitivity( string iOptimizationType, string iEpoch = "noepoch" );
         bool             optimizeSensitivity_using_qfactor( TH1D* effS, TH1D* effB,
                 double& i_SignalEfficiency_AtMaximum,
                 double& i_BackgroundEfficiency_AtMaximum,
@@ -210,15 +299,18 @@ class VTMVAEvaluator : public TNamed, public VPlotUtilities
                 TGraph* iGSignalEvents, TGraph* iGBackgroundEvents,
                 TGraph* iGOpt_AngularContainmentRadius, TGraph* iGOpt_AngularContainmentFraction,
                 bool bPlotContainmentFraction = false );
-        TGraph*          readInterpolatedCountsFromFile( TFile* iF, double i_secant_min, double i_secant_max, bool bIsOn = true );
-        double           readAverageCountsFromFile( TFile* iF, double i_e_min, double i_e_max, double i_ze_min, double i_ze_max, bool bIsOn = true );
         void             reset();
+        void             scanSensitivity( VTMVAOptimizationBin* iB );
         string           setFullMVAFileName( string iWeightFileName,
                                              unsigned intiWeightFileIndex_Emin, unsigned int i,
                                              unsigned int iWeightFileIndex_Zmin, unsigned int j,
                                              string fTMVAMethodName, int fTMVAMethodCounter,
                                              string iInstrumentEpoch,
                                              string iFileSuffix );
+        void             setOptimizedSensitivity( VTMVAOptimizationBin* iB );
+        void             smoothKernelNormal( vector< double >& x, vector< double >& y,
+                                             vector< double >& xs, vector< double >& ys,
+                                             double iBandwidth, unsigned int iNout );
         void             smoothAndInterpolateMVAValue( unsigned int iE_min, unsigned int iE_max,
                 unsigned int iZ_min, unsigned int iZ_max, double iEnergyStepSize );
         TGraphAsymmErrors* fillSmoothedEfficencyGraph( TGraphAsymmErrors* g, unsigned int iZe, bool iSignalEff = true );
@@ -297,6 +389,10 @@ class VTMVAEvaluator : public TNamed, public VPlotUtilities
         }
         
         void   setSensitivityOptimizationFixedSignalEfficiency( double iOptimizationFixedSignalEfficiency = 1. );
+        void   setSensitivityOptimizationThreads( unsigned int iNThreads = 0 )
+        {
+            fOptimizationNThreads = iNThreads;
+        }
         void   setSensitivityOptimizationSourceStrength(
             double iOptimizationMinSourceStrength = 0.001,
             double iOptimizationMaxSourceStrength = 30. );
@@ -353,7 +449,7 @@ class VTMVAEvaluator : public TNamed, public VPlotUtilities
         void   setTMVAMethod( string iMethodName = "BDT", int iMethodCounter = 0 );
         bool   writeOptimizedMVACutValues( string iRootFile );
         
-        ClassDef( VTMVAEvaluator, 52 );
+        ClassDef( VTMVAEvaluator, 53 );
 };
 
 #endif
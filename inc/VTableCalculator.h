@@ -10,6 +10,7 @@
 #include "TMath.h"
 #include "TProfile2D.h"
 
+#include "VCompiledLookupTableFile.h"
 #include "VGlobalRunParameter.h"
 #include "VHistogramUtilities.h"
 #include "VMedianCalculator.h"
@@ -29,13 +30,19 @@ class VTableCalculator
         // mode can be 'r' or 'w'
         VTableCalculator( int intel = 0 , bool iEnergy = false, bool iPE = false );
         VTableCalculator( string fpara, string hname, bool i_writeTables, TDirectory* iDir, bool iEnergy, bool iPE = false, int iUseMedianEnergy = 1 );
+        VTableCalculator( string fpara, string hname, VCompiledLookupTableFile* iCompiledFile, string iPath,
+                          bool iEnergy, bool iPE = false, int iUseMedianEnergy = 1 );
         
         // Destructor
-        ~VTableCalculator() {}
+        ~VTableCalculator();
         
         // Fill Histos and Calc Mean Scaled Width
         double calc( int ntel, double* r, double* s, double* l, double* d,
                      double* w, double* mt, double& chi2, double& dE, double* st = 0 );
+        const VCompiledLookupTable* getCompiledMedian()
+        {
+            return fCompiledMedian;
+        }
         TH2F* getHistoMedian();
         TDirectory* getOutputDirectory()
         {
@@ -63,6 +70,7 @@ class VTableCalculator
             fMinShowerPerBin = iM;
         }
         void setNormalizeTableValues( double i_value_min = -9999., double i_value_max = -9999. );
+        void setVCompiledTables( vector< const VCompiledLookupTable* >& hM );
         void setVHistograms( vector< TH2F* >& hM );
         void setInterpolationConstants( int, int );
         void setOutputDirectory( TDirectory* iF )
@@ -73,7 +81,7 @@ class VTableCalculator
         {
             fWrite1DHistograms = iB;
         }
-        void terminate( TDirectory* iOut = 0, char* xtitle = 0 );
+        bool terminate( TDirectory* iOut = 0, char* xtitle = 0 );
         
         
     private:
@@ -118,6 +126,10 @@ class VTableCalculator
         string hMedianName;
         vector< TH2F* > hVMedian;
         
+        // tables from compiled lookup table file
+        const VCompiledLookupTable* fCompiledMedian;
+        vector< const VCompiledLookupTable* > hVCompiledMedian;
+        
         // histogram interpolation
         int fInterPolWidth;
         int fInterPolIter;
@@ -128,11 +140,14 @@ class VTableCalculator
         
         bool    fWriteTables;
         
+        bool   addHistogramsFromFile( TDirectory* iDir1D );
         bool   create1DHistogram( int i, int j );
         bool   createMedianApprox( int i, int j );
         double getWeightMeanBinContent( TH2F*, int, int, double, double );
         void   fillMPV( TH2F*, int, int, TH1F*, double, double );
+        string getMedianHistogramName();
         double interpolate( TH2F* h, double x, double y, bool iError );
+        double interpolate( const VCompiledLookupTable* h, double x, double y, bool iError );
         bool   readHistograms();
         void   setBinning();
         void   setConstants( bool iPE = false );
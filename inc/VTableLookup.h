@@ -6,19 +6,23 @@
 #include "TDirectory.h"
 #include "TError.h"
 #include "TFile.h"
+#include "TKey.h"
 #include "TMath.h"
 #include "TSystem.h"
 
+#include "VCompiledLookupTableFile.h"
 #include "VStatistics.h"
 #include "VTableLookupDataHandler.h"
 #include "VTableLookupRunParameter.h"
 #include "VTablesToRead.h"
 #include "VTableCalculator.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <math.h>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -40,10 +44,10 @@ class VTableCalculatorData
         double fValueNormalizationRange_max;
         
         VTableCalculatorData();
-        ~VTableCalculatorData() {}
+        ~VTableCalculatorData();
         bool    assertTableVector( unsigned int wobble_bin );
         void    print();
-        void    terminate( TFile* iFile );
+        bool    terminate( TFile* iFile );
         
 };
 
@@ -68,6 +72,11 @@ class VTableLookup
         
         // root file with lookup tables and pointers to directories
         TFile* fLookupTableFile;
+        // table file shared by several lookup table objects (filling of several slices)
+        bool   fLookupTableFileShared;
+        mutex* fLookupTableFileMutex;
+        // compiled lookup table file (memory mapped)
+        VCompiledLookupTableFile* fCompiledLookupTableFile;
         
         // lookup table parameter space
         
@@ -79,6 +88,8 @@ class VTableLookup
         vector< ULong64_t >                     fTableTelTypes;
         // NSB level [tel_type]
         vector< vector< double > >              fTableNoiseLevel;
+        // noise level directories for table writing (optional) [tel_type]
+        map< ULong64_t, int >                   fTableNoiseLevelDirectory;
         // zenith angle [tel_type][NSB][ze]
         vector< vector< vector< double > > >    fTableZe;
         // wobble offsets [tel_type][NSB][ze][woff]
@@ -122,13 +133,15 @@ class VTableLookup
         void             fillLookupTable();
         int              getAzBin( double az );
         void             getIndexBoundary( unsigned int* ib, unsigned int* il, vector< double >& iV, double x );
-        vector< string > getSortedListOfDirectories( TDirectory* );
+        vector< string > getSortedListOfDirectories( string iPath );
         void             getTables( unsigned int inoise, unsigned int ize, unsigned int iwoff, unsigned int iaz, unsigned int tel, VTablesToRead* s );
+        int              getSimilarNoiseLevel( TDirectory* iDir, int i_noise );
         unsigned int     getTelTypeCounter( unsigned int iTel, bool iStopIfError = false );
         unsigned int     getWobbleBin( double w );
         void             initializeLookupTableDataVector();
         void             interpolate( VTablesToRead* s1, double w1, VTablesToRead* s2, double w2, VTablesToRead* s, double w, bool iCos = false );
         void             readLookupTable();
+        void             readLookupTableForEvent();
         void             readNoiseLevel( bool bWriteToRunPara = true ); // read noise level from pedvar histograms of data files
         bool             sanityCheckLookupTableFile( bool iPrint = false );
         bool             setInputFiles( vector< string > iInputFiles ); // set input files from evndisp
@@ -139,7 +152,7 @@ class VTableLookup
         
     public:
         VTableLookup( VTableLookupRunParameter* iTLRunParameter );
-        ~VTableLookup() {}
+        ~VTableLookup();
         
         double getMaxTotalTime()
         {
@@ -158,7 +171,12 @@ class VTableLookup
         }
         bool   initialize();
         void   loop();                              // loop over all events
-        void   terminate();
+        void   setLookupTableFile( TFile* iFile, mutex* iFileMutex = 0 );
+        void   setTableNoiseLevels( map< ULong64_t, int > iNoiseLevelDirectory )
+        {
+            fTableNoiseLevelDirectory = iNoiseLevelDirectory;
+        }
+        bool   terminate();
         
 };
 #endif
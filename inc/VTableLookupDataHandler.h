@@ -34,11 +34,15 @@
 #include <cmath>
 #include <iostream>
 #include <map>
+#include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
 using namespace std;
 
+class VRNTupleWriter;
+
 class VTableLookupDataHandler
 {
     private:
@@ -97,6 +101,7 @@ class VTableLookupDataHandler
         Ctelconfig* ftelconfig;
         vector< TChain* > fTtpars;
         vector< Ctpars* > ftpars;
+        CtparsSparse* ftparsSparse;               // image parameters of all telescopes (sparse layout)
         vector< VPointingCorrectionsTreeReader* > fpointingCorrections;
         TChain* fDeepLearnerpars;
         
@@ -137,6 +142,7 @@ class VTableLookupDataHandler
         
         // output trees
         TTree* fOTree;
+        VRNTupleWriter* fORNTuple;                //!< columnar copy of fOTree (optional)
         bool fShortTree;                          //!< use short version of output tree
         bool bWriteMCPars;
         bool fTreeWithParameterErrors;
@@ -152,26 +158,40 @@ class VTableLookupDataHandler
         unsigned int fNStats_WobbleMinCut;
         unsigned int fNStats_WobbleMaxCut;
         
+        // event data of the full array (subarray analysis)
+        vector< bool >   fImgSel_list_all;
+        vector< bool >   fTrig_list_all;
+        vector< bool >   fTPars_read_all;
+        bool             fReadShortEvent;
+        // output files and trees (subarray analysis; one per subarray)
+        vector< TFile* > fOutFile_SubArray;
+        vector< TTree* > fOTree_SubArray;
+        
         void   calcDistances();                //!< calculate distances between telescopes and shower core
         void   calcEmissionHeights();
+        void   calcTheta2();
         double calculateMeanNoiseLevel( bool bCurrentNoiseLevel = false );
         bool   checkIfFilesInChainAreRecovered( TChain* c );
+        void   copyImageParameters( unsigned int i, bool bShort );
         void   copyMCHistograms();
         bool   copyMCRunheader();
         void   copyTree_from_evndispFile( string iTreename = "MCpars" );
         void   copy_telconfig();
         bool   doImageQualitySelection( unsigned int iTelID );
         void   doStereoReconstruction();
+        string getSubArrayOutputFileName( string iOutput, unsigned int iSubArray );
         void   initializeTelTypeVector();
         int    fillNextEvent( bool bShort );
         void   printCutStatistics();
         void   printTelescopesList( unsigned int iPrintParameter );
         bool   randomSelected();
+        void   reconstructEvent();
         void   resetImageParameters();
         void   resetImageParameters( unsigned int i );
         void   setEventWeightfromMCSpectrum();
         void   setSelectRandom( double iX, int iS );
         void   writeDeadTimeHistograms();
+        void   writeOutputFile( TNamed* iM );
         
     public:
     
@@ -200,6 +220,7 @@ class VTableLookupDataHandler
         Float_t        fMCFirstInteractionHeight;
         Float_t	       fMCFirstInteractionDepth;
         
+        int fSubArrayID;                          //!< subarray ID (subarray analysis only)
         ULong64_t LTrig;
         unsigned int fNTrig;
         int fNImages;
@@ -381,14 +402,16 @@ class VTableLookupDataHandler
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         VTableLookupDataHandler( bool iWrite, VTableLookupRunParameter* iT = 0 );
-        ~VTableLookupDataHandler() {}
+        ~VTableLookupDataHandler();
         
         bool cut()                                //!< apply cuts on successful reconstruction to input data
         {
             return cut( false );
         }
         bool cut( bool bWrite );
+        void closeInputFiles();
         void fill();                              //!< fill output tree
+        void fillOutputTree();
         void fillMChistograms();
         void setfillTables( bool ib )
         {
@@ -554,6 +577,14 @@ class VTableLookupDataHandler
         {
             return fNTelTypes;
         }
+        unsigned int getNSubArrays()
+        {
+            if( fTLRunParameter && fTLRunParameter->fSubArrayID.size() > 0 )
+            {
+                return fTLRunParameter->fSubArrayID.size();
+            }
+            return 1;
+        }
         TFile* getOutputFile()
         {
             return fOutFile;
@@ -613,6 +644,7 @@ class VTableLookupDataHandler
         bool readRunParameter();
         void reset();                             //!< reset a few output variables
         void resetAll();
+        bool selectSubArray( unsigned int iSubArray );
         void setEnergy( double iES, double iChi2S, double idES, double ieAbsError = -999. )
         {
             fenergyS = iES;
@@ -55,6 +55,8 @@ class VTableLookupRunParameter : public TNamed, public VGlobalRunParameter
                                      string iEvndispRootFile );
         bool readRunParameters( string iFile );
         bool readTelTypeDepdendentWeights( string iFile );
+        bool readSubArrayList( string iFile );
+        bool readTableFillingSliceList( string iFile );
         void setCTA_MC_offaxisBins();
         
     public:
@@ -97,6 +99,10 @@ class VTableLookupRunParameter : public TNamed, public VGlobalRunParameter
         string fRunParameterFile;
         // list of telescopes (subarrays) to be active in analysis
         string fTelescopeList_sim_telarray_Counting;
+        // list of telescope subarrays analysed in one pass (one subarray per line)
+        string fSubArrayListFile;
+        vector< int > fSubArrayID;
+        vector< vector< unsigned int > > fSubArrayTelescopes;     // telescope counting starts at 0
         // file with telescope type dependent weights
         string fTelescopeType_weightFile;
         // list with telescope type dependent weights
@@ -141,6 +147,13 @@ class VTableLookupRunParameter : public TNamed, public VGlobalRunParameter
         // definition of offaxis bins (CTA only)
         vector< double > fCTA_MC_offaxisBin_min;
         vector< double > fCTA_MC_offaxisBin_max;
+        // list of slices (zenith angle, wobble offset, input files) filled in one job
+        string fTableFillingSliceListFile;
+        vector< double > fSliceZe;
+        vector< int >    fSliceWobbleOffset;
+        vector< string > fSliceInputFile;
+        // number of threads for filling of several slices (0 = number of cores)
+        unsigned int fNThreads;
         
         //////////////////////////////////////////
         // parameters for table reading only
@@ -162,6 +175,9 @@ class VTableLookupRunParameter : public TNamed, public VGlobalRunParameter
         bool bWriteMCPars;
         // copy pixel lists into mscw tree (large tree!)
         bool fWritePixelLists;
+        // write event data as RNTuple in addition to the data tree (0 = no, 1 = yes)
+        int  fWriteRNTuple;
+        int  fRNTupleCompression;
         // maximum time (in s) used of this run
         double fMaxRunTime;
         // parameters to be used in anasum
@@ -188,6 +204,6 @@ class VTableLookupRunParameter : public TNamed, public VGlobalRunParameter
         void print( int iB = 0 );
         void printHelp();
         
-        ClassDef( VTableLookupRunParameter, 1000 ); //for any changes to this file: increase this number
+        ClassDef( VTableLookupRunParameter, 1003 ); //for any changes to this file: increase this number
 };
 #endif
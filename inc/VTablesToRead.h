@@ -6,6 +6,8 @@
 #include "TH2F.h"
 #include "TH2D.h"
 
+#include "VCompiledLookupTableFile.h"
+
 #include <iostream>
 #include <map>
 #include <vector>
@@ -20,6 +22,7 @@ class VTablesToRead
         unsigned int    fNTel;
         map< unsigned int, vector< TH2F* > > hMedian;
         map< unsigned int, vector< TH2F* > > hSigma;
+        map< unsigned int, vector< const VCompiledLookupTable* > > hCompiledMedian;
         
         map< unsigned int, double > value;
         map< unsigned int, double > value_Chi2;
@@ -28,7 +31,7 @@ class VTablesToRead
         map< unsigned int, double* > value_T_sigma;
         
         VTablesToRead( unsigned int n_tabletypes, int nTel );
-        ~VTablesToRead() {}
+        ~VTablesToRead();
         void reset();
 };
 #endif
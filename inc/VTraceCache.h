@@ -0,0 +1,90 @@
+//! VTraceCache per-telescope buffer of decoded FADC traces (filled once per event)
+
+#ifndef VTraceCache_H
+#define VTraceCache_H
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/*
+ * settings a cached trace was decoded with and trace properties
+ * calculated during decoding (digital filter)
+ */
+class VTraceCacheEntry
+{
+    public:
+    
+        unsigned int fEvent;                       // event counter at time of filling
+        unsigned int fNSamples;                    // number of decoded samples
+        unsigned int fLength;                      // trace length (after upsampling)
+        double       fPed;
+        double       fHiLo;                        // low-gain multiplier (<=0: no scaling)
+        unsigned int fDF_method;
+        unsigned int fDF_upsample;
+        float        fDF_polezero;
+        double       fDF_tracemax;
+        unsigned int fSumWindowFirst;
+        unsigned int fSumWindowLast;
+        
+        VTraceCacheEntry();
+        ~VTraceCacheEntry() {}
+        
+        bool matches( const VTraceCacheEntry& iKey ) const
+        {
+            return ( fNSamples == iKey.fNSamples && fPed == iKey.fPed && fHiLo == iKey.fHiLo
+                     && fDF_method == iKey.fDF_method && fDF_upsample == iKey.fDF_upsample
+                     && fDF_polezero == iKey.fDF_polezero );
+        }
+};
+
+class VTraceCache
+{
+    private:
+    
+        unsigned int fNChannels;
+        unsigned int fStride;                      // space per channel in fTrace (samples x upsampling)
+        unsigned int fEvent;                       // entries filled with a different counter are invalid
+        
+        vector< double > fTrace;                   // [channel * fStride + sample]
+        vector< VTraceCacheEntry > fEntry;
+        
+        void   resizeStride( unsigned int iStride );
+    
+    public:
+    
+        VTraceCache();
+        ~VTraceCache() {}
+        
+        const VTraceCacheEntry* find( unsigned int iChannel, const VTraceCacheEntry& iKey ) const
+        {
+            if( iChannel < fNChannels && fEntry[iChannel].fEvent == fEvent && fEntry[iChannel].matches( iKey ) )
+            {
+                return &fEntry[iChannel];
+            }
+            return 0;
+        }
+        bool   fill( unsigned int iChannel, const VTraceCacheEntry& iEntry, const vector< double >& iTrace );
+        double* getBuffer( unsigned int iChannel, const VTraceCacheEntry& iEntry, unsigned int iLength );
+        const double* getTrace( unsigned int iChannel ) const
+        {
+            if( iChannel < fNChannels && fEntry[iChannel].fEvent == fEvent )
+            {
+                return &fTrace[iChannel * fStride];
+            }
+            return 0;
+        }
+        unsigned int getTraceLength( unsigned int iChannel ) const
+        {
+            if( iChannel < fNChannels && fEntry[iChannel].fEvent == fEvent )
+            {
+                return fEntry[iChannel].fLength;
+            }
+            return 0;
+        }
+        void   initialize( unsigned int iNChannels, unsigned int iNSamples );
+        void   newEvent();
+};
+
+#endif
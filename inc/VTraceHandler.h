@@ -8,6 +8,8 @@
 #include <stdint.h>
 #include <vector>
 
+#include "VDigitalFilter.h"
+#include "VTraceCache.h"
 #include "VVirtualDataReader.h"
 
 using namespace std;
@@ -43,8 +45,15 @@ class VTraceHandler
         unsigned int fDF_upsample;
         float        fDF_polezero;
         double       fDF_tracemax;
+        VDigitalFilter   fDF_filter;               // filter for blocks of channels
+        vector< float >  fDF_input;                // preallocated filter buffers
+        vector< float >  fDF_output;
+        vector< float >  fDF_baseline;
+        vector< float >  fDF_max;
+        vector< int >    fDF_at;
         int          PzpsaSmoothUpsampleFloat( int n, int us, float* ip, float bl, float pz, float* op, float* max, int* at );
         
+        VTraceCacheEntry getTraceCacheKey( unsigned int iNSamples, double iPed, double iHiLo );
         bool     apply_digitalFilter();
         bool     apply_lowgain( double );
         double   calculateTraceSum_fixedWindow( unsigned int , unsigned int, bool );
@@ -52,14 +61,34 @@ class VTraceHandler
         
         void     reset();
         
+        template< class T > void fillTrace( const VDataSpan< T >& iTrace, unsigned int iNSamples, unsigned int iFirst )
+        {
+            if( iNSamples != fpTrace.size() )
+            {
+                fpTrace.resize( iNSamples );
+            }
+            for( unsigned int i = 0; i < iNSamples; i++ )
+            {
+                fpTrace[i] = ( double )iTrace[i + iFirst];
+            }
+            fpTrazeSize = fpTrace.size();
+        }
+    
     public:
         VTraceHandler();
         virtual ~VTraceHandler() {};
         
         virtual void setTrace( vector< uint8_t >, double, unsigned int, double iHiLo = -1. ); //!< pass the trace values (with hilo)
         virtual void setTrace( vector< uint16_t >, double, unsigned int, double iHilo = -1. ); //!< pass the trace values (with hilo)
+        void setTrace( const VDataSpan< uint8_t >& pTrace, double, unsigned int, double iHiLo = -1. );
+        void setTrace( const VDataSpan< uint16_t >& pTrace, double, unsigned int, double iHiLo = -1. );
         virtual void setTrace( VVirtualDataReader* iReader, unsigned int iNSamples, double ped,
-                               unsigned int iChanID, unsigned int iHitID, double iHilo = -1. );
+                               unsigned int iChanID, unsigned int iHitID, double iHilo = -1.,
+                               VTraceCache* iTraceCache = 0 );
+        unsigned int fillTraceCache( VVirtualDataReader* iReader, unsigned int iNSamples,
+                                     const vector< unsigned int >& iHitID, const vector< unsigned int >& iChanID,
+                                     const vector< double >& iPed, const vector< double >& iHiLo,
+                                     VTraceCache* iTraceCache );
         vector< double >& getTrace()
         {
             return fpTrace;
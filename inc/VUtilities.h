@@ -12,9 +12,14 @@
 #include <string>
 #include <vector>
 
+#include "TGraph.h"
+#include "TLeaf.h"
+#include "TLeafC.h"
+#include "TMD5.h"
 #include "TMath.h"
 #include "TString.h"
 #include "TSystem.h"
+#include "TTree.h"
 
 #include "VGlobalRunParameter.h"
 
@@ -36,6 +41,9 @@ namespace VUtilities
     
     double line_point_distance( double x1, double y1, double z1,  double alt, double az, double x, double y, double z );
     
+    string getGraphMD5( TGraph* iGraph );
+    string getTreeMD5( TTree* iTree );
+    
     // from http://stackoverflow.com/questions/2844817/how-do-i-check-if-a-c-string-is-an-int
     inline bool isInteger( const std::string& s )
     {
@@ -3,6 +3,7 @@
 #ifndef VVIRTUALDATAREADER_H
 #define VVIRTUALDATAREADER_H
 
+#include "VDataSpan.h"
 #include "VMonteCarloRunHeader.h"
 #ifndef NOVBF
 #include "VRawDataExceptions.h"
@@ -32,6 +33,9 @@ class VVirtualDataReader
         std::vector<bool> f;
         std::vector<double> d;
         std::vector< uint16_t > iSampleVec16bit;
+        std::vector< bool > fFullHitVecBuffer;
+        std::vector< bool > fFullTrigVecBuffer;
+        std::vector< int > fFullAnaVecBuffer;
 
         string           fSourceFileName;
         vector< unsigned int > fTeltoAna;
@@ -111,6 +115,22 @@ class VVirtualDataReader
         {
             return b;
         }
+        // references to hit/trigger/analysis vectors (no copy for readers keeping these vectors)
+        virtual const std::vector< bool >&  getFullHitVecRef()
+        {
+            fFullHitVecBuffer = getFullHitVec();
+            return fFullHitVecBuffer;
+        }
+        virtual const std::vector< bool >&  getFullTrigVecRef()
+        {
+            fFullTrigVecBuffer = getFullTrigVec();
+            return fFullTrigVecBuffer;
+        }
+        virtual const std::vector< int >&   getFullAnaVecRef()
+        {
+            fFullAnaVecBuffer = getFullAnaVec();
+            return fFullAnaVecBuffer;
+        }
         virtual uint32_t                    getGPS0() = 0;
         virtual uint32_t                    getGPS1() = 0;
         virtual uint32_t                    getGPS2() = 0;
@@ -167,6 +187,16 @@ class VVirtualDataReader
         {
             return iSampleVec16bit;
         }
+        //!< view of the decoded samples of hit channel iHitID (empty: use getSample()/getSamplesVec())
+        virtual VDataSpan< uint8_t >        getSamplesSpan( uint32_t iHitID )
+        {
+            return VDataSpan< uint8_t >();
+        }
+        //!< view of the decoded samples of hit channel iHitID (16 bit; empty: use getSample16Bit()/getSamplesVec16Bit())
+        virtual VDataSpan< uint16_t >       getSamplesSpan16Bit( uint32_t iHitID )
+        {
+            return VDataSpan< uint16_t >();
+        }
         virtual void                        selectHitChan( uint32_t ) = 0;
         void                                setNumSamples( unsigned int iT, uint16_t iS )
         {
@@ -188,6 +218,18 @@ class VVirtualDataReader
         {
             return true;
         }
+        //!< number of events read ahead by a reader thread (0 = synchronous reading)
+        virtual void                        setPrefetchWindow( unsigned int iWindow = 0 ) {}
+        //!< position of the current event in the data file (-1 = random access not supported)
+        virtual int64_t                     getEventPosition()
+        {
+            return -1;
+        }
+        //!< next call of getNextEvent() reads the event at this position
+        virtual bool                        setEventPosition( int64_t iPosition )
+        {
+            return false;
+        }
 #ifndef NOVBF
         virtual VArrayTrigger*              getArrayTrigger()
         {
@@ -22,6 +22,8 @@ VAnaSum::VAnaSum( string i_datadir )
     fTotalDir = 0;
     fTotalDirName = "total_1";
     fStereoTotalDir = 0;
+    
+    fCacheKey = "";
 }
 
 /*
@@ -30,7 +32,8 @@ VAnaSum::VAnaSum( string i_datadir )
    check run mode
 
 */
-void VAnaSum::initialize( string i_LongListFilename, unsigned int iRunType, string i_outfile, int iRandomSeed, string iRunParameterfile )
+void VAnaSum::initialize( string i_LongListFilename, unsigned int iRunType, string i_outfile, int iRandomSeed, string iRunParameterfile,
+                          int iSelectedRunOn )
 {
     char i_temp[2000];
     char i_title[200];
@@ -71,6 +74,16 @@ void VAnaSum::initialize( string i_LongListFilename, unsigned int iRunType, stri
         cout << "...exiting" << endl;
         exit( EXIT_FAILURE );
     }
+    // analyse a single run of the run list only
+    if( iSelectedRunOn > 0 )
+    {
+        if( !fRunPara->selectRun( iSelectedRunOn ) )
+        {
+            cout << "...exiting" << endl;
+            exit( EXIT_FAILURE );
+        }
+        i_npair = ( int )fRunPara->fRunList.size();
+    }
     if( fAnalysisRunMode != 1 )
     {
         cout << "Random seed for stereo maps: " << iRandomSeed << endl;
@@ -893,10 +906,249 @@ void VAnaSum::terminate()
 {
     if( fOPfile )
     {
+        // key for run-wise results (incremental mode)
+        // (written last, incomplete files are therefore never reused)
+        if( fCacheKey.size() > 0 )
+        {
+            fOPfile->cd();
+            TNamed iCacheKey( "anasumCacheKey", fCacheKey.c_str() );
+            iCacheKey.Write();
+        }
         fOPfile->Close();
     }
 }
 
+/*
+ * incremental analysis
+ *
+ * run-wise results are kept in iCacheDirectory (one anasum file per run,
+ * same format as used for merging analysis results).
+ * Runs are analysed only if no cached result exists or if the
+ * cached result was produced with different input files or parameters.
+ *
+ * combine results afterwards with the merging analysis
+ * (run type 1, data directory = cache directory)
+ *
+ */
+bool VAnaSum::updateRunCache( string i_LongListFilename, string iCacheDirectory,
+                              int iRandomSeed, string iRunParameterfile )
+{
+    gSystem->mkdir( iCacheDirectory.c_str(), kTRUE );
+    if( gSystem->AccessPathName( iCacheDirectory.c_str() ) )
+    {
+        cout << "VAnaSum::updateRunCache error: cannot create cache directory " << iCacheDirectory << endl;
+        return false;
+    }
+    
+    // read list of runs
+    // (cut and effective area files are checked in the run-wise analysis)
+    VAnaSumRunParameter* iRunPara = new VAnaSumRunParameter();
+    if( !iRunPara->readRunParameter( iRunParameterfile ) )
+    {
+        cout << "VAnaSum::updateRunCache: error while reading run parameters" << endl;
+        delete iRunPara;
+        return false;
+    }
+    if( iRunPara->loadLongFileList( i_LongListFilename, false, true ) == 0 )
+    {
+        cout << "VAnaSum::updateRunCache error: no files found in runlist" << endl;
+        delete iRunPara;
+        return false;
+    }
+    
+    cout << endl;
+    cout << "incremental analysis (cache directory: " << iCacheDirectory << ")" << endl;
+    unsigned int iNAnalysed = 0;
+    char i_temp[2000];
+    for( unsigned int j = 0; j < iRunPara->fRunList.size(); j++ )
+    {
+        sprintf( i_temp, "%s/%d.anasum.root", iCacheDirectory.c_str(), iRunPara->fRunList[j].fRunOn );
+        string iCacheFile = i_temp;
+        string iCacheKey = getRunCacheKey( iRunPara, j, iRunParameterfile, iRandomSeed );
+        if( isValidRunCache( iCacheFile, iCacheKey ) )
+        {
+            cout << "	 run " << iRunPara->fRunList[j].fRunOn << ": using cached results" << endl;
+            continue;
+        }
+        cout << "	 run " << iRunPara->fRunList[j].fRunOn << ": analysing run (no valid cached results)" << endl;
+        
+        VAnaSum* iRunAnaSum = new VAnaSum( fDatadir );
+        iRunAnaSum->initialize( i_LongListFilename, 0, iCacheFile, iRandomSeed, iRunParameterfile, iRunPara->fRunList[j].fRunOn );
+        iRunAnaSum->doStereoAnalysis();
+        iRunAnaSum->fCacheKey = iCacheKey;
+        iRunAnaSum->terminate();
+        delete iRunAnaSum;
+        iNAnalysed++;
+    }
+    cout << "incremental analysis: " << iNAnalysed << " out of " << iRunPara->fRunList.size();
+    cout << " runs analysed, " << iRunPara->fRunList.size() - iNAnalysed << " runs taken from cache" << endl;
+    
+    delete iRunPara;
+    return true;
+}
+
+/*
+ * check if a cached run-wise result exists and is consistent with the current analysis
+ *
+ */
+bool VAnaSum::isValidRunCache( string iCacheFile, string iCacheKey )
+{
+    if( iCacheKey.size() == 0 || gSystem->AccessPathName( iCacheFile.c_str() ) )
+    {
+        return false;
+    }
+    TFile iF( iCacheFile.c_str() );
+    if( iF.IsZombie() )
+    {
+        return false;
+    }
+    bool iValid = false;
+    TNamed* iKey = ( TNamed* )iF.Get( "anasumCacheKey" );
+    if( iKey && iCacheKey == iKey->GetTitle() )
+    {
+        iValid = true;
+    }
+    iF.Close();
+    
+    return iValid;
+}
+
+/*
+ * signature of an input file
+ *
+ * files are resolved as in the analysis (current directory first, then
+ * $VERITAS_EVNDISP_AUX_DIR/iDirectory)
+ *
+ * small files (e.g. cut files, run parameter files): MD5 checksum of content
+ * large files (e.g. effective areas, mscw files): resolved file name, size and modification time
+ *
+ * returns an empty string for files which cannot be found
+ *
+ */
+string VAnaSum::getFileSignature( string iFile, string iDirectory )
+{
+    if( iFile.size() == 0 || iFile == "NOFILE" || iFile == "simu"
+            || iFile.find( "IGNORE" ) != string::npos )
+    {
+        return "NOFILE";
+    }
+    if( iDirectory.size() > 0 )
+    {
+        iFile = VUtilities::testFileLocation( iFile, iDirectory, true );
+        if( iFile.size() == 0 )
+        {
+            return "";
+        }
+    }
+    TString iPath( iFile.c_str() );
+    gSystem->ExpandPathName( iPath );
+    Long_t id = 0;
+    Long_t flags = 0;
+    Long_t modtime = 0;
+    Long64_t size = 0;
+    if( gSystem->GetPathInfo( iPath.Data(), &id, &size, &flags, &modtime ) != 0 )
+    {
+        return "";
+    }
+    stringstream iSignature;
+    if( size < 10 * 1024 * 1024 )
+    {
+        TMD5* iMD5 = TMD5::FileChecksum( iPath.Data() );
+        if( iMD5 )
+        {
+            iSignature << iMD5->AsString();
+            delete iMD5;
+            return iSignature.str();
+        }
+    }
+    iSignature << iPath.Data() << ":" << size << ":" << modtime;
+    return iSignature.str();
+}
+
+/*
+ * key describing all inputs to the analysis of a single run
+ *
+ * (run numbers, pointing and target definitions, background model, cut and IRF files,
+ *  input data files, run parameter file incl. exclusion regions and time masks)
+ *
+ * returns an empty string (i.e. no valid cache) if one of the input files cannot be found
+ *
+ */
+string VAnaSum::getRunCacheKey( VAnaSumRunParameter* iRunPara, unsigned int iRunCounter,
+                                string iRunParameterfile, int iRandomSeed )
+{
+    if( !iRunPara || iRunCounter >= iRunPara->fRunList.size() )
+    {
+        return "";
+    }
+    VAnaSumRunParameterDataClass* iR = &iRunPara->fRunList[iRunCounter];
+    
+    // run parameter file might be in the parameter directory
+    if( gSystem->AccessPathName( iRunParameterfile.c_str() ) )
+    {
+        iRunParameterfile = iRunPara->getDirectory_EVNDISPParameterFiles() + "/" + iRunParameterfile;
+    }
+    char i_temp[2000];
+    stringstream iKey;
+    iKey << setprecision( 10 );
+    iKey << VGlobalRunParameter::getEVNDISP_VERSION() << "|" << iRandomSeed;
+    iKey << "|" << iRunPara->getInputFileVersionNumber();
+    iKey << "|" << iR->fRunOn << "|" << iR->fRunOff << "|" << iR->fPairOffset;
+    iKey << "|" << iR->fTarget << "|" << iR->fTargetRAJ2000 << "|" << iR->fTargetDecJ2000;
+    iKey << "|" << iR->fTargetRA << "|" << iR->fTargetDec;
+    iKey << "|" << iR->fWobbleNorth << "|" << iR->fWobbleWest;
+    iKey << "|" << iR->fSkyMapCentreNorth << "|" << iR->fSkyMapCentreWest;
+    iKey << "|" << iR->fTargetShiftNorth << "|" << iR->fTargetShiftWest;
+    iKey << "|" << iR->fTargetShiftRAJ2000 << "|" << iR->fTargetShiftDecJ2000;
+    iKey << "|" << iR->fOff_Target << "|" << iR->fOff_TargetRAJ2000 << "|" << iR->fOff_TargetDecJ2000;
+    iKey << "|" << iR->fOff_WobbleNorth << "|" << iR->fOff_WobbleWest;
+    iKey << "|" << iR->fTelToAna << "|" << iR->fSourceRadius << "|" << iR->fmaxradius;
+    iKey << "|" << iR->fBackgroundModel << "|" << iR->f2DAcceptanceMode << "|" << iR->fOO_alpha;
+    iKey << "|" << iR->fRM_RingRadius << "|" << iR->fRM_RingWidth;
+    iKey << "|" << iR->fRE_distanceSourceOff << "|" << iR->fRE_nMinoffsource << "|" << iR->fRE_nMaxoffsource;
+    
+    // input files (resolved as in the analysis)
+    vector< string > iSignatures;
+    iSignatures.push_back( getFileSignature( iRunParameterfile ) );
+    iSignatures.push_back( getFileSignature( iRunPara->fTimeMaskFile ) );
+    // cuts are read from the effective area file or from a cut file
+    if( iR->fCutFile.find( ".root" ) != string::npos )
+    {
+        iSignatures.push_back( getFileSignature( iR->fCutFile, "EffectiveAreas" ) );
+    }
+    else
+    {
+        iSignatures.push_back( getFileSignature( iR->fCutFile, "GammaHadronCutFiles" ) );
+    }
+    iSignatures.push_back( getFileSignature( iR->fEffectiveAreaFile, "EffectiveAreas" ) );
+    if( iR->fAcceptanceFile.find( "/" ) == string::npos )
+    {
+        iSignatures.push_back( getFileSignature( iR->fAcceptanceFile, "RadialAcceptances" ) );
+    }
+    else
+    {
+        iSignatures.push_back( getFileSignature( iR->fAcceptanceFile ) );
+    }
+    sprintf( i_temp, "%s%s%d%s", fDatadir.c_str(), fPrefix.c_str(), iR->fRunOn, fSuffix.c_str() );
+    iSignatures.push_back( getFileSignature( i_temp ) );
+    sprintf( i_temp, "%s%s%d%s", fDatadir.c_str(), fPrefix.c_str(), iR->fRunOff, fSuffix.c_str() );
+    iSignatures.push_back( getFileSignature( i_temp ) );
+    for( unsigned int i = 0; i < iSignatures.size(); i++ )
+    {
+        if( iSignatures[i].size() == 0 )
+        {
+            return "";
+        }
+        iKey << "|" << iSignatures[i];
+    }
+    
+    TMD5 iMD5;
+    iMD5.Update( ( const UChar_t* )iKey.str().c_str(), ( UInt_t )iKey.str().size() );
+    iMD5.Final();
+    
+    return iMD5.AsString();
+}
+
 
 /*!
  *
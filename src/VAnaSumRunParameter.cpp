@@ -159,6 +159,10 @@ VAnaSumRunParameter::VAnaSumRunParameter()
     
     fWriteEventTree = 2;
     
+    // DL3 event lists
+    fWriteDL3EventList = 0;
+    fDL3FITSDirectory = "./";
+    
     // Binned Likelihood
     fLikelihoodAnalysis = false;
     
@@ -738,6 +742,19 @@ int VAnaSumRunParameter::readRunParameter( string i_filename, bool fIgnoreZeroEx
             {
                 fWriteEventTree = ( unsigned int )atoi( temp2.c_str() );
             }
+            ///////////////////////////////////////////////////////////
+            // WRITEDL3EVENTLIST
+            // 0 = write DL3 event tree into anasum output file (default)
+            // 1 = write DL3 event tree and FITS event list
+            // 2 = write FITS event list only (DL3 event tree if FITS event list cannot be written)
+            else if( temp == "WRITEDL3EVENTLIST" )
+            {
+                fWriteDL3EventList = ( unsigned int )atoi( temp2.c_str() );
+            }
+            else if( temp == "DL3FITSDIRECTORY" )
+            {
+                fDL3FITSDirectory = temp2;
+            }
             /// enable likelihood analysis ///
             else if( temp == "ENABLEBINNEDLIKELIHOOD" )
             {
@@ -1538,6 +1555,34 @@ unsigned int VAnaSumRunParameter::getMaxNumberofTelescopes()
 }
 
 
+/*
+ * reduce run list to a single on run
+ *
+ * (used for run-wise analysis in incremental mode)
+ */
+bool VAnaSumRunParameter::selectRun( int iRunOn )
+{
+    vector< VAnaSumRunParameterDataClass > iRunList;
+    for( unsigned int i = 0; i < fRunList.size(); i++ )
+    {
+        if( fRunList[i].fRunOn == iRunOn )
+        {
+            iRunList.push_back( fRunList[i] );
+        }
+    }
+    if( iRunList.size() == 0 )
+    {
+        cout << "VAnaSumRunParameter::selectRun error: run " << iRunOn << " not found in run list" << endl;
+        return false;
+    }
+    fRunList = iRunList;
+    fMapRunList.clear();
+    fMapRunList[fRunList[0].fRunOn] = fRunList[0];
+    
+    return true;
+}
+
+
 bool VAnaSumRunParameter::setTargetShifts( unsigned int i, double west, double north, double ra, double dec )
 {
     if( i < fRunList.size() )
@@ -10,6 +10,8 @@
 
 #include "VArrayAnalyzer.h"
 
+map< string, VDispAnalyzer* > VArrayAnalyzer::fDispAnalyzerCache;
+
 VArrayAnalyzer::VArrayAnalyzer()
 {
     fDebug = getDebugFlag();
@@ -25,6 +27,12 @@ VArrayAnalyzer::VArrayAnalyzer()
             getEvndispReconstructionParameter()->getNReconstructionCuts() );
     // set up MC data storage class
     fMCParameters = new VMCParameters( fDebug );
+    // image parameters of all telescopes in one tree (optional)
+    if( getRunParameter()->fWriteSparseImageTree )
+    {
+        fImageParameterSparseTree = new VImageParameterSparseTree( getRunParameter()->fShortTree,
+                getRunParameter()->fWriteImagePixelList );
+    }
     // test if number of telescopes exceeds value in fShowerParameters
     if( getNTel() > fShowerParameters->getMaxNTelescopes() )
     {
@@ -433,9 +441,8 @@ void VArrayAnalyzer::initAnalysis()
         {
             if( getEvndispReconstructionParameter( i )->fMethodID == 5 )
             {
-                fDispAnalyzer.push_back( new VDispAnalyzer() );
-                fDispAnalyzer.back()->setTelescopeTypeList( getDetectorGeometry()->getTelType_list() );
-                if( !fDispAnalyzer.back()->initialize( getEvndispReconstructionParameter( i )->fDISP_MLPFileName, "MLP" ) )
+                fDispAnalyzer.push_back( getDispAnalyzer( getEvndispReconstructionParameter( i )->fDISP_MLPFileName, "MLP" ) );
+                if( !fDispAnalyzer.back() )
                 {
                     exit( EXIT_FAILURE );
                 }
@@ -508,6 +515,17 @@ void VArrayAnalyzer::initTree()
         i_sst << "(short tree)";
     }
     fShowerParameters->initTree( "showerpars", i_sst.str(), fReader->isMC() );
+    if( fImageParameterSparseTree )
+    {
+        stringstream i_sst_tpars;
+        i_sst_tpars << "Event Parameters (all telescopes, VERSION ";
+        i_sst_tpars << getRunParameter()->getEVNDISP_TREE_VERSION() << ")";
+        if( getRunParameter()->fShortTree )
+        {
+            i_sst_tpars << " (short tree)";
+        }
+        fImageParameterSparseTree->initTree( "tparsSparse", i_sst_tpars.str() );
+    }
     if( isMC() && fMCParameters )
     {
         fMCParameters->initTree();
@@ -579,6 +597,13 @@ void VArrayAnalyzer::terminate( bool iWriteDebug )
             }
             cout << endl;
         }
+        if( getImageParameterSparseTree() && getImageParameterSparseTree()->getTree() )
+        {
+            cout << "writing image parameter tree (";
+            cout << getImageParameterSparseTree()->getTree()->GetEntries();
+            cout << " entries)" << endl;
+            getImageParameterSparseTree()->getTree()->Write();
+        }
         ///////////////////////////////////////////////////////////////
         // MC tree and histograms
         if( isMC() )
@@ -2259,10 +2284,9 @@ void VArrayAnalyzer::initializeDispAnalyzer( unsigned int iStereoCutCounter )
     // initialize disp analyzer
     else
     {
-        fDispAnalyzer.push_back( new VDispAnalyzer() );
-        fDispAnalyzer.back()->setTelescopeTypeList( getDetectorGeometry()->getTelType_list() );
         // initialize disp with BDTs from closest zenith angle
-        if( !fDispAnalyzer.back()->initialize( getTMVAFileNameForAngularReconstruction( iStereoCutCounter ), "TMVABDT" ) )
+        fDispAnalyzer.push_back( getDispAnalyzer( getTMVAFileNameForAngularReconstruction( iStereoCutCounter ), "TMVABDT" ) );
+        if( !fDispAnalyzer.back() )
         {
             cout << "VArrayAnalyzer::initAnalysis() error initializing MVA-BDT (method " << iStereoCutCounter << ")" << endl;
             cout << "\t file " << getTMVAFileNameForAngularReconstruction( iStereoCutCounter ) << endl;
@@ -2272,6 +2296,53 @@ void VArrayAnalyzer::initializeDispAnalyzer( unsigned int iStereoCutCounter )
     }
 }
 
+/*
+ * return disp analyzer for the given weight file and disp method
+ *
+ * BDT disp analyzers are kept resident and shared between runs
+ * (reading the TMVA weight files is expensive, see evndisp queue mode);
+ * MLP disp tables are closed at the end of each run and are not reused
+ *
+ */
+VDispAnalyzer* VArrayAnalyzer::getDispAnalyzer( string iFile, string iDispMethod )
+{
+    ostringstream iKey;
+    iKey << iDispMethod << "|" << iFile;
+    for( unsigned int i = 0; i < getDetectorGeometry()->getTelType_list().size(); i++ )
+    {
+        iKey << "|" << getDetectorGeometry()->getTelType_list()[i];
+    }
+    if( fDispAnalyzerCache.find( iKey.str() ) != fDispAnalyzerCache.end() )
+    {
+        cout << "reusing disp analyzer (" << iDispMethod << "): " << iFile << endl;
+        return fDispAnalyzerCache[iKey.str()];
+    }
+    VDispAnalyzer* iDispAnalyzer = new VDispAnalyzer();
+    iDispAnalyzer->setTelescopeTypeList( getDetectorGeometry()->getTelType_list() );
+    if( !iDispAnalyzer->initialize( iFile, iDispMethod ) )
+    {
+        delete iDispAnalyzer;
+        return 0;
+    }
+    if( iDispMethod == "TMVABDT" )
+    {
+        fDispAnalyzerCache[iKey.str()] = iDispAnalyzer;
+    }
+    
+    return iDispAnalyzer;
+}
+
+/*
+ * reset all run dependent data
+ *
+ * (disp analyzers are not deleted, see getDispAnalyzer())
+ */
+void VArrayAnalyzer::resetRun()
+{
+    fInitialized = false;
+    fDispAnalyzer.clear();
+}
+
 /*
    test angle between two image lines
 
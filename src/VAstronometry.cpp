@@ -115,7 +115,56 @@ void VAstronometry::vlaPreces( double MJD_ep0, double MJD_ep1, double* ra, doubl
     
     // precession matrix
     double rot_prec[3][3];
+    vlaPrecesMatrix( MJD_ep0, MJD_ep1, rot_prec );
     
+    double e1[3];
+    double e2[3];
+    
+    // Convert spherical coordinates to Cartesian
+    iauS2c( *ra, *dc, e1 );
+    // apply precession matrix
+    iauRxp( rot_prec, e1, e2 );
+    // P-vector to spherical coordinates
+    iauC2s( e2, ra, dc );
+    *ra = iauAnp( *ra );
+#endif
+}
+
+/*
+ *  Precession of a list of positions
+ *
+ *  (precession matrix is calculated once for all positions)
+ *
+ */
+void VAstronometry::vlaPreces( double MJD_ep0, double MJD_ep1, vector< double >& ra, vector< double >& dc )
+{
+#ifdef ASTROSLALIB
+    for( unsigned int i = 0; i < ra.size() && i < dc.size(); i++ )
+    {
+        vlaPreces( MJD_ep0, MJD_ep1, &ra[i], &dc[i] );
+    }
+#elif ASTROSOFA
+    double rot_prec[3][3];
+    vlaPrecesMatrix( MJD_ep0, MJD_ep1, rot_prec );
+    
+    double e1[3];
+    double e2[3];
+    for( unsigned int i = 0; i < ra.size() && i < dc.size(); i++ )
+    {
+        iauS2c( ra[i], dc[i], e1 );
+        iauRxp( rot_prec, e1, e2 );
+        iauC2s( e2, &ra[i], &dc[i] );
+        ra[i] = iauAnp( ra[i] );
+    }
+#endif
+}
+
+#ifdef ASTROSOFA
+/*
+ *  precession matrix (FK5) between two epochs
+ */
+void VAstronometry::vlaPrecesMatrix( double MJD_ep0, double MJD_ep1, double rot_prec[3][3] )
+{
     // days since year 2000
     double ep0_days_2000 = MJD_ep0 - DJM00;
     double ep1_days_2000 = MJD_ep1 - DJM00;
@@ -143,18 +192,8 @@ void VAstronometry::vlaPreces( double MJD_ep0, double MJD_ep1, double* ra, doubl
         iauPmat06( DJ00, ep1_days_2000, temp_tot_mat );
         iauRxr( rot_prec, temp_tot_mat, rot_prec );
     }
-    double e1[3];
-    double e2[3];
-    
-    // Convert spherical coordinates to Cartesian
-    iauS2c( *ra, *dc, e1 );
-    // apply precession matrix
-    iauRxp( rot_prec, e1, e2 );
-    // P-vector to spherical coordinates
-    iauC2s( e2, ra, dc );
-    *ra = iauAnp( *ra );
-#endif
 }
+#endif
 
 /*
  * Normalize angle into range 0-2 pi.
@@ -19,6 +19,9 @@ VBFDataReader::VBFDataReader( string sourcefile, int isourcetype, unsigned int i
     fNIncompleteEvent.assign( iNTel, 0 );
     setDebug( iDebug );
     fPrintDetectorConfig = iPrintDetectorConfig;
+    fPrefetchWindow = 0;
+    fPrefetchIndex = 0;
+    fPrefetchError = false;
 }
 
 
@@ -28,6 +31,7 @@ VBFDataReader::~VBFDataReader()
     {
         cout << "VBFDataReader::~VBFDataReader()" << endl;
     }
+    stopPrefetch();
     if( pack != NULL )
     {
         delete pack;
@@ -51,15 +55,14 @@ bool VBFDataReader::getNextEvent()
         }
         for( ;; )
         {
-            if( !reader.hasPacket( index ) )
-            {
-                setEventStatus( 999 );
-                return false;
-            }
             VPacket* old_pack = pack;
             try
             {
-                pack = reader.readPacket( index );
+                if( !readNextPacket( pack ) )
+                {
+                    setEventStatus( 999 );
+                    return false;
+                }
             }
             catch( const std::exception& e )
             {
@@ -236,6 +239,119 @@ bool VBFDataReader::getNextEvent()
 }
 
 
+/*
+ * read packet at position index
+ *
+ * (from the prefetch ring if asynchronous reading is switched on)
+ *
+ * returns false if there are no more packets; read errors are
+ * passed on as exceptions
+ */
+bool VBFDataReader::readNextPacket( VPacket*& iPacket )
+{
+    if( fPrefetchWindow == 0 )
+    {
+        if( !reader.hasPacket( index ) )
+        {
+            return false;
+        }
+        iPacket = reader.readPacket( index );
+        return true;
+    }
+    
+    if( !fPrefetchRing.isRunning() )
+    {
+        fPrefetchIndex = index;
+        fPrefetchError = false;
+        fPrefetchRing.start( fPrefetchWindow, VBFPrefetchPacket(), [this]( VBFPrefetchPacket & iPacket )
+        {
+            // stop reading at the end of the file or after a read error
+            if( fPrefetchError || !reader.hasPacket( fPrefetchIndex ) )
+            {
+                return false;
+            }
+            try
+            {
+                iPacket.fPacket = reader.readPacket( fPrefetchIndex );
+                iPacket.fError = "";
+            }
+            catch( const std::exception& e )
+            {
+                iPacket.fPacket = 0;
+                iPacket.fError = e.what();
+                if( iPacket.fError.size() == 0 )
+                {
+                    iPacket.fError = "unknown read error";
+                }
+                fPrefetchError = true;
+            }
+            fPrefetchIndex++;
+            return true;
+        } );
+    }
+    
+    VBFPrefetchPacket i_packet;
+    if( !fPrefetchRing.next( i_packet ) )
+    {
+        return false;
+    }
+    if( i_packet.fError.size() > 0 )
+    {
+        throw runtime_error( i_packet.fError );
+    }
+    iPacket = i_packet.fPacket;
+    return true;
+}
+
+
+/*
+ * read packets asynchronously
+ *
+ * a reader thread reads and decodes up to iWindow packets ahead
+ * of the analysis (iWindow = 0: synchronous reading)
+ */
+void VBFDataReader::setPrefetchWindow( unsigned int iWindow )
+{
+    stopPrefetch();
+    fPrefetchWindow = iWindow;
+}
+
+
+/*
+ * position reader at packet iPosition
+ *
+ * (next call of getNextEvent() reads this packet)
+ */
+bool VBFDataReader::setEventPosition( int64_t iPosition )
+{
+    stopPrefetch();
+    if( iPosition < 0 || !reader.hasPacket( ( unsigned )iPosition ) )
+    {
+        return false;
+    }
+    index = ( unsigned )iPosition;
+    return true;
+}
+
+
+/*
+ * stop prefetch thread and delete packets not yet analysed
+ */
+void VBFDataReader::stopPrefetch()
+{
+    fPrefetchRing.stop();
+    VBFPrefetchPacket i_packet;
+    while( fPrefetchRing.next( i_packet ) )
+    {
+        if( i_packet.fPacket )
+        {
+            delete i_packet.fPacket;
+        }
+        i_packet.fPacket = 0;
+    }
+}
+
+
 unsigned int VBFDataReader::getNTel()
 {
     unsigned int z = 0;
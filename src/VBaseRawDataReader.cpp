@@ -525,6 +525,84 @@ std::vector< uint8_t > VBaseRawDataReader::getSamplesVec()
 }
 
 
+/*
+ * view of the samples of hit channel iHitID
+ *
+ * samples of all hit channels are decoded once per event into a
+ * contiguous buffer; no view is given if samples are modified on
+ * access (noise from external file, gaussian noise, throughput correction)
+ */
+VDataSpan< uint8_t > VBaseRawDataReader::getSamplesSpan( uint32_t iHitID )
+{
+    if( fNoiseFileReader || finjectGaussianNoise > 0. || fTraceAmplitudeCorrectionS.size() > 0 )
+    {
+        return VDataSpan< uint8_t >();
+    }
+    if( !fillSampleBuffer() )
+    {
+        return VDataSpan< uint8_t >();
+    }
+    unsigned int i_nSamples = fSampleBufferNSamples[fTelID];
+    if( i_nSamples == 0 || ( iHitID + 1 ) * i_nSamples > fSampleBuffer[fTelID].size() )
+    {
+        return VDataSpan< uint8_t >();
+    }
+    return VDataSpan< uint8_t >( &fSampleBuffer[fTelID][iHitID * i_nSamples], i_nSamples );
+}
+
+
+/*
+ * decode samples of all hit channels of the current telescope event
+ *
+ * (buffer is reused for the following events; no allocation after the first events)
+ */
+bool VBaseRawDataReader::fillSampleBuffer()
+{
+    if( fTelID >= fEvent.size() || !fEvent[fTelID] )
+    {
+        return false;
+    }
+    if( fSampleBuffer.size() != fEvent.size() )
+    {
+        fSampleBuffer.resize( fEvent.size() );
+        fSampleBufferEvent.assign( fEvent.size(), 0 );
+        fSampleBufferEventNumber.assign( fEvent.size(), 0 );
+        fSampleBufferNSamples.assign( fEvent.size(), 0 );
+    }
+    VEvent* i_event = fEvent[fTelID];
+    // buffer is up to date
+    if( fSampleBufferEvent[fTelID] == i_event && fSampleBufferEventNumber[fTelID] == i_event->getEventNumber() )
+    {
+        return ( fSampleBufferNSamples[fTelID] > 0 );
+    }
+    fSampleBufferEvent[fTelID] = i_event;
+    fSampleBufferEventNumber[fTelID] = i_event->getEventNumber();
+    fSampleBufferNSamples[fTelID] = 0;
+    
+    unsigned int i_nSamples = i_event->getNumSamples();
+    unsigned int i_nHits = i_event->getNumChannelsHit();
+    fSampleBuffer[fTelID].resize( i_nSamples * i_nHits );
+    try
+    {
+        uint8_t* i_buffer = ( i_nSamples * i_nHits > 0 ? &fSampleBuffer[fTelID][0] : 0 );
+        for( unsigned int h = 0; h < i_nHits; h++ )
+        {
+            for( unsigned int s = 0; s < i_nSamples; s++ )
+            {
+                i_buffer[h * i_nSamples + s] = i_event->getSample( h, s );
+            }
+        }
+    }
+    catch( ... )
+    {
+        // fall back to sample-wise access (with error handling in getSample())
+        return false;
+    }
+    fSampleBufferNSamples[fTelID] = i_nSamples;
+    return ( i_nSamples > 0 );
+}
+
+
 void VBaseRawDataReader::selectHitChan( uint32_t i )
 {
     fHitID = i;
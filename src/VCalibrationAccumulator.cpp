@@ -0,0 +1,332 @@
+/*! \class VCalibrationAccumulator
+    \brief per-channel statistics for gain and time offset calibration (flasher/laser runs)
+    
+    gain and time offset distributions, time offset vs charge profiles
+    and mean pulse shapes are kept in flat arrays (one block per channel)
+    
+    means, RMS and medians are calculated for all channels in parallel
+    at the end of the run; ROOT histograms are created on request only
+    
+    statistics follow the conventions of TH1F/TProfile (mean and RMS from
+    fills inside the histogram range, median from the binned distribution)
+
+*/
+
+#include "VCalibrationAccumulator.h"
+
+#include <atomic>
+#include <thread>
+
+VCalibrationDistribution::VCalibrationDistribution()
+{
+    fNChannels = 0;
+    fNBins = 0;
+    fXmin = 0.;
+    fXmax = 0.;
+    fScale = 0.;
+}
+
+void VCalibrationDistribution::init( unsigned int iNChannels, unsigned int iNBins, double iXmin, double iXmax )
+{
+    fNChannels = iNChannels;
+    fNBins = iNBins;
+    fXmin = iXmin;
+    fXmax = iXmax;
+    if( fNBins > 0 && fXmax > fXmin )
+    {
+        fScale = ( double )fNBins / ( fXmax - fXmin );
+    }
+    else
+    {
+        fScale = 0.;
+    }
+    fBinContent.assign( fNChannels * ( fNBins + 2 ), 0. );
+    fEntries.assign( fNChannels, 0. );
+    fSumW.assign( fNChannels, 0. );
+    fSumWX.assign( fNChannels, 0. );
+    fSumWX2.assign( fNChannels, 0. );
+    fMean.assign( fNChannels, 0. );
+    fRMS.assign( fNChannels, 0. );
+    fMedian.assign( fNChannels, 0. );
+}
+
+/*
+ * calculate mean, RMS and median for one channel
+ *
+ * (median calculated as in TH1::GetQuantiles)
+ */
+void VCalibrationDistribution::calculate( unsigned int iChannel )
+{
+    if( iChannel >= fNChannels )
+    {
+        return;
+    }
+    fMean[iChannel] = 0.;
+    fRMS[iChannel] = 0.;
+    fMedian[iChannel] = 0.;
+    if( fSumW[iChannel] <= 0. )
+    {
+        return;
+    }
+    double iMean = fSumWX[iChannel] / fSumW[iChannel];
+    double iVar = fSumWX2[iChannel] / fSumW[iChannel] - iMean * iMean;
+    fMean[iChannel] = iMean;
+    if( iVar > 0. )
+    {
+        fRMS[iChannel] = sqrt( iVar );
+    }
+    
+    // cumulative distribution
+    const float* iC = &fBinContent[iChannel * ( fNBins + 2 ) + 1];
+    vector< double > iIntegral( fNBins + 1, 0. );
+    for( unsigned int i = 0; i < fNBins; i++ )
+    {
+        iIntegral[i + 1] = iIntegral[i] + iC[i];
+    }
+    if( iIntegral[fNBins] <= 0. )
+    {
+        return;
+    }
+    for( unsigned int i = 1; i <= fNBins; i++ )
+    {
+        iIntegral[i] /= iIntegral[fNBins];
+    }
+    // last bin with integral <= 0.5
+    unsigned int iBin = 0;
+    for( unsigned int i = 0; i < fNBins; i++ )
+    {
+        if( iIntegral[i] <= 0.5 )
+        {
+            iBin = i;
+        }
+    }
+    double iW = ( fXmax - fXmin ) / ( double )fNBins;
+    double x = fXmin + iBin * iW;
+    double dI = iIntegral[iBin + 1] - iIntegral[iBin];
+    if( dI > 0. )
+    {
+        x += iW * ( 0.5 - iIntegral[iBin] ) / dI;
+    }
+    fMedian[iChannel] = x;
+}
+
+/*
+ * create ROOT histogram for one channel
+ *
+ * (histogram is owned by the current directory)
+ */
+TH1F* VCalibrationDistribution::getHistogram( unsigned int iChannel, string iName, string iTitle )
+{
+    if( iChannel >= fNChannels )
+    {
+        return 0;
+    }
+    TH1F* h = new TH1F( iName.c_str(), iTitle.c_str(), fNBins, fXmin, fXmax );
+    const float* iC = &fBinContent[iChannel * ( fNBins + 2 )];
+    for( unsigned int i = 0; i < fNBins + 2; i++ )
+    {
+        h->SetBinContent( i, iC[i] );
+    }
+    double iStats[4];
+    iStats[0] = fSumW[iChannel];
+    iStats[1] = fSumW[iChannel];
+    iStats[2] = fSumWX[iChannel];
+    iStats[3] = fSumWX2[iChannel];
+    h->PutStats( iStats );
+    h->SetEntries( fEntries[iChannel] );
+    return h;
+}
+
+VCalibrationProfile::VCalibrationProfile()
+{
+    fNChannels = 0;
+    fNBins = 0;
+    fXmin = 0.;
+    fXmax = 0.;
+    fScale = 0.;
+    fYmin = 0.;
+    fYmax = 0.;
+}
+
+void VCalibrationProfile::init( unsigned int iNChannels, unsigned int iNBins, double iXmin, double iXmax, double iYmin, double iYmax )
+{
+    fNChannels = iNChannels;
+    fNBins = iNBins;
+    fXmin = iXmin;
+    fXmax = iXmax;
+    fYmin = iYmin;
+    fYmax = iYmax;
+    if( fNBins > 0 && fXmax > fXmin )
+    {
+        fScale = ( double )fNBins / ( fXmax - fXmin );
+    }
+    else
+    {
+        fScale = 0.;
+    }
+    fBinEntries.assign( fNChannels * ( fNBins + 2 ), 0. );
+    fSumY.assign( fNChannels * ( fNBins + 2 ), 0. );
+    fSumY2.assign( fNChannels * ( fNBins + 2 ), 0. );
+    fEntries.assign( fNChannels, 0. );
+}
+
+/*
+ * create ROOT profile for one channel
+ *
+ * (profile is owned by the current directory)
+ */
+TProfile* VCalibrationProfile::getProfile( unsigned int iChannel, string iName, string iTitle, string iErrorOption )
+{
+    if( iChannel >= fNChannels )
+    {
+        return 0;
+    }
+    TProfile* h = 0;
+    if( fYmin < fYmax )
+    {
+        h = new TProfile( iName.c_str(), iTitle.c_str(), fNBins, fXmin, fXmax, fYmin, fYmax, iErrorOption.c_str() );
+    }
+    else
+    {
+        h = new TProfile( iName.c_str(), iTitle.c_str(), fNBins, fXmin, fXmax, iErrorOption.c_str() );
+    }
+    unsigned int iOffset = iChannel * ( fNBins + 2 );
+    for( unsigned int i = 0; i < fNBins + 2; i++ )
+    {
+        // TProfile stores sum of y and sum of y^2 per bin
+        h->SetBinEntries( i, fBinEntries[iOffset + i] );
+        h->SetBinContent( i, fSumY[iOffset + i] );
+        h->GetSumw2()->SetAt( fSumY2[iOffset + i], i );
+    }
+    h->SetEntries( fEntries[iChannel] );
+    return h;
+}
+
+VCalibrationAccumulator::VCalibrationAccumulator()
+{
+    fNChannels = 0;
+    fNSamples = 0;
+    fPulseShape = false;
+}
+
+/*
+ * initialize all distributions
+ *
+ * (binning as for the histograms used in earlier versions)
+ */
+void VCalibrationAccumulator::init( unsigned int iNChannels, unsigned int iNSamples, bool iPulseShape )
+{
+    fNChannels = iNChannels;
+    fNSamples = iNSamples;
+    fPulseShape = iPulseShape;
+    
+    fGain.init( fNChannels, 150, 0., 5. );
+    fTOff.init( fNChannels, 150, -10., 10. );
+    fTOff_vs_Sum.init( fNChannels, 20, 5., 405. );
+    // pulse shapes only when requested
+    if( fPulseShape )
+    {
+        fPulse.init( fNChannels, fNSamples, 0., ( double )fNSamples, -100., 10000. );
+        fTCPulse.init( fNChannels, 100, 0., ( double )fNSamples );
+    }
+    else
+    {
+        fPulse.init( 0, 0, 0., 0. );
+        fTCPulse.init( 0, 0, 0., 0. );
+    }
+    fNPulseEvents.assign( fNChannels, 0. );
+}
+
+/*
+ * per-event kernel: fill gain and time offset statistics
+ * for all channels flagged in iUse
+ *
+ * gain = sum / mean sum; toff = tzero - mean tzero
+ * (sums and tzeros are rounded to float as for the earlier TH1F fills)
+ */
+void VCalibrationAccumulator::fill( const valarray< double >& iSums, const valarray< double >& iTZeros, const vector< unsigned char >& iUse,
+                                    double iMeanSum, double iMeanTZero )
+{
+    unsigned int n = fNChannels;
+    if( iSums.size() < n )
+    {
+        n = iSums.size();
+    }
+    if( iTZeros.size() < n )
+    {
+        n = iTZeros.size();
+    }
+    if( iUse.size() < n )
+    {
+        n = iUse.size();
+    }
+    for( unsigned int i = 0; i < n; i++ )
+    {
+        if( !iUse[i] )
+        {
+            continue;
+        }
+        fGain.fill( i, ( float )iSums[i] / iMeanSum );
+        if( iTZeros[i] >= 0. )
+        {
+            double iTOff = ( float )iTZeros[i] - iMeanTZero;
+            fTOff.fill( i, iTOff );
+            fTOff_vs_Sum.fill( i, ( float )iSums[i], iTOff );
+        }
+    }
+}
+
+/*
+ * calculate mean, RMS and median for all channels
+ *
+ * iNThreads = 0: use all available cores
+ */
+void VCalibrationAccumulator::terminate( unsigned int iNThreads )
+{
+    if( fPulseShape )
+    {
+        for( unsigned int i = 0; i < fNChannels; i++ )
+        {
+            fPulse.setEntries( i, fNPulseEvents[i] );
+            fTCPulse.setEntries( i, fNPulseEvents[i] );
+        }
+    }
+    
+    if( iNThreads == 0 )
+    {
+        iNThreads = thread::hardware_concurrency();
+    }
+    if( iNThreads > fNChannels )
+    {
+        iNThreads = fNChannels;
+    }
+    if( iNThreads <= 1 )
+    {
+        for( unsigned int i = 0; i < fNChannels; i++ )
+        {
+            fGain.calculate( i );
+            fTOff.calculate( i );
+        }
+        return;
+    }
+    
+    // channels are independent: no locking needed
+    atomic< unsigned int > iCounter( 0 );
+    vector< thread > i_threads;
+    for( unsigned int t = 0; t < iNThreads; t++ )
+    {
+        i_threads.push_back( thread( [&]()
+        {
+            unsigned int i = 0;
+            while( ( i = iCounter++ ) < fNChannels )
+            {
+                fGain.calculate( i );
+                fTOff.calculate( i );
+            }
+        } ) );
+    }
+    for( unsigned int t = 0; t < i_threads.size(); t++ )
+    {
+        i_threads[t].join();
+    }
+}
@@ -999,8 +999,8 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
         cout << "VCalibrator::calculateGainsAndTOffsets()" << endl;
     }
     ////////////////////////////////////////////////
-    // initialize output files and histograms
-    if( fReader->getMaxChannels() > 0 && hgain.size() == 0 )
+    // initialize output files and accumulators
+    if( fReader->getMaxChannels() > 0 && !fGainTOffAccumulator.isInitialized() )
     {
         findDeadChans( iLowGain );
         
@@ -1022,27 +1022,10 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
         cout << "calculate gains and toffsets with summation window " << fRunPar->fCalibrationSumWindow;
         cout << " (start at " << fRunPar->fCalibrationSumFirst << ")" << endl;
         
-        // create histograms
-        for( unsigned int i = 0; i < getNChannels(); i++ )
-        {
-            char gainkey[100];
-            char ic[100];
-            sprintf( gainkey, "hgain_%d", i );
-            double imin = 0.0;
-            double imax = 5.0;
-            sprintf( ic, "gain distribution (tel %d, channel %d)", getTelID() + 1, i );
-            hgain.push_back( new TH1F( gainkey, ic, 150, imin, imax ) );
-            
-            char pulsekey[100];
-            sprintf( pulsekey, "hpulse_%d", i );
-            imin = 0;
-            imax = getNSamples();
-            hpulse.push_back( new TProfile( pulsekey, "Mean pulse", ( int )( imax - imin ), imin, imax, -100., 10000. ) );
-            
-            char spekey[100];
-            sprintf( spekey, "htcpulse_%d", i );
-            htcpulse.push_back( new TProfile( spekey, "time corrected mean pulse", 100, imin, imax ) );
-        }
+        // per-channel statistics (gains, toffsets, mean pulses)
+        fGainTOffAccumulator.init( getNChannels(), getNSamples(), getRunParameter()->fwriteAverageLaserPulse );
+        fGainTOffUse.assign( getNChannels(), 0 );
+        
         if( !iLowGain )
         {
             opftoff = new TFile( ( fToffFileNameC[getTelID()] + ".root" ).c_str(), "RECREATE" );
@@ -1056,22 +1039,6 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
             cout << "calculateGainsAndTOffsets() error, can't open output file: " << opftoff->GetName() << endl;
             exit( EXIT_FAILURE );
         }
-        for( unsigned int i = 0; i < getNChannels(); i++ )
-        {
-            char toff_vs_sumkey[100];
-            char ic[100];
-            sprintf( toff_vs_sumkey, "htoff_vs_sum_%d", i );
-            double imin = 5;
-            double imax = 405;
-            htoff_vs_sum.push_back( new TProfile( toff_vs_sumkey, "TOff vs Sum", 20, imin, imax ) );
-            
-            char toffkey[100];
-            sprintf( toffkey, "htoff_%d", i );
-            imin = -10;
-            imax = 10;
-            sprintf( ic, "TOffset distribution (tel %d, channel %d)", getTelID() + 1, i );
-            htoff.push_back( new TH1F( toffkey, ic, 150, imin, imax ) );
-        }
         
         if( getRunParameter()->fWriteExtraCalibTree )
         {
@@ -1242,8 +1209,10 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
         
         
         // subtract pedestals
-        // set number of entries in hpulse to number of pulses added up
+        // (number of entries in mean pulses is the number of pulses added up)
         double tcorr = 0.;
+        unsigned int i_nsamples = getNSamples();
+        fGainTOffUse.assign( getNChannels(), 0 );
         for( unsigned int i = 0; i < getNChannels(); i++ )
         {
             if( getRunParameter()->fWriteExtraCalibTree )
@@ -1260,13 +1229,13 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
             }
             
             
-            int i_entries = ( int )hpulse[i]->GetEntries();
+            bool i_pulseFilled = false;
             if( getRunParameter()->fwriteLaserPulseN > 0 )
             {
                 i_pulseDir->cd();
                 sprintf( i_name, "h_%d", i );
                 sprintf( i_title, "event %d, channel %d", getEventNumber(), i );
-                i_pulse = new TH1D( i_name, i_title, hpulse[i]->GetNbinsX(), hpulse[i]->GetXaxis()->GetXmin(), hpulse[i]->GetXaxis()->GetXmax() );
+                i_pulse = new TH1D( i_name, i_title, i_nsamples, 0., ( double )i_nsamples );
             }
             
             if( m_sums > 0.1 || fRunPar->fLaserSumMin < 0. )
@@ -1284,18 +1253,17 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
                             chanID = fReader->getHitID( k );
                             if( chanID == i )
                             {
-                                for( unsigned int j = 0; j < ( unsigned int )hpulse[i]->GetNbinsX(); j++ )
+                                for( unsigned int j = 0; j < i_nsamples; j++ )
                                 {
                                     this_bin = ( int )( j + fCalData[getTeltoAnaID()]->fFADCStopOffsets[i] + 1 );
-                                    if( this_bin > 0 && this_bin <= hpulse[i]->GetNbinsX() )
+                                    if( this_bin > 0 && this_bin <= ( int )i_nsamples )
                                     {
                                         this_content = fReader->getSample_double( chanID, this_bin, ( this_bin == 0 ) ) - getPeds( iLowGain )[i];
                                         if( getRunParameter()->fwriteLaserPulseN > 0 )
                                         {
                                             i_pulse->SetBinContent( this_bin, this_content );
                                         }
-                                        hpulse[i]->Fill( this_bin, this_content );
-                                        // time corrected pulse
+                                        // mean pulse and time corrected pulse
                                         if( getTZeros()[i] > -99. )
                                         {
                                             tcorr = getTZeros()[i] - m_tzero;
@@ -1304,7 +1272,8 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
                                         {
                                             tcorr = 0.;
                                         }
-                                        htcpulse[i]->Fill( ( double )this_bin - tcorr, this_content );
+                                        fGainTOffAccumulator.fillPulse( i, ( double )this_bin, this_content, tcorr );
+                                        i_pulseFilled = true;
                                     }
                                 }
                             }
@@ -1325,21 +1294,14 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
                     continue;
                 }
                 /////////////////////////////////////////////
-                // fill gain and toffset histograms
+                // select channels for gain and toffset calculation
                 if( ( getSums()[i] > fRunPar->fCalibrationIntSumMin || fRunPar->fLaserSumMin < 0. ) && !getDead()[i] && !getMasked()[i] )
                 {
                     if( getRunParameter()->fWriteExtraCalibTree )
                     {
                         fExtra_use->at( i ) = 1;
                     }
-                    
-                    hgain[i]->Fill( ( float )getSums()[i] / m_sums );
-                    if( getTZeros()[i] >= 0. )
-                    {
-                    
-                        htoff[i]->Fill( ( float )getTZeros()[i] - m_tzero );
-                        htoff_vs_sum[i]->Fill( ( float )getSums()[i], ( float )getTZeros()[i] - m_tzero );
-                    }
+                    fGainTOffUse[i] = 1;
                 }
                 
                 if( getRunParameter()->fwriteLaserPulseN > 0 )
@@ -1347,15 +1309,13 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
                     i_pulse->Write();
                 }
             }
-            if( i_entries != hpulse[i]->GetEntries() )
-            {
-                hpulse[i]->SetEntries( i_entries + 1 );
-            }
-            if( i_entries != htcpulse[i]->GetEntries() )
+            if( i_pulseFilled )
             {
-                htcpulse[i]->SetEntries( i_entries + 1 );
+                fGainTOffAccumulator.countPulseEvent( i );
             }
         }
+        // fill gain and toffset statistics for all selected channels
+        fGainTOffAccumulator.fill( getSums(), getTZeros(), fGainTOffUse, m_sums, m_tzero );
         if( getRunParameter()->fwriteLaserPulseN > 0 )
         {
             getRunParameter()->fwriteLaserPulseN--;
@@ -1407,23 +1367,55 @@ void VCalibrator::writeGains( bool iLowGain )
         {
             for( unsigned int i = 0; i < getNChannels(); i++ )
             {
-                os   << i << " " << hgain[i]->GetMean() << " " << hgain[i]->GetRMS() << endl;
+                if( i < fGainTOffAccumulator.getNChannels() )
+                {
+                    os   << i << " " << fGainTOffAccumulator.fGain.fMean[i] << " " << fGainTOffAccumulator.fGain.fRMS[i] << endl;
+                }
+                else
+                {
+                    os   << i << " 0 0" << endl;
+                }
             }
         }
         os.close();
         
         opfgain->cd();
-        for( unsigned int i = 0; i < hgain.size(); i++ )
+        char hname[100];
+        char htitle[100];
+        // per-channel histograms (on request only)
+        if( getRunParameter()->fWriteCalibrationHistograms )
         {
-            hgain[i]->Write();
+            for( unsigned int i = 0; i < fGainTOffAccumulator.getNChannels(); i++ )
+            {
+                sprintf( hname, "hgain_%d", i );
+                sprintf( htitle, "gain distribution (tel %d, channel %d)", t + 1, i );
+                TH1F* h = fGainTOffAccumulator.fGain.getHistogram( i, hname, htitle );
+                if( h )
+                {
+                    h->Write();
+                    delete h;
+                }
+            }
         }
         
-        if( getRunParameter()->fwriteAverageLaserPulse )
+        if( getRunParameter()->fwriteAverageLaserPulse && fGainTOffAccumulator.hasPulseShape() )
         {
-            for( unsigned int i = 0; i < hpulse.size(); i++ )
+            for( unsigned int i = 0; i < fGainTOffAccumulator.getNChannels(); i++ )
             {
-                hpulse[i]->Write();
-                htcpulse[i]->Write();
+                sprintf( hname, "hpulse_%d", i );
+                TProfile* h = fGainTOffAccumulator.fPulse.getProfile( i, hname, "Mean pulse" );
+                if( h )
+                {
+                    h->Write();
+                    delete h;
+                }
+                sprintf( hname, "htcpulse_%d", i );
+                h = fGainTOffAccumulator.fTCPulse.getProfile( i, hname, "time corrected mean pulse" );
+                if( h )
+                {
+                    h->Write();
+                    delete h;
+                }
             }
         }
         if( getRunParameter()->fWriteExtraCalibTree )
@@ -1431,7 +1423,8 @@ void VCalibrator::writeGains( bool iLowGain )
             tExtra_ChargeTree->Write();
         }
         
-        TTree* iTG = fillCalibrationSummaryTree( t, "gain", hgain );
+        TTree* iTG = fillCalibrationSummaryTree( t, "gain", fGainTOffAccumulator.fGain.fMean,
+                     fGainTOffAccumulator.fGain.fMedian, fGainTOffAccumulator.fGain.fRMS );
         if( iTG )
         {
             iTG->Write();
@@ -1449,6 +1442,32 @@ TTree* VCalibrator::fillCalibrationSummaryTree( unsigned int itel, string iName,
 {
     setTelID( itel );
     
+    vector< float > i_mean( getNChannels(), 0. );
+    vector< float > i_median( getNChannels(), 0. );
+    vector< float > i_rms( getNChannels(), 0. );
+    double i_a[] = { 0.5 };
+    double i_b[] = { 0.0 };
+    for( unsigned int i = 0; i < getNChannels(); i++ )
+    {
+        if( i < h.size() && h[i] && h[i]->GetEntries() > 0 )
+        {
+            i_mean[i] = h[i]->GetMean();
+            i_rms[i]  = h[i]->GetRMS();
+            h[i]->GetQuantiles( 1, i_b, i_a );
+            i_median[i] = i_b[0];
+        }
+    }
+    return fillCalibrationSummaryTree( itel, iName, i_mean, i_median, i_rms );
+}
+
+/*
+ * calibration tree from per-channel mean, median and rms values
+ */
+TTree* VCalibrator::fillCalibrationSummaryTree( unsigned int itel, string iName,
+        vector< float >& iMean, vector< float >& iMedian, vector< float >& iRMS )
+{
+    setTelID( itel );
+    
     char iname[200];
     char ititle[200];
     
@@ -1471,17 +1490,14 @@ TTree* VCalibrator::fillCalibrationSummaryTree( unsigned int itel, string iName,
     sprintf( ititle, "%svar/F", iName.c_str() );
     t->Branch( iname, &i_rms, ititle );
     
-    double i_a[] = { 0.5 };
-    double i_b[] = { 0.0 };
     for( unsigned int i = 0; i < getNChannels(); i++ )
     {
         ichannel = ( int )i;
-        if( i < h.size() && h[i] && h[i]->GetEntries() > 0 )
+        if( i < iMean.size() && i < iMedian.size() && i < iRMS.size() )
         {
-            i_mean = h[i]->GetMean();
-            i_rms  = h[i]->GetRMS();
-            h[i]->GetQuantiles( 1, i_b, i_a );
-            i_median = i_b[0];
+            i_mean = iMean[i];
+            i_rms  = iRMS[i];
+            i_median = iMedian[i];
         }
         else
         {
@@ -1527,21 +1543,44 @@ void VCalibrator::writeTOffsets( bool iLowGain )
         }
         else for( unsigned int i = 0; i < getNChannels(); i++ )
             {
-                os << i << " " << htoff[i]->GetMean() << " " << htoff[i]->GetRMS() << endl;
+                if( i < fGainTOffAccumulator.getNChannels() )
+                {
+                    os << i << " " << fGainTOffAccumulator.fTOff.fMean[i] << " " << fGainTOffAccumulator.fTOff.fRMS[i] << endl;
+                }
+                else
+                {
+                    os << i << " 0 0" << endl;
+                }
             }
         os.close();
         
         opftoff->cd();
-        for( unsigned int i = 0; i < htoff.size(); i++ )
+        // per-channel histograms (on request only)
+        if( getRunParameter()->fWriteCalibrationHistograms )
         {
-            htoff[i]->Write();
-        }
-        for( unsigned int i = 0; i < htoff_vs_sum.size(); i++ )
-        {
-            htoff_vs_sum[i]->SetErrorOption( "S" );
-            htoff_vs_sum[i]->Write();
+            char hname[100];
+            char htitle[100];
+            for( unsigned int i = 0; i < fGainTOffAccumulator.getNChannels(); i++ )
+            {
+                sprintf( hname, "htoff_%d", i );
+                sprintf( htitle, "TOffset distribution (tel %d, channel %d)", t + 1, i );
+                TH1F* h = fGainTOffAccumulator.fTOff.getHistogram( i, hname, htitle );
+                if( h )
+                {
+                    h->Write();
+                    delete h;
+                }
+                sprintf( hname, "htoff_vs_sum_%d", i );
+                TProfile* p = fGainTOffAccumulator.fTOff_vs_Sum.getProfile( i, hname, "TOff vs Sum", "S" );
+                if( p )
+                {
+                    p->Write();
+                    delete p;
+                }
+            }
         }
-        TTree* iTT = fillCalibrationSummaryTree( t, "toff", htoff );
+        TTree* iTT = fillCalibrationSummaryTree( t, "toff", fGainTOffAccumulator.fTOff.fMean,
+                     fGainTOffAccumulator.fTOff.fMedian, fGainTOffAccumulator.fTOff.fRMS );
         if( iTT )
         {
             iTT->Write();
@@ -1559,6 +1598,7 @@ void VCalibrator::terminate( VPedestalCalculator* iP )
     }
     else if( fRunPar->frunmode == 2 || fRunPar->frunmode == 5 )
     {
+        fGainTOffAccumulator.terminate( fRunPar->fCalibrationNThreads );
         writeGains( fRunPar->frunmode == 5 );
         writeTOffsets( fRunPar->frunmode == 5 );
     }
@@ -3020,8 +3060,38 @@ void VCalibrator::initialize()
     // for calibration settings
     getCalibrationRunNumbers();
     
+    ////////////////////////////////////////////////////////////////
+    // calibration data are reused for runs with identical calibration input
+    // (evndisp queue mode); this includes the IPR graphs for NN cleaning
+    fCalData.clear();
+    fNumberGainEvents.assign( getNTel(), 0 );
+    fNumberTZeroEvents.assign( getNTel(), 0 );
+    string iCalDataKey = getCalibrationDataKey();
+    if( iCalDataKey.size() > 0 && fCalDataCache.find( iCalDataKey ) != fCalDataCache.end() )
+    {
+        cout << "reusing calibration data (pedestals, gains, time offsets, IPR graphs)" << endl;
+        fCalData = fCalDataCache[iCalDataKey];
+        for( unsigned int i = 0; i < fCalData.size(); i++ )
+        {
+            fCalData[i]->setReader( fReader );
+        }
+        for( unsigned int i = 0; i < getTeltoAna().size(); i++ )
+        {
+            setTelID( getTeltoAna()[i] );
+            if( getRunParameter()->fLowGainCalibrationFile.size() > 0 )
+            {
+                getDetectorGeometry()->setLowGainMultiplier_Trace( getTelID(), getCalData()->getLowGainMultiplier_Trace() );
+            }
+        }
+        initializeDeadChannelFinder();
+        return;
+    }
+    
     ////////////////////////////////////////////////////////////////
     // create the calibration data structures
+    // (summary histograms are not owned by the output file of this run)
+    bool iTH1AddDirectory = TH1::AddDirectoryStatus();
+    TH1::AddDirectory( kFALSE );
     for( unsigned int i = 0; i < getNTel(); i++ )
     {
         setTelID( i );
@@ -3031,8 +3101,6 @@ void VCalibrator::initialize()
                             "", "", "", fTZeroFileNameC[i], fLowGainTZeroFileNameC[i],
                             getRunParameter()->getObservatory() ) );
         fCalData.back()->setSumWindows( getSumWindow( i ) );
-        fNumberGainEvents.push_back( 0 );
-        fNumberTZeroEvents.push_back( 0 );
         
         fCalData.back()->initialize( getNChannels(), getNSamples(), usePedestalsInTimeSlices( false ), usePedestalsInTimeSlices( true ),
                                      ( fReader->getDataFormat() == "grisu"
@@ -3043,6 +3111,7 @@ void VCalibrator::initialize()
                                      getDebugFlag(), getRunParameter()->frunmode, isTeltoAna( i ) );
         fCalData.back()->setReader( fReader );
     }
+    TH1::AddDirectory( iTH1AddDirectory );
     
     //////////////////////////////////////////////////////////////////////////
     // define histograms and output files for pedestal calculation
@@ -3155,6 +3224,81 @@ void VCalibrator::initialize()
             calculateIPRGraphs();
         }
     }
+    if( iCalDataKey.size() > 0 )
+    {
+        fCalDataCache[iCalDataKey] = fCalData;
+    }
+}
+
+/*
+ * key describing all input to the calibration data of the current run
+ *
+ * (file names of pedestal, gain, toffset, etc files; calibration tree and IPR graphs
+ *  for DST files)
+ *
+ * returns an empty string if the calibration data of this run cannot be reused
+ */
+string VCalibrator::getCalibrationDataKey()
+{
+    // calibration data depends on the run itself:
+    // - calibration runs and pedestals read from grisu source files
+    // - pedestals smoothed over dead channels during the analysis
+    // - IPR graphs calculated for the IPR database
+    if( fRunPar->frunmode != 0
+            || fReader->getDataFormat() == "grisu"
+            || fRunPar->fSmoothDead
+            || fRunPar->ifCreateIPRdatabase )
+    {
+        return "";
+    }
+    ostringstream iKey;
+    iKey << fRunPar->fsourcetype << "|" << fRunPar->fIsMC << "|" << fRunPar->freadCalibfromDB;
+    iKey << "|" << fRunPar->fsimu_pedestalfile << "|" << fRunPar->fsimu_pedestalfile_DefaultPed;
+    iKey << "|" << fRunPar->fsimu_lowgain_pedestal_DefaultPed;
+    // FADC channel mapping from DB and low gain calibration values are run dependent
+    if( fRunPar->fuseDB || fRunPar->fLowGainCalibrationFile.size() > 0 )
+    {
+        iKey << "|run" << getRunNumber();
+    }
+    for( unsigned int i = 0; i < getNTel(); i++ )
+    {
+        setTelID( i );
+        iKey << "|T" << i << "|" << isTeltoAna( i ) << "|" << getNChannels() << "|" << getNSamples();
+        iKey << "|" << getSumWindow() << "|" << getSumWindow_2();
+        iKey << "|" << fPedFileNameC[i] << "|" << fGainFileNameC[i] << "|" << fToffFileNameC[i];
+        iKey << "|" << fPixFileNameC[i] << "|" << fTZeroFileNameC[i];
+        iKey << "|" << fNewLowGainPedFileNameC[i] << "|" << fLowGainPedFileNameC[i];
+        iKey << "|" << fLowGainGainFileNameC[i] << "|" << fLowGainToffFileNameC[i];
+        iKey << "|" << fLowGainMultiplierNameC[i] << "|" << fLowGainTZeroFileNameC[i];
+    }
+    // DST files: calibration data and IPR graphs are read from the DST file
+    if( fRunPar->fsourcetype == 4 || fRunPar->fsourcetype == 7 )
+    {
+        // IPR graphs are calculated from the DST file
+        if( fRunPar->ifReadIPRfromDatabase )
+        {
+            return "";
+        }
+        TFile iF( fRunPar->fsourcefile.c_str() );
+        if( iF.IsZombie() )
+        {
+            return "";
+        }
+        iKey << "|" << VUtilities::getTreeMD5( ( TTree* )iF.Get( "calibration" ) );
+        if( fRunPar->ifReadIPRfromDSTFile )
+        {
+            for( unsigned int i = 0; i < getNTel(); i++ )
+            {
+                setTelID( i );
+                ostringstream iSname;
+                iSname << "IPRcharge_TelType" << getTelType( i ) << "_SW" << getSumWindow();
+                iKey << "|" << VUtilities::getGraphMD5( ( TGraph* )iF.Get( iSname.str().c_str() ) );
+            }
+        }
+        iF.Close();
+    }
+    
+    return iKey.str();
 }
 
 void VCalibrator::setCalibrationFileNames()
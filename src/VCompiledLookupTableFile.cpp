@@ -0,0 +1,441 @@
+/*! \class VCompiledLookupTableFile
+    \brief binary, memory-mapped representation of a lookup table file
+    
+    Lookup table files are compiled once (see compileLookupTables) into
+    a single binary file with a directory index and contiguous grids
+    of bin contents and bin errors for each 2D table.
+    
+    The compiled file is memory-mapped read-only: the tables are not
+    copied into the process memory and concurrent mscw_energy jobs
+    on the same node share the pages through the OS file cache.
+    
+    File layout:
+    
+    - header (sCompiledLookupTableHeader)
+    - data section: per table (nbinsX+2)*(nbinsY+2) bin contents followed by
+      the same number of bin errors (double precision, ROOT bin ordering)
+    - index section: one sCompiledLookupTableIndex per table
+    
+    All blocks are aligned to 64 bytes.
+
+*/
+
+#include "VCompiledLookupTableFile.h"
+
+static const char fCompiledLookupTableMagic[8] = { 'V', 'L', 'U', 'T', 'C', 'M', 'P', '1' };
+static const uint32_t fCompiledLookupTableVersion = 1;
+static const uint32_t fCompiledLookupTableByteOrder = 0x01020304;
+static const unsigned int fCompiledLookupTableAlignment = 64;
+
+VCompiledLookupTable::VCompiledLookupTable()
+{
+    fNbinsX = 0;
+    fNbinsY = 0;
+    fXmin = 0.;
+    fXmax = 0.;
+    fYmin = 0.;
+    fYmax = 0.;
+    fContent = 0;
+    fError = 0;
+}
+
+/*
+ * same as TAxis::FindFixBin (fixed bin sizes only)
+ */
+int VCompiledLookupTable::findBinX( double x ) const
+{
+    if( x < fXmin )
+    {
+        return 0;
+    }
+    if( !( x < fXmax ) )
+    {
+        return fNbinsX + 1;
+    }
+    return 1 + int( fNbinsX * ( x - fXmin ) / ( fXmax - fXmin ) );
+}
+
+int VCompiledLookupTable::findBinY( double y ) const
+{
+    if( y < fYmin )
+    {
+        return 0;
+    }
+    if( !( y < fYmax ) )
+    {
+        return fNbinsY + 1;
+    }
+    return 1 + int( fNbinsY * ( y - fYmin ) / ( fYmax - fYmin ) );
+}
+
+/*
+ * global bin number (as TH1::GetBin: out-of-range bins are
+ * mapped onto the under- and overflow bins)
+ */
+int VCompiledLookupTable::getBin( int ix, int iy ) const
+{
+    if( ix < 0 )
+    {
+        ix = 0;
+    }
+    if( ix > fNbinsX + 1 )
+    {
+        ix = fNbinsX + 1;
+    }
+    if( iy < 0 )
+    {
+        iy = 0;
+    }
+    if( iy > fNbinsY + 1 )
+    {
+        iy = fNbinsY + 1;
+    }
+    return ix + ( fNbinsX + 2 ) * iy;
+}
+
+VCompiledLookupTableFile::VCompiledLookupTableFile()
+{
+    fDebug = false;
+    fFileDescriptor = -1;
+    fMappedData = 0;
+    fMappedSize = 0;
+}
+
+VCompiledLookupTableFile::~VCompiledLookupTableFile()
+{
+    close();
+}
+
+void VCompiledLookupTableFile::close()
+{
+    fTables.clear();
+    fDirectories.clear();
+    if( fMappedData )
+    {
+        munmap( fMappedData, fMappedSize );
+        fMappedData = 0;
+        fMappedSize = 0;
+    }
+    if( fFileDescriptor >= 0 )
+    {
+        ::close( fFileDescriptor );
+        fFileDescriptor = -1;
+    }
+    fFileName = "";
+}
+
+/*
+ * check magic number at the beginning of the file
+ */
+bool VCompiledLookupTableFile::isCompiledLookupTableFile( string iFile )
+{
+    ifstream is( iFile.c_str(), ios::in | ios::binary );
+    if( !is )
+    {
+        return false;
+    }
+    char iMagic[8];
+    is.read( iMagic, sizeof( iMagic ) );
+    if( !is )
+    {
+        return false;
+    }
+    return ( memcmp( iMagic, fCompiledLookupTableMagic, sizeof( iMagic ) ) == 0 );
+}
+
+/*
+ * memory-map a compiled lookup table file and read the directory index
+ */
+bool VCompiledLookupTableFile::open( string iFile )
+{
+    close();
+    
+    fFileDescriptor = ::open( iFile.c_str(), O_RDONLY );
+    if( fFileDescriptor < 0 )
+    {
+        cout << "VCompiledLookupTableFile::open error: unable to open file " << iFile << endl;
+        return false;
+    }
+    struct stat iStat;
+    if( fstat( fFileDescriptor, &iStat ) != 0 || ( size_t )iStat.st_size < sizeof( sCompiledLookupTableHeader ) )
+    {
+        cout << "VCompiledLookupTableFile::open error: invalid file size for " << iFile << endl;
+        close();
+        return false;
+    }
+    fMappedSize = ( size_t )iStat.st_size;
+    fMappedData = mmap( 0, fMappedSize, PROT_READ, MAP_SHARED, fFileDescriptor, 0 );
+    if( fMappedData == MAP_FAILED )
+    {
+        cout << "VCompiledLookupTableFile::open error: unable to memory-map file " << iFile << endl;
+        fMappedData = 0;
+        close();
+        return false;
+    }
+    
+    const char* iData = ( const char* )fMappedData;
+    const sCompiledLookupTableHeader* iHeader = ( const sCompiledLookupTableHeader* )iData;
+    if( memcmp( iHeader->fMagic, fCompiledLookupTableMagic, sizeof( iHeader->fMagic ) ) != 0
+            || iHeader->fVersion != fCompiledLookupTableVersion
+            || iHeader->fByteOrder != fCompiledLookupTableByteOrder )
+    {
+        cout << "VCompiledLookupTableFile::open error: " << iFile;
+        cout << " is not a compiled lookup table file (or of incompatible version / byte order)" << endl;
+        close();
+        return false;
+    }
+    if( iHeader->fFileSize != fMappedSize
+            || iHeader->fIndexOffset + iHeader->fNTables * sizeof( sCompiledLookupTableIndex ) > fMappedSize )
+    {
+        cout << "VCompiledLookupTableFile::open error: truncated file " << iFile << endl;
+        close();
+        return false;
+    }
+    
+    const sCompiledLookupTableIndex* iIndex = ( const sCompiledLookupTableIndex* )( iData + iHeader->fIndexOffset );
+    for( uint64_t i = 0; i < iHeader->fNTables; i++ )
+    {
+        if( iIndex[i].fNBins != ( uint64_t )( iIndex[i].fNbinsX + 2 ) * ( uint64_t )( iIndex[i].fNbinsY + 2 )
+                || iIndex[i].fOffset + 2 * iIndex[i].fNBins * sizeof( double ) > iHeader->fIndexOffset )
+        {
+            cout << "VCompiledLookupTableFile::open error: inconsistent index entry " << i << " in " << iFile << endl;
+            close();
+            return false;
+        }
+        string iName( iIndex[i].fName, strnlen( iIndex[i].fName, sizeof( iIndex[i].fName ) ) );
+        
+        VCompiledLookupTable iTable;
+        iTable.fName = iName;
+        iTable.fNbinsX = iIndex[i].fNbinsX;
+        iTable.fNbinsY = iIndex[i].fNbinsY;
+        iTable.fXmin = iIndex[i].fXmin;
+        iTable.fXmax = iIndex[i].fXmax;
+        iTable.fYmin = iIndex[i].fYmin;
+        iTable.fYmax = iIndex[i].fYmax;
+        iTable.fContent = ( const double* )( iData + iIndex[i].fOffset );
+        iTable.fError = iTable.fContent + iIndex[i].fNBins;
+        fTables[iName] = iTable;
+        
+        // register all parent directories
+        size_t iPos = iName.find( "/" );
+        while( iPos != string::npos )
+        {
+            fDirectories.insert( iName.substr( 0, iPos ) );
+            iPos = iName.find( "/", iPos + 1 );
+        }
+    }
+    fFileName = iFile;
+    
+    if( fDebug )
+    {
+        cout << "VCompiledLookupTableFile: mapped " << fTables.size() << " tables (";
+        cout << fMappedSize / 1024 / 1024 << " MB) from " << fFileName << endl;
+    }
+    
+    return true;
+}
+
+const VCompiledLookupTable* VCompiledLookupTableFile::getTable( string iName )
+{
+    map< string, VCompiledLookupTable >::iterator iTable = fTables.find( iName );
+    if( iTable != fTables.end() )
+    {
+        return &( iTable->second );
+    }
+    return 0;
+}
+
+/*
+ * return list of directories directly below the given path
+ *
+ * (empty path: top-level directories)
+ */
+vector< string > VCompiledLookupTableFile::getListOfDirectories( string iPath )
+{
+    vector< string > iDName;
+    string iPrefix = iPath;
+    if( iPrefix.size() > 0 )
+    {
+        iPrefix += "/";
+    }
+    set< string >::iterator iDir;
+    for( iDir = fDirectories.begin(); iDir != fDirectories.end(); ++iDir )
+    {
+        if( iDir->size() <= iPrefix.size() || iDir->compare( 0, iPrefix.size(), iPrefix ) != 0 )
+        {
+            continue;
+        }
+        string iSubDir = iDir->substr( iPrefix.size() );
+        if( iSubDir.find( "/" ) == string::npos )
+        {
+            iDName.push_back( iSubDir );
+        }
+    }
+    return iDName;
+}
+
+/*
+ * compile a lookup table file (ROOT) into a binary table file
+ *
+ * all 2D histograms are copied (1D histograms in histos1D directories are ignored)
+ */
+bool VCompiledLookupTableFile::compile( string iInputFile, string iOutputFile )
+{
+    TFile iFile( iInputFile.c_str() );
+    if( iFile.IsZombie() )
+    {
+        cout << "VCompiledLookupTableFile::compile error: unable to open table file " << iInputFile << endl;
+        return false;
+    }
+    ofstream iOutFile( iOutputFile.c_str(), ios::out | ios::binary | ios::trunc );
+    if( !iOutFile )
+    {
+        cout << "VCompiledLookupTableFile::compile error: unable to open output file " << iOutputFile << endl;
+        return false;
+    }
+    
+    // header is written twice: now as placeholder, at the end with all offsets
+    sCompiledLookupTableHeader iHeader;
+    memset( &iHeader, 0, sizeof( iHeader ) );
+    iOutFile.write( ( const char* )&iHeader, sizeof( iHeader ) );
+    writePadding( iOutFile );
+    iHeader.fDataOffset = ( uint64_t )iOutFile.tellp();
+    
+    vector< sCompiledLookupTableIndex > iIndex;
+    if( !compileDirectory( &iFile, "", iOutFile, iIndex ) )
+    {
+        return false;
+    }
+    
+    // directory index
+    iHeader.fIndexOffset = ( uint64_t )iOutFile.tellp();
+    for( unsigned int i = 0; i < iIndex.size(); i++ )
+    {
+        iOutFile.write( ( const char* )&iIndex[i], sizeof( sCompiledLookupTableIndex ) );
+    }
+    iHeader.fFileSize = ( uint64_t )iOutFile.tellp();
+    
+    memcpy( iHeader.fMagic, fCompiledLookupTableMagic, sizeof( iHeader.fMagic ) );
+    iHeader.fVersion = fCompiledLookupTableVersion;
+    iHeader.fByteOrder = fCompiledLookupTableByteOrder;
+    iHeader.fNTables = iIndex.size();
+    iOutFile.seekp( 0 );
+    iOutFile.write( ( const char* )&iHeader, sizeof( iHeader ) );
+    iOutFile.close();
+    if( !iOutFile )
+    {
+        cout << "VCompiledLookupTableFile::compile error: writing to " << iOutputFile << " failed" << endl;
+        return false;
+    }
+    iFile.Close();
+    
+    cout << "compiled " << iIndex.size() << " tables from " << iInputFile;
+    cout << " into " << iOutputFile << " (" << iHeader.fFileSize / 1024 / 1024 << " MB)" << endl;
+    
+    return true;
+}
+
+bool VCompiledLookupTableFile::compileDirectory( TDirectory* iDir, string iPath, ofstream& iOutFile,
+        vector< sCompiledLookupTableIndex >& iIndex )
+{
+    if( !iDir )
+    {
+        return false;
+    }
+    // keys are listed for all cycles (highest cycle first)
+    set< string > iKeysRead;
+    TKey* key = 0;
+    TIter nextkey( iDir->GetListOfKeys() );
+    while( ( key = ( TKey* )nextkey() ) )
+    {
+        string iName = key->GetName();
+        if( iKeysRead.find( iName ) != iKeysRead.end() )
+        {
+            continue;
+        }
+        iKeysRead.insert( iName );
+        TClass* cl = gROOT->GetClass( key->GetClassName() );
+        if( !cl )
+        {
+            continue;
+        }
+        string iFullName = iName;
+        if( iPath.size() > 0 )
+        {
+            iFullName = iPath + "/" + iName;
+        }
+        if( cl->InheritsFrom( "TDirectory" ) )
+        {
+            // 1D histograms are not used for table reading
+            if( iName == "histos1D" )
+            {
+                continue;
+            }
+            if( !compileDirectory( iDir->GetDirectory( iName.c_str() ), iFullName, iOutFile, iIndex ) )
+            {
+                return false;
+            }
+        }
+        else if( cl->InheritsFrom( "TH2" ) )
+        {
+            TH2* h = ( TH2* )key->ReadObj();
+            if( !h )
+            {
+                continue;
+            }
+            if( h->GetXaxis()->IsVariableBinSize() || h->GetYaxis()->IsVariableBinSize() )
+            {
+                cout << "VCompiledLookupTableFile::compile warning: ignoring table with variable bin sizes: " << iFullName << endl;
+                delete h;
+                continue;
+            }
+            sCompiledLookupTableIndex iEntry;
+            memset( &iEntry, 0, sizeof( iEntry ) );
+            if( iFullName.size() >= sizeof( iEntry.fName ) )
+            {
+                cout << "VCompiledLookupTableFile::compile error: table name too long: " << iFullName << endl;
+                delete h;
+                return false;
+            }
+            strncpy( iEntry.fName, iFullName.c_str(), sizeof( iEntry.fName ) - 1 );
+            iEntry.fNbinsX = h->GetNbinsX();
+            iEntry.fNbinsY = h->GetNbinsY();
+            iEntry.fXmin = h->GetXaxis()->GetXmin();
+            iEntry.fXmax = h->GetXaxis()->GetXmax();
+            iEntry.fYmin = h->GetYaxis()->GetXmin();
+            iEntry.fYmax = h->GetYaxis()->GetXmax();
+            iEntry.fNBins = ( uint64_t )( iEntry.fNbinsX + 2 ) * ( uint64_t )( iEntry.fNbinsY + 2 );
+            iEntry.fOffset = ( uint64_t )iOutFile.tellp();
+            
+            vector< double > iContent( iEntry.fNBins, 0. );
+            vector< double > iError( iEntry.fNBins, 0. );
+            for( int j = 0; j <= iEntry.fNbinsY + 1; j++ )
+            {
+                for( int i = 0; i <= iEntry.fNbinsX + 1; i++ )
+                {
+                    iContent[i + ( iEntry.fNbinsX + 2 ) * j] = h->GetBinContent( i, j );
+                    iError[i + ( iEntry.fNbinsX + 2 ) * j]   = h->GetBinError( i, j );
+                }
+            }
+            iOutFile.write( ( const char* )&iContent[0], iEntry.fNBins * sizeof( double ) );
+            iOutFile.write( ( const char* )&iError[0], iEntry.fNBins * sizeof( double ) );
+            writePadding( iOutFile );
+            iIndex.push_back( iEntry );
+            delete h;
+        }
+    }
+    return true;
+}
+
+/*
+ * align next block to fCompiledLookupTableAlignment bytes
+ */
+void VCompiledLookupTableFile::writePadding( ofstream& iOutFile )
+{
+    unsigned int iRest = ( unsigned int )( ( uint64_t )iOutFile.tellp() % fCompiledLookupTableAlignment );
+    if( iRest > 0 )
+    {
+        vector< char > iPadding( fCompiledLookupTableAlignment - iRest, 0 );
+        iOutFile.write( &iPadding[0], iPadding.size() );
+    }
+}
@@ -4,12 +4,17 @@
  */
 
 #include "VDL2Writer.h"
+#ifdef RUNWITHRNTUPLE
+#include "VRNTupleWriter.h"
+#endif
 
 /*!
  *
  */
 VDL2Writer::VDL2Writer( string iConfigFile )
 {
+    fWriteRNTuple = 0;
+    fDL2RNTupleWriter = 0;
     readConfigFile( iConfigFile );
     
     // tree with cut results for each event
@@ -118,6 +123,17 @@ bool VDL2Writer::readConfigFile( string iConfigFile )
                 is_stream >> temp_f;
                 dist_max.push_back( temp_f );
             }
+            else if( temp == "WRITERNTUPLE" )
+            {
+                is_stream >> fWriteRNTuple;
+                // downstream tools read the data tree; it is therefore always written
+                if( fWriteRNTuple > 1 )
+                {
+                    cout << "RNTuple-only output is not supported by all downstream tools; ";
+                    cout << "writing data tree in addition to the RNTuple" << endl;
+                    fWriteRNTuple = 1;
+                }
+            }
             else if( temp == "SIMULATIONFILE_DATA" )
             {
                 if( !( is_stream >> std::ws ).eof() )
@@ -192,7 +208,7 @@ bool VDL2Writer::fill( CData* d )
     ///////////////////////////////////////////////////////
     // get full data set and loop over all entries
     ///////////////////////////////////////////////////////
-    Long64_t d_nentries = d->fChain->GetEntries();
+    Long64_t d_nentries = d->getEntries();
     cout << "\t number of data events in source tree: " << d_nentries << endl;
     
     unsigned int i_dist_bin = 0;
@@ -262,7 +278,45 @@ void VDL2Writer::fillEventDataTree( float iMVA )
     {
         fCut_MVA = iMVA;
         fDL2DataTree->Fill();
+#ifdef RUNWITHRNTUPLE
+        if( fDL2RNTupleWriter )
+        {
+            fDL2RNTupleWriter->fill();
+        }
+#endif
+    }
+}
+
+/*
+ * columnar copy of the DL2 event data (RNTuple 'data_rntuple')
+ */
+bool VDL2Writer::initializeRNTuple( TDirectory* iDir )
+{
+    if( fWriteRNTuple <= 0 )
+    {
+        return true;
+    }
+#ifdef RUNWITHRNTUPLE
+    fDL2RNTupleWriter = new VRNTupleWriter();
+    return fDL2RNTupleWriter->initialize( fDL2DataTree, iDir );
+#else
+    cout << "VDL2Writer::initializeRNTuple warning: RNTuple output requires compilation with RNTUPLE=TRUE; ignored" << endl;
+    fWriteRNTuple = 0;
+    return true;
+#endif
+}
+
+/*
+ * commit RNTuple to disk (before closing the output file)
+ */
+void VDL2Writer::closeRNTuple()
+{
+#ifdef RUNWITHRNTUPLE
+    if( fDL2RNTupleWriter )
+    {
+        fDL2RNTupleWriter->close();
     }
+#endif
 }
 
 bool VDL2Writer::initializeTMVAEvaluators( CData* d )
@@ -0,0 +1,390 @@
+/*! \class VDL3FITSWriter
+    \brief buffered writer for DL3 event lists in FITS format
+    
+    event lists follow the data formats for gamma-ray astronomy (GADF):
+    
+    - EVENTS table (one row per event)
+    - GTI table (good time intervals from the time mask)
+    
+    events are buffered column-wise and written in chunks of
+    fChunkSize rows
+    
+    times are given in seconds since MJDREF (UTC)
+
+*/
+
+#include "VDL3FITSWriter.h"
+
+VDL3FITSWriter::VDL3FITSWriter( unsigned int iChunkSize )
+{
+    fptr = 0;
+    fFileName = "";
+    fRunNumber = 0;
+    fChunkSize = iChunkSize;
+    if( fChunkSize < 1 )
+    {
+        fChunkSize = 1;
+    }
+    fNRowsWritten = 0;
+    
+    fObject = "";
+    fObservatory = "";
+    fRA_OBJ = 0.;
+    fDEC_OBJ = 0.;
+    fRA_PNT = 0.;
+    fDEC_PNT = 0.;
+    fGeoLon = 0.;
+    fGeoLat = 0.;
+    fAltitude = 0.;
+}
+
+VDL3FITSWriter::~VDL3FITSWriter()
+{
+    if( fptr )
+    {
+        int status = 0;
+        fits_close_file( fptr, &status );
+        fptr = 0;
+    }
+}
+
+/*
+ * print cfitsio error messages
+ */
+bool VDL3FITSWriter::printerror( int status )
+{
+    if( status )
+    {
+        cout << "VDL3FITSWriter error writing " << fFileName << endl;
+        fits_report_error( stderr, status );
+    }
+    return false;
+}
+
+void VDL3FITSWriter::setTarget( string iObject, double iRA_OBJ, double iDEC_OBJ, double iRA_PNT, double iDEC_PNT )
+{
+    fObject = iObject;
+    fRA_OBJ = iRA_OBJ;
+    fDEC_OBJ = iDEC_OBJ;
+    fRA_PNT = iRA_PNT;
+    fDEC_PNT = iDEC_PNT;
+}
+
+void VDL3FITSWriter::setObservatory( string iObservatory, double iLongitude_deg, double iLatitude_deg, double iAltitude_m )
+{
+    fObservatory = iObservatory;
+    fGeoLon = iLongitude_deg;
+    fGeoLat = iLatitude_deg;
+    fAltitude = iAltitude_m;
+}
+
+/*
+ * open FITS file and create (empty) EVENTS table
+ *
+ * (existing files are overwritten)
+ */
+bool VDL3FITSWriter::open( string iFileName, int iRunNumber )
+{
+    if( fptr )
+    {
+        cout << "VDL3FITSWriter::open error: file already open: " << fFileName << endl;
+        return false;
+    }
+    fFileName = iFileName;
+    fRunNumber = iRunNumber;
+    fNRowsWritten = 0;
+    clearBuffers();
+    
+    int status = 0;
+    string iName = "!" + fFileName;
+    if( fits_create_file( &fptr, iName.c_str(), &status ) )
+    {
+        fptr = 0;
+        return printerror( status );
+    }
+    if( fits_create_img( fptr, BYTE_IMG, 0, 0, &status ) )
+    {
+        return printerror( status );
+    }
+    
+    const int nCol = 16;
+    const char* ttype[nCol] = { "EVENT_ID", "TIME", "RA", "DEC", "ENERGY", "ALT", "AZ", "MULTIP", "DETX", "DETY",
+                                "COREX", "COREY", "HIL_MSW", "HIL_MSL", "EMISSION_HEIGHT", "ACCEPTANCE"
+                              };
+    const char* tform[nCol] = { "1K", "1D", "1E", "1E", "1E", "1E", "1E", "1I", "1E", "1E",
+                                "1E", "1E", "1E", "1E", "1E", "1E"
+                              };
+    const char* tunit[nCol] = { "", "s", "deg", "deg", "TeV", "deg", "deg", "", "deg", "deg",
+                                "m", "m", "", "", "km", ""
+                              };
+    if( fits_create_tbl( fptr, BINARY_TBL, 0, nCol, ( char** )ttype, ( char** )tform, ( char** )tunit, "EVENTS", &status ) )
+    {
+        return printerror( status );
+    }
+    return true;
+}
+
+void VDL3FITSWriter::clearBuffers()
+{
+    fEVENT_ID.clear();
+    fTIME.clear();
+    fRA.clear();
+    fDEC.clear();
+    fENERGY.clear();
+    fALT.clear();
+    fAZ.clear();
+    fMULTIP.clear();
+    fDETX.clear();
+    fDETY.clear();
+    fCOREX.clear();
+    fCOREY.clear();
+    fHIL_MSW.clear();
+    fHIL_MSL.clear();
+    fEMISSION_HEIGHT.clear();
+    fACCEPTANCE.clear();
+}
+
+/*
+ * add one event to the column buffers
+ *
+ * (buffers are written to disk when fChunkSize events are reached)
+ */
+void VDL3FITSWriter::fill( int iEventNumber, int iMJD, double iTime_s, double iRA_deg, double iDec_deg, double iEnergy_TeV,
+                           double iAlt_deg, double iAz_deg, int iNImages, double iXoff_deg, double iYoff_deg,
+                           double iXcore_m, double iYcore_m, double iMSCW, double iMSCL, double iEmissionHeight, double iAcceptance )
+{
+    if( !fptr )
+    {
+        return;
+    }
+    fEVENT_ID.push_back( ( LONGLONG )iEventNumber );
+    fTIME.push_back( getTime( iMJD, iTime_s ) );
+    fRA.push_back( ( float )iRA_deg );
+    fDEC.push_back( ( float )iDec_deg );
+    fENERGY.push_back( ( float )iEnergy_TeV );
+    fALT.push_back( ( float )iAlt_deg );
+    fAZ.push_back( ( float )iAz_deg );
+    fMULTIP.push_back( ( short )iNImages );
+    fDETX.push_back( ( float )iXoff_deg );
+    fDETY.push_back( ( float )iYoff_deg );
+    fCOREX.push_back( ( float )iXcore_m );
+    fCOREY.push_back( ( float )iYcore_m );
+    fHIL_MSW.push_back( ( float )iMSCW );
+    fHIL_MSL.push_back( ( float )iMSCL );
+    fEMISSION_HEIGHT.push_back( ( float )iEmissionHeight );
+    fACCEPTANCE.push_back( ( float )iAcceptance );
+    
+    if( fEVENT_ID.size() >= fChunkSize )
+    {
+        flush();
+    }
+}
+
+/*
+ * write buffered events column-wise to the EVENTS table
+ */
+bool VDL3FITSWriter::flush()
+{
+    if( !fptr || fEVENT_ID.size() == 0 )
+    {
+        return true;
+    }
+    int status = 0;
+    LONGLONG n = fEVENT_ID.size();
+    LONGLONG iFirstRow = fNRowsWritten + 1;
+    fits_write_col( fptr, TLONGLONG, 1, iFirstRow, 1, n, &fEVENT_ID[0], &status );
+    fits_write_col( fptr, TDOUBLE, 2, iFirstRow, 1, n, &fTIME[0], &status );
+    fits_write_col( fptr, TFLOAT, 3, iFirstRow, 1, n, &fRA[0], &status );
+    fits_write_col( fptr, TFLOAT, 4, iFirstRow, 1, n, &fDEC[0], &status );
+    fits_write_col( fptr, TFLOAT, 5, iFirstRow, 1, n, &fENERGY[0], &status );
+    fits_write_col( fptr, TFLOAT, 6, iFirstRow, 1, n, &fALT[0], &status );
+    fits_write_col( fptr, TFLOAT, 7, iFirstRow, 1, n, &fAZ[0], &status );
+    fits_write_col( fptr, TSHORT, 8, iFirstRow, 1, n, &fMULTIP[0], &status );
+    fits_write_col( fptr, TFLOAT, 9, iFirstRow, 1, n, &fDETX[0], &status );
+    fits_write_col( fptr, TFLOAT, 10, iFirstRow, 1, n, &fDETY[0], &status );
+    fits_write_col( fptr, TFLOAT, 11, iFirstRow, 1, n, &fCOREX[0], &status );
+    fits_write_col( fptr, TFLOAT, 12, iFirstRow, 1, n, &fCOREY[0], &status );
+    fits_write_col( fptr, TFLOAT, 13, iFirstRow, 1, n, &fHIL_MSW[0], &status );
+    fits_write_col( fptr, TFLOAT, 14, iFirstRow, 1, n, &fHIL_MSL[0], &status );
+    fits_write_col( fptr, TFLOAT, 15, iFirstRow, 1, n, &fEMISSION_HEIGHT[0], &status );
+    fits_write_col( fptr, TFLOAT, 16, iFirstRow, 1, n, &fACCEPTANCE[0], &status );
+    clearBuffers();
+    if( status )
+    {
+        return printerror( status );
+    }
+    fNRowsWritten += n;
+    return true;
+}
+
+/*
+ * keywords describing the time reference system
+ * (written to the current HDU)
+ */
+bool VDL3FITSWriter::writeTimeKeywords()
+{
+    int status = 0;
+    int iMJDREFI = fMJDREFI;
+    double iMJDREFF = 0.;
+    fits_write_key( fptr, TINT, "MJDREFI", &iMJDREFI, "reference time: integer part [MJD]", &status );
+    fits_write_key( fptr, TDOUBLE, "MJDREFF", &iMJDREFF, "reference time: fractional part [MJD]", &status );
+    fits_write_key( fptr, TSTRING, "TIMEUNIT", ( void* )"s", "time unit", &status );
+    fits_write_key( fptr, TSTRING, "TIMESYS", ( void* )"UTC", "time system", &status );
+    fits_write_key( fptr, TSTRING, "TIMEREF", ( void* )"LOCAL", "time reference frame", &status );
+    if( status )
+    {
+        return printerror( status );
+    }
+    return true;
+}
+
+/*
+ * write GTI table from time mask (intervals of open seconds)
+ *
+ * returns sum of good time intervals in iOnTime [s]
+ */
+bool VDL3FITSWriter::writeGTI( const VTimeMask* iTimeMask, double& iOnTime )
+{
+    iOnTime = 0.;
+    vector< double > iStart;
+    vector< double > iStop;
+    if( iTimeMask )
+    {
+        vector< Bool_t > iMask = iTimeMask->getMask();
+        double iT0 = ( iTimeMask->getMaskStartUTC() - ( double )fMJDREFI ) * 86400.;
+        for( unsigned int i = 0; i < iMask.size(); i++ )
+        {
+            if( !iMask[i] )
+            {
+                continue;
+            }
+            if( i > 0 && iMask[i - 1] && iStop.size() > 0 )
+            {
+                iStop.back() = iT0 + ( double )( i + 1 );
+            }
+            else
+            {
+                iStart.push_back( iT0 + ( double )i );
+                iStop.push_back( iT0 + ( double )( i + 1 ) );
+            }
+        }
+    }
+    for( unsigned int i = 0; i < iStart.size(); i++ )
+    {
+        iOnTime += iStop[i] - iStart[i];
+    }
+    
+    int status = 0;
+    const char* ttype[2] = { "START", "STOP" };
+    const char* tform[2] = { "1D", "1D" };
+    const char* tunit[2] = { "s", "s" };
+    if( fits_create_tbl( fptr, BINARY_TBL, 0, 2, ( char** )ttype, ( char** )tform, ( char** )tunit, "GTI", &status ) )
+    {
+        return printerror( status );
+    }
+    fits_write_key( fptr, TSTRING, "HDUCLASS", ( void* )"GADF", "", &status );
+    fits_write_key( fptr, TSTRING, "HDUDOC", ( void* )"https://github.com/open-gamma-ray-astro/gamma-astro-data-formats", "", &status );
+    fits_write_key( fptr, TSTRING, "HDUVERS", ( void* )"0.2", "", &status );
+    fits_write_key( fptr, TSTRING, "HDUCLAS1", ( void* )"GTI", "", &status );
+    fits_write_key( fptr, TINT, "OBS_ID", &fRunNumber, "run number", &status );
+    if( status )
+    {
+        return printerror( status );
+    }
+    if( !writeTimeKeywords() )
+    {
+        return false;
+    }
+    if( iStart.size() > 0 )
+    {
+        fits_write_col( fptr, TDOUBLE, 1, 1, 1, ( LONGLONG )iStart.size(), &iStart[0], &status );
+        fits_write_col( fptr, TDOUBLE, 2, 1, 1, ( LONGLONG )iStop.size(), &iStop[0], &status );
+    }
+    if( status )
+    {
+        return printerror( status );
+    }
+    return true;
+}
+
+/*
+ * write remaining events, header keywords of the EVENTS table
+ * and the GTI table; close file
+ *
+ * iMJDStart, iMJDStopp: run start and end [MJD]
+ */
+bool VDL3FITSWriter::close( double iMJDStart, double iMJDStopp, const VTimeMask* iTimeMask, double iDeadTimeFraction )
+{
+    if( !fptr )
+    {
+        return false;
+    }
+    bool bSuccess = flush();
+    
+    int status = 0;
+    // on time from good time intervals
+    // (GTI table is written after the EVENTS header is complete)
+    double iOnTime = 0.;
+    if( iTimeMask )
+    {
+        iOnTime = iTimeMask->getEffectiveDuration();
+    }
+    else
+    {
+        iOnTime = ( iMJDStopp - iMJDStart ) * 86400.;
+    }
+    double iDeadC = 1. - iDeadTimeFraction;
+    double iLiveTime = iOnTime * iDeadC;
+    double iTStart = ( iMJDStart - ( double )fMJDREFI ) * 86400.;
+    double iTStop  = ( iMJDStopp - ( double )fMJDREFI ) * 86400.;
+    double iEquinox = 2000.;
+    string iCreator = "Eventdisplay " + VGlobalRunParameter::getEVNDISP_VERSION();
+    
+    fits_write_key( fptr, TSTRING, "HDUCLASS", ( void* )"GADF", "", &status );
+    fits_write_key( fptr, TSTRING, "HDUDOC", ( void* )"https://github.com/open-gamma-ray-astro/gamma-astro-data-formats", "", &status );
+    fits_write_key( fptr, TSTRING, "HDUVERS", ( void* )"0.2", "", &status );
+    fits_write_key( fptr, TSTRING, "HDUCLAS1", ( void* )"EVENTS", "", &status );
+    fits_write_key( fptr, TSTRING, "CREATOR", ( void* )iCreator.c_str(), "", &status );
+    fits_write_key( fptr, TSTRING, "TELESCOP", ( void* )fObservatory.c_str(), "", &status );
+    fits_write_key( fptr, TINT, "OBS_ID", &fRunNumber, "run number", &status );
+    fits_write_key( fptr, TDOUBLE, "TSTART", &iTStart, "start time of run [s]", &status );
+    fits_write_key( fptr, TDOUBLE, "TSTOP", &iTStop, "end time of run [s]", &status );
+    fits_write_key( fptr, TDOUBLE, "ONTIME", &iOnTime, "sum of good time intervals [s]", &status );
+    fits_write_key( fptr, TDOUBLE, "LIVETIME", &iLiveTime, "live time [s]", &status );
+    fits_write_key( fptr, TDOUBLE, "DEADC", &iDeadC, "dead time correction factor", &status );
+    fits_write_key( fptr, TSTRING, "OBJECT", ( void* )fObject.c_str(), "", &status );
+    fits_write_key( fptr, TDOUBLE, "RA_OBJ", &fRA_OBJ, "target right ascension (J2000) [deg]", &status );
+    fits_write_key( fptr, TDOUBLE, "DEC_OBJ", &fDEC_OBJ, "target declination (J2000) [deg]", &status );
+    fits_write_key( fptr, TDOUBLE, "RA_PNT", &fRA_PNT, "pointing right ascension (J2000) [deg]", &status );
+    fits_write_key( fptr, TDOUBLE, "DEC_PNT", &fDEC_PNT, "pointing declination (J2000) [deg]", &status );
+    fits_write_key( fptr, TDOUBLE, "EQUINOX", &iEquinox, "", &status );
+    fits_write_key( fptr, TSTRING, "RADECSYS", ( void* )"FK5", "", &status );
+    fits_write_key( fptr, TDOUBLE, "GEOLON", &fGeoLon, "observatory longitude [deg]", &status );
+    fits_write_key( fptr, TDOUBLE, "GEOLAT", &fGeoLat, "observatory latitude [deg]", &status );
+    fits_write_key( fptr, TDOUBLE, "ALTITUDE", &fAltitude, "observatory altitude [m]", &status );
+    if( status )
+    {
+        bSuccess = printerror( status );
+    }
+    if( !writeTimeKeywords() )
+    {
+        bSuccess = false;
+    }
+    // good time intervals
+    if( !writeGTI( iTimeMask, iOnTime ) )
+    {
+        bSuccess = false;
+    }
+    
+    status = 0;
+    if( fits_close_file( fptr, &status ) )
+    {
+        bSuccess = printerror( status );
+    }
+    fptr = 0;
+    if( bSuccess )
+    {
+        cout << "DL3 event list written to " << fFileName << " (" << fNRowsWritten << " events)" << endl;
+    }
+    return bSuccess;
+}
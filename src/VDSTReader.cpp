@@ -6,6 +6,32 @@
 
 #include <VDSTReader.h>
 
+VDSTReaderEvent::VDSTReaderEvent()
+{
+    fStatus = 0;
+    fRunNumber = 0;
+    fEventNumber = 0;
+    fEventType = 0;
+    for( unsigned int i = 0; i < 5; i++ )
+    {
+        fGPS[i] = 0;
+    }
+    fGPSYear = 0;
+    fATGPSYear = 0;
+    fNLocalTrigger = 0;
+    fMCPrimary = 0;
+    fMCEnergy = 0.;
+    fMCxcore = 0.;
+    fMCycore = 0.;
+    fMCxcos = 0.;
+    fMCycos = 0.;
+    fMCze = 0.;
+    fMCaz = 0.;
+    fMCxoff = 0.;
+    fMCyoff = 0.;
+}
+
+
 VDSTReader::VDSTReader( string isourcefile, bool iMC, int iNTel, bool iDebug )
 {
     fDebug = iDebug;
@@ -20,6 +46,9 @@ VDSTReader::VDSTReader( string isourcefile, bool iMC, int iNTel, bool iDebug )
     fPerformFADCAnalysis.assign( fNTelescopes, true );
     
     fDSTtreeEvent = 0;
+    fPrefetchWindow = 0;
+    fPrefetchTreeEvent = 0;
+    fMonteCarloHeader = 0;
     
     fMC = iMC;
     
@@ -30,6 +59,48 @@ VDSTReader::VDSTReader( string isourcefile, bool iMC, int iNTel, bool iDebug )
 }
 
 
+VDSTReader::~VDSTReader()
+{
+    fPrefetchRing.stop();
+}
+
+
+/*
+ * read events asynchronously
+ *
+ * a reader thread fills up to iWindow events ahead of the analysis
+ * into a ring of event buffers (iWindow = 0: synchronous reading)
+ *
+ * (reading starts with the next call to getNextEvent())
+ */
+void VDSTReader::setPrefetchWindow( unsigned int iWindow )
+{
+    fPrefetchRing.stop();
+    fPrefetchWindow = iWindow;
+}
+
+
+/*
+ * position reader at tree event iPosition
+ *
+ * (buffered events of the prefetch thread are discarded)
+ */
+bool VDSTReader::setEventPosition( int64_t iPosition )
+{
+    if( !fDSTTree || !fDSTTree->getDSTTree() )
+    {
+        return false;
+    }
+    if( iPosition < 0 || iPosition >= fDSTTree->getDSTTree()->GetEntries() )
+    {
+        return false;
+    }
+    fPrefetchRing.stop();
+    fDSTtreeEvent = ( unsigned int )iPosition;
+    return true;
+}
+
+
 TTree* VDSTReader::getMCTree()
 {
     if( !isMC() )
@@ -45,6 +116,8 @@ TTree* VDSTReader::getMCTree()
     {
         return 0;
     }
+    // file access is not thread safe: stop prefetching
+    fPrefetchRing.stop();
     
     return ( TTree* )fDSTfile->Get( "mc" );
 }
@@ -89,31 +162,34 @@ bool VDSTReader::init()
     {
         valarray< double > i_temp( 0., fNChannel[i] );
         vector< unsigned int > i_tempS( fNChannel[i], 0 );
+        vector< unsigned short int > i_tempUS( fNChannel[i], 0 );
         vector< bool > i_tempB( fNChannel[i], true );
         vector< bool > i_tempF( fNChannel[i], false );
-        fPedestal.push_back( i_temp );
-        fSums.push_back( i_temp );
-        fPe.push_back( i_temp );
+        fEvent.fPedestal.push_back( i_temp );
+        fEvent.fSums.push_back( i_temp );
+        fEvent.fPe.push_back( i_temp );
         vector< valarray< double > > i_temp_VV;
         for( unsigned int t = 0; t < VDST_MAXTIMINGLEVELS; t++ )
         {
             i_temp_VV.push_back( i_temp );
         }
-        fTracePulseTiming.push_back( i_temp_VV );
-        fTraceMax.push_back( i_temp );
-        fRawTraceMax.push_back( i_temp );
-        fDead.push_back( i_tempS );
+        fEvent.fTracePulseTiming.push_back( i_temp_VV );
+        fEvent.fTraceMax.push_back( i_temp );
+        fEvent.fRawTraceMax.push_back( i_temp );
+        fEvent.fDead.push_back( i_tempS );
+        fEvent.fZeroSuppressed.push_back( i_tempUS );
         fFullHitVec.push_back( i_tempB );
-        fFullTrigVec.push_back( i_tempB );
-        fHiLo.push_back( i_tempF );
-        fNumberofFullTrigger.push_back( 0 );
-        fTelAzimuth.push_back( 0. );
+        fEvent.fFullTrigVec.push_back( i_tempB );
+        fEvent.fHiLo.push_back( i_tempF );
+        fEvent.fNumberofFullTrigger.push_back( 0 );
+        fEvent.fTelAzimuth.push_back( 0. );
         fNumSamples.push_back( 0 );
-        fTelElevation.push_back( 0. );
-        fDSTvltrig.push_back( false );
-        fDSTl2trig_type.push_back( 0 );
-        fLTtime.push_back( 0. );
-        fLDTtime.push_back( 0. );
+        fEvent.fTelElevation.push_back( 0. );
+        fEvent.fDSTvltrig.push_back( false );
+        fEvent.fHasLocalTrigger.push_back( false );
+        fEvent.fDSTl2trig_type.push_back( 0 );
+        fEvent.fLTtime.push_back( 0. );
+        fEvent.fLDTtime.push_back( 0. );
         // FADC Trace
         vector< uint16_t > i_trace_sample( VDST_MAXSUMWINDOW, 0 );
         vector< vector< uint16_t > > i_trace_sample_VV;
@@ -121,10 +197,13 @@ bool VDSTReader::init()
         {
             i_trace_sample_VV.push_back( i_trace_sample );
         }
-        fFADCTrace.push_back( i_trace_sample_VV );
+        fEvent.fFADCTrace.push_back( i_trace_sample_VV );
     }
     fDummySample.assign( VDST_MAXSUMWINDOW, 0 );
     
+    // MC run header (read once; file access is not thread safe)
+    fMonteCarloHeader = ( VMonteCarloRunHeader* )fDSTfile->Get( "MC_runheader" );
+    
     return fDSTTree->isMC();
 }
 
@@ -146,6 +225,7 @@ bool VDSTReader::setTelescopeID( unsigned int iTelID )
 /*
  *  read next event from DST tree
  *
+ *  (from the prefetch ring if asynchronous reading is switched on)
  */
 bool VDSTReader::getNextEvent()
 {
@@ -159,13 +239,72 @@ bool VDSTReader::getNextEvent()
         return false;
     }
     
+    if( fPrefetchWindow > 0 )
+    {
+        if( !fPrefetchRing.isRunning() )
+        {
+            fPrefetchTreeEvent = fDSTtreeEvent;
+            fPrefetchRing.start( fPrefetchWindow, fEvent, [this]( VDSTReaderEvent & iEvent )
+            {
+                fillEvent( iEvent, fPrefetchTreeEvent );
+                if( iEvent.fStatus == 999 )
+                {
+                    return false;
+                }
+                if( iEvent.fStatus == 1 )
+                {
+                    fPrefetchTreeEvent++;
+                }
+                return true;
+            } );
+        }
+        if( !fPrefetchRing.next( fEvent ) )
+        {
+            fEvent.fStatus = 999;
+        }
+    }
+    else
+    {
+        fillEvent( fEvent, fDSTtreeEvent );
+    }
+    
+    // no next event
+    if( fEvent.fStatus == 999 )
+    {
+        setEventStatus( 999 );
+        return false;
+    }
+    else if( fEvent.fStatus != 1 )
+    {
+        return false;
+    }
+    
+    // successfull event
+    setEventStatus( 1 );
+    // increment tree event number
+    fDSTtreeEvent++;
+    return true;
+}
+
+
+/*
+ *  read event iTreeEvent from DST tree and fill data vectors
+ *
+ *  (iEvent.fStatus: 1 = successfull, 0 = error, 999 = no next event)
+ *
+ *  called from the prefetch thread when reading asynchronously:
+ *  do not access the current event (fEvent) here
+ */
+bool VDSTReader::fillEvent( VDSTReaderEvent& iEvent, unsigned int iTreeEvent )
+{
+    iEvent.fStatus = 0;
     int i_succ = 0;
-    i_succ = fDSTTree->getDSTTree()->GetEntry( fDSTtreeEvent );
+    i_succ = fDSTTree->getDSTTree()->GetEntry( iTreeEvent );
     
     // no next event
     if( i_succ <= 0 )
     {
-        setEventStatus( 999 );
+        iEvent.fStatus = 999;
         return false;
     }
     if( fDSTTree->getDSTNTel() < fNTelescopes )
@@ -175,52 +314,77 @@ bool VDSTReader::getNextEvent()
         return false;
     }
     
+    // event header
+    iEvent.fRunNumber = fDSTTree->getDSTRunNumber();
+    iEvent.fEventNumber = fDSTTree->getDSTEventNumber();
+    iEvent.fEventType = fDSTTree->getDSTEventType();
+    iEvent.fGPS[0] = fDSTTree->getDSTGPS0();
+    iEvent.fGPS[1] = fDSTTree->getDSTGPS1();
+    iEvent.fGPS[2] = fDSTTree->getDSTGPS2();
+    iEvent.fGPS[3] = fDSTTree->getDSTGPS3();
+    iEvent.fGPS[4] = fDSTTree->getDSTGPS4();
+    iEvent.fGPSYear = fDSTTree->getDSTGPSYear();
+    iEvent.fATGPSYear = fDSTTree->getDSTATGPSYear();
+    iEvent.fNLocalTrigger = fDSTTree->getDSTNLocalTrigger();
+    iEvent.fMCPrimary = fDSTTree->getDSTMCPrimary();
+    iEvent.fMCEnergy = fDSTTree->getDSTMCEnergy();
+    iEvent.fMCxcore = fDSTTree->getDSTMCxcore();
+    iEvent.fMCycore = fDSTTree->getDSTMCycore();
+    iEvent.fMCxcos = fDSTTree->getDSTMCxcos();
+    iEvent.fMCycos = fDSTTree->getDSTMCycos();
+    iEvent.fMCze = fDSTTree->getDSTMCze();
+    iEvent.fMCaz = fDSTTree->getDSTMCaz();
+    iEvent.fMCxoff = fDSTTree->getDSTMCxoff();
+    iEvent.fMCyoff = fDSTTree->getDSTMCyoff();
+    
     // fill data vectors
     for( unsigned int i = 0; i < fNTelescopes; i++ )
     {
-        fTelAzimuth[i] = fDSTTree->getDSTTelAzimuth( i );
-        fTelElevation[i] = fDSTTree->getDSTTelElevation( i );
+        iEvent.fTelAzimuth[i] = fDSTTree->getDSTTelAzimuth( i );
+        iEvent.fTelElevation[i] = fDSTTree->getDSTTelElevation( i );
         
         fDSTTree->setTelCounter( i );
         
         for( unsigned int j = 0; j < fNChannel[i]; j++ )
         {
-            fPedestal[i][j] = fDSTTree->getDSTPedestal( j, false );
-            fSums[i][j] = fDSTTree->getDSTSums( j );
-            fPe[i][j] = fDSTTree->getDSTPe( j );
+            iEvent.fPedestal[i][j] = fDSTTree->getDSTPedestal( j, false );
+            iEvent.fSums[i][j] = fDSTTree->getDSTSums( j );
+            iEvent.fPe[i][j] = fDSTTree->getDSTPe( j );
+            iEvent.fZeroSuppressed[i][j] = fDSTTree->getZeroSupppressed( j );
             for( unsigned int t = 0; t < fDSTTree->getDSTpulsetiminglevelsN(); t++ )
             {
-                if( fDSTTree->getZeroSupppressed( j ) < 2 )
+                if( iEvent.fZeroSuppressed[i][j] < 2 )
                 {
-                    fTracePulseTiming[i][t][j] = fDSTTree->getDSTpulsetiming( j, t );
+                    iEvent.fTracePulseTiming[i][t][j] = fDSTTree->getDSTpulsetiming( j, t );
                 }
                 // (TMPTMP) zero suppressed CTA data without timing
                 else
                 {
-                    fTracePulseTiming[i][t][j] = -1;
+                    iEvent.fTracePulseTiming[i][t][j] = -1;
                 }
             }
-            fHiLo[i][j] = fDSTTree->getDSTHiLo( j );
-            fTraceMax[i][j] = fDSTTree->getDSTMax( j );
-            fRawTraceMax[i][j] = fDSTTree->getDSTRawMax( j );
-            fDead[i][j] = fDSTTree->getDSTDead( j );
-            fFullTrigVec[i][j] = fDSTTree->getTrigL1( j );
+            iEvent.fHiLo[i][j] = fDSTTree->getDSTHiLo( j );
+            iEvent.fTraceMax[i][j] = fDSTTree->getDSTMax( j );
+            iEvent.fRawTraceMax[i][j] = fDSTTree->getDSTRawMax( j );
+            iEvent.fDead[i][j] = fDSTTree->getDSTDead( j );
+            iEvent.fFullTrigVec[i][j] = fDSTTree->getTrigL1( j );
         }
-        fNumberofFullTrigger[i] = fDSTTree->getNTrigL1( i );
+        iEvent.fNumberofFullTrigger[i] = fDSTTree->getNTrigL1( i );
     }
     // get local trigger
     for( unsigned int i = 0; i < fNTelescopes; i++ )
     {
-        fDSTvltrig[i] = fDSTTree->getDSTLocalTrigger( i );
+        iEvent.fDSTvltrig[i] = fDSTTree->getDSTLocalTrigger( i );
+        iEvent.fHasLocalTrigger[i] = ( fDSTTree->hasLocalTrigger( i ) >= 0 );
     }
     // get local trigger time
     if( fMC )
     {
         for( unsigned int i = 0; i < fNTelescopes; i++ )
         {
-            fLTtime[i] = fDSTTree->getDSTLocalTriggerTime( i );
-            fLDTtime[i] = fDSTTree->getDSTLocalDelayedTriggerTime( i );
-            fDSTl2trig_type[i] = fDSTTree->getDSTL2TriggerType( i );
+            iEvent.fLTtime[i] = fDSTTree->getDSTLocalTriggerTime( i );
+            iEvent.fLDTtime[i] = fDSTTree->getDSTLocalDelayedTriggerTime( i );
+            iEvent.fDSTl2trig_type[i] = fDSTTree->getDSTL2TriggerType( i );
         }
     }
     // get FADC trace
@@ -238,23 +402,20 @@ bool VDSTReader::getNextEvent()
             {
                 for( unsigned short int k = 0; k < fNumSamples[i]; k++ )
                 {
-                    fFADCTrace[i][j][k] = fDSTTree->getDSTTrace( j, k );
+                    iEvent.fFADCTrace[i][j][k] = fDSTTree->getDSTTrace( j, k );
                 }
             }
         }
     }
     
-    // successfull event
-    setEventStatus( 1 );
-    // increment tree event number
-    fDSTtreeEvent++;
+    iEvent.fStatus = 1;
     return true;
 }
 
 
 std::pair<bool, uint32_t> VDSTReader::getChannelHitIndex( uint32_t hit )
 {
-    if( hit < fSums[fTelID].size() )
+    if( hit < fEvent.fSums[fTelID].size() )
     {
         return std::make_pair( true, hit );
     }
@@ -264,7 +425,7 @@ std::pair<bool, uint32_t> VDSTReader::getChannelHitIndex( uint32_t hit )
 
 uint32_t VDSTReader::getHitID( uint32_t i )
 {
-    if( i < fSums[fTelID].size() )
+    if( i < fEvent.fSums[fTelID].size() )
     {
         return i;
     }
@@ -291,35 +452,48 @@ void VDSTReader::setTrigger( vector<bool> iImage, vector<bool> iBorder )
 
 VMonteCarloRunHeader* VDSTReader::getMonteCarloHeader()
 {
-    if( fDSTfile )
-    {
-        return ( VMonteCarloRunHeader* )fDSTfile->Get( "MC_runheader" );
-    }
-    return 0;
+    return fMonteCarloHeader;
 }
 
 vector< uint16_t > VDSTReader::getSamplesVec16Bit()
 {
-    if( fTelID < fFADCTrace.size() )
+    if( fTelID < fEvent.fFADCTrace.size() )
     {
-        if( fSelectedHitChannel < fFADCTrace[fTelID].size() )
+        if( fSelectedHitChannel < fEvent.fFADCTrace[fTelID].size() )
         {
-            return fFADCTrace[fTelID][fSelectedHitChannel];
+            return fEvent.fFADCTrace[fTelID][fSelectedHitChannel];
         }
     }
     
     return fDummySample16Bit;
 }
 
+/*
+ * view of the FADC trace of channel iHitID
+ *
+ * (same samples as returned by getSample16Bit(), no copy)
+ */
+VDataSpan< uint16_t > VDSTReader::getSamplesSpan16Bit( uint32_t iHitID )
+{
+    if( fTelID < fPerformFADCAnalysis.size() && fPerformFADCAnalysis[fTelID] && fTelID < fEvent.fFADCTrace.size() )
+    {
+        if( iHitID < fEvent.fFADCTrace[fTelID].size() && fEvent.fFADCTrace[fTelID][iHitID].size() > 0 )
+        {
+            return VDataSpan< uint16_t >( &fEvent.fFADCTrace[fTelID][iHitID][0], fEvent.fFADCTrace[fTelID][iHitID].size() );
+        }
+    }
+    return VDataSpan< uint16_t >();
+}
+
 vector< uint8_t > VDSTReader::getSamplesVec()
 {
-    if( fTelID < fPerformFADCAnalysis.size() && fPerformFADCAnalysis[fTelID] && fTelID < fFADCTrace.size() )
+    if( fTelID < fPerformFADCAnalysis.size() && fPerformFADCAnalysis[fTelID] && fTelID < fEvent.fFADCTrace.size() )
     {
-        if( fSelectedHitChannel < fFADCTrace[fTelID].size() )
+        if( fSelectedHitChannel < fEvent.fFADCTrace[fTelID].size() )
         {
             for( unsigned int i = 0; i < getNumSamples(); i++ )
             {
-                fDummySample[i] = ( uint8_t )fFADCTrace[fTelID][fSelectedHitChannel][i];
+                fDummySample[i] = ( uint8_t )fEvent.fFADCTrace[fTelID][fSelectedHitChannel][i];
             }
             return fDummySample;
         }
@@ -336,13 +510,13 @@ uint8_t  VDSTReader::getSample( unsigned channel, unsigned sample, bool iNewNois
 
 uint16_t VDSTReader::getSample16Bit( unsigned channel, unsigned sample, bool iNewNoiseTrace )
 {
-    if( fTelID < fPerformFADCAnalysis.size() && fPerformFADCAnalysis[fTelID] && fTelID < fFADCTrace.size() )
+    if( fTelID < fPerformFADCAnalysis.size() && fPerformFADCAnalysis[fTelID] && fTelID < fEvent.fFADCTrace.size() )
     {
-        if( channel < fFADCTrace[fTelID].size() )
+        if( channel < fEvent.fFADCTrace[fTelID].size() )
         {
-            if( sample < fFADCTrace[fTelID][channel].size() )
+            if( sample < fEvent.fFADCTrace[fTelID][channel].size() )
             {
-                return fFADCTrace[fTelID][channel][sample];
+                return fEvent.fFADCTrace[fTelID][channel][sample];
             }
         }
     }
@@ -359,7 +533,7 @@ uint16_t VDSTReader::getSample16Bit( unsigned channel, unsigned sample, bool iNe
 
 bool VDSTReader::isZeroSuppressed( unsigned int iChannel )
 {
-    return !( ( bool )fDSTTree->getZeroSupppressed( getTelescopeID(), iChannel ) );
+    return !( ( bool )getZeroSuppressionFlag( iChannel ) );
 }
 
 
@@ -377,5 +551,9 @@ bool VDSTReader::isZeroSuppressed( unsigned int iChannel )
  */
 unsigned short int VDSTReader::getZeroSuppressionFlag( unsigned int iChannel )
 {
-    return fDSTTree->getZeroSupppressed( getTelescopeID(), iChannel );
+    if( fTelID < fEvent.fZeroSuppressed.size() && iChannel < fEvent.fZeroSuppressed[fTelID].size() )
+    {
+        return fEvent.fZeroSuppressed[fTelID][iChannel];
+    }
+    return 0;
 }
@@ -167,9 +167,34 @@ VDataMCComparision::VDataMCComparision( string iname, int intel, bool iMVAValues
     
     setShowerMaximZe_deg();
     
+    fQuiet = false;
+    
     defineHistograms();
 }
 
+/*
+ * accumulator for parallel filling: same configuration as iParent,
+ * private set of histograms (to be added to the parent with addHistograms())
+ */
+VDataMCComparision::VDataMCComparision( VDataMCComparision* iParent )
+    : VDataMCComparision( iParent->fName, iParent->fNTel, iParent->fCalculateMVAValues )
+{
+    fTel_x = iParent->fTel_x;
+    fTel_y = iParent->fTel_y;
+    fTel_z = iParent->fTel_z;
+    fWobbleNorth = iParent->fWobbleNorth;
+    fWobbleEast = iParent->fWobbleEast;
+    fWobbleFromDataTree = iParent->fWobbleFromDataTree;
+    fAzRange = iParent->fAzRange;
+    fAzMin = iParent->fAzMin;
+    fAzMax = iParent->fAzMax;
+    fZeMin = iParent->fZeMin;
+    fZeMax = iParent->fZeMax;
+    hAzWeight = iParent->hAzWeight;
+    fShowerMaxZe_deg = iParent->fShowerMaxZe_deg;
+    fQuiet = true;
+}
+
 /*
 
   needed only for the calculation of MVA value (not a default)
@@ -448,6 +473,70 @@ bool VDataMCComparision::setOnOffHistograms( VDataMCComparision* on, VDataMCComp
     return true;
 }
 
+/*
+ * add histograms of an accumulator (same histogram definitions)
+ */
+bool VDataMCComparision::addHistograms( VDataMCComparision* iAccumulator )
+{
+    if( !iAccumulator || !hisList || !iAccumulator->hisList
+            || hisList->GetSize() != iAccumulator->hisList->GetSize() )
+    {
+        cout << "VDataMCComparision::addHistograms: error, inconsistent histogram lists" << endl;
+        return false;
+    }
+    TIter next( hisList );
+    TIter next_acc( iAccumulator->hisList );
+    while( TH1* h = ( TH1* )next() )
+    {
+        TH1* h_acc = ( TH1* )next_acc();
+        if( h_acc )
+        {
+            h->Add( h_acc );
+        }
+    }
+    return true;
+}
+
+/*
+ * read only the variables needed for the histograms
+ */
+void VDataMCComparision::selectBranches( TTree* iTree, bool iAzimuthWeighting )
+{
+    if( !iTree )
+    {
+        return;
+    }
+    vector< string > iBranches;
+    iBranches.push_back( "NImages" );
+    iBranches.push_back( "EChi2S" );
+    iBranches.push_back( "ErecS" );
+    iBranches.push_back( "Az" );
+    iBranches.push_back( "Ze" );
+    if( !iAzimuthWeighting )
+    {
+        const char* iVar[] = { "runNumber", "eventNumber", "MSCW", "MSCL", "MWR", "MLR", "Xcore", "Ycore",
+                               "SizeSecondMax", "theta2", "Xoff", "Yoff", "Xoff_derot", "Yoff_derot",
+                               "MCxoff", "MCyoff", "MCe0", "ImgSel", "ImgSel_list", "EmissionHeight",
+                               "ArrayPointing_Elevation", "ArrayPointing_Azimuth", "meanPedvar_Image",
+                               "MSCWT", "MSCLT", "ES", "R", "alpha", "asym", "cen_x", "cen_y", "dist",
+                               "fracLow", "length", "width", "loss", "max1", "max2", "max3",
+                               "meanPedvar_ImageT", "nlowgain", "ntubes", "size", "tgrad_x"
+                             };
+        for( unsigned int i = 0; i < sizeof( iVar ) / sizeof( iVar[0] ); i++ )
+        {
+            iBranches.push_back( iVar[i] );
+        }
+    }
+    iTree->SetBranchStatus( "*", 0 );
+    for( unsigned int i = 0; i < iBranches.size(); i++ )
+    {
+        if( iTree->GetBranch( iBranches[i].c_str() ) )
+        {
+            iTree->SetBranchStatus( iBranches[i].c_str(), 1 );
+        }
+    }
+}
+
 void VDataMCComparision::setEntries( TH1D* iH )
 {
     double ie = 0.;
@@ -549,7 +638,10 @@ bool VDataMCComparision::fillHistograms( string ifile, int iSingleTelescopeCuts
             if( fSpectralWeight )
             {
                 fSpectralWeight->setMCParameter( -1.*iMC_H->spectral_index, iMC_H->E_range[0], iMC_H->E_range[1] );
-                fSpectralWeight->print();
+                if( !fQuiet )
+                {
+                    fSpectralWeight->print();
+                }
                 
                 // Deals with CARE sims without full information in the run header
                 if( fSpectralWeight->getSpectralWeight( 1.0 ) == 0 )
@@ -566,49 +658,57 @@ bool VDataMCComparision::fillHistograms( string ifile, int iSingleTelescopeCuts
     // set this false for stereo cuts
     int fSingleTelescopeCuts = iSingleTelescopeCuts;
     
-    if( fName == "SIMS" )
+    if( fName == "SIMS" && !fQuiet )
     {
         cout << "\t reading simulations..." << endl;
     }
     fData = new CData( iC, fName == "SIMS" );
-    
-    int nentries =  fData->fChain->GetEntries();
-    cout << "\t entries: " << nentries << " (" << fNTel << " telescopes)" << endl;
-    cout << "\t quality cuts: " << endl;
-    cout << "\t\t maximum core distance [m]: " << fCoreMax_QC << endl;
-    cout << "\t\t minimum number of images per event: " << fNImages_min << endl;
-    if( fAzRange )
+    // MVA evaluation might need any of the variables in the data tree
+    if( !fCalculateMVAValues )
     {
-        cout << "\t\t azimuth cut: [" << fAzMin << ", " << fAzMax << "]" << endl;
+        selectBranches( iC );
     }
-    cout << "\t\t zenith cut: [" << fZeMin << ", " << fZeMax << "]" << endl;
-    cout << "\t cuts: ";
     
-    if( fSingleTelescopeCuts == -1 )
-    {
-        cout << " stereo cuts (hardwired)" << endl;
-        cout << "\t " << msw_min << " < MSCW < " << msw_max << ", " << msl_min << " < MSCL < " << msl_max;
-        cout << ", theta2 < " << theta2_cut << " deg2" << endl;
-    }
-    else if( fSingleTelescopeCuts == -2 )
-    {
-        cout << "NO CUTS (quality cuts only)" << endl;
-    }
-    else if( fSingleTelescopeCuts == -3 )
-    {
-        cout << " Theta2 cut (<" << theta2_cut << " deg2),  ";
-        cout << " Size2ndMax cut (>" << size2ndmax_min << ")" << endl;
-    }
-    else
+    int nentries =  fData->fChain->GetEntries();
+    if( !fQuiet )
     {
-        cout << " single telescope cuts for Telescope (hardwired): " << fSingleTelescopeCuts << endl;
-        cout << "\t ntubes >" << ntubes_min << endl;
-        cout << "\t alpha < " << alpha_max << endl;
-        cout << "\t size < " << size_min << endl;
-        cout << "\t " << length_min << " < length < " << length_max << endl;
-        cout << "\t " << width_min << " < width < " << width_max << endl;
-        cout << "\t los < " << los_max << endl;
-        cout << "\t " << dist_min << " < dist < " << dist_max << endl;
+        cout << "\t entries: " << nentries << " (" << fNTel << " telescopes)" << endl;
+        cout << "\t quality cuts: " << endl;
+        cout << "\t\t maximum core distance [m]: " << fCoreMax_QC << endl;
+        cout << "\t\t minimum number of images per event: " << fNImages_min << endl;
+        if( fAzRange )
+        {
+            cout << "\t\t azimuth cut: [" << fAzMin << ", " << fAzMax << "]" << endl;
+        }
+        cout << "\t\t zenith cut: [" << fZeMin << ", " << fZeMax << "]" << endl;
+        cout << "\t cuts: ";
+        
+        if( fSingleTelescopeCuts == -1 )
+        {
+            cout << " stereo cuts (hardwired)" << endl;
+            cout << "\t " << msw_min << " < MSCW < " << msw_max << ", " << msl_min << " < MSCL < " << msl_max;
+            cout << ", theta2 < " << theta2_cut << " deg2" << endl;
+        }
+        else if( fSingleTelescopeCuts == -2 )
+        {
+            cout << "NO CUTS (quality cuts only)" << endl;
+        }
+        else if( fSingleTelescopeCuts == -3 )
+        {
+            cout << " Theta2 cut (<" << theta2_cut << " deg2),  ";
+            cout << " Size2ndMax cut (>" << size2ndmax_min << ")" << endl;
+        }
+        else
+        {
+            cout << " single telescope cuts for Telescope (hardwired): " << fSingleTelescopeCuts << endl;
+            cout << "\t ntubes >" << ntubes_min << endl;
+            cout << "\t alpha < " << alpha_max << endl;
+            cout << "\t size < " << size_min << endl;
+            cout << "\t " << length_min << " < length < " << length_max << endl;
+            cout << "\t " << width_min << " < width < " << width_max << endl;
+            cout << "\t los < " << los_max << endl;
+            cout << "\t " << dist_min << " < dist < " << dist_max << endl;
+        }
     }
     
     double rdist1 = 0.;
@@ -679,8 +779,11 @@ bool VDataMCComparision::fillHistograms( string ifile, int iSingleTelescopeCuts
                 exit( EXIT_FAILURE );
             }
             
-            cout << "\t now at run " << fData->runNumber << " (" << fData->eventNumber << "):";
-            cout << " N " << fWobbleNorth << ", E " << fWobbleEast << endl;
+            if( !fQuiet )
+            {
+                cout << "\t now at run " << fData->runNumber << " (" << fData->eventNumber << "):";
+                cout << " N " << fWobbleNorth << ", E " << fWobbleEast << endl;
+            }
             
             iOldRun = fData->runNumber;
         }
@@ -1164,6 +1267,17 @@ bool VDataMCComparision::fillHistograms( string ifile, int iSingleTelescopeCuts
             }
         }
     }
+    
+    // close data files (accumulators fill one file per call)
+    if( fCuts )
+    {
+        delete fCuts;
+        fCuts = 0;
+    }
+    delete fData;
+    fData = 0;
+    delete iC;
+    
     return true;
 }
 
@@ -1262,6 +1376,7 @@ TH1D*  VDataMCComparision::getAzimuthWeightingHistogram( string ifile )
         exit( EXIT_FAILURE );
     }
     CData* tData = new CData( iC, fName == "SIMS" );
+    selectBranches( iC, true );
     int nentries =  tData->fChain->GetEntries();
     cout << "Filling Az distributions for entries: " << nentries << endl;
     cout << "(requires loop over all ON files)" << endl;
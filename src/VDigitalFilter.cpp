@@ -0,0 +1,199 @@
+/*! \class VDigitalFilter
+    \brief pole-zero correction, upsampling and smoothing of FADC traces
+    
+    same algorithm as VTraceHandler::PzpsaSmoothUpsampleFloat (FlashCam),
+    applied to blocks of fBlockSize channels at a time
+    
+    samples of all channels of a block are interleaved, so that each step
+    of the (sequential) running sums is done for all channels of the
+    block in one loop (vectorized by the compiler); results are identical
+    to the single-channel implementation
+
+*/
+
+#include "VDigitalFilter.h"
+
+VDigitalFilter::VDigitalFilter()
+{
+    fUpSample = 0;
+    fPoleZero = 0.;
+    fMult = 0.;
+}
+
+void VDigitalFilter::setParameters( unsigned int iUpSample, float iPoleZero )
+{
+    if( iUpSample == fUpSample && iPoleZero == fPoleZero )
+    {
+        return;
+    }
+    fUpSample = iUpSample;
+    fPoleZero = iPoleZero;
+    fMult = 0.;
+    if( fUpSample > 0 )
+    {
+        fMult = 1. / fUpSample / fUpSample;
+    }
+}
+
+/*
+ * filter iNTraces traces with iNSamples samples each
+ *
+ * iIn:       input traces [trace * iNSamples + sample]
+ * iBaseline: baseline per trace
+ * iOut:      filtered traces [trace * iNSamples * upsample + sample]
+ * iMax, iAt: peak maximum and position per trace (in upsampled samples)
+ */
+void VDigitalFilter::filter( unsigned int iNTraces, unsigned int iNSamples, const float* iIn, const float* iBaseline,
+                             float* iOut, float* iMax, int* iAt )
+{
+    if( iNTraces == 0 || iNSamples == 0 || fUpSample == 0 )
+    {
+        return;
+    }
+    const unsigned int W = fBlockSize;
+    unsigned int nOut = iNSamples * fUpSample;
+    fBlockIn.resize( iNSamples * W );
+    fBlockOut.resize( nOut * W );
+    
+    float iBlockBaseline[W];
+    float iBlockMax[W];
+    int   iBlockAt[W];
+    
+    for( unsigned int b = 0; b < iNTraces; b += W )
+    {
+        unsigned int nLanes = ( iNTraces - b < W ? iNTraces - b : W );
+        // interleave samples (unused lanes are filled with zeros)
+        for( unsigned int l = 0; l < W; l++ )
+        {
+            iBlockBaseline[l] = ( l < nLanes ? iBaseline[b + l] : 0. );
+        }
+        for( unsigned int s = 0; s < iNSamples; s++ )
+        {
+            float* p = &fBlockIn[s * W];
+            for( unsigned int l = 0; l < nLanes; l++ )
+            {
+                p[l] = iIn[( b + l ) * iNSamples + s];
+            }
+            for( unsigned int l = nLanes; l < W; l++ )
+            {
+                p[l] = 0.;
+            }
+        }
+        
+        filterBlock( iNSamples, iBlockBaseline, iBlockMax, iBlockAt );
+        
+        for( unsigned int l = 0; l < nLanes; l++ )
+        {
+            float* o = &iOut[( b + l ) * nOut];
+            for( unsigned int s = 0; s < nOut; s++ )
+            {
+                o[s] = fBlockOut[s * W + l];
+            }
+            iMax[b + l] = iBlockMax[l];
+            iAt[b + l]  = iBlockAt[l];
+        }
+    }
+}
+
+/*
+ * filter one block of interleaved traces
+ *
+ * (step by step as in PzpsaSmoothUpsampleFloat; the second running sum
+ *  reads and overwrites the output of the first running sum)
+ */
+void VDigitalFilter::filterBlock( unsigned int n, const float* iBaseline, float* iMax, int* iAt )
+{
+    const unsigned int W = fBlockSize;
+    const unsigned int us = fUpSample;
+    const float mult = fMult;
+    const float pz = fPoleZero;
+    const float* ip = &fBlockIn[0];
+    float* op = &fBlockOut[0];
+    
+    float v1[W], v2[W];
+    float pzc1[W], pzc2[W];
+    float sum1[W], sum2[W];
+    float tmp[W];
+    float last[W];
+    float peakmax[W];
+    int   peakat[W];
+    
+    unsigned int out1 = 0;
+    unsigned int out2 = 0;
+    
+    for( unsigned int l = 0; l < W; l++ )
+    {
+        v1[l] = v2[l] = ( ip[l] - iBaseline[l] ) * mult;
+        pzc2[l] = pzc1[l] = v2[l];
+        sum1[l] = pzc2[l] * us;
+        sum2[l] = sum1[l] * us;
+        peakmax[l] = -1e30;
+        peakat[l] = 0;
+    }
+    for( unsigned int i = 0; i < us; i++ )
+    {
+        for( unsigned int l = 0; l < W; l++ )
+        {
+            op[out1 * W + l] = sum1[l];
+        }
+        out1++;
+    }
+    for( unsigned int i = 1; i < n; i++ )
+    {
+        for( unsigned int l = 0; l < W; l++ )
+        {
+            v2[l] = ( ip[i * W + l] - iBaseline[l] ) * mult;
+            pzc2[l] = ( v2[l] - v1[l] );
+            v1[l] = v2[l];
+        }
+        for( unsigned int i1 = 0; i1 < us; i1++ )
+        {
+            float* o1 = &op[out1 * W];
+            float* o2 = &op[out2 * W];
+            for( unsigned int l = 0; l < W; l++ )
+            {
+                sum1[l] += pzc2[l] - pzc1[l] * pz;
+                o1[l] = sum1[l];
+                tmp[l] = o2[l];
+                o2[l] = sum2[l];
+                if( sum2[l] > peakmax[l] )
+                {
+                    peakmax[l] = sum2[l];
+                    peakat[l] = ( int )out2;
+                }
+                sum2[l] += sum1[l] - tmp[l];
+            }
+            out1++;
+            out2++;
+        }
+        for( unsigned int l = 0; l < W; l++ )
+        {
+            pzc1[l] = pzc2[l];
+        }
+    }
+    unsigned int nOut = n * us;
+    for( unsigned int l = 0; l < W; l++ )
+    {
+        last[l] = op[( nOut - 1 ) * W + l];
+    }
+    for( ; out2 < nOut; out2++ )
+    {
+        float* o2 = &op[out2 * W];
+        for( unsigned int l = 0; l < W; l++ )
+        {
+            tmp[l] = o2[l];
+            o2[l] = sum2[l];
+            if( sum2[l] > peakmax[l] )
+            {
+                peakmax[l] = sum2[l];
+                peakat[l] = ( int )out2;
+            }
+            sum2[l] += last[l] - tmp[l];
+        }
+    }
+    for( unsigned int l = 0; l < W; l++ )
+    {
+        iMax[l] = peakmax[l];
+        iAt[l] = peakat[l];
+    }
+}
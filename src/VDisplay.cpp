@@ -2131,8 +2131,15 @@ bool VDisplay::drawTgradGraphs()
     }
     
     fEventLoop->getData()->setTelID( fTelescope );
-    // get time gradient (for DP1)
+    // get time gradient of the pass which determined the final fit results
+    // (second pass for double pass method)
     TGraphErrors* xgraph = fEventLoop->getData()->getXGraph( false );
+    if( fEventLoop->getData()->isDoublePass() && fEventLoop->getData()->hasFADCData()
+            && fEventLoop->getData()->getXGraph( true )
+            && fEventLoop->getData()->getXGraph( true )->GetN() > 2 )
+    {
+        xgraph = fEventLoop->getData()->getXGraph( true );
+    }
     if( !xgraph || xgraph->GetN() < 1 )
     {
         return false;
@@ -2242,6 +2249,16 @@ bool VDisplay::drawTgradGraphs()
         xgraph->SetMarkerColor( 4 );
         xgraph->SetMarkerStyle( 20 );
         xgraph->Draw( "P" );
+        // time gradient fit to the points of this graph
+        // (graph has no fit function attached)
+        VImageParameter* iPar = fEventLoop->getData()->getImageParameters();
+        if( iPar && iPar->tgrad_x > -998. )
+        {
+            TLine* iL = new TLine( x_min, iPar->tint_x + iPar->tgrad_x * x_min,
+                                   x_max, iPar->tint_x + iPar->tgrad_x * x_max );
+            iL->SetLineColor( 2 );
+            iL->Draw();
+        }
     }
     
     delete h1;
@@ -1609,7 +1609,7 @@ bool VEffectiveAreaCalculator::fill( CData* d, VEffectiveAreaCalculatorMCHistogr
     ///////////////////////////////////////////////////////
     // get full data set and loop over all entries
     ///////////////////////////////////////////////////////
-    Long64_t d_nentries = d->fChain->GetEntries();
+    Long64_t d_nentries = d->getEntries();
     Long64_t i_start = 0;
     if( fRunPara && fRunPara->fIgnoreFractionOfEvents > 0. )
     {
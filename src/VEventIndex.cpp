@@ -0,0 +1,216 @@
+/*! \class VEventIndex
+    \brief event number to file position index for random access to events
+    
+    The index is filled while events are read (VEventLoop::nextEvent()).
+    Positions are reader specific (e.g. tree entry for DST files,
+    packet index for VBF files, stream offset for GrIsu files) and are
+    passed back to VVirtualDataReader::setEventPosition().
+    
+    Indexes can be stored in a small binary file and are reused
+    if size and modification time of the source file did not change.
+
+*/
+
+#include "VEventIndex.h"
+
+static const char fEventIndexMagic[8] = { 'V', 'E', 'V', 'T', 'I', 'D', 'X', '1' };
+static const uint32_t fEventIndexVersion = 1;
+
+VEventIndex::VEventIndex()
+{
+    fDebug = false;
+    reset();
+}
+
+/*
+ * reset index for a new source file
+ */
+void VEventIndex::reset( string iSourceFile )
+{
+    fSourceFile = iSourceFile;
+    fSourceFileSize = 0;
+    fSourceFileModTime = 0;
+    fIndex.clear();
+    fComplete = false;
+    fChanged = false;
+    if( fSourceFile.size() > 0 )
+    {
+        getSourceFileStatus( fSourceFile, fSourceFileSize, fSourceFileModTime );
+    }
+}
+
+bool VEventIndex::getSourceFileStatus( string iSourceFile, int64_t& iSize, int64_t& iModTime )
+{
+    struct stat i_stat;
+    if( stat( iSourceFile.c_str(), &i_stat ) != 0 )
+    {
+        iSize = 0;
+        iModTime = 0;
+        return false;
+    }
+    iSize = ( int64_t )i_stat.st_size;
+    iModTime = ( int64_t )i_stat.st_mtime;
+    return true;
+}
+
+/*
+ * add event to index
+ *
+ * (first occurrence of an event number is kept; negative
+ *  positions mean that the reader does not support seeking)
+ */
+void VEventIndex::addEvent( uint32_t iEventNumber, int64_t iPosition )
+{
+    if( iPosition < 0 )
+    {
+        return;
+    }
+    if( fIndex.insert( make_pair( iEventNumber, iPosition ) ).second )
+    {
+        fChanged = true;
+    }
+}
+
+bool VEventIndex::getPosition( uint32_t iEventNumber, int64_t& iPosition )
+{
+    map< uint32_t, int64_t >::iterator i_iter = fIndex.find( iEventNumber );
+    if( i_iter == fIndex.end() )
+    {
+        return false;
+    }
+    iPosition = i_iter->second;
+    return true;
+}
+
+/*
+ * get largest indexed event number smaller than iEventNumber
+ */
+bool VEventIndex::getPreviousEvent( uint32_t iEventNumber, uint32_t& iPreviousEventNumber )
+{
+    map< uint32_t, int64_t >::iterator i_iter = fIndex.lower_bound( iEventNumber );
+    if( i_iter == fIndex.begin() )
+    {
+        return false;
+    }
+    --i_iter;
+    iPreviousEventNumber = i_iter->first;
+    return true;
+}
+
+void VEventIndex::setComplete( bool iB )
+{
+    if( iB != fComplete )
+    {
+        fChanged = true;
+    }
+    fComplete = iB;
+}
+
+/*
+ * name of index file for a given source file
+ *
+ * e.g. 64080.cvbf -> iDirectory/64080.cvbf.evndisp.index
+ */
+string VEventIndex::getIndexFileName( string iDirectory, string iSourceFile )
+{
+    string iName = iSourceFile;
+    if( iName.rfind( "/" ) != string::npos )
+    {
+        iName = iName.substr( iName.rfind( "/" ) + 1, iName.size() );
+    }
+    if( iDirectory.size() > 0 && iDirectory[iDirectory.size() - 1] != '/' )
+    {
+        iDirectory += "/";
+    }
+    return iDirectory + iName + ".evndisp.index";
+}
+
+/*
+ * read index from file
+ *
+ * (index is ignored if the source file has changed since the index was written)
+ */
+bool VEventIndex::readIndexFile( string iIndexFile )
+{
+    ifstream is( iIndexFile.c_str(), ios::binary );
+    if( !is )
+    {
+        if( fDebug )
+        {
+            cout << "VEventIndex::readIndexFile: no index file found: " << iIndexFile << endl;
+        }
+        return false;
+    }
+    sEventIndexHeader i_header;
+    is.read( ( char* )&i_header, sizeof( sEventIndexHeader ) );
+    if( !is || memcmp( i_header.fMagic, fEventIndexMagic, 8 ) != 0 || i_header.fVersion != fEventIndexVersion )
+    {
+        cout << "VEventIndex::readIndexFile: invalid index file (ignored): " << iIndexFile << endl;
+        return false;
+    }
+    if( i_header.fSourceFileSize != fSourceFileSize || i_header.fSourceFileModTime != fSourceFileModTime )
+    {
+        cout << "VEventIndex::readIndexFile: source file changed, index file ignored: " << iIndexFile << endl;
+        return false;
+    }
+    map< uint32_t, int64_t > i_index;
+    uint32_t i_eventNumber = 0;
+    int64_t  i_position = 0;
+    for( uint64_t i = 0; i < i_header.fNEvents; i++ )
+    {
+        is.read( ( char* )&i_eventNumber, sizeof( uint32_t ) );
+        is.read( ( char* )&i_position, sizeof( int64_t ) );
+        if( !is )
+        {
+            cout << "VEventIndex::readIndexFile: error reading index file (ignored): " << iIndexFile << endl;
+            return false;
+        }
+        i_index[i_eventNumber] = i_position;
+    }
+    fIndex.swap( i_index );
+    fComplete = ( i_header.fComplete != 0 );
+    fChanged = false;
+    cout << "reading event index from " << iIndexFile << " (" << fIndex.size() << " events";
+    if( fComplete )
+    {
+        cout << ", complete";
+    }
+    cout << ")" << endl;
+    return true;
+}
+
+bool VEventIndex::writeIndexFile( string iIndexFile )
+{
+    // write to a temporary file first; concurrent jobs might read the index
+    string iTempFile = iIndexFile + ".tmp";
+    ofstream os( iTempFile.c_str(), ios::binary | ios::trunc );
+    if( !os )
+    {
+        cout << "VEventIndex::writeIndexFile: error opening index file for writing: " << iIndexFile << endl;
+        return false;
+    }
+    sEventIndexHeader i_header;
+    memset( &i_header, 0, sizeof( sEventIndexHeader ) );
+    memcpy( i_header.fMagic, fEventIndexMagic, 8 );
+    i_header.fVersion = fEventIndexVersion;
+    i_header.fComplete = ( fComplete ? 1 : 0 );
+    i_header.fSourceFileSize = fSourceFileSize;
+    i_header.fSourceFileModTime = fSourceFileModTime;
+    i_header.fNEvents = fIndex.size();
+    os.write( ( char* )&i_header, sizeof( sEventIndexHeader ) );
+    for( map< uint32_t, int64_t >::iterator i_iter = fIndex.begin(); i_iter != fIndex.end(); ++i_iter )
+    {
+        os.write( ( char* )&i_iter->first, sizeof( uint32_t ) );
+        os.write( ( char* )&i_iter->second, sizeof( int64_t ) );
+    }
+    os.close();
+    if( !os || rename( iTempFile.c_str(), iIndexFile.c_str() ) != 0 )
+    {
+        cout << "VEventIndex::writeIndexFile: error writing index file: " << iIndexFile << endl;
+        remove( iTempFile.c_str() );
+        return false;
+    }
+    fChanged = false;
+    cout << "writing event index to " << iIndexFile << " (" << fIndex.size() << " events)" << endl;
+    return true;
+}
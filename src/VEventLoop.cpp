@@ -44,6 +44,8 @@ VEventLoop::VEventLoop( VEvndispRunParameter* irunparameter )
     fBoolPrintSample.assign( fNTel, true );
     fGPSClockWarnings.assign( fNTel, 0 );
     fTimeCut_RunStartSeconds = 0;
+    fEventIndexSequential = false;
+    fEventIndex.setDebug( fDebug );
     
     fAnalyzeMode = true;
     fRunMode = ( E_runmode )fRunPar->frunmode;
@@ -107,6 +109,7 @@ VEventLoop::VEventLoop( VEvndispRunParameter* irunparameter )
     // create dead time calculator
     fDeadTime = new VDeadTime();
     fDeadTime->defineHistograms( fRunPar->fRunDuration );
+    fResetAnaData = false;
     
     // reset cut strings and variables
     resetRunOptions();
@@ -118,6 +121,166 @@ VEventLoop::~VEventLoop()
 }
 
 
+/*!
+    reset all run dependent data and prepare the event loop for the analysis of the next run
+    
+    (used by the evndisp queue mode; detector geometry, calibration data, IPR graphs and
+     disp analyzers are kept resident and reused if the input of the new run is identical)
+    
+    \param irunparameter run parameters of the next run
+    
+    \return false if the new run cannot be analysed with the same event loop
+*/
+bool VEventLoop::resetRun( VEvndispRunParameter* irunparameter )
+{
+    if( !irunparameter || !fRunPar )
+    {
+        return false;
+    }
+    // telescope configuration, run mode and reconstruction methods must not change
+    if( irunparameter->fNTelescopes != fRunPar->fNTelescopes
+            || irunparameter->fsourcetype != fRunPar->fsourcetype
+            || irunparameter->frunmode != fRunPar->frunmode
+            || irunparameter->fTelToAnalyze != fRunPar->fTelToAnalyze
+            || irunparameter->freconstructionparameterfile != fRunPar->freconstructionparameterfile )
+    {
+        cout << "VEventLoop::resetRun error: run parameters incompatible with previous run" << endl;
+        return false;
+    }
+    fDebug = irunparameter->fDebug;
+    if( fDebug )
+    {
+        cout << "VEventLoop::resetRun()" << endl;
+    }
+    fRunPar = irunparameter;
+    if( fNTel >= 10 )
+    {
+        fRunPar->fPrintSmallArray = false;
+    }
+    // all run dependent histograms and trees are created in the output file of the new run
+    gROOT->cd();
+    
+    bMCSetAtmosphericID = false;
+    fBoolPrintSample.assign( fNTel, true );
+    fGPSClockWarnings.assign( fNTel, 0 );
+    fTimeCut_RunStartSeconds = 0;
+    fEventIndexSequential = false;
+    
+    fEventNumber = 0;
+    fNextEventStatus = false;
+    fTimeCutsfNextEventStatus = true;
+    fEndCalibrationRunNow = false;
+    fBoolSumWindowChangeWarning = 0;
+    fLowGainMultiplierWarning = 0;
+    fArrayPreviousEventMJD = 0;
+    
+    setRunNumber( fRunPar->frunnumber );
+    
+    // detector geometry (reused for identical configurations)
+    bool iMakeNeighbourList = setDetectorGeometry( fNTel, fRunPar->fcamera, fRunPar->getDirectory_EVNDISPDetectorGeometry() );
+    setTeltoAna( fRunPar->fTelToAnalyze );
+    setDeadChannelText();
+    
+    // read reconstruction parameters
+    if( fEvndispReconstructionParameter )
+    {
+        delete fEvndispReconstructionParameter;
+        fEvndispReconstructionParameter = 0;
+    }
+    if( !get_reconstruction_parameters( fRunPar->freconstructionparameterfile, iMakeNeighbourList ) )
+    {
+        cout << "VEventLoop error while reading file with reconstruction parameters:" << endl;
+        cout << fRunPar->freconstructionparameterfile << endl;
+        exit( EXIT_FAILURE );
+    }
+    
+    // tracehandler
+    delete fTraceHandler;
+    fTraceHandler = new VTraceHandler();
+    if( getRunParameter()->fTraceIntegrationMethod.size() > 0 )
+    {
+        fTraceHandler->setTraceIntegrationmethod( getRunParameter()->fTraceIntegrationMethod[0] );
+    }
+    fTraceHandler->setMC_FADCTraceStart( getRunParameter()->fMC_FADCTraceStart );
+    fTraceHandler->setPulseTimingLevels( getRunParameter()->fpulsetiminglevels );
+    
+    // pedestal calculator
+    delete fPedestalCalculator;
+    fPedestalCalculator = new VPedestalCalculator();
+    
+    // dead time calculator
+    // (histograms are deleted in VDeadTime::writeHistograms() for data runs)
+    if( fDeadTime )
+    {
+        if( fDeadTime->getDeadTimeHistograms() )
+        {
+            fDeadTime->getDeadTimeHistograms()->Delete();
+            delete fDeadTime->getDeadTimeHistograms();
+        }
+        delete fDeadTime;
+    }
+    fDeadTime = new VDeadTime();
+    fDeadTime->defineHistograms( fRunPar->fRunDuration );
+    
+    // pixel data from DB and pointing are run dependent
+    if( fDB_PixelDataReader )
+    {
+        delete fDB_PixelDataReader;
+        fDB_PixelDataReader = 0;
+    }
+    for( unsigned int i = 0; i < fPointing.size(); i++ )
+    {
+        if( fPointing[i] )
+        {
+            delete fPointing[i];
+        }
+    }
+    fPointing.clear();
+    if( fArrayPointing )
+    {
+        delete fArrayPointing;
+        fArrayPointing = 0;
+    }
+    if( fStarCatalogue )
+    {
+        delete fStarCatalogue;
+        fStarCatalogue = 0;
+    }
+    // detector tree is owned by the output file of the previous run
+    if( fDetectorTree )
+    {
+        delete fDetectorTree;
+        fDetectorTree = 0;
+    }
+    for( unsigned int i = 0; i < fDeadChannelDefinition_HG.size(); i++ )
+    {
+        delete fDeadChannelDefinition_HG[i];
+    }
+    fDeadChannelDefinition_HG.clear();
+    for( unsigned int i = 0; i < fDeadChannelDefinition_LG.size(); i++ )
+    {
+        delete fDeadChannelDefinition_LG[i];
+    }
+    fDeadChannelDefinition_LG.clear();
+    
+    // analyzers (output file of the previous run has been closed in shutdown())
+    if( fAnalyzer )
+    {
+        fAnalyzer->resetRun();
+    }
+    if( fArrayAnalyzer )
+    {
+        fArrayAnalyzer->resetRun();
+    }
+    fResetAnaData = true;
+    
+    // reset cut strings and variables
+    resetRunOptions();
+    
+    return true;
+}
+
+
 /*!
     print basic run infos (file name, runnumber, etc.) to standard output
 */
@@ -456,6 +619,27 @@ bool VEventLoop::initEventLoop( string iFileName )
     // set the data readers for all inherent classes
     initializeDataReader();
     
+    // ============================
+    // asynchronous event reading
+    if( fReader && fRunPar->fPrefetchNEvents > 0 )
+    {
+        // reader thread and analysis use ROOT concurrently
+        ROOT::EnableThreadSafety();
+        fReader->setPrefetchWindow( fRunPar->fPrefetchNEvents );
+    }
+    
+    // ============================
+    // event index (random access to events)
+    if( fEventIndex.getSourceFile() != iFileName )
+    {
+        fEventIndex.reset( iFileName );
+        if( fRunPar->fEventIndexDirectory.size() > 0 )
+        {
+            fEventIndex.readIndexFile( VEventIndex::getIndexFileName( fRunPar->fEventIndexDirectory, iFileName ) );
+        }
+    }
+    fEventIndexSequential = true;
+    
     // ============================
     // read pixel values from DB
     fDB_PixelDataReader = 0;
@@ -635,7 +819,8 @@ void VEventLoop::initializeAnalyzers()
     // set analysis data storage classes
     // (slight inconsistency, produce VImageAnalyzerData for all telescopes,
     //  not only for the requested ones (in teltoana))
-    if( fAnaData.size() == 0 )
+    // (data storage classes of a previous run are reset, see resetRun())
+    if( fAnaData.size() == 0 || fResetAnaData )
     {
         for( unsigned int i = 0; i < fNTel; i++ )
         {
@@ -644,26 +829,34 @@ void VEventLoop::initializeAnalyzers()
                 fAnaDir[i]->cd();
             }
             setTelID( i );
-            fAnaData.push_back( new VImageAnalyzerData( i, fRunPar->fShortTree, ( fRunMode == R_PED || fRunMode == R_PEDLOW ||
-                                fRunMode == R_GTO || fRunMode == R_GTOLOW ||
-                                fRunMode == R_TZERO || fRunMode == R_TZEROLOW ),
-                                getRunParameter()->fWriteImagePixelList ) );
+            if( i < fAnaData.size() )
+            {
+                fAnaData[i]->resetRun();
+            }
+            else
+            {
+                fAnaData.push_back( new VImageAnalyzerData( i, fRunPar->fShortTree, ( fRunMode == R_PED || fRunMode == R_PEDLOW ||
+                                    fRunMode == R_GTO || fRunMode == R_GTOLOW ||
+                                    fRunMode == R_TZERO || fRunMode == R_TZEROLOW ),
+                                    getRunParameter()->fWriteImagePixelList ) );
+            }
             int iseed = fRunPar->fMCNdeadSeed;
             if( iseed != 0 )
             {
                 iseed += i;
             }
-            fAnaData.back()->initialize( getNChannels(), getReader()->getMaxChannels(),
-                                         getDebugFlag(), iseed, getNSamples(),
-                                         getRunParameter()->fpulsetiminglevels.size(), getRunParameter()->fpulsetiming_tzero_index,
-                                         getRunParameter()->fpulsetiming_width_index, getRunParameter()->fpulsetiming_triggertime_index );
+            fAnaData[i]->initialize( getNChannels(), getReader()->getMaxChannels(),
+                                     getDebugFlag(), iseed, getNSamples(),
+                                     getRunParameter()->fpulsetiminglevels.size(), getRunParameter()->fpulsetiming_tzero_index,
+                                     getRunParameter()->fpulsetiming_width_index, getRunParameter()->fpulsetiming_triggertime_index );
             if( fRunMode == R_DST )
             {
-                fAnaData.back()->initializeMeanPulseHistograms();
-                fAnaData.back()->initializeIntegratedChargeHistograms();
+                fAnaData[i]->initializeMeanPulseHistograms();
+                fAnaData[i]->initializeIntegratedChargeHistograms();
             }
-            fAnaData.back()->setTraceIntegrationMethod( getRunParameter()->fTraceIntegrationMethod[i] );
+            fAnaData[i]->setTraceIntegrationMethod( getRunParameter()->fTraceIntegrationMethod[i] );
         }
+        fResetAnaData = false;
         // reading special channels for all requested telescopes
         // reading throughput correction for all requested telescopes
         for( unsigned int i = 0; i < getTeltoAna().size(); i++ )
@@ -841,10 +1034,16 @@ void VEventLoop::shutdown()
     {
         fDST->terminate();
     }
+    // write event index
+    if( fRunPar->fEventIndexDirectory.size() > 0 && fEventIndex.isChanged() && fEventIndex.getNEvents() > 0 )
+    {
+        fEventIndex.writeIndexFile( VEventIndex::getIndexFileName( fRunPar->fEventIndexDirectory, fEventIndex.getSourceFile() ) );
+    }
     // delete readers
     if( fRunPar->fsourcetype != 0 && fGrIsuReader )
     {
         delete fGrIsuReader;
+        fGrIsuReader = 0;
     }
     if( fDebug )
     {
@@ -884,8 +1083,14 @@ void VEventLoop::shutdown()
 /*!
   \param gEv goto this event number
   (gEv==0 means reset file and goto event number 1 )
+  
+  events already seen (or listed in an event index file) are
+  accessed directly; all others are searched for by reading
+  through the file
+  
+  \return true if event was found
 */
-void VEventLoop::gotoEvent( int gEv )
+bool VEventLoop::gotoEvent( int gEv )
 {
     if( fDebug )
     {
@@ -897,7 +1102,29 @@ void VEventLoop::gotoEvent( int gEv )
     {
         // reset file, intialize calibrator and analyzer
         initEventLoop( fRunPar->fsourcefile );
-        return;
+        return true;
+    }
+    // event is in event index: position reader directly at this event
+    int64_t i_position = -1;
+    if( fEventIndex.getPosition( ( uint32_t )gEv, i_position ) && fReader->setEventPosition( i_position ) )
+    {
+        fEventIndexSequential = false;
+        fAnalyzeMode = false;
+        i_res = nextEvent();
+        if( !i_res || ( int )fEventNumber != gEv )
+        {
+            cout <<  "VEventLoop::gotoEvent( int gEv ): event not found: " << gEv << endl;
+            fAnalyzeMode = true;
+            return false;
+        }
+        analyzeEvent();
+        return true;
+    }
+    // index contains all events of this file
+    else if( fEventIndex.isComplete() )
+    {
+        cout <<  "VEventLoop::gotoEvent( int gEv ): event not found: " << gEv << endl;
+        return false;
     }
     // goto event number gEv (backward in sourcefile)
     // event number is smaller than current eventnumber
@@ -905,8 +1132,7 @@ void VEventLoop::gotoEvent( int gEv )
     {
         // reset file, start at the beginning and search for this event
         initEventLoop( fRunPar->fsourcefile );
-        gotoEvent( gEv );
-        return;
+        return gotoEvent( gEv );
     }
     // goto eventnumber gEv (forward in sourcefile)
     else
@@ -926,7 +1152,7 @@ void VEventLoop::gotoEvent( int gEv )
         if( !i_res )
         {
             cout <<  "VEventLoop::gotoEvent( int gEv ): event not found: " << gEv << endl;
-            return;
+            return false;
         }
         // event found, analyze it
         if( i_res )
@@ -934,6 +1160,7 @@ void VEventLoop::gotoEvent( int gEv )
             analyzeEvent();
         }
     }
+    return i_res;
 }
 
 
@@ -954,6 +1181,12 @@ bool VEventLoop::loop( int iEvents )
     fNumberofIncompleteEvents = 0;
     fNumberofGoodEvents = 0;
     
+    // analyse events from event list only
+    if( fRunPar->fEventListFile.size() > 0 )
+    {
+        return loopEventList( iEvents );
+    }
+    
     // Skip to start eventnumber
     if( fRunPar->fFirstEvent > 0 )
     {
@@ -998,6 +1231,107 @@ bool VEventLoop::loop( int iEvents )
 }
 
 
+/*!
+   analyse events listed in an event list file
+   
+   events are analysed in increasing event number; events known
+   to the event index are accessed directly, all others by reading
+   forward through the file
+   
+   \param iEvents maximum number of events to be analyzed (iEvents < 0: all events in list)
+*/
+bool VEventLoop::loopEventList( int iEvents )
+{
+    vector< unsigned int > i_eventList = readEventList( fRunPar->fEventListFile );
+    cout << endl;
+    cout << "analysing " << i_eventList.size() << " events from event list " << fRunPar->fEventListFile;
+    cout << " (" << fEventIndex.getNEvents() << " events in event index)" << endl;
+    
+    int i = 0;
+    unsigned int i_notFound = 0;
+    for( unsigned int e = 0; e < i_eventList.size(); e++ )
+    {
+        if( iEvents >= 0 && i >= iEvents )
+        {
+            break;
+        }
+        if( i == 0 )
+        {
+            cout << endl;
+            cout << "##########################################" << endl;
+            cout << "########  starting analysis  ############# " << endl;
+            cout << "##########################################" << endl;
+            cout << endl;
+        }
+        if( gotoEvent( ( int )i_eventList[e] ) )
+        {
+            fNumberofGoodEvents++;
+        }
+        else
+        {
+            i_notFound++;
+        }
+        if( fEndCalibrationRunNow || !fTimeCutsfNextEventStatus )
+        {
+            break;
+        }
+        i++;
+        if( fRunPar->fPrintAnalysisProgress > 0 && i % fRunPar->fPrintAnalysisProgress == 0 )
+        {
+            cout << "\t now at event " << i << " (event number " << i_eventList[e] << ")" << endl;
+        }
+    }
+    if( i_notFound > 0 )
+    {
+        cout << "VEventLoop::loopEventList: " << i_notFound << " event(s) from event list not found" << endl;
+    }
+    terminate( i );
+    return true;
+}
+
+
+/*!
+   read list of event numbers from file
+   
+   (one event number per line; lines starting with '#' are ignored)
+   
+   \return sorted list of event numbers (duplicates removed)
+*/
+vector< unsigned int > VEventLoop::readEventList( string iFile )
+{
+    vector< unsigned int > i_eventList;
+    ifstream is( iFile.c_str() );
+    if( !is )
+    {
+        cout << "VEventLoop::readEventList error: event list not found: " << iFile << endl;
+        exit( EXIT_FAILURE );
+    }
+    string is_line;
+    while( getline( is, is_line ) )
+    {
+        size_t i_first = is_line.find_first_not_of( " \t" );
+        if( i_first == string::npos || is_line[i_first] == '#' )
+        {
+            continue;
+        }
+        int i_eventNumber = atoi( is_line.substr( i_first ).c_str() );
+        if( i_eventNumber > 0 )
+        {
+            i_eventList.push_back( ( unsigned int )i_eventNumber );
+        }
+    }
+    is.close();
+    sort( i_eventList.begin(), i_eventList.end() );
+    i_eventList.erase( unique( i_eventList.begin(), i_eventList.end() ), i_eventList.end() );
+    if( i_eventList.size() == 0 )
+    {
+        cout << "VEventLoop::readEventList error: no events found in event list " << iFile << endl;
+        exit( EXIT_FAILURE );
+    }
+    return i_eventList;
+}
+
+
 /*!
   checking event cuts only in analysis mode
 
@@ -1026,6 +1360,11 @@ bool VEventLoop::nextEvent()
             else
             {
                 cout << "!!! void VEventLoop::nextEvent(): no next event (end of file)" << endl;
+                // all events of the file have been seen
+                if( fEventIndexSequential )
+                {
+                    fEventIndex.setComplete( true );
+                }
                 // if the display is run in the loop mode, goto event 0 and start again
                 if( fRunPar->floopmode )
                 {
@@ -1087,6 +1426,11 @@ bool VEventLoop::nextEvent()
             fReader->setTelescopeID( getTeltoAna()[i] );
             getTelescopeEventNumber()[getTeltoAna()[i]] = fReader->getEventNumber();
         }
+        // add event to event index
+        if( fEventNumber != 99999999 )
+        {
+            fEventIndex.addEvent( fEventNumber, fReader->getEventPosition() );
+        }
         // set event time from data reader
         setEventTimeFromReader();
         // check time into the run
@@ -1151,6 +1495,15 @@ int VEventLoop::analyzeEvent()
         }
     }
     
+    // new event: invalidate decoded traces of all telescopes
+    for( unsigned int i = 0; i < fRunPar->fTelToAnalyze.size(); i++ )
+    {
+        if( fRunPar->fTelToAnalyze[i] < fAnaData.size() && fAnaData[fRunPar->fTelToAnalyze[i]] )
+        {
+            fAnaData[fRunPar->fTelToAnalyze[i]]->getTraceCache()->newEvent();
+        }
+    }
+    
     ////////////////////////////////////
     // analyze all requested telescopes
     ////////////////////////////////////
@@ -1366,6 +1719,11 @@ int VEventLoop::analyzeEvent()
                 
         }
     }
+    // fill image parameters of all telescopes (sparse layout only)
+    if( fRunMode == R_ANA && getImageParameterSparseTree() )
+    {
+        getImageParameterSparseTree()->fill();
+    }
     /////////////////////////////////////////////////////////////////////////
     // ARRAY ANALYSIS
     if( fRunMode != R_PED && fRunMode != R_GTO && fRunMode != R_GTOLOW && fRunMode != R_PEDLOW && fRunMode != R_TZERO && fRunMode != R_TZEROLOW )
@@ -1626,11 +1984,21 @@ void VEventLoop::resetRunOptions()
 
 
 /*!
-      will be implemented as soon as all features of the vbf reader is used
+    go to the previous event: largest event number in the event index
+    smaller than the current event number
+    
+    (events are indexed while reading; an event index file (-eventindexdir)
+     provides the complete list; direct access for DST, VBF, PE and GrIsu files)
 */
 void VEventLoop::previousEvent()
 {
-    cout << "not implemented, fFileRead->getPrevEvent crashes always" << endl;
+    uint32_t i_previous = 0;
+    if( !fEventIndex.getPreviousEvent( fEventNumber, i_previous ) )
+    {
+        cout << "VEventLoop::previousEvent(): no previous event found (event " << fEventNumber << ")" << endl;
+        return;
+    }
+    gotoEvent( ( int )i_previous );
 }
 
 
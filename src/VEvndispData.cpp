@@ -232,13 +232,34 @@ bool VEvndispData::setDetectorGeometry( unsigned int iNTel, vector< string > iCa
     // (all cases but DSTs)
     if( getRunParameter()->fsourcetype != 7 && getRunParameter()->fsourcetype != 4 )
     {
-        fDetectorGeo = new VDetectorGeometry( iNTel, iCamera, iDir, fDebug,
-                                              getRunParameter()->fCameraCoordinateTransformX, getRunParameter()->fCameraCoordinateTransformY,
-                                              getRunParameter()->fsourcetype );
-        // get camera rotations from the DB
-        if( getRunParameter()->fDBCameraRotationMeasurements )
+        // geometry read from configuration files is kept resident and reused
+        // for identical configurations (e.g. by the workers in evndisp queue mode);
+        // camera rotations from the DB are run dependent and are always read
+        ostringstream iKey;
+        if( !getRunParameter()->fDBCameraRotationMeasurements )
+        {
+            iKey << iNTel << "|" << iDir << "|" << getRunParameter()->fsourcetype << "|";
+            iKey << getRunParameter()->fCameraCoordinateTransformX << "|" << getRunParameter()->fCameraCoordinateTransformY;
+            for( unsigned int i = 0; i < iCamera.size(); i++ )
+            {
+                iKey << "|" << iCamera[i];
+            }
+        }
+        if( fDetectorGeo && iKey.str().size() > 0 && iKey.str() == fDetectorGeoKey )
         {
-            fDetectorGeo->readDetectorGeometryFromDB( getRunParameter()->fDBRunStartTimeSQL, getRunParameter()->fDBCameraRotationMeasurements );
+            cout << "reusing detector geometry" << endl;
+        }
+        else
+        {
+            fDetectorGeo = new VDetectorGeometry( iNTel, iCamera, iDir, fDebug,
+                                                  getRunParameter()->fCameraCoordinateTransformX, getRunParameter()->fCameraCoordinateTransformY,
+                                                  getRunParameter()->fsourcetype );
+            fDetectorGeoKey = iKey.str();
+            // get camera rotations from the DB
+            if( getRunParameter()->fDBCameraRotationMeasurements )
+            {
+                fDetectorGeo->readDetectorGeometryFromDB( getRunParameter()->fDBRunStartTimeSQL, getRunParameter()->fDBCameraRotationMeasurements );
+            }
         }
     }
     //////////////////////////////////////////////////////////////////////////////////////////
@@ -246,8 +267,6 @@ bool VEvndispData::setDetectorGeometry( unsigned int iNTel, vector< string > iCa
     // (telconfig tree)
     else
     {
-        fDetectorGeo = new VDetectorGeometry( iNTel, fDebug );
-        fDetectorGeo->setSourceType( getRunParameter()->fsourcetype );
         TFile iDetectorFile( getRunParameter()->fsourcefile.c_str() );
         if( iDetectorFile.IsZombie() )
         {
@@ -260,13 +279,27 @@ bool VEvndispData::setDetectorGeometry( unsigned int iNTel, vector< string > iCa
             cout << "VEvndispData::setDetectorGeometry error: cannot find detector tree (telconfig) in " << getRunParameter()->fsourcefile << endl;
             exit( EXIT_FAILURE );
         }
-        VDetectorTree iDetectorTree;
-        iDetectorTree.readDetectorTree( fDetectorGeo, iTree, ( getRunParameter()->getObservatory() != "VERITAS" ) );
-        // neighbour list will be set up later, after reading the reconstruction runparameter files
-        iMakeNeighbourList = true;
-        if( fDebug )
+        // geometry is reused for DST files with identical telescope configurations
+        ostringstream iKey;
+        iKey << "dst|" << iNTel << "|" << getRunParameter()->fsourcetype << "|" << getRunParameter()->getObservatory();
+        iKey << "|" << VUtilities::getTreeMD5( iTree );
+        if( fDetectorGeo && iKey.str() == fDetectorGeoKey )
+        {
+            cout << "reusing detector geometry" << endl;
+        }
+        else
         {
-            cout << "VEvndispData::setDetectorGeometry reading detector geometry from DST file" << endl;
+            fDetectorGeo = new VDetectorGeometry( iNTel, fDebug );
+            fDetectorGeoKey = iKey.str();
+            fDetectorGeo->setSourceType( getRunParameter()->fsourcetype );
+            VDetectorTree iDetectorTree;
+            iDetectorTree.readDetectorTree( fDetectorGeo, iTree, ( getRunParameter()->getObservatory() != "VERITAS" ) );
+            // neighbour list will be set up later, after reading the reconstruction runparameter files
+            iMakeNeighbourList = true;
+            if( fDebug )
+            {
+                cout << "VEvndispData::setDetectorGeometry reading detector geometry from DST file" << endl;
+            }
         }
     }
     // print most important parameters of the detector
@@ -1250,6 +1283,7 @@ unsigned int VEvndispData::fNTel = 1;
 unsigned int VEvndispData::fTelID = 0;
 vector< unsigned int > VEvndispData::fTeltoAna;
 VDetectorGeometry* VEvndispData::fDetectorGeo = 0;
+string VEvndispData::fDetectorGeoKey = "";
 VDetectorTree* VEvndispData::fDetectorTree = 0;
 
 // pointing
@@ -1303,6 +1337,7 @@ TFile* VEvndispData::fOutputfile = 0;
 vector< TDirectory* > VEvndispData::fAnaDir;
 vector< VImageAnalyzerData* > VEvndispData::fAnaData;
 VShowerParameters* VEvndispData::fShowerParameters = 0;
+VImageParameterSparseTree* VEvndispData::fImageParameterSparseTree = 0;
 VMCParameters* VEvndispData::fMCParameters = 0;
 VEvndispReconstructionParameter* VEvndispData::fEvndispReconstructionParameter = 0;
 
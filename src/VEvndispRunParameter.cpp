@@ -62,6 +62,9 @@ VEvndispRunParameter::VEvndispRunParameter( bool bSetGlobalParameter ) : VGlobal
     fFirstEvent = -10000;
     fTimeCutsMin_min = -99;
     fTimeCutsMin_max = -99;
+    fPrefetchNEvents = 0;
+    fEventListFile = "";
+    fEventIndexDirectory = "";
     fIsMC = 0;
     fIgnoreCFGversions = false;
     fPrintAnalysisProgress = 25000;
@@ -237,7 +240,10 @@ VEvndispRunParameter::VEvndispRunParameter( bool bSetGlobalParameter ) : VGlobal
     ffillhistos = false;                          // obsolete
     foutputfileName = "";
     fWriteExtraCalibTree = false;
+    fWriteCalibrationHistograms = false;
+    fCalibrationNThreads = 0;
     fWriteImagePixelList = false;
+    fWriteSparseImageTree = false;
     // MC parameters
     // offset in telescope numbering (0 for old grisudet version (<3.0.0))
     ftelescopeNOffset = 1;
@@ -532,6 +538,18 @@ void VEvndispRunParameter::print( int iEv )
     {
         cout << "stop analysing at minute " << fTimeCutsMin_max << endl;
     }
+    if( fPrefetchNEvents > 0 )
+    {
+        cout << "asynchronous event reading (prefetching " << fPrefetchNEvents << " events)" << endl;
+    }
+    if( fEventListFile.size() > 0 )
+    {
+        cout << "analysing events from event list: " << fEventListFile << endl;
+    }
+    if( fEventIndexDirectory.size() > 0 )
+    {
+        cout << "event index directory: " << fEventIndexDirectory << endl;
+    }
     if( fNCalibrationEvents > 0 )
     {
         cout << "number of events in calibration analysis: " << fNCalibrationEvents << endl;
@@ -732,6 +750,10 @@ void VEvndispRunParameter::print( int iEv )
     {
         cout << endl << "shortened tree output " << endl;
     }
+    if( fWriteSparseImageTree )
+    {
+        cout << "image parameters of all telescopes written to one tree (tparsSparse)" << endl;
+    }
     if( fwriteMCtree )
     {
         cout << "writing full MC tree with all MC events " << endl;
@@ -180,10 +180,20 @@ bool VExclusionRegions::setExclusionRegionsFromStarCatalogue( VStarCatalogue* iS
     //////////////////////////////////////////////////////////
     // set up list of exclusion regions from star catalogue
     double i_brightness = 100.;
-    for( unsigned int i = 0; i < iStarCatalogue->getListOfStarsinFOV().size(); i++ )
+    vector< VStar* > i_StarsInFOV = iStarCatalogue->getListOfStarsinFOV();
+    // star exclusion regions already in the list (accessed by star ID)
+    map< int, VListOfExclusionRegions* > i_StarExclusionRegions;
+    for( unsigned int e = 0; e < fExclusionRegions.size(); e++ )
+    {
+        if( fExclusionRegions[e] && fExclusionRegions[e]->fExcludeFromBackground_StarID >= 0 )
+        {
+            i_StarExclusionRegions[fExclusionRegions[e]->fExcludeFromBackground_StarID] = fExclusionRegions[e];
+        }
+    }
+    for( unsigned int i = 0; i < i_StarsInFOV.size(); i++ )
     {
         // get list of stars in the relevant FOV
-        if( !iStarCatalogue->getListOfStarsinFOV()[i] )
+        if( !i_StarsInFOV[i] )
         {
             continue;
         }
@@ -199,11 +209,11 @@ bool VExclusionRegions::setExclusionRegionsFromStarCatalogue( VStarCatalogue* iS
             // get magnitude in correct band
             if( fBrightStarSettings[b]->fStarBand == "V" )
             {
-                i_brightness = iStarCatalogue->getListOfStarsinFOV()[i]->fBrightness_V;
+                i_brightness = i_StarsInFOV[i]->fBrightness_V;
             }
             else if( fBrightStarSettings[b]->fStarBand == "B" )
             {
-                i_brightness = iStarCatalogue->getListOfStarsinFOV()[i]->fBrightness_B;
+                i_brightness = i_StarsInFOV[i]->fBrightness_B;
             }
             else
             {
@@ -225,22 +235,20 @@ bool VExclusionRegions::setExclusionRegionsFromStarCatalogue( VStarCatalogue* iS
                 VListOfExclusionRegions* i_ExclusionRegion = 0;
                 
                 // check if this star is already in the list of exclusion regions
-                for( unsigned int e = 0; e < fExclusionRegions.size(); e++ )
+                map< int, VListOfExclusionRegions* >::iterator i_iter = i_StarExclusionRegions.find( ( int )i_StarsInFOV[i]->fStarID );
+                if( i_iter != i_StarExclusionRegions.end() )
                 {
-                    if( fExclusionRegions[e]->fExcludeFromBackground_StarID >= 0
-                            && fExclusionRegions[e]->fExcludeFromBackground_StarID == ( int )iStarCatalogue->getListOfStarsinFOV()[i]->fStarID )
-                    {
-                        i_ExclusionRegion = fExclusionRegions[e];
-                    }
+                    i_ExclusionRegion = i_iter->second;
                 }
-                if( !i_ExclusionRegion )
+                else
                 {
                     fExclusionRegions.push_back( new VListOfExclusionRegions() );
                     i_ExclusionRegion = fExclusionRegions.back();
+                    i_StarExclusionRegions[( int )i_StarsInFOV[i]->fStarID] = i_ExclusionRegion;
                 }
                 // fill the exclusion region
-                i_ExclusionRegion->fExcludeFromBackground_RAJ2000  = iStarCatalogue->getListOfStarsinFOV()[i]->fRA2000;
-                i_ExclusionRegion->fExcludeFromBackground_DecJ2000 = iStarCatalogue->getListOfStarsinFOV()[i]->fDec2000;
+                i_ExclusionRegion->fExcludeFromBackground_RAJ2000  = i_StarsInFOV[i]->fRA2000;
+                i_ExclusionRegion->fExcludeFromBackground_DecJ2000 = i_StarsInFOV[i]->fDec2000;
                 // exclusion radius might be already set to be larger
                 if( fBrightStarSettings[b]->fStarExlusionRadius_DEG
                         > i_ExclusionRegion->fExcludeFromBackground_Radius1 )
@@ -257,10 +265,10 @@ bool VExclusionRegions::setExclusionRegionsFromStarCatalogue( VStarCatalogue* iS
                 i_ExclusionRegion->fExcludeFromBackground_West = 0.;
                 i_ExclusionRegion->fExcludeFromBackground_CameraCentre_x = 0.;
                 i_ExclusionRegion->fExcludeFromBackground_CameraCentre_y = 0.;
-                i_ExclusionRegion->fExcludeFromBackground_StarID = ( int )iStarCatalogue->getListOfStarsinFOV()[i]->fStarID;
-                i_ExclusionRegion->fExcludeFromBackground_StarName = iStarCatalogue->getListOfStarsinFOV()[i]->fStarName;
-                i_ExclusionRegion->fExcludeFromBackground_StarBrightness_V = iStarCatalogue->getListOfStarsinFOV()[i]->fBrightness_V;
-                i_ExclusionRegion->fExcludeFromBackground_StarBrightness_B = iStarCatalogue->getListOfStarsinFOV()[i]->fBrightness_B;
+                i_ExclusionRegion->fExcludeFromBackground_StarID = ( int )i_StarsInFOV[i]->fStarID;
+                i_ExclusionRegion->fExcludeFromBackground_StarName = i_StarsInFOV[i]->fStarName;
+                i_ExclusionRegion->fExcludeFromBackground_StarBrightness_V = i_StarsInFOV[i]->fBrightness_V;
+                i_ExclusionRegion->fExcludeFromBackground_StarBrightness_B = i_StarsInFOV[i]->fBrightness_B;
                 if( fBrightStarSettings[b]->fStarBand == "B" )
                 {
                     i_ExclusionRegion->fExcludeFromBackground_B_Band = true;
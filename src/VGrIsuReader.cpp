@@ -640,6 +640,23 @@ void VGrIsuReader::readPedsfromPlines()
 }
 
 
+/*
+ * position stream at the beginning of a shower event
+ *
+ * (pedestal events are generated randomly and cannot be indexed)
+ */
+bool VGrIsuReader::setEventPosition( int64_t iPosition )
+{
+    if( fPedestalMode || iPosition < 0 )
+    {
+        return false;
+    }
+    is.clear();
+    is.seekg( ( streampos )iPosition );
+    return is.good();
+}
+
+
 /*!
      this is finetuned to the grisudet output
 */
@@ -1068,6 +1085,19 @@ std::vector< uint8_t >  VGrIsuReader::getSamplesVec()
 }
 
 
+/*
+ * view of the samples of channel iHitID (no copy)
+ */
+VDataSpan< uint8_t > VGrIsuReader::getSamplesSpan( uint32_t iHitID )
+{
+    if( iHitID < fMaxChannels[fTelescopeID] && fSamplesVec[fTelescopeID][iHitID].size() > 0 )
+    {
+        return VDataSpan< uint8_t >( &fSamplesVec[fTelescopeID][iHitID][0], fSamplesVec[fTelescopeID][iHitID].size() );
+    }
+    return VDataSpan< uint8_t >();
+}
+
+
 std::pair<bool, uint32_t> VGrIsuReader::getChannelHitIndex( uint32_t hit )
 {
     if( hit < fMaxChannels[fTelescopeID] )
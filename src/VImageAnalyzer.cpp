@@ -398,7 +398,15 @@ void VImageAnalyzer::fillOutputTree()
     }
     getImageParameters()->eventStatus = getAnalysisTelescopeEventStatus()[getTelID()];
     // fill the trees with the results
-    getImageParameters()->fill();
+    // (sparse layout: one tree for all telescopes, filled in VEventLoop::analyzeEvent)
+    if( getImageParameterSparseTree() )
+    {
+        getImageParameterSparseTree()->addTelescope( getTelID(), getImageParameters() );
+    }
+    else
+    {
+        getImageParameters()->fill();
+    }
     if( fRunPar->fImageLL )
     {
         getImageParametersLogL()->eventStatus = getAnalysisTelescopeEventStatus()[getTelID()];
@@ -470,7 +478,8 @@ void VImageAnalyzer::terminate( bool iDebug_IO )
             getPointing()[getTelID()]->terminate( isMC() );
         }
         // write main output trees
-        if( getImageParameters()->getTree() )
+        // (not for sparse layout, tpars trees are empty)
+        if( getImageParameters()->getTree() && !getImageParameterSparseTree() )
         {
             int i_nbytes = getImageParameters()->getTree()->Write();
             if( iDebug_IO )
@@ -924,6 +933,39 @@ void VImageAnalyzer::shutdown()
 }
 
 
+/*
+ * reset all run dependent data before analysing the next run
+ *
+ * (output file of the previous run is closed in shutdown())
+ */
+void VImageAnalyzer::resetRun()
+{
+    if( fDebug )
+    {
+        cout << "void VImageAnalyzer::resetRun()" << endl;
+    }
+    if( fOutputfile )
+    {
+        delete fOutputfile;
+        fOutputfile = 0;
+    }
+    fAnaDir.assign( fAnaDir.size(), 0 );
+    fInit = false;
+    
+    fVImageCleaning->resetRun();
+    
+    // detector geometry changes between runs for DSTs with different telescope configurations
+    if( fVImageParameterCalculation->getDetectorGeometry() != getDetectorGeometry() )
+    {
+        fVImageParameterCalculation->setDetectorGeometry( getDetectorGeometry() );
+        if( fRunPar->fhoughmuonmode )
+        {
+            fVImageParameterCalculation->houghInitialization();
+        }
+    }
+}
+
+
 /*!
    calculate trigger vector
 
@@ -942,7 +984,7 @@ void VImageAnalyzer::setNTrigger()
         return;
     }
     
-    std::vector<bool> triggered = getReader()->getFullTrigVec();
+    const std::vector<bool>& triggered = getReader()->getFullTrigVecRef();
     unsigned int triggered_size = triggered.size();
     unsigned short max_num_in_patch = 0;
     
@@ -114,11 +114,71 @@ void VImageAnalyzerData::initialize( unsigned int iChannels, unsigned int iMaxCh
     fFADCstopTZero.resize( 4, 0. );
     fFADCstopSum.resize( 4, 0. );
     
+    fTraceCache.initialize( iChannels, iSamples );
+    
     fRandomMakeDeadChannelsSeed = iseed;
     fRandomMakeDeadChannels->SetSeed( fRandomMakeDeadChannelsSeed );
 }
 
 
+/*
+ * reset all run dependent data
+ *
+ * analysis data are kept resident between runs (evndisp queue mode);
+ * trees and histograms are booked in the current directory of the
+ * output file of the next run, the data vectors are filled again
+ * in initialize()
+ */
+void VImageAnalyzerData::resetRun()
+{
+    // trees of the previous run are owned (and deleted) by its output file
+    if( fAnaHistos )
+    {
+        fAnaHistos->hisList->Clear();
+        fAnaHistos->init();
+    }
+    if( fImageParameter )
+    {
+        fImageParameter->resetTree();
+    }
+    if( fImageParameterLogL )
+    {
+        fImageParameterLogL->resetTree();
+    }
+    fTimeSinceRunStart = -1.;
+    fTimeRunStart = 0.;
+    
+    fDead.clear();
+    fMasked.clear();
+    fDeadRecovered.clear();
+    fDeadUI.clear();
+    fLowGainDead.clear();
+    fLowGainDeadRecovered.clear();
+    fLowGainDeadUI.clear();
+    fHiLo.clear();
+    fZeroSuppressed.clear();
+    fLLEst.clear();
+    fPulseTimingUncorrected.clear();
+    fPulseTimingCorrected.clear();
+    fImage.clear();
+    fBorder.clear();
+    fTrigger.clear();
+    fBrightNonImage.clear();
+    fImageBorderNeighbour.clear();
+    fBorderBorderNeighbour.clear();
+    fImageUser.clear();
+    fClusterID.clear();
+    fClusterNpix.clear();
+    fClusterSize.clear();
+    fClusterTime.clear();
+    fClusterCenx.clear();
+    fClusterCeny.clear();
+    fCorrelationCoefficient.clear();
+    fFADCstopTZero.clear();
+    fFADCstopSum.clear();
+}
+
+
 void VImageAnalyzerData::initializeMeanPulseHistograms()
 {
     fFillMeanTraces = true;
@@ -169,7 +229,7 @@ void VImageAnalyzerData::initializeIntegratedChargeHistograms()
 }
 
 
-void VImageAnalyzerData::setTrace( unsigned int iChannel, vector< double > fT, bool iHiLo, double iPeds )
+void VImageAnalyzerData::setTrace( unsigned int iChannel, const vector< double >& fT, bool iHiLo, double iPeds )
 {
     if( fFillMeanTraces && iChannel < hMeanPulseLow.size() && iChannel < hMeanPulseHigh.size() )
     {
@@ -489,6 +489,12 @@ void VImageBaseAnalyzer::calcTZerosSums( int iFirstSum, int iLastSum, unsigned i
     }
     unsigned int ndead_size = getDead().size();
     
+    // digital filter: filter all channels of this event together
+    if( getDigitalFilterMethod() > 0 )
+    {
+        fillTraceCache();
+    }
+    
     double i_tempTraceMax = 0;
     unsigned int i_tempN255 = 0;
     unsigned int i_tempTraceMaxPosition = 0;
@@ -679,7 +685,28 @@ void VImageBaseAnalyzer::calcTZerosSums( int iFirstSum, int iLastSum, unsigned i
                 if( i_channelHitID == getFADCstopTrig()[c] )
                 {
                     fReader->selectHitChan( ( uint32_t )i );
+                    // use direct view of samples if available from reader
+                    VDataSpan< uint16_t > i_samples16Bit;
+                    VDataSpan< uint8_t > i_samples;
                     if( fReader->has16Bit() )
+                    {
+                        i_samples16Bit = fReader->getSamplesSpan16Bit( ( uint32_t )i );
+                    }
+                    else
+                    {
+                        i_samples = fReader->getSamplesSpan( ( uint32_t )i );
+                    }
+                    if( !i_samples16Bit.empty() )
+                    {
+                        fTraceHandler->setTrace( i_samples16Bit, getPeds( getHiLo()[i_channelHitID] )[i_channelHitID],
+                                                 i_channelHitID, getLowGainMultiplier_Trace()*getHiLo()[i_channelHitID] );
+                    }
+                    else if( !i_samples.empty() )
+                    {
+                        fTraceHandler->setTrace( i_samples, getPeds( getHiLo()[i_channelHitID] )[i_channelHitID],
+                                                 i_channelHitID, getLowGainMultiplier_Trace()*getHiLo()[i_channelHitID] );
+                    }
+                    else if( fReader->has16Bit() )
                     {
                         fTraceHandler->setTrace( fReader->getSamplesVec16Bit(), getPeds( getHiLo()[i_channelHitID] )[i_channelHitID],
                                                  i_channelHitID, getLowGainMultiplier_Trace()*getHiLo()[i_channelHitID] );
@@ -925,13 +952,14 @@ void VImageBaseAnalyzer::findDeadChans( bool iLowGain, bool iFirst )
         if( fReader->isMC() )
         {
             // getFullAnaVec()[i]: -1: dead channel, 0: channel does not exist, 1 channel o.k.
-            if( fReader->getDataFormatNum() == 1 && getNChannels() >= fReader->getFullAnaVec().size() )
+            const vector< int >& i_anaVec = fReader->getFullAnaVecRef();
+            if( fReader->getDataFormatNum() == 1 && getNChannels() >= i_anaVec.size() )
             {
-                if( fReader->getFullAnaVec()[i] == 0 )
+                if( i_anaVec[i] == 0 )
                 {
                     setDead( i, 12, iLowGain );
                 }
-                if( !fRunPar->fMCnoDead && fReader->getFullAnaVec()[i] == -1 )
+                if( !fRunPar->fMCnoDead && i_anaVec[i] == -1 )
                 {
                     setDead( i, 12, iLowGain );
                 }
@@ -1614,6 +1642,62 @@ int VImageBaseAnalyzer::getFADCTraceIntegrationPosition( int iPos )
  * set trace and parameters for trace integration methods
  *
  */
+/*
+ * decode and digitally filter the traces of all good channels
+ * of this event in one go (see VTraceHandler::fillTraceCache)
+ *
+ * settings (pedestals, low-gain multipliers) as in initializeTrace();
+ * the following calls to initializeTrace() read the filtered
+ * traces from the trace cache
+ */
+void VImageBaseAnalyzer::fillTraceCache()
+{
+    fTraceCacheHitID.clear();
+    fTraceCacheChanID.clear();
+    fTraceCachePed.clear();
+    fTraceCacheHiLo.clear();
+    
+    unsigned int nhits = fReader->getNumChannelsHit();
+    if( nhits > getDead( false ).size() )
+    {
+        nhits = getDead( false ).size();
+    }
+    unsigned int i_channelHitID = 0;
+    for( unsigned int i = 0; i < nhits; i++ )
+    {
+        try
+        {
+            i_channelHitID = fReader->getHitID( i );
+        }
+        catch( ... )
+        {
+            continue;
+        }
+        if( i_channelHitID >= getDead().size() || i_channelHitID >= getHiLo().size()
+                || getDead( i_channelHitID, getHiLo()[i_channelHitID] ) )
+        {
+            continue;
+        }
+        // zero suppressed channels with charge information only
+        if( i_channelHitID < getZeroSuppressed().size() && getZeroSuppressed()[i_channelHitID] == 2 )
+        {
+            continue;
+        }
+        fTraceCacheHitID.push_back( i );
+        fTraceCacheChanID.push_back( i_channelHitID );
+        fTraceCachePed.push_back( getPeds( getHiLo()[i_channelHitID] )[i_channelHitID] );
+        fTraceCacheHiLo.push_back( getLowGainMultiplier_Trace() * getHiLo()[i_channelHitID] );
+    }
+    
+    fTraceHandler->setDigitalFilterParameters( getDigitalFilterMethod(),
+            getDigitalFilterUpSample(),
+            getDigitalFilterPoleZero() );
+    fTraceHandler->fillTraceCache( fReader, getNSamples(),
+                                   fTraceCacheHitID, fTraceCacheChanID,
+                                   fTraceCachePed, fTraceCacheHiLo,
+                                   getTraceCache() );
+}
+
 void VImageBaseAnalyzer::initializeTrace( bool iMakingPeds, unsigned int i_channelHitID, unsigned int i, unsigned int iTraceIntegrationMethod )
 {
     double i_LG = getLowGainMultiplier_Trace() * getHiLo()[i_channelHitID];
@@ -1632,12 +1716,14 @@ void VImageBaseAnalyzer::initializeTrace( bool iMakingPeds, unsigned int i_chann
             getDigitalFilterPoleZero() );
             
     // set trace
+    // (decoded once per event; all further calls read from the trace cache)
     fTraceHandler->setTrace( fReader,
                              getNSamples(),
                              getPeds( getHiLo()[i_channelHitID] )[i_channelHitID],
                              i_channelHitID,
                              i,
-                             i_LG );
+                             i_LG,
+                             getTraceCache() );
     // make sure that trace integration is set (important for pedestal calculations in QADC runs)
     if( iTraceIntegrationMethod < 9999 )
     {
@@ -43,6 +43,27 @@ VImageCleaning::VImageCleaning( VEvndispData* iData )
     
 }
 
+/*
+ * reset run dependent data of the NN image cleaning
+ *
+ * IPR graphs and probability curves are set up again
+ * at the first event of the next run (IPR graphs are
+ * part of the calibration data)
+ */
+void VImageCleaning::resetRun()
+{
+    fWriteGraphToFileRecreate = true;
+    for( unsigned int i = 0; i < VDST_MAXTELTYPES; i++ )
+    {
+        kInitNNImgClnPerTelType[i] = false;
+    }
+    fIPR_save_mincharge = -99.;
+    fIPR_save_dT_from_probCurve = -99.;
+    fIPR_save_telid = 99;
+    fIPR_save_ProbCurve_par1 = -99.;
+    fIPR_save_ProbCurve_par2 = -99.;
+}
+
 /*
  * simple error messager
  *
@@ -3216,7 +3237,7 @@ void VImageCleaning::resetImageChannel( unsigned int i_channel )
 */
 double getTraceCorrelationValue( double Amean, double Bmean,
                                  double Avar, double Bvar,
-                                 vector < double > vA, vector < double > vB )
+                                 const double* vA, const double* vB, unsigned int n )
 {
     if( Avar == 0. || Bvar == 0. )
     {
@@ -3224,7 +3245,7 @@ double getTraceCorrelationValue( double Amean, double Bmean,
     }
     double N = 0;
     
-    for( unsigned int i = 0; i < vA.size() && i < vB.size() ; i++ )
+    for( unsigned int i = 0; i < n; i++ )
     {
         N = N + ( vA[i] - Amean ) * ( vB[i] - Bmean );
     }
@@ -3232,26 +3253,26 @@ double getTraceCorrelationValue( double Amean, double Bmean,
     return N / TMath::Sqrt( Avar * Bvar );
 }
 
-double getTraceMean( vector < double > vA )
+double getTraceMean( const double* vA, unsigned int n )
 {
-    if( vA.size() == 0 )
+    if( n == 0 )
     {
         return 0.;
     }
     
     double N = 0;
-    for( unsigned int i = 0; i < vA.size(); i++ )
+    for( unsigned int i = 0; i < n; i++ )
     {
         N = N + vA[i];
     }
     
-    return N / double( vA.size() );
+    return N / double( n );
 }
 
-double getTraceVar( vector < double > vA, double Am )
+double getTraceVar( const double* vA, unsigned int n, double Am )
 {
     double N = 0;
-    for( unsigned int i = 0; i < vA.size(); i++ )
+    for( unsigned int i = 0; i < n; i++ )
     {
         N = N + ( vA[i] - Am ) * ( vA[i] - Am );
     }
@@ -3277,7 +3298,14 @@ void VImageCleaning::cleanImageTraceCorrelate( VImageCleaningRunParameter* iImag
     
     fData->setBorderCorrelationCoefficient( 0. );
     
-    vector < vector < double > > vImageTraces( fData->getDetectorGeo()->getNChannels( fData->getTelID() ), vector<double>( ( int )fData->getNSamples(), 0 ) );
+    // traces are read from the trace cache of this telescope
+    // (decoded already for the trace integration; no per-event copies)
+    VTraceCache* iTraceCache = fData->getTraceCache();
+    unsigned int nchannels = fData->getDetectorGeo()->getNChannels( fData->getTelID() );
+    unsigned int nsamples = fData->getNSamples();
+    vector< double > iZeroTrace( nsamples, 0. );
+    vector< const double* > vImageTraces( nchannels, iZeroTrace.data() );
+    vector< unsigned int > vImageTraceLength( nchannels, nsamples );
     
     unsigned int nhits = fData->getReader()->getNumChannelsHit();
     for( unsigned int i = 0; i < nhits; i++ )
@@ -3295,9 +3323,14 @@ void VImageCleaning::cleanImageTraceCorrelate( VImageCleaningRunParameter* iImag
                 fData->getTraceHandler()->setTrace( fData->getReader(), fData->getNSamples(),
                                                     fData->getPeds( fData->getHiLo()[i_channelHitID] )[i_channelHitID],
                                                     i_channelHitID, i,
-                                                    fData->getLowGainMultiplier_Trace()*fData->getHiLo()[i_channelHitID] );
-                                                    
-                vImageTraces[i_channelHitID] = fData->getTraceHandler()->getTrace();
+                                                    fData->getLowGainMultiplier_Trace()*fData->getHiLo()[i_channelHitID],
+                                                    iTraceCache );
+                if( i_channelHitID < nchannels && iTraceCache->getTrace( i_channelHitID )
+                        && iTraceCache->getTraceLength( i_channelHitID ) >= nsamples )
+                {
+                    vImageTraces[i_channelHitID] = iTraceCache->getTrace( i_channelHitID );
+                    vImageTraceLength[i_channelHitID] = iTraceCache->getTraceLength( i_channelHitID );
+                }
             }
         }
         catch( ... )
@@ -3313,7 +3346,7 @@ void VImageCleaning::cleanImageTraceCorrelate( VImageCleaningRunParameter* iImag
         
     }
     
-    if( vImageTraces.size() > 0 )
+    if( nchannels > 0 && nsamples > 0 )
     {
         vector < double > avepulse( fData->getNSamples(), 0 );
         vector < unsigned int > ImagePixelList;
@@ -3396,11 +3429,12 @@ void VImageCleaning::cleanImageTraceCorrelate( VImageCleaningRunParameter* iImag
                 
                 if( fData->getPedvars( fData->getCurrentSumWindow()[k], fData->getHiLo()[k] )[k] > 0. )
                 {
-                    double tMean = getTraceMean( vImageTraces[k] );
-                    double tVar = getTraceVar( vImageTraces[k], tMean );
+                    double tMean = getTraceMean( vImageTraces[k], vImageTraceLength[k] );
+                    double tVar = getTraceVar( vImageTraces[k], vImageTraceLength[k], tMean );
                     
                     
-                    double corv = getTraceCorrelationValue( AvePulseMean, tMean, AvePulseVar, tVar, avepulse, vImageTraces[k] );
+                    double corv = getTraceCorrelationValue( AvePulseMean, tMean, AvePulseVar, tVar,
+                                  &avepulse[0], vImageTraces[k], nsamples );
                     double sn = fData->getSums()[k] / fData->getPedvars( fData->getCurrentSumWindow()[k], fData->getHiLo()[k] )[k];
                     
                     // require that correlation coefficient and signal/noise is above certain thresholds
@@ -69,10 +69,14 @@ void VImageParameterCalculation::calcTimingParameters( bool iIsSecondPass )
         return;
     }
     
-    vector< double > xpos;
-    vector< double > t;
-    vector< double > et;
-    vector< bool > usePoint;
+    vector< double >& xpos = fTimeFitX;
+    vector< double >& t = fTimeFitT;
+    vector< double >& et = fTimeFitE;
+    vector< bool >& usePoint = fTimeFitUse;
+    xpos.clear();
+    t.clear();
+    et.clear();
+    usePoint.clear();
     double i_xmin = 1.e99;
     double i_xmax = -1.e99;
     // get average pulse times
@@ -148,17 +152,12 @@ void VImageParameterCalculation::calcTimingParameters( bool iIsSecondPass )
     // find and remove outliers
     if( xpos.size() > 9 && i_xmin < i_xmax )
     {
-        TH1F h( "houtlier", "", 100, i_xmin, i_xmax );
-        for( unsigned int i = 0; i < xpos.size(); i++ )
-        {
-            h.Fill( xpos[i] );
-        }
-        double i_a[] = { 0.25, 0.75 };
-        double i_b[] = { 0.00, 0.00 };
-        h.GetQuantiles( 2, i_b, i_a );
-        double iqr = i_b[1] - i_b[0];
-        double i_limin_min = i_b[0] - 1.5 * iqr;
-        double i_limin_max = i_b[1] + 1.5 * iqr;
+        double i_q1 = 0.;
+        double i_q3 = 0.;
+        getTimeFitQuartiles( i_xmin, i_xmax, i_q1, i_q3 );
+        double iqr = i_q3 - i_q1;
+        double i_limin_min = i_q1 - 1.5 * iqr;
+        double i_limin_max = i_q3 + 1.5 * iqr;
         for( unsigned int i = 0; i < xpos.size(); i++ )
         {
             if( xpos[i] < i_limin_min )
@@ -214,40 +213,39 @@ void VImageParameterCalculation::calcTimingParameters( bool iIsSecondPass )
         if( nclean > 2 )
         {
             // Fill the graphs for long (x) short(y) and radial (r) axis
+            // (graph is used for display and as starting value for the LL fit)
             int z = 0;
+            fTimeGradientFit.clear();
             for( unsigned int i = 0; i < xpos.size(); i++ )
             {
                 if( usePoint[i] )
                 {
                     xgraph->SetPoint( z, xpos[i], t[i] );
                     xgraph->SetPointError( z, 0., et[i] );
+                    fTimeGradientFit.addPoint( xpos[i], t[i], et[i] );
                     z++;
                 }
             }
-            // ignore all the clutter from the tgraph fitting algorithm
-            gErrorIgnoreLevel = 5000;
-            // robust fitting for larger images
+            // straight line fit (replaces xgraph->Fit( "pol1" ) )
+            // robust fitting (least trimmed squares) for larger images
             // (only for first pass, which is relevant for the window placement)
-            // robust fitting seems to be unstable for >1000 points
             if( z > 9 && z < 1000 && !iIsSecondPass )
             {
-                xgraph->Fit( "pol1", "rob Q" );
+                fTimeGradientFit.fitRobust();
             }
             else
             {
-                xgraph->Fit( "pol1", "Q" );
+                fTimeGradientFit.fit();
             }
             
-            TF1* xline = xgraph->GetFunction( "pol1" );
-            
-            gErrorIgnoreLevel = 0;
-            
             // fill fit results
-            fParGeo->tint_x   = xline->GetParameter( 0 );
-            fParGeo->tgrad_x  = xline->GetParameter( 1 );
-            fParGeo->tint_dx  = xline->GetParError( 0 );
-            fParGeo->tgrad_dx = xline->GetParError( 1 );
-            fParGeo->tchisq_x = xline->GetChisquare();
+            // (robust fit: parameters and errors of the least-squares fit to the
+            //  points kept by the LTS selection, chi2 for all points)
+            fParGeo->tint_x   = fTimeGradientFit.getIntercept();
+            fParGeo->tgrad_x  = fTimeGradientFit.getSlope();
+            fParGeo->tint_dx  = fTimeGradientFit.getInterceptError();
+            fParGeo->tgrad_dx = fTimeGradientFit.getSlopeError();
+            fParGeo->tchisq_x = fTimeGradientFit.getChi2();
             if( nclean > 0. )
             {
                 fParGeo->tmean = fParGeo->tmean / nclean;
@@ -273,6 +271,69 @@ void VImageParameterCalculation::calcTimingParameters( bool iIsSecondPass )
     fboolCalcTiming = true;
 }
 
+/*
+ * first and third quartile of the pixel positions along the major axis
+ *
+ * (from a distribution with 100 bins between i_xmin and i_xmax,
+ *  calculated as TH1::GetQuantiles; points at i_xmax are in the overflow)
+ */
+void VImageParameterCalculation::getTimeFitQuartiles( double i_xmin, double i_xmax, double& q1, double& q3 )
+{
+    const unsigned int nbins = 100;
+    fTimeFitXDistribution.assign( nbins + 1, 0. );
+    double i_scale = ( double )nbins / ( i_xmax - i_xmin );
+    for( unsigned int i = 0; i < fTimeFitX.size(); i++ )
+    {
+        if( fTimeFitX[i] >= i_xmin && fTimeFitX[i] < i_xmax )
+        {
+            unsigned int iBin = ( unsigned int )( ( fTimeFitX[i] - i_xmin ) * i_scale );
+            if( iBin >= nbins )
+            {
+                iBin = nbins - 1;
+            }
+            fTimeFitXDistribution[iBin + 1]++;
+        }
+    }
+    // normalised cumulative distribution
+    for( unsigned int i = 1; i <= nbins; i++ )
+    {
+        fTimeFitXDistribution[i] += fTimeFitXDistribution[i - 1];
+    }
+    q1 = i_xmin;
+    q3 = i_xmin;
+    if( fTimeFitXDistribution[nbins] <= 0. )
+    {
+        return;
+    }
+    for( unsigned int i = 1; i <= nbins; i++ )
+    {
+        fTimeFitXDistribution[i] /= fTimeFitXDistribution[nbins];
+    }
+    double i_prob[] = { 0.25, 0.75 };
+    double i_q[] = { 0., 0. };
+    double i_width = ( i_xmax - i_xmin ) / ( double )nbins;
+    for( unsigned int q = 0; q < 2; q++ )
+    {
+        // last bin with integral <= probability
+        unsigned int iBin = 0;
+        for( unsigned int i = 0; i < nbins; i++ )
+        {
+            if( fTimeFitXDistribution[i] <= i_prob[q] )
+            {
+                iBin = i;
+            }
+        }
+        i_q[q] = i_xmin + iBin * i_width;
+        double dI = fTimeFitXDistribution[iBin + 1] - fTimeFitXDistribution[iBin];
+        if( dI > 0. )
+        {
+            i_q[q] += i_width * ( i_prob[q] - fTimeFitXDistribution[iBin] ) / dI;
+        }
+    }
+    q1 = i_q[0];
+    q3 = i_q[1];
+}
+
 /*****************************************************************************
 muonRingFinder
 input: pointer to pixels passing cleaning
@@ -921,23 +982,6 @@ void VImageParameterCalculation::calcParameters()
         exit( EXIT_FAILURE );
     }
     
-    double sumsig = 0;
-    double sumsig_2 = 0.;
-    double sumxsig = 0;
-    double sumysig = 0;
-    double sumx2sig = 0;
-    double sumy2sig = 0;
-    double sumxysig = 0;
-    double sumx3sig = 0;
-    double sumy3sig = 0;
-    double sumx2ysig = 0;
-    double sumxy2sig = 0;
-    int pntubes = 0;
-    int pntubesBrightNoImage = 0;
-    double sumOuterRing = 0.;                     // sum signal of image in outer ring
-    double sumDeadRing = 0.;                      // sum signal of image ring around dead pixel
-    double sumLowGain = 0.;
-    
     // calculate mean ped and pedvar
     fParGeo->fmeanPed_Image = 0.;
     fParGeo->fmeanPedvar_Image = 0.;
@@ -945,20 +989,20 @@ void VImageParameterCalculation::calcParameters()
     if( fData->hasFADCData() )
     {
         double nPixPed = 0.;
-        for( unsigned int j = 0; j < fData->getImageBorderNeighbour().size(); j++ )
+        const vector< bool >& i_ImageBorderNeighbour = fData->getImageBorderNeighbour();
+        valarray< double >& i_Peds = fData->getPeds();
+        valarray< double >& i_Pedvars = fData->getPedvars( fData->getSumWindow() );
+        for( unsigned int j = 0; j < i_ImageBorderNeighbour.size(); j++ )
         {
-            if( fData->getImageBorderNeighbour()[j] )
+            if( i_ImageBorderNeighbour[j] )
             {
                 // mean ped and pedvar over image
-                if( fData )
+                if( j < i_Peds.size() )
                 {
-                    if( j < fData->getPeds().size() )
-                    {
-                        fParGeo->fmeanPed_Image += fData->getPeds()[j];
-                        fParGeo->fmeanPedvar_Image += fData->getPedvars( fData->getSumWindow() )[j];
-                    }
-                    nPixPed++;
+                    fParGeo->fmeanPed_Image += i_Peds[j];
+                    fParGeo->fmeanPedvar_Image += i_Pedvars[j];
                 }
+                nPixPed++;
             }
         }
         if( nPixPed > 0 )
@@ -984,85 +1028,103 @@ void VImageParameterCalculation::calcParameters()
     // calculate image parameters
     /////////////////////////////////////////
     
-    setImageBorderPixelPosition( fParGeo );
+    // compacted list of image/border pixels
+    fillImagePixelList();
+    const unsigned int nImagePixel = fImagePixelList.size();
     
-    // loop over all pixels
-    for( unsigned int j = 0; j < fData->getSums().size(); j++ )
+    // image/border pixel positions
+    vector< float > i_ImageBorderPixel_x( nImagePixel, 0. );
+    vector< float > i_ImageBorderPixel_y( nImagePixel, 0. );
+    for( unsigned int k = 0; k < nImagePixel; k++ )
     {
-        if( fData->getBrightNonImage()[j] )
-        {
-            pntubesBrightNoImage++;
-        }
-        
-        // loop over image tubes
-        // select image or border pixel
-        if( fData->getImage()[j] || fData->getBorder()[j] )
+        i_ImageBorderPixel_x[k] = fImagePixelX[k];
+        i_ImageBorderPixel_y[k] = fImagePixelY[k];
+    }
+    fParGeo->setImageBorderPixelPosition( i_ImageBorderPixel_x, i_ImageBorderPixel_y );
+    
+    const vector< bool >& i_BrightNonImage = fData->getBrightNonImage();
+    int pntubes = ( int )nImagePixel;
+    int pntubesBrightNoImage = ( int )count( i_BrightNonImage.begin(), i_BrightNonImage.end(), true );
+    
+    // moments and auxiliary sums in one pass over the gathered pixel data
+    // (independent partial sums per lane; padded entries have zero signal)
+    const unsigned int W = fMomentLanes;
+    double l_sig[W], l_sig_2[W], l_xsig[W], l_ysig[W], l_x2sig[W], l_y2sig[W], l_xysig[W];
+    double l_x3sig[W], l_y3sig[W], l_x2ysig[W], l_xy2sig[W], l_OuterRing[W], l_DeadRing[W], l_LowGain[W];
+    for( unsigned int l = 0; l < W; l++ )
+    {
+        l_sig[l] = l_sig_2[l] = l_xsig[l] = l_ysig[l] = l_x2sig[l] = l_y2sig[l] = l_xysig[l] = 0.;
+        l_x3sig[l] = l_y3sig[l] = l_x2ysig[l] = l_xy2sig[l] = l_OuterRing[l] = l_DeadRing[l] = l_LowGain[l] = 0.;
+    }
+    const double* p_x = fImagePixelX.data();
+    const double* p_y = fImagePixelY.data();
+    const double* p_s = fImagePixelSignal.data();
+    const double* p_s2 = fImagePixelSignal2.data();
+    const double* p_outer = fImagePixelOuterRing.data();
+    const double* p_dead = fImagePixelDeadRing.data();
+    const double* p_low = fImagePixelLowGain.data();
+    for( unsigned int k = 0; k < fImagePixelSignal.size(); k += W )
+    {
+        for( unsigned int l = 0; l < W; l++ )
         {
-            pntubes += 1;
+            const double xi = p_x[k + l];
+            const double yi = p_y[k + l];
+            const double si = p_s[k + l];
             
-            double xi = getDetectorGeometry()->getX()[j];
-            double yi = getDetectorGeometry()->getY()[j];
-            
-            double si = ( double )fData->getSums()[j]; // charge (dc)
-            double si2 = ( double )fData->getSums2()[j];
-            // image weighting with squared intensity
-            // (non standard from traditional image calculation!)
-            if( fData->getRunParameter() && fData->getRunParameter()->fSquaredImageCalculation )
-            {
-                si *= si;
-                si2 *= si2;
-            }
-            sumsig += si;
-            sumsig_2 += si2;
-            // sum in outer ring
-            if( getDetectorGeometry()->isEdgePixel()[j] )
-            {
-                sumOuterRing += si;
-            }
-            // sum around dead pixels
-            if( j < getDetectorGeometry()->getNeighbours().size() || getDetectorGeometry()->getNNeighbours()[j] < getDetectorGeometry()->getMaxNeighbour() )
-            {
-                bool iDead = false;
-                for( unsigned int n = 0; n < getDetectorGeometry()->getNeighbours()[j].size(); n++ )
-                {
-                    unsigned int k = getDetectorGeometry()->getNeighbours()[j][n];
-                    if( k < fData->getDead().size() && fData->getDead( k, fData->getHiLo()[k] ) )
-                    {
-                        sumDeadRing += si;
-                        iDead = true;
-                        break;              // each pixel should only be added once
-                    }
-                }
-                if( !iDead && getDetectorGeometry()->getNNeighbours()[j] < getDetectorGeometry()->getMaxNeighbour() )
-                {
-                    sumDeadRing += si;
-                }
-            }
-            if( fData->getHiLo()[j] )
-            {
-                sumLowGain += si2;
-            }
+            l_sig[l] += si;
+            l_sig_2[l] += p_s2[k + l];
+            l_OuterRing[l] += si * p_outer[k + l];
+            l_DeadRing[l] += si * p_dead[k + l];
+            l_LowGain[l] += p_s2[k + l] * p_low[k + l];
             
             const double sixi = si * xi;
             const double siyi = si * yi;
-            
-            sumxsig += sixi;
-            sumysig += siyi;
+            l_xsig[l] += sixi;
+            l_ysig[l] += siyi;
             
             const double sixi2 = sixi * xi;
             const double siyi2 = siyi * yi;
-            const double sixiyi = sixi * yi;
+            l_x2sig[l] += sixi2;
+            l_y2sig[l] += siyi2;
+            l_xysig[l] += sixi * yi;
             
-            sumx2sig += sixi2;
-            sumy2sig += siyi2;
-            sumxysig += sixiyi;
-            
-            sumx3sig += sixi2 * xi;
-            sumy3sig += siyi2 * yi;
-            sumx2ysig += sixi2 * yi;
-            sumxy2sig += siyi2 * xi;
+            l_x3sig[l] += sixi2 * xi;
+            l_y3sig[l] += siyi2 * yi;
+            l_x2ysig[l] += sixi2 * yi;
+            l_xy2sig[l] += siyi2 * xi;
         }
     }
+    double sumsig = 0;
+    double sumsig_2 = 0.;
+    double sumxsig = 0;
+    double sumysig = 0;
+    double sumx2sig = 0;
+    double sumy2sig = 0;
+    double sumxysig = 0;
+    double sumx3sig = 0;
+    double sumy3sig = 0;
+    double sumx2ysig = 0;
+    double sumxy2sig = 0;
+    double sumOuterRing = 0.;                     // sum signal of image in outer ring
+    double sumDeadRing = 0.;                      // sum signal of image ring around dead pixel
+    double sumLowGain = 0.;
+    for( unsigned int l = 0; l < W; l++ )
+    {
+        sumsig += l_sig[l];
+        sumsig_2 += l_sig_2[l];
+        sumxsig += l_xsig[l];
+        sumysig += l_ysig[l];
+        sumx2sig += l_x2sig[l];
+        sumy2sig += l_y2sig[l];
+        sumxysig += l_xysig[l];
+        sumx3sig += l_x3sig[l];
+        sumy3sig += l_y3sig[l];
+        sumx2ysig += l_x2ysig[l];
+        sumxy2sig += l_xy2sig[l];
+        sumOuterRing += l_OuterRing[l];
+        sumDeadRing += l_DeadRing[l];
+        sumLowGain += l_LowGain[l];
+    }
     if( fDebug )
     {
         cout << "VImageParameterCalculation::calcParameters: ";
@@ -1100,27 +1162,28 @@ void VImageParameterCalculation::calcParameters()
     i_index[1] = 0;
     i_index[2] = 0;
     
-    for( unsigned int i = 0; i < fData->getSums().size(); i++ )
+    valarray< double >& i_Sums = fData->getSums();
+    for( unsigned int i = 0; i < i_Sums.size(); i++ )
     {
-        if( fData->getSums()[i] > i_max[0] )
+        if( i_Sums[i] > i_max[0] )
         {
             i_max[2] = i_max[1];
             i_max[1] = i_max[0];
-            i_max[0] = fData->getSums()[i];
+            i_max[0] = i_Sums[i];
             i_index[2] = i_index[1];
             i_index[1] = i_index[0];
             i_index[0] = i;
         }
-        else if( fData->getSums()[i] > i_max[1] )
+        else if( i_Sums[i] > i_max[1] )
         {
             i_max[2] = i_max[1];
-            i_max[1] = fData->getSums()[i];
+            i_max[1] = i_Sums[i];
             i_index[2] = i_index[1];
             i_index[1] = i;
         }
-        else if( fData->getSums()[i] > i_max[2] )
+        else if( i_Sums[i] > i_max[2] )
         {
-            i_max[2] = fData->getSums()[i];
+            i_max[2] = i_Sums[i];
             i_index[2] = i;
         }
     }
@@ -1463,6 +1526,108 @@ double VImageParameterCalculation::getFractionOfImageBorderPixelUnderImage( doub
 }
 
 
+/*
+ * compacted list of image/border pixels with gathered positions, signals and
+ * flags (outer ring, next to dead pixel, low gain)
+ *
+ * (list is padded with zero-signal entries to a multiple of fMomentLanes)
+ */
+void VImageParameterCalculation::fillImagePixelList()
+{
+    fImagePixelList.clear();
+    fImagePixelX.clear();
+    fImagePixelY.clear();
+    fImagePixelSignal.clear();
+    fImagePixelSignal2.clear();
+    fImagePixelOuterRing.clear();
+    fImagePixelDeadRing.clear();
+    fImagePixelLowGain.clear();
+    
+    if( !fData || !getDetectorGeometry() )
+    {
+        return;
+    }
+    
+    const vector< bool >& i_Image = fData->getImage();
+    const vector< bool >& i_Border = fData->getBorder();
+    const vector< bool >& i_HiLo = fData->getHiLo();
+    valarray< double >& i_Sums = fData->getSums();
+    valarray< double >& i_Sums2 = fData->getSums2();
+    vector< float >& i_X = getDetectorGeometry()->getX();
+    vector< float >& i_Y = getDetectorGeometry()->getY();
+    vector< bool >& i_EdgePixel = getDetectorGeometry()->isEdgePixel();
+    vector< vector< int > >& i_Neighbours = getDetectorGeometry()->getNeighbours();
+    vector< unsigned int >& i_NNeighbours = getDetectorGeometry()->getNNeighbours();
+    unsigned int i_MaxNeighbour = getDetectorGeometry()->getMaxNeighbour();
+    bool i_Squared = ( fData->getRunParameter() && fData->getRunParameter()->fSquaredImageCalculation );
+    
+    unsigned int n = i_Sums.size();
+    if( i_Image.size() < n )
+    {
+        n = i_Image.size();
+    }
+    if( i_Border.size() < n )
+    {
+        n = i_Border.size();
+    }
+    for( unsigned int j = 0; j < n; j++ )
+    {
+        if( !i_Image[j] && !i_Border[j] )
+        {
+            continue;
+        }
+        fImagePixelList.push_back( j );
+        fImagePixelX.push_back( i_X[j] );
+        fImagePixelY.push_back( i_Y[j] );
+        
+        double si = i_Sums[j];                     // charge (dc)
+        double si2 = i_Sums2[j];
+        // image weighting with squared intensity
+        // (non standard from traditional image calculation!)
+        if( i_Squared )
+        {
+            si *= si;
+            si2 *= si2;
+        }
+        fImagePixelSignal.push_back( si );
+        fImagePixelSignal2.push_back( si2 );
+        fImagePixelOuterRing.push_back( i_EdgePixel[j] ? 1. : 0. );
+        
+        // pixels around dead pixels (each pixel should only be added once)
+        double i_dead = 0.;
+        if( j < i_Neighbours.size() || i_NNeighbours[j] < i_MaxNeighbour )
+        {
+            for( unsigned int k = 0; k < i_Neighbours[j].size(); k++ )
+            {
+                unsigned int c = i_Neighbours[j][k];
+                if( c < fData->getDead().size() && fData->getDead( c, i_HiLo[c] ) )
+                {
+                    i_dead = 1.;
+                    break;
+                }
+            }
+            if( i_NNeighbours[j] < i_MaxNeighbour )
+            {
+                i_dead = 1.;
+            }
+        }
+        fImagePixelDeadRing.push_back( i_dead );
+        fImagePixelLowGain.push_back( i_HiLo[j] ? 1. : 0. );
+    }
+    // padding
+    while( fImagePixelSignal.size() % fMomentLanes != 0 )
+    {
+        fImagePixelX.push_back( 0. );
+        fImagePixelY.push_back( 0. );
+        fImagePixelSignal.push_back( 0. );
+        fImagePixelSignal2.push_back( 0. );
+        fImagePixelOuterRing.push_back( 0. );
+        fImagePixelDeadRing.push_back( 0. );
+        fImagePixelLowGain.push_back( 0. );
+    }
+}
+
+
 void VImageParameterCalculation::setImageBorderPixelPosition( VImageParameter* iPar )
 {
     if( fData && iPar )
@@ -0,0 +1,211 @@
+/*! \class VImageParameterSparseTree
+    \brief image parameters of all telescopes in one tree
+    
+    alternative output layout to the tpars trees (one tree per telescope):
+    one entry per event (same number of entries as showerpars tree),
+    parameters are stored as variable-length arrays for telescopes with
+    images only (ntubes > 0)
+    
+    contains the image parameters used in the lookup table analysis
+    (see Ctpars); written with command line option -sparseimagetree
+
+*/
+
+#include "VImageParameterSparseTree.h"
+
+VImageParameterSparseTree::VImageParameterSparseTree( unsigned int iShortTree, bool iWritePixelList )
+{
+    fTree = 0;
+    fShortTree = iShortTree;
+    fWritePixelList = iWritePixelList;
+    
+    newEvent();
+}
+
+void VImageParameterSparseTree::initTree( string iName, string iTitle )
+{
+    fTree = new TTree( iName.c_str(), iTitle.c_str() );
+    fTree->SetMaxTreeSize( 1000 * Long64_t( 2000000000 ) );
+    fTree->SetAutoSave( 150000000 );               // autosave when 150 Mbytes written
+    
+    fTree->Branch( "NImages", &NImages, "NImages/i" );
+    fTree->Branch( "TelID", TelID, "TelID[NImages]/i" );
+    fTree->Branch( "eventStatus", eventStatus, "eventStatus[NImages]/i" );
+    if( fShortTree < 1 )
+    {
+        fTree->Branch( "meanPed_Image", meanPed_Image, "meanPed_Image[NImages]/F" );
+    }
+    fTree->Branch( "meanPedvar_Image", meanPedvar_Image, "meanPedvar_Image[NImages]/F" );
+    fTree->Branch( "cen_x", cen_x, "cen_x[NImages]/F" );
+    fTree->Branch( "cen_y", cen_y, "cen_y[NImages]/F" );
+    fTree->Branch( "f_d", f_d, "f_d[NImages]/F" );
+    fTree->Branch( "f_s", f_s, "f_s[NImages]/F" );
+    fTree->Branch( "f_sdevxy", f_sdevxy, "f_sdevxy[NImages]/F" );
+    fTree->Branch( "length", length, "length[NImages]/F" );
+    fTree->Branch( "width", width, "width[NImages]/F" );
+    fTree->Branch( "size", size, "size[NImages]/F" );
+    fTree->Branch( "size2", size2, "size2[NImages]/F" );
+    fTree->Branch( "loss", loss, "loss[NImages]/F" );
+    fTree->Branch( "fui", fui, "fui[NImages]/F" );
+    fTree->Branch( "fracLow", fracLow, "fracLow[NImages]/F" );
+    fTree->Branch( "dist", dist, "dist[NImages]/F" );
+    if( fShortTree < 1 )
+    {
+        fTree->Branch( "alpha", alpha, "alpha[NImages]/F" );
+        fTree->Branch( "los", los, "los[NImages]/F" );
+        fTree->Branch( "phi", phi, "phi[NImages]/F" );
+    }
+    fTree->Branch( "cosphi", cosphi, "cosphi[NImages]/F" );
+    fTree->Branch( "sinphi", sinphi, "sinphi[NImages]/F" );
+    fTree->Branch( "ntubes", ntubes, "ntubes[NImages]/s" );
+    fTree->Branch( "nsat", nsat, "nsat[NImages]/s" );
+    fTree->Branch( "nlowgain", nlowgain, "nlowgain[NImages]/s" );
+    if( fShortTree < 1 )
+    {
+        fTree->Branch( "ntubesBNI", ntubesBNI, "ntubesBNI[NImages]/s" );
+        fTree->Branch( "max", max, "max[NImages][3]/F" );
+        fTree->Branch( "index_of_max", index_of_max, "index_of_max[NImages][3]/s" );
+    }
+    fTree->Branch( "asymmetry", asymmetry, "asymmetry[NImages]/F" );
+    fTree->Branch( "bad", bad, "bad[NImages]/s" );
+    fTree->Branch( "badLow", badLow, "badLow[NImages]/s" );
+    fTree->Branch( "tgrad_x", tgrad_x, "tgrad_x[NImages]/F" );
+    if( fShortTree < 1 )
+    {
+        fTree->Branch( "tchisq_x", tchisq_x, "tchisq_x[NImages]/F" );
+    }
+    fTree->Branch( "Fitstat", Fitstat, "Fitstat[NImages]/I" );
+    fTree->Branch( "dcen_x", dcen_x, "dcen_x[NImages]/F" );
+    fTree->Branch( "dcen_y", dcen_y, "dcen_y[NImages]/F" );
+    fTree->Branch( "dlength", dlength, "dlength[NImages]/F" );
+    fTree->Branch( "dwidth", dwidth, "dwidth[NImages]/F" );
+    fTree->Branch( "dphi", dphi, "dphi[NImages]/F" );
+    
+    // image / border pixel list
+    // (buffers grow with the number of pixels; branch addresses are updated in fill())
+    if( fWritePixelList )
+    {
+        PixelID.resize( VDST_MAXCHANNELS, 0 );
+        PixelType.resize( VDST_MAXCHANNELS, 0 );
+        PixelIntensity.resize( VDST_MAXCHANNELS, 0. );
+        PixelTimingT0.resize( VDST_MAXCHANNELS, 0. );
+        PixelPE.resize( VDST_MAXCHANNELS, 0. );
+        fTree->Branch( "PixelListN", PixelListN, "PixelListN[NImages]/i" );
+        fTree->Branch( "PixelListNPixelNN", &PixelListNPixelNN, "PixelListNPixelNN/i" );
+        fTree->Branch( "PixelID", &PixelID[0], "PixelID[PixelListNPixelNN]/i" );
+        fTree->Branch( "PixelType", &PixelType[0], "PixelType[PixelListNPixelNN]/i" );
+        fTree->Branch( "PixelIntensity", &PixelIntensity[0], "PixelIntensity[PixelListNPixelNN]/F" );
+        fTree->Branch( "PixelTimingT0", &PixelTimingT0[0], "PixelTimingT0[PixelListNPixelNN]/F" );
+        fTree->Branch( "PixelPE", &PixelPE[0], "PixelPE[PixelListNPixelNN]/F" );
+    }
+}
+
+void VImageParameterSparseTree::newEvent()
+{
+    NImages = 0;
+    PixelListNPixelNN = 0;
+    fEventAnalyzed = false;
+}
+
+/*
+ * add image parameters of this telescope to the current event
+ *
+ * (to be called for each analyzed telescope; only images with ntubes > 0 are stored)
+ */
+void VImageParameterSparseTree::addTelescope( unsigned int iTelID, VImageParameter* iPar )
+{
+    fEventAnalyzed = true;
+    if( !iPar || iPar->ntubes == 0 || NImages >= VDST_MAXTELESCOPES )
+    {
+        return;
+    }
+    unsigned int i = NImages;
+    TelID[i] = iTelID;
+    eventStatus[i] = iPar->eventStatus;
+    meanPed_Image[i] = iPar->fmeanPed_Image;
+    meanPedvar_Image[i] = iPar->fmeanPedvar_Image;
+    cen_x[i] = iPar->cen_x;
+    cen_y[i] = iPar->cen_y;
+    f_d[i] = iPar->f_d;
+    f_s[i] = iPar->f_s;
+    f_sdevxy[i] = iPar->f_sdevxy;
+    length[i] = iPar->length;
+    width[i] = iPar->width;
+    size[i] = iPar->size;
+    size2[i] = iPar->size2;
+    loss[i] = iPar->loss;
+    fui[i] = iPar->fui;
+    fracLow[i] = iPar->fracLow;
+    dist[i] = iPar->dist;
+    alpha[i] = iPar->alpha;
+    los[i] = iPar->los;
+    phi[i] = iPar->phi;
+    cosphi[i] = iPar->cosphi;
+    sinphi[i] = iPar->sinphi;
+    ntubes[i] = iPar->ntubes;
+    ntubesBNI[i] = iPar->ntubesBrightNoImage;
+    nsat[i] = iPar->nsat;
+    nlowgain[i] = iPar->nlowgain;
+    bad[i] = iPar->bad;
+    badLow[i] = iPar->badLow;
+    for( unsigned int j = 0; j < 3; j++ )
+    {
+        max[i][j] = iPar->max[j];
+        index_of_max[i][j] = iPar->index_of_max[j];
+    }
+    asymmetry[i] = iPar->asymmetry;
+    tgrad_x[i] = iPar->tgrad_x;
+    tchisq_x[i] = iPar->tchisq_x;
+    Fitstat[i] = iPar->Fitstat;
+    dcen_x[i] = iPar->dcen_x;
+    dcen_y[i] = iPar->dcen_y;
+    dlength[i] = iPar->dlength;
+    dwidth[i] = iPar->dwidth;
+    dphi[i] = iPar->dphi;
+    
+    if( fWritePixelList )
+    {
+        PixelListN[i] = iPar->PixelListN;
+        if( PixelListNPixelNN + iPar->PixelListN > PixelID.size() )
+        {
+            unsigned int n = PixelID.size() + VDST_MAXCHANNELS;
+            PixelID.resize( n, 0 );
+            PixelType.resize( n, 0 );
+            PixelIntensity.resize( n, 0. );
+            PixelTimingT0.resize( n, 0. );
+            PixelPE.resize( n, 0. );
+        }
+        for( unsigned int p = 0; p < iPar->PixelListN; p++ )
+        {
+            PixelID[PixelListNPixelNN + p] = iPar->PixelID[p];
+            PixelType[PixelListNPixelNN + p] = iPar->PixelType[p];
+            PixelIntensity[PixelListNPixelNN + p] = iPar->PixelIntensity[p];
+            PixelTimingT0[PixelListNPixelNN + p] = iPar->PixelTimingT0[p];
+            PixelPE[PixelListNPixelNN + p] = iPar->PixelPE[p];
+        }
+        PixelListNPixelNN += iPar->PixelListN;
+    }
+    NImages++;
+}
+
+/*
+ * fill current event into the tree
+ * (events without any analyzed telescope are not filled, as for the tpars trees)
+ */
+void VImageParameterSparseTree::fill()
+{
+    if( !fTree || !fEventAnalyzed )
+    {
+        return;
+    }
+    if( fWritePixelList )
+    {
+        fTree->SetBranchAddress( "PixelID", &PixelID[0] );
+        fTree->SetBranchAddress( "PixelType", &PixelType[0] );
+        fTree->SetBranchAddress( "PixelIntensity", &PixelIntensity[0] );
+        fTree->SetBranchAddress( "PixelTimingT0", &PixelTimingT0[0] );
+        fTree->SetBranchAddress( "PixelPE", &PixelPE[0] );
+    }
+    fTree->Fill();
+    newEvent();
+}
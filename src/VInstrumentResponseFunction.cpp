@@ -6,6 +6,9 @@
 
 #include "VInstrumentResponseFunction.h"
 
+#include <atomic>
+#include <thread>
+
 VInstrumentResponseFunction::VInstrumentResponseFunction()
 {
     fDebug = false;
@@ -16,6 +19,7 @@ VInstrumentResponseFunction::VInstrumentResponseFunction()
     fOutputFile = 0;
     
     fData = 0;
+    fRunPara = 0;
     fEnergyReconstructionMethod = 0;
     
     fSpectralWeight = new VSpectralWeight();
@@ -192,7 +196,7 @@ bool VInstrumentResponseFunction::fillEventData()
     ///////////////////////////////////
     // get full data set
     ///////////////////////////////////
-    Long64_t d_nentries = fData->fChain->GetEntries();
+    Long64_t d_nentries = fData->getEntries();
     cout << "VInstrumentResponseFunction " << fName << " (" << fType << "): total number of data events: " << d_nentries << endl;
     for( Long64_t i = 0; i < d_nentries; i++ )
     {
@@ -316,6 +320,60 @@ bool VInstrumentResponseFunction::fillResolutionGraphs( vector< vector< VInstrum
     // fill resolution graphs
     cout << "VInstrumentResponseFunction::terminate ";
     cout << " (integration probability: " << fContainmentProbability << ")" << endl;
+    
+    // calculate containment values for all IRF objects and types in parallel
+    // (independent; graphs are filled afterwards in terminate())
+    vector< pair< VInstrumentResponseFunctionData*, unsigned int > > i_tasks;
+    for( unsigned int i = 0; i < fIRFData.size(); i++ )
+    {
+        for( unsigned int j = 0; j < fIRFData[i].size(); j++ )
+        {
+            if( fIRFData[i][j] )
+            {
+                for( unsigned int t = 0; t < fIRFData[i][j]->f2DHisto.size(); t++ )
+                {
+                    if( t != VInstrumentResponseFunctionData::E_RELA )
+                    {
+                        i_tasks.push_back( make_pair( fIRFData[i][j], t ) );
+                    }
+                }
+            }
+        }
+    }
+    unsigned int i_nthreads = 1;
+    if( fRunPara )
+    {
+        i_nthreads = fRunPara->fNThreads;
+    }
+    if( i_nthreads == 0 )
+    {
+        i_nthreads = thread::hardware_concurrency();
+    }
+    if( i_nthreads > i_tasks.size() )
+    {
+        i_nthreads = i_tasks.size();
+    }
+    if( i_nthreads > 1 )
+    {
+        atomic< unsigned int > iCounter( 0 );
+        vector< thread > i_threads;
+        for( unsigned int t = 0; t < i_nthreads; t++ )
+        {
+            i_threads.push_back( thread( [&]()
+            {
+                unsigned int n = 0;
+                while( ( n = iCounter++ ) < i_tasks.size() )
+                {
+                    i_tasks[n].first->calculateResolutionFromSamples( i_tasks[n].second, fContainmentProbability );
+                }
+            } ) );
+        }
+        for( unsigned int t = 0; t < i_threads.size(); t++ )
+        {
+            i_threads[t].join();
+        }
+    }
+    
     for( unsigned int i = 0; i < fIRFData.size(); i++ )
     {
         for( unsigned int j = 0; j < fIRFData[i].size(); j++ )
@@ -443,6 +501,24 @@ vector< TH2D* > VInstrumentResponseFunction::getAngularResolution2D( unsigned in
     return h;
 }
 
+/*
+ * release samples used for the calculation of containment values
+ * (call after all resolution graphs, including those of duplicated IRFs, are filled)
+ */
+void VInstrumentResponseFunction::clearSamples()
+{
+    for( unsigned int i = 0; i < fIRFData.size(); i++ )
+    {
+        for( unsigned int j = 0; j < fIRFData[i].size(); j++ )
+        {
+            if( fIRFData[i][j] )
+            {
+                fIRFData[i][j]->clearSamples();
+            }
+        }
+    }
+}
+
 void VInstrumentResponseFunction::setDuplicationID( unsigned int iID )
 {
     if( iID != 9999 )
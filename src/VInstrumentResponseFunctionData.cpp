@@ -1,13 +1,17 @@
 /*! \class VInstrumentResponseFunctionData
     \brief data class for instrumental response functions
 
-
+    containment values (e.g. 68% angular resolution) are calculated
+    from the unbinned samples of each energy bin (weighted selection);
+    errors from the order statistics of the samples
 
 */
 
 
 #include "VInstrumentResponseFunctionData.h"
 
+#include <algorithm>
+
 VInstrumentResponseFunctionData::VInstrumentResponseFunctionData()
 {
     fType = "";
@@ -414,6 +418,20 @@ bool VInstrumentResponseFunctionData::initialize( string iName, string iType, un
         fContainmentProbability.push_back( 0. );
     }
     
+    // samples for containment calculation
+    fSample.resize( f2DHisto.size() );
+    for( unsigned int i = 0; i < f2DHisto.size(); i++ )
+    {
+        if( i != E_RELA )
+        {
+            fSample[i].resize( f2DHisto[i]->GetNbinsX() );
+        }
+    }
+    fResolution_x.resize( f2DHisto.size() );
+    fResolution_y.resize( f2DHisto.size() );
+    fResolution_yE.resize( f2DHisto.size() );
+    fResolution_Probability.assign( f2DHisto.size(), -1. );
+    
     return true;
 }
 
@@ -523,50 +541,60 @@ void VInstrumentResponseFunctionData::fill( double iWeight )
     if( E_DIFF < f2DHisto.size() && f2DHisto[E_DIFF] )
     {
         f2DHisto[E_DIFF]->Fill( log10( iErec_lin ), iDiff, iWeight );
+        fillSample( E_DIFF, log10( iErec_lin ), iDiff, iWeight );
     }
     // difference vs true energy
     if( E_DIFF_MC < f2DHisto.size() && f2DHisto[E_DIFF_MC] )
     {
         f2DHisto[E_DIFF_MC]->Fill( log10( fData->MCe0 ), iDiff, iWeight );
+        fillSample( E_DIFF_MC, log10( fData->MCe0 ), iDiff, iWeight );
     }
     // squared difference vs energy
     if( E_DIFF2 < f2DHisto.size() && f2DHisto[E_DIFF2] )
     {
         f2DHisto[E_DIFF2]->Fill( log10( iErec_lin ), iDiff * iDiff, iWeight );
+        fillSample( E_DIFF2, log10( iErec_lin ), iDiff * iDiff, iWeight );
     }
     // squared difference vs true energy
     if( E_DIFF2_MC < f2DHisto.size() && f2DHisto[E_DIFF2_MC] )
     {
         f2DHisto[E_DIFF2_MC]->Fill( log10( fData->MCe0 ), iDiff * iDiff, iWeight );
+        fillSample( E_DIFF2_MC, log10( fData->MCe0 ), iDiff * iDiff, iWeight );
     }
     // log10 difference vs energy
     if( E_LOGDIFF < f2DHisto.size() && f2DHisto[E_LOGDIFF] && iDiff > 0. )
     {
         f2DHisto[E_LOGDIFF]->Fill( log10( iErec_lin ), log10( iDiff ), iWeight );
+        fillSample( E_LOGDIFF, log10( iErec_lin ), log10( iDiff ), iWeight );
     }
     // log10 difference vs true energy
     if( E_LOGDIFF_MC < f2DHisto.size() && f2DHisto[E_LOGDIFF_MC] && iDiff > 0. )
     {
         f2DHisto[E_LOGDIFF_MC]->Fill( log10( fData->MCe0 ), log10( iDiff ), iWeight );
+        fillSample( E_LOGDIFF_MC, log10( fData->MCe0 ), log10( iDiff ), iWeight );
     }
     
     // difference vs number of images
     if( E_NIMAG < f2DHisto.size() && f2DHisto[E_NIMAG] )
     {
         f2DHisto[E_NIMAG]->Fill( fData->getNImages(), iDiff, iWeight );
+        fillSample( E_NIMAG, fData->getNImages(), iDiff, iWeight );
     }
     
     // difference vs core distance
     if( E_DIST < f2DHisto.size() && f2DHisto[E_DIST] )
     {
-        f2DHisto[E_DIST]->Fill( sqrt( ( fData->MCxcore - fArrayCentre_X ) * ( fData->MCxcore - fArrayCentre_X ) +
-                                      ( fData->MCycore - fArrayCentre_Y ) * ( fData->MCycore - fArrayCentre_Y ) ), iDiff, iWeight );
+        double iDist = sqrt( ( fData->MCxcore - fArrayCentre_X ) * ( fData->MCxcore - fArrayCentre_X ) +
+                             ( fData->MCycore - fArrayCentre_Y ) * ( fData->MCycore - fArrayCentre_Y ) );
+        f2DHisto[E_DIST]->Fill( iDist, iDiff, iWeight );
+        fillSample( E_DIST, iDist, iDiff, iWeight );
     }
     
     // error vs energy
     if( E_ERROR < f2DHisto.size() && f2DHisto[E_ERROR] )
     {
         f2DHisto[E_ERROR]->Fill( log10( iErec_lin ), iError, iWeight );
+        fillSample( E_ERROR, log10( iErec_lin ), iError, iWeight );
     }
     
     // relative error vs energy
@@ -590,8 +618,25 @@ bool VInstrumentResponseFunctionData::terminate( double iContainmentProbability,
         fContainmentProbability[i] = iContainmentProbability;
         if( i != E_RELA )
         {
-            calculateResolution( f2DHisto[i], fResolutionGraph[i], f2DHisto[i]->GetName(),
-                                 iContainmentProbability );
+            // exact containment values from samples
+            // (possibly calculated already in parallel, see VInstrumentResponseFunction::fillResolutionGraphs)
+            if( i < fResolution_Probability.size()
+                    && ( fResolution_Probability[i] == iContainmentProbability
+                         || calculateResolutionFromSamples( i, iContainmentProbability ) ) )
+            {
+                fResolutionGraph[i]->Set( ( int )fResolution_x[i].size() );
+                for( unsigned int p = 0; p < fResolution_x[i].size(); p++ )
+                {
+                    fResolutionGraph[i]->SetPoint( p, fResolution_x[i][p], fResolution_y[i][p] );
+                    fResolutionGraph[i]->SetPointError( p, 0., fResolution_yE[i][p] );
+                }
+            }
+            // no samples available: use histograms
+            else
+            {
+                calculateResolution( f2DHisto[i], fResolutionGraph[i], f2DHisto[i]->GetName(),
+                                     iContainmentProbability );
+            }
         }
         // for relative plots get mean and spread from each bin in the histogram
         else
@@ -604,6 +649,156 @@ bool VInstrumentResponseFunctionData::terminate( double iContainmentProbability,
 }
 
 
+/*
+ * release memory of samples
+ * (containment values are calculated from histograms afterwards)
+ */
+void VInstrumentResponseFunctionData::clearSamples()
+{
+    vector< vector< vector< pair< float, float > > > >().swap( fSample );
+}
+
+/*
+ * store sample for containment calculation
+ *
+ * (only samples inside the histogram range are used, as for the histograms)
+ */
+void VInstrumentResponseFunctionData::fillSample( unsigned int iHistoID, double x, double y, double iWeight )
+{
+    if( iHistoID >= fSample.size() || iHistoID >= f2DHisto.size() || !f2DHisto[iHistoID] )
+    {
+        return;
+    }
+    int i_bin = f2DHisto[iHistoID]->GetXaxis()->FindFixBin( x );
+    if( i_bin < 1 || i_bin > ( int )fSample[iHistoID].size() )
+    {
+        return;
+    }
+    if( y < f2DHisto[iHistoID]->GetYaxis()->GetXmin() || y >= f2DHisto[iHistoID]->GetYaxis()->GetXmax() )
+    {
+        return;
+    }
+    fSample[iHistoID][i_bin - 1].push_back( make_pair( ( float )y, ( float )iWeight ) );
+}
+
+/*
+ * weighted quantile: smallest value with cumulative weight fraction > iProbability
+ *
+ * (weighted quickselect, expected linear time; reorders iSample)
+ */
+double VInstrumentResponseFunctionData::getWeightedQuantile( vector< pair< float, float > >& iSample,
+        double iTotalWeight, double iProbability )
+{
+    if( iSample.size() == 0 )
+    {
+        return 0.;
+    }
+    double i_target = iProbability * iTotalWeight;
+    double i_acc = 0.;
+    unsigned int lo = 0;
+    unsigned int hi = iSample.size();
+    while( hi - lo > 1 )
+    {
+        unsigned int mid = lo + ( hi - lo ) / 2;
+        nth_element( iSample.begin() + lo, iSample.begin() + mid, iSample.begin() + hi );
+        double i_wl = 0.;
+        for( unsigned int i = lo; i < mid; i++ )
+        {
+            i_wl += iSample[i].second;
+        }
+        if( i_acc + i_wl > i_target )
+        {
+            hi = mid;
+        }
+        else if( i_acc + i_wl + iSample[mid].second > i_target )
+        {
+            return iSample[mid].first;
+        }
+        else
+        {
+            i_acc += i_wl + iSample[mid].second;
+            lo = mid + 1;
+        }
+    }
+    if( lo >= iSample.size() )
+    {
+        return max_element( iSample.begin(), iSample.end() )->first;
+    }
+    return iSample[lo].first;
+}
+
+/*
+ * calculate containment values for all x bins from samples
+ *
+ * error from order statistics: half the distance between the quantiles at
+ * p +- sqrt( p(1-p)/n_eff ) (n_eff: effective number of weighted events)
+ *
+ * (no ROOT objects are modified; safe to call for different histogram IDs in parallel)
+ */
+bool VInstrumentResponseFunctionData::calculateResolutionFromSamples( unsigned int iHistoID, double iContainmentProbability )
+{
+    if( iHistoID >= fSample.size() || iHistoID >= f2DHisto.size() || !f2DHisto[iHistoID] || fSample[iHistoID].size() == 0 )
+    {
+        return false;
+    }
+    fResolution_x[iHistoID].clear();
+    fResolution_y[iHistoID].clear();
+    fResolution_yE[iHistoID].clear();
+    
+    for( unsigned int b = 0; b < fSample[iHistoID].size(); b++ )
+    {
+        vector< pair< float, float > >& v = fSample[iHistoID][b];
+        // require at least 20 events to calculate
+        // a good containment radius and error
+        if( v.size() <= 20 )
+        {
+            continue;
+        }
+        double i_w = 0.;
+        double i_w2 = 0.;
+        for( unsigned int i = 0; i < v.size(); i++ )
+        {
+            i_w  += v[i].second;
+            i_w2 += v[i].second * v[i].second;
+        }
+        if( i_w <= 0. || i_w2 <= 0. )
+        {
+            continue;
+        }
+        double i_res = getWeightedQuantile( v, i_w, iContainmentProbability );
+        // require at least 5 filled histogram bins up to the containment value
+        // (as for the calculation from histograms)
+        int i_resBin = f2DHisto[iHistoID]->GetYaxis()->FindFixBin( i_res );
+        vector< bool > i_filledBin( i_resBin + 1, false );
+        int iTempNBins = 0;
+        for( unsigned int i = 0; i < v.size(); i++ )
+        {
+            int j = f2DHisto[iHistoID]->GetYaxis()->FindFixBin( v[i].first );
+            if( j >= 0 && j <= i_resBin && !i_filledBin[j] )
+            {
+                i_filledBin[j] = true;
+                iTempNBins++;
+            }
+        }
+        if( iTempNBins <= 4 )
+        {
+            continue;
+        }
+        
+        double i_neff = i_w * i_w / i_w2;
+        double i_dp = sqrt( iContainmentProbability * ( 1. - iContainmentProbability ) / i_neff );
+        double i_low = getWeightedQuantile( v, i_w, TMath::Max( iContainmentProbability - i_dp, 0. ) );
+        double i_up  = getWeightedQuantile( v, i_w, TMath::Min( iContainmentProbability + i_dp, 1. ) );
+        
+        fResolution_x[iHistoID].push_back( f2DHisto[iHistoID]->GetXaxis()->GetBinCenter( b + 1 ) );
+        fResolution_y[iHistoID].push_back( i_res );
+        fResolution_yE[iHistoID].push_back( 0.5 * ( i_up - i_low ) );
+    }
+    fResolution_Probability[iHistoID] = iContainmentProbability;
+    
+    return true;
+}
+
 /*!
 
     calculate threshold (usually 68%) reconstruction accuracy from 2D histogram
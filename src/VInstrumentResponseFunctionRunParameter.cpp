@@ -8,6 +8,7 @@
 VInstrumentResponseFunctionRunParameter::VInstrumentResponseFunctionRunParameter()
 {
     fFillingMode = 0;
+    fNThreads = 0;
     fEffArea_short_writing = false;
     
     fInstrumentEpoch = "NOT_SET";
@@ -381,6 +382,14 @@ bool VInstrumentResponseFunctionRunParameter::readRunParameterFromTextFile( stri
                     is_stream >> fEffArea_short_writing;
                 }
             }
+            // number of threads used for the calculation of resolution curves (0 = all cores)
+            else if( temp == "NTHREADS" )
+            {
+                if( !( is_stream >> std::ws ).eof() )
+                {
+                    is_stream >> fNThreads;
+                }
+            }
             // read input data file name
             else if( temp == "SIMULATIONFILE_DATA" )
             {
@@ -7,6 +7,9 @@
 
 #include "VInterpolate2DHistos.h"
 
+#include <atomic>
+#include <thread>
+
 VInterpolate2DHistos::VInterpolate2DHistos( int iseed )
 {
     fRandom = new TRandom3( iseed );
@@ -204,8 +207,14 @@ TH2F* VInterpolate2DHistos::doLogLinearExtrapolation( TH2F* h, string iname, TH2
 /*
  *  Gaussian smoothing / interpolation
  *
+ *  each bin content is smeared with a Gaussian of width
+ *  nWidth / 2 x bin width and weighted with the number of
+ *  events in this bin (hNevents)
+ *
+ *  smoothed value is the weighted mean of all contributions
+ *  (calculated exactly using a separable convolution; nGausN
+ *  is not used anymore - results do not depend on random numbers)
  *
- *   **THIS IS UNTESTED AND SHOULD NOT BE USED**
 */
 TH2F* VInterpolate2DHistos::doGaussianInterpolation( TH2F* h, string iname, TH2F* hNevents, int nGausN, double nWidth )
 {
@@ -213,51 +222,210 @@ TH2F* VInterpolate2DHistos::doGaussianInterpolation( TH2F* h, string iname, TH2F
     {
         return 0;
     }
+    if( h->GetNbinsX() != hNevents->GetNbinsX() || h->GetNbinsY() != hNevents->GetNbinsY() )
+    {
+        cout << "VInterpolate2DHistos::doGaussianInterpolation error: inconsistent binning of ";
+        cout << h->GetName() << " and " << hNevents->GetName() << endl;
+        return 0;
+    }
     
     char hname[600];
     sprintf( hname, "%s_%s", h->GetName(), iname.c_str() );
     TH2F* hs = ( TH2F* )h->Clone( hname );
     
-    sprintf( hname, "%s_%s_%s", h->GetName(), iname.c_str(), "temp" );
-    TProfile2D h2D( hname, "", hs->GetNbinsX(), hs->GetXaxis()->GetXmin(), hs->GetXaxis()->GetXmax(),
-                    hs->GetNbinsY(), hs->GetYaxis()->GetXmin(), hs->GetYaxis()->GetXmax(),
-                    -100., 100. );
-                    
-    double x = 0.;
-    double y = 0.;
-    double xc = 0.;
-    double yc = 0.;
-    double z = 0.;
+    convolveGaussian( h, hNevents, nWidth, hs );
     
-    double xWidth = hs->GetXaxis()->GetBinWidth( 1 );
-    double yWidth = hs->GetYaxis()->GetBinWidth( 1 );
+    return hs;
+}
+
+/*
+ * Gaussian smoothing of several histograms
+ *
+ * (histograms are smoothed in parallel using iNThreads threads;
+ *  iNThreads = 0: use all available cores)
+ *
+ */
+vector< TH2F* > VInterpolate2DHistos::doGaussianInterpolation( vector< TH2F* > h, string iname, vector< TH2F* > hNevents,
+        double nWidth, unsigned int iNThreads )
+{
+    vector< TH2F* > hs( h.size(), ( TH2F* )0 );
+    if( h.size() != hNevents.size() )
+    {
+        cout << "VInterpolate2DHistos::doGaussianInterpolation error: inconsistent number of histograms ";
+        cout << h.size() << "\t" << hNevents.size() << endl;
+        return hs;
+    }
+    // histograms are created in the main thread
+    char hname[600];
+    for( unsigned int i = 0; i < h.size(); i++ )
+    {
+        if( !h[i] || !hNevents[i] )
+        {
+            continue;
+        }
+        if( h[i]->GetNbinsX() != hNevents[i]->GetNbinsX() || h[i]->GetNbinsY() != hNevents[i]->GetNbinsY() )
+        {
+            cout << "VInterpolate2DHistos::doGaussianInterpolation error: inconsistent binning of ";
+            cout << h[i]->GetName() << " and " << hNevents[i]->GetName() << endl;
+            continue;
+        }
+        sprintf( hname, "%s_%s", h[i]->GetName(), iname.c_str() );
+        hs[i] = ( TH2F* )h[i]->Clone( hname );
+    }
     
-    for( int i = 1; i <= hs->GetNbinsX(); i++ )
+    if( iNThreads == 0 )
+    {
+        iNThreads = thread::hardware_concurrency();
+    }
+    if( iNThreads > h.size() )
     {
-        xc = hs->GetXaxis()->GetBinCenter( i );
-        for( int j = 1; j <= hs->GetNbinsY(); j++ )
+        iNThreads = h.size();
+    }
+    if( iNThreads <= 1 )
+    {
+        for( unsigned int i = 0; i < hs.size(); i++ )
         {
-            yc = hs->GetYaxis()->GetBinCenter( j );
-            z  = hs->GetBinContent( i, j );
-            int n  = ( int )( hNevents->GetBinContent( i, j ) * nGausN );
-            
-            // loop over all bin entries
-            for( int k = 0; k < n; k++ )
+            if( hs[i] )
             {
-                x = fRandom->Gaus( xc, xWidth * nWidth / 2. );
-                y = fRandom->Gaus( yc, yWidth * nWidth / 2. );
-                h2D.Fill( x, y, z );
+                convolveGaussian( h[i], hNevents[i], nWidth, hs[i] );
             }
         }
+        return hs;
     }
     
-    // copy histograms
-    for( int i = 1; i <= hs->GetNbinsX(); i++ )
+    // smoothing works on bin arrays only: no locking needed
+    atomic< unsigned int > iCounter( 0 );
+    vector< thread > i_threads;
+    for( unsigned int t = 0; t < iNThreads; t++ )
     {
-        for( int j = 1; j <= hs->GetNbinsY(); j++ )
+        i_threads.push_back( thread( [&]()
         {
-            hs->SetBinContent( i, j, h2D.GetBinContent( i, j ) );
-        }
+            unsigned int i = 0;
+            while( ( i = iCounter++ ) < hs.size() )
+            {
+                if( hs[i] )
+                {
+                    convolveGaussian( h[i], hNevents[i], nWidth, hs[i] );
+                }
+            }
+        } ) );
     }
+    for( unsigned int t = 0; t < i_threads.size(); t++ )
+    {
+        i_threads[t].join();
+    }
+    
     return hs;
 }
+
+/*
+ * Gaussian kernel along one axis
+ *
+ * element [k*nbins+i] is the fraction of a Gaussian centred
+ * on bin k which falls into bin i (underflow and overflow
+ * are discarded)
+ *
+ */
+vector< double > VInterpolate2DHistos::getGaussianKernel( const TAxis* iAxis, double iSigma )
+{
+    int n = iAxis->GetNbins();
+    vector< double > iK( n * n, 0. );
+    for( int k = 0; k < n; k++ )
+    {
+        if( iSigma <= 0. )
+        {
+            iK[k * n + k] = 1.;
+            continue;
+        }
+        double c = iAxis->GetBinCenter( k + 1 );
+        for( int i = 0; i < n; i++ )
+        {
+            iK[k * n + i] = 0.5 * ( TMath::Erf( ( iAxis->GetBinUpEdge( i + 1 ) - c ) / ( TMath::Sqrt2() * iSigma ) )
+                                    - TMath::Erf( ( iAxis->GetBinLowEdge( i + 1 ) - c ) / ( TMath::Sqrt2() * iSigma ) ) );
+        }
+    }
+    return iK;
+}
+
+/*
+ * event-count-weighted Gaussian convolution of h
+ *
+ *    hs(i,j) = sum_kl w_kl h_kl Kx_ki Ky_lj / sum_kl w_kl Kx_ki Ky_lj
+ *
+ * (convolution in x first, then in y; w = hNevents)
+ *
+ */
+void VInterpolate2DHistos::convolveGaussian( const TH2F* h, const TH2F* hNevents, double nWidth, TH2F* hs )
+{
+    if( !h || !hNevents || !hs )
+    {
+        return;
+    }
+    const int nx = h->GetNbinsX();
+    const int ny = h->GetNbinsY();
+    
+    vector< double > Kx = getGaussianKernel( h->GetXaxis(), h->GetXaxis()->GetBinWidth( 1 ) * nWidth / 2. );
+    vector< double > Ky = getGaussianKernel( h->GetYaxis(), h->GetYaxis()->GetBinWidth( 1 ) * nWidth / 2. );
+    
+    // raw bin arrays (including under- and overflow bins)
+    const Float_t* v = h->GetArray();
+    const Float_t* w = hNevents->GetArray();
+    Float_t* s = hs->GetArray();
+    
+    // convolution along x
+    vector< double > iNum( nx * ny, 0. );
+    vector< double > iDen( nx * ny, 0. );
+    for( int j = 0; j < ny; j++ )
+    {
+        for( int k = 0; k < nx; k++ )
+        {
+            int b = ( k + 1 ) + ( nx + 2 ) * ( j + 1 );
+            if( w[b] <= 0. )
+            {
+                continue;
+            }
+            double wv = w[b] * v[b];
+            const double* kx = &Kx[k * nx];
+            for( int i = 0; i < nx; i++ )
+            {
+                iNum[j * nx + i] += kx[i] * wv;
+                iDen[j * nx + i] += kx[i] * w[b];
+            }
+        }
+    }
+    // convolution along y
+    vector< double > iNumXY( nx * ny, 0. );
+    vector< double > iDenXY( nx * ny, 0. );
+    for( int l = 0; l < ny; l++ )
+    {
+        const double* ky = &Ky[l * ny];
+        for( int j = 0; j < ny; j++ )
+        {
+            if( ky[j] == 0. )
+            {
+                continue;
+            }
+            for( int i = 0; i < nx; i++ )
+            {
+                iNumXY[j * nx + i] += ky[j] * iNum[l * nx + i];
+                iDenXY[j * nx + i] += ky[j] * iDen[l * nx + i];
+            }
+        }
+    }
+    
+    for( int j = 0; j < ny; j++ )
+    {
+        for( int i = 0; i < nx; i++ )
+        {
+            int b = ( i + 1 ) + ( nx + 2 ) * ( j + 1 );
+            if( iDenXY[j * nx + i] > 0. )
+            {
+                s[b] = iNumXY[j * nx + i] / iDenXY[j * nx + i];
+            }
+            else
+            {
+                s[b] = 0.;
+            }
+        }
+    }
+}
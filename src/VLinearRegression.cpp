@@ -0,0 +1,288 @@
+/*! \class VLinearRegression
+    \brief weighted straight-line fit y = a + b*x
+    
+    replaces TGraphErrors::Fit( "pol1" ) for the time gradient analysis
+    
+    fit():       weighted least squares (closed form); parameters, errors
+                 (from the covariance matrix) and chi2 as for the
+                 ROOT linear fitter (point errors in y only)
+    
+    fitRobust(): least trimmed squares (FAST-LTS, Rousseeuw & Van Driessen),
+                 as the 'rob' option of TGraph::Fit: the line is fitted to the
+                 h points with the smallest (weighted) squared residuals;
+                 default h = (n + 3) / 2; starting subsets are all pairs of
+                 points (or 500 random pairs for large samples, fixed seed);
+                 parameters and errors are those of a weighted least-squares
+                 refit to the h kept points (errors do not include the
+                 uncertainty of the point selection)
+    
+    chi2 is always calculated for all points
+
+*/
+
+#include "VLinearRegression.h"
+
+VLinearRegression::VLinearRegression()
+{
+    fRandom.seed( 4357 );
+    fIntercept = 0.;
+    fSlope = 0.;
+    fInterceptError = 0.;
+    fSlopeError = 0.;
+    fChi2 = 0.;
+}
+
+/*
+ * weighted least-squares fit to the first n points of iSubset
+ *
+ * (sums are calculated relative to the weighted mean for numerical stability)
+ */
+bool VLinearRegression::fitSubset( const vector< unsigned int >& iSubset, unsigned int n, double& a, double& b, double* da, double* db )
+{
+    double S = 0.;
+    double Sx = 0.;
+    double Sy = 0.;
+    for( unsigned int k = 0; k < n; k++ )
+    {
+        unsigned int i = iSubset[k];
+        S  += fW[i];
+        Sx += fW[i] * fX[i];
+        Sy += fW[i] * fY[i];
+    }
+    if( S <= 0. )
+    {
+        return false;
+    }
+    double xm = Sx / S;
+    double ym = Sy / S;
+    double Sxx = 0.;
+    double Sxy = 0.;
+    for( unsigned int k = 0; k < n; k++ )
+    {
+        unsigned int i = iSubset[k];
+        double dx = fX[i] - xm;
+        Sxx += fW[i] * dx * dx;
+        Sxy += fW[i] * dx * ( fY[i] - ym );
+    }
+    if( Sxx <= 0. )
+    {
+        return false;
+    }
+    b = Sxy / Sxx;
+    a = ym - b * xm;
+    if( da )
+    {
+        *da = sqrt( 1. / S + xm * xm / Sxx );
+    }
+    if( db )
+    {
+        *db = sqrt( 1. / Sxx );
+    }
+    return true;
+}
+
+double VLinearRegression::getChi2( double a, double b )
+{
+    double chi2 = 0.;
+    for( unsigned int i = 0; i < fX.size(); i++ )
+    {
+        double r = fY[i] - a - b * fX[i];
+        chi2 += fW[i] * r * r;
+    }
+    return chi2;
+}
+
+/*
+ * weighted least-squares fit to all points
+ */
+bool VLinearRegression::fit()
+{
+    fIntercept = 0.;
+    fSlope = 0.;
+    fInterceptError = 0.;
+    fSlopeError = 0.;
+    fChi2 = 0.;
+    
+    fIndex.resize( fX.size() );
+    for( unsigned int i = 0; i < fIndex.size(); i++ )
+    {
+        fIndex[i] = i;
+    }
+    if( !fitSubset( fIndex, fIndex.size(), fIntercept, fSlope, &fInterceptError, &fSlopeError ) )
+    {
+        return false;
+    }
+    fChi2 = getChi2( fIntercept, fSlope );
+    return true;
+}
+
+/*
+ * concentration step: fit to the h points with smallest residuals of the
+ * line (a,b); returns the LTS objective of the new line
+ */
+double VLinearRegression::cStep( double& a, double& b, unsigned int h )
+{
+    unsigned int n = fX.size();
+    for( unsigned int i = 0; i < n; i++ )
+    {
+        double r = fY[i] - a - b * fX[i];
+        fResidual[i] = fW[i] * r * r;
+        fIndex[i] = i;
+    }
+    nth_element( fIndex.begin(), fIndex.begin() + ( h - 1 ), fIndex.end(),
+                 [this]( unsigned int i, unsigned int j )
+    {
+        return fResidual[i] < fResidual[j];
+    } );
+    if( !fitSubset( fIndex, h, a, b ) )
+    {
+        return 1.e99;
+    }
+    // objective for new line
+    for( unsigned int i = 0; i < n; i++ )
+    {
+        double r = fY[i] - a - b * fX[i];
+        fResidual[i] = fW[i] * r * r;
+    }
+    nth_element( fResidual.begin(), fResidual.begin() + ( h - 1 ), fResidual.end() );
+    double q = 0.;
+    for( unsigned int i = 0; i < h; i++ )
+    {
+        q += fResidual[i];
+    }
+    return q;
+}
+
+/*
+ * least trimmed squares fit
+ *
+ * iFraction: fraction of good points (0: h = (n+3)/2)
+ */
+bool VLinearRegression::fitRobust( double iFraction )
+{
+    unsigned int n = fX.size();
+    unsigned int h = ( n + 3 ) / 2;
+    if( iFraction > 0. && iFraction < 1. )
+    {
+        h = ( unsigned int )( iFraction * n );
+    }
+    if( h < 3 || h >= n )
+    {
+        return fit();
+    }
+    fResidual.resize( n );
+    fIndex.resize( n );
+    // same starting subsets for each fit
+    fRandom.seed( 4357 );
+    
+    ///////////////////////////////////////////////////
+    // starting lines through pairs of points, two C-steps each;
+    // keep the 10 best candidates
+    const unsigned int nStart = 500;
+    const unsigned int nBest = 10;
+    vector< double > i_bestQ;
+    vector< double > i_bestA;
+    vector< double > i_bestB;
+    bool i_allPairs = ( n * ( n - 1 ) / 2 <= nStart );
+    unsigned int nPairs = ( i_allPairs ? n * ( n - 1 ) / 2 : nStart );
+    unsigned int i1 = 0;
+    unsigned int i2 = 1;
+    uniform_int_distribution< unsigned int > i_dist( 0, n - 1 );
+    for( unsigned int s = 0; s < nPairs; s++ )
+    {
+        unsigned int p = i1;
+        unsigned int q = i2;
+        if( i_allPairs )
+        {
+            i2++;
+            if( i2 >= n )
+            {
+                i1++;
+                i2 = i1 + 1;
+            }
+        }
+        else
+        {
+            p = i_dist( fRandom );
+            q = i_dist( fRandom );
+        }
+        if( p == q || fX[p] == fX[q] )
+        {
+            continue;
+        }
+        double b = ( fY[q] - fY[p] ) / ( fX[q] - fX[p] );
+        double a = fY[p] - b * fX[p];
+        cStep( a, b, h );
+        double Q = cStep( a, b, h );
+        // insert into list of best candidates
+        unsigned int k = 0;
+        while( k < i_bestQ.size() && i_bestQ[k] <= Q )
+        {
+            k++;
+        }
+        if( k < nBest )
+        {
+            i_bestQ.insert( i_bestQ.begin() + k, Q );
+            i_bestA.insert( i_bestA.begin() + k, a );
+            i_bestB.insert( i_bestB.begin() + k, b );
+            if( i_bestQ.size() > nBest )
+            {
+                i_bestQ.pop_back();
+                i_bestA.pop_back();
+                i_bestB.pop_back();
+            }
+        }
+    }
+    if( i_bestQ.size() == 0 )
+    {
+        return fit();
+    }
+    
+    ///////////////////////////////////////////////////
+    // iterate best candidates until convergence
+    double Qmin = 1.e99;
+    double a_min = 0.;
+    double b_min = 0.;
+    for( unsigned int k = 0; k < i_bestQ.size(); k++ )
+    {
+        double a = i_bestA[k];
+        double b = i_bestB[k];
+        double Q = i_bestQ[k];
+        for( unsigned int it = 0; it < 100; it++ )
+        {
+            double Qnew = cStep( a, b, h );
+            if( !( Qnew < Q ) )
+            {
+                break;
+            }
+            Q = Qnew;
+        }
+        if( Q < Qmin )
+        {
+            Qmin = Q;
+            a_min = a;
+            b_min = b;
+        }
+    }
+    
+    ///////////////////////////////////////////////////
+    // final fit (parameters and errors) to the h points closest to the best line
+    for( unsigned int i = 0; i < n; i++ )
+    {
+        double r = fY[i] - a_min - b_min * fX[i];
+        fResidual[i] = fW[i] * r * r;
+        fIndex[i] = i;
+    }
+    nth_element( fIndex.begin(), fIndex.begin() + ( h - 1 ), fIndex.end(),
+                 [this]( unsigned int i, unsigned int j )
+    {
+        return fResidual[i] < fResidual[j];
+    } );
+    fSubset.assign( fIndex.begin(), fIndex.begin() + h );
+    if( !fitSubset( fSubset, h, fIntercept, fSlope, &fInterceptError, &fSlopeError ) )
+    {
+        return fit();
+    }
+    fChi2 = getChi2( fIntercept, fSlope );
+    return true;
+}
@@ -243,6 +243,17 @@ std::vector< bool > VMultipleGrIsuReader::getFullHitVec()
 }
 
 
+const std::vector< bool >& VMultipleGrIsuReader::getFullHitVecRef()
+{
+    if( getReader() )
+    {
+        return getReader()->getFullHitVecRef();
+    }
+    
+    return vv_bool;
+}
+
+
 std::vector< bool > VMultipleGrIsuReader::getFullTrigVec()
 {
     if( getReader() )
@@ -255,6 +266,17 @@ std::vector< bool > VMultipleGrIsuReader::getFullTrigVec()
 }
 
 
+const std::vector< bool >& VMultipleGrIsuReader::getFullTrigVecRef()
+{
+    if( getReader() )
+    {
+        return getReader()->getFullTrigVecRef();
+    }
+    
+    return vv_bool;
+}
+
+
 int VMultipleGrIsuReader::getNumberofFullTrigger()
 {
     if( getReader() )
@@ -278,6 +300,17 @@ std::vector< int > VMultipleGrIsuReader::getFullAnaVec()
 }
 
 
+const std::vector< int >& VMultipleGrIsuReader::getFullAnaVecRef()
+{
+    if( getReader() )
+    {
+        return getReader()->getFullAnaVecRef();
+    }
+    
+    return vv_int;
+}
+
+
 uint8_t VMultipleGrIsuReader::getEventType()
 {
     if( getReader() )
@@ -433,7 +466,6 @@ std::vector< uint8_t > VMultipleGrIsuReader::getSamplesVec()
     return a;
 }
 
-
 std::vector< double > VMultipleGrIsuReader::getTelElevation()
 {
     return fTelElevation;
@@ -165,6 +165,27 @@ bool VPEReader::setTelescopeID( unsigned int iTelID )
 }
 
 
+/*
+ * position reader at tree event iPosition
+ */
+bool VPEReader::setEventPosition( int64_t iPosition )
+{
+    if( iPosition < 0 )
+    {
+        return false;
+    }
+    for( unsigned int i = 0; i < fPE_Tree.size(); i++ )
+    {
+        if( fPE_Tree[i] && iPosition >= fPE_Tree[i]->getEntries() )
+        {
+            return false;
+        }
+    }
+    fPE_treeEvent = ( unsigned int )iPosition;
+    return true;
+}
+
+
 bool VPEReader::getNextEvent()
 {
     if( fDebug )
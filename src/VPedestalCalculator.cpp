@@ -296,7 +296,7 @@ void VPedestalCalculator::doAnalysis( bool iLowGain )
                                 getDigitalFilterPoleZero() );
                                 
                         fTraceHandler->setTrace( fReader, getNSamples(), getPeds()[chanID], chanID, i,
-                                                 getLowGainMultiplier_Trace()*getHiLo()[chanID] );
+                                                 getLowGainMultiplier_Trace()*getHiLo()[chanID], getTraceCache() );
                                                  
                         //////////////////////////
                         // loop over all summation windows
@@ -400,6 +400,8 @@ void VPlotLookupTable::plotLookupTableSlice( double iLogSize, double iR )
 
 /*
  * interpolate or smooth lookup tables
+ *
+ * methods: interpolate, fit*, gauss
  */
 bool VPlotLookupTable::smoothLookupTables( unsigned int iSetID, string iMethod, int iMinEvents )
 {
@@ -429,6 +431,13 @@ bool VPlotLookupTable::smoothLookupTables( unsigned int iSetID, string iMethod,
                                               iMinEvents );
                                               
     }
+    else if( iMethod == "gauss" )
+    {
+        fLookupTableData[iSetID]->hmedian =
+            i_inter.doGaussianInterpolation( fLookupTableData[iSetID]->hmedian,
+                                             iMethod,
+                                             fLookupTableData[iSetID]->hnevents );
+    }
     else
     {
         return false;
@@ -8,6 +8,10 @@
 
 #include "VPointingCorrectionsTreeReader.h"
 
+/*
+ * chain with pointing corrections is owned by this class
+ *
+ */
 VPointingCorrectionsTreeReader::VPointingCorrectionsTreeReader( TChain* t )
 {
     fPointingErrorX = 0.;
@@ -28,6 +32,11 @@ VPointingCorrectionsTreeReader::VPointingCorrectionsTreeReader( TChain* t )
     
 }
 
+VPointingCorrectionsTreeReader::~VPointingCorrectionsTreeReader()
+{
+    delete fTree;
+}
+
 
 int VPointingCorrectionsTreeReader::getEntry( Long64_t iEntry )
 {
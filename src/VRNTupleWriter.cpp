@@ -0,0 +1,177 @@
+/*! \class VRNTupleWriter
+    \brief columnar copy of mscw/DL2 event data trees as RNTuple
+    
+    fields are defined from the branches of an existing (leaf list) tree;
+    values are copied from the branch addresses at each fill()
+    
+    - scalar leaves are written as scalar fields
+    - arrays (fixed size or variable size, e.g. [NImages]) as collections
+    
+    the RNTuple is committed to disk with close() (before closing the file)
+
+*/
+
+#include "VRNTupleWriter.h"
+
+VRNTupleWriter::VRNTupleWriter()
+{
+    fName = "";
+    fNEntries = 0;
+}
+
+VRNTupleWriter::~VRNTupleWriter()
+{
+    close();
+    for( unsigned int i = 0; i < fColumns.size(); i++ )
+    {
+        delete fColumns[i];
+    }
+}
+
+template< class S, class T > void VRNTupleWriter::addColumn( ROOT::RNTupleModel* iModel, string iName, TLeaf* iLeaf, bool iCollection )
+{
+    if( iCollection )
+    {
+        fColumns.push_back( new VRNTupleCollectionWriter< S, T >( iLeaf, iModel->MakeField< vector< T > >( iName ) ) );
+    }
+    else
+    {
+        fColumns.push_back( new VRNTupleScalarWriter< S, T >( iLeaf, iModel->MakeField< T >( iName ) ) );
+    }
+}
+
+/*
+ * define RNTuple fields from the branches of the given tree
+ *
+ * iCompression: ROOT compression settings (e.g. 505: zstd, level 5)
+ */
+bool VRNTupleWriter::initialize( TTree* iTree, TDirectory* iDir, string iName, int iCompression )
+{
+    if( !iTree || !iDir )
+    {
+        cout << "VRNTupleWriter::initialize error: no tree or output file" << endl;
+        return false;
+    }
+    fName = iName;
+    
+    unique_ptr< ROOT::RNTupleModel > iModel = ROOT::RNTupleModel::Create();
+    vector< string > iFieldNames;
+    
+    TObjArray* iBranches = iTree->GetListOfBranches();
+    for( int b = 0; b < iBranches->GetEntries(); b++ )
+    {
+        TBranch* iBranch = ( TBranch* )iBranches->At( b );
+        if( !iBranch || iBranch->IsA() != TBranch::Class() || iBranch->GetListOfLeaves()->GetEntries() != 1 )
+        {
+            cout << "VRNTupleWriter::initialize: ignoring branch " << ( iBranch ? iBranch->GetName() : "" ) << endl;
+            continue;
+        }
+        string iFieldName = iBranch->GetName();
+        // branch names are not unique in all trees (first one wins, as for TTree::GetBranch)
+        bool iDuplicate = false;
+        for( unsigned int f = 0; f < iFieldNames.size(); f++ )
+        {
+            if( iFieldNames[f] == iFieldName )
+            {
+                iDuplicate = true;
+                break;
+            }
+        }
+        if( iDuplicate )
+        {
+            continue;
+        }
+        TLeaf* iLeaf = ( TLeaf* )iBranch->GetListOfLeaves()->At( 0 );
+        bool iCollection = ( iLeaf->GetLeafCount() != 0 || iLeaf->GetLenStatic() > 1 );
+        string iType = iLeaf->GetTypeName();
+        if( iType == "Float_t" )
+        {
+            addColumn< Float_t, float >( iModel.get(), iFieldName, iLeaf, iCollection );
+        }
+        else if( iType == "Double_t" )
+        {
+            addColumn< Double_t, double >( iModel.get(), iFieldName, iLeaf, iCollection );
+        }
+        else if( iType == "Int_t" )
+        {
+            addColumn< Int_t, std::int32_t >( iModel.get(), iFieldName, iLeaf, iCollection );
+        }
+        else if( iType == "UInt_t" )
+        {
+            addColumn< UInt_t, std::uint32_t >( iModel.get(), iFieldName, iLeaf, iCollection );
+        }
+        else if( iType == "Long64_t" )
+        {
+            addColumn< Long64_t, std::int64_t >( iModel.get(), iFieldName, iLeaf, iCollection );
+        }
+        else if( iType == "ULong64_t" )
+        {
+            addColumn< ULong64_t, std::uint64_t >( iModel.get(), iFieldName, iLeaf, iCollection );
+        }
+        else if( iType == "Short_t" )
+        {
+            addColumn< Short_t, std::int16_t >( iModel.get(), iFieldName, iLeaf, iCollection );
+        }
+        else if( iType == "UShort_t" )
+        {
+            addColumn< UShort_t, std::uint16_t >( iModel.get(), iFieldName, iLeaf, iCollection );
+        }
+        else if( iType == "Char_t" )
+        {
+            addColumn< Char_t, std::int8_t >( iModel.get(), iFieldName, iLeaf, iCollection );
+        }
+        else if( iType == "UChar_t" )
+        {
+            addColumn< UChar_t, std::uint8_t >( iModel.get(), iFieldName, iLeaf, iCollection );
+        }
+        else if( iType == "Bool_t" )
+        {
+            addColumn< Bool_t, bool >( iModel.get(), iFieldName, iLeaf, iCollection );
+        }
+        else
+        {
+            cout << "VRNTupleWriter::initialize: ignoring branch " << iFieldName << " (type " << iType << ")" << endl;
+            continue;
+        }
+        iFieldNames.push_back( iFieldName );
+    }
+    
+    ROOT::RNTupleWriteOptions iOptions;
+    iOptions.SetCompression( iCompression );
+    fWriter = ROOT::RNTupleWriter::Append( std::move( iModel ), fName, *iDir, iOptions );
+    if( !fWriter )
+    {
+        cout << "VRNTupleWriter::initialize error: cannot create RNTuple " << fName << endl;
+        return false;
+    }
+    cout << "writing event data as RNTuple " << fName << " (" << iFieldNames.size() << " fields, compression ";
+    cout << iCompression << ")" << endl;
+    
+    return true;
+}
+
+void VRNTupleWriter::fill()
+{
+    if( !fWriter )
+    {
+        return;
+    }
+    for( unsigned int i = 0; i < fColumns.size(); i++ )
+    {
+        fColumns[i]->fill();
+    }
+    fWriter->Fill();
+    fNEntries++;
+}
+
+/*
+ * commit RNTuple to disk
+ */
+void VRNTupleWriter::close()
+{
+    if( fWriter )
+    {
+        fWriter.reset();
+        cout << "\t total number of events in RNTuple " << fName << ": " << fNEntries << endl;
+    }
+}
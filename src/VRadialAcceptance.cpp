@@ -213,7 +213,9 @@ VRadialAcceptance::VRadialAcceptance( VGammaHadronCuts* icuts, VAnaSumRunParamet
         // (large bin numbers required to achieve sufficent accuracy)
         sprintf( hname, "hAreaExcluded2D_%d", fRunPar->fRunList[i].fRunOff );
         sprintf( htitle, "run %d", fRunPar->fRunList[i].fRunOff );
-        hAreaExcluded2D.push_back( new TH2F( hname, htitle, 1000, -xymax, xymax, 1000, -xymax, xymax ) );
+        // (same binning as exclusion mask)
+        hAreaExcluded2D.push_back( new TH2F( hname, htitle, fExclusionMask_nbins, -fExclusionMask_max, fExclusionMask_max,
+                                             fExclusionMask_nbins, -fExclusionMask_max, fExclusionMask_max ) );
         hAreaExcluded2D.back()->SetXTitle( "x_{off,derot} [deg]" );
         hAreaExcluded2D.back()->SetYTitle( "y_{off,derot} [deg]" );
         hAreaExcluded2D.back()->Sumw2();
@@ -340,12 +342,173 @@ VRadialAcceptance::VRadialAcceptance( VGammaHadronCuts* icuts, VAnaSumRunParamet
 }
 
 
+/*!
+
+ *  accumulator for parallel filling of acceptance curves
+ *
+ *  - run-wise histograms are shared with iParent
+ *    (each run must be filled by one accumulator only)
+ *  - all other histograms are private copies, added to
+ *    iParent with iParent->addAccumulator()
+ *
+ *  must be called from the main thread
+ 
+ */
+VRadialAcceptance::VRadialAcceptance( VRadialAcceptance* iParent, VGammaHadronCuts* iCuts )
+{
+    reset();
+    
+    if( !iParent || !iParent->hList )
+    {
+        cout << "VRadialAcceptance error: no acceptance curves to accumulate" << endl;
+        cout << "exiting..";
+        exit( EXIT_FAILURE );
+    }
+    fRunPar = iParent->fRunPar;
+    fCuts = iCuts;
+    if( !fCuts )
+    {
+        fCuts = iParent->fCuts;
+    }
+    fproduction_shortIO = iParent->fproduction_shortIO;
+    fSourcePosition_X = iParent->fSourcePosition_X;
+    fSourcePosition_Y = iParent->fSourcePosition_Y;
+    fSourcePosition_Radius = iParent->fSourcePosition_Radius;
+    fMaxDistanceAllowed = iParent->fMaxDistanceAllowed;
+    fCut_CameraFiducialSize_max = iParent->fCut_CameraFiducialSize_max;
+    fEnergyReconstructionMethod = iParent->fEnergyReconstructionMethod;
+    fAzCut_min = iParent->fAzCut_min;
+    fAzCut_max = iParent->fAzCut_max;
+    fAccZeFitMinBin = iParent->fAccZeFitMinBin;
+    fAccZeFitMaxBin = iParent->fAccZeFitMaxBin;
+    phi_minphi = iParent->phi_minphi;
+    phi_maxphi = iParent->phi_maxphi;
+    phi_nbins = iParent->phi_nbins;
+    phi_minradius = iParent->phi_minradius;
+    phi_maxradius = iParent->phi_maxradius;
+    rad_minrad = iParent->rad_minrad;
+    rad_maxrad = iParent->rad_maxrad;
+    rad_nbins = iParent->rad_nbins;
+    rad_phiwidth = iParent->rad_phiwidth;
+    
+    // run-wise histograms (shared)
+    fRadialAcceptance_perRun = iParent->fRadialAcceptance_perRun;
+    hscaleRun = iParent->hscaleRun;
+    hscaleRunRatio = iParent->hscaleRunRatio;
+    hAreaExcluded2D = iParent->hAreaExcluded2D;
+    hXYAccRun = iParent->hXYAccRun;
+    hListNormalizeHistograms = new TList();
+    for( unsigned int i = 0; i < fRadialAcceptance_perRun.size(); i++ )
+    {
+        hListNormalizeHistograms->Add( fRadialAcceptance_perRun[i] );
+    }
+    
+    // all other histograms filled event-wise (private)
+    hListAccumulator = new TList();
+    hListAccumulator->SetOwner( kTRUE );
+    hPhiDist = ( TH1F* )cloneAccumulatorHistogram( iParent->hPhiDist );
+    hXYAccTotDeRot = ( TH2F* )cloneAccumulatorHistogram( iParent->hXYAccTotDeRot );
+    hXYAccTotDeRotPhiDependentSlice = ( TH1F* )cloneAccumulatorHistogram( iParent->hXYAccTotDeRotPhiDependentSlice );
+    hXYAccTotDeRotRadiusDependentSlice000 = ( TH1F* )cloneAccumulatorHistogram( iParent->hXYAccTotDeRotRadiusDependentSlice000 );
+    for( unsigned int i = 0; i < iParent->hXYAccImgSel.size(); i++ )
+    {
+        hXYAccImgSel.push_back( ( TH2F* )cloneAccumulatorHistogram( iParent->hXYAccImgSel[i] ) );
+        hXYAccImgSelPreDeRot.push_back( ( TH2F* )cloneAccumulatorHistogram( iParent->hXYAccImgSelPreDeRot[i] ) );
+        hXYAccImgSelPhiDependentSlice.push_back( ( TH1F* )cloneAccumulatorHistogram( iParent->hXYAccImgSelPhiDependentSlice[i] ) );
+        hXYAccImgSelRadiusDependentSlice000.push_back( ( TH1F* )cloneAccumulatorHistogram( iParent->hXYAccImgSelRadiusDependentSlice000[i] ) );
+    }
+    for( unsigned int i = 0; i < iParent->hXYAccNImages.size(); i++ )
+    {
+        hXYAccNImages.push_back( ( TH2F* )cloneAccumulatorHistogram( iParent->hXYAccNImages[i] ) );
+        hXYAccNImagesPreDeRot.push_back( ( TH2F* )cloneAccumulatorHistogram( iParent->hXYAccNImagesPreDeRot[i] ) );
+        hXYAccNImagesPhiDependentSlice.push_back( ( TH1F* )cloneAccumulatorHistogram( iParent->hXYAccNImagesPhiDependentSlice[i] ) );
+        hXYAccNImagesRadiusDependentSlice000.push_back( ( TH1F* )cloneAccumulatorHistogram( iParent->hXYAccNImagesRadiusDependentSlice000[i] ) );
+    }
+}
+
+
 VRadialAcceptance::~VRadialAcceptance()
 {
     if( fAccFile )
     {
         delete fAccFile;
     }
+    if( hListAccumulator )
+    {
+        delete hListAccumulator;
+        delete hListNormalizeHistograms;
+    }
+}
+
+
+/*
+ *  empty, memory-resident copy of a histogram (owned by this object)
+ */
+TH1* VRadialAcceptance::cloneAccumulatorHistogram( TH1* h )
+{
+    if( !h )
+    {
+        return 0;
+    }
+    TH1* i_h = ( TH1* )h->Clone();
+    i_h->SetDirectory( 0 );
+    i_h->Reset();
+    hListAccumulator->Add( i_h );
+    return i_h;
+}
+
+
+/*
+ *  add histograms of an accumulator to this object
+ *
+ *  (run-wise histograms are shared and filled already)
+ */
+bool VRadialAcceptance::addAccumulator( VRadialAcceptance* iAccumulator )
+{
+    if( !iAccumulator || !iAccumulator->hListAccumulator )
+    {
+        return false;
+    }
+    vector< TH1* > i_h;
+    vector< TH1* > i_hAcc;
+    i_h.push_back( hPhiDist );
+    i_hAcc.push_back( iAccumulator->hPhiDist );
+    i_h.push_back( hXYAccTotDeRot );
+    i_hAcc.push_back( iAccumulator->hXYAccTotDeRot );
+    i_h.push_back( hXYAccTotDeRotPhiDependentSlice );
+    i_hAcc.push_back( iAccumulator->hXYAccTotDeRotPhiDependentSlice );
+    i_h.push_back( hXYAccTotDeRotRadiusDependentSlice000 );
+    i_hAcc.push_back( iAccumulator->hXYAccTotDeRotRadiusDependentSlice000 );
+    for( unsigned int i = 0; i < hXYAccImgSel.size() && i < iAccumulator->hXYAccImgSel.size(); i++ )
+    {
+        i_h.push_back( hXYAccImgSel[i] );
+        i_hAcc.push_back( iAccumulator->hXYAccImgSel[i] );
+        i_h.push_back( hXYAccImgSelPreDeRot[i] );
+        i_hAcc.push_back( iAccumulator->hXYAccImgSelPreDeRot[i] );
+        i_h.push_back( hXYAccImgSelPhiDependentSlice[i] );
+        i_hAcc.push_back( iAccumulator->hXYAccImgSelPhiDependentSlice[i] );
+        i_h.push_back( hXYAccImgSelRadiusDependentSlice000[i] );
+        i_hAcc.push_back( iAccumulator->hXYAccImgSelRadiusDependentSlice000[i] );
+    }
+    for( unsigned int i = 0; i < hXYAccNImages.size() && i < iAccumulator->hXYAccNImages.size(); i++ )
+    {
+        i_h.push_back( hXYAccNImages[i] );
+        i_hAcc.push_back( iAccumulator->hXYAccNImages[i] );
+        i_h.push_back( hXYAccNImagesPreDeRot[i] );
+        i_hAcc.push_back( iAccumulator->hXYAccNImagesPreDeRot[i] );
+        i_h.push_back( hXYAccNImagesPhiDependentSlice[i] );
+        i_hAcc.push_back( iAccumulator->hXYAccNImagesPhiDependentSlice[i] );
+        i_h.push_back( hXYAccNImagesRadiusDependentSlice000[i] );
+        i_hAcc.push_back( iAccumulator->hXYAccNImagesRadiusDependentSlice000[i] );
+    }
+    for( unsigned int i = 0; i < i_h.size(); i++ )
+    {
+        if( i_h[i] && i_hAcc[i] )
+        {
+            i_h[i]->Add( i_hAcc[i] );
+        }
+    }
+    return true;
 }
 
 
@@ -373,7 +536,18 @@ void VRadialAcceptance::reset()
     hPhiDist = 0;
     hPhiDistDeRot = 0;
     hXYAccTotDeRot = 0;
+    hXYAccTotDeRotPhiDependentSlice = 0;
+    hXYAccTotDeRotRadiusDependentSlice000 = 0;
     fAccFile = 0;
+    hListAccumulator = 0;
+    
+    fExclusionMaskFilled = false;
+    fExclusionMask_nbins = 1000;
+    fExclusionMask_max = 5.;
+    
+    fAcceptanceMapFilled = false;
+    fAcceptanceMap_nbins = 0;
+    fAcceptanceMap_max = 0.;
     
     f2DAcceptanceMode = 0 ;
     f2DBinNormalizationConstant = 0 ;
@@ -400,37 +574,24 @@ void VRadialAcceptance::reset()
     (ignore here any zenith angle acceptance)
 
     note: x,y are in derotated coordinates
+
+    1D radial acceptances are interpolated from the acceptance map
+    (see fillAcceptanceMap())
  */
 double VRadialAcceptance::getAcceptance( double x, double y )
 {
     // use 1D radial acceptances
     if( f2DAcceptanceMode == 0 )
     {
-        double iacc = 1.;
-        
-        if( fAcceptanceFunctionDefined && fRadialAcceptanceFit )
+        if( !fAcceptanceFunctionDefined || !fRadialAcceptanceFit )
         {
-            double idist = sqrt( x * x + y * y );
-            if( idist > fRadialAcceptanceFit->GetXmax() )
-            {
-                iacc = 0.;
-            }
-            else
-            {
-                iacc = fRadialAcceptanceFit->Eval( idist );
-            }
-            if( iacc > 1. )
-            {
-                iacc = 1.;
-            }
-            if( iacc < 0. )
-            {
-                iacc = 0.;
-            }
+            return 1.;
         }
-        
-        return iacc;
-        
+        if( !fAcceptanceMapFilled )
+        {
+            fillAcceptanceMap();
+        }
+        return interpolateAcceptanceMap( x, y );
     }
     // use 2D acceptances
     // (use getXoff_derot() and getYoff_derot())
@@ -460,6 +621,173 @@ double VRadialAcceptance::getAcceptance( double x, double y )
 }
 
 
+/*
+ *    get acceptance for a list of n positions
+ *    (x,y in derotated coordinates)
+ */
+void VRadialAcceptance::getAcceptance( unsigned int n, const double* x, const double* y, double* acc )
+{
+    if( f2DAcceptanceMode != 0 || !fAcceptanceFunctionDefined || !fRadialAcceptanceFit )
+    {
+        for( unsigned int i = 0; i < n; i++ )
+        {
+            acc[i] = getAcceptance( x[i], y[i] );
+        }
+        return;
+    }
+    if( !fAcceptanceMapFilled )
+    {
+        fillAcceptanceMap();
+    }
+    for( unsigned int i = 0; i < n; i++ )
+    {
+        acc[i] = interpolateAcceptanceMap( x[i], y[i] );
+    }
+}
+
+
+/*
+ *    fill acceptance map from the 1D radial acceptance function
+ *
+ *    grid nodes with a spacing of 0.01 deg (maximum 1000 x 1000 cells)
+ *    cover the range of the acceptance function; nodes outside of this range
+ *    (corners of the grid) are filled with the extrapolated function and are
+ *    used for interpolation close to the maximum radius only (acceptance is
+ *    zero outside the range, see interpolateAcceptanceMap())
+ */
+void VRadialAcceptance::fillAcceptanceMap()
+{
+    fAcceptanceMap_max = fRadialAcceptanceFit->GetXmax();
+    fAcceptanceMap_nbins = TMath::Min( 1000, TMath::Max( 2, ( int )ceil( 2. * fAcceptanceMap_max / 0.01 ) ) );
+    int i_nnodes = fAcceptanceMap_nbins + 1;
+    double i_binwidth = 2. * fAcceptanceMap_max / ( double )fAcceptanceMap_nbins;
+    fAcceptanceMap.assign( i_nnodes * i_nnodes, 0. );
+    
+    double x = 0.;
+    double y = 0.;
+    double r = 0.;
+    double iacc = 0.;
+    for( int ix = 0; ix < i_nnodes; ix++ )
+    {
+        x = -fAcceptanceMap_max + ix * i_binwidth;
+        for( int iy = 0; iy < i_nnodes; iy++ )
+        {
+            y = -fAcceptanceMap_max + iy * i_binwidth;
+            r = sqrt( x * x + y * y );
+            iacc = fRadialAcceptanceFit->Eval( r );
+            if( iacc > 1. )
+            {
+                iacc = 1.;
+            }
+            if( iacc < 0. )
+            {
+                iacc = 0.;
+            }
+            fAcceptanceMap[ix * i_nnodes + iy] = ( float )iacc;
+        }
+    }
+    fAcceptanceMapFilled = true;
+}
+
+
+/*
+ *    bilinear interpolation in acceptance map
+ *    (zero acceptance outside the range of the acceptance function)
+ */
+double VRadialAcceptance::interpolateAcceptanceMap( double x, double y )
+{
+    if( x * x + y * y > fAcceptanceMap_max * fAcceptanceMap_max )
+    {
+        return 0.;
+    }
+    int i_nnodes = fAcceptanceMap_nbins + 1;
+    double i_binwidth = 2. * fAcceptanceMap_max / ( double )fAcceptanceMap_nbins;
+    double u = ( x + fAcceptanceMap_max ) / i_binwidth;
+    double v = ( y + fAcceptanceMap_max ) / i_binwidth;
+    int ix = TMath::Min( TMath::Max( ( int )floor( u ), 0 ), fAcceptanceMap_nbins - 1 );
+    int iy = TMath::Min( TMath::Max( ( int )floor( v ), 0 ), fAcceptanceMap_nbins - 1 );
+    double fx = u - ix;
+    double fy = v - iy;
+    const float* a = &fAcceptanceMap[ix * i_nnodes + iy];
+    
+    return ( 1. - fx ) * ( ( 1. - fy ) * a[0] + fy * a[1] )
+           + fx * ( ( 1. - fy ) * a[i_nnodes] + fy * a[i_nnodes + 1] );
+}
+
+
+/*
+ *    mean acceptance per cell of a regular grid, with zero acceptance
+ *    for excluded positions (nsub x nsub sampling points per cell)
+ *
+ *    cell (i,j) (counting from 0) is stored in iAcc[i * ny + j]
+ *
+ *    iBackground = true:  exclude regions using isExcludedfromBackground()
+ *    iBackground = false: exclude regions using isExcludedfromSource()
+ *
+ *    x,y are de-rotated camera coordinates
+ */
+void VRadialAcceptance::getAcceptanceMap( vector< double >& iAcc, int nx, double xmin, double xmax,
+        int ny, double ymin, double ymax, bool iBackground, int nsub )
+{
+    iAcc.assign( TMath::Max( nx * ny, 0 ), 0. );
+    if( nx < 1 || ny < 1 )
+    {
+        return;
+    }
+    if( nsub < 1 )
+    {
+        nsub = 1;
+    }
+    double dx = ( xmax - xmin ) / ( double )nx;
+    double dy = ( ymax - ymin ) / ( double )ny;
+    
+    // sampling points of one column of cells
+    unsigned int n = ( unsigned int )( ny * nsub * nsub );
+    vector< double > i_x( n, 0. );
+    vector< double > i_y( n, 0. );
+    vector< double > i_a( n, 0. );
+    for( int i = 0; i < nx; i++ )
+    {
+        unsigned int k = 0;
+        for( int j = 0; j < ny; j++ )
+        {
+            for( int si = 0; si < nsub; si++ )
+            {
+                for( int sj = 0; sj < nsub; sj++ )
+                {
+                    i_x[k] = xmin + ( i + ( si + 0.5 ) / nsub ) * dx;
+                    i_y[k] = ymin + ( j + ( sj + 0.5 ) / nsub ) * dy;
+                    k++;
+                }
+            }
+        }
+        getAcceptance( n, &i_x[0], &i_y[0], &i_a[0] );
+        
+        k = 0;
+        for( int j = 0; j < ny; j++ )
+        {
+            double i_sum = 0.;
+            for( int s = 0; s < nsub * nsub; s++ )
+            {
+                if( iBackground && isExcludedfromBackground( i_x[k], i_y[k] ) )
+                {
+                    k++;
+                    continue;
+                }
+                if( !iBackground && isExcludedfromSource( i_x[k], i_y[k] ) )
+                {
+                    k++;
+                    continue;
+                }
+                i_sum += i_a[k];
+                k++;
+            }
+            iAcc[i * ny + j] = i_sum / ( double )( nsub * nsub );
+        }
+    }
+}
+
+
 /*!
  *    define here region in the sky which are excluded in the analysis
  *
@@ -486,8 +814,135 @@ bool VRadialAcceptance::isExcluded( double x, double y )
  *
  *     x,y are de-rotated camera coordinates
  *     (not wobble shifted: relative to the camera center)
+ *
+ *    uses the exclusion mask; exact test only close to region boundaries
  */
 bool VRadialAcceptance::isExcludedfromBackground( double x, double y )
+{
+    if( !fExclusionMaskFilled )
+    {
+        fillExclusionMask();
+    }
+    double i_binwidth = 2. * fExclusionMask_max / ( double )fExclusionMask_nbins;
+    int ix = ( int )floor( ( x + fExclusionMask_max ) / i_binwidth );
+    int iy = ( int )floor( ( y + fExclusionMask_max ) / i_binwidth );
+    if( ix >= 0 && ix < fExclusionMask_nbins && iy >= 0 && iy < fExclusionMask_nbins )
+    {
+        char i_mask = fExclusionMask[ix * fExclusionMask_nbins + iy];
+        if( i_mask == 0 )
+        {
+            return false;
+        }
+        else if( i_mask == 1 )
+        {
+            return true;
+        }
+    }
+    
+    return testExcludedfromBackground( x, y );
+}
+
+
+/*
+ *    fill exclusion mask on the camera-coordinate grid
+ *
+ *    a cell is marked as not excluded (0) or excluded (1) only if
+ *    this is true for every point inside the cell; all other cells
+ *    are marked for an exact test (2)
+ */
+void VRadialAcceptance::fillExclusionMask()
+{
+    fExclusionMask.assign( fExclusionMask_nbins * fExclusionMask_nbins, 0 );
+    double i_binwidth = 2. * fExclusionMask_max / ( double )fExclusionMask_nbins;
+    // half diagonal of a cell (with safety margin for rounding)
+    double h = 0.5 * sqrt( 2. ) * i_binwidth * 1.001;
+    
+    double x = 0.;
+    double y = 0.;
+    double d = 0.;
+    for( int ix = 0; ix < fExclusionMask_nbins; ix++ )
+    {
+        x = -fExclusionMask_max + ( ix + 0.5 ) * i_binwidth;
+        for( int iy = 0; iy < fExclusionMask_nbins; iy++ )
+        {
+            y = -fExclusionMask_max + ( iy + 0.5 ) * i_binwidth;
+            char i_mask = 0;
+            // fiducial area
+            d = sqrt( x * x + y * y );
+            if( d - h > fMaxDistanceAllowed )
+            {
+                i_mask = 1;
+            }
+            else if( d + h > fMaxDistanceAllowed )
+            {
+                i_mask = 2;
+            }
+            // source region
+            if( i_mask != 1 && fSourcePosition_Radius > 0. )
+            {
+                d = sqrt( ( x - fSourcePosition_X ) * ( x - fSourcePosition_X ) + ( y - fSourcePosition_Y ) * ( y - fSourcePosition_Y ) );
+                if( d + h < fSourcePosition_Radius )
+                {
+                    i_mask = 1;
+                }
+                else if( d - h < fSourcePosition_Radius )
+                {
+                    i_mask = 2;
+                }
+            }
+            fExclusionMask[ix * fExclusionMask_nbins + iy] = i_mask;
+        }
+    }
+    
+    // exclusion regions (loop over cells inside a box around each region)
+    for( unsigned int i = 0; i < fListOfExclusionRegions.size(); i++ )
+    {
+        if( !fListOfExclusionRegions[i] )
+        {
+            continue;
+        }
+        double i_x0 = fListOfExclusionRegions[i]->fExcludeFromBackground_CameraCentre_x;
+        double i_y0 = fListOfExclusionRegions[i]->fExcludeFromBackground_CameraCentre_y;
+        double i_r1 = fabs( fListOfExclusionRegions[i]->fExcludeFromBackground_Radius1 );
+        double i_r2 = fabs( fListOfExclusionRegions[i]->fExcludeFromBackground_Radius2 );
+        double i_rmax = TMath::Max( i_r1, i_r2 );
+        double i_rmin = TMath::Min( i_r1, i_r2 );
+        
+        int ix_min = TMath::Max( 0, ( int )floor( ( i_x0 - i_rmax - h + fExclusionMask_max ) / i_binwidth ) );
+        int ix_max = TMath::Min( fExclusionMask_nbins - 1, ( int )floor( ( i_x0 + i_rmax + h + fExclusionMask_max ) / i_binwidth ) );
+        int iy_min = TMath::Max( 0, ( int )floor( ( i_y0 - i_rmax - h + fExclusionMask_max ) / i_binwidth ) );
+        int iy_max = TMath::Min( fExclusionMask_nbins - 1, ( int )floor( ( i_y0 + i_rmax + h + fExclusionMask_max ) / i_binwidth ) );
+        for( int ix = ix_min; ix <= ix_max; ix++ )
+        {
+            x = -fExclusionMask_max + ( ix + 0.5 ) * i_binwidth;
+            for( int iy = iy_min; iy <= iy_max; iy++ )
+            {
+                if( fExclusionMask[ix * fExclusionMask_nbins + iy] == 1 )
+                {
+                    continue;
+                }
+                y = -fExclusionMask_max + ( iy + 0.5 ) * i_binwidth;
+                d = sqrt( ( x - i_x0 ) * ( x - i_x0 ) + ( y - i_y0 ) * ( y - i_y0 ) );
+                if( i_rmin > 0. && d + h < i_rmin )
+                {
+                    fExclusionMask[ix * fExclusionMask_nbins + iy] = 1;
+                }
+                else if( d - h < i_rmax )
+                {
+                    fExclusionMask[ix * fExclusionMask_nbins + iy] = 2;
+                }
+            }
+        }
+    }
+    fExclusionMaskFilled = true;
+}
+
+
+/*
+ *    exact test for regions excluded from background analysis
+ *    (see isExcludedfromBackground())
+ */
+bool VRadialAcceptance::testExcludedfromBackground( double x, double y )
 {
     // event outside fiducial area
     if( isExcluded( x, y ) )
@@ -544,6 +999,8 @@ void VRadialAcceptance::setSource( double x, double y, double r, double imaxdist
     // maximum allowed distance of an event
     // from the camera centre
     fMaxDistanceAllowed = imaxdist;
+    
+    fExclusionMaskFilled = false;
 }
 
 /*
@@ -554,6 +1011,7 @@ void VRadialAcceptance::setSource( double x, double y, double r, double imaxdist
 void VRadialAcceptance::setRegionToExcludeAcceptance( vector< VListOfExclusionRegions* > iF )
 {
     fListOfExclusionRegions = iF;
+    fExclusionMaskFilled = false;
 }
 
 
@@ -1268,9 +1726,12 @@ int VRadialAcceptance::SetExtraHistogramMode( int ehm )
      get scaling histogram for 1D radial acceptances taking
      exclusion regions into account
 
+     (progress output is written to iLog; allows to print
+      output of parallel filling in one block per run)
+
 */
 bool VRadialAcceptance::correctRadialAcceptancesForExclusionRegions( TDirectory* iDirectory,
-        unsigned int iRunNumber )
+        unsigned int iRunNumber, ostream& iLog )
 {
     if( !iDirectory->cd() )
     {
@@ -1291,21 +1752,21 @@ bool VRadialAcceptance::correctRadialAcceptancesForExclusionRegions( TDirectory*
     /////////////////////////////////////////////
     // fill a 2D map and the 1D area map taking
     // exclusion regions into account
-    cout << "2D filling of acceptance ratios taking exclusion regions into account ";
+    iLog << "2D filling of acceptance ratios taking exclusion regions into account ";
     string iDirTitleName = iDirectory->GetTitle();
     if( iDirTitleName.size() > 0 )
     {
-        cout << "(" << iDirectory->GetName() << ", " << iDirectory->GetTitle() << "):";
+        iLog << "(" << iDirectory->GetName() << ", " << iDirectory->GetTitle() << "):";
     }
     else
     {
-        cout << "(az average histograms):";
+        iLog << "(az average histograms):";
     }
-    cout << endl;
+    iLog << endl;
     double neventssim = ( double )( hAreaExcluded2D[ifocus]->GetNbinsX() * hAreaExcluded2D[ifocus]->GetNbinsY() );
-    cout << "\t number of simulations " << neventssim << endl;
-    cout << "\t nxbins = " << hAreaExcluded2D[ifocus]->GetNbinsX() << endl ;
-    cout << "\t nybins = " << hAreaExcluded2D[ifocus]->GetNbinsY() << endl ;
+    iLog << "\t number of simulations " << neventssim << endl;
+    iLog << "\t nxbins = " << hAreaExcluded2D[ifocus]->GetNbinsX() << endl ;
+    iLog << "\t nybins = " << hAreaExcluded2D[ifocus]->GetNbinsY() << endl ;
     int nfilled = 0 ;
     for( int kx = 1; kx <= hAreaExcluded2D[ifocus]->GetNbinsX(); kx++ )
     {
@@ -1321,7 +1782,7 @@ bool VRadialAcceptance::correctRadialAcceptancesForExclusionRegions( TDirectory*
             }
         }
     }
-    cout << "\t nfilled = " << nfilled << endl;
+    iLog << "\t nfilled = " << nfilled << endl;
     
     // multiply with total area and scale by number of simulated events
     if( neventssim > 0. )
@@ -1344,7 +1805,14 @@ bool VRadialAcceptance::correctRadialAcceptancesForExclusionRegions( TDirectory*
         for( unsigned int j = 0; j < fRunPar->fRunList.size(); j++ )
         {
             sprintf( numberstring, "_%d", iRunNumber );
-            if( ( int )iRunNumber == ( int )fRunPar->fRunList[j].fRunOff && strstr( h->GetName(), numberstring ) != NULL )
+            // (exact match of the run number at the end of the histogram name:
+            //  runs are corrected in parallel and a run number matching the
+            //  beginning of another run number must not rescale the histogram
+            //  of the other run)
+            string i_hname = h->GetName();
+            if( ( int )iRunNumber == ( int )fRunPar->fRunList[j].fRunOff
+                    && i_hname.size() > strlen( numberstring )
+                    && i_hname.substr( i_hname.size() - strlen( numberstring ) ) == numberstring )
             {
                 h->Divide( hscaleRun[ifocus] );
             }
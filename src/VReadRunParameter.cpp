@@ -140,6 +140,26 @@ bool VReadRunParameter::readCommandline( int argc, char* argv[] )
                 fRunPara->fsourcefile = "";
             }
         }
+        // file with list of events to be analysed
+        else if( iTemp.find( "eventlist" ) < iTemp.size() )
+        {
+            checkSecondArgument( iTemp1, iTemp2, true );
+            if( iTemp2.size() > 0 )
+            {
+                fRunPara->fEventListFile = iTemp2;
+                i++;
+            }
+        }
+        // directory for event index files
+        else if( iTemp.find( "eventindexdir" ) < iTemp.size() )
+        {
+            checkSecondArgument( iTemp1, iTemp2, true );
+            if( iTemp2.size() > 0 )
+            {
+                fRunPara->fEventIndexDirectory = iTemp2;
+                i++;
+            }
+        }
         // pedestal file for grisu simulations
         else if( iTemp.find( "pedestalfile" ) < iTemp.size() )
         {
@@ -650,6 +670,19 @@ bool VReadRunParameter::readCommandline( int argc, char* argv[] )
                 fRunPara->fFirstEvent = -10000;
             }
         }
+        // number of events read ahead by a reader thread
+        else if( iTemp.find( "prefetch" ) < iTemp.size() )
+        {
+            int i_prefetch = atoi( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
+            if( i_prefetch > 0 )
+            {
+                fRunPara->fPrefetchNEvents = ( unsigned int )i_prefetch;
+            }
+            else
+            {
+                fRunPara->fPrefetchNEvents = 0;
+            }
+        }
         // start analyzing at this minute
         else if( iTemp.find( "timecutmin" ) < iTemp.size() )
         {
@@ -910,10 +943,30 @@ bool VReadRunParameter::readCommandline( int argc, char* argv[] )
         {
             fRunPara->fWriteExtraCalibTree = true;
         }
+        else if( iTemp.rfind( "writecalibhistos" ) < iTemp.size() )
+        {
+            fRunPara->fWriteCalibrationHistograms = true;
+        }
+        else if( iTemp.rfind( "calibthreads" ) < iTemp.size() )
+        {
+            int i_threads = atoi( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
+            if( i_threads > 0 )
+            {
+                fRunPara->fCalibrationNThreads = ( unsigned int )i_threads;
+            }
+            else
+            {
+                fRunPara->fCalibrationNThreads = 0;
+            }
+        }
         else if( iTemp.rfind( "writeimagepixellist" ) < iTemp.size() )
         {
             fRunPara->fWriteImagePixelList = true;
         }
+        else if( iTemp.rfind( "sparseimagetree" ) < iTemp.size() )
+        {
+            fRunPara->fWriteSparseImageTree = true;
+        }
         else if( i > 1 )
         {
             cout << "unknown command line parameter: " << iTemp << endl;
@@ -0,0 +1,286 @@
+/*! \class VRunAstrometry
+    \brief run-wise astrometry (precession matrices and tabulated sidereal time)
+    
+    Coordinate transformations for all events of a run:
+    
+    - precession matrices are calculated once per epoch pair
+      (instead of once per event)
+    - local sidereal time is tabulated on a time grid covering the run
+      and linearly interpolated; the maximum interpolation error is
+      measured at initialisation and the grid is refined if required
+    
+    Transformations outside of the tabulated time range fall back to the
+    exact calculation.
+
+*/
+
+#include "VRunAstrometry.h"
+
+VRunAstrometry::VRunAstrometry()
+{
+    fDebug = false;
+    
+    fObsLongitude_rad = VGlobalRunParameter::getObservatory_Longitude_deg() * TMath::DegToRad();
+    fObsLatitude_rad  = VGlobalRunParameter::getObservatory_Latitude_deg() * TMath::DegToRad();
+    
+    fMJD0 = 0;
+    fTime0_s = 0.;
+    fTimeStep_s = 10.;
+    fMaxLSTError_rad = 0.;
+}
+
+/*
+ * initialize astrometry for a run
+ *
+ * iMJDStart, iMJDStopp: run start and end (MJD including fraction of day)
+ * iTimeStep_s:          initial step size of sidereal time table
+ * iMaxError_arcsec:     required maximum interpolation error
+ */
+bool VRunAstrometry::init( double iMJDStart, double iMJDStopp, double iTimeStep_s, double iMaxError_arcsec )
+{
+    fLST.clear();
+    fMaxLSTError_rad = 0.;
+    if( iMJDStart <= 0. || iMJDStopp < iMJDStart || iTimeStep_s <= 0. )
+    {
+        cout << "VRunAstrometry::init: invalid run times (" << iMJDStart << ", " << iMJDStopp << ")";
+        cout << ", using exact calculation for all events" << endl;
+        return false;
+    }
+    fMJD0 = ( int )floor( iMJDStart );
+    // add a margin of one minute on each side
+    fTime0_s = ( iMJDStart - ( double )fMJD0 ) * 86400. - 60.;
+    double i_duration_s = ( iMJDStopp - iMJDStart ) * 86400. + 120.;
+    
+    // refine time step until required precision is reached
+    double i_step = iTimeStep_s;
+    for( unsigned int i = 0; i < 10; i++ )
+    {
+        unsigned int i_n = ( unsigned int )ceil( i_duration_s / i_step ) + 1;
+        fTimeStep_s = i_step;
+        fLST.assign( i_n, 0. );
+        if( !fillLSTTable( i_step ) )
+        {
+            return false;
+        }
+        if( fMaxLSTError_rad * TMath::RadToDeg() * 3600. < iMaxError_arcsec )
+        {
+            break;
+        }
+        i_step *= 0.5;
+    }
+    cout << "\trun astrometry: sidereal time table with " << fLST.size() << " entries (step " << fTimeStep_s << " s)";
+    cout << ", maximum interpolation error " << getMaxInterpolationError_arcsec() << " arcsec" << endl;
+    
+    return true;
+}
+
+/*
+ * fill table of local sidereal time and determine maximum
+ * interpolation error (in the middle of the grid intervals)
+ */
+bool VRunAstrometry::fillLSTTable( double iTimeStep_s )
+{
+    for( unsigned int i = 0; i < fLST.size(); i++ )
+    {
+        fLST[i] = getLST_exact( fMJD0, fTime0_s + ( double )i * iTimeStep_s );
+        // unwrap (sidereal time is monotonically increasing)
+        if( i > 0 )
+        {
+            while( fLST[i] < fLST[i - 1] )
+            {
+                fLST[i] += 2. * TMath::Pi();
+            }
+        }
+    }
+    fMaxLSTError_rad = 0.;
+    for( unsigned int i = 0; i + 1 < fLST.size(); i++ )
+    {
+        double i_mid = getLST_exact( fMJD0, fTime0_s + ( ( double )i + 0.5 ) * iTimeStep_s );
+        double i_diff = VAstronometry::vlaDranrm( i_mid - 0.5 * ( fLST[i] + fLST[i + 1] ) );
+        if( i_diff > TMath::Pi() )
+        {
+            i_diff -= 2. * TMath::Pi();
+        }
+        if( fabs( i_diff ) > fMaxLSTError_rad )
+        {
+            fMaxLSTError_rad = fabs( i_diff );
+        }
+    }
+    return true;
+}
+
+/*
+ * local sidereal time [rad]
+ *
+ * (same calculation as in VSkyCoordinatesUtilities::getHorizontalCoordinates();
+ *  iTime_s might be larger than one day)
+ */
+double VRunAstrometry::getLST_exact( int iMJD, double iTime_s )
+{
+    int i_days = ( int )floor( iTime_s / 86400. );
+    iMJD += i_days;
+    iTime_s -= ( double )i_days * 86400.;
+    return VAstronometry::vlaGmsta( ( double )iMJD, iTime_s / 86400. ) - fObsLongitude_rad;
+}
+
+/*
+ * local sidereal time [rad] interpolated from table
+ */
+double VRunAstrometry::getLST( int iMJD, double iTime_s )
+{
+    double t = ( double )( iMJD - fMJD0 ) * 86400. + iTime_s - fTime0_s;
+    if( fLST.size() < 2 || t < 0. )
+    {
+        return getLST_exact( iMJD, iTime_s );
+    }
+    unsigned int k = ( unsigned int )( t / fTimeStep_s );
+    if( k + 1 >= fLST.size() )
+    {
+        return getLST_exact( iMJD, iTime_s );
+    }
+    double f = t / fTimeStep_s - ( double )k;
+    return fLST[k] + f * ( fLST[k + 1] - fLST[k] );
+}
+
+/*
+ * precession matrix between two epochs
+ *
+ * (columns are the precessed unit vectors; calculated once
+ *  per epoch pair with VAstronometry::vlaPreces())
+ */
+const vector< double >& VRunAstrometry::getPrecessionMatrix( double iMJD_start, double iMJD_end )
+{
+    pair< double, double > i_key( iMJD_start, iMJD_end );
+    map< pair< double, double >, vector< double > >::iterator i_iter = fPrecessionMatrix.find( i_key );
+    if( i_iter != fPrecessionMatrix.end() )
+    {
+        return i_iter->second;
+    }
+    vector< double > m( 9, 0. );
+    double i_ra[]  = { 0., 0.5 * TMath::Pi(), 0. };
+    double i_dec[] = { 0., 0., 0.5 * TMath::Pi() };
+    for( unsigned int c = 0; c < 3; c++ )
+    {
+        VAstronometry::vlaPreces( iMJD_start, iMJD_end, &i_ra[c], &i_dec[c] );
+        m[c]     = cos( i_dec[c] ) * cos( i_ra[c] );
+        m[3 + c] = cos( i_dec[c] ) * sin( i_ra[c] );
+        m[6 + c] = sin( i_dec[c] );
+    }
+    fPrecessionMatrix[i_key] = m;
+    return fPrecessionMatrix[i_key];
+}
+
+/*
+ * precess coordinates (all angles in [rad])
+ */
+void VRunAstrometry::precess( double iMJD_start, double iMJD_end, double& ra_rad, double& dec_rad )
+{
+    const vector< double >& m = getPrecessionMatrix( iMJD_start, iMJD_end );
+    double v[3];
+    v[0] = cos( dec_rad ) * cos( ra_rad );
+    v[1] = cos( dec_rad ) * sin( ra_rad );
+    v[2] = sin( dec_rad );
+    double w[3];
+    for( unsigned int i = 0; i < 3; i++ )
+    {
+        w[i] = m[3 * i] * v[0] + m[3 * i + 1] * v[1] + m[3 * i + 2] * v[2];
+    }
+    ra_rad  = VAstronometry::vlaDranrm( atan2( w[1], w[0] ) );
+    dec_rad = atan2( w[2], sqrt( w[0] * w[0] + w[1] * w[1] ) );
+}
+
+/*
+ * horizontal to equatorial coordinates (current epoch)
+ *
+ * (see VSkyCoordinatesUtilities::getEquatorialCoordinates(); all angles in [deg])
+ */
+void VRunAstrometry::getEquatorialCoordinates( int iMJD, double iTime, double az_deg, double ze_deg, double& dec_deg, double& ra_deg )
+{
+    double ha = 0.;
+    VAstronometry::vlaDh2e( az_deg * TMath::DegToRad(), ( 90. - ze_deg ) * TMath::DegToRad(), fObsLatitude_rad, &ha, &dec_deg );
+    ra_deg = VAstronometry::vlaDranrm( getLST( iMJD, iTime ) - ha );
+    dec_deg *= TMath::RadToDeg();
+    ra_deg  *= TMath::RadToDeg();
+}
+
+/*
+ * equatorial (current epoch) to horizontal coordinates
+ *
+ * (see VSkyCoordinatesUtilities::getHorizontalCoordinates(); all angles in [deg])
+ */
+void VRunAstrometry::getHorizontalCoordinates( int iMJD, double iTime, double dec_deg, double ra_deg, double& az_deg, double& ze_deg )
+{
+    double ha = VAstronometry::vlaDranrm( getLST( iMJD, iTime ) - ra_deg * TMath::DegToRad() );
+    VAstronometry::vlaDe2h( ha, dec_deg * TMath::DegToRad(), fObsLatitude_rad, &az_deg, &ze_deg );
+    ze_deg = 90 - ze_deg * TMath::RadToDeg();
+    az_deg *= TMath::RadToDeg();
+}
+
+/*
+ * azimuth and elevation for a list of events with J2000 coordinates
+ *
+ * (coordinates are precessed to the epoch of each event)
+ */
+void VRunAstrometry::getHorizontalCoordinates_J2000( const vector< int >& iMJD, const vector< double >& iTime,
+        const vector< double >& iRA_J2000_deg, const vector< double >& iDec_J2000_deg,
+        vector< double >& iAz_deg, vector< double >& iEl_deg )
+{
+    unsigned int n = iMJD.size();
+    iAz_deg.assign( n, 0. );
+    iEl_deg.assign( n, 0. );
+    if( iTime.size() != n || iRA_J2000_deg.size() != n || iDec_J2000_deg.size() != n )
+    {
+        cout << "VRunAstrometry::getHorizontalCoordinates_J2000 error: inconsistent vector lengths" << endl;
+        return;
+    }
+    double i_ra = 0.;
+    double i_dec = 0.;
+    double i_ze = 0.;
+    for( unsigned int i = 0; i < n; i++ )
+    {
+        i_ra  = iRA_J2000_deg[i] * TMath::DegToRad();
+        i_dec = iDec_J2000_deg[i] * TMath::DegToRad();
+        precess( 51544.5, ( double )iMJD[i], i_ra, i_dec );
+        getHorizontalCoordinates( iMJD[i], iTime[i], i_dec * TMath::RadToDeg(), i_ra * TMath::RadToDeg(), iAz_deg[i], i_ze );
+        iEl_deg[i] = 90. - i_ze;
+    }
+}
+
+/*
+ * convert derotated camera coordinates to J2000
+ *
+ * (see VSkyCoordinatesUtilities::convert_derotatedCoordinates_to_J2000())
+ */
+void VRunAstrometry::convert_derotatedCoordinates_to_J2000( int iMJD, double iTime,
+        double iTelAz, double iTelEl,
+        double& x, double& y )
+{
+    // get equatorial coordinates for current epoch
+    double i_ra = 0.;
+    double i_dec = 0.;
+    getEquatorialCoordinates( iMJD, iTime, iTelAz, 90. - iTelEl, i_dec, i_ra );
+    // precess coordinates to J2000
+    double i_raJ2000 = i_ra * TMath::DegToRad();
+    double i_decJ2000 = i_dec * TMath::DegToRad();
+    precess( ( double )iMJD, 51544., i_raJ2000, i_decJ2000 );
+    i_raJ2000 *= TMath::RadToDeg();
+    i_decJ2000 *= TMath::RadToDeg();
+    
+    // calculate wobble offset in ra/dec for current epoch
+    double i_decDiff = 0.;
+    double i_raDiff = 0.;
+    VSkyCoordinatesUtilities::getWobbleOffset_in_RADec( y, -x, i_dec, i_ra, i_decDiff, i_raDiff );
+    if( i_raDiff < -180. )
+    {
+        i_raDiff += 360.;
+    }
+    double i_decWobble = ( i_dec + i_decDiff ) * TMath::DegToRad();
+    double i_raWobble  = ( i_ra + i_raDiff ) * TMath::DegToRad();
+    
+    // correct for precession (from current epoch to J2000=MJD51544)
+    precess( ( double )iMJD, 51544., i_raWobble, i_decWobble );
+    i_raWobble *= TMath::RadToDeg();
+    i_decWobble *= TMath::RadToDeg();
+    x = VSkyCoordinatesUtilities::getTargetShiftWest( i_raJ2000, i_decJ2000, i_raWobble, i_decWobble ) * -1.;
+    y = VSkyCoordinatesUtilities::getTargetShiftNorth( i_raJ2000, i_decJ2000, i_raWobble, i_decWobble );
+}
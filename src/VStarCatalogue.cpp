@@ -1,10 +1,116 @@
 /*! \class VStarCatalogue
  *  \brief bright star catalogue
 
+    ascii catalogues are converted on first use into a binary cache
+    (<catalogue>.vcat) with an index of stars in declination bands;
+    the cache is ignored if size or modification time of the
+    ascii catalogue change
+
 */
 
 #include "VStarCatalogue.h"
 
+static const char fStarCatalogueCacheMagic[8] = { 'V', 'S', 'T', 'A', 'R', 'C', 'A', 'T' };
+static const uint32_t fStarCatalogueCacheVersion = 1;
+
+/*
+ * helper functions for reading/writing of binary catalogue cache
+ */
+static void writeCacheString( ofstream& os, const string& iS )
+{
+    uint32_t n = iS.size();
+    os.write( ( char* )&n, sizeof( uint32_t ) );
+    os.write( iS.c_str(), n );
+}
+
+static void writeCacheVector( ofstream& os, const vector< double >& iV )
+{
+    uint32_t n = iV.size();
+    os.write( ( char* )&n, sizeof( uint32_t ) );
+    if( n > 0 )
+    {
+        os.write( ( char* )&iV[0], n * sizeof( double ) );
+    }
+}
+
+static void writeCacheVector( ofstream& os, const vector< string >& iV )
+{
+    uint32_t n = iV.size();
+    os.write( ( char* )&n, sizeof( uint32_t ) );
+    for( unsigned int i = 0; i < iV.size(); i++ )
+    {
+        writeCacheString( os, iV[i] );
+    }
+}
+
+static bool readCacheString( ifstream& is, string& iS )
+{
+    uint32_t n = 0;
+    is.read( ( char* )&n, sizeof( uint32_t ) );
+    if( !is || n > 100000 )
+    {
+        return false;
+    }
+    iS.resize( n );
+    if( n > 0 )
+    {
+        is.read( &iS[0], n );
+    }
+    return ( bool )is;
+}
+
+static bool readCacheVector( ifstream& is, vector< double >& iV )
+{
+    uint32_t n = 0;
+    is.read( ( char* )&n, sizeof( uint32_t ) );
+    if( !is || n > 100000 )
+    {
+        return false;
+    }
+    iV.resize( n );
+    if( n > 0 )
+    {
+        is.read( ( char* )&iV[0], n * sizeof( double ) );
+    }
+    return ( bool )is;
+}
+
+static bool readCacheVector( ifstream& is, vector< string >& iV )
+{
+    uint32_t n = 0;
+    is.read( ( char* )&n, sizeof( uint32_t ) );
+    if( !is || n > 100000 )
+    {
+        return false;
+    }
+    iV.resize( n );
+    for( unsigned int i = 0; i < n; i++ )
+    {
+        if( !readCacheString( is, iV[i] ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * declination band for a given declination
+ */
+static unsigned int getDecBand( double iDec_deg, double iBandWidth_deg, unsigned int iNBands )
+{
+    int i_band = ( int )floor( ( iDec_deg + 90. ) / iBandWidth_deg );
+    if( i_band < 0 )
+    {
+        return 0;
+    }
+    if( i_band >= ( int )iNBands )
+    {
+        return iNBands - 1;
+    }
+    return ( unsigned int )i_band;
+}
+
 
 VStarCatalogue::VStarCatalogue()
 {
@@ -13,6 +119,9 @@ VStarCatalogue::VStarCatalogue()
     fCatalogue = "Hipparcos_MAG8_1997.dat";
     fCatalogueVersion = 0;
 
+    fDecBandWidth_deg = 1.;
+    fCatalogueCacheDirectory = "";
+
     setTelescopePointing();
 }
 
@@ -49,23 +158,26 @@ bool VStarCatalogue::init( double iMJD, string iCatalogue )
     {
         return false;
     }
-    double dec, ra;
+    vector< double > dec( fStars.size(), 0. );
+    vector< double > ra( fStars.size(), 0. );
     double i_b, i_l;
     for( unsigned int i = 0; i < fStars.size(); i++ )
     {
-        dec = fStars[i]->fDec2000 * TMath::Pi() / 180.;
-        ra =  fStars[i]->fRA2000 * TMath::Pi() / 180.;
+        dec[i] = fStars[i]->fDec2000 * TMath::Pi() / 180.;
+        ra[i] =  fStars[i]->fRA2000 * TMath::Pi() / 180.;
         // calculate galac coordinates
-        VAstronometry::vlaEqgal( ra, dec, &i_l, &i_b );
+        VAstronometry::vlaEqgal( ra[i], dec[i], &i_l, &i_b );
         fStars[i]->fRunGalLong1958 = i_l * 180. / TMath::Pi();
-
-        // apply precesssion
-        VAstronometry::vlaPreces( 2451545.0 - 2400000.5, iMJD, &ra, &dec );
-        // calculate ra/dec for current epoch
-        fStars[i]->fDecCurrentEpoch = dec * 180. / TMath::Pi();
-        fStars[i]->fRACurrentEpoch = ra * 180. / TMath::Pi();
         fStars[i]->fRunGalLat1958  = i_b * 180. / TMath::Pi();
     }
+    // apply precesssion (same precession matrix for all stars)
+    VAstronometry::vlaPreces( 2451545.0 - 2400000.5, iMJD, ra, dec );
+    // calculate ra/dec for current epoch
+    for( unsigned int i = 0; i < fStars.size(); i++ )
+    {
+        fStars[i]->fDecCurrentEpoch = dec[i] * 180. / TMath::Pi();
+        fStars[i]->fRACurrentEpoch = ra[i] * 180. / TMath::Pi();
+    }
     return true;
 }
 
@@ -202,7 +314,9 @@ bool VStarCatalogue::readCatalogue()
     // READ VERITAS object catalogue from DB
     if( fCatalogue == "VERITASDB" )
     {
-        return readVERITASsourcesfromDB( "" );
+        bool i_read = readVERITASsourcesfromDB( "" );
+        fillDecBandIndex();
+        return i_read;
     }
     //////////////////////////////////////
 
@@ -231,6 +345,24 @@ bool VStarCatalogue::readCatalogue()
             return false;
         }
     }
+    //////////////////////////////////////
+    // read catalogue from binary cache (if up-to-date)
+    int64_t i_SourceFileSize = 0;
+    int64_t i_SourceFileModTime = 0;
+    struct stat i_stat;
+    if( stat( fCatalogue.c_str(), &i_stat ) == 0 )
+    {
+        i_SourceFileSize = ( int64_t )i_stat.st_size;
+        i_SourceFileModTime = ( int64_t )i_stat.st_mtime;
+    }
+    string iCacheFile = getCatalogueCacheFileName();
+    if( readCatalogueCache( iCacheFile, i_SourceFileSize, i_SourceFileModTime ) )
+    {
+        is.close();
+        return true;
+    }
+    unsigned int i_FirstStar = fStars.size();
+
     string iLine;
     string iLine_sub;
     string iT1;
@@ -464,9 +596,272 @@ bool VStarCatalogue::readCatalogue()
     }
     is.close();
 
+    fillDecBandIndex();
+    // write binary cache (only for a catalogue read into an empty list)
+    if( i_FirstStar == 0 )
+    {
+        writeCatalogueCache( iCacheFile, i_SourceFileSize, i_SourceFileModTime );
+    }
+
     return true;
 }
 
+/*
+ * name of binary cache file
+ *
+ * e.g. Hipparcos_MAG8_1997.dat -> Hipparcos_MAG8_1997.dat.vcat
+ * (same directory as the catalogue, if no cache directory is set)
+ */
+string VStarCatalogue::getCatalogueCacheFileName()
+{
+    string iName = fCatalogue;
+    if( fCatalogueCacheDirectory.size() > 0 )
+    {
+        if( iName.rfind( "/" ) != string::npos )
+        {
+            iName = iName.substr( iName.rfind( "/" ) + 1, iName.size() );
+        }
+        iName = fCatalogueCacheDirectory + "/" + iName;
+    }
+    return iName + ".vcat";
+}
+
+/*
+ * read stars and declination band index from binary cache
+ *
+ * (cache is ignored if the ascii catalogue changed since the cache was written)
+ */
+bool VStarCatalogue::readCatalogueCache( string iCacheFile, int64_t iSourceFileSize, int64_t iSourceFileModTime )
+{
+    ifstream is( iCacheFile.c_str(), ios::binary );
+    if( !is )
+    {
+        return false;
+    }
+    sStarCatalogueCacheHeader i_header;
+    is.read( ( char* )&i_header, sizeof( sStarCatalogueCacheHeader ) );
+    if( !is || memcmp( i_header.fMagic, fStarCatalogueCacheMagic, 8 ) != 0
+            || i_header.fVersion != fStarCatalogueCacheVersion )
+    {
+        cout << "VStarCatalogue::readCatalogueCache: invalid cache file (ignored): " << iCacheFile << endl;
+        return false;
+    }
+    if( i_header.fSourceFileSize != iSourceFileSize || i_header.fSourceFileModTime != iSourceFileModTime )
+    {
+        if( fDebug )
+        {
+            cout << "VStarCatalogue::readCatalogueCache: catalogue changed, cache ignored: " << iCacheFile << endl;
+        }
+        return false;
+    }
+    vector< VStar* > i_Stars;
+    bool i_ok = true;
+    for( uint64_t i = 0; i < i_header.fNStars && i_ok; i++ )
+    {
+        VStar* i_Star = new VStar();
+        i_Stars.push_back( i_Star );
+        uint32_t i_variability = 0;
+        is.read( ( char* )&i_Star->fStarID, sizeof( unsigned int ) );
+        is.read( ( char* )&i_Star->fDec2000, sizeof( double ) );
+        is.read( ( char* )&i_Star->fRA2000, sizeof( double ) );
+        is.read( ( char* )&i_Star->fDecCurrentEpoch, sizeof( double ) );
+        is.read( ( char* )&i_Star->fRACurrentEpoch, sizeof( double ) );
+        is.read( ( char* )&i_Star->fRunGalLong1958, sizeof( double ) );
+        is.read( ( char* )&i_Star->fRunGalLat1958, sizeof( double ) );
+        is.read( ( char* )&i_Star->fBrightness_V, sizeof( double ) );
+        is.read( ( char* )&i_Star->fBrightness_B, sizeof( double ) );
+        is.read( ( char* )&i_Star->fMajorDiameter, sizeof( double ) );
+        is.read( ( char* )&i_Star->fMinorDiameter, sizeof( double ) );
+        is.read( ( char* )&i_Star->fPositionAngle, sizeof( double ) );
+        is.read( ( char* )&i_Star->fMajorDiameter_68, sizeof( double ) );
+        is.read( ( char* )&i_Star->fMinorDiameter_68, sizeof( double ) );
+        is.read( ( char* )&i_Star->fPositionAngle_68, sizeof( double ) );
+        is.read( ( char* )&i_Star->fSignificance, sizeof( double ) );
+        is.read( ( char* )&i_Star->fSpectralIndex, sizeof( double ) );
+        is.read( ( char* )&i_Star->fSpectralIndexError, sizeof( double ) );
+        is.read( ( char* )&i_Star->fCutOff_MeV, sizeof( double ) );
+        is.read( ( char* )&i_Star->fCutOffError_MeV, sizeof( double ) );
+        is.read( ( char* )&i_variability, sizeof( uint32_t ) );
+        is.read( ( char* )&i_Star->fQualityFlag, sizeof( int ) );
+        i_Star->fVariability = ( i_variability != 0 );
+        i_ok = is
+               && readCacheString( is, i_Star->fStarName )
+               && readCacheString( is, i_Star->fSpectrumType )
+               && readCacheString( is, i_Star->fType )
+               && readCacheVector( is, i_Star->fFluxEnergyMin )
+               && readCacheVector( is, i_Star->fFluxEnergyMax )
+               && readCacheVector( is, i_Star->fFlux )
+               && readCacheVector( is, i_Star->fFluxError )
+               && readCacheVector( is, i_Star->fOtherNames )
+               && readCacheVector( is, i_Star->fAssociations );
+    }
+    // declination band index
+    vector< vector< unsigned int > > i_DecBandIndex( i_header.fNDecBands );
+    for( unsigned int b = 0; b < i_header.fNDecBands && i_ok; b++ )
+    {
+        uint32_t n = 0;
+        is.read( ( char* )&n, sizeof( uint32_t ) );
+        if( !is || n > i_header.fNStars )
+        {
+            i_ok = false;
+            break;
+        }
+        i_DecBandIndex[b].resize( n );
+        if( n > 0 )
+        {
+            is.read( ( char* )&i_DecBandIndex[b][0], n * sizeof( unsigned int ) );
+        }
+        i_ok = !is.fail();
+    }
+    if( !i_ok )
+    {
+        cout << "VStarCatalogue::readCatalogueCache: error reading cache file (ignored): " << iCacheFile << endl;
+        for( unsigned int i = 0; i < i_Stars.size(); i++ )
+        {
+            delete i_Stars[i];
+        }
+        return false;
+    }
+    cout << "\treading star catalogue: " << fCatalogue << " (from cache " << iCacheFile << ")" << endl;
+    fCatalogueVersion = i_header.fCatalogueVersion;
+    if( fStars.size() == 0
+            && i_DecBandIndex.size() == ( unsigned int )( 180. / fDecBandWidth_deg + 0.5 ) )
+    {
+        fStars.swap( i_Stars );
+        fDecBandIndex.swap( i_DecBandIndex );
+    }
+    else
+    {
+        fStars.insert( fStars.end(), i_Stars.begin(), i_Stars.end() );
+        fillDecBandIndex();
+    }
+
+    return true;
+}
+
+/*
+ * write stars and declination band index into binary cache
+ *
+ * (cache file is written to a temporary file first, as several
+ *  jobs might read the same catalogue concurrently)
+ */
+bool VStarCatalogue::writeCatalogueCache( string iCacheFile, int64_t iSourceFileSize, int64_t iSourceFileModTime )
+{
+    if( iSourceFileSize == 0 && iSourceFileModTime == 0 )
+    {
+        return false;
+    }
+    ostringstream i_TempFile;
+    i_TempFile << iCacheFile << ".tmp." << gSystem->GetPid();
+    ofstream os( i_TempFile.str().c_str(), ios::binary | ios::trunc );
+    if( !os )
+    {
+        cout << "\tstar catalogue cache not written (no write access): " << iCacheFile << endl;
+        return false;
+    }
+    sStarCatalogueCacheHeader i_header;
+    memset( &i_header, 0, sizeof( sStarCatalogueCacheHeader ) );
+    memcpy( i_header.fMagic, fStarCatalogueCacheMagic, 8 );
+    i_header.fVersion = fStarCatalogueCacheVersion;
+    i_header.fCatalogueVersion = fCatalogueVersion;
+    i_header.fSourceFileSize = iSourceFileSize;
+    i_header.fSourceFileModTime = iSourceFileModTime;
+    i_header.fNStars = fStars.size();
+    i_header.fNDecBands = fDecBandIndex.size();
+    os.write( ( char* )&i_header, sizeof( sStarCatalogueCacheHeader ) );
+    for( unsigned int i = 0; i < fStars.size(); i++ )
+    {
+        uint32_t i_variability = ( fStars[i]->fVariability ? 1 : 0 );
+        os.write( ( char* )&fStars[i]->fStarID, sizeof( unsigned int ) );
+        os.write( ( char* )&fStars[i]->fDec2000, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fRA2000, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fDecCurrentEpoch, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fRACurrentEpoch, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fRunGalLong1958, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fRunGalLat1958, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fBrightness_V, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fBrightness_B, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fMajorDiameter, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fMinorDiameter, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fPositionAngle, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fMajorDiameter_68, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fMinorDiameter_68, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fPositionAngle_68, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fSignificance, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fSpectralIndex, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fSpectralIndexError, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fCutOff_MeV, sizeof( double ) );
+        os.write( ( char* )&fStars[i]->fCutOffError_MeV, sizeof( double ) );
+        os.write( ( char* )&i_variability, sizeof( uint32_t ) );
+        os.write( ( char* )&fStars[i]->fQualityFlag, sizeof( int ) );
+        writeCacheString( os, fStars[i]->fStarName );
+        writeCacheString( os, fStars[i]->fSpectrumType );
+        writeCacheString( os, fStars[i]->fType );
+        writeCacheVector( os, fStars[i]->fFluxEnergyMin );
+        writeCacheVector( os, fStars[i]->fFluxEnergyMax );
+        writeCacheVector( os, fStars[i]->fFlux );
+        writeCacheVector( os, fStars[i]->fFluxError );
+        writeCacheVector( os, fStars[i]->fOtherNames );
+        writeCacheVector( os, fStars[i]->fAssociations );
+    }
+    for( unsigned int b = 0; b < fDecBandIndex.size(); b++ )
+    {
+        uint32_t n = fDecBandIndex[b].size();
+        os.write( ( char* )&n, sizeof( uint32_t ) );
+        if( n > 0 )
+        {
+            os.write( ( char* )&fDecBandIndex[b][0], n * sizeof( unsigned int ) );
+        }
+    }
+    os.close();
+    if( !os || rename( i_TempFile.str().c_str(), iCacheFile.c_str() ) != 0 )
+    {
+        cout << "\tstar catalogue cache not written: " << iCacheFile << endl;
+        remove( i_TempFile.str().c_str() );
+        return false;
+    }
+    cout << "\twriting star catalogue cache: " << iCacheFile << endl;
+    return true;
+}
+
+/*
+ * sort stars into declination bands (J2000)
+ */
+void VStarCatalogue::fillDecBandIndex()
+{
+    unsigned int i_NBands = ( unsigned int )( 180. / fDecBandWidth_deg + 0.5 );
+    fDecBandIndex.assign( i_NBands, vector< unsigned int >() );
+    for( unsigned int i = 0; i < fStars.size(); i++ )
+    {
+        if( fStars[i] )
+        {
+            fDecBandIndex[getDecBand( fStars[i]->fDec2000, fDecBandWidth_deg, i_NBands )].push_back( i );
+        }
+    }
+}
+
+/*
+ * list of stars (index in fStars) in declination range (J2000)
+ *
+ * list is sorted, i.e. the order of stars in the catalogue is kept
+ */
+vector< unsigned int > VStarCatalogue::getStarsInDecRange( double iDecMin_deg, double iDecMax_deg )
+{
+    vector< unsigned int > i_stars;
+    if( fDecBandIndex.size() == 0 )
+    {
+        fillDecBandIndex();
+    }
+    unsigned int i_bmin = getDecBand( iDecMin_deg, fDecBandWidth_deg, fDecBandIndex.size() );
+    unsigned int i_bmax = getDecBand( iDecMax_deg, fDecBandWidth_deg, fDecBandIndex.size() );
+    for( unsigned int b = i_bmin; b <= i_bmax && b < fDecBandIndex.size(); b++ )
+    {
+        i_stars.insert( i_stars.end(), fDecBandIndex[b].begin(), fDecBandIndex[b].end() );
+    }
+    sort( i_stars.begin(), i_stars.end() );
+    return i_stars;
+}
+
 VStar* VStarCatalogue::readCommaSeparatedLine_FAVA( string iLine, int zid, VStar* i_Star )
 {
     string iT1;
@@ -1358,8 +1753,19 @@ unsigned int VStarCatalogue::setFOV( double ra, double dec, double iFOV_x, doubl
     double iRA = 0.;
     double iDec = 0.;
 
-    for( unsigned int i = 0; i < fStars.size(); i++ )
+    // preselect stars in declination bands around the FOV centre
+    // (distance on the sky is smaller than the distance in the tangential plane;
+    //  current epoch coordinates differ from J2000 by less than 1 deg)
+    double i_r = sqrt( iFOV_x * iFOV_x + iFOV_y * iFOV_y );
+    if( !bJ2000 )
+    {
+        i_r += 1.;
+    }
+    vector< unsigned int > i_candidates = getStarsInDecRange( dec - i_r, dec + i_r );
+
+    for( unsigned int c = 0; c < i_candidates.size(); c++ )
     {
+        unsigned int i = i_candidates[c];
         if( iBand == "B" && fStars[i]->fBrightness_B > iBrightness )
         {
             continue;
@@ -1401,10 +1807,50 @@ unsigned int VStarCatalogue::setFOV( double ra, double dec, double iFOV_x, doubl
 }
 
 
+/*!
+
+    cone search: list of stars within iRadius_deg around ra/dec
+
+    all angles in [deg]
+*/
+vector< VStar* > VStarCatalogue::getStarsInCone( double ra, double dec, double iRadius_deg, bool bJ2000, double iBrightness, string iBand )
+{
+    vector< VStar* > i_stars;
+
+    double i_r = iRadius_deg;
+    if( !bJ2000 )
+    {
+        i_r += 1.;
+    }
+    vector< unsigned int > i_candidates = getStarsInDecRange( dec - i_r, dec + i_r );
+
+    for( unsigned int c = 0; c < i_candidates.size(); c++ )
+    {
+        VStar* i_Star = fStars[i_candidates[c]];
+        if( iBand == "B" && i_Star->fBrightness_B > iBrightness )
+        {
+            continue;
+        }
+        else if( iBand == "V" && i_Star->fBrightness_V > iBrightness )
+        {
+            continue;
+        }
+        double iRA = ( bJ2000 ? i_Star->fRA2000 : i_Star->fRACurrentEpoch );
+        double iDec = ( bJ2000 ? i_Star->fDec2000 : i_Star->fDecCurrentEpoch );
+        if( VAstronometry::vlaDsep( iRA * TMath::DegToRad(), iDec * TMath::DegToRad(),
+                                    ra * TMath::DegToRad(), dec * TMath::DegToRad() ) * TMath::RadToDeg() <= iRadius_deg )
+        {
+            i_stars.push_back( i_Star );
+        }
+    }
+    return i_stars;
+}
+
 void VStarCatalogue::purge()
 {
     fStars.clear();
     fStars.swap( fStars );
+    fDecBandIndex.clear();
 }
 
 
@@ -4,6 +4,11 @@
 */
 
 #include "VStereoAnalysis.h"
+#ifdef RUNWITHFITS
+#include "VDL3FITSWriter.h"
+#endif
+
+#include <sstream>
 
 VStereoAnalysis::VStereoAnalysis( bool ion, string i_hsuffix, VAnaSumRunParameter* irunpara, vector< TDirectory* > iDirRun,
                                   TDirectory* iDirTot, string iDataDir, int iRandomSeed, bool iTotalAnalysisOnly )
@@ -38,12 +43,11 @@ VStereoAnalysis::VStereoAnalysis( bool ion, string i_hsuffix, VAnaSumRunParamete
     
     fRunPara = irunpara;
     fDL3EventTree = 0;
+    fDL3_Acceptance = 0;
+    fDL3FITSWriter = 0;
     fDeadTimeStorage = 0.;
     
-    fVsky = new VSkyCoordinates() ;
-    fVsky->supressStdoutText( true ) ;
-    fVsky->setObservatory( VGlobalRunParameter::getObservatory_Longitude_deg(),
-                           VGlobalRunParameter::getObservatory_Latitude_deg() );
+    fRunAstrometry = new VRunAstrometry();
                            
     // calculating run start, end and duration (verifies data trees)
     if( !bTotalAnalysisOnly )
@@ -129,10 +133,16 @@ VStereoAnalysis::VStereoAnalysis( bool ion, string i_hsuffix, VAnaSumRunParamete
 
 VStereoAnalysis::~VStereoAnalysis()
 {
-    if( fVsky )
+    if( fRunAstrometry )
+    {
+        delete fRunAstrometry;
+    }
+#ifdef RUNWITHFITS
+    if( fDL3FITSWriter )
     {
-        delete fVsky;
+        delete fDL3FITSWriter;
     }
+#endif
     if( fHistoTot )
     {
         delete fHistoTot;
@@ -222,7 +232,7 @@ string  VStereoAnalysis::setRunTimes( CData* iData )
     i_minMJD = fDataRun->MJD;
     i_minUTC = VSkyCoordinatesUtilities::getUTC( ( int )i_minMJD, i_min );
     
-    int i_nentries = ( int )fDataRun->fChain->GetEntries() - 2;
+    int i_nentries = ( int )fDataRun->getEntries() - 2;
     fDataRun->GetEntry( i_nentries );
     i_max = fDataRun->Time;
     f_t_in_s_max[i_run] = i_max;
@@ -274,7 +284,10 @@ int VStereoAnalysis::getDataRunNumber() const
         else if( fDataRun->GetEntry( 0 ) == 0 )
         {
             cout << "VStereoAnalysis::getDataRunNumber error: tree is empty." << endl;
-            fDataRun->fChain->Print();
+            if( fDataRun->fChain )
+            {
+                fDataRun->fChain->Print();
+            }
         }
         else
         {
@@ -332,7 +345,7 @@ double VStereoAnalysis::fillHistograms( int icounter, int irun, double iAzMin, d
     
     // set pointer to data tree (run wise)
     fDataRun = getDataFromFile( irun );
-    if( fDataRun == 0 || fDataRunTree == 0 )
+    if( fDataRun == 0 )
     {
         cout << "VStereoAnalysis::fillHistograms error, no data tree " << endl;
         cout << "\t" << fDataRun << "\t" << fDataRunTree << endl;
@@ -364,6 +377,8 @@ double VStereoAnalysis::fillHistograms( int icounter, int irun, double iAzMin, d
         }
         iMJDStopp = fRunMJDStopp[irun];
     }
+    // run-wise astrometry (precession matrices, sidereal time)
+    fRunAstrometry->init( iMJDStart, iMJDStopp );
     //////////////////////////////////////////
     // boolean for gamma/hadron cuts
     
@@ -465,8 +480,8 @@ double VStereoAnalysis::fillHistograms( int icounter, int irun, double iAzMin, d
     double iDirectionOffset = 0.;
     
     // get number of entries from data tree
-    Int_t nentries = Int_t( fDataRun->fChain->GetEntries() );
-    if( fDebug )
+    Int_t nentries = Int_t( fDataRun->getEntries() );
+    if( fDebug && fDataRun->fChain )
     {
         cout << "DEBUG double VStereoAnalysis::fillHistograms() reading chain " << fDataRun->fChain->GetName() << "\t" << nentries << endl;
     }
@@ -751,6 +766,12 @@ double VStereoAnalysis::fillHistograms( int icounter, int irun, double iAzMin, d
     // END: loop over all entries/events in the data tree
     /////////////////////////////////////////////////////////////////////
     
+    // fill remaining events into DL3 tree / FITS event list
+    if( fIsOn )
+    {
+        flush_DL3Tree();
+    }
+    
     // filling the effective area for last time bin
     // fill energy histograms: require a valid effective area value
     if( iEnergyWeighting > 0. )
@@ -769,6 +790,12 @@ double VStereoAnalysis::fillHistograms( int icounter, int irun, double iAzMin, d
     fDeadTime[fHisCounter]->checkStatus();
     fDeadTime[fHisCounter]->printDeadTime();
     
+    // DL3 event list (requires final time mask and dead time)
+    if( fIsOn )
+    {
+        close_DL3FITSEventList( iMJDStart, iMJDStopp );
+    }
+    
     // filling the histo with the duration of the time bin
     // looping over the mask seconds
     for( unsigned int i_s = 0 ; i_s < fTimeMask->getMaskSize() ; i_s++ )
@@ -929,7 +956,7 @@ void VStereoAnalysis::writeHistograms( bool bOn )
                 fHisto[fHisCounter]->writeObjects( fRunPara->fRunList[fHisCounter].fEffectiveAreaFile, "EffectiveAreas", gTimeBinnedMeanEffectiveArea );
             }
         }
-        if( fDL3EventTree && fIsOn )
+        if( fIsOn )
         {
             write_DL3Tree() ;
         }
@@ -1870,13 +1897,25 @@ CData* VStereoAnalysis::getDataFromFile( int i_runNumber )
             exit( EXIT_FAILURE );
         }
         fDataRunTree = ( TTree* )fDataFile->Get( "data" );
-        if( !fDataRunTree )
+#ifdef RUNWITHRNTUPLE
+        // columnar event data (used if available)
+        VRNTupleReader* iRNTuple = VRNTupleReader::open( fDataFile );
+        if( iRNTuple )
         {
-            cout << "VStereoAnalysis::getDataFromFile() error: cannot find data tree in " << iFileName << endl;
-            cout << "exiting..." << endl;
-            exit( EXIT_FAILURE );
+            cout << "VStereoAnalysis::getDataFromFile() reading event data from RNTuple" << endl;
+            c = new CData( iRNTuple );
+        }
+#endif
+        if( !c )
+        {
+            if( !fDataRunTree )
+            {
+                cout << "VStereoAnalysis::getDataFromFile() error: cannot find data tree in " << iFileName << endl;
+                cout << "exiting..." << endl;
+                exit( EXIT_FAILURE );
+            }
+            c = new CData( fDataRunTree );
         }
-        c = new CData( fDataRunTree );
         // read current (major) epoch from data file
         VEvndispRunParameter* i_runPara = ( VEvndispRunParameter* )fDataFile->Get( "runparameterV2" );
         if( i_runPara )
@@ -2093,7 +2132,7 @@ void VStereoAnalysis::getDerotatedCoordinates( unsigned int icounter, CData* iDa
     y_derot = iDataRun->getYoff_derot();
     
     // convert de-rotated camera coordinates to J2000
-    VSkyCoordinatesUtilities::convert_derotatedCoordinates_to_J2000(
+    fRunAstrometry->convert_derotatedCoordinates_to_J2000(
         fDataRun->MJD, fDataRun->Time,
         iDataRun->ArrayPointing_Azimuth, iDataRun->ArrayPointing_Elevation,
         x_derot, y_derot );
@@ -2127,12 +2166,33 @@ bool VStereoAnalysis::init_DL3Tree( int irun, int icounter )
     if( fDL3EventTree )
     {
         delete fDL3EventTree;
+        fDL3EventTree = 0;
     }
+    fDL3EventBuffer.clear();
     if( !fRunPara )
     {
         return false;
     }
     
+    // DL3 event list in FITS format
+    bool bFITSEventList = false;
+    if( fRunPara->fWriteDL3EventList > 0 )
+    {
+        bFITSEventList = init_DL3FITSEventList( irun, icounter );
+    }
+    // no DL3 tree required
+    // (unless FITS event list cannot be written)
+    if( fRunPara->fWriteDL3EventList > 1 )
+    {
+        if( bFITSEventList )
+        {
+            init_DL3Acceptance( icounter );
+            return true;
+        }
+        cout << "VStereoAnalysis::init_DL3Tree warning: no DL3 FITS event list for run " << irun;
+        cout << "; writing DL3 event tree instead" << endl;
+    }
+    
     char htitle[200];
     sprintf( htitle, "DL3 event list for run %d", irun );
     fDL3EventTree = new TTree( "DL3EventTree", htitle );
@@ -2161,21 +2221,84 @@ bool VStereoAnalysis::init_DL3Tree( int irun, int icounter )
     fDL3EventTree->Branch( "Acceptance"    , &fDL3EventTree_Acceptance    , "Acceptance/D" );
     cout << endl;
     
-    // init radial acceptance class
+    init_DL3Acceptance( icounter );
+    return true;
+}
+
+/*
+ * init radial acceptance class for DL3 event lists
+ */
+void VStereoAnalysis::init_DL3Acceptance( int icounter )
+{
+    if( fDL3_Acceptance )
+    {
+        delete fDL3_Acceptance;
+        fDL3_Acceptance = 0;
+    }
     if( icounter < ( int )fRunPara->fRunList.size() )
     {
         fDL3_Acceptance = new VRadialAcceptance( fRunPara->fRunList[icounter].fAcceptanceFile ) ;
         fDL3_Acceptance->Set2DAcceptanceMode( fRunPara->fRunList[icounter].f2DAcceptanceMode ) ;
     }
-    else
+}
+
+/*
+ * open FITS file for DL3 event list
+ *
+ * (file name: <DL3FITSDIRECTORY>/<run>.dl3.fits)
+ */
+bool VStereoAnalysis::init_DL3FITSEventList( int irun, int icounter )
+{
+#ifdef RUNWITHFITS
+    if( !fDL3FITSWriter )
     {
-        fDL3_Acceptance = 0;
+        fDL3FITSWriter = new VDL3FITSWriter();
+    }
+    ostringstream iFileName;
+    iFileName << fRunPara->fDL3FITSDirectory << "/" << irun << ".dl3.fits";
+    if( !fDL3FITSWriter->open( iFileName.str(), irun ) )
+    {
+        cout << "VStereoAnalysis::init_DL3FITSEventList error opening " << iFileName.str() << endl;
+        return false;
     }
+    if( icounter < ( int )fRunPara->fRunList.size() )
+    {
+        fDL3FITSWriter->setTarget( fRunPara->fRunList[icounter].fTarget,
+                                   fRunPara->fRunList[icounter].fTargetRAJ2000,
+                                   fRunPara->fRunList[icounter].fTargetDecJ2000,
+                                   fRunPara->fRunList[icounter].fTargetRAJ2000 - getWobbleWest(),
+                                   fRunPara->fRunList[icounter].fTargetDecJ2000 + getWobbleNorth() );
+    }
+    fDL3FITSWriter->setObservatory( fRunPara->getObservatory(),
+                                    fRunPara->getObservatory_Longitude_deg(),
+                                    fRunPara->getObservatory_Latitude_deg(),
+                                    fRunPara->getObservatory_Height_m() );
     return true;
+#else
+    cout << "VStereoAnalysis::init_DL3FITSEventList warning: no FITS support; DL3 FITS event list for run ";
+    cout << irun << " is not written" << endl;
+    return false;
+#endif
 }
 
 /*
- *  fill a new event into the DL3 tree
+ * write remaining events, header and good time intervals
+ * to the DL3 FITS event list
+ */
+void VStereoAnalysis::close_DL3FITSEventList( double iMJDStart, double iMJDStopp )
+{
+#ifdef RUNWITHFITS
+    if( fDL3FITSWriter && fDL3FITSWriter->isOpen() )
+    {
+        fDL3FITSWriter->close( iMJDStart, iMJDStopp, fTimeMask, getDeadTimeFraction() );
+    }
+#endif
+}
+
+/*
+ *  fill a new event into the DL3 event buffer
+ *
+ *  (events are written to the DL3 tree with flush_DL3Tree())
  */
 void VStereoAnalysis::fill_DL3Tree( CData* c , double i_xderot, double i_yderot, unsigned int icounter, double i_UTC )
 {
@@ -2184,30 +2307,32 @@ void VStereoAnalysis::fill_DL3Tree( CData* c , double i_xderot, double i_yderot,
         return;
     }
     
-    fDL3EventTree_runNumber    = c->runNumber;    // Run Number
-    fDL3EventTree_eventNumber  = c->eventNumber;  // Event Number
-    fDL3EventTree_Time         = c->Time;         // Time of day (seconds) of gamma ray event
-    fDL3EventTree_MJD          = c->MJD;          // Day of epoch (days)
-    fDL3EventTree_Xoff         = c->getXoff();         // Gamma Point-Of-Origin, in camera coodinates (deg)
-    fDL3EventTree_Yoff         = c->getYoff();         // Gamma Point-Of-Origin, in camera coodinates (deg)
-    fDL3EventTree_Xderot   = i_xderot;        // Derotated Gamma Point-Of-Origin (deg, RA)
-    fDL3EventTree_Yderot   = i_yderot;        // Derotated Gamma Point-Of-Origin (deg, DEC)
-    fDL3EventTree_Erec        = c->getEnergy_TeV();        // Reconstructed Gamma Energy (TeV)
-    fDL3EventTree_dE          = c->getEnergyDelta();          // Reconstructed Gamma Energy (TeV) Error
-    fDL3EventTree_Xcore = c->getXcore_M();        // Gamma Ray Core-Ground intersection location (north?)
-    fDL3EventTree_Ycore = c->getYcore_M();        // Gamma Ray Core-Ground intersection location (east?)
-    fDL3EventTree_NImages      = c->getNImages();      // Number of images used in reconstruction?
-    fDL3EventTree_ImgSel       = c->getImgSel();       // 4-bit binary code describing which telescopes had images
-    fDL3EventTree_MSCW         = c->MSCW ;        // mean scaled width
-    fDL3EventTree_MSCL         = c->MSCL ;        // mean scaled length
-    fDL3EventTree_EmissionHeight = c->EmissionHeight ; // height of shower maximum (in km) above telescope z-plane
+    sDL3Event i_event;
+    i_event.runNumber    = c->runNumber;    // Run Number
+    i_event.eventNumber  = c->eventNumber;  // Event Number
+    i_event.Time         = c->Time;         // Time of day (seconds) of gamma ray event
+    i_event.MJD          = c->MJD;          // Day of epoch (days)
+    i_event.Xoff         = c->getXoff();         // Gamma Point-Of-Origin, in camera coodinates (deg)
+    i_event.Yoff         = c->getYoff();         // Gamma Point-Of-Origin, in camera coodinates (deg)
+    i_event.Xderot       = i_xderot;        // Derotated Gamma Point-Of-Origin (deg, RA)
+    i_event.Yderot       = i_yderot;        // Derotated Gamma Point-Of-Origin (deg, DEC)
+    i_event.Erec         = c->getEnergy_TeV();        // Reconstructed Gamma Energy (TeV)
+    i_event.Erec_Err     = fDL3EventTree_Erec_Err;
+    i_event.dE           = c->getEnergyDelta();          // Reconstructed Gamma Energy (TeV) Error
+    i_event.Xcore        = c->getXcore_M();        // Gamma Ray Core-Ground intersection location (north?)
+    i_event.Ycore        = c->getYcore_M();        // Gamma Ray Core-Ground intersection location (east?)
+    i_event.NImages      = c->getNImages();      // Number of images used in reconstruction?
+    i_event.ImgSel       = c->getImgSel();       // 4-bit binary code describing which telescopes had images
+    i_event.MSCW         = c->MSCW ;        // mean scaled width
+    i_event.MSCL         = c->MSCL ;        // mean scaled length
+    i_event.EmissionHeight = c->EmissionHeight ; // height of shower maximum (in km) above telescope z-plane
     if( fDL3_Acceptance )
     {
-        fDL3EventTree_Acceptance     = fDL3_Acceptance->getAcceptance( c->Xoff, c->Yoff );
+        i_event.Acceptance     = fDL3_Acceptance->getAcceptance( c->Xoff, c->Yoff );
     }
     else
     {
-        fDL3EventTree_Acceptance     = 0.;
+        i_event.Acceptance     = 0.;
     }
     // get event ra and dec
     if( icounter < fRunPara->fRunList.size() )
@@ -2216,35 +2341,109 @@ void VStereoAnalysis::fill_DL3Tree( CData* c , double i_xderot, double i_yderot,
         double i_centerpoint_dec = ( fRunPara->fRunList[icounter].fTargetDecJ2000 + getWobbleNorth() );
         double i_Spherical_RA  = 0.;
         double i_Spherical_DEC = 0.;
-        VAstronometry::vlaDtp2s( fDL3EventTree_Xderot * TMath::DegToRad(),
-                                 fDL3EventTree_Yderot * TMath::DegToRad(),
+        VAstronometry::vlaDtp2s( i_event.Xderot * TMath::DegToRad(),
+                                 i_event.Yderot * TMath::DegToRad(),
                                  i_centerpoint_RA * TMath::DegToRad(),
                                  i_centerpoint_dec * TMath::DegToRad(),
                                  &i_Spherical_RA, &i_Spherical_DEC );
-        fDL3EventTree_RA  = i_Spherical_RA * TMath::RadToDeg();
-        fDL3EventTree_DEC = i_Spherical_DEC * TMath::RadToDeg();
-        
-        // Convert from spherical RA and DEC to Azimuth and Zenith
-        // convert to degrees and do calculation
-        fVsky->setTargetJ2000( i_Spherical_DEC * TMath::RadToDeg(), i_Spherical_RA * TMath::RadToDeg() );
-        fVsky->precessTarget( fDL3EventTree_MJD, 0 ) ;
-        
-        // calculate new param
-        fVsky->updatePointing( fDL3EventTree_MJD, fDL3EventTree_Time ) ;
-        fDL3EventTree_Az = fVsky->getTargetAzimuth();
-        fDL3EventTree_El = fVsky->getTargetElevation();
-        
+        i_event.RA  = i_Spherical_RA * TMath::RadToDeg();
+        i_event.DEC = i_Spherical_DEC * TMath::RadToDeg();
+        i_event.bDirection = true;
     }
     else
     {
-        fDL3EventTree_RA = 0.;
-        fDL3EventTree_DEC = 0.;
+        i_event.RA = 0.;
+        i_event.DEC = 0.;
+        i_event.bDirection = false;
     }
+    fDL3EventBuffer.push_back( i_event );
     
-    if( fDL3EventTree )
+    // limit size of event buffer
+    if( fDL3EventBuffer.size() >= 100000 )
+    {
+        flush_DL3Tree();
+    }
+}
+
+/*
+ *  calculate azimuth and elevation for all buffered events
+ *  and fill them into the DL3 tree
+ *
+ *  (Az/El from J2000 coordinates precessed to the epoch of the event)
+ */
+void VStereoAnalysis::flush_DL3Tree()
+{
+    if( fDL3EventBuffer.size() == 0 )
     {
-        fDL3EventTree->Fill();
+        return;
     }
+    unsigned int n = fDL3EventBuffer.size();
+    vector< int > i_MJD( n, 0 );
+    vector< double > i_Time( n, 0. );
+    vector< double > i_RA( n, 0. );
+    vector< double > i_DEC( n, 0. );
+    for( unsigned int i = 0; i < n; i++ )
+    {
+        i_MJD[i]  = fDL3EventBuffer[i].MJD;
+        i_Time[i] = fDL3EventBuffer[i].Time;
+        i_RA[i]   = fDL3EventBuffer[i].RA;
+        i_DEC[i]  = fDL3EventBuffer[i].DEC;
+    }
+    vector< double > i_Az;
+    vector< double > i_El;
+    fRunAstrometry->getHorizontalCoordinates_J2000( i_MJD, i_Time, i_RA, i_DEC, i_Az, i_El );
+    
+    for( unsigned int i = 0; i < n; i++ )
+    {
+        fDL3EventTree_runNumber    = fDL3EventBuffer[i].runNumber;
+        fDL3EventTree_eventNumber  = fDL3EventBuffer[i].eventNumber;
+        fDL3EventTree_Time         = fDL3EventBuffer[i].Time;
+        fDL3EventTree_MJD          = fDL3EventBuffer[i].MJD;
+        fDL3EventTree_Xoff         = fDL3EventBuffer[i].Xoff;
+        fDL3EventTree_Yoff         = fDL3EventBuffer[i].Yoff;
+        fDL3EventTree_Xderot       = fDL3EventBuffer[i].Xderot;
+        fDL3EventTree_Yderot       = fDL3EventBuffer[i].Yderot;
+        fDL3EventTree_Erec         = fDL3EventBuffer[i].Erec;
+        fDL3EventTree_Erec_Err     = fDL3EventBuffer[i].Erec_Err;
+        fDL3EventTree_dE           = fDL3EventBuffer[i].dE;
+        fDL3EventTree_Xcore        = fDL3EventBuffer[i].Xcore;
+        fDL3EventTree_Ycore        = fDL3EventBuffer[i].Ycore;
+        fDL3EventTree_NImages      = fDL3EventBuffer[i].NImages;
+        fDL3EventTree_ImgSel       = fDL3EventBuffer[i].ImgSel;
+        fDL3EventTree_MSCW         = fDL3EventBuffer[i].MSCW;
+        fDL3EventTree_MSCL         = fDL3EventBuffer[i].MSCL;
+        fDL3EventTree_EmissionHeight = fDL3EventBuffer[i].EmissionHeight;
+        fDL3EventTree_Acceptance   = fDL3EventBuffer[i].Acceptance;
+        fDL3EventTree_RA           = fDL3EventBuffer[i].RA;
+        fDL3EventTree_DEC          = fDL3EventBuffer[i].DEC;
+        if( fDL3EventBuffer[i].bDirection )
+        {
+            fDL3EventTree_Az = i_Az[i];
+            fDL3EventTree_El = i_El[i];
+        }
+        else
+        {
+            fDL3EventTree_Az = 0.;
+            fDL3EventTree_El = 0.;
+        }
+        if( fDL3EventTree )
+        {
+            fDL3EventTree->Fill();
+        }
+#ifdef RUNWITHFITS
+        if( fDL3FITSWriter && fDL3FITSWriter->isOpen() )
+        {
+            fDL3FITSWriter->fill( fDL3EventTree_eventNumber, fDL3EventTree_MJD, fDL3EventTree_Time,
+                                  fDL3EventTree_RA, fDL3EventTree_DEC, fDL3EventTree_Erec,
+                                  fDL3EventTree_El, fDL3EventTree_Az, fDL3EventTree_NImages,
+                                  fDL3EventTree_Xoff, fDL3EventTree_Yoff,
+                                  fDL3EventTree_Xcore, fDL3EventTree_Ycore,
+                                  fDL3EventTree_MSCW, fDL3EventTree_MSCL,
+                                  fDL3EventTree_EmissionHeight, fDL3EventTree_Acceptance );
+        }
+#endif
+    }
+    fDL3EventBuffer.clear();
 }
 
 /*
@@ -2253,14 +2452,19 @@ void VStereoAnalysis::fill_DL3Tree( CData* c , double i_xderot, double i_yderot,
 */
 void VStereoAnalysis::write_DL3Tree()
 {
-    fDL3EventTree->Write();
-    
-    fRunPara->SetName( "VAnaSumRunParameter" );
-    fRunPara->Write() ;
+    flush_DL3Tree();
+    if( fDL3EventTree )
+    {
+        fDL3EventTree->Write();
+        
+        fRunPara->SetName( "VAnaSumRunParameter" );
+        fRunPara->Write() ;
+    }
     
     // cleanup
     if( fDL3_Acceptance )
     {
         delete fDL3_Acceptance;
+        fDL3_Acceptance = 0;
     }
 }
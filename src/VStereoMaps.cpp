@@ -25,6 +25,10 @@
 
 #include "VStereoMaps.h"
 
+#include <atomic>
+#include <iomanip>
+#include <thread>
+
 VStereoMaps::VStereoMaps( bool iuc, int iRandomSeed, bool iTMPL_RE_nMaxoffsource )
 {
     fData = 0;
@@ -58,6 +62,11 @@ VStereoMaps::VStereoMaps( bool iuc, int iRandomSeed, bool iTMPL_RE_nMaxoffsource
     fTargetShiftNorth = 0;
     fTargetShiftWest = 0.;
     
+    fRE_roffTemp = 0.;
+    fRE_index_nr = 0;
+    fRE_index_nphi = 0;
+    fRE_index_dr = 0.;
+    
     hAux_theta2On = 0;
     hAux_theta2Off = 0;
     hAux_theta2Ratio = 0;
@@ -471,6 +480,9 @@ void VStereoMaps::finalize( bool iIsOn, double OnOff_Alpha )
  *
  *   following Funk 2005, but adapted to case here
  *
+ *   sum over the mean acceptance per map bin (see VRadialAcceptance::getAcceptanceMap()),
+ *   weighted by the fraction of each bin inside the source region or ring
+ *
  */
 void VStereoMaps::RM_getAlpha( bool iIsOn )
 {
@@ -514,12 +526,8 @@ void VStereoMaps::RM_getAlpha( bool iIsOn )
     
     double x = 0.;
     double x_w = hmap_stereo->GetXaxis()->GetBinWidth( 2 );
-    int ix_start = 0;
-    int ix_stopp = 0;
     double y = 0.;
     double y_w = hmap_stereo->GetYaxis()->GetBinWidth( 2 );
-    int iy_start = 0;
-    int iy_stopp = 0;
     double cx = 0.;
     double cy = 0.;
     double cr = 0.;
@@ -543,16 +551,6 @@ void VStereoMaps::RM_getAlpha( bool iIsOn )
     int i_xoff = TMath::Nint( fRunList.fWobbleWestMod / x_w );
     int j_yoff = TMath::Nint( fRunList.fWobbleNorthMod / y_w );
     
-    // loop over all possible source positions,
-    // calculate alpha for source or ring positions
-    
-    // get boundaries for loop over ring area (square which encloses ring)
-    // get loop boundaries (the square on the map which encloses the ring)
-    
-    // lower edge of bins
-    double i_xLE = 0.;
-    double i_yLE = 0.;
-    
     int i_nbinsXstart = 1;
     int i_nbinsX = hmap_alpha->GetNbinsX();
     int i_nbinsXstopp = i_nbinsX;
@@ -567,28 +565,75 @@ void VStereoMaps::RM_getAlpha( bool iIsOn )
         i_nbinsYstopp = hmap_stereo->GetYaxis()->FindBin( fRunList.fWobbleNorthMod );
     }
     
-    // x,y (or i,j) is the position of the test source
-    for( int i = i_nbinsXstart; i <= i_nbinsXstopp; i++ )
+    // mean acceptance per bin (zero for excluded regions)
+    vector< double > i_accMap;
+    fAcceptance->getAcceptanceMap( i_accMap,
+                                   i_nbinsX, hmap_alpha->GetXaxis()->GetXmin(), hmap_alpha->GetXaxis()->GetXmax(),
+                                   i_nbinsY, hmap_alpha->GetYaxis()->GetXmin(), hmap_alpha->GetYaxis()->GetXmax(),
+                                   !iIsOn );
+    
+    // fraction of each bin inside the source region (on) or the ring (off),
+    // for bins relative to the bin of the test source
+    // (square which encloses the ring)
+    vector< int >    i_kernel_di;
+    vector< int >    i_kernel_dj;
+    vector< double > i_kernel_w;
+    if( iIsOn && bUncorrelatedSkyMaps )
     {
-        i_xLE = hmap_alpha->GetXaxis()->GetBinLowEdge( i );
-        x = fRandom->Uniform( i_xLE, i_xLE + x_w );
-        
-        // define area which has to be test for this test source (x)
-        ix_start = i - ( int )( i_rU / x_w + 1 );
-        if( ix_start < 1 )
-        {
-            ix_start = 1;
-        }
-        ix_stopp = i + ( int )( i_rU / x_w + 1 );
-        if( ix_stopp > i_nbinsX )
+        i_kernel_di.push_back( 0 );
+        i_kernel_dj.push_back( 0 );
+        i_kernel_w.push_back( 1. );
+    }
+    else
+    {
+        const int i_nsub = 8;
+        int i_nrX = ( int )( i_rU / x_w + 1 );
+        int i_nrY = ( int )( i_rU / y_w + 1 );
+        for( int di = -i_nrX; di <= i_nrX; di++ )
         {
-            ix_stopp = i_nbinsX;
+            for( int dj = -i_nrY; dj <= i_nrY; dj++ )
+            {
+                int i_inside = 0;
+                for( int si = 0; si < i_nsub; si++ )
+                {
+                    cx = ( di + ( si + 0.5 ) / i_nsub - 0.5 ) * x_w;
+                    for( int sj = 0; sj < i_nsub; sj++ )
+                    {
+                        cy = ( dj + ( sj + 0.5 ) / i_nsub - 0.5 ) * y_w;
+                        cr = cx * cx + cy * cy;
+                        if( iIsOn && cr < i_rS * i_rS )
+                        {
+                            i_inside++;
+                        }
+                        else if( !iIsOn && cr > i_rL * i_rL && cr < i_rU * i_rU )
+                        {
+                            i_inside++;
+                        }
+                    }
+                }
+                if( i_inside > 0 )
+                {
+                    i_kernel_di.push_back( di );
+                    i_kernel_dj.push_back( dj );
+                    i_kernel_w.push_back( ( double )i_inside / ( double )( i_nsub * i_nsub ) );
+                }
+            }
         }
+    }
+    
+    // loop over all possible source positions,
+    // calculate alpha for source or ring positions
+    // (sum of acceptances over the source region or ring)
+    int ci = 0;
+    int cj = 0;
+    // x,y (or i,j) is the position of the test source
+    for( int i = i_nbinsXstart; i <= i_nbinsXstopp; i++ )
+    {
+        x = hmap_alpha->GetXaxis()->GetBinCenter( i );
         
         for( int j = i_nbinsYstart; j <= i_nbinsYstopp; j++ )
         {
-            i_yLE = hmap_alpha->GetYaxis()->GetBinLowEdge( j );
-            y = fRandom->Uniform( i_yLE, i_yLE + y_w );
+            y = hmap_alpha->GetYaxis()->GetBinCenter( j );
             
             // check if events is in fiducial area
             if( sqrt( x * x + y * y ) > fRunList.fmaxradius )
@@ -597,79 +642,16 @@ void VStereoMaps::RM_getAlpha( bool iIsOn )
                 continue;
             }
             
-            // define area which has to be test for this test source (y)
-            iy_start = j - ( int )( i_rU / y_w + 1 );
-            if( iy_start < 1 )
-            {
-                iy_start = 1;
-            }
-            iy_stopp = j + ( int )( i_rU / y_w + 1 );
-            if( iy_stopp > i_nbinsY )
-            {
-                iy_stopp = i_nbinsY;
-            }
-            
-            // reset acceptance
             i_acc = 0.;
-            
-            // loop over all possible ring positions
-            for( int ci = ix_start; ci <= ix_stopp; ci++ )
+            for( unsigned int k = 0; k < i_kernel_w.size(); k++ )
             {
-                i_xLE = hmap_alpha->GetXaxis()->GetBinLowEdge( ci );
-                
-                for( int cj = iy_start; cj <= iy_stopp; cj++ )
+                ci = i + i_kernel_di[k];
+                cj = j + i_kernel_dj[k];
+                if( ci < 1 || ci > i_nbinsX || cj < 1 || cj > i_nbinsY )
                 {
-                    i_yLE = hmap_alpha->GetYaxis()->GetBinLowEdge( cj );
-                    
-                    // cx, cy are camera coordinates relative to the camera center
-                    cx = fRandom->Uniform( i_xLE, i_xLE + x_w );
-                    cy = fRandom->Uniform( i_yLE, i_yLE + y_w );
-                    
-                    cr = ( cx - x ) * ( cx - x ) + ( cy - y ) * ( cy - y );
-                    
-                    //////////////////////////////////////////////
-                    // get sum of acceptance for on region
-                    if( iIsOn )
-                    {
-                        // check is event is in fiducial area
-                        if( fAcceptance->isExcludedfromSource( cx, cy ) )
-                        {
-                            continue;
-                        }
-                        // check if event is in 'on' region
-                        if( bUncorrelatedSkyMaps )
-                        {
-                            // check if event is in bin
-                            if( ci == i && cj == j )
-                            {
-                                i_acc += fAcceptance->getAcceptance( cx, cy );
-                            }
-                        }
-                        else
-                        {
-                            // check if event is inside source region
-                            if( cr < i_rS * i_rS )
-                            {
-                                i_acc += fAcceptance->getAcceptance( cx, cy );
-                            }
-                        }
-                    }
-                    //////////////////////////////////////////////
-                    // get acceptance for OFF regions
-                    else
-                    {
-                        // don't use events in source region
-                        if( fAcceptance->isExcludedfromBackground( cx, cy ) )
-                        {
-                            continue;
-                        }
-                        // check if event is inside ring
-                        if( cr > i_rL * i_rL && cr < i_rU * i_rU )
-                        {
-                            i_acc += fAcceptance->getAcceptance( cx, cy );
-                        }
-                    }
+                    continue;
                 }
+                i_acc += i_kernel_w[k] * i_accMap[( ci - 1 ) * i_nbinsY + cj - 1];
             }
             // fill the alpha map (scaled to acceptance 1)
             hmap_alpha->SetBinContent( i - i_xoff, j - j_yoff, i_acc / iNB_expected );
@@ -780,6 +762,8 @@ bool VStereoMaps::fill_ReflectedRegionModel( double x, double y, int irun, bool
         // bin of source direction
         f_RE_WW = hmap_stereo->GetXaxis()->FindBin( fRunList.fWobbleWestMod - fTargetShiftWest );
         f_RE_WN = hmap_stereo->GetYaxis()->FindBin( fRunList.fWobbleNorthMod - fTargetShiftNorth );
+        
+        initialize_ReflectedRegionIndex();
     }
     
     ///////////////////////////
@@ -794,54 +778,32 @@ bool VStereoMaps::fill_ReflectedRegionModel( double x, double y, int irun, bool
         return false;
     }
     
-    // now loop over the whole map to check if events is in one of the off regions
-    if( i_isGamma )
+    // now check all off regions in the radial and polar angle bucket of this event
+    // (off regions are sorted by bin in each bucket)
+    if( i_isGamma && fRE_index_nr > 0 && fRE_index_nphi > 0 )
     {
-        double i_cx = 0.;
-        double i_cy = 0.;
-        double i_binDist = 0.;
-        unsigned int i_nr = 0;
-        
-        for( int i = f_RE_xstart; i <= f_RE_xstopp; i++ )
+        unsigned int i_r = ( unsigned int )( i_evDist / fRE_index_dr );
+        if( i_r >= fRE_index_nr )
         {
-            i_cx =  hmap_stereo->GetXaxis()->GetBinCenter( i );
-            
-            for( int j = f_RE_ystart; j <= f_RE_ystopp; j++ )
+            i_r = fRE_index_nr - 1;
+        }
+        double i_phi = atan2( y, x ) + TMath::Pi();
+        unsigned int i_p = ( unsigned int )( i_phi / TMath::TwoPi() * ( double )fRE_index_nphi );
+        if( i_p >= fRE_index_nphi )
+        {
+            i_p = fRE_index_nphi - 1;
+        }
+        const vector< unsigned int >& i_bucket = fRE_index[i_r * fRE_index_nphi + i_p];
+        for( unsigned int k = 0; k < i_bucket.size(); k++ )
+        {
+            const sRE_INDEXREGION& i_reg = fRE_indexRegions[i_bucket[k]];
+            // apply theta2 cut in background region
+            double theta2 = ( x - i_reg.xoff ) * ( x - i_reg.xoff ) + ( y - i_reg.yoff ) * ( y - i_reg.yoff );
+            if( theta2 < i_reg.roff2 )
             {
-                i_cy =  hmap_stereo->GetYaxis()->GetBinCenter( j );
-                
-                // check if event is in the same ring as this bin (all off regions are in a ring around the camera center)
-                i_binDist = sqrt( i_cx * i_cx + i_cy * i_cy );
-                
-                if( i_evDist > i_binDist + fRE_roffTemp )
-                {
-                    continue;
-                }
-                if( i_evDist < i_binDist - fRE_roffTemp )
-                {
-                    continue;
-                }
-                
-                // loop over all off regions for this bin
-                i_nr = fRE_off[i][j].xoff.size();
-                if( fRE_off[i][j].noff == 0 )
-                {
-                    i_nr = 0;
-                }
-                
-                for( unsigned int p = 0; p < i_nr; p++ )
-                {
-                    // apply theta2 cut in background region
-                    double theta2 = ( x - fRE_off[i][j].xoff[p] ) * ( x - fRE_off[i][j].xoff[p] )
-                                    + ( y - fRE_off[i][j].yoff[p] ) * ( y - fRE_off[i][j].yoff[p] );
-                                    
-                    if( theta2 < fRE_off[i][j].roff[p]*fRE_off[i][j].roff[p] )
-                    {
-                        i_theta2 = theta2;
-                        hmap_stereo->Fill( i_cx - fRunList.fWobbleWestMod, i_cy - fRunList.fWobbleNorthMod );
-                        hmap_alpha->Fill( i_cx - fRunList.fWobbleWestMod, i_cy - fRunList.fWobbleNorthMod, ( double )fRE_off[i][j].noff * f_RE_AreaNorm );
-                    }
-                }
+                i_theta2 = theta2;
+                hmap_stereo->Fill( i_reg.x_bin - fRunList.fWobbleWestMod, i_reg.y_bin - fRunList.fWobbleNorthMod );
+                hmap_alpha->Fill( i_reg.x_bin - fRunList.fWobbleWestMod, i_reg.y_bin - fRunList.fWobbleNorthMod, ( double )i_reg.noff * f_RE_AreaNorm );
             }
         }
     }
@@ -877,12 +839,206 @@ bool VStereoMaps::fill_ReflectedRegionModel( double x, double y, int irun, bool
 }
 
 
+/*!
+ *   key for the reflected region cache
+ *
+ *   off regions depend on the wobble offset, target shift, sky map binning,
+ *   region parameters and on the exclusion regions (in camera coordinates) only
+ */
+string VStereoMaps::getReflectedRegionCacheKey( int iBinX_min, int iBinX_max, int iBinY_min, int iBinY_max )
+{
+    ostringstream i_key;
+    i_key << fixed << setprecision( 4 );
+    i_key << fRunList.fWobbleWestMod << " " << fRunList.fWobbleNorthMod << " ";
+    i_key << fTargetShiftWest << " " << fTargetShiftNorth << " ";
+    i_key << fRunList.fSourceRadius << " " << fRunList.fmaxradius << " ";
+    i_key << fRunList.fRE_distanceSourceOff << " " << fRunList.fRE_nMinoffsource << " " << fRunList.fRE_nMaxoffsource << " ";
+    i_key << fTMPL_RE_nMaxoffsource << " ";
+    i_key << hmap_stereo->GetXaxis()->GetXmin() << " " << hmap_stereo->GetXaxis()->GetXmax() << " " << hmap_stereo->GetNbinsX() << " ";
+    i_key << hmap_stereo->GetYaxis()->GetXmin() << " " << hmap_stereo->GetYaxis()->GetXmax() << " " << hmap_stereo->GetNbinsY() << " ";
+    i_key << iBinX_min << " " << iBinX_max << " " << iBinY_min << " " << iBinY_max;
+    for( unsigned int i = 0; i < fListOfExclusionRegions.size(); i++ )
+    {
+        if( fListOfExclusionRegions[i] )
+        {
+            i_key << " [" << fListOfExclusionRegions[i]->fExcludeFromBackground_CameraCentre_x;
+            i_key << " " << fListOfExclusionRegions[i]->fExcludeFromBackground_CameraCentre_y;
+            i_key << " " << fListOfExclusionRegions[i]->fExcludeFromBackground_Radius1;
+            i_key << " " << fListOfExclusionRegions[i]->fExcludeFromBackground_Radius2;
+            i_key << " " << fListOfExclusionRegions[i]->fExcludeFromBackground_RotAngle << "]";
+        }
+    }
+    return i_key.str();
+}
+
+/*!
+ *   search off regions for a source at x,y (camera coordinates)
+ *
+ *   (thread safe; random removal of off regions is done by the caller)
+ *
+ *   iNRegions: number of off regions for the debug histogram (-1: no search done)
+ */
+void VStereoMaps::solve_ReflectedRegions( double x, double y, sRE_REGIONS& iRegions, int& iNRegions )
+{
+    iRegions.xoff.clear();
+    iRegions.yoff.clear();
+    iRegions.roff.clear();
+    iRegions.noff = 0;
+    iNRegions = -1;
+    
+    // distance of bin to camera center
+    double ids = sqrt( x * x + y * y );
+    
+    // bin is outside confidence region (distance of bin + off source radius)
+    // and bin is too close to center of camera
+    if( ids >= fRunList.fmaxradius || ids <= fRE_roffTemp || fRE_roffTemp == 0. )
+    {
+        return;
+    }
+    // angular size of the on region seen from the observation position
+    double w = asin( fRE_roffTemp / ids );
+    // number of off source regions
+    int n_r = 0;
+    if( w > 0 )
+    {
+        n_r = ( int )( TMath::Pi() / w );
+    }
+    // maximum number of off source region possible for this particular distance to camera center
+    int n_max_RE = n_r;
+    
+    // test if there are enough off source regions
+    if( n_r < fRunList.fRE_nMinoffsource )
+    {
+        return;
+    }
+    
+    // vectors with off source positions
+    vector< double >& r_off = iRegions.roff;
+    vector< double >& x_off = iRegions.xoff;
+    vector< double >& y_off = iRegions.yoff;
+    // vectors with off source positions (temporary)
+    vector< double > r_offTemp;
+    vector< double > x_offTemp;
+    vector< double > y_offTemp;
+    
+    // phi angle of on position
+    double phi_0 = atan2( y, x );
+    
+    // off positions
+    double phi_i = 0.;
+    double x_t = 0.;
+    double y_t = 0.;
+    
+    // try to fit at least fRunList.fRE_nMinoffsource into the available space, work by trial and error
+    // (rotate source start of source regions in XX degrees steps)
+    // (step size is a trade off between accuracy and speed)
+    for( double t = 0.; t < 360.; t += 1.0 )
+    {
+        // reset all previously filled vector
+        r_offTemp.clear();
+        x_offTemp.clear();
+        y_offTemp.clear();
+        // loop over all possible off source positions
+        for( int p = 0; p < n_r; p++ )
+        {
+            // get off-source positions
+            phi_i = phi_0 + TMath::Pi() + ( 2 * p + 1 - n_r ) * w;
+            phi_i += ( ( double )( t ) ) / TMath::RadToDeg();
+            x_t = ids * cos( phi_i );
+            y_t = ids * sin( phi_i );
+            
+            // check if off source region is not included in this off position
+            // (require to be at least 2.0*times theta2 circle away)
+            if( ( x_t - x ) * ( x_t - x ) + ( y_t - y ) * ( y_t - y )
+                    < ( 2. + fRunList.fRE_distanceSourceOff ) * ( 2. + fRunList.fRE_distanceSourceOff )*fRunList.fSourceRadius )
+            {
+                continue;
+            }
+            
+            // check if real source region is not included in this off position
+            // check if off source region is not excluded from background
+            bool bExclude = false;
+            for( unsigned int ex = 0; ex < fListOfExclusionRegions.size(); ex++ )
+            {
+                if( !fListOfExclusionRegions[ex] )
+                {
+                    continue;
+                }
+                if( fListOfExclusionRegions[ex]->isInsideExclusionRegion( x_t, y_t, fRE_roffTemp ) )
+                {
+                    bExclude = true;
+                    break;
+                }
+            }
+            if( bExclude )
+            {
+                continue;
+            }
+            
+            // fill an off region
+            r_offTemp.push_back( fRE_roffTemp );
+            x_offTemp.push_back( x_t );
+            y_offTemp.push_back( y_t );
+        }
+        // test if this configuration has more off source regions than a previous one
+        if( x_offTemp.size() > x_off.size() )
+        {
+            r_off = r_offTemp;
+            x_off = x_offTemp;
+            y_off = y_offTemp;
+        }
+        // test if there are enough off source regions
+        if( ( int )x_off.size() >= fRunList.fRE_nMaxoffsource || ( x_off.size() > 10 && ( int )x_off.size() >= n_max_RE - 5 ) )
+        {
+            break;
+        }
+    }
+    
+    // remove those regions which are furthest away
+    // (default; random removal see initialize_ReflectedRegionModel())
+    if( !fTMPL_RE_nMaxoffsource )
+    {
+        double i_dist = 0.;
+        while( ( int )r_off.size() > fRunList.fRE_nMaxoffsource )
+        {
+            double i_max = 0.;
+            unsigned int i_maxtt = 99999;
+            unsigned int tt = 0;
+            for( tt = 0; tt < r_off.size(); tt++ )
+            {
+                i_dist = sqrt( ( x_off[tt] - x ) * ( x_off[tt] - x ) + ( y_off[tt] - y ) * ( y_off[tt] - y ) );
+                if( i_dist > i_max )
+                {
+                    i_max = i_dist;
+                    i_maxtt = tt;
+                }
+            }
+            if( i_maxtt != 99999 && i_maxtt < r_off.size() )
+            {
+                r_off.erase( r_off.begin() + i_maxtt );
+                x_off.erase( x_off.begin() + i_maxtt );
+                y_off.erase( y_off.begin() + i_maxtt );
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+    
+    // number of off source regions
+    iNRegions = ( int )x_off.size();
+}
+
 /*!
  *   calculate number and positions of background regions
  *
  *   store this in 2D vector of sRE_REGIONS
  *
  *   x,y not rotated to source position
+ *
+ *   solutions are cached: runs with the same wobble offset, target shift
+ *   and exclusion regions reuse the off regions of the first of these runs
  */
 bool VStereoMaps::initialize_ReflectedRegionModel()
 {
@@ -983,16 +1139,16 @@ bool VStereoMaps::initialize_ReflectedRegionModel()
         }
     }
     
-    // off region parameters
-    sRE_REGIONS i_off;
-    i_off.noff = 0;
-    
-    // empty vector
-    vector< double > i_Dempty;
-    
     // source extension (equal to radius of off regions)
     fRE_roffTemp = sqrt( fRunList.fSourceRadius );
     
+    if( fRunList.fmaxradius <= 0. )
+    {
+        cout << "VStereoMaps::initialize_ReflectedRegionModel() warning: max camera radius is zero: ";
+        cout << fRunList.fmaxradius << endl;
+        return false;
+    }
+    
     /////////////////////////////////////////////////////////////////////////////////////////////////////////
     // calculate off regions (following Zufelde, 2005, p.28)
     //
@@ -1019,53 +1175,145 @@ bool VStereoMaps::initialize_ReflectedRegionModel()
         i_nbinsY     = y_bin_wobble;
     }
     
-    // set up 2D vector of off source parameters ([n_x][n_y])
-    fRE_off.clear();
-    vector< sRE_REGIONS > i_x_off;
-    for( int j = 0; j <= i_nbinsY; j++ )
+    string i_key = getReflectedRegionCacheKey( i_nbinsX_min, i_nbinsX, i_nbinsY_min, i_nbinsY );
+    if( fRE_cache.find( i_key ) == fRE_cache.end() )
     {
-        i_x_off.push_back( i_off );
-        i_x_off.back().noff = 0;
+        // set up 2D vector of off source parameters ([n_x][n_y])
+        sRE_SOLUTION i_solution;
+        sRE_REGIONS i_off;
+        i_off.noff = 0;
+        i_solution.fOff.assign( i_nbinsX + 1, vector< sRE_REGIONS >( i_nbinsY + 1, i_off ) );
+        i_solution.fNRegions.assign( i_nbinsX + 1, vector< int >( i_nbinsY + 1, -1 ) );
+        
+        // bin centres (coordinate system: relative to camera centre)
+        vector< double > i_binCentreX( i_nbinsX + 1, 0. );
+        vector< double > i_binCentreY( i_nbinsY + 1, 0. );
+        for( int i = i_nbinsX_min; i <= i_nbinsX; i++ )
+        {
+            i_binCentreX[i] = hmap_stereo->GetXaxis()->GetBinCenter( i );
+            if( TMath::Abs( i_binCentreX[i] ) < 1.e-5 )
+            {
+                i_binCentreX[i] = 0.;
+            }
+        }
+        for( int j = i_nbinsY_min; j <= i_nbinsY; j++ )
+        {
+            i_binCentreY[j] = hmap_stereo->GetYaxis()->GetBinCenter( j );
+            if( TMath::Abs( i_binCentreY[j] ) < 1.e-5 )
+            {
+                i_binCentreY[j] = 0.;
+            }
+        }
+        
+        //////////////////////////////////////////////////////////////////////////////////////
+        // search off regions for all bins in the stereo maps
+        // (columns of the sky map are solved in parallel)
+        //////////////////////////////////////////////////////////////////////////////////////
+        unsigned int i_ncolumns = ( unsigned int )( i_nbinsX - i_nbinsX_min + 1 );
+        unsigned int i_nthreads = thread::hardware_concurrency();
+        if( i_nthreads > i_ncolumns )
+        {
+            i_nthreads = i_ncolumns;
+        }
+        if( i_nthreads < 1 )
+        {
+            i_nthreads = 1;
+        }
+        atomic< unsigned int > iCounter( 0 );
+        auto i_solveColumns = [&]()
+        {
+            unsigned int n = 0;
+            while( ( n = iCounter++ ) < i_ncolumns )
+            {
+                int i = i_nbinsX_min + ( int )n;
+                for( int j = i_nbinsY_min; j <= i_nbinsY; j++ )
+                {
+                    solve_ReflectedRegions( i_binCentreX[i], i_binCentreY[j], i_solution.fOff[i][j], i_solution.fNRegions[i][j] );
+                }
+            }
+        };
+        if( i_nthreads > 1 )
+        {
+            vector< thread > i_threads;
+            for( unsigned int t = 0; t < i_nthreads; t++ )
+            {
+                i_threads.push_back( thread( i_solveColumns ) );
+            }
+            for( unsigned int t = 0; t < i_threads.size(); t++ )
+            {
+                i_threads[t].join();
+            }
+        }
+        else
+        {
+            i_solveColumns();
+        }
+        
+        // not enough off source regions: remove all
+        for( int i = i_nbinsX_min; i <= i_nbinsX; i++ )
+        {
+            for( int j = i_nbinsY_min; j <= i_nbinsY; j++ )
+            {
+                sRE_REGIONS& i_reg = i_solution.fOff[i][j];
+                if( ( int )i_reg.xoff.size() < fRunList.fRE_nMinoffsource )
+                {
+                    i_reg.roff.clear();
+                    i_reg.xoff.clear();
+                    i_reg.yoff.clear();
+                    i_reg.noff = 0;
+                }
+                else
+                {
+                    i_reg.noff = ( int )i_reg.xoff.size();
+                }
+            }
+        }
+        fRE_cache[i_key] = i_solution;
     }
-    for( int i = 0; i <= i_nbinsX; i++ )
+    else
     {
-        fRE_off.push_back( i_x_off );
+        cout << "\t\t (reflected regions from previous run with identical configuration)" << endl;
     }
+    fRE_off = fRE_cache[i_key].fOff;
+    vector< vector< int > > i_NRegions = fRE_cache[i_key].fNRegions;
     
-    // distance of bin to camera center
-    double ids = 0.;
-    
-    // vectors with off source positions
-    vector< double > r_off;
-    vector< double > x_off;
-    vector< double > y_off;
-    // vectors with off source positions (temporary)
-    vector< double > r_offTemp;
-    vector< double > x_offTemp;
-    vector< double > y_offTemp;
-    
-    // calculate maximum number of off source regions possible
-    // (maximum number of off source regions at the edge of the camera)
-    int n_max_RE = 0;
-    if( fRunList.fmaxradius > 0. )
+    // check maximum number of sources, if too many, remove some (randomly choosen)
+    // (this might introduce a gradient across the sky maps)
+    // (done for each run, also for cached regions, so that runs use independent
+    //  random choices; sequentially in bin order to keep the sequence of random numbers)
+    if( fTMPL_RE_nMaxoffsource )
     {
-        n_max_RE = ( int )( TMath::Pi() / ( asin( fRE_roffTemp / fRunList.fmaxradius ) ) );
-    }
-    else
-    {
-        cout << "VStereoMaps::initialize_ReflectedRegionModel() warning: max camera radius is zero: ";
-        cout << fRunList.fmaxradius << endl;
-        return false;
+        for( int i = i_nbinsX_min; i <= i_nbinsX; i++ )
+        {
+            for( int j = i_nbinsY_min; j <= i_nbinsY; j++ )
+            {
+                sRE_REGIONS& i_reg = fRE_off[i][j];
+                if( ( int )i_reg.roff.size() > fRunList.fRE_nMaxoffsource )
+                {
+                    unsigned int remo_iter = 0;
+                    while( ( int )i_reg.roff.size() > fRunList.fRE_nMaxoffsource )
+                    {
+                        remo_iter = ( unsigned int )fRandom->Integer( ( int )i_reg.roff.size() );
+                        i_reg.roff.erase( i_reg.roff.begin() + remo_iter );
+                        i_reg.xoff.erase( i_reg.xoff.begin() + remo_iter );
+                        i_reg.yoff.erase( i_reg.yoff.begin() + remo_iter );
+                    }
+                    i_NRegions[i][j] = ( int )i_reg.xoff.size();
+                    // not enough off source regions: remove all
+                    if( ( int )i_reg.xoff.size() < fRunList.fRE_nMinoffsource )
+                    {
+                        i_reg.roff.clear();
+                        i_reg.xoff.clear();
+                        i_reg.yoff.clear();
+                    }
+                    i_reg.noff = ( int )i_reg.xoff.size();
+                }
+            }
+        }
     }
     
-    //////////////////////////////////////////////////////////////////////////////////////
-    //////////////////////////////////////////////////////////////////////////////////////
-    //////////////////////////////////////////////////////////////////////////////////////
-    // loop over all bins in the stereo maps
-    //
-    // coordinate system: relative to camera centre
-    // (shifted at the very end to sky map centred coordinate system)
-    //////////////////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////////////
+    // fill debug histogram and tree with reflected regions
     for( int i = i_nbinsX_min; i <= i_nbinsX; i++ )
     {
         x = hmap_stereo->GetXaxis()->GetBinCenter( i );
@@ -1081,187 +1329,11 @@ bool VStereoMaps::initialize_ReflectedRegionModel()
             {
                 y = 0.;
             }
+            n_r = fRE_off[i][j].noff;
             
-            // distance of this bin from camera center
-            ids = sqrt( x * x + y * y );
-            
-            // initialise list of reflected regions for this bin
-            n_r = 0;
-            r_off.clear();
-            x_off.clear();
-            y_off.clear();
-            fRE_off[i][j].roff = r_off;
-            fRE_off[i][j].xoff = x_off;
-            fRE_off[i][j].yoff = y_off;
-            fRE_off[i][j].noff = 0;
-            
-            // bin is outside confidence region (distance of bin + off source radius)
-            // and bin is too close to center of camera
-            if( ids < ( fRunList.fmaxradius ) && ids > fRE_roffTemp && fRE_roffTemp != 0. )
+            if( hRE_NRegions && i_NRegions[i][j] >= 0 )
             {
-                // angular size of the on region seen from the observation position
-                double w = asin( fRE_roffTemp / ids );
-                // number of off source regions
-                if( w > 0 )
-                {
-                    n_r = ( int )( TMath::Pi() / w );
-                }
-                else
-                {
-                    n_r = 0;
-                }
-                // set maximum number of off source region possible for this particular distance to camera center
-                n_max_RE = n_r;
-                
-                // test if there are enough off source regions
-                if( n_r >= fRunList.fRE_nMinoffsource )
-                {
-                    // phi angle of on position
-                    double phi_0 = atan2( y, x );
-                    
-                    // off positions
-                    double phi_i = 0.;
-                    double x_t = 0.;
-                    double y_t = 0.;
-                    
-                    // try to fit at least fRunList.fRE_nMinoffsource into the available space, work by trial and error
-                    // (rotate source start of source regions in XX degrees steps)
-                    // (step size is a trade off between accuracy and speed)
-                    for( double t = 0.; t < 360.; t += 1.0 )
-                    {
-                        // reset all previously filled vector
-                        r_offTemp.clear();
-                        x_offTemp.clear();
-                        y_offTemp.clear();
-                        // loop over all possible off source positions
-                        for( int p = 0; p < n_r; p++ )
-                        {
-                            // get off-source positions
-                            phi_i = phi_0 + TMath::Pi() + ( 2 * p + 1 - n_r ) * w;
-                            phi_i += ( ( double )( t ) ) / TMath::RadToDeg();
-                            x_t = ids * cos( phi_i );
-                            y_t = ids * sin( phi_i );
-                            
-                            // check if off source region is not included in this off position
-                            // (require to be at least 2.0*times theta2 circle away)
-                            if( ( x_t - x ) * ( x_t - x ) + ( y_t - y ) * ( y_t - y )
-                                    < ( 2. + fRunList.fRE_distanceSourceOff ) * ( 2. + fRunList.fRE_distanceSourceOff )*fRunList.fSourceRadius )
-                            {
-                                continue;
-                            }
-                            
-                            // check if real source region is not included in this off position
-                            // check if off source region is not excluded from background
-                            bool bExclude = false;
-                            for( unsigned int ex = 0; ex < fListOfExclusionRegions.size(); ex++ )
-                            {
-                                if( !fListOfExclusionRegions[ex] )
-                                {
-                                    continue;
-                                }
-                                if( fListOfExclusionRegions[ex]->isInsideExclusionRegion( x_t, y_t, fRE_roffTemp ) )
-                                {
-                                    bExclude = true;
-                                }
-                            }
-                            if( bExclude )
-                            {
-                                continue;
-                            }
-                            
-                            // fill an off region
-                            r_offTemp.push_back( fRE_roffTemp );
-                            x_offTemp.push_back( x_t );
-                            y_offTemp.push_back( y_t );
-                        }
-                        // test if this configuration has more off source regions than a previous one
-                        if( x_offTemp.size() > x_off.size() )
-                        {
-                            r_off = r_offTemp;
-                            x_off = x_offTemp;
-                            y_off = y_offTemp;
-                        }
-                        // test if there are enough off source regions
-                        if( ( int )x_off.size() >= fRunList.fRE_nMaxoffsource || ( x_off.size() > 10 && ( int )x_off.size() >= n_max_RE - 5 ) )
-                        {
-                            break;
-                        }
-                    }
-                    n_r = ( int )x_off.size();
-                    
-                    // check maximum number of sources, if too many, remove some (randomly choosen)
-                    // (this might introduce a gradient across the sky maps)
-                    if( fTMPL_RE_nMaxoffsource )
-                    {
-                        if( n_r > fRunList.fRE_nMaxoffsource )
-                        {
-                            unsigned int remo_iter = 0;
-                            while( ( int )r_off.size() > fRunList.fRE_nMaxoffsource )
-                            {
-                                remo_iter = ( unsigned int )fRandom->Integer( ( int )r_off.size() );
-                                r_off.erase( r_off.begin() + remo_iter );
-                                x_off.erase( x_off.begin() + remo_iter );
-                                y_off.erase( y_off.begin() + remo_iter );
-                            }
-                        }
-                    }
-                    // remove those regions which are furthest away
-                    // (default)
-                    else
-                    {
-                        double i_dist = 0.;
-                        while( ( int )r_off.size() > fRunList.fRE_nMaxoffsource )
-                        {
-                            double i_max = 0.;
-                            unsigned int i_maxtt = 99999;
-                            unsigned int tt = 0;
-                            for( tt = 0; tt < r_off.size(); tt++ )
-                            {
-                                i_dist = sqrt( ( x_off[tt] - x ) * ( x_off[tt] - x ) + ( y_off[tt] - y ) * ( y_off[tt] - y ) );
-                                if( i_dist > i_max )
-                                {
-                                    i_max = i_dist;
-                                    i_maxtt = tt;
-                                }
-                            }
-                            if( i_maxtt != 99999 && i_maxtt < r_off.size() )
-                            {
-                                r_off.erase( r_off.begin() + i_maxtt );
-                                x_off.erase( x_off.begin() + i_maxtt );
-                                y_off.erase( y_off.begin() + i_maxtt );
-                            }
-                        }
-                    }
-                    
-                    // number of off source regions
-                    n_r = ( int )x_off.size();
-                    
-                    if( hRE_NRegions )
-                    {
-                        hRE_NRegions->SetBinContent( i, j, n_r );
-                    }
-                }
-            }
-            ////////////////////////////////////////
-            // now fill off source regions
-            
-            // not enough off source regions
-            if( n_r < fRunList.fRE_nMinoffsource )
-            {
-                // set n_r to 0 (otherwise problems filling debug tree)
-                n_r = 0;
-                fRE_off[i][j].roff = i_Dempty;
-                fRE_off[i][j].xoff = i_Dempty;
-                fRE_off[i][j].yoff = i_Dempty;
-                fRE_off[i][j].noff = 0;
-            }
-            // valid number of off source regions
-            else
-            {
-                fRE_off[i][j].roff = r_off;
-                fRE_off[i][j].xoff = x_off;
-                fRE_off[i][j].yoff = y_off;
-                fRE_off[i][j].noff = n_r;
+                hRE_NRegions->SetBinContent( i, j, i_NRegions[i][j] );
             }
             
             // fill tree with reflected regions (only for correlated maps)
@@ -1300,6 +1372,94 @@ bool VStereoMaps::initialize_ReflectedRegionModel()
     return true;
 }
 
+/*!
+ *   sort off regions of all bins into radial and polar angle buckets
+ *
+ *   an off region is added to all buckets it overlaps with; buckets are
+ *   filled in bin order (same order of filling as looping over all bins)
+ */
+void VStereoMaps::initialize_ReflectedRegionIndex()
+{
+    fRE_indexRegions.clear();
+    fRE_index.clear();
+    fRE_index_nr = 0;
+    fRE_index_nphi = 0;
+    fRE_index_dr = 0.;
+    if( fRE_roffTemp <= 0. || fRunList.fmaxradius <= 0. )
+    {
+        return;
+    }
+    // radial bucket width is the radius of the off regions
+    fRE_index_dr = fRE_roffTemp;
+    fRE_index_nr = ( unsigned int )( fRunList.fmaxradius / fRE_index_dr ) + 1;
+    fRE_index_nphi = 72;
+    fRE_index.assign( fRE_index_nr * fRE_index_nphi, vector< unsigned int >() );
+    
+    double i_dphi_bucket = TMath::TwoPi() / ( double )fRE_index_nphi;
+    for( int i = f_RE_xstart; i <= f_RE_xstopp && i < ( int )fRE_off.size(); i++ )
+    {
+        double i_cx = hmap_stereo->GetXaxis()->GetBinCenter( i );
+        for( int j = f_RE_ystart; j <= f_RE_ystopp && j < ( int )fRE_off[i].size(); j++ )
+        {
+            if( fRE_off[i][j].noff == 0 )
+            {
+                continue;
+            }
+            double i_cy = hmap_stereo->GetYaxis()->GetBinCenter( j );
+            for( unsigned int p = 0; p < fRE_off[i][j].xoff.size(); p++ )
+            {
+                sRE_INDEXREGION i_reg;
+                i_reg.x_bin = i_cx;
+                i_reg.y_bin = i_cy;
+                i_reg.xoff = fRE_off[i][j].xoff[p];
+                i_reg.yoff = fRE_off[i][j].yoff[p];
+                i_reg.roff2 = fRE_off[i][j].roff[p] * fRE_off[i][j].roff[p];
+                i_reg.noff = fRE_off[i][j].noff;
+                fRE_indexRegions.push_back( i_reg );
+                unsigned int i_id = fRE_indexRegions.size() - 1;
+                
+                // radial range covered by this off region
+                double i_roff = fRE_off[i][j].roff[p];
+                double i_d = sqrt( i_reg.xoff * i_reg.xoff + i_reg.yoff * i_reg.yoff );
+                int r_min = ( int )( ( i_d - i_roff ) / fRE_index_dr );
+                int r_max = ( int )( ( i_d + i_roff ) / fRE_index_dr );
+                if( r_min < 0 )
+                {
+                    r_min = 0;
+                }
+                if( r_max >= ( int )fRE_index_nr )
+                {
+                    r_max = ( int )fRE_index_nr - 1;
+                }
+                // polar angle range covered by this off region
+                int p_min = 0;
+                int p_max = ( int )fRE_index_nphi - 1;
+                if( i_d > i_roff )
+                {
+                    double i_phi = atan2( i_reg.yoff, i_reg.xoff ) + TMath::Pi();
+                    double i_w = asin( i_roff / i_d );
+                    p_min = ( int )floor( ( i_phi - i_w ) / i_dphi_bucket );
+                    p_max = ( int )floor( ( i_phi + i_w ) / i_dphi_bucket );
+                    if( p_max - p_min >= ( int )fRE_index_nphi )
+                    {
+                        p_min = 0;
+                        p_max = ( int )fRE_index_nphi - 1;
+                    }
+                }
+                for( int ir = r_min; ir <= r_max; ir++ )
+                {
+                    for( int ip = p_min; ip <= p_max; ip++ )
+                    {
+                        // wrap polar angle buckets
+                        int i_bucket = ( ip % ( int )fRE_index_nphi + ( int )fRE_index_nphi ) % ( int )fRE_index_nphi;
+                        fRE_index[ir * fRE_index_nphi + i_bucket].push_back( i_id );
+                    }
+                }
+            }
+        }
+    }
+}
+
 
 void VStereoMaps::initialize_theta2()
 {
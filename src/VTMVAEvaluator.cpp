@@ -68,6 +68,7 @@ void VTMVAEvaluator::reset()
     setSensitivityOptimizationParameters();
     setSensitivityOptimizationFixedSignalEfficiency();
     setSensitivityOptimizationSourceStrength();
+    setSensitivityOptimizationThreads();
     setOptimizeAngularContainment();
     setTMVAAngularContainmentThetaFixedMinRadius();
     setTMVAMethod();
@@ -612,22 +613,19 @@ bool VTMVAEvaluator::initializeWeightFiles( string iWeightFileName,
             fIsZombie = true;
             return false;
         }
-        /////////////////////////////////////////////////////////
-        // get optimal signal efficiency (from maximum signal/noise ratio)
-        /////////////////////////////////////////////////////////
-        if( fParticleNumberFileName.size() > 0 )
+    }
+    
+    /////////////////////////////////////////////////////////
+    // get optimal signal efficiency (from maximum signal/noise ratio)
+    // (all bins)
+    /////////////////////////////////////////////////////////
+    if( fParticleNumberFileName.size() > 0 )
+    {
+        if( !optimizeSensitivity( iOptimizationType, iInstrumentEpoch ) )
         {
-            cout << endl;
-            cout << "======================= optimize sensitivity " << b << " =======================" << endl;
-            if( !optimizeSensitivity( b, iOptimizationType, iInstrumentEpoch ) )
-            {
-                cout << "VTMVAEvaluator::initializeWeightFiles: error while calculating optimized sensitivity" << endl;
-                return false;
-            }
-            cout << "======================= end optimize sensitivity =======================" << endl;
-            cout << endl;
+            cout << "VTMVAEvaluator::initializeWeightFiles: error while calculating optimized sensitivity" << endl;
+            return false;
         }
-        
     }
     
     // smooth and Interpolate
@@ -2222,18 +2220,14 @@ void VTMVAEvaluator::printSignalEfficiency()
 
     - main problem is how to deal with low statistics bins
 
-*/
+    optimization is done in three steps:
+    1. read particle numbers and efficiencies for all bins (particle number file is read once)
+    2. scan source strengths and cut values for all bins (in parallel; no ROOT objects used)
+    3. fill and print results (in order of bins)
 
-bool VTMVAEvaluator::optimizeSensitivity( unsigned int iDataBin,
-        string iOptimizationType,
-        string iInstrumentEpoch )
+*/
+bool VTMVAEvaluator::optimizeSensitivity( string iOptimizationType, string iInstrumentEpoch )
 {
-    // valid data bin
-    if( iDataBin >= fTMVAData.size() || !fTMVAData[iDataBin] )
-    {
-        return false;
-    }
-    
     // print some info on optimization parameters to screen
     printSensitivityOptimizationParameters();
     
@@ -2265,208 +2259,315 @@ bool VTMVAEvaluator::optimizeSensitivity( unsigned int iDataBin,
     // (no error message if angular containment histogram is not found
     //  simply means that theta2 cut is not optimised)
     
-    ///////////////////////////////////////////////////////////////////////////////
-    // get number of events (after quality cuts) at this energy from on/off graphs
-    double Non = 0.;
-    double Nof = 0.;
-    double Ndif = 0.;
-    
-    // bin width in energy (linear axis)
-    double i_dE = TMath::Power( 10., fTMVAData[iDataBin]->fEnergyCut_Log10TeV_max )
-                  - TMath::Power( 10., fTMVAData[iDataBin]->fEnergyCut_Log10TeV_min );
-    // in CTA, a log axis is used!!!
-    i_dE = TMath::Abs( fTMVAData[iDataBin]->fEnergyCut_Log10TeV_max - fTMVAData[iDataBin]->fEnergyCut_Log10TeV_min );
+    // signal and background rates
+    TObject* iNOn = iPN->Get( "gSignalRate" );
+    TObject* iNOff = iPN->Get( "gBGRate" );
     
     //////////////////////////////////////////////////////
-    // Interpolate 2D graphs from particle rate files
-    // less robust method which get excess and background counts
-    // by interpolating between graphs
-    // (favored for CTA analysis)
-    if( iOptimizationType == "UseInterpolatedCounts" )
-    {
-        cout << "VTVMAEvaluator::optimizeSensitivity: UseInterpolatedCounts (conversion rate ";
-        cout << fParticleNumberFile_Conversion_Rate_to_seconds << ")" << endl;
-        // get the NOn (signal + background) and NOff (background) graphs
-        // Interpolation between zenith angles happens on secant axis
-        TGraph* i_on = readInterpolatedCountsFromFile( iPN, 1. / cos( fTMVAData[iDataBin]->fZenithCut_min * TMath::DegToRad() ),
-                       1. / cos( fTMVAData[iDataBin]->fZenithCut_max * TMath::DegToRad() ),
-                       true );
-        TGraph* i_of = readInterpolatedCountsFromFile( iPN, 1. / cos( fTMVAData[iDataBin]->fZenithCut_min * TMath::DegToRad() ),
-                       1. / cos( fTMVAData[iDataBin]->fZenithCut_max * TMath::DegToRad() ),
-                       false );
-        if( !i_on || !i_of )
+    // step 1: particle numbers and efficiencies for all bins
+    vector< VTMVAOptimizationBin > iOptBins( fTMVAData.size() );
+    // interpolated rate graphs (per zenith angle interval)
+    map< pair< double, double >, pair< TGraph*, TGraph* > > iInterpolatedCounts;
+    for( unsigned int b = 0; b < fTMVAData.size(); b++ )
+    {
+        if( !fTMVAData[b] )
         {
-            cout << "VTVMAEvaluator::optimizeSensitivity: error," << endl;
-            cout << " cannot read graphs from particle number file " << endl;
-            cout << i_on << "\t" << i_of << endl;
             return false;
         }
-        //////////////// CTA ONLY /////////////////////////////////////////////////
-        // mean energy calculation below requires equal binning for the count graphs
-        if( iInstrumentEpoch == "noepoch" || iInstrumentEpoch == "CTA" )
-        {
-            double x = 0.;
-            double p = 0.;
-            // get mean energy of the considered bins
-            // interval [fTMVAData[iDataBin]->fEnergyCut_Log10TeV_min,fTMVAData[iDataBin]->fEnergyCut_Log10TeV_max]
-            // make sure that energy is not lower or higher then minimum/maximum bins in the rate graphs
-            for( int ii = 0; ii < i_on->GetN(); ii++ )
+        iOptBins[b].fDataBin = b;
+        iOptBins[b].fHAngContainment = iHAngContainment;
+        
+        ///////////////////////////////////////////////////////////////////////////////
+        // get number of events (after quality cuts) at this energy from on/off graphs
+        double Nof = 0.;
+        double Ndif = 0.;
+        
+        // bin width in energy (linear axis)
+        double i_dE = TMath::Power( 10., fTMVAData[b]->fEnergyCut_Log10TeV_max )
+                      - TMath::Power( 10., fTMVAData[b]->fEnergyCut_Log10TeV_min );
+        // in CTA, a log axis is used!!!
+        i_dE = TMath::Abs( fTMVAData[b]->fEnergyCut_Log10TeV_max - fTMVAData[b]->fEnergyCut_Log10TeV_min );
+        
+        double i_secant_min = 1. / cos( fTMVAData[b]->fZenithCut_min * TMath::DegToRad() );
+        double i_secant_max = 1. / cos( fTMVAData[b]->fZenithCut_max * TMath::DegToRad() );
+        
+        //////////////////////////////////////////////////////
+        // Interpolate 2D graphs from particle rate files
+        // less robust method which get excess and background counts
+        // by interpolating between graphs
+        // (favored for CTA analysis)
+        if( iOptimizationType == "UseInterpolatedCounts" )
+        {
+            cout << "VTVMAEvaluator::optimizeSensitivity: UseInterpolatedCounts (conversion rate ";
+            cout << fParticleNumberFile_Conversion_Rate_to_seconds << ")" << endl;
+            // get the NOn (signal + background) and NOff (background) graphs
+            // Interpolation between zenith angles happens on secant axis
+            pair< double, double > iZeKey( i_secant_min, i_secant_max );
+            if( iInterpolatedCounts.find( iZeKey ) == iInterpolatedCounts.end() )
+            {
+                iInterpolatedCounts[iZeKey] = make_pair( getInterpolatedDifferentialRatesfromGraph2D( iNOn, i_secant_min, i_secant_max ),
+                                              getInterpolatedDifferentialRatesfromGraph2D( iNOff, i_secant_min, i_secant_max ) );
+            }
+            TGraph* i_on = iInterpolatedCounts[iZeKey].first;
+            TGraph* i_of = iInterpolatedCounts[iZeKey].second;
+            if( !i_on || !i_of )
+            {
+                cout << "VTVMAEvaluator::optimizeSensitivity: error," << endl;
+                cout << " cannot read graphs from particle number file " << endl;
+                cout << i_on << "\t" << i_of << endl;
+                return false;
+            }
+            //////////////// CTA ONLY /////////////////////////////////////////////////
+            // mean energy calculation below requires equal binning for the count graphs
+            if( iInstrumentEpoch == "noepoch" || iInstrumentEpoch == "CTA" )
             {
-                i_on->GetPoint( ii, x, p );
-                if( p > 0. && ( x + i_on->GetErrorX( ii ) <= fTMVAData[iDataBin]->fEnergyCut_Log10TeV_max
-                                || x <= fTMVAData[iDataBin]->fEnergyCut_Log10TeV_max ) )
+                double x = 0.;
+                double p = 0.;
+                // get mean energy of the considered bins
+                // interval [fTMVAData[b]->fEnergyCut_Log10TeV_min,fTMVAData[b]->fEnergyCut_Log10TeV_max]
+                // make sure that energy is not lower or higher then minimum/maximum bins in the rate graphs
+                for( int ii = 0; ii < i_on->GetN(); ii++ )
                 {
-                    if( fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV < x )
+                    i_on->GetPoint( ii, x, p );
+                    if( p > 0. && ( x + i_on->GetErrorX( ii ) <= fTMVAData[b]->fEnergyCut_Log10TeV_max
+                                    || x <= fTMVAData[b]->fEnergyCut_Log10TeV_max ) )
                     {
-                        if( x + i_on->GetErrorX( ii ) <= fTMVAData[iDataBin]->fEnergyCut_Log10TeV_max )
+                        if( fTMVAData[b]->fSpectralWeightedMeanEnergy_Log10TeV < x )
                         {
-                            fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV = x + 0.97 * i_on->GetErrorX( ii );
-                        }
-                        else
-                        {
-                            fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV = x;
+                            if( x + i_on->GetErrorX( ii ) <= fTMVAData[b]->fEnergyCut_Log10TeV_max )
+                            {
+                                fTMVAData[b]->fSpectralWeightedMeanEnergy_Log10TeV = x + 0.97 * i_on->GetErrorX( ii );
+                            }
+                            else
+                            {
+                                fTMVAData[b]->fSpectralWeightedMeanEnergy_Log10TeV = x;
+                            }
                         }
+                        break;
                     }
-                    break;
+                }
+                ///////////
+                // make sure that selected energy is not beyond the valid range of the graph
+                
+                // get the value of the energy, zenith and particle rate for the last index of the array
+                i_on->GetPoint( i_on->GetN() - 1, x, p );
+                
+                // energy is beyond - set it to 0.8*last value
+                if( fTMVAData[b]->fSpectralWeightedMeanEnergy_Log10TeV > x )
+                {
+                    cout << "LAST POINT " << fTMVAData[b]->fSpectralWeightedMeanEnergy_Log10TeV << "\t" << x << endl;
+                    fTMVAData[b]->fSpectralWeightedMeanEnergy_Log10TeV = TMath::Log10( TMath::Power( 10., x ) * 0.8 );
                 }
             }
-            ///////////
-            // make sure that selected energy is not beyond the valid range of the graph
+            //////////////// end of CTA ONLY /////////////////////////////////////////////////
             
-            // get the value of the energy, zenith and particle rate for the last index of the array
-            i_on->GetPoint( i_on->GetN() - 1, x, p );
-            
-            // energy is beyond - set it to 0.8*last value
-            if( fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV > x )
+            ///////////////////////////////////////////////////////////////////////////////
+            // Interpolate between the values of the TGraph2D
+            //
+            // Convert the observing time in seconds as the particle rate is given in 1/seconds
+            // Get the value of the middle of the energy and zenith angle bin
+            Ndif = i_on->Eval( fTMVAData[b]->fSpectralWeightedMeanEnergy_Log10TeV );
+            Nof = i_of->Eval( fTMVAData[b]->fSpectralWeightedMeanEnergy_Log10TeV );
+        }
+        //////////////////////////////////////////////////////////////////
+        // robust method which get excess and background counts
+        // by averaging over graphs
+        // (favored for VTS analysis)
+        else if( iOptimizationType == "UseAveragedCounts" )
+        {
+            cout << "VTVMAEvaluator::optimizeSensitivity: UseAveragedCounts (conversion rate ";
+            cout << fParticleNumberFile_Conversion_Rate_to_seconds << ")" << endl;
+            // read signal=excess counts
+            Ndif = getAverageDifferentialRateFromGraph2D( iNOn, fTMVAData[b]->fEnergyCut_Log10TeV_min,
+                    fTMVAData[b]->fEnergyCut_Log10TeV_max,
+                    i_secant_min, i_secant_max );
+            // read background counts
+            Nof = getAverageDifferentialRateFromGraph2D( iNOff, fTMVAData[b]->fEnergyCut_Log10TeV_min,
+                    fTMVAData[b]->fEnergyCut_Log10TeV_max,
+                    i_secant_min, i_secant_max );
+        }
+        else
+        {
+            cout << "VTVMAEvaluator::optimizeSensitivity: error," << endl;
+            cout << " unknown optimization type" << endl;
+            return false;
+        }
+        if( Nof < 0. )
+        {
+            Nof = 0.;
+        }
+        // correct normalisation and times dE
+        Ndif *= fOptimizationObservingTime_h * fParticleNumberFile_Conversion_Rate_to_seconds * i_dE;
+        Nof  *= fOptimizationObservingTime_h * fParticleNumberFile_Conversion_Rate_to_seconds * i_dE;
+        iOptBins[b].fNon = Ndif + Nof;
+        iOptBins[b].fNof = Nof;
+        iOptBins[b].fEnergy_Log10TeV = fTMVAData[b]->fSpectralWeightedMeanEnergy_Log10TeV;
+        
+        cout << "VTVMAEvaluator::optimizeSensitivity: event numbers before optimization: ";
+        cout << " non = " << iOptBins[b].fNon;
+        cout << " noff = " << Nof;
+        cout << " ndif = " << Ndif << " (1 CU)" << endl;
+        cout << "VTVMAEvaluator::optimizeSensitivity: data bin: ";
+        cout << b;
+        cout << ",  weighted mean energy " << TMath::Power( 10., fTMVAData[b]->fSpectralWeightedMeanEnergy_Log10TeV );
+        cout << " [TeV], ";
+        cout << fTMVAData[b]->fSpectralWeightedMeanEnergy_Log10TeV;
+        cout << " [" << fTMVAData[b]->fEnergyCut_Log10TeV_min << ", ";
+        cout << fTMVAData[b]->fEnergyCut_Log10TeV_max << "]";
+        cout << endl;
+        
+        ///////////////////////////////////////////////////////////////////
+        // get signal and background efficiency histograms
+        TH1D* effS = fTMVAData[b]->hSignalEfficiency;
+        TH1D* effB = fTMVAData[b]->hBackgroundEfficiency;
+        if( !effS || !effB )
+        {
+            cout << "VTVMAEvaluator::optimizeSensitivity: error:" << endl;
+            cout << " cannot find signal and/or background efficiency histogram(s)" << endl;
+            cout << effS << "\t" << effB << " (bin " << b << ")" << endl;
+            return false;
+        }
+        // copy efficiencies into contiguous arrays (index: ROOT bin number)
+        iOptBins[b].fNbins = effS->GetNbinsX();
+        iOptBins[b].fXmin = effS->GetXaxis()->GetXmin();
+        iOptBins[b].fXmax = effS->GetXaxis()->GetXmax();
+        iOptBins[b].fMVACut.resize( effS->GetNbinsX() + 2, 0. );
+        iOptBins[b].fEffS.resize( effS->GetNbinsX() + 2, 0. );
+        iOptBins[b].fEffB.resize( effS->GetNbinsX() + 2, 0. );
+        for( int i = 0; i <= effS->GetNbinsX() + 1; i++ )
+        {
+            iOptBins[b].fMVACut[i] = effS->GetBinCenter( i );
+            iOptBins[b].fEffS[i] = effS->GetBinContent( i );
+            iOptBins[b].fEffB[i] = effB->GetBinContent( i );
+        }
+        // variable bin sizes
+        if( effS->GetXaxis()->GetXbins()->GetSize() > 0 )
+        {
+            for( int i = 1; i <= effS->GetNbinsX() + 1; i++ )
             {
-                cout << "LAST POINT " << fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV << "\t" << x << endl;
-                fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV = TMath::Log10( TMath::Power( 10., x ) * 0.8 );
+                iOptBins[b].fBinLowEdges.push_back( effS->GetXaxis()->GetBinLowEdge( i ) );
             }
         }
-        //////////////// end of CTA ONLY /////////////////////////////////////////////////
-        
-        ///////////////////////////////////////////////////////////////////////////////
-        // Interpolate between the values of the TGraph2D
-        //
-        // Convert the observing time in seconds as the particle rate is given in 1/seconds
-        // Get the value of the middle of the energy and zenith angle bin
-        Ndif = i_on->Eval( fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV );
-        Nof = i_of->Eval( fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV );
-    }
-    //////////////////////////////////////////////////////////////////
-    // robust method which get excess and background counts
-    // by averaging over graphs
-    // (favored for VTS analysis)
-    else if( iOptimizationType == "UseAveragedCounts" )
-    {
-        cout << "VTVMAEvaluator::optimizeSensitivity: UseAveragedCounts (conversion rate ";
-        cout << fParticleNumberFile_Conversion_Rate_to_seconds << ")" << endl;
-        // read signal=excess counts
-        Ndif = readAverageCountsFromFile( iPN, fTMVAData[iDataBin]->fEnergyCut_Log10TeV_min,
-                                          fTMVAData[iDataBin]->fEnergyCut_Log10TeV_max,
-                                          1. / cos( fTMVAData[iDataBin]->fZenithCut_min * TMath::DegToRad() ),
-                                          1. / cos( fTMVAData[iDataBin]->fZenithCut_max * TMath::DegToRad() ),
-                                          true );
-        // read background counts
-        Nof = readAverageCountsFromFile( iPN, fTMVAData[iDataBin]->fEnergyCut_Log10TeV_min,
-                                         fTMVAData[iDataBin]->fEnergyCut_Log10TeV_max,
-                                         1. / cos( fTMVAData[iDataBin]->fZenithCut_min * TMath::DegToRad() ),
-                                         1. / cos( fTMVAData[iDataBin]->fZenithCut_max * TMath::DegToRad() ),
-                                         false );
+    }
+    cout << "VTVMAEvaluator::optimizeSensitivity: optimization parameters: ";
+    cout << "maximum signal efficiency is " << fOptimizationFixedSignalEfficiency;
+    cout << " minimum source strength is " << fOptimizationMinSourceStrength;
+    cout << " (alpha: " << fOptimizationBackgroundAlpha << ")" << endl;
+    
+    //////////////////////////////////////////////////////
+    // step 2: scan over source strengths and cut values
+    unsigned int iNThreads = fOptimizationNThreads;
+    if( iNThreads == 0 )
+    {
+        iNThreads = thread::hardware_concurrency();
+    }
+    if( iNThreads > iOptBins.size() )
+    {
+        iNThreads = iOptBins.size();
+    }
+    if( iNThreads < 2 )
+    {
+        for( unsigned int b = 0; b < iOptBins.size(); b++ )
+        {
+            scanSensitivity( &iOptBins[b] );
+        }
     }
     else
     {
-        cout << "VTVMAEvaluator::optimizeSensitivity: error," << endl;
-        cout << " unknown optimization type" << endl;
-        return false;
+        cout << "VTVMAEvaluator::optimizeSensitivity: scanning " << iOptBins.size();
+        cout << " bins using " << iNThreads << " threads" << endl;
+        atomic< unsigned int > iNextBin( 0 );
+        vector< thread > iThreads;
+        for( unsigned int t = 0; t < iNThreads; t++ )
+        {
+            iThreads.push_back( thread( [this, &iOptBins, &iNextBin]()
+            {
+                for( unsigned int b = iNextBin++; b < iOptBins.size(); b = iNextBin++ )
+                {
+                    scanSensitivity( &iOptBins[b] );
+                }
+            } ) );
+        }
+        for( unsigned int t = 0; t < iThreads.size(); t++ )
+        {
+            iThreads[t].join();
+        }
     }
-    if( Nof < 0. )
-    {
-        Nof = 0.;
-    }
-    // correct normalisation and times dE
-    Ndif *= fOptimizationObservingTime_h * fParticleNumberFile_Conversion_Rate_to_seconds * i_dE;
-    Nof  *= fOptimizationObservingTime_h * fParticleNumberFile_Conversion_Rate_to_seconds * i_dE;
-    Non = Ndif + Nof;
-    
-    cout << "VTVMAEvaluator::optimizeSensitivity: event numbers before optimization: ";
-    cout << " non = " << Non;
-    cout << " noff = " << Nof;
-    cout << " ndif = " << Ndif << " (1 CU)" << endl;
-    cout << "VTVMAEvaluator::optimizeSensitivity: data bin: ";
-    cout << iDataBin;
-    cout << ",  weighted mean energy " << TMath::Power( 10., fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV );
-    cout << " [TeV], ";
-    cout << fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV;
-    cout << " [" << fTMVAData[iDataBin]->fEnergyCut_Log10TeV_min << ", ";
-    cout << fTMVAData[iDataBin]->fEnergyCut_Log10TeV_max << "]";
-    cout << endl;
-    
-    ///////////////////////////////////////////////////////////////////
-    // get signal and background efficiency histograms from TMVA files
     
-    TFile* iTMVAFile = new TFile( fTMVAData[iDataBin]->fTMVAFileName.c_str() );
-    if( iTMVAFile->IsZombie() )
+    //////////////////////////////////////////////////////
+    // step 3: fill and print results
+    for( unsigned int b = 0; b < iOptBins.size(); b++ )
     {
-        cout << "VTVMAEvaluator::optimizeSensitivity: error:" << endl;
-        cout << " cannot read TMVA file " << fTMVAData[iDataBin]->fTMVAFileName;
-        cout << " (bin " << iDataBin << ")" << endl;
-        return false;
+        cout << endl;
+        cout << "======================= optimize sensitivity " << b << " =======================" << endl;
+        setOptimizedSensitivity( &iOptBins[b] );
+        cout << "======================= end optimize sensitivity =======================" << endl;
+        cout << endl;
     }
-    // get signal and background efficiency histograms
-    // TH1D* effS = getEfficiencyHistogram( "effS", iTMVAFile, fTMVAData[iDataBin]->fTMVAMethodTag_2 );
-    // TH1D* effB = getEfficiencyHistogram( "effB", iTMVAFile, fTMVAData[iDataBin]->fTMVAMethodTag_2 );
-    TH1D* effS = fTMVAData[iDataBin]->hSignalEfficiency;
-    TH1D* effB = fTMVAData[iDataBin]->hBackgroundEfficiency;
-    if( !effS || !effB )
+    
+    // cleanup
+    map< pair< double, double >, pair< TGraph*, TGraph* > >::iterator i_iter;
+    for( i_iter = iInterpolatedCounts.begin(); i_iter != iInterpolatedCounts.end(); ++i_iter )
     {
-        cout << "VTVMAEvaluator::optimizeSensitivity: error:" << endl;
-        cout << " cannot find signal and/or background efficiency histogram(s)" << endl;
-        cout << effS << "\t" << effB << endl;
-        return false;
+        if( i_iter->second.first && i_iter->second.first != iNOn )
+        {
+            delete i_iter->second.first;
+        }
+        if( i_iter->second.second && i_iter->second.second != iNOff )
+        {
+            delete i_iter->second.second;
+        }
     }
+    iPN->Close();
+    delete iPN;
     
-    cout << "VTVMAEvaluator::optimizeSensitivity: optimization parameters: ";
-    cout << "maximum signal efficiency is " << fOptimizationFixedSignalEfficiency;
-    cout << " minimum source strength is " << fOptimizationMinSourceStrength;
-    cout << " (alpha: " << fOptimizationBackgroundAlpha << ")" << endl;
+    return true;
+}
+
+/*
+ * scan source strengths and cut values for a single bin
+ *
+ * uses only the arrays in VTMVAOptimizationBin
+ * (thread safe; no output to screen, no ROOT objects except read access
+ * to the angular containment histogram)
+ *
+ */
+void VTMVAEvaluator::scanSensitivity( VTMVAOptimizationBin* iB )
+{
+    if( !iB || iB->fEffS.size() < 2 )
+    {
+        return;
+    }
+    const double Non = iB->fNon;
+    const double Nof = iB->fNof;
+    const int    iNbins = iB->fNbins;
+    const double* effS = &iB->fEffS[0];
+    const double* effB = &iB->fEffB[0];
+    const double* iCut = &iB->fMVACut[0];
     
-    //////////////////////////////////////////////////////////////////////////
-    //////////////////////////////////////////////////////////////////////////
-    // optimization starts here
-    //////////////////////////////////////////////////////////////////////////
+    double Ndif = Non - Nof;
     double i_Signal_to_sqrtNoise = 0.;
     double i_AngularContainmentRadius = 0.;
     double i_AngularContainmentFraction = 0.;
-    
-    double i_TMVACutValue_AtMaximum = -99.;
-    double i_SourceStrength_atMaximum = 0.;
-    double i_SignalEfficiency_AtMaximum = -99.;
-    double i_BackgroundEfficiency_AtMaximum = -99.;
-    double i_Signal_to_sqrtNoise_atMaximum = 0.;
-    double i_AngularContainmentRadiusAtMaximum = 0.;
-    double i_AngularContainmentFractionAtMaximum = 0.;
     double iSourceStrength = 0.;
     
-    TGraph* iGSignal_to_sqrtNoise = 0;
-    TGraph* iGSignalEvents        = 0;
-    TGraph* iGBackgroundEvents    = 0;
-    TGraph* iGSignal_to_sqrtNoise_Smooth = 0;
-    TGraph* iGOpt_AngularContainmentRadius = 0;
-    TGraph* iGOpt_AngularContainmentFraction = 0;
+    // smoothed significance curve
+    vector< double > iSmooth_x;
+    vector< double > iSmooth_y;
     
     //////////////////////////////////////////////////////
     // loop over different source strengths (in Crab Units)
     // (hardwired: start at 0.001 CU to 30 CU)
     unsigned int iSourceStrengthStepSizeN =
         ( unsigned int )( ( log10( fOptimizationMaxSourceStrength ) - log10( fOptimizationMinSourceStrength ) ) / 0.005 );
-    cout << "VTVMAEvaluator::optimizeSensitivity: source strength steps: " << iSourceStrengthStepSizeN << endl;
-    cout << "VTVMAEvaluator::optimizeSensitivity: range for source strength: (";
-    cout << fOptimizationMinSourceStrength << ", " << fOptimizationMaxSourceStrength << ") CU" << endl;
+    iB->fLog << "VTVMAEvaluator::optimizeSensitivity: source strength steps: " << iSourceStrengthStepSizeN << endl;
+    iB->fLog << "VTVMAEvaluator::optimizeSensitivity: range for source strength: (";
+    iB->fLog << fOptimizationMinSourceStrength << ", " << fOptimizationMaxSourceStrength << ") CU" << endl;
     for( unsigned int s = 0; s < iSourceStrengthStepSizeN; s++ )
     {
         iSourceStrength = log10( fOptimizationMinSourceStrength ) + s * 0.005;
         iSourceStrength = TMath::Power( 10., iSourceStrength );
+        iB->fSourceStrength = iSourceStrength;
         
         // source events
         Ndif = ( Non - Nof ) * iSourceStrength;
@@ -2475,14 +2576,14 @@ bool VTMVAEvaluator::optimizeSensitivity( unsigned int iDataBin,
         // (needed to speed up the calculation)
         // (ignore any detail, no optimization of angular cut)
         bool bPassed = false;
-        for( int i = 1; i < effS->GetNbinsX(); i++ )
+        if( Nof > 0. && fOptimizationBackgroundAlpha > 0. )
         {
-            if( effB->GetBinContent( i ) > 0. && Nof > 0. )
+            for( int i = 1; i < iNbins; i++ )
             {
-                if( fOptimizationBackgroundAlpha > 0. )
+                if( effB[i] > 0. )
                 {
-                    i_Signal_to_sqrtNoise = VStatistics::calcSignificance( effS->GetBinContent( i ) * Ndif + effB->GetBinContent( i ) * Nof,
-                                            effB->GetBinContent( i ) * Nof / fOptimizationBackgroundAlpha,
+                    i_Signal_to_sqrtNoise = VStatistics::calcSignificance( effS[i] * Ndif + effB[i] * Nof,
+                                            effB[i] * Nof / fOptimizationBackgroundAlpha,
                                             fOptimizationBackgroundAlpha );
                     // check significance criteria
                     if( i_Signal_to_sqrtNoise > fOptimizationSourceSignificance )
@@ -2491,10 +2592,6 @@ bool VTMVAEvaluator::optimizeSensitivity( unsigned int iDataBin,
                         break;
                     }
                 }
-                else
-                {
-                    break;
-                }
             }
         }
         // no chance to pass significance criteria -> continue to next energy bin
@@ -2509,44 +2606,42 @@ bool VTMVAEvaluator::optimizeSensitivity( unsigned int iDataBin,
         i_AngularContainmentRadius = 0.;
         i_AngularContainmentFraction = 0.;
         
-        i_TMVACutValue_AtMaximum = -99.;
-        i_SourceStrength_atMaximum = 0.;
-        i_SignalEfficiency_AtMaximum = -99.;
-        i_BackgroundEfficiency_AtMaximum = -99.;
-        i_Signal_to_sqrtNoise_atMaximum = 0.;
-        i_AngularContainmentRadiusAtMaximum = 0.;
-        i_AngularContainmentFractionAtMaximum = 0.;
+        iB->fTMVACutValue_AtMaximum = -99.;
+        iB->fSourceStrength_atMaximum = 0.;
+        iB->fSignalEfficiency_AtMaximum = -99.;
+        iB->fBackgroundEfficiency_AtMaximum = -99.;
+        iB->fSignal_to_sqrtNoise_atMaximum = 0.;
         
-        iGSignal_to_sqrtNoise = new TGraph( 1 );
-        iGSignalEvents        = new TGraph( 1 );
-        iGBackgroundEvents    = new TGraph( 1 );
-        iGOpt_AngularContainmentRadius = new TGraph( 1 );
-        iGOpt_AngularContainmentFraction = new TGraph( 1 );
+        iB->fSignal_to_sqrtNoise_x.clear();
+        iB->fSignal_to_sqrtNoise_y.clear();
+        iB->fSignalEvents_y.clear();
+        iB->fBackgroundEvents_y.clear();
+        iB->fSignalEvents_x.clear();
+        iB->fAngularContainmentRadius_y.clear();
+        iB->fAngularContainmentFraction_y.clear();
         
-        int z = 0;
-        int z_SB = 0;
         // loop over all signal efficiency bins
-        for( int i = 1; i < effS->GetNbinsX(); i++ )
+        for( int i = 1; i < iNbins; i++ )
         {
-            if( effB->GetBinContent( i ) > 0. && Nof > 0. )
+            if( effB[i] > 0. && Nof > 0. )
             {
                 if( fOptimizationBackgroundAlpha > 0. )
                 {
                     // optimize angular containment radius (theta2)
-                    if( iHAngContainment && fTMVA_OptimizeAngularContainment )
+                    if( iB->fHAngContainment && fTMVA_OptimizeAngularContainment )
                     {
-                        getOptimalAngularContainmentRadius( effS->GetBinContent( i ), effB->GetBinContent( i ), Ndif, Nof,
-                                                            iHAngContainment, fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV,
+                        getOptimalAngularContainmentRadius( effS[i], effB[i], Ndif, Nof,
+                                                            iB->fHAngContainment, iB->fEnergy_Log10TeV,
                                                             i_Signal_to_sqrtNoise, i_AngularContainmentRadius, i_AngularContainmentFraction );
                     }
                     // optimize signal/sqrt(noise)
                     else
                     {
-                        i_Signal_to_sqrtNoise = VStatistics::calcSignificance( effS->GetBinContent( i ) * Ndif + effB->GetBinContent( i ) * Nof,
-                                                effB->GetBinContent( i ) * Nof / fOptimizationBackgroundAlpha,
+                        i_Signal_to_sqrtNoise = VStatistics::calcSignificance( effS[i] * Ndif + effB[i] * Nof,
+                                                effB[i] * Nof / fOptimizationBackgroundAlpha,
                                                 fOptimizationBackgroundAlpha );
-                        i_AngularContainmentRadius = VHistogramUtilities::interpolateTH2D( iHAngContainment,
-                                                     fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV,
+                        i_AngularContainmentRadius = VHistogramUtilities::interpolateTH2D( iB->fHAngContainment,
+                                                     iB->fEnergy_Log10TeV,
                                                      fTMVAngularContainmentRadiusMax );
                         i_AngularContainmentFraction = fTMVAngularContainmentRadiusMax;
                     }
@@ -2559,179 +2654,216 @@ bool VTMVAEvaluator::optimizeSensitivity( unsigned int iDataBin,
                 }
                 if( fDebug )
                 {
-                    cout << "___________________________________________________________" << endl;
-                    cout << i << "\t" << Non << "\t" << effS->GetBinContent( i )  << "\t";
-                    cout << Nof << "\t" << effB->GetBinContent( i ) << "\t";
-                    cout << Ndif << endl;
-                    cout << "\t" << effS->GetBinContent( i ) * Ndif;
-                    cout << "\t" << effS->GetBinContent( i ) * Ndif + effB->GetBinContent( i ) * Nof;
-                    cout << "\t" << effS->GetBinContent( i ) * Non + effB->GetBinContent( i ) * Nof;
-                    cout << "\t" << effB->GetBinContent( i ) * Nof << endl;
+                    iB->fLog << "___________________________________________________________" << endl;
+                    iB->fLog << i << "\t" << Non << "\t" << effS[i]  << "\t";
+                    iB->fLog << Nof << "\t" << effB[i] << "\t";
+                    iB->fLog << Ndif << endl;
+                    iB->fLog << "\t" << effS[i] * Ndif;
+                    iB->fLog << "\t" << effS[i] * Ndif + effB[i] * Nof;
+                    iB->fLog << "\t" << effS[i] * Non + effB[i] * Nof;
+                    iB->fLog << "\t" << effB[i] * Nof << endl;
                 }
-                if( effS->GetBinContent( i ) * Ndif > 0. )
+                if( effS[i] * Ndif > 0. )
                 {
-                    iGSignalEvents->SetPoint( z_SB, effS->GetBinCenter( i ),  effS->GetBinContent( i ) * Ndif );
-                    iGBackgroundEvents->SetPoint( z_SB, effS->GetBinCenter( i ), effB->GetBinContent( i ) * Nof );
-                    z_SB++;
+                    iB->fSignalEvents_x.push_back( iCut[i] );
+                    iB->fSignalEvents_y.push_back( effS[i] * Ndif );
+                    iB->fBackgroundEvents_y.push_back( effB[i] * Nof );
                 }
                 // check that a minimum number of off events is available
-                if( effB->GetBinContent( i ) * Nof < fOptimizationMinBackGroundEvents )
+                if( effB[i] * Nof < fOptimizationMinBackGroundEvents )
                 {
                     if( fDebug )
                     {
-                        cout << "\t number of background events lower than ";
-                        cout << fOptimizationMinBackGroundEvents << ": setting signal/sqrt(noise) to 0; bin " << i << endl;
+                        iB->fLog << "\t number of background events lower than ";
+                        iB->fLog << fOptimizationMinBackGroundEvents << ": setting signal/sqrt(noise) to 0; bin " << i << endl;
                     }
                     i_Signal_to_sqrtNoise = 0.;
                 }
                 // add results to a graph
-                if( iGSignal_to_sqrtNoise && i_Signal_to_sqrtNoise > 1.e-2 )
+                if( i_Signal_to_sqrtNoise > 1.e-2 )
                 {
-                    iGSignal_to_sqrtNoise->SetPoint( z, effS->GetBinCenter( i ), i_Signal_to_sqrtNoise );
-                    iGOpt_AngularContainmentRadius->SetPoint( z, effS->GetBinCenter( i ), i_AngularContainmentRadius );
-                    iGOpt_AngularContainmentFraction->SetPoint( z, effS->GetBinCenter( i ), i_AngularContainmentFraction );
+                    iB->fSignal_to_sqrtNoise_x.push_back( iCut[i] );
+                    iB->fSignal_to_sqrtNoise_y.push_back( i_Signal_to_sqrtNoise );
+                    iB->fAngularContainmentRadius_y.push_back( i_AngularContainmentRadius );
+                    iB->fAngularContainmentFraction_y.push_back( i_AngularContainmentFraction );
                     if( fDebug )
                     {
-                        cout << "\t SET " << z << "\t" << effS->GetBinCenter( i ) << "\t" << i_Signal_to_sqrtNoise << "\t";
-                        cout << i_AngularContainmentRadius << "\t" << i_AngularContainmentFraction << endl;
+                        iB->fLog << "\t SET " << iB->fSignal_to_sqrtNoise_x.size() - 1 << "\t" << iCut[i] << "\t" << i_Signal_to_sqrtNoise << "\t";
+                        iB->fLog << i_AngularContainmentRadius << "\t" << i_AngularContainmentFraction << endl;
                     }
-                    z++;
                 }
                 if( fDebug )
                 {
-                    cout << "\t z " << z << "\t" << i_Signal_to_sqrtNoise << endl;
-                    cout << "___________________________________________________________" << endl;
+                    iB->fLog << "\t z " << iB->fSignal_to_sqrtNoise_x.size() << "\t" << i_Signal_to_sqrtNoise << endl;
+                    iB->fLog << "___________________________________________________________" << endl;
                 }
             }
         } // END loop over all signal efficiency bins
         /////////////////////////
         // determine position of maximum significance
-        // fill a histogram from these values, smooth it, and determine position of maximum significance
+        // smooth significance curve and determine position of maximum significance
+        // (graphs without any entry contain a single point at (0,0))
+        if( iB->fSignal_to_sqrtNoise_x.size() == 0 )
+        {
+            iB->fSignal_to_sqrtNoise_x.push_back( 0. );
+            iB->fSignal_to_sqrtNoise_y.push_back( 0. );
+            iB->fAngularContainmentRadius_y.push_back( 0. );
+            iB->fAngularContainmentFraction_y.push_back( 0. );
+        }
+        smoothKernelNormal( iB->fSignal_to_sqrtNoise_x, iB->fSignal_to_sqrtNoise_y, iSmooth_x, iSmooth_y, 0.05, 100 );
+        // find maximum in significance plot
         double i_xmax = -99.;
-        if( iGSignal_to_sqrtNoise )
+        double i_ymax = -99.;
+        double i_xmax_global = -99.;
+        double i_ymax_global = -99.;
+        for( unsigned int i = 0; i < iSmooth_x.size(); i++ )
         {
-            TGraphSmooth* iGSmooth = new TGraphSmooth( "s" );
-            iGSignal_to_sqrtNoise_Smooth = iGSmooth->SmoothKern( iGSignal_to_sqrtNoise, "normal", 0.05, 100 );
-            // find maximum in significance plot
-            double i_ymax = -99.;
-            double i_xmax_global = -99.;
-            double i_ymax_global = -99.;
-            for( int i = 0; i < iGSignal_to_sqrtNoise_Smooth->GetN(); i++ )
+            i_xmax = iSmooth_x[i];
+            i_ymax = iSmooth_y[i];
+            
+            /// check if this point passes all critera:
+            // - significance
+            // - systematic criterium
+            // - min number of background events
+            
+            // passed significance criteria
+            if( i_ymax >= fOptimizationSourceSignificance )
             {
-                iGSignal_to_sqrtNoise_Smooth->GetPoint( i, i_xmax, i_ymax );
-                
-                /// check if this point passes all critera:
-                // - significance
-                // - systematic criterium
-                // - min number of background events
-                
-                // passed significance criteria
-                if( i_ymax >= fOptimizationSourceSignificance )
+                iB->fSignalEfficiency_AtMaximum     = effS[iB->findBin( i_xmax )];
+                iB->fBackgroundEfficiency_AtMaximum = effB[iB->findBin( i_xmax )];
+                // systematic cut criterium
+                if( iB->fBackgroundEfficiency_AtMaximum * Nof > 0 && fOptimizationBackgroundAlpha > 0. )
                 {
-                    i_SignalEfficiency_AtMaximum     = effS->GetBinContent( effS->FindBin( i_xmax ) );
-                    i_BackgroundEfficiency_AtMaximum = effB->GetBinContent( effB->FindBin( i_xmax ) );
-                    // systematic cut criterium
-                    if( i_BackgroundEfficiency_AtMaximum * Nof > 0 && fOptimizationBackgroundAlpha > 0. )
+                    if( Ndif * iB->fSignalEfficiency_AtMaximum / ( iB->fBackgroundEfficiency_AtMaximum * Nof ) >= fMinBackgroundRateRatio_min )
                     {
-                        if( Ndif * i_SignalEfficiency_AtMaximum / ( i_BackgroundEfficiency_AtMaximum * Nof ) >= fMinBackgroundRateRatio_min )
+                        // number of signal events criterium
+                        if( Ndif * iB->fSignalEfficiency_AtMaximum >= fOptimizationMinSignalEvents )
                         {
-                            // number of signal events criterium
-                            if( Ndif * i_SignalEfficiency_AtMaximum >= fOptimizationMinSignalEvents )
+                            // check if this is a global maximum
+                            // (otherwise would find first bin above sig requirement)
+                            if( i_ymax > i_ymax_global )
                             {
-                                // check if this is a global maximum
-                                // (otherwise would find first bin above sig requirement)
-                                if( i_ymax > i_ymax_global )
-                                {
-                                    i_xmax_global = i_xmax;
-                                    i_ymax_global = i_ymax;
-                                }
+                                i_xmax_global = i_xmax;
+                                i_ymax_global = i_ymax;
                             }
                         }
                     }
                 }
             }
-            i_SignalEfficiency_AtMaximum     = effS->GetBinContent( effS->FindBin( i_xmax_global ) );
-            i_BackgroundEfficiency_AtMaximum = effB->GetBinContent( effB->FindBin( i_xmax_global ) );
-            i_TMVACutValue_AtMaximum         = i_xmax_global;
-            i_Signal_to_sqrtNoise_atMaximum  = i_ymax_global;
-            i_SourceStrength_atMaximum       = iSourceStrength;
-            i_AngularContainmentRadiusAtMaximum = iGOpt_AngularContainmentRadius->Eval( i_xmax_global );
-            i_AngularContainmentFractionAtMaximum = iGOpt_AngularContainmentFraction->Eval( i_xmax_global );
         }
-        fTMVAData[iDataBin]->fTMVAOptimumCutValueFound = true;
+        iB->fSignalEfficiency_AtMaximum     = effS[iB->findBin( i_xmax_global )];
+        iB->fBackgroundEfficiency_AtMaximum = effB[iB->findBin( i_xmax_global )];
+        iB->fTMVACutValue_AtMaximum         = i_xmax_global;
+        iB->fSignal_to_sqrtNoise_atMaximum  = i_ymax_global;
+        iB->fSourceStrength_atMaximum       = iSourceStrength;
+        iB->fSmooth_x = iSmooth_x;
+        iB->fSmooth_y = iSmooth_y;
+        iB->fOptimumCutValueFound = true;
         /////////////////////////////////
         // check detection criteria
         
         // significance criteria
-        bool bPassed_MinimumSignificance = ( i_Signal_to_sqrtNoise_atMaximum >= fOptimizationSourceSignificance );
+        bool bPassed_MinimumSignificance = ( iB->fSignal_to_sqrtNoise_atMaximum >= fOptimizationSourceSignificance );
         // require a minimum number of signal events
-        bool bPassed_MinimumSignalEvents = ( Ndif * i_SignalEfficiency_AtMaximum >= fOptimizationMinSignalEvents );
+        bool bPassed_MinimumSignalEvents = ( Ndif * iB->fSignalEfficiency_AtMaximum >= fOptimizationMinSignalEvents );
         // require the signal to be larger than a certain fraction of background
         bool bPasses_MinimumSystematicCut = false;
-        if( i_BackgroundEfficiency_AtMaximum * Nof > 0 && fOptimizationBackgroundAlpha > 0. )
+        if( iB->fBackgroundEfficiency_AtMaximum * Nof > 0 && fOptimizationBackgroundAlpha > 0. )
         {
             bPasses_MinimumSystematicCut =
-                ( Ndif * i_SignalEfficiency_AtMaximum / ( i_BackgroundEfficiency_AtMaximum * Nof )
+                ( Ndif * iB->fSignalEfficiency_AtMaximum / ( iB->fBackgroundEfficiency_AtMaximum * Nof )
                   >= fMinBackgroundRateRatio_min );
         }
         
         if( bPassed_MinimumSignificance && !bPassed_MinimumSignalEvents )
         {
-            cout << "\t passed significance but not signal events criterium";
-            cout << " (" << iSourceStrength << " CU): ";
-            cout << "sig " << i_Signal_to_sqrtNoise_atMaximum;
-            cout << ", Ndif " << Ndif* i_SignalEfficiency_AtMaximum << endl;
+            iB->fLog << "\t passed significance but not signal events criterium";
+            iB->fLog << " (" << iSourceStrength << " CU): ";
+            iB->fLog << "sig " << iB->fSignal_to_sqrtNoise_atMaximum;
+            iB->fLog << ", Ndif " << Ndif* iB->fSignalEfficiency_AtMaximum << endl;
         }
         if( bPassed_MinimumSignificance && !bPasses_MinimumSystematicCut )
         {
-            cout << "\t passed significance but not systematics criterium";
-            cout << " (" << iSourceStrength << " CU): ";
-            cout << "sig " << i_Signal_to_sqrtNoise_atMaximum;
-            cout << ", Ndif " << Ndif* i_SignalEfficiency_AtMaximum;
-            cout << ", Noff " << i_BackgroundEfficiency_AtMaximum* Nof;
-            if( i_BackgroundEfficiency_AtMaximum * Nof > 1.e-10 )
+            iB->fLog << "\t passed significance but not systematics criterium";
+            iB->fLog << " (" << iSourceStrength << " CU): ";
+            iB->fLog << "sig " << iB->fSignal_to_sqrtNoise_atMaximum;
+            iB->fLog << ", Ndif " << Ndif* iB->fSignalEfficiency_AtMaximum;
+            iB->fLog << ", Noff " << iB->fBackgroundEfficiency_AtMaximum* Nof;
+            if( iB->fBackgroundEfficiency_AtMaximum * Nof > 1.e-10 )
             {
-                cout << ", sig/bck ratio ";
-                cout << Ndif* i_SignalEfficiency_AtMaximum / ( i_BackgroundEfficiency_AtMaximum * Nof );
+                iB->fLog << ", sig/bck ratio ";
+                iB->fLog << Ndif* iB->fSignalEfficiency_AtMaximum / ( iB->fBackgroundEfficiency_AtMaximum * Nof );
             }
-            cout << endl;
+            iB->fLog << endl;
         }
         // good! Passed all three requirements --> exit loop over source strengths
         if( bPassed_MinimumSignificance && bPassed_MinimumSignalEvents && bPasses_MinimumSystematicCut )
         {
             break;
         }
-        
-        // delete graphs
-        // (not in last step, keep them there for plotting)
-        if( s != iSourceStrengthStepSizeN - 1 )
+    } // end of loop over source strength
+    iB->fNdif = Ndif;
+}
+
+/*
+ * fill results of the sensitivity optimization for a single bin
+ * into the data vectors and print results
+ *
+ */
+void VTMVAEvaluator::setOptimizedSensitivity( VTMVAOptimizationBin* iB )
+{
+    if( !iB || iB->fDataBin >= fTMVAData.size() || !fTMVAData[iB->fDataBin] )
+    {
+        return;
+    }
+    unsigned int iDataBin = iB->fDataBin;
+    TH1D* effS = fTMVAData[iDataBin]->hSignalEfficiency;
+    TH1D* effB = fTMVAData[iDataBin]->hBackgroundEfficiency;
+    double Ndif = iB->fNdif;
+    double Nof = iB->fNof;
+    double iSourceStrength = iB->fSourceStrength;
+    double i_TMVACutValue_AtMaximum = iB->fTMVACutValue_AtMaximum;
+    double i_SignalEfficiency_AtMaximum = iB->fSignalEfficiency_AtMaximum;
+    double i_BackgroundEfficiency_AtMaximum = iB->fBackgroundEfficiency_AtMaximum;
+    double i_AngularContainmentRadiusAtMaximum = 0.;
+    double i_AngularContainmentFractionAtMaximum = 0.;
+    
+    cout << iB->fLog.str();
+    
+    // graphs describing optimization procedure
+    // (for last source strength step)
+    TGraph* iGSignal_to_sqrtNoise = 0;
+    TGraph* iGSignalEvents        = 0;
+    TGraph* iGBackgroundEvents    = 0;
+    TGraph* iGSignal_to_sqrtNoise_Smooth = 0;
+    TGraph* iGOpt_AngularContainmentRadius = 0;
+    TGraph* iGOpt_AngularContainmentFraction = 0;
+    if( iB->fOptimumCutValueFound )
+    {
+        iGSignal_to_sqrtNoise = new TGraph( ( int )iB->fSignal_to_sqrtNoise_x.size(),
+                                            &iB->fSignal_to_sqrtNoise_x[0], &iB->fSignal_to_sqrtNoise_y[0] );
+        iGOpt_AngularContainmentRadius = new TGraph( ( int )iB->fSignal_to_sqrtNoise_x.size(),
+                &iB->fSignal_to_sqrtNoise_x[0], &iB->fAngularContainmentRadius_y[0] );
+        iGOpt_AngularContainmentFraction = new TGraph( ( int )iB->fSignal_to_sqrtNoise_x.size(),
+                &iB->fSignal_to_sqrtNoise_x[0], &iB->fAngularContainmentFraction_y[0] );
+        if( iB->fSignalEvents_x.size() > 0 )
         {
-            if( iGSignal_to_sqrtNoise )
-            {
-                delete iGSignal_to_sqrtNoise;
-            }
-            if( iGSignalEvents )
-            {
-                delete iGSignalEvents;
-            }
-            if( iGBackgroundEvents )
-            {
-                delete iGBackgroundEvents;
-            }
-            if( iGSignal_to_sqrtNoise_Smooth )
-            {
-                delete iGSignal_to_sqrtNoise_Smooth;
-            }
-            if( iGOpt_AngularContainmentRadius )
-            {
-                delete iGOpt_AngularContainmentRadius;
-            }
-            if( iGOpt_AngularContainmentFraction )
-            {
-                delete iGOpt_AngularContainmentFraction;
-            }
+            iGSignalEvents = new TGraph( ( int )iB->fSignalEvents_x.size(), &iB->fSignalEvents_x[0], &iB->fSignalEvents_y[0] );
+            iGBackgroundEvents = new TGraph( ( int )iB->fSignalEvents_x.size(), &iB->fSignalEvents_x[0], &iB->fBackgroundEvents_y[0] );
         }
-    } // end of loop over source strength
+        else
+        {
+            iGSignalEvents = new TGraph( 1 );
+            iGBackgroundEvents = new TGraph( 1 );
+        }
+        if( iB->fSmooth_x.size() > 0 )
+        {
+            iGSignal_to_sqrtNoise_Smooth = new TGraph( ( int )iB->fSmooth_x.size(), &iB->fSmooth_x[0], &iB->fSmooth_y[0] );
+        }
+        i_AngularContainmentRadiusAtMaximum = iGOpt_AngularContainmentRadius->Eval( i_TMVACutValue_AtMaximum );
+        i_AngularContainmentFractionAtMaximum = iGOpt_AngularContainmentFraction->Eval( i_TMVACutValue_AtMaximum );
+        fTMVAData[iDataBin]->fTMVAOptimumCutValueFound = true;
+    }
     cout << "VTVMAEvaluator::optimizeSensitivity (finished looping over source strengths)";
     cout << ", last value: " << iSourceStrength << endl;
     ///////////////////////////////////////////////////////////////////////
@@ -2777,11 +2909,11 @@ bool VTMVAEvaluator::optimizeSensitivity( unsigned int iDataBin,
     // regular case:
     //   - maximum found and reasonable
     //   - signal efficiency in allowed range
-    else if( i_SourceStrength_atMaximum > 0. )
+    else if( iB->fSourceStrength_atMaximum > 0. )
     {
         cout << "VTMVAEvaluator::optimizeSensitivity: signal efficiency at maximum (";
-        cout << i_SourceStrength_atMaximum << " CU) is ";
-        cout << i_SignalEfficiency_AtMaximum << " with a significance of " << i_Signal_to_sqrtNoise_atMaximum << endl;
+        cout << iB->fSourceStrength_atMaximum << " CU) is ";
+        cout << i_SignalEfficiency_AtMaximum << " with a significance of " << iB->fSignal_to_sqrtNoise_atMaximum << endl;
         cout << "\t Ndiff = " << Ndif << ", Nof " << i_BackgroundEfficiency_AtMaximum* Nof << endl;
         if( ( i_BackgroundEfficiency_AtMaximum * Nof ) > 1.e-10 )
         {
@@ -2806,12 +2938,12 @@ bool VTMVAEvaluator::optimizeSensitivity( unsigned int iDataBin,
         cout << "%, radius ";
         cout << i_AngularContainmentRadiusAtMaximum << " [deg]";
     }
-    if( iHAngContainment )
+    if( iB->fHAngContainment )
     {
         cout << " (scaled from ";
-        cout << iHAngContainment->GetBinContent(
-                 iHAngContainment->GetXaxis()->FindBin( fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV ),
-                 iHAngContainment->GetYaxis()->FindBin( fTMVAngularContainmentRadiusMax ) );
+        cout << iB->fHAngContainment->GetBinContent(
+                 iB->fHAngContainment->GetXaxis()->FindBin( fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV ),
+                 iB->fHAngContainment->GetYaxis()->FindBin( fTMVAngularContainmentRadiusMax ) );
         cout << " [deg], " << fTMVAngularContainmentRadiusMax * 100. << "%)";
     }
     cout << endl;
@@ -2831,15 +2963,21 @@ bool VTMVAEvaluator::optimizeSensitivity( unsigned int iDataBin,
     double iMeanEnergyAfterCuts = -99.;
     if( fDebug )
     {
-        iMeanEnergyAfterCuts = getMeanEnergyAfterCut( iTMVAFile, i_TMVACutValue_AtMaximum, iDataBin );
-        cout << "Mean energy after cuts [TeV]: " << iMeanEnergyAfterCuts << endl;
+        TFile* iTMVAFile = new TFile( fTMVAData[iDataBin]->fTMVAFileName.c_str() );
+        if( !iTMVAFile->IsZombie() )
+        {
+            iMeanEnergyAfterCuts = getMeanEnergyAfterCut( iTMVAFile, i_TMVACutValue_AtMaximum, iDataBin );
+            cout << "Mean energy after cuts [TeV]: " << iMeanEnergyAfterCuts << endl;
+        }
+        iTMVAFile->Close();
+        delete iTMVAFile;
     }
     
     // fill results into data vectors
     fTMVAData[iDataBin]->fSignalEfficiency           = i_SignalEfficiency_AtMaximum;
     fTMVAData[iDataBin]->fBackgroundEfficiency       = i_BackgroundEfficiency_AtMaximum;
     fTMVAData[iDataBin]->fTMVACutValue               = i_TMVACutValue_AtMaximum;
-    fTMVAData[iDataBin]->fSourceStrengthAtOptimum_CU = i_SourceStrength_atMaximum;
+    fTMVAData[iDataBin]->fSourceStrengthAtOptimum_CU = iB->fSourceStrength_atMaximum;
     if( iMeanEnergyAfterCuts > 0. )
     {
         fTMVAData[iDataBin]->fSpectralWeightedMeanEnergy_Log10TeV = log10( iMeanEnergyAfterCuts );
@@ -2854,8 +2992,85 @@ bool VTMVAEvaluator::optimizeSensitivity( unsigned int iDataBin,
                                    effS, effB, iGSignalEvents, iGBackgroundEvents,
                                    iGOpt_AngularContainmentRadius, iGOpt_AngularContainmentFraction );
     }
+}
+
+/*
+ * kernel smoothing with a normal kernel
+ *
+ * array version of TGraphSmooth::SmoothKern( g, "normal", bandwidth, nout )
+ * (output on an equidistant grid between smallest and largest x value)
+ *
+ */
+void VTMVAEvaluator::smoothKernelNormal( vector< double >& x, vector< double >& y,
+        vector< double >& xs, vector< double >& ys,
+        double iBandwidth, unsigned int iNout )
+{
+    xs.clear();
+    ys.clear();
+    if( x.size() == 0 || x.size() != y.size() )
+    {
+        return;
+    }
+    // sort input values in x
+    vector< double > xi( x.size() );
+    vector< double > yi( x.size() );
+    vector< int > index( x.size() );
+    TMath::Sort( ( int )x.size(), &x[0], &index[0], kFALSE );
+    for( unsigned int i = 0; i < x.size(); i++ )
+    {
+        xi[i] = x[index[i]];
+        yi[i] = y[index[i]];
+    }
+    int n = ( int )xi.size();
+    int np = TMath::Max( ( int )iNout, n );
+    double delta = ( xi[n - 1] - xi[0] ) / ( np - 1 );
+    xs.resize( np );
+    ys.resize( np, 0. );
+    for( int j = 0; j < np; j++ )
+    {
+        xs[j] = xi[0] + j * delta;
+    }
     
-    return true;
+    // bandwidth is in units of half inter-quartile range
+    double bw = iBandwidth * 0.3706506;
+    double cutoff = 4. * bw;
+    int imin = 0;
+    while( imin < n && xi[imin] < xs[0] - cutoff )
+    {
+        imin++;
+    }
+    for( int j = 0; j < np; j++ )
+    {
+        double num = 0.;
+        double den = 0.;
+        double x0 = xs[j];
+        for( int i = imin; i < n; i++ )
+        {
+            if( xi[i] < x0 - cutoff )
+            {
+                imin = i;
+            }
+            else
+            {
+                if( xi[i] > x0 + cutoff )
+                {
+                    break;
+                }
+                double xx = TMath::Abs( xi[i] - x0 ) / bw;
+                double w = TMath::Exp( -0.5 * xx * xx );
+                num += w * yi[i];
+                den += w;
+            }
+        }
+        if( den > 0. )
+        {
+            ys[j] = num / den;
+        }
+        else
+        {
+            ys[j] = 0.;
+        }
+    }
 }
 
 
@@ -3665,56 +3880,6 @@ vector< bool > VTMVAEvaluator::getOptimumCutValueFound()
     return iA;
 }
 
-/*
- * read graph with on/off numbers as a function of energy and possibly zenith angle
- * Interpolates between zenith range and return a TGraph
- * zenith angles given given in secants
- *
- */
-TGraph* VTMVAEvaluator::readInterpolatedCountsFromFile( TFile* iF, double i_secant_min, double i_secant_max, bool bIsOn )
-{
-    if( !iF && iF->IsZombie() )
-    {
-        return 0;
-    }
-    TObject* i_N = 0;
-    if( bIsOn )
-    {
-        i_N = iF->Get( "gSignalRate" );
-    }
-    else
-    {
-        i_N = iF->Get( "gBGRate" );
-    }
-    return ( TGraph* )getInterpolatedDifferentialRatesfromGraph2D( i_N, i_secant_min, i_secant_max );
-}
-
-/*
- * read rates with signal and off numbers as a function of energy and possibly zenith angle
- * return a double
- *
- * zenith angles are given in secants
- *
-*/
-double VTMVAEvaluator::readAverageCountsFromFile( TFile* iF, double i_e_min, double i_e_max,
-        double i_secant_min, double i_secant_max, bool bIsOn )
-{
-    if( !iF && iF->IsZombie() )
-    {
-        return 0;
-    }
-    TObject* i_N = 0;
-    if( bIsOn )
-    {
-        i_N = iF->Get( "gSignalRate" );
-    }
-    else
-    {
-        i_N = iF->Get( "gBGRate" );
-    }
-    return ( double )getAverageDifferentialRateFromGraph2D( i_N, i_e_min, i_e_max, i_secant_min, i_secant_max );
-}
-
 /*
  * fill by Interpolation a TGraph2D into TGraph (if necessary)
  *
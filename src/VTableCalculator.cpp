@@ -31,6 +31,8 @@ VTableCalculator::VTableCalculator( int intel, bool iEnergy, bool iPE )
     }
     hMedian = 0;
     hMean = 0;
+    fCompiledMedian = 0;
+    fBinning1Dxbins = 0;
     
     fWriteTables = false;
     
@@ -78,6 +80,7 @@ VTableCalculator::VTableCalculator( string fpara, string hname_add,
     fHName_Add = hname_add;
     
     fName = fpara;
+    fCompiledMedian = 0;
     
     fInterPolWidth = 1;
     fInterPolIter = 3;
@@ -146,6 +149,9 @@ VTableCalculator::VTableCalculator( string fpara, string hname_add,
             sprintf( htitle, "%s (mean) [TeV]", fpara.c_str() );
         }
         hMean->SetZTitle( htitle );
+        // histograms are owned by this class (and written in terminate())
+        hMedian->SetDirectory( 0 );
+        hMean->SetDirectory( 0 );
         // 1d histograms for variable distribution
         for( i = 0; i < NumSize; i++ )
         {
@@ -167,35 +173,119 @@ VTableCalculator::VTableCalculator( string fpara, string hname_add,
     {
         fReadHistogramsFromFile = false;
         
-        if( fUseMedianEnergy == 1 )
-        {
-            sprintf( hname, "%s_median_%s", fpara.c_str(), fHName_Add.c_str() );
-        }
-        else if( fUseMedianEnergy == 2 )
+        hMedianName = getMedianHistogramName();
+    }
+
+}
+
+/*
+ * table reading from a compiled (memory-mapped) lookup table file
+ *
+ * iPath is the directory of this table in the original lookup table file
+ */
+VTableCalculator::VTableCalculator( string fpara, string hname_add,
+                                    VCompiledLookupTableFile* iCompiledFile, string iPath,
+                                    bool iEnergy, bool iPE, int iUseMedianEnergy )
+{
+    setDebug();
+    
+    // initialize variables for table value normalization
+    setNormalizeTableValues();
+    
+    fWrite1DHistograms = false;
+    fFillMedianApproximations = false;
+    
+    setConstants( iPE );
+    fEnergy = iEnergy;
+    fUseMedianEnergy = iUseMedianEnergy;
+    fReadHistogramsFromFile = false;
+    
+    setEventSelectionCut();
+    
+    fHName_Add = hname_add;
+    fName = fpara;
+    
+    fInterPolWidth = 1;
+    fInterPolIter = 3;
+    
+    setBinning();
+    
+    fOutDir = 0;
+    fWriteTables = false;
+    hMedian = 0;
+    hMean = 0;
+    
+    if( !iCompiledFile || !iCompiledFile->hasDirectory( iPath ) )
+    {
+        cout << "VTableCalculator: error data directory in compiled table file does not exist: " << iPath << "\t" << fpara << endl;
+        exit( EXIT_FAILURE );
+    }
+    hMedianName = getMedianHistogramName();
+    fCompiledMedian = iCompiledFile->getTable( iPath + "/" + hMedianName );
+}
+
+/*
+ * histograms of tables read from file are owned by the table file
+ *
+ */
+VTableCalculator::~VTableCalculator()
+{
+    if( fWriteTables )
+    {
+        for( unsigned int i = 0; i < Oh.size(); i++ )
         {
-            if( fEnergy )
+            for( unsigned int j = 0; j < Oh[i].size(); j++ )
             {
-                sprintf( hname, "%s_mpv_%s", fpara.c_str(), fHName_Add.c_str() );
+                delete Oh[i][j];
             }
-            else
+        }
+        for( unsigned int i = 0; i < OMedian.size(); i++ )
+        {
+            for( unsigned int j = 0; j < OMedian[i].size(); j++ )
             {
-                sprintf( hname, "%s_median_%s", fpara.c_str(), fHName_Add.c_str() );
+                delete OMedian[i][j];
             }
         }
+        delete hMedian;
+        delete hMean;
+    }
+    delete [] fBinning1Dxbins;
+}
+
+/*
+ * name of histogram used for table reading
+ *
+ */
+string VTableCalculator::getMedianHistogramName()
+{
+    char hname[1000];
+    if( fUseMedianEnergy == 1 )
+    {
+        sprintf( hname, "%s_median_%s", fName.c_str(), fHName_Add.c_str() );
+    }
+    else if( fUseMedianEnergy == 2 )
+    {
+        if( fEnergy )
+        {
+            sprintf( hname, "%s_mpv_%s", fName.c_str(), fHName_Add.c_str() );
+        }
         else
         {
-            if( fEnergy )
-            {
-                sprintf( hname, "%s_mean_%s", fpara.c_str(), fHName_Add.c_str() );
-            }
-            else
-            {
-                sprintf( hname, "%s_median_%s", fpara.c_str(), fHName_Add.c_str() );
-            }
+            sprintf( hname, "%s_median_%s", fName.c_str(), fHName_Add.c_str() );
         }
-        hMedianName = hname;
     }
-    
+    else
+    {
+        if( fEnergy )
+        {
+            sprintf( hname, "%s_mean_%s", fName.c_str(), fHName_Add.c_str() );
+        }
+        else
+        {
+            sprintf( hname, "%s_median_%s", fName.c_str(), fHName_Add.c_str() );
+        }
+    }
+    return hname;
 }
 
 /*
@@ -208,6 +298,8 @@ VTableCalculator::VTableCalculator( string fpara, string hname_add,
 
 void VTableCalculator::setBinning()
 {
+    fBinning1Dxbins = 0;
+    fBinning1DxbinsN = 0;
     fBinning1DXlow = 0.;
     fBinning1DXhigh = 1.;
     if( fEnergy )
@@ -296,6 +388,7 @@ bool VTableCalculator::create1DHistogram( int i, int j )
         
         Oh[i][j] = new TH1F( hisname, histitle, fBinning1DxbinsN, fBinning1Dxbins );
         Oh[i][j]->SetXTitle( fName.c_str() );
+        Oh[i][j]->SetDirectory( 0 );
         // allow automatic rebinning
         Oh[i][j]->GetXaxis()->SetCanExtend( true );
     }
@@ -333,7 +426,7 @@ void VTableCalculator::setConstants( bool iPE )
 }
 
 
-void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
+bool VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
 {
     if( iOut != 0 )
     {
@@ -343,7 +436,7 @@ void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
     if( !fOutDir->cd() )
     {
         cout << "Error: unable to reach writing directory ( VTableCalculator::terminate())" << endl;
-        return;
+        return false;
     }
     
     /////////////////////////////////////////////////////////////////////////////////////////////
@@ -353,9 +446,30 @@ void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
     {
         TDirectory* iDir1D = 0;
         // make output directory for 1D histograms
+        // (might exist already when updating a table file)
         if( fOutDir )
         {
-            iDir1D = fOutDir->mkdir( "histos1D" );
+            iDir1D = fOutDir->GetDirectory( "histos1D" );
+            if( !iDir1D )
+            {
+                iDir1D = fOutDir->mkdir( "histos1D" );
+            }
+        }
+        // add distributions of the existing table
+        // (existing tables are not overwritten if this is not possible)
+        if( iDir1D && fWrite1DHistograms )
+        {
+            if( !addHistogramsFromFile( iDir1D ) )
+            {
+                return false;
+            }
+            // mean values are accumulated for later updates
+            if( hMean )
+            {
+                iDir1D->cd();
+                hMean->Write( "hMeanProfile", TObject::kOverwrite );
+                fOutDir->cd();
+            }
         }
         
         ///////////////////////////////////
@@ -461,13 +575,15 @@ void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
                     {
                         fOutDir->cd();
                         iDir1D->cd();
-                        Oh[i][j]->Write();
+                        Oh[i][j]->Write( 0, TObject::kOverwrite );
                     }
                     delete Oh[i][j];
+                    Oh[i][j] = 0;
                 }
                 else if( fFillMedianApproximations && OMedian[i][j] )
                 {
                     delete OMedian[i][j];
+                    OMedian[i][j] = 0;
                 }
             }
         }
@@ -502,8 +618,9 @@ void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
                 {
                     cout << "(" << hMedian->GetEntries() << " entries)";
                     delete hMedian;
+                    hMedian = 0;
                     h->SetName( n.c_str() );
-                    h->Write();
+                    h->Write( 0, TObject::kOverwrite );
                     delete h;
                 }
             }
@@ -517,7 +634,7 @@ void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
                     if( h )
                     {
                         h->SetName( n.c_str() );
-                        h->Write();
+                        h->Write( 0, TObject::kOverwrite );
                     }
                     delete h;
                 }
@@ -532,7 +649,7 @@ void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
                     if( h )
                     {
                         h->SetName( n.c_str() );
-                        h->Write();
+                        h->Write( 0, TObject::kOverwrite );
                     }
                     delete h;
                 }
@@ -544,10 +661,11 @@ void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
                 if( h )
                 {
                     delete hMean;
+                    hMean = 0;
                     if( h )
                     {
                         h->SetName( n.c_str() );
-                        h->Write();
+                        h->Write( 0, TObject::kOverwrite );
                     }
                     delete h;
                 }
@@ -562,7 +680,7 @@ void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
                     if( h )
                     {
                         h->SetName( n.c_str() );
-                        h->Write();
+                        h->Write( 0, TObject::kOverwrite );
                     }
                     delete h;
                 }
@@ -570,9 +688,70 @@ void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
             cout << endl;
         }
     }
+    return true;
 }
 
 
+/*
+ * add 1D distributions and mean values from an existing table
+ * (incremental table filling; medians are recalculated from the sum)
+ *
+ * returns false for existing tables which cannot be updated
+ * (tables filled without 1D histograms)
+ */
+bool VTableCalculator::addHistogramsFromFile( TDirectory* iDir1D )
+{
+    if( !iDir1D )
+    {
+        return true;
+    }
+    TProfile2D* iMean = ( TProfile2D* )iDir1D->Get( "hMeanProfile" );
+    bool bMeanProfile = ( iMean != 0 );
+    if( hMean && iMean )
+    {
+        hMean->Add( iMean );
+    }
+    delete iMean;
+    
+    char hisname[200];
+    unsigned int iNHistograms = 0;
+    for( int i = 0; i < NumSize; i++ )
+    {
+        for( int j = 0; j < NumDist; j++ )
+        {
+            sprintf( hisname, "h%d", i * 1000 + j );
+            TH1F* h = ( TH1F* )iDir1D->Get( hisname );
+            if( !h )
+            {
+                continue;
+            }
+            if( Oh[i][j] || create1DHistogram( i, j ) )
+            {
+                Oh[i][j]->Add( h );
+                iNHistograms++;
+            }
+            delete h;
+        }
+    }
+    // existing table without accumulated mean values
+    // (filled with 1D histograms, but before mean values were stored):
+    // medians are recalculated from the sum of 1D histograms
+    if( !bMeanProfile && iNHistograms > 0 )
+    {
+        cout << "VTableCalculator::addHistogramsFromFile warning: no mean values for existing table in ";
+        cout << fOutDir->GetPath() << "; mean values are calculated from new events only" << endl;
+    }
+    // existing table without 1D histograms: statistics of the existing
+    // table would be lost
+    else if( !bMeanProfile && fOutDir && hMedian && fOutDir->FindKey( hMedian->GetName() ) )
+    {
+        cout << "VTableCalculator::addHistogramsFromFile error: existing table without 1D histograms in ";
+        cout << fOutDir->GetPath() << " cannot be updated" << endl;
+        return false;
+    }
+    return true;
+}
+
 /*!
      main calculation routine for lookup tables
 
@@ -798,6 +977,11 @@ double VTableCalculator::calc( int ntel, double* r, double* s, double* l, double
                     med   = interpolate( hMedian, log10( s[tel] ), r[tel], false );
                     sigma = interpolate( hMedian, log10( s[tel] ), r[tel], true );
                 }
+                else if( hVCompiledMedian.size() == ( unsigned int )ntel && hVCompiledMedian[tel] )
+                {
+                    med   = interpolate( hVCompiledMedian[tel], log10( s[tel] ), r[tel], false );
+                    sigma = interpolate( hVCompiledMedian[tel], log10( s[tel] ), r[tel], true );
+                }
                 else if( hVMedian.size() == ( unsigned int )ntel && hVMedian[tel] )
                 {
                     med   = interpolate( hVMedian[tel], log10( s[tel] ), r[tel], false );
@@ -1120,6 +1304,18 @@ void VTableCalculator::setVHistograms( vector< TH2F* >& hM )
     fReadHistogramsFromFile = true;
 }
 
+/*
+ * set tables from a compiled lookup table file
+ *
+ * (take precedence over tables set with setVHistograms)
+ */
+void VTableCalculator::setVCompiledTables( vector< const VCompiledLookupTable* >& hM )
+{
+    hVCompiledMedian = hM;
+    
+    fReadHistogramsFromFile = true;
+}
+
 
 TH2F* VTableCalculator::getHistoMedian()
 {
@@ -1228,6 +1424,81 @@ double VTableCalculator::interpolate( TH2F* h, double x, double y, bool iError )
     return v;
 }
 
+/*
+ * interpolate in x and y for a table from a compiled lookup table file
+ *
+ * (identical to interpolate( TH2F*, ... ))
+ */
+double VTableCalculator::interpolate( const VCompiledLookupTable* h, double x, double y, bool iError )
+{
+    if( !h )
+    {
+        return -999.;
+    }
+    
+    int i_x = h->findBinX( x );
+    int i_y = h->findBinY( y );
+    // handle under and overflows ( bin nBinsX+1 is needed)
+    if( i_x == 0 || i_y == 0 || i_x == h->getNbinsX() || i_y == h->getNbinsY() )
+    {
+        if( iError )
+        {
+            return h->getBinError( i_x, i_y );
+        }
+        else
+        {
+            return h->getBinContent( i_x, i_y );
+        }
+    }
+    if( x < h->getBinCenterX( i_x ) )
+    {
+        i_x--;
+    }
+    if( y < h->getBinCenterY( i_y ) )
+    {
+        i_y--;
+    }
+    
+    double e1 = 0.;
+    double e2 = 0.;
+    double v = 0.;
+    
+    // first interpolate on distance axis, then on size axis
+    if( !iError )
+    {
+        e1 = VStatistics::interpolate( h->getBinContent( i_x, i_y ), h->getBinCenterY( i_y ),
+                                       h->getBinContent( i_x, i_y + 1 ), h->getBinCenterY( i_y + 1 ),
+                                       y, false, 0.5, 1.e-5 );
+        e2 = VStatistics::interpolate( h->getBinContent( i_x + 1, i_y ), h->getBinCenterY( i_y ),
+                                       h->getBinContent( i_x + 1, i_y + 1 ), h->getBinCenterY( i_y + 1 ),
+                                       y, false, 0.5, 1.e-5 );
+    }
+    else
+    {
+        e1 = VStatistics::interpolate( h->getBinError( i_x, i_y ), h->getBinCenterY( i_y ),
+                                       h->getBinError( i_x, i_y + 1 ), h->getBinCenterY( i_y + 1 ),
+                                       y, false, 0.5, 1.e-5 );
+        e2 = VStatistics::interpolate( h->getBinError( i_x + 1, i_y ), h->getBinCenterY( i_y ),
+                                       h->getBinError( i_x + 1, i_y + 1 ), h->getBinCenterY( i_y + 1 ),
+                                       y, false, 0.5, 1.e-5 );
+    }
+    v = VStatistics::interpolate( e1, h->getBinCenterX( i_x ),
+                                  e2, h->getBinCenterX( i_x + 1 ),
+                                  x, false, 0.5, 1.e-5 );
+    // final check on consistency of results
+    // (don't expect to reconstruct anything below 1 GeV)
+    if( e1 > 1.e-3 && e2 < 1.e-3 )
+    {
+        return e1;
+    }
+    if( e1 < 1.e-3 && e2 > 1.e-3 )
+    {
+        return e2;
+    }
+    
+    return v;
+}
+
 /*
 
      search most probable value of energy distribution for a give size/radius bin
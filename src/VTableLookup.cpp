@@ -23,6 +23,9 @@ VTableLookup::VTableLookup( VTableLookupRunParameter* iTLRunParameter )
     fNTel = 0;
     // look up table file
     fLookupTableFile = 0;
+    fLookupTableFileShared = false;
+    fLookupTableFileMutex = 0;
+    fCompiledLookupTableFile = 0;
     
     fNumberOfIgnoredEvents = 0;
     fNNoiseLevelWarnings = 0;
@@ -77,6 +80,39 @@ VTableLookup::VTableLookup( VTableLookupRunParameter* iTLRunParameter )
     
 }
 
+/*
+ * table files are closed in terminate() (table writing) or
+ * kept open (table reading)
+ *
+ */
+VTableLookup::~VTableLookup()
+{
+    delete fData;
+    delete fTableCalculator;
+    map< unsigned int, VTableCalculatorData* >::iterator iTableData;
+    for( iTableData = fTableData.begin(); iTableData != fTableData.end(); ++iTableData )
+    {
+        delete iTableData->second;
+    }
+    delete fCompiledLookupTableFile;
+    
+    delete s_NupZupWup;
+    delete s_NupZupWlow;
+    delete s_NupZup;
+    delete s_NupZlowWup;
+    delete s_NupZlowWlow;
+    delete s_NupZlow;
+    delete s_Nup;
+    delete s_NlowZupWup;
+    delete s_NlowZupWlow;
+    delete s_NlowZup;
+    delete s_NlowZlowWup;
+    delete s_NlowZlowWlow;
+    delete s_NlowZlow;
+    delete s_Nlow;
+    delete s_N;
+}
+
 
 /*!
       \param ifile output file name
@@ -91,6 +127,20 @@ void VTableLookup::setOutputFile( string ifile, string ioption, string ioutputfi
     fData->setOutputFile( ifile, ioption, ioutputfile );
 }
 
+/*
+ * set an open table file for table writing
+ *
+ * (file is shared by several lookup table objects filling
+ *  different slices; directories are created and tables are
+ *  written while holding the file mutex)
+ */
+void VTableLookup::setLookupTableFile( TFile* iFile, mutex* iFileMutex )
+{
+    fLookupTableFile = iFile;
+    fLookupTableFileShared = ( iFile != 0 );
+    fLookupTableFileMutex = iFileMutex;
+}
+
 /*
  * initialize lookup data table vectors
  *
@@ -172,9 +222,26 @@ void VTableLookup::setMCTableFiles_forTableWriting( string itablefile, double iz
         cout << "VTableLookup::setMCTableFiles warning: setting mc table files makes no sense" << endl;
     }
     
+    // directories are created in a table file shared with other threads
+    unique_lock< mutex > iFileLock;
+    if( fLookupTableFileMutex )
+    {
+        iFileLock = unique_lock< mutex >( *fLookupTableFileMutex );
+    }
+    
     /////////////////////////////////////////////////////////////////////////////////////////
-    // create the table file
-    fLookupTableFile = new TFile( itablefile.c_str(), "NEW", iFileTitle.c_str() );
+    // create the table file (or update an existing file)
+    if( !fLookupTableFileShared )
+    {
+        if( fTLRunParameter->writeoption == "update" )
+        {
+            fLookupTableFile = new TFile( itablefile.c_str(), "UPDATE", iFileTitle.c_str() );
+        }
+        else
+        {
+            fLookupTableFile = new TFile( itablefile.c_str(), "NEW", iFileTitle.c_str() );
+        }
+    }
     if( fLookupTableFile->IsZombie() )
     {
         cout << "VTableLookup::setMCTableFiles error while opening table file: " << itablefile << endl;
@@ -257,7 +324,15 @@ void VTableLookup::setMCTableFiles_forTableWriting( string itablefile, double iz
             // NOISE LEVEL
             if( noise.find( t ) != noise.end() )
             {
-                int i_noise = ( int )( noise[t] * 100 );
+                int i_noise = 0;
+                if( fTableNoiseLevelDirectory.find( t ) != fTableNoiseLevelDirectory.end() )
+                {
+                    i_noise = fTableNoiseLevelDirectory[t];
+                }
+                else
+                {
+                    i_noise = getSimilarNoiseLevel( gDirectory, ( int )( noise[t] * 100 ) );
+                }
                 sprintf( hname, "NOISE_%05d", i_noise );
                 if( gDirectory->Get( hname ) )
                 {
@@ -337,7 +412,11 @@ void VTableLookup::setMCTableFiles_forTableWriting( string itablefile, double iz
                         TDirectory* i_curAzDir = gDirectory;
                         
                         i_curAzDir->cd();
-                        TDirectory* i_Dir = gDirectory->mkdir( iTableData->fDirectoryName.c_str() );
+                        TDirectory* i_Dir = i_curAzDir->GetDirectory( iTableData->fDirectoryName.c_str() );
+                        if( !i_Dir )
+                        {
+                            i_Dir = i_curAzDir->mkdir( iTableData->fDirectoryName.c_str() );
+                        }
                         i_LT.push_back( new VTableCalculator( iTableData->fFillVariable.c_str(),
                                                               isuff.c_str(),
                                                               fTLRunParameter->fWriteTables,
@@ -385,35 +464,57 @@ void VTableLookup::setMCTableFiles_forTableReading( string itablefile, string is
         cout << "void VTableLookup::setMCTableFiles_forTableReading( string itablefile, string isuff )" << endl;
     }
     
+    // compiled lookup table file (memory mapped; see compileLookupTables)
+    string iCompiledTableFile = itablefile;
+    const char* aux_dir = gSystem->Getenv( "OBS_EVNDISP_AUX_DIR" );
+    if( !VCompiledLookupTableFile::isCompiledLookupTableFile( iCompiledTableFile ) && aux_dir )
+    {
+        iCompiledTableFile = string( aux_dir ) + "/Tables/" + itablefile;
+    }
+    if( VCompiledLookupTableFile::isCompiledLookupTableFile( iCompiledTableFile ) )
+    {
+        fCompiledLookupTableFile = new VCompiledLookupTableFile();
+        fCompiledLookupTableFile->setDebug( fTLRunParameter->fDebug );
+        if( !fCompiledLookupTableFile->open( iCompiledTableFile ) )
+        {
+            cout << "VTableLookup::setMCTableFiles_forTableReading error (reading): unable to open compiled table file: " << iCompiledTableFile << endl;
+            exit( EXIT_FAILURE );
+        }
+        itablefile = iCompiledTableFile;
+        cout << "reading compiled table file: " << itablefile << endl;
+    }
     // open table file
-    gErrorIgnoreLevel = 20001;
-    fLookupTableFile = new TFile( itablefile.c_str() );
-    if( fLookupTableFile->IsZombie() )
+    else
     {
-        fLookupTableFile->Close();
-        const char* data_dir = gSystem->Getenv( "OBS_EVNDISP_AUX_DIR" );
-        if( data_dir )
-        {
-            // try to see of file exists in directory ./tables
-            string itemp = data_dir;
-            itemp += "/Tables/" + itablefile;
-            itablefile = itemp;
-            fLookupTableFile = new TFile( itablefile.c_str() );
-            if( fLookupTableFile->IsZombie() )
+        gErrorIgnoreLevel = 20001;
+        fLookupTableFile = new TFile( itablefile.c_str() );
+        if( fLookupTableFile->IsZombie() )
+        {
+            fLookupTableFile->Close();
+            const char* data_dir = gSystem->Getenv( "OBS_EVNDISP_AUX_DIR" );
+            if( data_dir )
+            {
+                // try to see of file exists in directory ./tables
+                string itemp = data_dir;
+                itemp += "/Tables/" + itablefile;
+                itablefile = itemp;
+                fLookupTableFile = new TFile( itablefile.c_str() );
+                if( fLookupTableFile->IsZombie() )
+                {
+                    cout << "VTableLookup::setMCTableFiles_forTableReading error (reading): unable to open table file: " << itablefile << endl;
+                    exit( EXIT_FAILURE );
+                }
+            }
+            else
             {
                 cout << "VTableLookup::setMCTableFiles_forTableReading error (reading): unable to open table file: " << itablefile << endl;
+                cout << " (no $OBS_EVNDISP_AUX_DIR defined)" << endl;
                 exit( EXIT_FAILURE );
             }
         }
-        else
-        {
-            cout << "VTableLookup::setMCTableFiles_forTableReading error (reading): unable to open table file: " << itablefile << endl;
-            cout << " (no $OBS_EVNDISP_AUX_DIR defined)" << endl;
-            exit( EXIT_FAILURE );
-        }
+        gErrorIgnoreLevel = 0;
+        cout << "reading table file ( may take a while ): " << itablefile << endl;
     }
-    gErrorIgnoreLevel = 0;
-    cout << "reading table file ( may take a while ): " << itablefile << endl;
     
     ////////////////////////////////////////
     // create lookup table data vector
@@ -467,7 +568,7 @@ void VTableLookup::setMCTableFiles_forTableReading( string itablefile, string is
         ////
         // TELESCOPE TYPE
         // (for VTS, each telescope is of a different type)
-        vector< string > iDNameTel = getSortedListOfDirectories( fLookupTableFile );
+        vector< string > iDNameTel = getSortedListOfDirectories( "" );
         for( unsigned int t = 0; t < iDNameTel.size(); t++ )
         {
             // skip debug directories
@@ -475,12 +576,12 @@ void VTableLookup::setMCTableFiles_forTableReading( string itablefile, string is
             {
                 continue;
             }
-            fLookupTableFile->cd( iDNameTel[t].c_str() );
+            string iPathTel = iDNameTel[t];
             fTableTelTypes.push_back( ( ULong64_t )( atoi )( iDNameTel[t].substr( 4, iDNameTel[t].size() ).c_str() ) );
             
             if( fTLRunParameter->fDebug == 2 )
             {
-                cout << "DEBUG  DIR TELTYPE " << " " << gDirectory->GetPath() << endl;
+                cout << "DEBUG  DIR TELTYPE " << " " << iPathTel << endl;
             }
             
             iiii_LT.clear();
@@ -491,16 +592,15 @@ void VTableLookup::setMCTableFiles_forTableReading( string itablefile, string is
             
             ////
             // NOISE LEVEL
-            TDirectory* iDirNSB = gDirectory;
-            vector< string > iDNameNSB = getSortedListOfDirectories( iDirNSB );
+            vector< string > iDNameNSB = getSortedListOfDirectories( iPathTel );
             for( unsigned int n = 0; n < iDNameNSB.size(); n++ )
             {
                 i_NoiseLevel.push_back( atof( iDNameNSB[n].substr( 6, 5 ).c_str() ) / 100. );
                 
-                iDirNSB->cd( iDNameNSB[n].c_str() );
+                string iPathNSB = iPathTel + "/" + iDNameNSB[n];
                 if( fTLRunParameter->fDebug == 2 )
                 {
-                    cout << "  DEBUG  DIR NSB " << " " << gDirectory->GetPath() << endl;
+                    cout << "  DEBUG  DIR NSB " << " " << iPathNSB << endl;
                 }
                 
                 iii_LT.clear();
@@ -510,17 +610,16 @@ void VTableLookup::setMCTableFiles_forTableReading( string itablefile, string is
                 
                 ////
                 // ZENITH ANGLE
-                TDirectory* iDirZe = gDirectory;
-                vector< string > iDNameZE = getSortedListOfDirectories( iDirZe );
+                vector< string > iDNameZE = getSortedListOfDirectories( iPathNSB );
                 for( unsigned z = 0; z < iDNameZE.size(); z++ )
                 {
                     i_ze.push_back( atof( iDNameZE[z].substr( 3, 3 ).c_str() ) / 10. );
                     
-                    iDirZe->cd( iDNameZE[z].c_str() );
+                    string iPathZe = iPathNSB + "/" + iDNameZE[z];
                     
                     if( fTLRunParameter->fDebug == 2 )
                     {
-                        cout << "    DEBUG  DIR ZE " << " " << gDirectory->GetPath() << endl;
+                        cout << "    DEBUG  DIR ZE " << " " << iPathZe << endl;
                     }
                     
                     ii_LT.clear();
@@ -529,43 +628,54 @@ void VTableLookup::setMCTableFiles_forTableReading( string itablefile, string is
                     
                     ////
                     // DIRECTION OFFSET
-                    TDirectory* iDirWoff = gDirectory;
-                    vector< string > iDNameWoff  = getSortedListOfDirectories( iDirWoff );
+                    vector< string > iDNameWoff  = getSortedListOfDirectories( iPathZe );
                     for( unsigned int w = 0; w < iDNameWoff.size(); w++ )
                     {
                         i_DirectionOffset.push_back( atof( iDNameWoff[w].substr( 5, 4 ).c_str() ) / 1000. );
                         
-                        iDirWoff->cd( iDNameWoff[w].c_str() );
+                        string iPathWoff = iPathZe + "/" + iDNameWoff[w];
                         
                         if( fTLRunParameter->fDebug == 2 )
                         {
-                            cout << "      DEBUG  DIR WOFF " << " " << gDirectory->GetPath() << endl;
+                            cout << "      DEBUG  DIR WOFF " << " " << iPathWoff << endl;
                         }
                         
                         i_LT.clear();
                         
                         // AZIMUTH ANGLE
-                        TDirectory* iDirAz = gDirectory;
-                        vector< string > iDNameAz  = getSortedListOfDirectories( iDirAz );
+                        vector< string > iDNameAz  = getSortedListOfDirectories( iPathWoff );
                         
                         for( unsigned int a = 0; a < iDNameAz.size(); a++ )
                         {
-                            iDirAz->cd( iDNameAz[a].c_str() );
+                            string iPathAz = iPathWoff + "/" + iDNameAz[a];
                             
                             if( fTLRunParameter->fDebug == 2 )
                             {
-                                cout << "        DEBUG  DIR AZ " << " " << gDirectory->GetPath() << endl;
+                                cout << "        DEBUG  DIR AZ " << " " << iPathAz << endl;
                             }
                             
-                            // get lookup table directory
-                            TDirectory* iDir = ( TDirectory* )gDirectory->Get( iTableData->fDirectoryName.c_str() );
+                            // lookup table directory
+                            string iPathTable = iPathAz + "/" + iTableData->fDirectoryName;
                             // new lookup table calculator
-                            i_LT.push_back( new VTableCalculator( iTableData->fFillVariable.c_str(),
-                                                                  isuff.c_str(),
-                                                                  fTLRunParameter->fWriteTables,
-                                                                  iDir, iTableData->fEnergy,
-                                                                  fTLRunParameter->fPE,
-                                                                  fTLRunParameter->fUseMedianEnergy ) );
+                            if( fCompiledLookupTableFile )
+                            {
+                                i_LT.push_back( new VTableCalculator( iTableData->fFillVariable.c_str(),
+                                                                      isuff.c_str(),
+                                                                      fCompiledLookupTableFile, iPathTable,
+                                                                      iTableData->fEnergy,
+                                                                      fTLRunParameter->fPE,
+                                                                      fTLRunParameter->fUseMedianEnergy ) );
+                            }
+                            else
+                            {
+                                TDirectory* iDir = fLookupTableFile->GetDirectory( iPathTable.c_str() );
+                                i_LT.push_back( new VTableCalculator( iTableData->fFillVariable.c_str(),
+                                                                      isuff.c_str(),
+                                                                      fTLRunParameter->fWriteTables,
+                                                                      iDir, iTableData->fEnergy,
+                                                                      fTLRunParameter->fPE,
+                                                                      fTLRunParameter->fUseMedianEnergy ) );
+                            }
                             if( iTableData->fEnergy )
                             {
                                 i_LT.back()->setEventSelectionCut( fTLRunParameter->fEventSelectionCut_lossCutMax,
@@ -573,7 +683,7 @@ void VTableLookup::setMCTableFiles_forTableReading( string itablefile, string is
                             }
                             i_LT.back()->setNormalizeTableValues( iTableData->fValueNormalizationRange_min,
                                                                   iTableData->fValueNormalizationRange_max );
-                            cout << gDirectory->GetPath() << endl;
+                            cout << iPathAz << endl;
                         }                             // az
                         ii_LT.push_back( i_LT );
                     }                                 // woff
@@ -864,20 +974,7 @@ void VTableLookup::fillLookupTable()
 */
 void VTableLookup::readLookupTable()
 {
-    int i_az = 0;
-    double ze = 0.;
-    double woff = 0.;
     int fevent = 0;
-    double imr = 0.;
-    double inr = 0.;
-    
-    // lookup table index for interpolation
-    unsigned int inoise_up = 0;
-    unsigned int inoise_low = 0;
-    unsigned int ize_up = 0;
-    unsigned int ize_low = 0;
-    unsigned int iwoff_up = 0;
-    unsigned int iwoff_low = 0;
     
     // (this is a bit of a mess)
     s_NupZupWup    = new VTablesToRead( fTableData.size(), fNTel );
@@ -943,475 +1040,508 @@ void VTableLookup::readLookupTable()
             fTLRunParameter->fWobbleOffset = ( int )( fData->getMCWobbleOffset() * 100. );
             bFirst = false;
         }
-        // reset image counter
-        int fnmscw = 0;
         // fill MC energy spectra
         fData->fillMChistograms();
-        // if data fails basic cuts, write default values directly to tree
-        if( !fData->cut() )
+        // loop over all subarrays
+        // (one subarray for the standard analysis)
+        for( unsigned int s = 0; s < fData->getNSubArrays(); s++ )
         {
-            if( fTLRunParameter->bNoNoTrigger )
+            if( fData->selectSubArray( s ) )
             {
-                fData->reset();
-                fData->fill();
+                readLookupTableForEvent();
             }
-            // goto next event
         }
-        else
+        fevent++;
+    }
+}
+
+/*
+
+   calculate mscw, mscl and energy for the current event
+   and fill results into the output tree
+
+*/
+void VTableLookup::readLookupTableForEvent()
+{
+    int i_az = 0;
+    double ze = 0.;
+    double woff = 0.;
+    double imr = 0.;
+    double inr = 0.;
+    
+    // lookup table index for interpolation
+    unsigned int inoise_up = 0;
+    unsigned int inoise_low = 0;
+    unsigned int ize_up = 0;
+    unsigned int ize_low = 0;
+    unsigned int iwoff_up = 0;
+    unsigned int iwoff_low = 0;
+    
+    // reset image counter
+    int fnmscw = 0;
+    // if data fails basic cuts, write default values directly to tree
+    if( !fData->cut() )
+    {
+        if( fTLRunParameter->bNoNoTrigger )
         {
-            //////////////////////////////////////
-            // here we should have good data only
-            // (ze, az, and wobble offset have been
-            //  tested)
-            //////////////////////////////////////
-            
-            // get direction angles for this event
-            ze   = fData->getZe();
-            woff = fData->getWobbleOffset();
-            i_az = getAzBin( fData->getAz() );
-            // get noise level for this event
-            readNoiseLevel( false );
-            
-            if( fTLRunParameter->fDebug == 2 )
+            fData->reset();
+            fData->fill();
+        }
+        // goto next event
+    }
+    else
+    {
+        //////////////////////////////////////
+        // here we should have good data only
+        // (ze, az, and wobble offset have been
+        //  tested)
+        //////////////////////////////////////
+        
+        // get direction angles for this event
+        ze   = fData->getZe();
+        woff = fData->getWobbleOffset();
+        i_az = getAzBin( fData->getAz() );
+        // get noise level for this event
+        readNoiseLevel( false );
+        
+        if( fTLRunParameter->fDebug == 2 )
+        {
+            cout << endl << endl << "DEBUG  NEW EVENT " << fData->getEventCounter() << endl;
+        }
+        /////////////////////////////
+        // interpolation section
+        // interpolate for given size, R between NSB, ze, distance to camera center
+        // no interpolation for AZ bins
+        
+        
+        /////////////////////////////
+        // NOISE (low) ZENITH (low)
+        if( fTLRunParameter->fDebug == 2 )
+        {
+            cout << "DEBUG  NOISE LOW ZENITH LOW" << endl;
+        }
+        for( int t = 0; t < fNTel; t++ )
+        {
+            if( fTLRunParameter
+                    && t < ( int )fTLRunParameter->fTelToAnalyzeData.size()
+                    && !fTLRunParameter->fTelToAnalyzeData[t]->fTelToAnalyze )
             {
-                cout << endl << endl << "DEBUG  NEW EVENT " << fData->getEventCounter() << endl;
+                continue;
             }
-            /////////////////////////////
-            // interpolation section
-            // interpolate for given size, R between NSB, ze, distance to camera center
-            // no interpolation for AZ bins
+            // index for this telescope type
+            unsigned int telX = getTelTypeCounter( t, true );
             
-            
-            /////////////////////////////
-            // NOISE (low) ZENITH (low)
             if( fTLRunParameter->fDebug == 2 )
             {
-                cout << "DEBUG  NOISE LOW ZENITH LOW" << endl;
+                cout << "DEBUG  TELESCOPE " << t << " (T" << t + 1 << "), teltype counter " << telX << endl;
+                cout << "DEBUG      zenith " << ze << ", noise " << fNoiseLevel[t];
+                cout << ", woff " << woff << ", az " << fData->getAz() << ", az bin " << i_az << endl;
             }
-            for( int t = 0; t < fNTel; t++ )
-            {
-                if( fTLRunParameter
-                        && t < ( int )fTLRunParameter->fTelToAnalyzeData.size()
-                        && !fTLRunParameter->fTelToAnalyzeData[t]->fTelToAnalyze )
-                {
-                    continue;
-                }
-                // index for this telescope type
-                unsigned int telX = getTelTypeCounter( t, true );
-                
-                if( fTLRunParameter->fDebug == 2 )
-                {
-                    cout << "DEBUG  TELESCOPE " << t << " (T" << t + 1 << "), teltype counter " << telX << endl;
-                    cout << "DEBUG      zenith " << ze << ", noise " << fNoiseLevel[t];
-                    cout << ", woff " << woff << ", az " << fData->getAz() << ", az bin " << i_az << endl;
-                }
-                // noise (low)
-                getIndexBoundary( &inoise_up, &inoise_low, fTableNoiseLevel[telX], fNoiseLevel[t] );
-                if( fTLRunParameter->fDebug == 2 )
-                {
-                    cout << "DEBUG  NOISE " << t << " " << inoise_low << " " << inoise_up << " ";
-                    cout << fNoiseLevel[t] << "\t" << fTableNoiseLevel[telX].size();
-                    cout << ", NSB level: ";
-                    for( unsigned int ii = 0; ii < fTableNoiseLevel[telX].size(); ii++ )
-                    {
-                        cout << fTableNoiseLevel[telX][ii] << ", ";
-                    }
-                    cout << endl;
-                }
-                // get zenith angle
-                getIndexBoundary( &ize_up, &ize_low, fTableZe[telX][inoise_low], ze );
-                if( fTLRunParameter->fDebug == 2 )
-                {
-                    cout << "DEBUG  ZENITH " << t << " " << ize_up << " " << ize_low << " ";
-                    cout << ze << "\t" << fTableZe[telX][inoise_low].size();
-                    cout << ", ze bins: ";
-                    for( unsigned int ii = 0; ii < fTableZe[telX][inoise_low].size(); ii++ )
-                    {
-                        cout << fTableZe[telX][inoise_low][ii] << ", ";
-                    }
-                    cout << endl;
-                }
-                
-                // get direction offset index
-                getIndexBoundary( &iwoff_up, &iwoff_low, fTableDirectionOffset[telX][inoise_low][ize_low], woff );
-                if( fTLRunParameter->fDebug == 2 )
-                {
-                    cout << "DEBUG  WOFF " << t << " " << iwoff_up << " " << iwoff_low << " " << woff << "\t";
-                    cout << fTableDirectionOffset[telX][inoise_low][ize_low].size();
-                    cout << ", woff bins: ";
-                    for( unsigned int ii = 0; ii < fTableDirectionOffset[telX][inoise_low][ize_low].size(); ii++ )
-                    {
-                        cout << fTableDirectionOffset[telX][inoise_low][ize_low][ii] << ", ";
-                    }
-                    cout << endl;
-                }
-                
-                // get tables
-                getTables( inoise_low, ize_low, iwoff_up, i_az, t, s_NlowZlowWup );
-                getTables( inoise_low, ize_low, iwoff_low, i_az, t, s_NlowZlowWlow );
-                
-            } // loop over all telescopes
-            calculateMSFromTables( s_NlowZlowWup );
-            calculateMSFromTables( s_NlowZlowWlow );
-            // interpolate between direction offset bins
-            // note: expect that there are the same number of lookup tables for each
-            //       telescope type and noise level
-            interpolate( s_NlowZlowWlow, fTableDirectionOffset[0][0][ize_low][iwoff_low],
-                         s_NlowZlowWup,  fTableDirectionOffset[0][0][ize_low][iwoff_up],
-                         s_NlowZlow, woff );
-                         
+            // noise (low)
+            getIndexBoundary( &inoise_up, &inoise_low, fTableNoiseLevel[telX], fNoiseLevel[t] );
             if( fTLRunParameter->fDebug == 2 )
             {
-                cout << "DEBUG  WOFF INTER 1 ";
-                cout << woff << " " << fTableDirectionOffset[0][0][ize_low][iwoff_low] << " ";
-                cout << fTableDirectionOffset[0][0][ize_low][iwoff_up];
-                cout << " " << ize_low << " ";
-                cout << s_NlowZlowWlow->value[E_MSCL] << " ";
-                cout << s_NlowZlowWup->value[E_MSCL] << " ";
-                cout << s_NlowZlow->value[E_MSCL] << endl;
-            }
-            
-            ///////////////////////////
-            // NOISE (low) ZENITH (up)
-            for( int t = 0; t < fNTel; t++ )
-            {
-                if( fTLRunParameter
-                        && t < ( int )fTLRunParameter->fTelToAnalyzeData.size()
-                        && !fTLRunParameter->fTelToAnalyzeData[t]->fTelToAnalyze )
+                cout << "DEBUG  NOISE " << t << " " << inoise_low << " " << inoise_up << " ";
+                cout << fNoiseLevel[t] << "\t" << fTableNoiseLevel[telX].size();
+                cout << ", NSB level: ";
+                for( unsigned int ii = 0; ii < fTableNoiseLevel[telX].size(); ii++ )
                 {
-                    continue;
+                    cout << fTableNoiseLevel[telX][ii] << ", ";
                 }
-                // index for this telescope type
-                unsigned int telX = getTelTypeCounter( t, true );
-                
-                // noise (low)
-                getIndexBoundary( &inoise_up, &inoise_low, fTableNoiseLevel[telX], fNoiseLevel[t] );
-                // get zenith angle
-                getIndexBoundary( &ize_up, &ize_low, fTableZe[telX][inoise_low], ze );
-                
-                // zenith angle (up)
-                // get direction offset index
-                getIndexBoundary( &iwoff_up, &iwoff_low, fTableDirectionOffset[telX][inoise_low][ize_up], woff );
-                getTables( inoise_low, ize_up, iwoff_up, i_az, t, s_NlowZupWup );
-                getTables( inoise_low, ize_up, iwoff_low, i_az, t, s_NlowZupWlow );
+                cout << endl;
             }
-            calculateMSFromTables( s_NlowZupWup );
-            calculateMSFromTables( s_NlowZupWlow );
-            
-            // interpolate between direction offset bins
-            // note: expect that there are the same number of lookup tables for each
-            //       telescope type and noise level
-            interpolate( s_NlowZupWlow, fTableDirectionOffset[0][0][ize_up][iwoff_low],
-                         s_NlowZupWup,  fTableDirectionOffset[0][0][ize_up][iwoff_up],
-                         s_NlowZup, woff );
-                         
+            // get zenith angle
+            getIndexBoundary( &ize_up, &ize_low, fTableZe[telX][inoise_low], ze );
             if( fTLRunParameter->fDebug == 2 )
             {
-                cout << "DEBUG  WOFF INTER 2 ";
-                cout << woff << " " << fTableDirectionOffset[0][0][ize_up][iwoff_low] << " ";
-                cout << fTableDirectionOffset[0][0][ize_up][iwoff_up] << " " << ize_up;
-                cout << " " << s_NlowZupWlow->value[E_MSCL] << " ";
-                cout << s_NlowZupWup->value[E_MSCL] << " ";
-                cout << s_NlowZup->value[E_MSCL] << endl;
-            }
-            
-            // interpolate between zenith angle bins
-            // note: expect that there are the same number of lookup tables for each
-            //       telescope type and noise level
-            interpolate( s_NlowZlow, fTableZe[0][0][ize_low],
-                         s_NlowZup, fTableZe[0][0][ize_up],
-                         s_Nlow, ze, true );
-                         
-            if( fTLRunParameter->fDebug == 2 )
-            {
-                cout << "DEBUG  ZE INTER 1 " << ze << " " << fTableZe[0][0][ize_low] << " ";
-                cout << fTableZe[0][0][ize_up] << " ";
-                cout << s_NlowZlow->value[E_MSCL] << " ";
-                cout << s_NlowZup->value[E_MSCL] << " ";
-                cout << s_Nlow->value[E_MSCL] << endl;
-            }
-            
-            ///////////////////////////
-            // NOISE (up) ZENITH (low)
-            if( fTLRunParameter->fDebug == 2 )
-            {
-                cout << "DEBUG  HIGH NOISE" << endl;
-            }
-            for( int t = 0; t < fNTel; t++ )
-            {
-                if( fTLRunParameter
-                        && t < ( int )fTLRunParameter->fTelToAnalyzeData.size()
-                        && !fTLRunParameter->fTelToAnalyzeData[t]->fTelToAnalyze )
+                cout << "DEBUG  ZENITH " << t << " " << ize_up << " " << ize_low << " ";
+                cout << ze << "\t" << fTableZe[telX][inoise_low].size();
+                cout << ", ze bins: ";
+                for( unsigned int ii = 0; ii < fTableZe[telX][inoise_low].size(); ii++ )
                 {
-                    continue;
+                    cout << fTableZe[telX][inoise_low][ii] << ", ";
                 }
-                // index for this telescope type
-                unsigned int telX = getTelTypeCounter( t, true );
-                
-                // noise (up)
-                getIndexBoundary( &inoise_up, &inoise_low, fTableNoiseLevel[telX], fNoiseLevel[t] );
-                // get zenith angle
-                getIndexBoundary( &ize_up, &ize_low, fTableZe[telX][inoise_up], ze );
-                if( fTLRunParameter->fDebug == 2 )
-                {
-                    cout << "DEBUG  WOFF " << t << " " << inoise_low << " " << inoise_up << " " << fNoiseLevel[t] << endl;
-                }
-                
-                // zenith angle (low)
-                // get direction offset index
-                getIndexBoundary( &iwoff_up, &iwoff_low, fTableDirectionOffset[telX][inoise_up][ize_low], woff );
-                getTables( inoise_up, ize_low, iwoff_up, i_az, t, s_NupZlowWup );
-                getTables( inoise_up, ize_low, iwoff_low, i_az, t, s_NupZlowWlow );
-            }
-            calculateMSFromTables( s_NupZlowWup );
-            calculateMSFromTables( s_NupZlowWlow );
-            // interpolate between direction offset bins
-            // note: expect that there are the same number of lookup tables for each
-            //       telescope type and noise level
-            interpolate( s_NupZlowWlow, fTableDirectionOffset[0][0][ize_low][iwoff_low],
-                         s_NupZlowWup,  fTableDirectionOffset[0][0][ize_low][iwoff_up],
-                         s_NupZlow, woff );
-                         
-            if( fTLRunParameter->fDebug == 2 )
-            {
-                cout << "DEBUG  WOFF INTER 1 ";
-                cout << woff << " " << fTableDirectionOffset[0][0][ize_low][iwoff_low] << " ";
-                cout << fTableDirectionOffset[0][0][ize_low][iwoff_up];
-                cout << " " << s_NupZlowWlow->value[E_MSCL] << " ";
-                cout << s_NupZlowWup->value[E_MSCL] << " ";
-                cout << s_NupZlow->value[E_MSCL] << endl;
+                cout << endl;
             }
             
-            ///////////////////////////
-            // NOISE (up) ZENITH (up)
-            for( int t = 0; t < fNTel; t++ )
+            // get direction offset index
+            getIndexBoundary( &iwoff_up, &iwoff_low, fTableDirectionOffset[telX][inoise_low][ize_low], woff );
+            if( fTLRunParameter->fDebug == 2 )
             {
-                if( fTLRunParameter
-                        && t < ( int )fTLRunParameter->fTelToAnalyzeData.size()
-                        && !fTLRunParameter->fTelToAnalyzeData[t]->fTelToAnalyze )
+                cout << "DEBUG  WOFF " << t << " " << iwoff_up << " " << iwoff_low << " " << woff << "\t";
+                cout << fTableDirectionOffset[telX][inoise_low][ize_low].size();
+                cout << ", woff bins: ";
+                for( unsigned int ii = 0; ii < fTableDirectionOffset[telX][inoise_low][ize_low].size(); ii++ )
                 {
-                    continue;
+                    cout << fTableDirectionOffset[telX][inoise_low][ize_low][ii] << ", ";
                 }
-                // index for this telescope type
-                unsigned int telX = getTelTypeCounter( t, true );
-                
-                // noise (up)
-                getIndexBoundary( &inoise_up, &inoise_low, fTableNoiseLevel[telX], fNoiseLevel[t] );
-                // get zenith angle
-                getIndexBoundary( &ize_up, &ize_low, fTableZe[telX][inoise_up], ze );
-                
-                // zenith angle (up)
-                // get direction offset index
-                getIndexBoundary( &iwoff_up, &iwoff_low, fTableDirectionOffset[telX][inoise_up][ize_up], woff );
-                getTables( inoise_up, ize_up, iwoff_up, i_az, t, s_NupZupWup );
-                getTables( inoise_up, ize_up, iwoff_low, i_az, t, s_NupZupWlow );
+                cout << endl;
             }
-            calculateMSFromTables( s_NupZupWup );
-            calculateMSFromTables( s_NupZupWlow );
             
-            // interpolate between direction offset bins
-            // note: expect that there are the same number of lookup tables for each
-            //       telescope type and noise level
-            interpolate( s_NupZupWlow, fTableDirectionOffset[0][0][ize_up][iwoff_low],
-                         s_NupZupWup,  fTableDirectionOffset[0][0][ize_up][iwoff_up],
-                         s_NupZup, woff );
-                         
-            if( fTLRunParameter->fDebug == 2 )
-            {
-                cout << "DEBUG  WOFF INTER 2 ";
-                cout << woff << " " << fTableDirectionOffset[0][0][ize_up][iwoff_low] << " ";
-                cout << fTableDirectionOffset[0][0][ize_up][iwoff_up];
-                cout << " " << s_NupZupWlow->value[E_MSCL] << " ";
-                cout << s_NupZupWup->value[E_MSCL] << " ";
-                cout << s_NupZup->value[E_MSCL] << endl;
-            }
+            // get tables
+            getTables( inoise_low, ize_low, iwoff_up, i_az, t, s_NlowZlowWup );
+            getTables( inoise_low, ize_low, iwoff_low, i_az, t, s_NlowZlowWlow );
             
-            // interpolate between zenith angle bins
-            // note: expect that there are the same number of lookup tables for each
-            //       telescope type and noise level
-            interpolate( s_NupZlow, fTableZe[0][0][ize_low],
-                         s_NupZup,  fTableZe[0][0][ize_up],
-                         s_Nup, ze, true );
-                         
-            if( fTLRunParameter->fDebug == 2 )
+        } // loop over all telescopes
+        calculateMSFromTables( s_NlowZlowWup );
+        calculateMSFromTables( s_NlowZlowWlow );
+        // interpolate between direction offset bins
+        // note: expect that there are the same number of lookup tables for each
+        //       telescope type and noise level
+        interpolate( s_NlowZlowWlow, fTableDirectionOffset[0][0][ize_low][iwoff_low],
+                     s_NlowZlowWup,  fTableDirectionOffset[0][0][ize_low][iwoff_up],
+                     s_NlowZlow, woff );
+        
+        if( fTLRunParameter->fDebug == 2 )
+        {
+            cout << "DEBUG  WOFF INTER 1 ";
+            cout << woff << " " << fTableDirectionOffset[0][0][ize_low][iwoff_low] << " ";
+            cout << fTableDirectionOffset[0][0][ize_low][iwoff_up];
+            cout << " " << ize_low << " ";
+            cout << s_NlowZlowWlow->value[E_MSCL] << " ";
+            cout << s_NlowZlowWup->value[E_MSCL] << " ";
+            cout << s_NlowZlow->value[E_MSCL] << endl;
+        }
+        
+        ///////////////////////////
+        // NOISE (low) ZENITH (up)
+        for( int t = 0; t < fNTel; t++ )
+        {
+            if( fTLRunParameter
+                    && t < ( int )fTLRunParameter->fTelToAnalyzeData.size()
+                    && !fTLRunParameter->fTelToAnalyzeData[t]->fTelToAnalyze )
             {
-                cout << "DEBUG  ZE INTER 2 " << ze;
-                cout << " " << s_NupZlow->value[E_MSCL] << " ";
-                cout << s_NupZup->value[E_MSCL] << " ";
-                cout << s_Nup->value[E_MSCL] << endl;
+                continue;
             }
+            // index for this telescope type
+            unsigned int telX = getTelTypeCounter( t, true );
             
-            // calculate average table NSB for this type of telescopes
-            double i_meanNoiseLevel_low = 0.;
-            double i_meanNoiseLevel_up = 0.;
-            double i_meanNoiseLevel_data = 0.;
-            double i_meanNoiseLevel_N = 0.;
-            for( int t = 0; t < fNTel; t++ )
-            {
-                if( fTelToAnalyze[t] )
-                {
-                    // index for this telescope type
-                    unsigned int telX = getTelTypeCounter( t, true );
-                    
-                    // get noise level index
-                    getIndexBoundary( &inoise_up, &inoise_low, fTableNoiseLevel[telX], fNoiseLevel[t] );
-                    
-                    i_meanNoiseLevel_low  += fTableNoiseLevel[telX][inoise_low];
-                    i_meanNoiseLevel_up   += fTableNoiseLevel[telX][inoise_up];
-                    i_meanNoiseLevel_data += fNoiseLevel[t];
-                    i_meanNoiseLevel_N++;
-                }
-            }
-            if( i_meanNoiseLevel_N > 0. )
+            // noise (low)
+            getIndexBoundary( &inoise_up, &inoise_low, fTableNoiseLevel[telX], fNoiseLevel[t] );
+            // get zenith angle
+            getIndexBoundary( &ize_up, &ize_low, fTableZe[telX][inoise_low], ze );
+            
+            // zenith angle (up)
+            // get direction offset index
+            getIndexBoundary( &iwoff_up, &iwoff_low, fTableDirectionOffset[telX][inoise_low][ize_up], woff );
+            getTables( inoise_low, ize_up, iwoff_up, i_az, t, s_NlowZupWup );
+            getTables( inoise_low, ize_up, iwoff_low, i_az, t, s_NlowZupWlow );
+        }
+        calculateMSFromTables( s_NlowZupWup );
+        calculateMSFromTables( s_NlowZupWlow );
+        
+        // interpolate between direction offset bins
+        // note: expect that there are the same number of lookup tables for each
+        //       telescope type and noise level
+        interpolate( s_NlowZupWlow, fTableDirectionOffset[0][0][ize_up][iwoff_low],
+                     s_NlowZupWup,  fTableDirectionOffset[0][0][ize_up][iwoff_up],
+                     s_NlowZup, woff );
+        
+        if( fTLRunParameter->fDebug == 2 )
+        {
+            cout << "DEBUG  WOFF INTER 2 ";
+            cout << woff << " " << fTableDirectionOffset[0][0][ize_up][iwoff_low] << " ";
+            cout << fTableDirectionOffset[0][0][ize_up][iwoff_up] << " " << ize_up;
+            cout << " " << s_NlowZupWlow->value[E_MSCL] << " ";
+            cout << s_NlowZupWup->value[E_MSCL] << " ";
+            cout << s_NlowZup->value[E_MSCL] << endl;
+        }
+        
+        // interpolate between zenith angle bins
+        // note: expect that there are the same number of lookup tables for each
+        //       telescope type and noise level
+        interpolate( s_NlowZlow, fTableZe[0][0][ize_low],
+                     s_NlowZup, fTableZe[0][0][ize_up],
+                     s_Nlow, ze, true );
+        
+        if( fTLRunParameter->fDebug == 2 )
+        {
+            cout << "DEBUG  ZE INTER 1 " << ze << " " << fTableZe[0][0][ize_low] << " ";
+            cout << fTableZe[0][0][ize_up] << " ";
+            cout << s_NlowZlow->value[E_MSCL] << " ";
+            cout << s_NlowZup->value[E_MSCL] << " ";
+            cout << s_Nlow->value[E_MSCL] << endl;
+        }
+        
+        ///////////////////////////
+        // NOISE (up) ZENITH (low)
+        if( fTLRunParameter->fDebug == 2 )
+        {
+            cout << "DEBUG  HIGH NOISE" << endl;
+        }
+        for( int t = 0; t < fNTel; t++ )
+        {
+            if( fTLRunParameter
+                    && t < ( int )fTLRunParameter->fTelToAnalyzeData.size()
+                    && !fTLRunParameter->fTelToAnalyzeData[t]->fTelToAnalyze )
             {
-                i_meanNoiseLevel_low  /= i_meanNoiseLevel_N;
-                i_meanNoiseLevel_up   /= i_meanNoiseLevel_N;
-                i_meanNoiseLevel_data /= i_meanNoiseLevel_N;
+                continue;
             }
+            // index for this telescope type
+            unsigned int telX = getTelTypeCounter( t, true );
             
-            // interpolate between NSB level bins
-            interpolate( s_Nlow, i_meanNoiseLevel_low,
-                         s_Nup,  i_meanNoiseLevel_up,
-                         s_N,    i_meanNoiseLevel_data, false );
-                         
+            // noise (up)
+            getIndexBoundary( &inoise_up, &inoise_low, fTableNoiseLevel[telX], fNoiseLevel[t] );
+            // get zenith angle
+            getIndexBoundary( &ize_up, &ize_low, fTableZe[telX][inoise_up], ze );
             if( fTLRunParameter->fDebug == 2 )
             {
-                cout << "DEBUG  NOISE INTER " << i_meanNoiseLevel_data << " ";
-                cout << i_meanNoiseLevel_low << "\t" << i_meanNoiseLevel_up;
-                cout << " " << s_Nlow->value[E_MSCL] << " ";
-                cout << s_Nup->value[E_MSCL] << " ";
-                cout << s_N->value[E_MSCL] << endl;
+                cout << "DEBUG  WOFF " << t << " " << inoise_low << " " << inoise_up << " " << fNoiseLevel[t] << endl;
             }
             
-            // (end of interpolation section)
-            /////////////////////////////////
-            
-            
-            //////////////////////////////////////////////////////
-            // determine number of telescopes with MSCW values
-            for( unsigned int j = 0; j < s_N->fNTel; j++ )
+            // zenith angle (low)
+            // get direction offset index
+            getIndexBoundary( &iwoff_up, &iwoff_low, fTableDirectionOffset[telX][inoise_up][ize_low], woff );
+            getTables( inoise_up, ize_low, iwoff_up, i_az, t, s_NupZlowWup );
+            getTables( inoise_up, ize_low, iwoff_low, i_az, t, s_NupZlowWlow );
+        }
+        calculateMSFromTables( s_NupZlowWup );
+        calculateMSFromTables( s_NupZlowWlow );
+        // interpolate between direction offset bins
+        // note: expect that there are the same number of lookup tables for each
+        //       telescope type and noise level
+        interpolate( s_NupZlowWlow, fTableDirectionOffset[0][0][ize_low][iwoff_low],
+                     s_NupZlowWup,  fTableDirectionOffset[0][0][ize_low][iwoff_up],
+                     s_NupZlow, woff );
+        
+        if( fTLRunParameter->fDebug == 2 )
+        {
+            cout << "DEBUG  WOFF INTER 1 ";
+            cout << woff << " " << fTableDirectionOffset[0][0][ize_low][iwoff_low] << " ";
+            cout << fTableDirectionOffset[0][0][ize_low][iwoff_up];
+            cout << " " << s_NupZlowWlow->value[E_MSCL] << " ";
+            cout << s_NupZlowWup->value[E_MSCL] << " ";
+            cout << s_NupZlow->value[E_MSCL] << endl;
+        }
+        
+        ///////////////////////////
+        // NOISE (up) ZENITH (up)
+        for( int t = 0; t < fNTel; t++ )
+        {
+            if( fTLRunParameter
+                    && t < ( int )fTLRunParameter->fTelToAnalyzeData.size()
+                    && !fTLRunParameter->fTelToAnalyzeData[t]->fTelToAnalyze )
             {
-                if( s_N->value_T[E_MSCW][j] > -90. )
-                {
-                    fnmscw++;
-                }
+                continue;
             }
-            fData->setNMSCW( fnmscw );
+            // index for this telescope type
+            unsigned int telX = getTelTypeCounter( t, true );
             
-            /////////////////////////
-            // set msc value (mean reduced scaled variables)
-            fData->setMSCW( s_N->value[E_MSCW] );
-            fData->setMSCL( s_N->value[E_MSCL] );
+            // noise (up)
+            getIndexBoundary( &inoise_up, &inoise_low, fTableNoiseLevel[telX], fNoiseLevel[t] );
+            // get zenith angle
+            getIndexBoundary( &ize_up, &ize_low, fTableZe[telX][inoise_up], ze );
             
-            // calculate mean width ratio (mean scaled variables)
-            imr = 0.;
-            inr = 0.;
-            // require size2 > 0 (to use only selected images for the MWR/MWL calculation)
-            double* i_s2 = fData->getSize2( 1., fTLRunParameter->fUseSelectedImagesOnly );
-            for( unsigned int j = 0; j < s_N->fNTel; j++ )
-            {
-                if( s_N->value_T[E_MSCW][j] > 0. && fData->getWidth() && i_s2 && i_s2[j] > 0. )
-                {
-                    imr += fData->getWidth()[j] / s_N->value_T[E_MSCW][j];
-                    inr++;
-                }
-            }
-            if( inr > 0. )
-            {
-                fData->setMWR( imr / inr );
-            }
-            else
+            // zenith angle (up)
+            // get direction offset index
+            getIndexBoundary( &iwoff_up, &iwoff_low, fTableDirectionOffset[telX][inoise_up][ize_up], woff );
+            getTables( inoise_up, ize_up, iwoff_up, i_az, t, s_NupZupWup );
+            getTables( inoise_up, ize_up, iwoff_low, i_az, t, s_NupZupWlow );
+        }
+        calculateMSFromTables( s_NupZupWup );
+        calculateMSFromTables( s_NupZupWlow );
+        
+        // interpolate between direction offset bins
+        // note: expect that there are the same number of lookup tables for each
+        //       telescope type and noise level
+        interpolate( s_NupZupWlow, fTableDirectionOffset[0][0][ize_up][iwoff_low],
+                     s_NupZupWup,  fTableDirectionOffset[0][0][ize_up][iwoff_up],
+                     s_NupZup, woff );
+        
+        if( fTLRunParameter->fDebug == 2 )
+        {
+            cout << "DEBUG  WOFF INTER 2 ";
+            cout << woff << " " << fTableDirectionOffset[0][0][ize_up][iwoff_low] << " ";
+            cout << fTableDirectionOffset[0][0][ize_up][iwoff_up];
+            cout << " " << s_NupZupWlow->value[E_MSCL] << " ";
+            cout << s_NupZupWup->value[E_MSCL] << " ";
+            cout << s_NupZup->value[E_MSCL] << endl;
+        }
+        
+        // interpolate between zenith angle bins
+        // note: expect that there are the same number of lookup tables for each
+        //       telescope type and noise level
+        interpolate( s_NupZlow, fTableZe[0][0][ize_low],
+                     s_NupZup,  fTableZe[0][0][ize_up],
+                     s_Nup, ze, true );
+        
+        if( fTLRunParameter->fDebug == 2 )
+        {
+            cout << "DEBUG  ZE INTER 2 " << ze;
+            cout << " " << s_NupZlow->value[E_MSCL] << " ";
+            cout << s_NupZup->value[E_MSCL] << " ";
+            cout << s_Nup->value[E_MSCL] << endl;
+        }
+        
+        // calculate average table NSB for this type of telescopes
+        double i_meanNoiseLevel_low = 0.;
+        double i_meanNoiseLevel_up = 0.;
+        double i_meanNoiseLevel_data = 0.;
+        double i_meanNoiseLevel_N = 0.;
+        for( int t = 0; t < fNTel; t++ )
+        {
+            if( fTelToAnalyze[t] )
             {
-                fData->setMWR( -99. );
+                // index for this telescope type
+                unsigned int telX = getTelTypeCounter( t, true );
+                
+                // get noise level index
+                getIndexBoundary( &inoise_up, &inoise_low, fTableNoiseLevel[telX], fNoiseLevel[t] );
+                
+                i_meanNoiseLevel_low  += fTableNoiseLevel[telX][inoise_low];
+                i_meanNoiseLevel_up   += fTableNoiseLevel[telX][inoise_up];
+                i_meanNoiseLevel_data += fNoiseLevel[t];
+                i_meanNoiseLevel_N++;
             }
-            // calculate mean length ratio (mean scaled variables)
-            imr = 0.;
-            inr = 0.;
-            for( unsigned int j = 0; j < s_N->fNTel; j++ )
+        }
+        if( i_meanNoiseLevel_N > 0. )
+        {
+            i_meanNoiseLevel_low  /= i_meanNoiseLevel_N;
+            i_meanNoiseLevel_up   /= i_meanNoiseLevel_N;
+            i_meanNoiseLevel_data /= i_meanNoiseLevel_N;
+        }
+        
+        // interpolate between NSB level bins
+        interpolate( s_Nlow, i_meanNoiseLevel_low,
+                     s_Nup,  i_meanNoiseLevel_up,
+                     s_N,    i_meanNoiseLevel_data, false );
+        
+        if( fTLRunParameter->fDebug == 2 )
+        {
+            cout << "DEBUG  NOISE INTER " << i_meanNoiseLevel_data << " ";
+            cout << i_meanNoiseLevel_low << "\t" << i_meanNoiseLevel_up;
+            cout << " " << s_Nlow->value[E_MSCL] << " ";
+            cout << s_Nup->value[E_MSCL] << " ";
+            cout << s_N->value[E_MSCL] << endl;
+        }
+        
+        // (end of interpolation section)
+        /////////////////////////////////
+        
+        
+        //////////////////////////////////////////////////////
+        // determine number of telescopes with MSCW values
+        for( unsigned int j = 0; j < s_N->fNTel; j++ )
+        {
+            if( s_N->value_T[E_MSCW][j] > -90. )
             {
-                if( s_N->value_T[E_MSCL][j] > 0. && fData->getLength() && i_s2 && i_s2[j] > 0. )
-                {
-                    imr += fData->getLength()[j] / s_N->value_T[E_MSCL][j];
-                    inr++;
-                }
+                fnmscw++;
             }
-            if( inr > 0. )
+        }
+        fData->setNMSCW( fnmscw );
+        
+        /////////////////////////
+        // set msc value (mean reduced scaled variables)
+        fData->setMSCW( s_N->value[E_MSCW] );
+        fData->setMSCL( s_N->value[E_MSCL] );
+        
+        // calculate mean width ratio (mean scaled variables)
+        imr = 0.;
+        inr = 0.;
+        // require size2 > 0 (to use only selected images for the MWR/MWL calculation)
+        double* i_s2 = fData->getSize2( 1., fTLRunParameter->fUseSelectedImagesOnly );
+        for( unsigned int j = 0; j < s_N->fNTel; j++ )
+        {
+            if( s_N->value_T[E_MSCW][j] > 0. && fData->getWidth() && i_s2 && i_s2[j] > 0. )
             {
-                fData->setMLR( imr / inr );
+                imr += fData->getWidth()[j] / s_N->value_T[E_MSCW][j];
+                inr++;
             }
-            else
+        }
+        if( inr > 0. )
+        {
+            fData->setMWR( imr / inr );
+        }
+        else
+        {
+            fData->setMWR( -99. );
+        }
+        // calculate mean length ratio (mean scaled variables)
+        imr = 0.;
+        inr = 0.;
+        for( unsigned int j = 0; j < s_N->fNTel; j++ )
+        {
+            if( s_N->value_T[E_MSCL][j] > 0. && fData->getLength() && i_s2 && i_s2[j] > 0. )
             {
-                fData->setMLR( -99. );
+                imr += fData->getLength()[j] / s_N->value_T[E_MSCL][j];
+                inr++;
             }
-            
-            /////////////////////////
-            // fill energies
-            //
-            // for dispEnergy: fill
-            // energy in the data handler
-            int iNERS = fData->fnenergyT;
-            if( !fData->useDispEnergy() )
+        }
+        if( inr > 0. )
+        {
+            fData->setMLR( imr / inr );
+        }
+        else
+        {
+            fData->setMLR( -99. );
+        }
+        
+        /////////////////////////
+        // fill energies
+        //
+        // for dispEnergy: fill
+        // energy in the data handler
+        int iNERS = fData->fnenergyT;
+        if( !fData->useDispEnergy() )
+        {
+            fData->setEnergy( s_N->value[E_EREC],
+                              s_N->value_Chi2[E_EREC],
+                              s_N->value_dE[E_EREC] );
+            // set energies per telescope
+            for( unsigned int j = 0; j < s_N->fNTel; j++ )
             {
-                fData->setEnergy( s_N->value[E_EREC],
-                                  s_N->value_Chi2[E_EREC],
-                                  s_N->value_dE[E_EREC] );
-                // set energies per telescope
-                for( unsigned int j = 0; j < s_N->fNTel; j++ )
+                fData->setEnergyT( j, s_N->value_T[E_EREC][j] );
+                if( s_N->value_T[E_EREC][j] > 0. )
                 {
-                    fData->setEnergyT( j, s_N->value_T[E_EREC][j] );
-                    if( s_N->value_T[E_EREC][j] > 0. )
-                    {
-                        iNERS++;
-                    }
+                    iNERS++;
                 }
-                fData->setNEnergyT( iNERS );
             }
-            // energy quality (for non-DISP methods)
-            if( iNERS > 0 )
+            fData->setNEnergyT( iNERS );
+        }
+        // energy quality (for non-DISP methods)
+        if( iNERS > 0 )
+        {
+            // good energy from 1 or more images
+            if( s_N->value_Chi2[E_EREC] >= 0. )
             {
-                // good energy from 1 or more images
-                if( s_N->value_Chi2[E_EREC] >= 0. )
+                if( iNERS > 1 )
                 {
-                    if( iNERS > 1 )
-                    {
-                        fData->setNEnergyQuality( 0 );
-                    }
-                    else
-                    {
-                        fData->setNEnergyQuality( 1 );
-                    }
+                    fData->setNEnergyQuality( 0 );
                 }
-                // no reconstructed total energy,
                 else
                 {
-                    fData->setNEnergyQuality( -2 );
+                    fData->setNEnergyQuality( 1 );
                 }
             }
-            else if( !fData->useDispEnergy() )
+            // no reconstructed total energy,
+            else
             {
-                fData->setNEnergyQuality( -1 );
+                fData->setNEnergyQuality( -2 );
             }
-            // set mean reduced scaled widths and energies per telescope
+        }
+        else if( !fData->useDispEnergy() )
+        {
+            fData->setNEnergyQuality( -1 );
+        }
+        // set mean reduced scaled widths and energies per telescope
+        for( unsigned int j = 0; j < s_N->fNTel; j++ )
+        {
+            fData->setMSCWT( j, s_N->value_T[E_MSCW][j], s_N->value_T_sigma[E_MSCW][j] );
+            fData->setMSCLT( j, s_N->value_T[E_MSCL][j], s_N->value_T_sigma[E_MSCL][j] );
+        }
+        
+        /////////////////////////
+        // fill mean scaled time gradient (optional)
+        if( s_N->value.find( E_TGRA ) != s_N->value.end() )
+        {
+            fData->setMSCT( s_N->value[E_TGRA] );
             for( unsigned int j = 0; j < s_N->fNTel; j++ )
             {
-                fData->setMSCWT( j, s_N->value_T[E_MSCW][j], s_N->value_T_sigma[E_MSCW][j] );
-                fData->setMSCLT( j, s_N->value_T[E_MSCL][j], s_N->value_T_sigma[E_MSCL][j] );
+                fData->setMSCTT( j, s_N->value_T[E_TGRA][j], s_N->value_T_sigma[E_TGRA][j] );
             }
-            
-            /////////////////////////
-            // fill mean scaled time gradient (optional)
-            if( s_N->value.find( E_TGRA ) != s_N->value.end() )
-            {
-                fData->setMSCT( s_N->value[E_TGRA] );
-                for( unsigned int j = 0; j < s_N->fNTel; j++ )
-                {
-                    fData->setMSCTT( j, s_N->value_T[E_TGRA][j], s_N->value_T_sigma[E_TGRA][j] );
-                }
-            }
-            
-            fData->fill();
         }
-        fevent++;
+        
+        fData->fill();
     }
 }
 
@@ -1469,12 +1599,19 @@ void VTableLookup::interpolate( VTablesToRead* s1, double w1, VTablesToRead* s2,
 /*!
      write everything to disk
 */
-void VTableLookup::terminate()
+bool VTableLookup::terminate()
 {
+    bool bSuccess = true;
     fData->terminate( fTLRunParameter );
     
     if( fTLRunParameter->fWriteTables )
     {
+        // table file shared with other threads
+        unique_lock< mutex > iFileLock;
+        if( fLookupTableFileMutex )
+        {
+            iFileLock = unique_lock< mutex >( *fLookupTableFileMutex );
+        }
         cout << "writing tables to disk (outputfile is " << fLookupTableFile->GetName() << ")" << endl;
         
         /// loop over all lookup table types
@@ -1487,7 +1624,10 @@ void VTableLookup::terminate()
             {
                 continue;
             }
-            iTableData->terminate( fLookupTableFile );
+            if( !iTableData->terminate( fLookupTableFile ) )
+            {
+                bSuccess = false;
+            }
         }
         cout << "end of run (" << fLookupTableFile->GetName() << ")" << endl;
     }
@@ -1503,13 +1643,19 @@ void VTableLookup::terminate()
     // large amount of objects read from subdirectory of the tablefile might result in
     // excessive time needed to close the tablefile
     // tablefile is therefore only close in table writing mode
-    if( fTLRunParameter->fWriteTables )
+    // (shared table files are closed by the owner)
+    if( fTLRunParameter->fWriteTables && !fLookupTableFileShared )
     {
         cout << "closing file..." << endl;
         fLookupTableFile->Close();
     }
+    else if( fTLRunParameter->fWriteTables )
+    {
+        fData->closeInputFiles();
+    }
     
     cout << "exiting..." << endl;
+    return bSuccess;
 }
 
 /*
@@ -1588,32 +1734,48 @@ bool VTableLookup::setInputFiles( vector< string > iInputFiles )
       sort them to make sure that they are always in the same sequence
 
 */
-vector< string > VTableLookup::getSortedListOfDirectories( TDirectory* iDir )
+vector< string > VTableLookup::getSortedListOfDirectories( string iPath )
 {
     vector< string > iDName;
     
-    if( !iDir )
+    // compiled lookup table file
+    if( fCompiledLookupTableFile )
     {
-        return iDName;
+        iDName = fCompiledLookupTableFile->getListOfDirectories( iPath );
     }
-    
-    bool bWoffAltered = false;
-    
-    TList* iKeyList = iDir->GetListOfKeys();
-    if( iKeyList )
+    // ROOT lookup table file
+    else if( fLookupTableFile )
     {
-        TIter next( iKeyList );
-        while( TNamed* iK = ( TNamed* )next() )
+        TDirectory* iDir = fLookupTableFile;
+        if( iPath.size() > 0 )
         {
-            iDName.push_back( iK->GetName() );
-            if( iDName.back().substr( 0, 4 ) == "woff" && iDName.back().size() == 8 )
+            iDir = fLookupTableFile->GetDirectory( iPath.c_str() );
+        }
+        if( !iDir )
+        {
+            return iDName;
+        }
+        TList* iKeyList = iDir->GetListOfKeys();
+        if( iKeyList )
+        {
+            TIter next( iKeyList );
+            while( TNamed* iK = ( TNamed* )next() )
             {
-                iDName.back() = "woff_0" + iDName.back().substr( 5, iDName.back().size() );
-                bWoffAltered = true;
+                iDName.push_back( iK->GetName() );
             }
         }
     }
     
+    bool bWoffAltered = false;
+    for( unsigned int i = 0; i < iDName.size(); i++ )
+    {
+        if( iDName[i].substr( 0, 4 ) == "woff" && iDName[i].size() == 8 )
+        {
+            iDName[i] = "woff_0" + iDName[i].substr( 5, iDName[i].size() );
+            bWoffAltered = true;
+        }
+    }
+    
     sort( iDName.begin(), iDName.end() );
     
     if( bWoffAltered )
@@ -1820,7 +1982,14 @@ void VTableLookup::getTables( unsigned int inoise, unsigned int ize,
             continue;
         }
         
-        s->hMedian[t][tel] = iTableData->fTable[telX][inoise][ize][iwoff][iaz]->getHistoMedian();
+        if( fCompiledLookupTableFile )
+        {
+            s->hCompiledMedian[t][tel] = iTableData->fTable[telX][inoise][ize][iwoff][iaz]->getCompiledMedian();
+        }
+        else
+        {
+            s->hMedian[t][tel] = iTableData->fTable[telX][inoise][ize][iwoff][iaz]->getHistoMedian();
+        }
         t++;
     }
 }
@@ -1858,6 +2027,7 @@ void VTableLookup::calculateMSFromTables( VTablesToRead* s )
             fTableData[E_MSCW]->fValueNormalizationRange_max );
     fTableCalculator->setEventSelectionCut();
     fTableCalculator->setVHistograms( s->hMedian[E_MSCW] );
+    fTableCalculator->setVCompiledTables( s->hCompiledMedian[E_MSCW] );
     
     s->value[E_MSCW] = fTableCalculator->calc( ( int )fData->getNTel(), fData->getDistanceToCore(),
                        i_s2, i_l, i_d, fData->getWidth(),
@@ -1872,6 +2042,7 @@ void VTableLookup::calculateMSFromTables( VTablesToRead* s )
             fTableData[E_MSCL]->fValueNormalizationRange_max );
     fTableCalculator->setEventSelectionCut();
     fTableCalculator->setVHistograms( s->hMedian[E_MSCL] );
+    fTableCalculator->setVCompiledTables( s->hCompiledMedian[E_MSCL] );
     
     s->value[E_MSCL] = fTableCalculator->calc( ( int )fData->getNTel(), fData->getDistanceToCore(),
                        i_s2, i_l, i_d, fData->getLength(),
@@ -1887,6 +2058,7 @@ void VTableLookup::calculateMSFromTables( VTablesToRead* s )
     fTableCalculator->setEventSelectionCut( fTLRunParameter->fEventSelectionCut_lossCutMax,
                                             fTLRunParameter->fEventSelectionCut_distanceCutMax );
     fTableCalculator->setVHistograms( s->hMedian[E_EREC] );
+    fTableCalculator->setVCompiledTables( s->hCompiledMedian[E_EREC] );
     s->value[E_EREC] = fTableCalculator->calc( ( int )fData->getNTel(), fData->getDistanceToCore(),
                        i_s2, i_l, i_d, 0,
                        s->value_T[E_EREC],
@@ -1903,6 +2075,7 @@ void VTableLookup::calculateMSFromTables( VTablesToRead* s )
                 fTableData[E_TGRA]->fValueNormalizationRange_max );
         fTableCalculator->setEventSelectionCut();
         fTableCalculator->setVHistograms( s->hMedian[E_TGRA] );
+        fTableCalculator->setVCompiledTables( s->hCompiledMedian[E_TGRA] );
         
         s->value[E_TGRA] = fTableCalculator->calc( ( int )fData->getNTel(), fData->getDistanceToCore(),
                            i_s2, i_l, i_d, fData->getTimeGradient(),
@@ -2009,6 +2182,38 @@ unsigned int VTableLookup::getWobbleBin( double w )
     return 9999;
 }
 
+/*
+ * noise levels (mean pedvars) vary slightly from simulation file to
+ * simulation file; use the first existing noise directory (in ascending
+ * order) of a very similar noise level (same criterion as in combineLookupTables)
+ */
+int VTableLookup::getSimilarNoiseLevel( TDirectory* iDir, int i_noise )
+{
+    if( !iDir || !iDir->GetListOfKeys() )
+    {
+        return i_noise;
+    }
+    vector< int > i_noise_dir;
+    TIter next( iDir->GetListOfKeys() );
+    while( TKey* iKey = ( TKey* )next() )
+    {
+        string iName = iKey->GetName();
+        if( iName.find( "NOISE_" ) == 0 )
+        {
+            i_noise_dir.push_back( atoi( iName.substr( 6, iName.size() ).c_str() ) );
+        }
+    }
+    sort( i_noise_dir.begin(), i_noise_dir.end() );
+    for( unsigned int i = 0; i < i_noise_dir.size(); i++ )
+    {
+        if( TMath::Abs( i_noise_dir[i] - i_noise ) < 10 )
+        {
+            return i_noise_dir[i];
+        }
+    }
+    return i_noise;
+}
+
 unsigned int VTableLookup::getTelTypeCounter( unsigned int tel, bool iStopIfError )
 {
     unsigned int telX = 999999;
@@ -2044,12 +2249,33 @@ VTableCalculatorData::VTableCalculatorData()
     fValueNormalizationRange_max = -9999.;
 }
 
+VTableCalculatorData::~VTableCalculatorData()
+{
+    for( unsigned int i = 0; i < fTable.size(); i++ )
+    {
+        for( unsigned int t = 0; t < fTable[i].size(); t++ )
+        {
+            for( unsigned int u = 0; u < fTable[i][t].size(); u++ )
+            {
+                for( unsigned int v = 0; v < fTable[i][t][u].size(); v++ )
+                {
+                    for( unsigned w = 0; w < fTable[i][t][u][v].size(); w++ )
+                    {
+                        delete fTable[i][t][u][v][w];
+                    }
+                }
+            }
+        }
+    }
+}
+
 /*
  * call terminate function for lookup table code and write tables to disk
  *
  */
-void VTableCalculatorData::terminate( TFile* iFile )
+bool VTableCalculatorData::terminate( TFile* iFile )
 {
+    bool bSuccess = true;
     char hname[800];
     for( unsigned int i = 0; i < fTable.size(); i++ )
     {
@@ -2065,7 +2291,10 @@ void VTableCalculatorData::terminate( TFile* iFile )
                         cout << "writing " << fDirectoryName << " tables for ";
                         cout << fTable[i][t][u][v][w]->getOutputDirectory()->GetMotherDir()->GetPath();
                         cout << " : " << hname << endl;
-                        fTable[i][t][u][v][w]->terminate( fTable[i][t][u][v][w]->getOutputDirectory(), hname );
+                        if( !fTable[i][t][u][v][w]->terminate( fTable[i][t][u][v][w]->getOutputDirectory(), hname ) )
+                        {
+                            bSuccess = false;
+                        }
                         if( iFile )
                         {
                             iFile->Flush();
@@ -2075,6 +2304,7 @@ void VTableCalculatorData::terminate( TFile* iFile )
             }
         }
     }
+    return bSuccess;
 }
 
 /*
@@ -6,6 +6,9 @@
 */
 
 #include "VTableLookupDataHandler.h"
+#ifdef RUNWITHRNTUPLE
+#include "VRNTupleWriter.h"
+#endif
 
 VTableLookupDataHandler::VTableLookupDataHandler( bool iwrite, VTableLookupRunParameter* iT )
 {
@@ -27,8 +30,12 @@ VTableLookupDataHandler::VTableLookupDataHandler( bool iwrite, VTableLookupRunPa
     fTshowerpars = 0;
     fTshowerpars_QCCut = 0;
     fshowerpars = 0;
+    ftparsSparse = 0;
     fDeepLearnerpars = 0;
     fOTree = 0;
+    fORNTuple = 0;
+    fSubArrayID = 0;
+    fReadShortEvent = false;
     fShortTree = fTLRunParameter->bShortTree;
     bWriteMCPars = fTLRunParameter->bWriteMCPars;
     fTreeWithParameterErrors = false;
@@ -134,6 +141,13 @@ VTableLookupDataHandler::VTableLookupDataHandler( bool iwrite, VTableLookupRunPa
     hWE0trig->SetYTitle( "distance to camera center [deg]" );
     hWE0trig->SetZTitle( "number of showers" );
     hisList->Add( hWE0trig );
+    // (histograms are owned by this class)
+    TIter next( hisList );
+    TH1* h = 0;
+    while( ( h = ( TH1* )next() ) )
+    {
+        h->SetDirectory( 0 );
+    }
 
     // time cuts
     fMaxTotalTime = fTLRunParameter->fMaxRunTime;
@@ -148,6 +162,67 @@ VTableLookupDataHandler::VTableLookupDataHandler( bool iwrite, VTableLookupRunPa
     fDispAnalyzerCore      = 0;
 }
 
+VTableLookupDataHandler::~VTableLookupDataHandler()
+{
+    closeInputFiles();
+
+    // input chains and tree readers
+    for( unsigned int i = 0; i < ftpars.size(); i++ )
+    {
+        if( ftpars[i] )
+        {
+            // (chain is 0 for the sparse tree layout)
+            TTree* iT = ftpars[i]->fChain;
+            delete ftpars[i];
+            delete iT;
+        }
+    }
+    if( ftparsSparse )
+    {
+        TTree* iTSparse = ftparsSparse->fChain;
+        delete ftparsSparse;
+        delete iTSparse;
+    }
+    for( unsigned int i = 0; i < fpointingCorrections.size(); i++ )
+    {
+        delete fpointingCorrections[i];
+    }
+    delete fshowerpars;
+    delete fTshowerpars;
+    delete fTshowerpars_QCCut;
+    delete fDeepLearnerpars;
+    delete fTtelconfig;
+
+    delete fEmissionHeightCalculator;
+    delete fRandom;
+    delete fDispAnalyzerDirection;
+    delete fDispAnalyzerDirectionError;
+    delete fDispAnalyzerCore;
+    delete fDispAnalyzerEnergy;
+
+    if( hisList )
+    {
+        hisList->Delete();
+        delete hisList;
+    }
+
+    // output files (closed in terminate())
+#ifdef RUNWITHRNTUPLE
+    delete fORNTuple;
+#endif
+    if( fOutFile_SubArray.size() > 0 )
+    {
+        for( unsigned int s = 0; s < fOutFile_SubArray.size(); s++ )
+        {
+            delete fOutFile_SubArray[s];
+        }
+    }
+    else
+    {
+        delete fOutFile;
+    }
+}
+
 /*
  * fill results of analysis into output tree
  * (called data in the mscw file)
@@ -203,13 +278,27 @@ void VTableLookupDataHandler::fill()
     {
         if( isReconstructed() )
         {
-            fOTree->Fill();
+            fillOutputTree();
         }
     }
     else
     {
-        fOTree->Fill();
+        fillOutputTree();
+    }
+}
+
+/*
+ * fill event into output tree and/or RNTuple
+ */
+void VTableLookupDataHandler::fillOutputTree()
+{
+    fOTree->Fill();
+#ifdef RUNWITHRNTUPLE
+    if( fORNTuple )
+    {
+        fORNTuple->fill();
     }
+#endif
 }
 
 
@@ -285,17 +374,7 @@ bool VTableLookupDataHandler::getNextEvent( bool bShort )
             return true;
         }
 
-        // calculate theta2
-        if( !fIsMC )
-        {
-            ftheta2 = ( fYoff_derot - fWobbleN ) * ( fYoff_derot - fWobbleN )
-                      + ( fXoff_derot - fWobbleE ) * ( fXoff_derot - fWobbleE );
-        }
-        else
-        {
-            ftheta2 = ( fXoff - fMCxoff ) * ( fXoff - fMCxoff )
-                      + ( fYoff - fMCyoff ) * ( fYoff - fMCyoff );
-        }
+        calcTheta2();
 
         setEventWeightfromMCSpectrum();
     }
@@ -306,6 +385,23 @@ bool VTableLookupDataHandler::getNextEvent( bool bShort )
     return true;
 }
 
+/*
+ * calculate theta2 (squared angular distance to source / MC direction)
+ */
+void VTableLookupDataHandler::calcTheta2()
+{
+    if( !fIsMC )
+    {
+        ftheta2 = ( fYoff_derot - fWobbleN ) * ( fYoff_derot - fWobbleN )
+                  + ( fXoff_derot - fWobbleE ) * ( fXoff_derot - fWobbleE );
+    }
+    else
+    {
+        ftheta2 = ( fXoff - fMCxoff ) * ( fXoff - fMCxoff )
+                  + ( fYoff - fMCyoff ) * ( fYoff - fMCyoff );
+    }
+}
+
 /*
  * get next event from trees,
  * do quick reconstruction quality test,
@@ -420,6 +516,7 @@ int VTableLookupDataHandler::fillNextEvent( bool bShort )
             MJD = fshowerpars->MJD;
         }
         fNTrig = 0;
+        fTrig_list_all.assign( fNTel, false );
         // determine number of triggered telescopes
         for( unsigned t = 0; t < fshowerpars->NTrig; t++)
         {
@@ -427,6 +524,10 @@ int VTableLookupDataHandler::fillNextEvent( bool bShort )
             if( t < fTLRunParameter->fTelToAnalyzeData.size() && fTLRunParameter->fTelToAnalyzeData[tel_trig] && fTLRunParameter->fTelToAnalyzeData[tel_trig]->fTelToAnalyze )
             {
                 fNTrig++;
+                if( tel_trig < fTrig_list_all.size() )
+                {
+                    fTrig_list_all[tel_trig] = true;
+                }
             }
         }
 
@@ -548,6 +649,7 @@ int VTableLookupDataHandler::fillNextEvent( bool bShort )
     ii = 0;
     unsigned int i_pixel_id0 = 0;
     PixelListNPixelNN = 0;
+    fTPars_read_all.assign( fNTel, false );
     for( unsigned int i = 0; i < fNTel; i++ )
     {
         bool fReadTPars = false;
@@ -581,46 +683,14 @@ int VTableLookupDataHandler::fillNextEvent( bool bShort )
             }
             ftpars[i]->GetEntry( fEventCounter );
 
-            fdist[i] = ftpars[i]->dist;
-            ffui[i] = ftpars[i]->fui;
-            fsize[i] = ftpars[i]->size;
-            fsize2[i] = ftpars[i]->size2;
-            floss[i] = ftpars[i]->loss;
-            ffracLow[i] = ftpars[i]->fracLow;
-            fwidth[i] = ftpars[i]->width;
-            flength[i] = ftpars[i]->length;
-            ftgrad_x[i] = ftpars[i]->tgrad_x;
             if( i < fpointingCorrections.size() && fpointingCorrections[i]
                     && fpointingCorrections[i]->is_initialized() )
             {
                 fpointingCorrections[i]->getEntry( fEventCounter );
-                fcen_x[i] = fpointingCorrections[i]->getCorrected_cen_x( ftpars[i]->cen_x );
-                fcen_y[i] = fpointingCorrections[i]->getCorrected_cen_y( ftpars[i]->cen_y );
-                float phi = fpointingCorrections[i]->getCorrected_phi(
-                                ftpars[i]->cen_x,
-                                ftpars[i]->cen_y,
-                                ftpars[i]->f_d,
-                                ftpars[i]->f_s,
-                                ftpars[i]->f_sdevxy );
-                fcosphi[i] = cos( phi );
-                fsinphi[i] = sin( phi );
-            }
-            else
-            {
-                fcen_x[i] = ftpars[i]->cen_x;
-                fcen_y[i] = ftpars[i]->cen_y;
-                fcosphi[i] = ftpars[i]->cosphi;
-                fsinphi[i] = ftpars[i]->sinphi;
-            }
-            if( ftpars[i]->hasParameterErrors() )
-            {
-                fTreeWithParameterErrors = true;
-                fdcen_x[i] = ftpars[i]->dcen_x;
-                fdcen_y[i] = ftpars[i]->dcen_y;
-                fdlength[i] = ftpars[i]->dlength;
-                fdwidth[i] = ftpars[i]->dwidth;
-                fdphi[i] = ftpars[i]->dphi;
             }
+            copyImageParameters( i, bShort );
+            fTPars_read_all[i] = true;
+
             if( ftpars[i]->hasPixelList() && fTLRunParameter->fWritePixelLists )
             {
                 PixelListN[ii] = ftpars[i]->PixelListN;
@@ -651,25 +721,6 @@ int VTableLookupDataHandler::fillNextEvent( bool bShort )
                     SizeSecondMax_temp = fsize[i];
                 }
             }
-            fCurrentNoiseLevel[i] = ftpars[i]->meanPedvar_Image;
-            if( !bShort )
-            {
-                fmeanPedvar_ImageT[i] = ftpars[i]->meanPedvar_Image;
-                fntubes[i] = ftpars[i]->ntubes;
-                fnsat[i] = ftpars[i]->nsat;
-                fnlowgain[i] = ftpars[i]->nlowgain;
-                falpha[i] = ftpars[i]->alpha;
-                flos[i] = ftpars[i]->los;
-                fasym[i] = ftpars[i]->asymmetry;
-                fmax1[i] = ftpars[i]->max[0];
-                fmax2[i] = ftpars[i]->max[1];
-                fmax3[i] = ftpars[i]->max[2];
-                fmaxindex1[i] = ftpars[i]->index_of_max[0];
-                fmaxindex2[i] = ftpars[i]->index_of_max[1];
-                fmaxindex3[i] = ftpars[i]->index_of_max[2];
-                ftchisq_x[i] = ftpars[i]->tchisq_x;
-                fFitstat[i] = ftpars[i]->Fitstat;
-            }
         }
         else
         {
@@ -697,6 +748,95 @@ int VTableLookupDataHandler::fillNextEvent( bool bShort )
         fSizeSecondMax =  SizeFirstMax_temp;
     }
 
+    ///////////////////////////////////////////////////////////
+    // subarray analysis: keep selection of the full array;
+    // reconstruction is done for each subarray (see selectSubArray())
+    if( fTLRunParameter->fSubArrayID.size() > 0 && !fwrite )
+    {
+        fImgSel_list_all.assign( fImgSel_list, fImgSel_list + fNTel );
+        fReadShortEvent = bShort;
+    }
+    else
+    {
+        reconstructEvent();
+    }
+
+    fEventCounter++;
+    return 1;
+}
+
+/*
+ * copy image parameters of telescope i from the tpars tree
+ * (tree entry and pointing corrections are read before)
+ */
+void VTableLookupDataHandler::copyImageParameters( unsigned int i, bool bShort )
+{
+    fdist[i] = ftpars[i]->dist;
+    ffui[i] = ftpars[i]->fui;
+    fsize[i] = ftpars[i]->size;
+    fsize2[i] = ftpars[i]->size2;
+    floss[i] = ftpars[i]->loss;
+    ffracLow[i] = ftpars[i]->fracLow;
+    fwidth[i] = ftpars[i]->width;
+    flength[i] = ftpars[i]->length;
+    ftgrad_x[i] = ftpars[i]->tgrad_x;
+    if( i < fpointingCorrections.size() && fpointingCorrections[i]
+            && fpointingCorrections[i]->is_initialized() )
+    {
+        fcen_x[i] = fpointingCorrections[i]->getCorrected_cen_x( ftpars[i]->cen_x );
+        fcen_y[i] = fpointingCorrections[i]->getCorrected_cen_y( ftpars[i]->cen_y );
+        float phi = fpointingCorrections[i]->getCorrected_phi(
+                        ftpars[i]->cen_x,
+                        ftpars[i]->cen_y,
+                        ftpars[i]->f_d,
+                        ftpars[i]->f_s,
+                        ftpars[i]->f_sdevxy );
+        fcosphi[i] = cos( phi );
+        fsinphi[i] = sin( phi );
+    }
+    else
+    {
+        fcen_x[i] = ftpars[i]->cen_x;
+        fcen_y[i] = ftpars[i]->cen_y;
+        fcosphi[i] = ftpars[i]->cosphi;
+        fsinphi[i] = ftpars[i]->sinphi;
+    }
+    if( ftpars[i]->hasParameterErrors() )
+    {
+        fTreeWithParameterErrors = true;
+        fdcen_x[i] = ftpars[i]->dcen_x;
+        fdcen_y[i] = ftpars[i]->dcen_y;
+        fdlength[i] = ftpars[i]->dlength;
+        fdwidth[i] = ftpars[i]->dwidth;
+        fdphi[i] = ftpars[i]->dphi;
+    }
+    fCurrentNoiseLevel[i] = ftpars[i]->meanPedvar_Image;
+    if( !bShort )
+    {
+        fmeanPedvar_ImageT[i] = ftpars[i]->meanPedvar_Image;
+        fntubes[i] = ftpars[i]->ntubes;
+        fnsat[i] = ftpars[i]->nsat;
+        fnlowgain[i] = ftpars[i]->nlowgain;
+        falpha[i] = ftpars[i]->alpha;
+        flos[i] = ftpars[i]->los;
+        fasym[i] = ftpars[i]->asymmetry;
+        fmax1[i] = ftpars[i]->max[0];
+        fmax2[i] = ftpars[i]->max[1];
+        fmax3[i] = ftpars[i]->max[2];
+        fmaxindex1[i] = ftpars[i]->index_of_max[0];
+        fmaxindex2[i] = ftpars[i]->index_of_max[1];
+        fmaxindex3[i] = ftpars[i]->index_of_max[2];
+        ftchisq_x[i] = ftpars[i]->tchisq_x;
+        fFitstat[i] = ftpars[i]->Fitstat;
+    }
+}
+
+/*
+ * event reconstruction from image parameters
+ * (distances, emission heights, optional stereo / disp reconstruction)
+ */
+void VTableLookupDataHandler::reconstructEvent()
+{
     ///////////////////////////////////////////////////////////
     // calculate distances
     calcDistances();
@@ -723,6 +863,11 @@ int VTableLookupDataHandler::fillNextEvent( bool bShort )
     if( fTLRunParameter->fRerunStereoReconstruction )
     {
         doStereoReconstruction();
+        // subarray analysis: distances to the core of this subarray
+        if( fTLRunParameter->fSubArrayID.size() > 0 )
+        {
+            calcDistances();
+        }
     }
 
     //////////////////////////////////////////////////////////
@@ -808,9 +953,133 @@ int VTableLookupDataHandler::fillNextEvent( bool bShort )
         setNEnergyT( fDispAnalyzerEnergy->getEnergyNT() );
         setNEnergyQuality( fDispAnalyzerEnergy->getEnergyQualityLabel() );
     }
+}
 
-    fEventCounter++;
-    return 1;
+/*
+ * select telescopes of a subarray for the current event
+ * and redo the event reconstruction for this subarray
+ *
+ * image parameters are read once per event (fillNextEvent());
+ * for each subarray, the eventdisplay reconstruction and the image
+ * parameters of the telescopes in the subarray are restored from the
+ * event already in memory; all other telescopes are reset
+ *
+ * returns false for invalid subarrays
+ */
+bool VTableLookupDataHandler::selectSubArray( unsigned int iSubArray )
+{
+    if( fTLRunParameter->fSubArrayID.size() == 0 )
+    {
+        return true;
+    }
+    if( iSubArray >= fTLRunParameter->fSubArrayID.size()
+            || fImgSel_list_all.size() != fNTel
+            || fTPars_read_all.size() != fNTel )
+    {
+        return false;
+    }
+    fSubArrayID = fTLRunParameter->fSubArrayID[iSubArray];
+    // each subarray is written into its own output file
+    if( iSubArray < fOTree_SubArray.size() )
+    {
+        fOTree = fOTree_SubArray[iSubArray];
+    }
+    vector< bool > i_inSubArray( fNTel, false );
+    for( unsigned int i = 0; i < fTLRunParameter->fSubArrayTelescopes[iSubArray].size(); i++ )
+    {
+        if( fTLRunParameter->fSubArrayTelescopes[iSubArray][i] < fNTel )
+        {
+            i_inSubArray[fTLRunParameter->fSubArrayTelescopes[iSubArray][i]] = true;
+        }
+    }
+    // reset results (and image parameters) of the previous subarray
+    reset();
+
+    // eventdisplay reconstruction as starting point for each subarray
+    fchi2 = fchi2_QCTree[fMethod];
+    fDispDiff = fshowerpars->DispDiff[fMethod];
+    fimg2_ang = fshowerpars->img2_ang[fMethod];
+    if( !fReadShortEvent && !fShortTree )
+    {
+        fRA = fshowerpars->ra[fMethod];
+        fDec = fshowerpars->dec[fMethod];
+        fstdS = fshowerpars->stds[fMethod];
+        fXcore_SC = fshowerpars->Xcore_SC[fMethod];
+        fYcore_SC = fshowerpars->Ycore_SC[fMethod];
+        fstdP = fshowerpars->stdp[fMethod];
+    }
+    fZe = fshowerpars->Ze[fMethod];
+    fAz = fshowerpars->Az[fMethod];
+    fXcore = fshowerpars->Xcore[fMethod];
+    fYcore = fshowerpars->Ycore[fMethod];
+    fXoff = fshowerpars->Xoff[fMethod];
+    fYoff = fshowerpars->Yoff[fMethod];
+    fXoff_derot = fshowerpars->XoffDeRot[fMethod];
+    fYoff_derot = fshowerpars->YoffDeRot[fMethod];
+
+    for( unsigned int i = 0; i < getNTelTypes(); i++ )
+    {
+        NImages_Ttype[i] = 0;
+    }
+    fImgSel = 0;
+    fNTrig = 0;
+    Double_t SizeFirstMax_temp = -1000.;
+    Double_t SizeSecondMax_temp = -100.;
+    unsigned int ii = 0;
+    for( unsigned int i = 0; i < fNTel; i++ )
+    {
+        fImgSel_list[i] = ( fImgSel_list_all[i] && i_inSubArray[i] );
+        if( i < fTrig_list_all.size() && fTrig_list_all[i] && i_inSubArray[i] )
+        {
+            fNTrig++;
+        }
+        // image parameters of telescopes outside of the subarray stay reset
+        if( !i_inSubArray[i] || !fTPars_read_all[i] )
+        {
+            continue;
+        }
+        copyImageParameters( i, fReadShortEvent );
+        if( fTLRunParameter->fTelToAnalyzeData.size() == getNTel()
+                && fTLRunParameter->fTelToAnalyzeData[i] )
+        {
+            fweight[i] = fTLRunParameter->fTelToAnalyzeData[i]->fWeight;
+        }
+        if( fImgSel_list[i] )
+        {
+            fImgSel_list_short[ii] = i;
+            NImages_Ttype[getTelType_arraycounter( i )]++;
+            // (bit coding for < 64 telescopes only)
+            if( i < 8 * sizeof( ULong64_t ) )
+            {
+                fImgSel |= ( ( ULong64_t )1 << i );
+            }
+            ii++;
+            if( fsize[i] > SizeSecondMax_temp )
+            {
+                if( fsize[i] > SizeFirstMax_temp )
+                {
+                    SizeSecondMax_temp = SizeFirstMax_temp;
+                    SizeFirstMax_temp = fsize[i];
+                }
+                else
+                {
+                    SizeSecondMax_temp = fsize[i];
+                }
+            }
+        }
+    }
+    fNImages = ( int )ii;
+    fmeanPedvar_Image = calculateMeanNoiseLevel( true );
+    fSizeSecondMax = ( SizeSecondMax_temp > 0. ? SizeSecondMax_temp : 0. );
+    if( fNImages == 1 )
+    {
+        fSizeSecondMax = SizeFirstMax_temp;
+    }
+
+    reconstructEvent();
+    calcTheta2();
+
+    return true;
 }
 
 /*
@@ -1009,6 +1278,7 @@ bool VTableLookupDataHandler::checkIfFilesInChainAreRecovered( TChain* c )
             return true;
         }
         ifInput->Close();
+        delete ifInput;
     }
 
     return false;
@@ -1337,17 +1607,46 @@ bool VTableLookupDataHandler::setInputFile( vector< string > iInput )
     fTshowerpars_QCCut->SetBranchAddress( "NImages", fNImages_QCTree );
     fTshowerpars_QCCut->SetBranchAddress( "Chi2", fchi2_QCTree );
 
+    // image parameters of all telescopes in one tree (sparse layout)
+    TChain* iTSparse = new TChain( "tparsSparse" );
+    for( unsigned int f = 0; f < finputfile.size(); f++ )
+    {
+        iTSparse->Add( finputfile[f].c_str() );
+    }
+    // (tree is not present in files with standard layout)
+    gErrorIgnoreLevel = 5000;
+    Int_t iSparseBytes = iTSparse->GetEntry( 0 );
+    gErrorIgnoreLevel = 0;
+    if( fEventDisplayFileFormat >= 2 && iSparseBytes > 0 )
+    {
+        cout << "reading image parameters of all telescopes from tree tparsSparse" << endl;
+        fEventDisplayFileFormat = TMath::Max( fEventDisplayFileFormat, 5 );
+        ftparsSparse = new CtparsSparse( iTSparse, bShort );
+    }
+    else
+    {
+        delete iTSparse;
+    }
+
     // get individual image parameter trees
     for( unsigned int i = 0; i < fNTel; i++ )
     {
+        // sparse layout: parameters of this telescope are read from tparsSparse
+        if( ftparsSparse )
+        {
+            ftpars.push_back( new Ctpars( ftparsSparse, i, fIsMC, bShort ) );
+        }
         TChain* iT = new TChain( "tpars" );
         sprintf( iName, "pointing_%u", i + 1 );
         // pointing correction chain
         TChain* iPC = new TChain( iName );
         for( unsigned int f = 0; f < finputfile.size(); f++ )
         {
-            sprintf( iDir, "%s/Tel_%u/tpars", finputfile[f].c_str(), i + 1 );
-            iT->Add( iDir );
+            if( !ftparsSparse )
+            {
+                sprintf( iDir, "%s/Tel_%u/tpars", finputfile[f].c_str(), i + 1 );
+                iT->Add( iDir );
+            }
             // no pointing corrections for MC analysis
             if( !fIsMC )
             {
@@ -1362,7 +1661,11 @@ bool VTableLookupDataHandler::setInputFile( vector< string > iInput )
         }
         // get first entry to check if chain is there
         // gErrorIgnoreLevel = 5000;
-        if( iT->GetEntry( 0 ) > 0 )
+        if( ftparsSparse )
+        {
+            delete iT;
+        }
+        else if( iT->GetEntry( 0 ) > 0 )
         {
             if( fEventDisplayFileFormat >= 2 )
             {
@@ -1568,6 +1871,11 @@ bool VTableLookupDataHandler::setInputFile( vector< string > iInput )
 bool VTableLookupDataHandler::setOutputFile( string iOutput, string iOption, string tablefile )
 {
     foutputfile = iOutput;
+    // subarray analysis: one output file per subarray
+    if( fTLRunParameter->fSubArrayID.size() > 0 )
+    {
+        foutputfile = getSubArrayOutputFileName( iOutput, 0 );
+    }
 
     if( fNTel == 0 )
     {
@@ -1619,6 +1927,10 @@ bool VTableLookupDataHandler::setOutputFile( string iOutput, string iOption, str
     fOTree->Branch( "WobbleN", &fWobbleN, "WobbleN/D" );
     fOTree->Branch( "WobbleE", &fWobbleE, "WobbleE/D" );
 
+    if( fTLRunParameter->fSubArrayID.size() > 0 )
+    {
+        fOTree->Branch( "SubArrayID", &fSubArrayID, "SubArrayID/I" );
+    }
     fOTree->Branch( "LTrig", &LTrig, "LTrig/l" );
     fOTree->Branch( "NTrig", &fNTrig, "NTrig/i" );
     fOTree->Branch( "NImages", &fNImages, "NImages/I" );
@@ -1875,11 +2187,82 @@ bool VTableLookupDataHandler::setOutputFile( string iOutput, string iOption, str
         fOTree->Branch( "PixelPE", PixelPE, "PixelPE[PixelListNPixelNN]/F" );
     }
 
+    // subarray analysis: one output file and tree per subarray
+    // (branch addresses are shared with the tree of the first subarray)
+    if( fTLRunParameter->fSubArrayID.size() > 0 )
+    {
+        fOutFile_SubArray.push_back( fOutFile );
+        fOTree_SubArray.push_back( fOTree );
+        for( unsigned int s = 1; s < fTLRunParameter->fSubArrayID.size(); s++ )
+        {
+            string iSubArrayFile = getSubArrayOutputFileName( iOutput, s );
+            TFile* iF = new TFile( iSubArrayFile.c_str(), iOption.c_str() );
+            if( iF->IsZombie() )
+            {
+                cout << "VTableLookupDataHandler::setOutputFile error while opening output file " << iSubArrayFile << "\t" << iOption << endl;
+                exit( EXIT_FAILURE );
+            }
+            TTree* iT = fOTree->CloneTree( 0 );
+            iT->SetDirectory( iF );
+            fOutFile_SubArray.push_back( iF );
+            fOTree_SubArray.push_back( iT );
+        }
+    }
+
+    // columnar copy of the event data (RNTuple)
+    if( fTLRunParameter->fWriteRNTuple > 0 )
+    {
+#ifdef RUNWITHRNTUPLE
+        fORNTuple = new VRNTupleWriter();
+        if( !fORNTuple->initialize( fOTree, fOutFile, "data_rntuple", fTLRunParameter->fRNTupleCompression ) )
+        {
+            cout << "VTableLookupDataHandler::setOutputFile error while defining RNTuple" << endl;
+            exit( EXIT_FAILURE );
+        }
+#else
+        cout << "VTableLookupDataHandler::setOutputFile warning: RNTuple output requires compilation with RNTUPLE=TRUE; ignored" << endl;
+#endif
+    }
+
     readRunParameter();
+    // copy run parameters to the output files of all subarrays
+    for( unsigned int s = 1; s < fOutFile_SubArray.size(); s++ )
+    {
+        fOutFile = fOutFile_SubArray[s];
+        readRunParameter();
+    }
+    if( fOutFile_SubArray.size() > 0 )
+    {
+        fOutFile = fOutFile_SubArray[0];
+    }
 
     return true;
 }
 
+/*
+ * output file name for a subarray
+ *
+ * e.g. 123456.mscw.root -> 123456.mscw.subarray3.root (subarray ID 3)
+ */
+string VTableLookupDataHandler::getSubArrayOutputFileName( string iOutput, unsigned int iSubArray )
+{
+    if( iSubArray >= fTLRunParameter->fSubArrayID.size() )
+    {
+        return iOutput;
+    }
+    ostringstream iFileName;
+    if( iOutput.size() > 5 && iOutput.substr( iOutput.size() - 5 ) == ".root" )
+    {
+        iFileName << iOutput.substr( 0, iOutput.size() - 5 );
+    }
+    else
+    {
+        iFileName << iOutput;
+    }
+    iFileName << ".subarray" << fTLRunParameter->fSubArrayID[iSubArray] << ".root";
+    return iFileName.str();
+}
+
 
 /*
  * read and update run parameters from eventdisplay file
@@ -2042,15 +2425,77 @@ void VTableLookupDataHandler::printCutStatistics()
 /*!
   write everything to disk
 */
+/*
+ * close all input files
+ *
+ * (table filling of several slices in one job: avoid keeping
+ *  the files of all slices open until the end of the job)
+ */
+void VTableLookupDataHandler::closeInputFiles()
+{
+    set< TTree* > iChains;
+    iChains.insert( fTshowerpars );
+    iChains.insert( fTshowerpars_QCCut );
+    iChains.insert( fDeepLearnerpars );
+    if( ftparsSparse )
+    {
+        iChains.insert( ftparsSparse->fChain );
+    }
+    for( unsigned int i = 0; i < ftpars.size(); i++ )
+    {
+        if( ftpars[i] )
+        {
+            iChains.insert( ftpars[i]->fChain );
+        }
+    }
+    for( set< TTree* >::iterator it = iChains.begin(); it != iChains.end(); ++it )
+    {
+        // (resetting a chain closes its current file)
+        if( *it )
+        {
+            ( *it )->Reset();
+        }
+    }
+}
+
 bool VTableLookupDataHandler::terminate( TNamed* iM )
 {
     printCutStatistics();
 
+    // subarray analysis: one output file per subarray
+    if( fOutFile_SubArray.size() > 0 )
+    {
+        for( unsigned int s = 0; s < fOutFile_SubArray.size(); s++ )
+        {
+            fOutFile = fOutFile_SubArray[s];
+            fOTree = fOTree_SubArray[s];
+            writeOutputFile( iM );
+        }
+    }
+    else
+    {
+        writeOutputFile( iM );
+    }
+
+    return true;
+}
+
+/*
+ * write data tree, run parameters, MC histograms etc. to the output file
+ */
+void VTableLookupDataHandler::writeOutputFile( TNamed* iM )
+{
     if( fOutFile )
     {
         cout << "writing data to " << fOutFile->GetName() << endl;
         fOutFile->cd();
 
+#ifdef RUNWITHRNTUPLE
+        if( fORNTuple )
+        {
+            fORNTuple->close();
+        }
+#endif
         cout << endl << "\t total number of events in output tree: " << fOTree->GetEntries() << endl << endl;
         fOTree->Write( "", TObject::kOverwrite );
 
@@ -2154,8 +2599,6 @@ bool VTableLookupDataHandler::terminate( TNamed* iM )
         cout << "...outputfile closed" << endl;
         cout << "(" << fOutFile->GetName() << ")" << endl;
     }
-
-    return true;
 }
 
 void VTableLookupDataHandler::writeDeadTimeHistograms()
@@ -25,6 +25,8 @@ VTableLookupRunParameter::VTableLookupRunParameter()
     bWriteReconstructedEventsOnly = 1;
     bShortTree = false;
     fWritePixelLists = false;
+    fWriteRNTuple = 0;
+    fRNTupleCompression = 505;
     bWriteMCPars = false;
     rec_method = 0;
     fWrite1DHistograms = false;
@@ -50,6 +52,9 @@ VTableLookupRunParameter::VTableLookupRunParameter()
     fDispError_BDTFileName = "";
     fDispError_BDTWeight = 5.;
     fTelescopeList_sim_telarray_Counting = "";
+    fSubArrayListFile = "";
+    fTableFillingSliceListFile = "";
+    fNThreads = 1;
     fTelescopeType_weightFile = "";
     fRunParameterFile = "";
     fQualityCutLevel = 0;
@@ -257,6 +262,28 @@ bool VTableLookupRunParameter::fillParameters( int argc, char* argv[] )
                 i++;
             }
         }
+        // list of subarrays (sim_telarray counting)
+        else if( iTemp.find( "-sub_array_list" ) < iTemp.size() )
+        {
+            if( iTemp2.size() > 0 )
+            {
+                fSubArrayListFile = iTemp2;
+                i++;
+            }
+        }
+        // list of slices for table filling (zenith angle, wobble offset, input files)
+        else if( iTemp.find( "-slicelist" ) < iTemp.size() )
+        {
+            if( iTemp2.size() > 0 )
+            {
+                fTableFillingSliceListFile = iTemp2;
+                i++;
+            }
+        }
+        else if( iTemp.find( "-nthreads" ) < iTemp.size() )
+        {
+            fNThreads = ( unsigned int )atoi( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
+        }
         // run parameters from file
         else if( iTemp.find( "-runparameter" ) < iTemp.size() )
         {
@@ -410,6 +437,32 @@ bool VTableLookupRunParameter::fillParameters( int argc, char* argv[] )
         {
             fWritePixelLists = true;
         }
+        else if( iTemp.find( "-rntuplecompression" ) < iTemp.size() )
+        {
+            if( iTemp.rfind( "=" ) != string::npos )
+            {
+                fRNTupleCompression = atoi( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
+            }
+        }
+        else if( iTemp.find( "-rntuple" ) < iTemp.size() )
+        {
+            if( iTemp.rfind( "=" ) != string::npos )
+            {
+                fWriteRNTuple = atoi( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
+            }
+            else
+            {
+                fWriteRNTuple = 1;
+            }
+            // downstream tools (anasum, makeEffectiveArea, compareDatawithMC, ...)
+            // read the data tree; it is therefore always written
+            if( fWriteRNTuple > 1 )
+            {
+                cout << "RNTuple-only output is not supported by all downstream tools; ";
+                cout << "writing data tree in addition to the RNTuple" << endl;
+                fWriteRNTuple = 1;
+            }
+        }
         else if( iTemp.find( "-pe" ) < iTemp.size() )
         {
             fPE = true;
@@ -450,6 +503,35 @@ bool VTableLookupRunParameter::fillParameters( int argc, char* argv[] )
     {
         isMC = true;
     }
+    // fill all slices of a list in one job
+    if( fTableFillingSliceListFile.size() > 0 )
+    {
+        if( !readTableFillingSliceList( fTableFillingSliceListFile ) )
+        {
+            cout << "exiting..." << endl;
+            exit( EXIT_FAILURE );
+        }
+        // telescope configuration is read from the first slice
+        if( inputfile.size() == 0 )
+        {
+            inputfile.push_back( fSliceInputFile[0] );
+        }
+    }
+    // incremental filling of existing tables and filling of slice lists
+    // (several slices might be filled into the same directory) require
+    // the 1D distributions
+    if( fWriteTables && ( writeoption == "update" || fSliceZe.size() > 0 ) && !fWrite1DHistograms )
+    {
+        if( writeoption == "update" )
+        {
+            cout << "updating existing lookup tables: writing 1D histograms to disk" << endl;
+        }
+        else
+        {
+            cout << "filling lookup tables for a list of slices: writing 1D histograms to disk" << endl;
+        }
+        fWrite1DHistograms = true;
+    }
     // =============================================
     // end of reading command line parameters
     // =============================================
@@ -525,7 +607,76 @@ bool VTableLookupRunParameter::fillParameters( int argc, char* argv[] )
 
     fillTelescopeTypeDependentWeights();
 
+    // analyse several subarrays in one pass (CTA only)
+    if( fSubArrayListFile.size() > 0 )
+    {
+        if( !readSubArrayList( fSubArrayListFile ) )
+        {
+            cout << "exiting..." << endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    return true;
+}
+
+/*
+ * read list of slices for table filling
+ *
+ * one slice per line:
+ *    <zenith angle [deg]> <wobble offset [deg]> <evndisp file(s) (wildcards allowed)>
+ *
+ * noise levels are determined from the input files (as for a single slice)
+ */
+bool VTableLookupRunParameter::readTableFillingSliceList( string iFile )
+{
+    fSliceZe.clear();
+    fSliceWobbleOffset.clear();
+    fSliceInputFile.clear();
+
+    if( !fWriteTables )
+    {
+        cout << "VTableLookupRunParameter::readTableFillingSliceList error: slice lists are possible for table filling only" << endl;
+        return false;
+    }
+    ifstream is;
+    is.open( iFile.c_str(), ifstream::in );
+    if( !is )
+    {
+        cout << "VTableLookupRunParameter::readTableFillingSliceList error: file with slice list not found: ";
+        cout << iFile << endl;
+        return false;
+    }
+    cout << "reading list of table filling slices from " << iFile << endl;
+    string iLine;
+    while( getline( is, iLine ) )
+    {
+        if( iLine.size() == 0 || iLine.substr( 0, 1 ) == "#" )
+        {
+            continue;
+        }
+        istringstream is_stream( iLine );
+        double iZe = 0.;
+        double iWoff = 0.;
+        string iInputFile;
+        if( !( is_stream >> iZe >> iWoff >> iInputFile ) )
+        {
+            cout << "VTableLookupRunParameter::readTableFillingSliceList error: invalid line: " << iLine << endl;
+            return false;
+        }
+        fSliceZe.push_back( iZe );
+        // wobble offset in directory naming (as for -woff)
+        fSliceWobbleOffset.push_back( ( int )( iWoff * 1000 + 0.5 ) );
+        fSliceInputFile.push_back( iInputFile );
+    }
+    is.close();
 
+    if( fSliceZe.size() == 0 )
+    {
+        cout << "VTableLookupRunParameter::readTableFillingSliceList error: no slices found in " << iFile << endl;
+        return false;
+    }
+    cout << "\t found " << fSliceZe.size() << " slices" << endl;
     return true;
 }
 
@@ -773,6 +924,108 @@ bool VTableLookupRunParameter::readTelescopeToAnalyze( string iTelescopeList_sim
     return true;
 }
 
+/*
+ * read list of subarrays to be analysed in one pass
+ *
+ * one subarray per line: subarray ID followed by the list of
+ * telescopes (sim_telarray counting, as for -sub_array_sim_telarray_counting)
+ *
+ * e.g. 3 1 2 3 4 15 16
+ *
+ * lines starting with '#' are ignored
+ */
+bool VTableLookupRunParameter::readSubArrayList( string iFile )
+{
+    fSubArrayID.clear();
+    fSubArrayTelescopes.clear();
+
+    if( fWriteTables )
+    {
+        cout << "VTableLookupRunParameter::readSubArrayList error: subarray lists are not possible for table filling" << endl;
+        return false;
+    }
+    if( fTelToAnalyzeData.size() == 0 )
+    {
+        cout << "VTableLookupRunParameter::readSubArrayList error: no telescope configuration found" << endl;
+        return false;
+    }
+    ifstream is;
+    is.open( iFile.c_str(), ifstream::in );
+    if( !is )
+    {
+        cout << "VTableLookupRunParameter::readSubArrayList error: file with subarray list not found: ";
+        cout << iFile << endl;
+        return false;
+    }
+    cout << "reading list of subarrays from " << iFile << endl;
+    string iLine;
+    while( getline( is, iLine ) )
+    {
+        if( iLine.size() == 0 || iLine.substr( 0, 1 ) == "#" )
+        {
+            continue;
+        }
+        istringstream is_stream( iLine );
+        int iID = 0;
+        if( !( is_stream >> iID ) )
+        {
+            continue;
+        }
+        vector< unsigned int > iTel;
+        unsigned int iT = 0;
+        while( is_stream >> iT )
+        {
+            bool bFound = false;
+            for( unsigned int t = 0; t < fTelToAnalyzeData.size(); t++ )
+            {
+                if( fTelToAnalyzeData[t] && fTelToAnalyzeData[t]->fTelID_hyperArray == iT )
+                {
+                    // telescopes removed with -sub_array_sim_telarray_counting stay removed
+                    if( fTelToAnalyzeData[t]->fTelToAnalyze )
+                    {
+                        iTel.push_back( t );
+                    }
+                    bFound = true;
+                    break;
+                }
+            }
+            if( !bFound )
+            {
+                cout << "VTableLookupRunParameter::readSubArrayList error: telescope " << iT;
+                cout << " (subarray " << iID << ") not found in telescope configuration" << endl;
+                return false;
+            }
+        }
+        fSubArrayID.push_back( iID );
+        fSubArrayTelescopes.push_back( iTel );
+    }
+    is.close();
+
+    if( fSubArrayID.size() == 0 )
+    {
+        cout << "VTableLookupRunParameter::readSubArrayList error: no subarrays found in " << iFile << endl;
+        return false;
+    }
+    // direction and core are calculated for each subarray
+    fRerunStereoReconstruction = true;
+    // events failing the reconstruction cuts are not written
+    // (the image parameters are shared by all subarrays of an event)
+    bNoNoTrigger = false;
+    // one output file per subarray (data tree only)
+    if( fWriteRNTuple > 0 )
+    {
+        cout << "VTableLookupRunParameter::readSubArrayList: RNTuple output not available for subarray analysis; ignored" << endl;
+        fWriteRNTuple = 0;
+    }
+    if( fWritePixelLists )
+    {
+        cout << "VTableLookupRunParameter::readSubArrayList: pixel lists not available for subarray analysis; ignored" << endl;
+        fWritePixelLists = false;
+    }
+
+    return true;
+}
+
 /*
  * read telescope combination for analysis
  *
@@ -936,12 +1189,29 @@ void VTableLookupRunParameter::print( int iP )
         {
             cout << "writing reconstructed events only (" << bWriteReconstructedEventsOnly << ")" << endl;
         }
+        if( fWriteRNTuple > 0 )
+        {
+            cout << "writing event data as RNTuple (mode " << fWriteRNTuple << ", compression " << fRNTupleCompression << ")" << endl;
+        }
+        if( fSubArrayID.size() > 0 )
+        {
+            cout << "analysing " << fSubArrayID.size() << " subarrays (from " << fSubArrayListFile << "; one output file per subarray)" << endl;
+        }
     }
     else
     {
         cout << "filling lookup tables for: ";
         cout << " zenith " << ze << ", direction offset " << fWobbleOffset << "(x0.01) [deg], ";
         cout << "noise level " << fNoiseLevel << ", spectral index " << fSpectralIndex << endl;
+        if( fSliceZe.size() > 0 )
+        {
+            cout << "filling " << fSliceZe.size() << " slices (from " << fTableFillingSliceListFile << ")";
+            cout << " with " << fNThreads << " thread(s)" << endl;
+        }
+        if( writeoption == "update" )
+        {
+            cout << "updating existing lookup table file" << endl;
+        }
         if( fWrite1DHistograms )
         {
             cout << "write 1D histograms to disk" << endl;
@@ -20,6 +20,7 @@ VTablesToRead::VTablesToRead( unsigned int n_tabletypes, int iNTel )
         }
         hMedian[t] = i_hnull;
         hSigma[t]  = i_hnull;
+        hCompiledMedian[t] = vector< const VCompiledLookupTable* >( fNTel, 0 );
         
         value_T[t]       = new double[fNTel];
         value_T_sigma[t] = new double[fNTel];
@@ -34,6 +35,15 @@ VTablesToRead::VTablesToRead( unsigned int n_tabletypes, int iNTel )
     
 }
 
+VTablesToRead::~VTablesToRead()
+{
+    for( unsigned int t = 0; t < fNLT_types; t++ )
+    {
+        delete [] value_T[t];
+        delete [] value_T_sigma[t];
+    }
+}
+
 
 void VTablesToRead::reset()
 {
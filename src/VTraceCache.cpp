@@ -0,0 +1,124 @@
+/*! \class VTraceCache
+    \brief per-telescope buffer of decoded FADC traces
+    
+    traces are decoded from the raw data reader, low-gain scaled and
+    (optionally) digitally filtered once per event and channel; all
+    following calls to VTraceHandler::setTrace() for the same channel
+    and settings read the trace from this buffer
+    
+    all traces are kept in one contiguous array (one block per channel);
+    entries are invalidated by incrementing the event counter (no clearing
+    of the buffer between events)
+    
+    traces are stored as in VTraceHandler, i.e. including the pedestal
+    (the pedestal used for decoding is part of the cache key)
+
+*/
+
+#include "VTraceCache.h"
+
+VTraceCacheEntry::VTraceCacheEntry()
+{
+    fEvent = 0;
+    fNSamples = 0;
+    fLength = 0;
+    fPed = 0.;
+    fHiLo = 0.;
+    fDF_method = 0;
+    fDF_upsample = 0;
+    fDF_polezero = 0.;
+    fDF_tracemax = 0.;
+    fSumWindowFirst = 0;
+    fSumWindowLast = 0;
+}
+
+VTraceCache::VTraceCache()
+{
+    fNChannels = 0;
+    fStride = 0;
+    fEvent = 1;
+}
+
+void VTraceCache::initialize( unsigned int iNChannels, unsigned int iNSamples )
+{
+    fNChannels = iNChannels;
+    fStride = iNSamples;
+    fEvent = 1;
+    fTrace.assign( fNChannels * fStride, 0. );
+    fEntry.assign( fNChannels, VTraceCacheEntry() );
+}
+
+/*
+ * invalidate all entries
+ */
+void VTraceCache::newEvent()
+{
+    fEvent++;
+    // counter overflow: reset entries
+    if( fEvent == 0 )
+    {
+        fEntry.assign( fNChannels, VTraceCacheEntry() );
+        fEvent = 1;
+    }
+}
+
+/*
+ * increase space per channel (e.g. for upsampled traces);
+ * valid entries are kept
+ */
+void VTraceCache::resizeStride( unsigned int iStride )
+{
+    vector< double > iTrace( fNChannels * iStride, 0. );
+    for( unsigned int i = 0; i < fNChannels; i++ )
+    {
+        if( fEntry[i].fEvent == fEvent )
+        {
+            for( unsigned int s = 0; s < fEntry[i].fLength; s++ )
+            {
+                iTrace[i * iStride + s] = fTrace[i * fStride + s];
+            }
+        }
+    }
+    fTrace.swap( iTrace );
+    fStride = iStride;
+}
+
+/*
+ * store decoded trace for this channel and event
+ */
+bool VTraceCache::fill( unsigned int iChannel, const VTraceCacheEntry& iEntry, const vector< double >& iTrace )
+{
+    double* p = getBuffer( iChannel, iEntry, iTrace.size() );
+    if( !p )
+    {
+        return false;
+    }
+    for( unsigned int s = 0; s < iTrace.size(); s++ )
+    {
+        p[s] = iTrace[s];
+    }
+    
+    return true;
+}
+
+/*
+ * mark entry for this channel as valid and return the buffer to be
+ * filled with iLength samples
+ * (pointer is valid until the next call of getBuffer() or fill())
+ */
+double* VTraceCache::getBuffer( unsigned int iChannel, const VTraceCacheEntry& iEntry, unsigned int iLength )
+{
+    if( iChannel >= fNChannels || iLength == 0 )
+    {
+        return 0;
+    }
+    if( iLength > fStride )
+    {
+        resizeStride( iLength );
+    }
+    fEntry[iChannel] = iEntry;
+    fEntry[iChannel].fEvent = fEvent;
+    fEntry[iChannel].fLength = iLength;
+    
+    return &fTrace[iChannel * fStride];
+}
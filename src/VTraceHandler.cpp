@@ -41,8 +41,12 @@ void VTraceHandler::reset()
     analysis routines call this function
 
     (generally, this function is called)
+    
+    iTraceCache: per-telescope buffer of decoded traces; traces are decoded
+    only once per event for given pedestal, gain and digital filter settings
 */
-void VTraceHandler::setTrace( VVirtualDataReader* iReader, unsigned int iNSamples, double ped, unsigned int iChanID, unsigned int iHitID, double iHiLo )
+void VTraceHandler::setTrace( VVirtualDataReader* iReader, unsigned int iNSamples, double ped, unsigned int iChanID, unsigned int iHitID, double iHiLo,
+                              VTraceCache* iTraceCache )
 {
     fPed = ped;
     fChanID = iChanID;
@@ -55,21 +59,62 @@ void VTraceHandler::setTrace( VVirtualDataReader* iReader, unsigned int iNSample
         return;
     }
     
+    ///////////////////////////////////////
+    // trace decoded before in this event
+    if( iTraceCache )
+    {
+        const VTraceCacheEntry* i_entry = iTraceCache->find( fChanID, getTraceCacheKey( iNSamples, fPed, iHiLo ) );
+        if( i_entry )
+        {
+            const double* i_trace = iTraceCache->getTrace( fChanID );
+            fpTrace.assign( i_trace, i_trace + i_entry->fLength );
+            fpTrazeSize = fpTrace.size();
+            fHiLo = ( iHiLo > 0. );
+            fDF_tracemax = i_entry->fDF_tracemax;
+            fSumWindowFirst = i_entry->fSumWindowFirst;
+            fSumWindowLast = i_entry->fSumWindowLast;
+            return;
+        }
+    }
+    
     ///////////////////////////////////////
     // copy trace from raw data reader
-    if( iNSamples != fpTrace.size() )
+    // (direct access to the decoded samples if provided by the reader)
+    bool i_filled = false;
+    if( iReader->has16Bit() )
     {
-        fpTrace.clear();
-        for( unsigned int i = 0; i < iNSamples; i++ )
+        VDataSpan< uint16_t > i_samples = iReader->getSamplesSpan16Bit( iHitID );
+        if( i_samples.size() >= iNSamples + fMC_FADCTraceStart )
         {
-            fpTrace.push_back( iReader->getSample_double( iHitID, i + fMC_FADCTraceStart, ( i == 0 ) ) );
+            fillTrace( i_samples, iNSamples, fMC_FADCTraceStart );
+            i_filled = true;
         }
     }
-    else for( unsigned int i = 0; i < iNSamples; i++ )
+    else
+    {
+        VDataSpan< uint8_t > i_samples = iReader->getSamplesSpan( iHitID );
+        if( i_samples.size() >= iNSamples + fMC_FADCTraceStart )
         {
-            fpTrace[i] = iReader->getSample_double( iHitID, i + fMC_FADCTraceStart, ( i == 0 ) );
+            fillTrace( i_samples, iNSamples, fMC_FADCTraceStart );
+            i_filled = true;
         }
-        
+    }
+    if( !i_filled )
+    {
+        if( iNSamples != fpTrace.size() )
+        {
+            fpTrace.clear();
+            for( unsigned int i = 0; i < iNSamples; i++ )
+            {
+                fpTrace.push_back( iReader->getSample_double( iHitID, i + fMC_FADCTraceStart, ( i == 0 ) ) );
+            }
+        }
+        else for( unsigned int i = 0; i < iNSamples; i++ )
+            {
+                fpTrace[i] = iReader->getSample_double( iHitID, i + fMC_FADCTraceStart, ( i == 0 ) );
+            }
+    }
+    
     fpTrazeSize = fpTrace.size();
     
     ////////////////////////////
@@ -83,34 +128,157 @@ void VTraceHandler::setTrace( VVirtualDataReader* iReader, unsigned int iNSample
     {
         apply_digitalFilter();
     }
+    
+    if( iTraceCache )
+    {
+        VTraceCacheEntry i_entry = getTraceCacheKey( iNSamples, fPed, iHiLo );
+        i_entry.fDF_tracemax = fDF_tracemax;
+        i_entry.fSumWindowFirst = fSumWindowFirst;
+        i_entry.fSumWindowLast = fSumWindowLast;
+        iTraceCache->fill( fChanID, i_entry, fpTrace );
+    }
 }
 
 /*
- *  used only for time jitter calibration
+ * settings which determine the decoded trace
+ * (used as key for the trace cache)
+ */
+VTraceCacheEntry VTraceHandler::getTraceCacheKey( unsigned int iNSamples, double iPed, double iHiLo )
+{
+    VTraceCacheEntry i_key;
+    i_key.fNSamples = iNSamples;
+    i_key.fPed = iPed;
+    i_key.fHiLo = ( iHiLo > 0. ? iHiLo : 0. );
+    i_key.fDF_method = fDF_method;
+    if( fDF_method > 0 )
+    {
+        i_key.fDF_upsample = fDF_upsample;
+        i_key.fDF_polezero = fDF_polezero;
+    }
+    return i_key;
+}
+
+/*
+ * decode, low-gain scale and digitally filter all given channels
+ * of an event together and store them in the trace cache
+ *
+ * (traces are identical to the ones from setTrace(); channels without
+ *  direct access to the samples are left for setTrace())
  *
+ * returns number of channels filled
  */
-void VTraceHandler::setTrace( vector<uint16_t> pTrace, double ped, unsigned int iChanID, double iHiLo )
+unsigned int VTraceHandler::fillTraceCache( VVirtualDataReader* iReader, unsigned int iNSamples,
+        const vector< unsigned int >& iHitID, const vector< unsigned int >& iChanID,
+        const vector< double >& iPed, const vector< double >& iHiLo,
+        VTraceCache* iTraceCache )
 {
-    fPed = ped;
-    fChanID = iChanID;
-    reset();
-    // copy trace
-    unsigned int i_tsize = pTrace.size();
-    if( i_tsize != fpTrace.size() )
+    if( !iReader || !iTraceCache || fDF_method == 0 || fDF_upsample == 0 || iNSamples == 0 )
     {
-        fpTrace.clear();
-        for( unsigned int i = 0; i < i_tsize; i++ )
+        return 0;
+    }
+    unsigned int nChannels = iHitID.size();
+    fDF_input.resize( nChannels * iNSamples );
+    fDF_baseline.resize( nChannels );
+    vector< unsigned int > i_index;
+    i_index.reserve( nChannels );
+    
+    ///////////////////////////////////////
+    // decode and apply hi-lo gain ratio
+    // (in double precision as in setTrace)
+    bool i_16Bit = iReader->has16Bit();
+    double i_sample = 0.;
+    for( unsigned int c = 0; c < nChannels && c < iChanID.size() && c < iPed.size() && c < iHiLo.size(); c++ )
+    {
+        if( iTraceCache->find( iChanID[c], getTraceCacheKey( iNSamples, iPed[c], iHiLo[c] ) ) )
+        {
+            continue;
+        }
+        VDataSpan< uint16_t > i_samples16Bit;
+        VDataSpan< uint8_t > i_samples;
+        if( i_16Bit )
+        {
+            i_samples16Bit = iReader->getSamplesSpan16Bit( iHitID[c] );
+            if( i_samples16Bit.size() < iNSamples + fMC_FADCTraceStart )
+            {
+                continue;
+            }
+        }
+        else
+        {
+            i_samples = iReader->getSamplesSpan( iHitID[c] );
+            if( i_samples.size() < iNSamples + fMC_FADCTraceStart )
+            {
+                continue;
+            }
+        }
+        float* i_in = &fDF_input[i_index.size() * iNSamples];
+        for( unsigned int i = 0; i < iNSamples; i++ )
         {
-            fpTrace.push_back( ( double )pTrace[i] );
+            if( i_16Bit )
+            {
+                i_sample = ( double )i_samples16Bit[i + fMC_FADCTraceStart];
+            }
+            else
+            {
+                i_sample = ( double )i_samples[i + fMC_FADCTraceStart];
+            }
+            if( iHiLo[c] > 0. )
+            {
+                i_sample  = ( i_sample - iPed[c] ) * iHiLo[c];
+                i_sample += iPed[c];
+            }
+            i_in[i] = i_sample;
         }
+        fDF_baseline[i_index.size()] = iPed[c];
+        i_index.push_back( c );
     }
-    else for( unsigned int i = 0; i < i_tsize; i++ )
+    if( i_index.size() == 0 )
+    {
+        return 0;
+    }
+    
+    ///////////////////////////////////////
+    // filter all channels
+    fDF_filter.setParameters( fDF_upsample, fDF_polezero );
+    unsigned int nOut = iNSamples * fDF_upsample;
+    fDF_output.resize( i_index.size() * nOut );
+    fDF_max.resize( i_index.size() );
+    fDF_at.resize( i_index.size() );
+    fDF_filter.filter( i_index.size(), iNSamples, &fDF_input[0], &fDF_baseline[0],
+                       &fDF_output[0], &fDF_max[0], &fDF_at[0] );
+    
+    ///////////////////////////////////////
+    // fill trace cache
+    unsigned int nFilled = 0;
+    for( unsigned int t = 0; t < i_index.size(); t++ )
+    {
+        unsigned int c = i_index[t];
+        VTraceCacheEntry i_entry = getTraceCacheKey( iNSamples, iPed[c], iHiLo[c] );
+        i_entry.fDF_tracemax = fDF_max[t];
+        i_entry.fSumWindowFirst = ( unsigned int )fDF_at[t];
+        i_entry.fSumWindowLast = i_entry.fSumWindowFirst + 1;
+        double* i_trace = iTraceCache->getBuffer( iChanID[c], i_entry, nOut );
+        if( !i_trace )
         {
-            fpTrace[i] = ( double )pTrace[i];
+            continue;
         }
-        
-    fpTrazeSize = fpTrace.size();
-    fHiLo = apply_lowgain( iHiLo );
+        const float* i_out = &fDF_output[t * nOut];
+        for( unsigned int i = 0; i < nOut; i++ )
+        {
+            i_trace[i] = i_out[i] + iPed[c];
+        }
+        nFilled++;
+    }
+    return nFilled;
+}
+
+/*
+ *  used only for time jitter calibration
+ *
+ */
+void VTraceHandler::setTrace( vector<uint16_t> pTrace, double ped, unsigned int iChanID, double iHiLo )
+{
+    setTrace( VDataSpan< uint16_t >( pTrace.size() > 0 ? &pTrace[0] : 0, pTrace.size() ), ped, iChanID, iHiLo );
 }
 
 /*
@@ -118,29 +286,29 @@ void VTraceHandler::setTrace( vector<uint16_t> pTrace, double ped, unsigned int
  *
  */
 void VTraceHandler::setTrace( vector<uint8_t> pTrace, double ped, unsigned int iChanID, double iHiLo )
+{
+    setTrace( VDataSpan< uint8_t >( pTrace.size() > 0 ? &pTrace[0] : 0, pTrace.size() ), ped, iChanID, iHiLo );
+}
+
+/*
+ *  set trace from a view of the samples in the data reader
+ *  (no intermediate copy of the samples)
+ */
+void VTraceHandler::setTrace( const VDataSpan< uint16_t >& pTrace, double ped, unsigned int iChanID, double iHiLo )
 {
     fPed = ped;
     fChanID = iChanID;
     reset();
-    // copy trace
-    unsigned int i_tsize = pTrace.size();
-    if( i_tsize != fpTrace.size() )
-    {
-        fpTrace.clear();
-        for( unsigned int i = 0; i < i_tsize; i++ )
-        {
-            fpTrace.push_back( ( double )pTrace[i] );
-        }
-    }
-    else
-    {
-        for( unsigned int i = 0; i < i_tsize; i++ )
-        {
-            fpTrace[i] = ( double )pTrace[i];
-        }
-    }
-    
-    fpTrazeSize = fpTrace.size();
+    fillTrace( pTrace, pTrace.size(), 0 );
+    fHiLo = apply_lowgain( iHiLo );
+}
+
+void VTraceHandler::setTrace( const VDataSpan< uint8_t >& pTrace, double ped, unsigned int iChanID, double iHiLo )
+{
+    fPed = ped;
+    fChanID = iChanID;
+    reset();
+    fillTrace( pTrace, pTrace.size(), 0 );
     fHiLo = apply_lowgain( iHiLo );
 }
 
@@ -709,32 +877,36 @@ double VTraceHandler::calculateTraceSum_slidingWindow( unsigned int iSearchStart
 
 bool VTraceHandler::apply_digitalFilter()
 {
-    // not opimized for speed, but try to use the FlashCam routines
-    // in its orginal versions
+    // use the FlashCam routines in its orginal versions
+    // (see fillTraceCache() for filtering of all channels of an event)
     
     // input
     int n  = ( int )fpTrace.size();
-    float* ip = new float[fpTrace.size()];
+    if( n == 0 || fDF_upsample == 0 )
+    {
+        return false;
+    }
     int us = fDF_upsample;
     float bl = fPed;
     float pz = fDF_polezero;
-    for( unsigned int t = 0; t < fpTrace.size(); t++ )
+    fDF_input.resize( n );
+    for( int t = 0; t < n; t++ )
     {
-        ip[t] = fpTrace[t];
+        fDF_input[t] = fpTrace[t];
     }
     
     // results
-    float* op = new float[fpTrace.size()*fDF_upsample];
+    fDF_output.resize( n * us );
     float max = 0.;
     int   at  = 0;
     
     // filter
-    PzpsaSmoothUpsampleFloat( n, us, ip, bl, pz, op, &max, &at );
+    PzpsaSmoothUpsampleFloat( n, us, &fDF_input[0], bl, pz, &fDF_output[0], &max, &at );
     
-    fpTrace.clear();
+    fpTrace.resize( n * us );
     for( int i = 0; i < n * us; i++ )
     {
-        fpTrace.push_back( op[i] + fPed );
+        fpTrace[i] = fDF_output[i] + fPed;
     }
     fpTrazeSize = fpTrace.size();
     
@@ -742,9 +914,6 @@ bool VTraceHandler::apply_digitalFilter()
     fSumWindowFirst = ( unsigned int )at;
     fSumWindowLast  = fSumWindowFirst + 1;
     
-    delete[] ip;
-    delete[] op;
-    
     return true;
 }
 
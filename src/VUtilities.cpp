@@ -235,3 +235,70 @@ unsigned int VUtilities::count_number_of_textblocks( string str )
     
     return z;
 }
+
+/*
+ * MD5 sum of the contents of a tree (all leaf values of all entries)
+ *
+ * used to test if e.g. detector configuration or calibration trees
+ * of two files are identical
+ */
+string VUtilities::getTreeMD5( TTree* iTree )
+{
+    if( !iTree )
+    {
+        return "";
+    }
+    TMD5 iMD5;
+    TObjArray* iLeaves = iTree->GetListOfLeaves();
+    for( int l = 0; l < iLeaves->GetEntriesFast(); l++ )
+    {
+        string iName = iLeaves->At( l )->GetName();
+        iMD5.Update( ( const UChar_t* )iName.c_str(), ( UInt_t )iName.size() );
+    }
+    for( Long64_t n = 0; n < iTree->GetEntries(); n++ )
+    {
+        iTree->GetEntry( n );
+        for( int l = 0; l < iLeaves->GetEntriesFast(); l++ )
+        {
+            TLeaf* iLeaf = ( TLeaf* )iLeaves->At( l );
+            if( !iLeaf )
+            {
+                continue;
+            }
+            if( iLeaf->IsA() == TLeafC::Class() )
+            {
+                string iValue = ( ( TLeafC* )iLeaf )->GetValueString();
+                iMD5.Update( ( const UChar_t* )iValue.c_str(), ( UInt_t )iValue.size() );
+                continue;
+            }
+            for( int j = 0; j < iLeaf->GetLen(); j++ )
+            {
+                double iValue = iLeaf->GetValue( j );
+                iMD5.Update( ( const UChar_t* )&iValue, ( UInt_t )sizeof( double ) );
+            }
+        }
+    }
+    iMD5.Final();
+    
+    return iMD5.AsString();
+}
+
+/*
+ * MD5 sum of the points of a graph
+ */
+string VUtilities::getGraphMD5( TGraph* iGraph )
+{
+    if( !iGraph )
+    {
+        return "";
+    }
+    TMD5 iMD5;
+    for( int i = 0; i < iGraph->GetN(); i++ )
+    {
+        double iValue[2] = { iGraph->GetX()[i], iGraph->GetY()[i] };
+        iMD5.Update( ( const UChar_t* )iValue, ( UInt_t )sizeof( iValue ) );
+    }
+    iMD5.Final();
+    
+    return iMD5.AsString();
+}
@@ -32,6 +32,8 @@ string datadir = "";
 string fRunParameterfile = "ANASUM.runparameter";
 // for usage of random generators: see VStereoMaps.cpp
 int fRandomSeed = 17;
+// cache directory with run-wise results for incremental analysis (run type 0 only)
+string fCacheDirectory = "";
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /*
@@ -86,6 +88,21 @@ int main( int argc, char* argv[] )
         exit( EXIT_FAILURE );
     }
     
+    // incremental analysis: analyse new or modified runs only
+    // and combine run-wise results from cache directory
+    if( runType == 0 && fCacheDirectory.size() > 0 )
+    {
+        VAnaSum* iRunCache = new VAnaSum( datadir );
+        if( !iRunCache->updateRunCache( listfilename, fCacheDirectory, fRandomSeed, fRunParameterfile ) )
+        {
+            cout << "error updating run-wise results in cache directory " << fCacheDirectory << endl;
+            exit( EXIT_FAILURE );
+        }
+        delete iRunCache;
+        datadir = fCacheDirectory;
+        runType = 1;
+    }
+    
     // initialize analysis
     VAnaSum* anasum = new VAnaSum( datadir );
     anasum->initialize( listfilename, runType, outfile, fRandomSeed, fRunParameterfile );
@@ -118,10 +135,11 @@ int parseOptions( int argc, char* argv[] )
             {"randomseed", required_argument, 0, 'r'},
             {"runType", required_argument, 0, 'i'},
             {"parameterfile",  required_argument, 0, 'f'},
+            {"cachedir", required_argument, 0, 'c'},
             {0, 0, 0, 0}
         };
         int option_index = 0;
-        int c = getopt_long( argc, argv, "h:l:k:m:o:d:s:r:i:u:f:g", long_options, &option_index );
+        int c = getopt_long( argc, argv, "h:l:k:m:o:d:s:r:i:u:f:c:g", long_options, &option_index );
         if( optopt != 0 )
         {
             cout << "error: unknown option" << endl;
@@ -182,6 +200,9 @@ int parseOptions( int argc, char* argv[] )
             case 'f':
                 fRunParameterfile = optarg;
                 break;
+            case 'c':
+                fCacheDirectory = optarg;
+                break;
             case '?':
                 break;
             default:
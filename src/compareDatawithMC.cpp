@@ -7,13 +7,18 @@
 #include "VGlobalRunParameter.h"
 #include "VDataMCComparision.h"
 
+#include "TChainElement.h"
 #include "TFile.h"
+#include "TROOT.h"
 #include "TTree.h"
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace std;
@@ -85,6 +90,30 @@ double getTelescopePositions( string iF, vector< double >& iX, vector< double >&
     return r_max;
 }
 
+/*
+ * list of files matching a file name (wildcards allowed)
+ *
+ */
+vector< string > getListOfFiles( string iF )
+{
+    vector< string > iFiles;
+    TChain c( "data" );
+    if( !c.Add( iF.c_str() ) )
+    {
+        return iFiles;
+    }
+    TObjArray* iFileElements = c.GetListOfFiles();
+    if( iFileElements )
+    {
+        TIter next( iFileElements );
+        while( TChainElement* iChainElement = ( TChainElement* )next() )
+        {
+            iFiles.push_back( iChainElement->GetTitle() );
+        }
+    }
+    return iFiles;
+}
+
 /*
  * read input parameters, MC and data files from a configuration file
  *
@@ -206,7 +235,7 @@ int main( int argc, char* argv[] )
         cout << "(e.g. from Crab Nebula or Mrk 421 observations)" << endl;
         cout << endl;
         cout << endl;
-        cout << "compareDatawithMC <input file list> <cut> <outputfile> [BDT gamma/hadron cuts] [shower max zenith angle (default=20deg)]" << endl;
+        cout << "compareDatawithMC <input file list> <cut> <outputfile> [BDT gamma/hadron cuts] [shower max zenith angle (default=20deg)] [number of threads]" << endl;
         cout << endl;
         cout << "\t input file list: see example file COMPAREMC.runparameter in the parameter files directory" << endl;
         cout << "\t cuts: " << endl;
@@ -222,6 +251,9 @@ int main( int argc, char* argv[] )
         cout << "\t use BDT cuts for gamma/hadron separation: 0 = no (default), 1 = yes" << endl;
         cout << "\t cut file needs to be indicated within VDataMCComparision::initialGammaHadronCuts()" << endl;
         cout << endl;
+        cout << "\t number of threads: files of all data runs and simulations are read in parallel" << endl;
+        cout << "\t                    (default = 1; 0 = number of cores)" << endl;
+        cout << endl;
         cout << "Note: most cuts are hardwired in VDataMCComparision::fillHistograms()" << endl;
         cout << endl;
         exit( EXIT_SUCCESS );
@@ -246,6 +278,25 @@ int main( int argc, char* argv[] )
     {
         fShowerMaxZe_deg = atof( argv[5] );
     }
+    unsigned int fNThreads = 1;
+    if( argc > 6 )
+    {
+        fNThreads = ( unsigned int )atoi( argv[6] );
+        if( fNThreads == 0 )
+        {
+            fNThreads = thread::hardware_concurrency();
+        }
+        if( fNThreads < 1 )
+        {
+            fNThreads = 1;
+        }
+    }
+    if( fNThreads > 1 )
+    {
+        ROOT::EnableThreadSafety();
+        // histograms of the accumulators are not attached to any directory
+        TH1::AddDirectory( kFALSE );
+    }
     
     // test number of telescopes
     int iNT = 0;
@@ -331,8 +382,11 @@ int main( int argc, char* argv[] )
             fStereoCompare[i]->setAzimuthWeightingHistogram( hAzOn );
         }
         // fill histograms
-        fStereoCompare.back()->fillHistograms( fInputData[i].fFileName, fSingleTelescopeCuts );
-        fStereoCompare.back()->writeHistograms( fOutputfile );
+        if( fNThreads == 1 )
+        {
+            fStereoCompare.back()->fillHistograms( fInputData[i].fFileName, fSingleTelescopeCuts );
+            fStereoCompare.back()->writeHistograms( fOutputfile );
+        }
         
         if( fInputData[i].fType == "ON" )
         {
@@ -345,6 +399,73 @@ int main( int argc, char* argv[] )
         cout << endl;
     }
     
+    ////////////////////////////////////////////////
+    // parallel mode: all files of all inputs are filled by worker threads
+    // into private accumulators (one per thread and input), which are
+    // added to the histograms of each input at the end
+    if( fNThreads > 1 )
+    {
+        vector< pair< unsigned int, string > > iTasks;
+        for( unsigned int i = 0; i < fInputData.size(); i++ )
+        {
+            vector< string > iFiles = getListOfFiles( fInputData[i].fFileName );
+            if( iFiles.size() == 0 )
+            {
+                cout << "error while reading data chain: " << fInputData[i].fFileName << endl;
+                cout << "exiting..." << endl;
+                exit( EXIT_FAILURE );
+            }
+            for( unsigned int f = 0; f < iFiles.size(); f++ )
+            {
+                iTasks.push_back( make_pair( i, iFiles[f] ) );
+            }
+        }
+        if( fNThreads > iTasks.size() )
+        {
+            fNThreads = iTasks.size();
+        }
+        cout << "filling histograms from " << iTasks.size() << " files with " << fNThreads << " threads" << endl;
+        
+        vector< vector< VDataMCComparision* > > iAccumulator( fNThreads );
+        for( unsigned int t = 0; t < fNThreads; t++ )
+        {
+            for( unsigned int i = 0; i < fStereoCompare.size(); i++ )
+            {
+                iAccumulator[t].push_back( new VDataMCComparision( fStereoCompare[i] ) );
+            }
+        }
+        atomic< unsigned int > iCounter( 0 );
+        mutex iPrintMutex;
+        vector< thread > i_threads;
+        for( unsigned int t = 0; t < fNThreads; t++ )
+        {
+            i_threads.push_back( thread( [&, t]()
+            {
+                unsigned int n = 0;
+                while( ( n = iCounter++ ) < iTasks.size() )
+                {
+                    iAccumulator[t][iTasks[n].first]->fillHistograms( iTasks[n].second, fSingleTelescopeCuts );
+                    lock_guard< mutex > iLock( iPrintMutex );
+                    cout << "\t (" << fInputData[iTasks[n].first].fType << ") " << iTasks[n].second << endl;
+                }
+            } ) );
+        }
+        for( unsigned int t = 0; t < i_threads.size(); t++ )
+        {
+            i_threads[t].join();
+        }
+        // merge accumulators (fixed order)
+        for( unsigned int i = 0; i < fStereoCompare.size(); i++ )
+        {
+            for( unsigned int t = 0; t < fNThreads; t++ )
+            {
+                fStereoCompare[i]->addHistograms( iAccumulator[t][i] );
+            }
+            fStereoCompare[i]->writeHistograms( fOutputfile );
+        }
+        cout << endl;
+    }
+    
     ////////////////////////////////////////
     // calculate difference histograms
     cout << "DIFF" << endl;
@@ -0,0 +1,68 @@
+/*! \file compileLookupTables
+    \brief compile a lookup table file into a binary, memory-mappable table file
+    
+    compiled table files are read by mscw_energy in the same way as
+    ROOT lookup table files (-tablefile <compiled file>)
+
+*/
+
+#include "VCompiledLookupTableFile.h"
+#include "VGlobalRunParameter.h"
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main( int argc, char* argv[] )
+{
+    // print version only
+    if( argc == 2 )
+    {
+        string fCommandLine = argv[1];
+        if( fCommandLine == "-v" || fCommandLine == "--version" )
+        {
+            VGlobalRunParameter fRunPara;
+            cout << fRunPara.getEVNDISP_VERSION() << endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+    
+    VGlobalRunParameter* iT = new VGlobalRunParameter();
+    cout << endl;
+    cout << "compileLookupTables (" << iT->getEVNDISP_VERSION() << ")" << endl;
+    cout << "-----------------------------" << endl;
+    cout << endl;
+    
+    // print help
+    if( argc < 3 )
+    {
+        cout << "compile a lookup table file into a binary table file for fast (memory-mapped) reading" << endl << endl;
+        cout << "compileLookupTables <input table file name> <output file name>" << endl;
+        cout << endl;
+        cout << "(compiled table files are machine dependent: compile on the same platform used for mscw_energy)" << endl;
+        cout << endl;
+        exit( EXIT_SUCCESS );
+    }
+    string fIFile = argv[1];
+    string fOFile = argv[2];
+    
+    if( !VCompiledLookupTableFile::compile( fIFile, fOFile ) )
+    {
+        cout << "error compiling lookup table file " << fIFile << endl;
+        exit( EXIT_FAILURE );
+    }
+    
+    // test reading of compiled file
+    VCompiledLookupTableFile iCompiledFile;
+    if( !iCompiledFile.open( fOFile ) )
+    {
+        cout << "error reading compiled lookup table file " << fOFile << endl;
+        exit( EXIT_FAILURE );
+    }
+    cout << "number of tables in compiled file: " << iCompiledFile.getNTables() << endl;
+    iCompiledFile.close();
+    
+    cout << endl;
+    cout << "finished..." << endl;
+}
@@ -12,9 +12,18 @@
 #include <TSystem.h>
 #include <TStopwatch.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include "VDisplay.h"
 #include "VEventLoop.h"
 #include "VReadRunParameter.h"
@@ -24,6 +33,335 @@ using namespace std;
 // fitter for log likelihood, has to be global
 TMinuit* fLLFitter;
 
+/*
+ * read list of input files for queue mode
+ *
+ * iQueue is either a text file with one file name per line
+ * or a directory (all files in this directory are analysed)
+ */
+vector< string > readQueue( string iQueue )
+{
+    vector< string > iFiles;
+    
+    FileStat_t iStat;
+    if( gSystem->GetPathInfo( iQueue.c_str(), iStat ) != 0 )
+    {
+        cout << "evndisp queue error: file or directory not found: " << iQueue << endl;
+        return iFiles;
+    }
+    // directory
+    if( R_ISDIR( iStat.fMode ) )
+    {
+        void* iDir = gSystem->OpenDirectory( iQueue.c_str() );
+        const char* iEntry = 0;
+        while( iDir && ( iEntry = gSystem->GetDirEntry( iDir ) ) )
+        {
+            string iName = iEntry;
+            if( iName.size() == 0 || iName[0] == '.' )
+            {
+                continue;
+            }
+            iName = iQueue + "/" + iName;
+            if( gSystem->GetPathInfo( iName.c_str(), iStat ) == 0 && !R_ISDIR( iStat.fMode ) )
+            {
+                iFiles.push_back( iName );
+            }
+        }
+        gSystem->FreeDirectory( iDir );
+        sort( iFiles.begin(), iFiles.end() );
+    }
+    // file list
+    else
+    {
+        ifstream is( iQueue.c_str() );
+        string is_line;
+        while( getline( is, is_line ) )
+        {
+            is_line.erase( 0, is_line.find_first_not_of( " \t" ) );
+            is_line.erase( is_line.find_last_not_of( " \t\r" ) + 1 );
+            if( is_line.size() > 0 && is_line[0] != '#' )
+            {
+                iFiles.push_back( is_line );
+            }
+        }
+    }
+    return iFiles;
+}
+
+/*
+ * queue status of each file (shared between queue workers)
+ */
+enum E_queueStatus { Q_PENDING = -1, Q_RUNNING = -2 };
+
+/*
+ * analyse queue files with one persistent event loop
+ *
+ * files are claimed one by one through the shared counter iQueue[0];
+ * status and worker process ID of file f are stored in iQueue[1+f] and
+ * iQueue[1+nfiles+f]
+ *
+ * the event loop is created for the first file only; for all other files
+ * VEventLoop::resetRun() resets the run dependent data (event counters,
+ * output file, pointing, DB pixel data, dead time, etc.) while the
+ * detector geometry, calibration data (incl. IPR graphs) and disp BDTs
+ * are reused as long as their input does not change
+ */
+void analyseQueueFiles( vector< vector< string > > iFileArgs, vector< string > iLogFiles, volatile int* iQueue, bool iWriteLogFiles )
+{
+    unsigned int iNFiles = iFileArgs.size();
+    VEventLoop* iEventLoop = 0;
+    VReadRunParameter* iReadRunParameter = 0;
+    for( ;; )
+    {
+        int f = __sync_fetch_and_add( &iQueue[0], 1 );
+        if( f < 0 || f >= ( int )iNFiles )
+        {
+            break;
+        }
+        iQueue[1 + f] = Q_RUNNING;
+        iQueue[1 + iNFiles + f] = ( int )getpid();
+        if( iWriteLogFiles )
+        {
+            cout.flush();
+            fflush( stdout );
+            if( !freopen( iLogFiles[f].c_str(), "w", stdout ) || !freopen( iLogFiles[f].c_str(), "a", stderr ) )
+            {
+                iQueue[1 + f] = EXIT_FAILURE;
+                continue;
+            }
+        }
+        vector< char* > iArgv;
+        for( unsigned int i = 0; i < iFileArgs[f].size(); i++ )
+        {
+            iArgv.push_back( ( char* )iFileArgs[f][i].c_str() );
+        }
+        VReadRunParameter* iNextReadRunParameter = new VReadRunParameter();
+        if( !iNextReadRunParameter->readCommandline( ( int )iArgv.size(), &iArgv[0] ) )
+        {
+            delete iNextReadRunParameter;
+            iQueue[1 + f] = EXIT_FAILURE;
+            continue;
+        }
+        iNextReadRunParameter->getRunParameter()->print();
+        
+        // first file: create event loop
+        if( !iEventLoop )
+        {
+            iEventLoop = new VEventLoop( iNextReadRunParameter->getRunParameter() );
+        }
+        // all other files: reset run dependent data
+        else if( !iEventLoop->resetRun( iNextReadRunParameter->getRunParameter() ) )
+        {
+            delete iNextReadRunParameter;
+            iQueue[1 + f] = EXIT_FAILURE;
+            continue;
+        }
+        if( iReadRunParameter )
+        {
+            delete iReadRunParameter;
+        }
+        iReadRunParameter = iNextReadRunParameter;
+        
+        if( !iEventLoop->initEventLoop() )
+        {
+            iQueue[1 + f] = EXIT_FAILURE;
+            continue;
+        }
+        iEventLoop->loop( iReadRunParameter->getRunParameter()->fnevents );
+        iEventLoop->shutdown();
+        cout.flush();
+        fflush( stdout );
+        iQueue[1 + f] = EXIT_SUCCESS;
+    }
+}
+
+/*
+ * queue mode: analyse a list of files with one command
+ *
+ * all files are analysed by one persistent event loop (see analyseQueueFiles()):
+ * detector geometry, calibration data, NN-cleaning IPR graphs and disp BDTs
+ * are read once and reloaded only when their input changes (e.g. a different
+ * calibration run); event counters, output file, pointing and DB data are
+ * reset for each file. All files must be analysed with the same telescope
+ * configuration, source type and reconstruction parameter file.
+ *
+ * output files (and log files) are named after the input files;
+ * the file index is added for input files with identical names
+ *
+ * iNWorkers > 1: files are distributed over iNWorkers forked processes,
+ * each with its own persistent event loop (output of each file is written
+ * into a log file); crashed workers are replaced
+ */
+int analyseQueue( vector< string > iArgs, string iQueue, string iQueueOutputDirectory, unsigned int iNWorkers )
+{
+    vector< string > iFiles = readQueue( iQueue );
+    if( iFiles.size() == 0 )
+    {
+        cout << "evndisp queue error: no files found in " << iQueue << endl;
+        return EXIT_FAILURE;
+    }
+    if( iNWorkers < 1 )
+    {
+        iNWorkers = 1;
+    }
+    if( iNWorkers > iFiles.size() )
+    {
+        iNWorkers = iFiles.size();
+    }
+    cout << "evndisp queue mode: " << iFiles.size() << " file(s) (" << iNWorkers << " worker(s))" << endl;
+    
+    ////////////////////////////////////////////////////////////////
+    // check command line (using the first file of the queue)
+    vector< string > iTestArgs = iArgs;
+    iTestArgs.push_back( "-sourcefile" );
+    iTestArgs.push_back( iFiles[0] );
+    vector< char* > iArgv;
+    for( unsigned int i = 0; i < iTestArgs.size(); i++ )
+    {
+        iArgv.push_back( ( char* )iTestArgs[i].c_str() );
+    }
+    VReadRunParameter* fReadRunParameter = new VReadRunParameter();
+    if( !fReadRunParameter->readCommandline( ( int )iArgv.size(), &iArgv[0] ) )
+    {
+        return EXIT_FAILURE;
+    }
+    if( fReadRunParameter->getRunParameter()->fdisplaymode || fReadRunParameter->getRunParameter()->frunmode != 0 )
+    {
+        cout << "evndisp queue error: queue mode is possible for the analysis run mode only (no display, no calibration)" << endl;
+        return EXIT_FAILURE;
+    }
+    
+    ////////////////////////////////////////////////////////////////
+    // command line for each file
+    // (output file names from input file names, as run numbers
+    //  are not necessarily unique for simulation files)
+    if( iQueueOutputDirectory.size() == 0 )
+    {
+        iQueueOutputDirectory = fReadRunParameter->getRunParameter()->getDirectory_EVNDISPOutput();
+    }
+    delete fReadRunParameter;
+    vector< string > iBaseNames;
+    map< string, unsigned int > iNBaseNames;
+    for( unsigned int f = 0; f < iFiles.size(); f++ )
+    {
+        string iBaseName = iFiles[f].substr( iFiles[f].rfind( "/" ) + 1, iFiles[f].size() );
+        iBaseName = iBaseName.substr( 0, iBaseName.find( "." ) );
+        iBaseNames.push_back( iBaseName );
+        iNBaseNames[iBaseName]++;
+    }
+    vector< vector< string > > iFileArgs;
+    vector< string > iLogFiles;
+    for( unsigned int f = 0; f < iFiles.size(); f++ )
+    {
+        ostringstream iBaseName;
+        iBaseName << iQueueOutputDirectory << "/" << iBaseNames[f];
+        if( iNBaseNames[iBaseNames[f]] > 1 )
+        {
+            iBaseName << "_" << f + 1;
+        }
+        iFileArgs.push_back( iArgs );
+        iFileArgs.back().push_back( "-sourcefile" );
+        iFileArgs.back().push_back( iFiles[f] );
+        iFileArgs.back().push_back( "-output" );
+        iFileArgs.back().push_back( iBaseName.str() + ".root" );
+        iLogFiles.push_back( iBaseName.str() + ".evndisp.log" );
+    }
+    
+    ////////////////////////////////////////////////////////////////
+    // queue status (shared between worker processes)
+    size_t iQueueSize = ( 1 + 2 * iFiles.size() ) * sizeof( int );
+    volatile int* iQueueStatus = ( volatile int* )mmap( 0, iQueueSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+    if( iQueueStatus == MAP_FAILED )
+    {
+        cout << "evndisp queue error: failed to allocate shared memory" << endl;
+        return EXIT_FAILURE;
+    }
+    iQueueStatus[0] = 0;
+    for( unsigned int f = 0; f < iFiles.size(); f++ )
+    {
+        iQueueStatus[1 + f] = Q_PENDING;
+        iQueueStatus[1 + iFiles.size() + f] = 0;
+    }
+    
+    ////////////////////////////////////////////////////////////////
+    // one persistent event loop in this process
+    if( iNWorkers == 1 )
+    {
+        analyseQueueFiles( iFileArgs, iLogFiles, iQueueStatus, false );
+    }
+    ////////////////////////////////////////////////////////////////
+    // several worker processes with one persistent event loop each
+    else
+    {
+        unsigned int iNRunning = 0;
+        for( ;; )
+        {
+            // start new workers while files are left
+            while( iNRunning < iNWorkers && iQueueStatus[0] < ( int )iFiles.size() )
+            {
+                cout.flush();
+                fflush( stdout );
+                pid_t iPID = fork();
+                if( iPID == 0 )
+                {
+                    analyseQueueFiles( iFileArgs, iLogFiles, iQueueStatus, true );
+                    cout.flush();
+                    fflush( stdout );
+                    fflush( stderr );
+                    _exit( EXIT_SUCCESS );
+                }
+                else if( iPID < 0 )
+                {
+                    cout << "evndisp queue error: failed to start worker" << endl;
+                    break;
+                }
+                iNRunning++;
+            }
+            if( iNRunning == 0 )
+            {
+                break;
+            }
+            // wait for any worker to finish
+            int iWaitStatus = 0;
+            pid_t iPID = waitpid( -1, &iWaitStatus, 0 );
+            if( iPID < 0 )
+            {
+                break;
+            }
+            iNRunning--;
+            // file analysed by a crashed worker
+            for( unsigned int f = 0; f < iFiles.size(); f++ )
+            {
+                if( iQueueStatus[1 + iFiles.size() + f] == ( int )iPID && iQueueStatus[1 + f] == Q_RUNNING )
+                {
+                    cout << "evndisp queue: worker failed while analysing " << iFiles[f] << endl;
+                    iQueueStatus[1 + f] = EXIT_FAILURE;
+                }
+            }
+        }
+    }
+    
+    ////////////////////////////////////////////////////////////////
+    // summary
+    unsigned int iNFailed = 0;
+    for( unsigned int f = 0; f < iFiles.size(); f++ )
+    {
+        if( iQueueStatus[1 + f] != EXIT_SUCCESS )
+        {
+            if( iNFailed == 0 )
+            {
+                cout << "evndisp queue: failed files:" << endl;
+            }
+            cout << "\t" << iFiles[f] << endl;
+            iNFailed++;
+        }
+    }
+    cout << "evndisp queue: " << iFiles.size() - iNFailed << " of " << iFiles.size() << " file(s) analysed successfully" << endl;
+    munmap( ( void* )iQueueStatus, iQueueSize );
+    
+    return ( iNFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+
 int main( int argc, char* argv[] )
 {
     // some timing
@@ -42,6 +380,39 @@ int main( int argc, char* argv[] )
         }
     }
     
+    // queue mode: analyse several files with one process
+    string iQueue = "";
+    string iQueueOutputDirectory = "";
+    unsigned int iQueueWorkers = 1;
+    vector< string > iArgs;
+    for( int i = 0; i < argc; i++ )
+    {
+        string iTemp = argv[i];
+        if( iTemp == "-queue" && i + 1 < argc )
+        {
+            iQueue = argv[++i];
+        }
+        else if( iTemp == "-queueoutdir" && i + 1 < argc )
+        {
+            iQueueOutputDirectory = argv[++i];
+        }
+        else if( iTemp.find( "-queueworkers=" ) == 0 )
+        {
+            iQueueWorkers = atoi( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
+        }
+        else
+        {
+            iArgs.push_back( iTemp );
+        }
+    }
+    if( iQueue.size() > 0 )
+    {
+        int iReturn = analyseQueue( iArgs, iQueue, iQueueOutputDirectory, iQueueWorkers );
+        fStopWatch.Stop();
+        fStopWatch.Print();
+        return iReturn;
+    }
+    
     // read the command line parameters
     VReadRunParameter* fReadRunParameter = new VReadRunParameter();
     if( !fReadRunParameter->readCommandline( argc, argv ) )
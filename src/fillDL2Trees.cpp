@@ -102,7 +102,14 @@ int main( int argc, char* argv[] )
     
     // fill DL2 trees
     fOutputfile->cd();
+    if( !fDL2Writer.initializeRNTuple( fOutputfile ) )
+    {
+        cout << "Error defining DL2 RNTuple" << endl;
+        cout << "exiting..." << endl;
+        exit( EXIT_FAILURE );
+    }
     fDL2Writer.fill( &d );
+    fDL2Writer.closeRNTuple();
     
     // write results to disk
     if( fDL2Writer.getEventDataTree() )
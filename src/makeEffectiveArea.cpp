@@ -210,20 +210,44 @@ int main( int argc, char* argv[] )
     /////////////////////////////////////////////////////////////////////////////
     // load data chain
     TChain* c = new TChain( "data" );
-    if( !c->Add( fRunPara->fdatafile.c_str(), -1 ) )
+    CData* d = 0;
+#ifdef RUNWITHRNTUPLE
+    // columnar event data (RNTuple; single files only)
+    TFile* iRNTupleFile = 0;
+    if( fRunPara->fdatafile.find( "*" ) == string::npos )
     {
-        cout << "Error while trying to add mscw data tree from file " << fRunPara->fdatafile  << endl;
-        cout << "exiting..." << endl;
-        exit( EXIT_FAILURE );
+        iRNTupleFile = new TFile( fRunPara->fdatafile.c_str() );
+        VRNTupleReader* iRNTuple = VRNTupleReader::open( iRNTupleFile );
+        if( iRNTuple )
+        {
+            cout << "reading event data from RNTuple" << endl;
+            c->Add( fRunPara->fdatafile.c_str(), 0 );
+            d = new CData( iRNTuple, true, true );
+        }
+        else
+        {
+            iRNTupleFile->Close();
+            delete iRNTupleFile;
+            iRNTupleFile = 0;
+        }
+    }
+#endif
+    if( !d )
+    {
+        if( !c->Add( fRunPara->fdatafile.c_str(), -1 ) )
+        {
+            cout << "Error while trying to add mscw data tree from file " << fRunPara->fdatafile  << endl;
+            cout << "exiting..." << endl;
+            exit( EXIT_FAILURE );
+        }
+        d = new CData( c, true, true );
     }
-    
-    CData d( c, true, true );
     for( unsigned int i = 0; i < fCuts.size(); i++ )
     {
-        fCuts[i]->setDataTree( &d );
+        fCuts[i]->setDataTree( d );
     }
     // expect all cuts using the same reconstruction type
-    d.setReconstructionType( fCuts[0]->fReconstructionType );
+    d->setReconstructionType( fCuts[0]->fReconstructionType );
     
     /////////////////////////////////////////////////////////////////////////////
     // fill resolution plots
@@ -231,7 +255,7 @@ int main( int argc, char* argv[] )
     {
         if( f_IRF[i] )
         {
-            f_IRF[i]->setDataTree( &d );
+            f_IRF[i]->setDataTree( d );
             f_IRF[i]->setCuts( fCuts );
             f_IRF[i]->setOutputFile( fOutputfile );
             if( f_IRF[i]->doNotDuplicateIRFs() )
@@ -245,6 +269,14 @@ int main( int argc, char* argv[] )
             }
         }
     }
+    // samples are not needed after filling all resolution graphs
+    for( unsigned int i = 0; i < f_IRF.size(); i++ )
+    {
+        if( f_IRF[i] )
+        {
+            f_IRF[i]->clearSamples();
+        }
+    }
     
     /////////////////////////////////////////////////////////////////////////////
     // calculate effective areas
@@ -354,7 +386,7 @@ int main( int argc, char* argv[] )
         }
         
         // fill effective areas
-        fEffectiveAreaCalculator.fill( &d, fMC_histo, fRunPara->fEnergyReconstructionMethod );
+        fEffectiveAreaCalculator.fill( d, fMC_histo, fRunPara->fEnergyReconstructionMethod );
         fStopWatch.Print();
     }
     
@@ -487,6 +519,15 @@ int main( int argc, char* argv[] )
     }
     
     fOutputfile->Close();
+#ifdef RUNWITHRNTUPLE
+    // close RNTuple input file (after deleting the reader)
+    if( iRNTupleFile )
+    {
+        delete d;
+        iRNTupleFile->Close();
+        delete iRNTupleFile;
+    }
+#endif
     cout << "end..." << endl;
 }
 
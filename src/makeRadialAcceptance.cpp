@@ -7,22 +7,31 @@
 
 #include "CData.h"
 #include "TFile.h"
+#include "TROOT.h"
 
 #include "VEvndispRunParameter.h"
 #include "VRadialAcceptance.h"
 #include "VGammaHadronCuts.h"
 #include "VAnaSumRunParameter.h"
 
+#include <atomic>
 #include <getopt.h>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <sys/stat.h>
 
 using namespace std;
 
 int parseOptions( int argc, char* argv[] );
+VGammaHadronCuts* initializeGammaHadronCuts( VAnaSumRunParameter* fRunPara );
+void fillRadialAcceptances( VAnaSumRunParameter* fRunPara, VGammaHadronCuts* fCuts,
+                            VRadialAcceptance* facc, vector< VRadialAcceptance* > facc_az,
+                            TDirectory* facc_dir, vector< TDirectory* > facc_az_dir,
+                            atomic< unsigned int >* iRunCounter, mutex* iPrintMutex );
 string listfilename = "";
 string cutfilename = "";
 string simpleListFileName = "";
@@ -44,6 +53,8 @@ bool   production_shortIO = false;
 string exclusionregionfile = "";
 // target region excluded
 bool fRemoveTargetRegionFromAcceptanceFilling = true;
+// number of threads (runs are filled in parallel)
+unsigned int fNThreads = 1;
 
 
 ////////////////////////////////////////////////////////////////////
@@ -130,49 +141,7 @@ int main( int argc, char* argv[] )
     
     ///////////////////////////////////////////
     // initialize gamma/hadron cuts
-    VGammaHadronCuts* fCuts = 0;
-    if( cutfilename.size() > 0 && cutfilename.find( ".root" ) != string::npos )
-    {
-        // read cuts from effective area file
-        fCuts = fRunPara->getGammaHadronCuts( cutfilename );
-        if( !fCuts )
-        {
-            cout << "error reading gamma/hadron ctus from " << cutfilename << endl;
-            cout << "exiting..." << endl;
-            exit( EXIT_FAILURE );
-        }
-        // set reconstruction type to default if not set
-        if( fCuts->fReconstructionType == NOT_SET )
-        {
-            fRunPara->fReconstructionType = GEO;
-            fCuts->setReconstructionType( fRunPara->fReconstructionType );
-        }
-    }
-    else if( cutfilename.size() > 0 )
-    {
-        // read gamma/hadron cuts from cut file
-        // (ascii file)
-        fCuts = new VGammaHadronCuts();
-        fCuts->setInstrumentEpoch( fInstrumentEpoch );
-        fCuts->setTelToAnalyze( teltoana );
-        fCuts->setNTel( ntel );
-        // set reconstruction type (e.g. GEO, DISP, ...
-        fCuts->setReconstructionType( fRunPara->fReconstructionType );
-        fCuts->readCuts( cutfilename );
-    }
-    else
-    {
-        cout << "error: no gamma/hadron cut file given" << endl;
-        cout << "(command line option -c)" << endl;
-        cout << "exiting..." << endl;
-        exit( EXIT_FAILURE );
-    }
-    if( !fCuts )
-    {
-        cout << "error reading cut file: " << cutfilename << endl;
-        cout << "exiting..." << endl;
-        exit( EXIT_FAILURE );
-    }
+    VGammaHadronCuts* fCuts = initializeGammaHadronCuts( fRunPara );
     cout << "Max distance of events to camera centre: " << fMaxDistanceAllowed << " [deg]" << endl;
     cout << "Instrument epoch is " << fInstrumentEpoch << endl;
     cout << "Telescopes to analyse: " << teltoanastring << endl;
@@ -185,6 +154,19 @@ int main( int argc, char* argv[] )
         cout << "Write long list of histograms" << endl;
     }
     cout << "total number of files to read: " << fRunPara->fRunList.size() << endl;
+    if( fNThreads == 0 )
+    {
+        fNThreads = thread::hardware_concurrency();
+    }
+    if( fNThreads > fRunPara->fRunList.size() )
+    {
+        fNThreads = fRunPara->fRunList.size();
+    }
+    if( fNThreads < 1 )
+    {
+        fNThreads = 1;
+    }
+    cout << "number of threads: " << fNThreads << endl;
     
     char ifile[1800];
     
@@ -259,15 +241,11 @@ int main( int argc, char* argv[] )
     }
     
     //////////////////////////////////////////////////////////////
-    // main loop over all runs
-    //   - fill radial acceptances per run
-    //   - fill average radial acceptance
+    // read run parameters and initialize exclusion regions
+    // (serial: exclusion regions depend on the order of runs)
     for( unsigned int i = 0; i < fRunPara->fRunList.size(); i++ )
     {
         sprintf( ifile, "%s/%d.mscw.root", datadir.c_str(), fRunPara->fRunList[i].fRunOff );
-        cout << "now chaining " << ifile;
-        cout << " (wobble offset " << -1.*fRunPara->fRunList[i].fWobbleNorth;
-        cout << ", " << fRunPara->fRunList[i].fWobbleWest << ")" << endl;
         
         // open data (mscw_energy) file
         TFile fDataFile( ifile );
@@ -276,16 +254,6 @@ int main( int argc, char* argv[] )
             cout << "error: file not found, " << ifile << endl;
             exit( EXIT_FAILURE );
         }
-        // get data tree
-        TTree* c = ( TTree* )fDataFile.Get( "data" );
-        CData* d = new CData( c, false, true );
-        if( !d )
-        {
-            cout << "makeRadialAcceptance: no data tree defined: run " << fRunPara->fRunList[i].fRunOff << endl;
-            exit( EXIT_FAILURE );
-        }
-        // set reconstruction type (e.g. GEO, DISP, ...)
-        d->setReconstructionType( fCuts->fReconstructionType );
         
         /////////////////////////////////////
         // read run parameters from mscw file
@@ -294,7 +262,6 @@ int main( int argc, char* argv[] )
         if( iParV2 )
         {
             ostringstream iTel_temp;
-            cout << "Testing telescope multiplicity " << teltoanastring << endl;
             for( unsigned int i = 0; i < iParV2->fTelToAnalyze.size(); i++ )
             {
                 iTel_temp << iParV2->fTelToAnalyze[i] + 1;
@@ -323,20 +290,10 @@ int main( int argc, char* argv[] )
         }
         else
         {
-            cout << "error reading run parameters from mscw file" << endl;
+            cout << "error reading run parameters from mscw file " << ifile << endl;
             exit( EXIT_FAILURE );
         }
-        
-        // initialize gamma/hadron cuts
-        fCuts->initializeCuts( fRunPara->fRunList[i].fRunOff, datadir );
-        fCuts->setDataTree( d );
-        // data trees and cuts
-        int nentries = d->fChain->GetEntries();
-        if( entries > 0 )
-        {
-            nentries = entries;
-        }
-        cout << "filling acceptance curves with " << nentries << " events (before gamma/hadron cuts)" << endl;
+        fDataFile.Close();
         
         ////////////////////////////////////////////
         // calculate coordinates of camera centre:
@@ -350,7 +307,6 @@ int main( int argc, char* argv[] )
                 -1.*fRunPara->fRunList[i].fWobbleWest,    // require wobble EAST
                 raJ2000_deg, decJ2000_deg );
                 
-        cout << "Camera centre at (ra,dec) J2000 : ( " << raJ2000_deg << ", " << decJ2000_deg << ")" << endl;
         ////////////////////////////////////////////
         // initialize exclusion regions
         
@@ -363,7 +319,8 @@ int main( int argc, char* argv[] )
         }
         if( exclusionregionfile.size() > 0 )
         {
-            cout << "Exclusion regions: " << endl;
+            cout << "Exclusion regions for run " << fRunPara->fRunList[i].fRunOff;
+            cout << " (camera centre at (ra,dec) J2000 : ( " << raJ2000_deg << ", " << decJ2000_deg << ")): " << endl;
             double iMax = fMaxDistanceAllowed * 1.3;
             VStarCatalogue iStarCatalogue;
             iStarCatalogue.init( iMJD, fRunPara->getStarCatalogue() );
@@ -372,6 +329,156 @@ int main( int argc, char* argv[] )
             fRunPara->initializeExclusionRegions( i, &iStarCatalogue,
                                                   raJ2000_deg, decJ2000_deg,
                                                   raJ2000_deg, decJ2000_deg );
+        }
+    }
+    
+    //////////////////////////////////////////////////////////////
+    // one set of gamma/hadron cuts and acceptance accumulators
+    // per thread
+    if( fNThreads > 1 )
+    {
+        ROOT::EnableThreadSafety();
+    }
+    vector< VGammaHadronCuts* > fCuts_thread;
+    vector< VRadialAcceptance* > facc_thread;
+    vector< vector< VRadialAcceptance* > > facc_az_thread;
+    for( unsigned int t = 0; t < fNThreads; t++ )
+    {
+        if( t == 0 )
+        {
+            fCuts_thread.push_back( fCuts );
+        }
+        else
+        {
+            fCuts_thread.push_back( initializeGammaHadronCuts( fRunPara ) );
+            // (set in VRadialAcceptance constructor)
+            fCuts_thread.back()->fCut_CameraFiducialSize_max = fCuts->fCut_CameraFiducialSize_max;
+        }
+        facc_thread.push_back( new VRadialAcceptance( facc, fCuts_thread.back() ) );
+        vector< VRadialAcceptance* > i_acc_az;
+        for( unsigned int a = 0; a < facc_az.size(); a++ )
+        {
+            i_acc_az.push_back( new VRadialAcceptance( facc_az[a], fCuts_thread.back() ) );
+        }
+        facc_az_thread.push_back( i_acc_az );
+    }
+    
+    //////////////////////////////////////////////////////////////
+    // main loop over all runs
+    //   - fill radial acceptances per run
+    //   - fill average radial acceptance
+    atomic< unsigned int > iRunCounter( 0 );
+    mutex iPrintMutex;
+    if( fNThreads == 1 )
+    {
+        fillRadialAcceptances( fRunPara, fCuts_thread[0], facc_thread[0], facc_az_thread[0],
+                               facc_dir, facc_az_dir, &iRunCounter, &iPrintMutex );
+    }
+    else
+    {
+        vector< thread > i_threads;
+        for( unsigned int t = 0; t < fNThreads; t++ )
+        {
+            i_threads.push_back( thread( fillRadialAcceptances, fRunPara, fCuts_thread[t], facc_thread[t], facc_az_thread[t],
+                                         facc_dir, facc_az_dir, &iRunCounter, &iPrintMutex ) );
+        }
+        for( unsigned int t = 0; t < i_threads.size(); t++ )
+        {
+            i_threads[t].join();
+        }
+    }
+    
+    // merge accumulators
+    for( unsigned int t = 0; t < fNThreads; t++ )
+    {
+        facc->addAccumulator( facc_thread[t] );
+        delete facc_thread[t];
+        for( unsigned int a = 0; a < facc_az_thread[t].size(); a++ )
+        {
+            facc_az[a]->addAccumulator( facc_az_thread[t][a] );
+            delete facc_az_thread[t][a];
+        }
+    }
+    
+    /////////////////////////////////////////
+    // write acceptance files to disk
+    facc->calculateAverageRadialAcceptanceCurveFromRuns( facc_dir );
+    facc->calculate2DBinNormalizationConstant() ;
+    facc->terminate( facc_dir );
+    for( unsigned int a = 0; a < facc_az_dir.size(); a++ )
+    {
+        if( facc_az[a] )
+        {
+            facc_az[a]->calculateAverageRadialAcceptanceCurveFromRuns( facc_az_dir[a] );
+            facc_az[a]->terminate( facc_az_dir[a] );
+        }
+    }
+    
+    fo->Close();
+    cout << "closing radial acceptance file: " << fo->GetName() << endl;
+    
+    cout << "exiting.." << endl;
+}
+
+
+/*
+
+    fill acceptance curves for all runs not yet analysed
+    (called for each thread; one set of cuts and accumulators per thread)
+
+*/
+void fillRadialAcceptances( VAnaSumRunParameter* fRunPara, VGammaHadronCuts* fCuts,
+                            VRadialAcceptance* facc, vector< VRadialAcceptance* > facc_az,
+                            TDirectory* facc_dir, vector< TDirectory* > facc_az_dir,
+                            atomic< unsigned int >* iRunCounter, mutex* iPrintMutex )
+{
+    char ifile[1800];
+    
+    for( ;; )
+    {
+        unsigned int i = ( *iRunCounter )++;
+        if( i >= fRunPara->fRunList.size() )
+        {
+            break;
+        }
+        ostringstream iLog;
+        sprintf( ifile, "%s/%d.mscw.root", datadir.c_str(), fRunPara->fRunList[i].fRunOff );
+        iLog << "now chaining " << ifile;
+        iLog << " (wobble offset " << -1.*fRunPara->fRunList[i].fWobbleNorth;
+        iLog << ", " << fRunPara->fRunList[i].fWobbleWest << ")" << endl;
+        
+        // open data (mscw_energy) file
+        TFile fDataFile( ifile );
+        if( fDataFile.IsZombie() )
+        {
+            cout << "error: file not found, " << ifile << endl;
+            exit( EXIT_FAILURE );
+        }
+        // get data tree
+        TTree* c = ( TTree* )fDataFile.Get( "data" );
+        if( !c )
+        {
+            cout << "makeRadialAcceptance: no data tree defined: run " << fRunPara->fRunList[i].fRunOff << endl;
+            exit( EXIT_FAILURE );
+        }
+        CData* d = new CData( c, false, true );
+        // set reconstruction type (e.g. GEO, DISP, ...)
+        d->setReconstructionType( fCuts->fReconstructionType );
+        
+        // initialize gamma/hadron cuts
+        fCuts->initializeCuts( fRunPara->fRunList[i].fRunOff, datadir );
+        fCuts->setDataTree( d );
+        // data trees and cuts
+        int nentries = d->fChain->GetEntries();
+        if( entries > 0 )
+        {
+            nentries = entries;
+        }
+        iLog << "filling acceptance curves with " << nentries << " events (before gamma/hadron cuts)" << endl;
+        
+        // exclusion regions (initialized in main())
+        if( exclusionregionfile.size() > 0 )
+        {
             facc->setRegionToExcludeAcceptance( fRunPara->getExclusionRegions( i ) );
             for( unsigned int a = 0; a < facc_az.size(); a++ )
             {
@@ -382,7 +489,11 @@ int main( int argc, char* argv[] )
             }
         }
         
-        fCuts->printCutSummary();
+        if( i == 0 )
+        {
+            lock_guard< mutex > iLock( *iPrintMutex );
+            fCuts->printCutSummary();
+        }
         
         int neventStats = 0;
         int i_entries_after_cuts = 0;
@@ -399,7 +510,7 @@ int main( int argc, char* argv[] )
             // printout for MC
             if( n == 0 and d->isMC() )
             {
-                cout << "\t (analysing MC data)" << endl;
+                iLog << "\t (analysing MC data)" << endl;
             }
             
             // convert de-rotated coordinates to J2000
@@ -412,6 +523,7 @@ int main( int argc, char* argv[] )
                 x_rotJ2000, y_rotJ2000 );
                 
             // check if event is inside an exclusion region
+            // (exclusion mask lookup)
             if( exclusionregionfile.size() > 0 && facc->isExcludedfromBackground( x_rotJ2000, y_rotJ2000 ) )
             {
                 continue;
@@ -436,42 +548,80 @@ int main( int argc, char* argv[] )
             }
             i_entries_after_cuts += neventStats;
         }
-        cout << "total number of entries after cuts: " << i_entries_after_cuts << endl;
-        cout << endl << endl;
+        iLog << "total number of entries after cuts: " << i_entries_after_cuts << endl;
+        iLog << endl << endl;
         
         fDataFile.Close();
-        facc->correctRadialAcceptancesForExclusionRegions( facc_dir, fRunPara->fRunList[i].fRunOff );
+        
+        facc->correctRadialAcceptancesForExclusionRegions( facc_dir, fRunPara->fRunList[i].fRunOff, iLog );
         for( unsigned int a = 0; a < facc_az.size(); a++ )
         {
             if( facc_az[a] )
             {
-                if( facc_az[a] )
-                {
-                    facc_az[a]->correctRadialAcceptancesForExclusionRegions( facc_az_dir[a],
-                            fRunPara->fRunList[i].fRunOff );
-                }
+                facc_az[a]->correctRadialAcceptancesForExclusionRegions( facc_az_dir[a],
+                        fRunPara->fRunList[i].fRunOff, iLog );
             }
         }
+        
+        lock_guard< mutex > iLock( *iPrintMutex );
+        cout << iLog.str();
     }
-    
-    /////////////////////////////////////////
-    // write acceptance files to disk
-    facc->calculateAverageRadialAcceptanceCurveFromRuns( facc_dir );
-    facc->calculate2DBinNormalizationConstant() ;
-    facc->terminate( facc_dir );
-    for( unsigned int a = 0; a < facc_az_dir.size(); a++ )
+}
+
+
+/*
+
+    initialize gamma/hadron cuts
+    (from effective area file or from ascii cut file)
+
+*/
+VGammaHadronCuts* initializeGammaHadronCuts( VAnaSumRunParameter* fRunPara )
+{
+    VGammaHadronCuts* fCuts = 0;
+    if( cutfilename.size() > 0 && cutfilename.find( ".root" ) != string::npos )
     {
-        if( facc_az[a] )
+        // read cuts from effective area file
+        fCuts = fRunPara->getGammaHadronCuts( cutfilename );
+        if( !fCuts )
         {
-            facc_az[a]->calculateAverageRadialAcceptanceCurveFromRuns( facc_az_dir[a] );
-            facc_az[a]->terminate( facc_az_dir[a] );
+            cout << "error reading gamma/hadron ctus from " << cutfilename << endl;
+            cout << "exiting..." << endl;
+            exit( EXIT_FAILURE );
+        }
+        // set reconstruction type to default if not set
+        if( fCuts->fReconstructionType == NOT_SET )
+        {
+            fRunPara->fReconstructionType = GEO;
+            fCuts->setReconstructionType( fRunPara->fReconstructionType );
         }
     }
+    else if( cutfilename.size() > 0 )
+    {
+        // read gamma/hadron cuts from cut file
+        // (ascii file)
+        fCuts = new VGammaHadronCuts();
+        fCuts->setInstrumentEpoch( fInstrumentEpoch );
+        fCuts->setTelToAnalyze( teltoana );
+        fCuts->setNTel( ntel );
+        // set reconstruction type (e.g. GEO, DISP, ...
+        fCuts->setReconstructionType( fRunPara->fReconstructionType );
+        fCuts->readCuts( cutfilename );
+    }
+    else
+    {
+        cout << "error: no gamma/hadron cut file given" << endl;
+        cout << "(command line option -c)" << endl;
+        cout << "exiting..." << endl;
+        exit( EXIT_FAILURE );
+    }
+    if( !fCuts )
+    {
+        cout << "error reading cut file: " << cutfilename << endl;
+        cout << "exiting..." << endl;
+        exit( EXIT_FAILURE );
+    }
     
-    fo->Close();
-    cout << "closing radial acceptance file: " << fo->GetName() << endl;
-    
-    cout << "exiting.." << endl;
+    return fCuts;
 }
 
 
@@ -499,10 +649,11 @@ int parseOptions( int argc, char* argv[] )
             {"teltoana", required_argument, 0, 't'},
             {"productionIO", required_argument, 0, 'p'},
             {"--remove_target", required_argument, 0, 'r'},
+            {"nthreads", required_argument, 0, 'j'},
             {0, 0, 0, 0}
         };
         int option_index = 0;
-        int c = getopt_long( argc, argv, "ht:s:f:p:l:e:m:r:o:i:d:n:c:w:t:", long_options, &option_index );
+        int c = getopt_long( argc, argv, "ht:s:f:p:l:e:m:r:o:i:d:n:c:w:t:j:", long_options, &option_index );
         if( optopt != 0 )
         {
             cout << "error: unknown option" << endl;
@@ -547,6 +698,7 @@ int parseOptions( int argc, char* argv[] )
                 cout << "-t --teltoana <telescopes>" << endl;
                 cout << "-p --productionIO [0/1] " << endl;
                 cout << "-f --exclusionregionfile [file with exclusion regions]" << endl;
+                cout << "-j --nthreads [number of threads; runs are filled in parallel (default=1; 0=number of cores)]" << endl;
                 cout << endl;
                 exit( EXIT_SUCCESS );
                 break;
@@ -604,6 +756,9 @@ int parseOptions( int argc, char* argv[] )
             case 'r':
                 fRemoveTargetRegionFromAcceptanceFilling = ( bool )atoi( optarg );
                 break;
+            case 'j':
+                fNThreads = ( unsigned int )atoi( optarg );
+                break;
             case '?':
                 break;
             default:
@@ -9,11 +9,22 @@
 #include "VTableLookup.h"
 
 #include <TChain.h>
+#include <TFile.h>
+#include <TH1.h>
+#include <TKey.h>
+#include <TMath.h>
+#include <TROOT.h>
 #include <TStopwatch.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <stdlib.h>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
@@ -43,6 +54,225 @@ void printParametersFromFile( string ff )
     exit( EXIT_SUCCESS );
 }
 
+/*
+ * extract noise from file name (noise<N>_)
+ * (as in combineLookupTables)
+ */
+int extract_noise_from_filename( string iFN )
+{
+    int i_noise = 0;
+    
+    if( iFN.find( "noise" ) != string::npos )
+    {
+        size_t i_beg = iFN.find( "noise" ) + 5;
+        size_t i_fin = iFN.find( "_", i_beg ) - i_beg;
+        i_noise = atoi( iFN.substr( i_beg, i_fin ).c_str() );
+    }
+    return i_noise;
+}
+
+/*
+ * noise level directories (NOISE_<pedvar x 100>) for all slices per telescope type
+ *
+ * noise levels vary slightly from simulation file to simulation file;
+ * directories are assigned before filling (independent of the order in
+ * which the threads process the slices) with the rules of combineLookupTables:
+ * first noise level within 10 (noise levels of an existing table file
+ * first, then in the order of the slice list), then the noise level from
+ * the file name, otherwise a new noise level
+ */
+vector< map< ULong64_t, int > > getSliceNoiseLevels( VTableLookupRunParameter* iRunPara, TFile* iTableFile )
+{
+    map< ULong64_t, vector< int > > iNoise;
+    map< ULong64_t, vector< int > > iNoiseFileName;
+    
+    // noise levels in an existing table file
+    if( iTableFile && iTableFile->GetListOfKeys() )
+    {
+        TIter next( iTableFile->GetListOfKeys() );
+        TKey* iKey = 0;
+        while( ( iKey = ( TKey* )next() ) )
+        {
+            string iName = iKey->GetName();
+            TDirectory* iDir = iTableFile->GetDirectory( iName.c_str() );
+            if( iName.find( "tel_" ) != 0 || !iDir || !iDir->GetListOfKeys() )
+            {
+                continue;
+            }
+            ULong64_t t = atoll( iName.substr( 4, iName.size() ).c_str() );
+            TIter nextNoise( iDir->GetListOfKeys() );
+            TKey* iNoiseKey = 0;
+            while( ( iNoiseKey = ( TKey* )nextNoise() ) )
+            {
+                string iNoiseName = iNoiseKey->GetName();
+                if( iNoiseName.find( "NOISE_" ) == 0 )
+                {
+                    iNoise[t].push_back( atoi( iNoiseName.substr( 6, iNoiseName.size() ).c_str() ) );
+                }
+            }
+            sort( iNoise[t].begin(), iNoise[t].end() );
+            iNoiseFileName[t].assign( iNoise[t].size(), 0 );
+        }
+    }
+    
+    vector< map< ULong64_t, int > > iSliceNoise;
+    for( unsigned int n = 0; n < iRunPara->fSliceZe.size(); n++ )
+    {
+        // mean pedvars per telescope type of the input files of this slice
+        VTableLookupRunParameter iSlicePara( *iRunPara );
+        iSlicePara.inputfile.assign( 1, iRunPara->fSliceInputFile[n] );
+        VTableLookupDataHandler iData( true, &iSlicePara );
+        iData.setInputFile( iSlicePara.inputfile );
+        map< ULong64_t, double > i_pedvarlevel = iData.getNoiseLevel_per_TelescopeType();
+        int i_noise_filename = extract_noise_from_filename( iRunPara->fSliceInputFile[n] );
+        
+        map< ULong64_t, int > i_slice;
+        map< ULong64_t, double >::iterator iter_pedvar;
+        for( iter_pedvar = i_pedvarlevel.begin(); iter_pedvar != i_pedvarlevel.end(); ++iter_pedvar )
+        {
+            ULong64_t t = iter_pedvar->first;
+            int i_noise = ( int )( iter_pedvar->second * 100 );
+            int i_noise_dir = -1;
+            for( unsigned int i = 0; i < iNoise[t].size(); i++ )
+            {
+                if( TMath::Abs( iNoise[t][i] - i_noise ) < 10 )
+                {
+                    i_noise_dir = iNoise[t][i];
+                    break;
+                }
+            }
+            if( i_noise_dir < 0 && i_noise_filename > 0 )
+            {
+                for( unsigned int i = 0; i < iNoiseFileName[t].size(); i++ )
+                {
+                    if( iNoiseFileName[t][i] == i_noise_filename )
+                    {
+                        i_noise_dir = iNoise[t][i];
+                        break;
+                    }
+                }
+            }
+            if( i_noise_dir < 0 )
+            {
+                i_noise_dir = i_noise;
+                iNoise[t].push_back( i_noise );
+                iNoiseFileName[t].push_back( i_noise_filename );
+            }
+            i_slice[t] = i_noise_dir;
+            cout << "slice " << n << ", telescope type " << t << ": noise level " << i_noise;
+            cout << " (file name " << i_noise_filename << ") -> NOISE_" << i_noise_dir << endl;
+        }
+        iSliceNoise.push_back( i_slice );
+    }
+    return iSliceNoise;
+}
+
+/*
+ * fill lookup tables for all slices (zenith angle, wobble offset; noise
+ * levels from the input files) of a list in one job
+ *
+ * each thread fills the tables of one slice at a time; all tables are
+ * written into the same table file (directory layout as after
+ * combineLookupTables; noise level directories are assigned
+ * with the rules of combineLookupTables, see getSliceNoiseLevels()).
+ * 1D histograms are always written: slices with the same zenith angle,
+ * wobble offset and noise level are filled into the same directory and
+ * are added to the tables already written there
+ */
+bool fillLookupTableSlices( VTableLookupRunParameter* iRunPara )
+{
+    unsigned int iNThreads = iRunPara->fNThreads;
+    if( iNThreads == 0 )
+    {
+        iNThreads = thread::hardware_concurrency();
+    }
+    if( iNThreads > iRunPara->fSliceZe.size() )
+    {
+        iNThreads = iRunPara->fSliceZe.size();
+    }
+    if( iNThreads < 1 )
+    {
+        iNThreads = 1;
+    }
+    if( iNThreads > 1 )
+    {
+        ROOT::EnableThreadSafety();
+    }
+    // histograms of the table calculators are written explicitly
+    TH1::AddDirectory( kFALSE );
+    
+    char hname[900];
+    sprintf( hname, "lookup table file (array recid = %d, slices from %s)",
+             iRunPara->rec_method, iRunPara->fTableFillingSliceListFile.c_str() );
+    TFile* iTableFile = 0;
+    if( iRunPara->writeoption == "update" )
+    {
+        iTableFile = new TFile( iRunPara->tablefile.c_str(), "UPDATE", hname );
+    }
+    else
+    {
+        iTableFile = new TFile( iRunPara->tablefile.c_str(), "NEW", hname );
+    }
+    if( iTableFile->IsZombie() )
+    {
+        cout << "error while opening table file: " << iRunPara->tablefile << endl;
+        cout << "exiting..." << endl;
+        exit( EXIT_FAILURE );
+    }
+    // noise level directories (before starting the threads)
+    vector< map< ULong64_t, int > > iSliceNoise = getSliceNoiseLevels( iRunPara, iTableFile );
+    
+    cout << "filling " << iRunPara->fSliceZe.size() << " slices with " << iNThreads << " thread(s)" << endl;
+    
+    atomic< unsigned int > iCounter( 0 );
+    atomic< bool > bSuccess( true );
+    mutex iFileMutex;
+    vector< thread > i_threads;
+    for( unsigned int t = 0; t < iNThreads; t++ )
+    {
+        i_threads.push_back( thread( [&]()
+        {
+            unsigned int n = 0;
+            while( ( n = iCounter++ ) < iRunPara->fSliceZe.size() )
+            {
+                VTableLookupRunParameter* iSlicePara = new VTableLookupRunParameter( *iRunPara );
+                iSlicePara->inputfile.assign( 1, iRunPara->fSliceInputFile[n] );
+                iSlicePara->ze = iRunPara->fSliceZe[n];
+                iSlicePara->fWobbleOffset = iRunPara->fSliceWobbleOffset[n];
+                
+                VTableLookup* iTLook = new VTableLookup( iSlicePara );
+                iTLook->setLookupTableFile( iTableFile, &iFileMutex );
+                iTLook->setTableNoiseLevels( iSliceNoise[n] );
+                // (no exit here: the table file is closed by the main thread)
+                if( !iTLook->initialize() )
+                {
+                    cout << "error creating lookup tables for slice " << n << endl;
+                    bSuccess = false;
+                    delete iTLook;
+                    delete iSlicePara;
+                    continue;
+                }
+                iTLook->loop();
+                if( !iTLook->terminate() )
+                {
+                    cout << "error writing lookup tables for slice " << n << endl;
+                    bSuccess = false;
+                }
+                delete iTLook;
+                delete iSlicePara;
+            }
+        } ) );
+    }
+    for( unsigned int t = 0; t < i_threads.size(); t++ )
+    {
+        i_threads[t].join();
+    }
+    cout << "closing file..." << endl;
+    iTableFile->Close();
+    
+    return bSuccess;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  main function to write and read lookup tables
@@ -87,6 +317,20 @@ int main( int argc, char* argv[] )
     }
     fTLRunParameter->print();
     
+    // fill tables for a list of slices
+    if( fTLRunParameter->fWriteTables && fTLRunParameter->fSliceZe.size() > 0 )
+    {
+        bool bSuccess = fillLookupTableSlices( fTLRunParameter );
+        fStopWatch.Stop();
+        fStopWatch.Print();
+        if( !bSuccess )
+        {
+            cout << "error filling lookup tables" << endl;
+            exit( EXIT_FAILURE );
+        }
+        exit( EXIT_SUCCESS );
+    }
+    
     // initilize lookup tables
     VTableLookup* fTLook = new VTableLookup( fTLRunParameter );
     if( !fTLook->initialize() )
@@ -119,5 +363,9 @@ int main( int argc, char* argv[] )
     
     //////////////////////////
     // write tables to disk
-    fTLook->terminate();
+    if( !fTLook->terminate() )
+    {
+        cout << "error writing lookup tables" << endl;
+        exit( EXIT_FAILURE );
+    }
 }
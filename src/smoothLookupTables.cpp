@@ -36,6 +36,13 @@ void copyDirectory( TDirectory* source, const char* hx = 0 );
 // flag if woff_0500 should be copied
 bool fCopy_woff_0500 = false;
 
+// smoothing method (fit or gauss)
+string fSmoothingMethod = "fit";
+// width of Gaussian kernel (in units of bin widths)
+double fGaussianWidth = 1.;
+// number of threads (for Gaussian smoothing; 0 = all cores)
+unsigned int fNThreads = 1;
+
 TH2F* smooth2DHistogram( TH2F* h, TH2F* hNevents )
 {
     if( !h )
@@ -173,7 +180,12 @@ int main( int argc, char* argv[] )
     if( argc < 2 )
     {
         cout << "combine several tables from different files into one single table file" << endl << endl;
-        cout << "combineLookupTables <input table file name> <output file name>" << endl;
+        cout << "smoothLookupTables <input table file name> <output file name> [method] [width] [threads]" << endl;
+        cout << endl;
+        cout << "   method:  smoothing method: fit (default) or gauss" << endl;
+        cout << "            (gauss: event-count-weighted Gaussian convolution)" << endl;
+        cout << "   width:   width of Gaussian kernel in units of bin widths (default: 1)" << endl;
+        cout << "   threads: number of tables smoothed in parallel (default: 1; 0: use all cores)" << endl;
         cout << endl;
         cout << "(should be used with care; check effect of smoothing first with VPlotLookupTables)" << endl;
         cout << endl;
@@ -181,6 +193,29 @@ int main( int argc, char* argv[] )
     }
     string fIFile = argv[1];
     string fOFile = argv[2];
+    if( argc > 3 )
+    {
+        fSmoothingMethod = argv[3];
+        if( fSmoothingMethod != "fit" && fSmoothingMethod != "gauss" )
+        {
+            cout << "error: unknown smoothing method " << fSmoothingMethod << endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+    if( argc > 4 )
+    {
+        fGaussianWidth = atof( argv[4] );
+    }
+    if( argc > 5 )
+    {
+        fNThreads = atoi( argv[5] );
+    }
+    cout << "smoothing method: " << fSmoothingMethod;
+    if( fSmoothingMethod == "gauss" )
+    {
+        cout << " (kernel width " << fGaussianWidth << " bins, threads: " << fNThreads << ")";
+    }
+    cout << endl;
     
     //////////////////////////////////////
     // open output lookup table file
@@ -286,6 +321,10 @@ void copyDirectory( TDirectory* source, const char* hx )
         }
     }
     adir->cd();
+    // objects (tables) in this directory
+    vector< TObject* > iObjects;
+    vector< string > iObjectNames;
+    vector< TH2F* > iNevents;
     //loop on all entries of this directory
     TKey* key;
     TIter nextkey( source->GetListOfKeys() );
@@ -326,13 +365,10 @@ void copyDirectory( TDirectory* source, const char* hx )
             {
                 cout << gDirectory->GetPath() << endl;
             }
-            adir->cd();
-            string iDirName = gDirectory->GetName();
             ///////////////////////////////////
-            // smooth histograms
             // get histogram for event counting histogram
             // smooth median, mean, and mpv histograms
-            // copy only median and mpv histogram
+            TH2F* iHEvents = 0;
             if( iName.find( "median" ) != string::npos
                     || iName.find( "Median" ) != string::npos
                     || iName.find( "mpv" ) != string::npos
@@ -340,19 +376,67 @@ void copyDirectory( TDirectory* source, const char* hx )
               )
             {
                 string iNeventsHistoName = getNeventsHistoName( iName );
-                TH2F* iHEvents = ( TH2F* )source->Get( iNeventsHistoName.c_str() );
-                if( iHEvents )
+                iHEvents = ( TH2F* )source->Get( iNeventsHistoName.c_str() );
+            }
+            iObjects.push_back( obj );
+            iObjectNames.push_back( iName );
+            iNevents.push_back( iHEvents );
+        }
+    }
+    adir->cd();
+    ///////////////////////////////////
+    // smooth histograms
+    // (Gaussian smoothing: all tables of this directory in parallel)
+    if( fSmoothingMethod == "gauss" )
+    {
+        vector< TH2F* > iH;
+        vector< TH2F* > iHEvents;
+        vector< unsigned int > iIndex;
+        for( unsigned int i = 0; i < iObjects.size(); i++ )
+        {
+            if( iNevents[i] )
+            {
+                iH.push_back( ( TH2F* )iObjects[i] );
+                iHEvents.push_back( iNevents[i] );
+                iIndex.push_back( i );
+                cout << "\t\t smooth histogram using _gauss_ algorithm: " << iObjectNames[i] << endl;
+            }
+        }
+        VInterpolate2DHistos i_inter;
+        vector< TH2F* > iHSmoothed = i_inter.doGaussianInterpolation( iH, "gauss", iHEvents, fGaussianWidth, fNThreads );
+        for( unsigned int i = 0; i < iHSmoothed.size(); i++ )
+        {
+            if( iHSmoothed[i] )
+            {
+                delete iObjects[iIndex[i]];
+                iObjects[iIndex[i]] = ( TObject* )iHSmoothed[i];
+            }
+        }
+    }
+    else
+    {
+        for( unsigned int i = 0; i < iObjects.size(); i++ )
+        {
+            if( iNevents[i] )
+            {
+                TObject* obj = ( TObject* )smooth2DHistogram( ( TH2F* )iObjects[i], iNevents[i] );
+                if( obj )
                 {
-                    obj = ( TObject* )smooth2DHistogram( ( TH2F* )obj, iHEvents );
+                    delete iObjects[i];
+                    iObjects[i] = obj;
                 }
             }
-            ///////////////////////////////////
-            cout << "\t writing " << iName << " to ";
-            cout << adir->GetPath() << endl;
-            obj->Write( iName.c_str() );
-            delete obj;
         }
     }
+    ///////////////////////////////////
+    // write all objects of this directory
+    for( unsigned int i = 0; i < iObjects.size(); i++ )
+    {
+        cout << "\t writing " << iObjectNames[i] << " to ";
+        cout << adir->GetPath() << endl;
+        iObjects[i]->Write( iObjectNames[i].c_str() );
+        delete iObjects[i];
+    }
     adir->SaveSelf( kTRUE );
     savdir->cd();
 }